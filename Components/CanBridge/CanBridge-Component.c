@@ -0,0 +1,634 @@
+//==============================================================================
+//header:
+
+
+//==============================================================================
+//includes:
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CanBridge-Component.h"
+#include "CanBus/CanBus-Component.h"
+#include "Components.h"
+#include "TerminalCommands/TerminalCommands.h"
+
+#if NET_TARGET_LAYOUT == NET_LWIP_LAYOUT
+
+#include "lwip/sockets.h"
+#include "lwip/errno.h"
+
+#elif NET_TARGET_LAYOUT == NET_FREERTOS_LAYOUT
+
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+
+#endif
+//==============================================================================
+//types:
+
+#if NET_TARGET_LAYOUT == NET_LWIP_LAYOUT
+
+typedef int CanBridgeSocketT;
+#define CAN_BRIDGE_INVALID_SOCKET -1
+
+#elif NET_TARGET_LAYOUT == NET_FREERTOS_LAYOUT
+
+typedef Socket_t CanBridgeSocketT;
+#define CAN_BRIDGE_INVALID_SOCKET NULL
+
+#endif
+//------------------------------------------------------------------------------
+/// @brief one bus on the link: a cannelloni instance of its own
+typedef struct
+{
+	uint16_t LocalPort;
+	uint16_t RemotePort;
+
+	CanBridgeSocketT Socket; //opened by the downlink, the uplink sends with it
+
+	CanBusRingT Ring; //the frames of the bus: the task of CanBus writes, the uplink reads
+	uint8_t TxSequence;
+
+	uint8_t RxSequence; //the next one expected from the peer
+	uint8_t RxBehind; //datagrams in a row behind the sequence
+	bool IsRxSynchronized;
+
+} CanBridgePortT;
+//==============================================================================
+//variables:
+
+static TaskHandle_t uplinkTaskHandle;
+static StaticTask_t uplinkTaskBuffer;
+static StackType_t uplinkTaskStack[CAN_BRIDGE_UPLINK_TASK_STACK_SIZE] CAN_BRIDGE_COMPONENT_MAIN_TASK_STACK_SECTION;
+
+static TaskHandle_t downlinkTaskHandle;
+static StaticTask_t downlinkTaskBuffer;
+static StackType_t downlinkTaskStack[CAN_BRIDGE_DOWNLINK_TASK_STACK_SIZE] CAN_BRIDGE_COMPONENT_MAIN_TASK_STACK_SECTION;
+
+static int RTOS_CanBridgeUplinkTaskStackWaterMark;
+static int RTOS_CanBridgeDownlinkTaskStackWaterMark;
+
+static CanBusFrameT privateFrames[CAN_BUS_PORTS_COUNT][CAN_BRIDGE_RING_SIZE_MASK + 1] CAN_BRIDGE_MEM_SECTION;
+static uint8_t privateUplinkBuffer[CAN_BRIDGE_DATAGRAM_SIZE] CAN_BRIDGE_MEM_SECTION;
+static uint8_t privateDownlinkBuffer[CAN_BRIDGE_DATAGRAM_SIZE] CAN_BRIDGE_MEM_SECTION;
+
+static CanBridgePortT privatePorts[CAN_BUS_PORTS_COUNT] =
+{
+#if CAN_BUS_PORT1_ENABLE == 1
+	[CAN_BUS_PORT1] =
+	{
+		.LocalPort = CAN_BRIDGE_PORT1_LOCAL_PORT,
+		.RemotePort = CAN_BRIDGE_PORT1_REMOTE_PORT,
+		.Socket = CAN_BRIDGE_INVALID_SOCKET
+	},
+#endif
+
+#if CAN_BUS_PORT2_ENABLE == 1
+	[CAN_BUS_PORT2] =
+	{
+		.LocalPort = CAN_BRIDGE_PORT2_LOCAL_PORT,
+		.RemotePort = CAN_BRIDGE_PORT2_REMOTE_PORT,
+		.Socket = CAN_BRIDGE_INVALID_SOCKET
+	},
+#endif
+};
+
+static volatile uint32_t privateRemoteAddress = CAN_BRIDGE_REMOTE_ADDRESS;
+static volatile bool privateIsRemoteFixed = CAN_BRIDGE_REMOTE_ADDRESS != 0;
+
+CanBridgeStatisticT CanBridgeStatistic[CAN_BUS_PORTS_COUNT];
+//==============================================================================
+//functions:
+
+#if NET_TARGET_LAYOUT == NET_LWIP_LAYOUT
+
+static CanBridgeSocketT privateSocketOpen(uint16_t port)
+{
+	int socketNumber = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+	if (socketNumber < 0)
+	{
+		return CAN_BRIDGE_INVALID_SOCKET;
+	}
+
+	int timeout = CAN_BRIDGE_RECEIVE_TIMEOUT;
+	setsockopt(socketNumber, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	timeout = CAN_BRIDGE_SEND_TIMEOUT;
+	setsockopt(socketNumber, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+	struct sockaddr_in address = { 0 };
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = INADDR_ANY;
+
+	if (bind(socketNumber, (struct sockaddr*)&address, sizeof(address)) < 0)
+	{
+		close(socketNumber);
+		return CAN_BRIDGE_INVALID_SOCKET;
+	}
+
+	return socketNumber;
+}
+//------------------------------------------------------------------------------
+/**
+ * @return >0 - bytes received, 0 - timeout, <0 - error
+ */
+static int privateSocketReceive(CanBridgeSocketT socket, void* buffer, int size, uint32_t* address)
+{
+	struct sockaddr_in from;
+	socklen_t length = sizeof(from);
+
+	int result = recvfrom(socket, buffer, size, 0, (struct sockaddr*)&from, &length);
+
+	if (result < 0)
+	{
+		return (errno == EWOULDBLOCK || errno == EAGAIN) ? 0 : -1;
+	}
+
+	*address = from.sin_addr.s_addr;
+
+	return result;
+}
+//------------------------------------------------------------------------------
+static int privateSocketSend(CanBridgeSocketT socket, void* data, int size, uint32_t address, uint16_t port)
+{
+	struct sockaddr_in to = { 0 };
+	to.sin_family = AF_INET;
+	to.sin_port = htons(port);
+	to.sin_addr.s_addr = address;
+
+	return sendto(socket, data, size, 0, (struct sockaddr*)&to, sizeof(to));
+}
+
+#elif NET_TARGET_LAYOUT == NET_FREERTOS_LAYOUT
+
+static CanBridgeSocketT privateSocketOpen(uint16_t port)
+{
+	Socket_t socket = FreeRTOS_socket(FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP);
+
+	if (socket == FREERTOS_INVALID_SOCKET)
+	{
+		return CAN_BRIDGE_INVALID_SOCKET;
+	}
+
+	TickType_t timeout = pdMS_TO_TICKS(CAN_BRIDGE_RECEIVE_TIMEOUT);
+	FreeRTOS_setsockopt(socket, 0, FREERTOS_SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	timeout = pdMS_TO_TICKS(CAN_BRIDGE_SEND_TIMEOUT);
+	FreeRTOS_setsockopt(socket, 0, FREERTOS_SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+	struct freertos_sockaddr address = { 0 };
+	address.sin_port = FreeRTOS_htons(port);
+
+	if (FreeRTOS_bind(socket, &address, sizeof(address)) != 0)
+	{
+		FreeRTOS_closesocket(socket);
+		return CAN_BRIDGE_INVALID_SOCKET;
+	}
+
+	return socket;
+}
+//------------------------------------------------------------------------------
+/**
+ * @return >0 - bytes received, 0 - timeout
+ */
+static int privateSocketReceive(CanBridgeSocketT socket, void* buffer, int size, uint32_t* address)
+{
+	struct freertos_sockaddr from;
+	socklen_t length = sizeof(from);
+
+	int result = FreeRTOS_recvfrom(socket, buffer, size, 0, &from, &length);
+
+	if (result > 0)
+	{
+		*address = from.sin_addr;
+	}
+
+	return result < 0 ? 0 : result;
+}
+//------------------------------------------------------------------------------
+static int privateSocketSend(CanBridgeSocketT socket, void* data, int size, uint32_t address, uint16_t port)
+{
+	struct freertos_sockaddr to = { 0 };
+	to.sin_port = FreeRTOS_htons(port);
+	to.sin_addr = address;
+
+	return FreeRTOS_sendto(socket, data, size, 0, &to, sizeof(to));
+}
+
+#endif
+//------------------------------------------------------------------------------
+/**
+ * @brief called by the task of CanBus: the frames of the bus wait in the ring for their datagram,
+ * the uplink is woken when the first one comes and when a batch is full.
+ * The frames the gateway sent itself stay off the link: those of the bridge came from it.
+ */
+static void privateFrameListener(void* context, uint8_t port, CanBusFrameT* frame)
+{
+	CanBusRingT* ring = &privatePorts[port].Ring;
+
+	if (frame->Flags & CAN_BUS_FRAME_TRANSMITTED)
+	{
+		return;
+	}
+
+	CanBusFrameT* entry = CanBusRingReserve(ring);
+
+	if (!entry)
+	{
+		CanBridgeStatistic[port].RingOverflows++;
+		return;
+	}
+
+	*entry = *frame;
+	CanBusRingCommit(ring);
+
+	uint16_t count = CanBusRingGetCount(ring);
+
+	if (count == 1 || count == CAN_BRIDGE_BATCH_FRAMES)
+	{
+		xTaskNotifyGive(uplinkTaskHandle);
+	}
+}
+//------------------------------------------------------------------------------
+/// @param latency us the oldest frame waited
+static void privateSend(uint8_t port, uint32_t latency)
+{
+	CanBridgePortT* bridge = &privatePorts[port];
+	CanBridgeStatisticT* statistic = &CanBridgeStatistic[port];
+	CanBridgePacketT packet;
+	CanBusFrameT* frame;
+
+	CanBridgePacketBegin(&packet, privateUplinkBuffer, sizeof(privateUplinkBuffer), bridge->TxSequence);
+
+	while (packet.Count < CAN_BRIDGE_BATCH_FRAMES
+			&& (frame = CanBusRingPeek(&bridge->Ring))
+			&& CanBridgePacketAdd(&packet, frame))
+	{
+		CanBusRingRelease(&bridge->Ring);
+	}
+
+	uint16_t length = CanBridgePacketEnd(&packet);
+	uint32_t address = privateRemoteAddress;
+
+	if (bridge->Socket == CAN_BRIDGE_INVALID_SOCKET || !address)
+	{
+		statistic->Discarded += packet.Count;
+		return;
+	}
+
+	//a datagram that failed is a gap in the sequence for the peer
+	bridge->TxSequence++;
+
+	if (privateSocketSend(bridge->Socket, privateUplinkBuffer, length, address, bridge->RemotePort) != length)
+	{
+		statistic->SendErrors++;
+		return;
+	}
+
+	statistic->TxDatagrams++;
+	statistic->TxFrames += packet.Count;
+	statistic->LatencySum += latency;
+
+	if (latency > statistic->LatencyMax)
+	{
+		statistic->LatencyMax = latency;
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief sends the full batches and the one its oldest frame is due for
+ * @return us until the oldest frame left is due, UINT32_MAX - the ring is empty
+ */
+static uint32_t privateFlush(uint8_t port)
+{
+	CanBusRingT* ring = &privatePorts[port].Ring;
+	CanBusFrameT* oldest;
+
+	while ((oldest = CanBusRingPeek(ring)))
+	{
+		uint64_t time = CanBusComponentGetTime();
+		uint32_t age = time > oldest->Timestamp ? (uint32_t)(time - oldest->Timestamp) : 0;
+
+		if (CanBusRingGetCount(ring) < CAN_BRIDGE_BATCH_FRAMES && age < CAN_BRIDGE_BATCH_DEADLINE)
+		{
+			return CAN_BRIDGE_BATCH_DEADLINE - age;
+		}
+
+		privateSend(port, age);
+	}
+
+	return UINT32_MAX;
+}
+//------------------------------------------------------------------------------
+static void privateUplinkTask(void* arg)
+{
+	while (true)
+	{
+		RTOS_CanBridgeUplinkTaskStackWaterMark = uxTaskGetStackHighWaterMark(NULL);
+
+		uint32_t wait = CAN_BRIDGE_IDLE_PERIOD * 1000;
+
+		for (uint8_t port = 0; port < CAN_BUS_PORTS_COUNT; port++)
+		{
+			uint32_t left = privateFlush(port);
+
+			if (left < wait)
+			{
+				wait = left;
+			}
+		}
+
+		//a tick at least: the deadline is met to the tick
+		TickType_t ticks = pdMS_TO_TICKS((wait + 999) / 1000);
+
+		ulTaskNotifyTake(pdTRUE, ticks ? ticks : 1);
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the sequence of the datagrams of the peer: a gap ahead is lost, a step back came late
+ * and takes one of the lost back. A run of them behind is a restarted peer: the sequence starts over.
+ */
+static void privateTrackSequence(CanBridgePortT* bridge, CanBridgeStatisticT* statistic, uint8_t sequence)
+{
+	uint8_t gap = sequence - bridge->RxSequence;
+
+	if (bridge->IsRxSynchronized && gap >= 0x80)
+	{
+		statistic->OutOfOrder++;
+
+		if (statistic->Lost)
+		{
+			statistic->Lost--;
+		}
+
+		if (++bridge->RxBehind < CAN_BRIDGE_RESYNC_DATAGRAMS)
+		{
+			return;
+		}
+	}
+	else if (bridge->IsRxSynchronized)
+	{
+		statistic->Lost += gap;
+	}
+
+	bridge->IsRxSynchronized = true;
+	bridge->RxBehind = 0;
+	bridge->RxSequence = sequence + 1;
+}
+//------------------------------------------------------------------------------
+static void privateHandleDatagram(uint8_t port, uint16_t size, uint32_t address)
+{
+	CanBridgePortT* bridge = &privatePorts[port];
+	CanBridgeStatisticT* statistic = &CanBridgeStatistic[port];
+	CanBridgeReaderT reader;
+	CanBusFrameT frame;
+
+	xResult result = CanBridgeReaderInit(&reader, privateDownlinkBuffer, size);
+
+	if (result != xResultAccept)
+	{
+		if (result == xResultError)
+		{
+			statistic->Malformed++;
+		}
+
+		return;
+	}
+
+	//the peer is the last sender unless it was given
+	if (!privateIsRemoteFixed)
+	{
+		privateRemoteAddress = address;
+	}
+
+	statistic->RxDatagrams++;
+
+	privateTrackSequence(bridge, statistic, reader.Sequence);
+
+	while (CanBridgeReaderNext(&reader, &frame))
+	{
+		if (CanBusComponentTransmit(port, &frame) == xResultAccept)
+		{
+			statistic->RxFrames++;
+		}
+		else
+		{
+			statistic->QueueOverflows++;
+		}
+	}
+
+	statistic->Skipped += reader.Skipped;
+
+	if (reader.IsMalformed)
+	{
+		statistic->Malformed++;
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief the sockets wait for the network, the uplink discards the frames meanwhile
+static void privateOpenSockets()
+{
+	for (uint8_t port = 0; port < CAN_BUS_PORTS_COUNT; port++)
+	{
+		CanBridgePortT* bridge = &privatePorts[port];
+
+		while (bridge->Socket == CAN_BRIDGE_INVALID_SOCKET)
+		{
+			bridge->Socket = privateSocketOpen(bridge->LocalPort);
+
+			if (bridge->Socket == CAN_BRIDGE_INVALID_SOCKET)
+			{
+				vTaskDelay(pdMS_TO_TICKS(CAN_BRIDGE_RETRY_PERIOD));
+			}
+		}
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief the datagrams of each socket are taken until it times out, then the next one
+static void privateDownlinkTask(void* arg)
+{
+	privateOpenSockets();
+
+	while (true)
+	{
+		RTOS_CanBridgeDownlinkTaskStackWaterMark = uxTaskGetStackHighWaterMark(NULL);
+
+		for (uint8_t port = 0; port < CAN_BUS_PORTS_COUNT; port++)
+		{
+			uint32_t address = 0;
+			int size;
+
+			while ((size = privateSocketReceive(privatePorts[port].Socket, privateDownlinkBuffer, sizeof(privateDownlinkBuffer), &address)) > 0)
+			{
+				privateHandleDatagram(port, size, address);
+			}
+
+			if (size < 0)
+			{
+				vTaskDelay(pdMS_TO_TICKS(CAN_BRIDGE_RECEIVE_TIMEOUT));
+			}
+		}
+	}
+}
+//------------------------------------------------------------------------------
+static uint8_t privateParseAddress(const char* text, uint32_t* address)
+{
+	uint8_t* octets = (uint8_t*)address;
+	char* end;
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		unsigned long value = strtoul(text, &end, 10);
+
+		if (end == text || value > 255 || (i < 3 && *end != '.'))
+		{
+			return false;
+		}
+
+		octets[i] = value;
+		text = end + 1;
+	}
+
+	return true;
+}
+//------------------------------------------------------------------------------
+static void privateReport(xPortT* port, const char* line)
+{
+	xPortStartTransmission(port);
+	xPortTransmitString(port, line);
+	xPortEndTransmission(port);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief "can-bridge [-r a.b.c.d]": the peer and the traffic of each bus both ways,
+ * the statistic is cleared after the report. 0.0.0.0 takes the sender of the last datagram again.
+ */
+static xResult privateCommand(xPortT* port, TerminalCommandArgumentsT* arguments)
+{
+	char line[256];
+
+	if (TerminalCommandCheckOptions(arguments, "r", NULL) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	char* option = TerminalCommandGetOption(arguments, 'r');
+
+	if (option)
+	{
+		uint32_t address = 0;
+
+		if (!privateParseAddress(option, &address))
+		{
+			return xResultError;
+		}
+
+		privateIsRemoteFixed = address != 0;
+		privateRemoteAddress = address;
+	}
+
+	uint32_t address = privateRemoteAddress;
+	uint8_t* octets = (uint8_t*)&address;
+
+	snprintf(line, sizeof(line), "[can-bridge] peer %u.%u.%u.%u, %s, batch %u frames, deadline %u us\r",
+				octets[0], octets[1], octets[2], octets[3],
+				privateIsRemoteFixed ? "fixed" : "the last sender",
+				CAN_BRIDGE_BATCH_FRAMES,
+				CAN_BRIDGE_BATCH_DEADLINE);
+
+	privateReport(port, line);
+
+	for (uint8_t number = 0; number < CAN_BUS_PORTS_COUNT; number++)
+	{
+		CanBridgePortT* bridge = &privatePorts[number];
+		CanBridgeStatisticT* statistic = &CanBridgeStatistic[number];
+		uint32_t datagrams = statistic->TxDatagrams ? statistic->TxDatagrams : 1;
+
+		//tenths of the frames per datagram
+		uint32_t frames = (uint32_t)((uint64_t)statistic->TxFrames * 10 / datagrams);
+
+		snprintf(line, sizeof(line), "[can-bridge] port %u udp %u up: datagrams %lu, frames %lu, %lu.%lu per datagram, latency avg %lu max %lu us, ring overflows %lu, ring peak %u/%u, discarded %lu, send errors %lu\r",
+					number + 1,
+					bridge->RemotePort,
+					statistic->TxDatagrams,
+					statistic->TxFrames,
+					frames / 10,
+					frames % 10,
+					(uint32_t)(statistic->LatencySum / datagrams),
+					statistic->LatencyMax,
+					statistic->RingOverflows,
+					bridge->Ring.Peak,
+					bridge->Ring.SizeMask,
+					statistic->Discarded,
+					statistic->SendErrors);
+
+		privateReport(port, line);
+
+		snprintf(line, sizeof(line), "[can-bridge] port %u udp %u down: datagrams %lu, frames %lu, lost %lu, out of order %lu, malformed %lu, skipped %lu, queue overflows %lu\r",
+					number + 1,
+					bridge->LocalPort,
+					statistic->RxDatagrams,
+					statistic->RxFrames,
+					statistic->Lost,
+					statistic->OutOfOrder,
+					statistic->Malformed,
+					statistic->Skipped,
+					statistic->QueueOverflows);
+
+		privateReport(port, line);
+
+		memset(statistic, 0, sizeof(CanBridgeStatisticT));
+		bridge->Ring.Peak = 0;
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static const TerminalCommandT privateCommands[] =
+{
+	{
+		.Name = "can-bridge",
+		.Usage = "[-r a.b.c.d]",
+		.Handler = privateCommand
+	}
+};
+//==============================================================================
+//initialization:
+
+/**
+ * @brief after CanBus: the frames of both buses are taken by a listener of its task,
+ * the sockets are opened by the downlink once the network is up
+ */
+xResult CanBridgeComponentInit(void* parent)
+{
+	TerminalCommandsAdd(privateCommands, sizeof(privateCommands) / sizeof(privateCommands[0]));
+
+	for (uint8_t port = 0; port < CAN_BUS_PORTS_COUNT; port++)
+	{
+		CanBusRingInit(&privatePorts[port].Ring, privateFrames[port], CAN_BRIDGE_RING_SIZE_MASK);
+	}
+
+	uplinkTaskHandle = xTaskCreateStatic(privateUplinkTask, // Function that implements the task.
+											"can bridge up task", // Text name for the task.
+											CAN_BRIDGE_UPLINK_TASK_STACK_SIZE, // Number of indexes in the xStack array.
+											NULL, // Parameter passed into the task.
+											osPriorityNormal, // Priority at which the task is created.
+											uplinkTaskStack, // Array to use as the task's stack.
+											&uplinkTaskBuffer);
+
+	downlinkTaskHandle = xTaskCreateStatic(privateDownlinkTask, // Function that implements the task.
+											"can bridge down task", // Text name for the task.
+											CAN_BRIDGE_DOWNLINK_TASK_STACK_SIZE, // Number of indexes in the xStack array.
+											NULL, // Parameter passed into the task.
+											osPriorityNormal, // Priority at which the task is created.
+											downlinkTaskStack, // Array to use as the task's stack.
+											&downlinkTaskBuffer);
+
+	return CanBusComponentAddListener(privateFrameListener, NULL);
+}
+//==============================================================================
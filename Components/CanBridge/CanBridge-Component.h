@@ -0,0 +1,57 @@
+//==============================================================================
+//header:
+
+#ifndef _CAN_BRIDGE_COMPONENT_H_
+#define _CAN_BRIDGE_COMPONENT_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "CanBridge-ComponentConfig.h"
+#include "CanBridgePacket.h"
+#include "Abstractions/xPort/xPort.h"
+//==============================================================================
+//types:
+
+typedef struct
+{
+	uint32_t TxDatagrams;
+	uint32_t TxFrames;
+	uint32_t RingOverflows; //the frames of the bus that did not fit the ring
+	uint32_t Discarded; //the frames without a socket or a peer to send to
+	uint32_t SendErrors;
+
+	uint64_t LatencySum; //us from the SOF of the oldest frame of a datagram to its send
+	uint32_t LatencyMax;
+
+	uint32_t RxDatagrams;
+	uint32_t RxFrames; //put to the transmit queue
+	uint32_t Lost; //datagrams missing from the sequence
+	uint32_t OutOfOrder; //came after a later one
+	uint32_t Malformed;
+	uint32_t Skipped; //CAN FD and error frames
+	uint32_t QueueOverflows; //the transmit queue of the controller was full
+
+} CanBridgeStatisticT;
+//==============================================================================
+//functions:
+
+xResult CanBridgeComponentInit(void* parent);
+//==============================================================================
+//override:
+
+#define CanBridgeComponentHandler()
+#define CanBridgeComponentTimeSynchronization()
+//==============================================================================
+//export:
+
+extern CanBridgeStatisticT CanBridgeStatistic[CAN_BUS_PORTS_COUNT];
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_CAN_BRIDGE_COMPONENT_H_
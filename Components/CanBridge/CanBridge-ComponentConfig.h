@@ -0,0 +1,49 @@
+//==============================================================================
+//header:
+
+#ifndef _CAN_BRIDGE_COMPONENT_CONFIG_H_
+#define _CAN_BRIDGE_COMPONENT_CONFIG_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+#include "Net/Net-ComponentConfig.h"
+#include "CanBus/CanBus-ComponentConfig.h"
+//==============================================================================
+//defines:
+
+#define CAN_BRIDGE_COMPONENT_MAIN_TASK_STACK_SECTION __attribute__((section("._user_heap_stack")))
+#define CAN_BRIDGE_MEM_SECTION __attribute__((section("._user_heap_stack")))
+
+#define CAN_BRIDGE_UPLINK_TASK_STACK_SIZE 0x180 //the frames of the buses to the datagrams
+#define CAN_BRIDGE_DOWNLINK_TASK_STACK_SIZE 0x180 //the datagrams to the transmit queues
+
+//a loaded 1 Mbit/s bus brings up to 20 frames per ms: the ring rides out 12 ms of a stalled network
+#define CAN_BRIDGE_RING_SIZE_MASK 0xff
+#define CAN_BRIDGE_BATCH_FRAMES 64 //a full datagram is sent at once: 5 + 64 * 13 bytes at most
+#define CAN_BRIDGE_BATCH_DEADLINE 1000 //us from the SOF of the oldest frame to the send of its datagram
+#define CAN_BRIDGE_IDLE_PERIOD 100 //ms of the uplink without frames
+
+#define CAN_BRIDGE_DATAGRAM_SIZE 1472 //the payload of a UDP datagram in an Ethernet frame
+#define CAN_BRIDGE_RECEIVE_TIMEOUT 1 //ms, the downlink polls the sockets of both buses in turn
+#define CAN_BRIDGE_SEND_TIMEOUT 10 //ms
+#define CAN_BRIDGE_RETRY_PERIOD 1000 //ms between the attempts to open the sockets
+#define CAN_BRIDGE_RESYNC_DATAGRAMS 16 //datagrams in a row behind the sequence: the peer restarted
+
+#define CAN_BRIDGE_REMOTE_ADDRESS 0 //network byte order, 0 - the sender of the last datagram
+
+//one cannelloni instance per bus: its own pair of UDP ports
+#define CAN_BRIDGE_PORT1_LOCAL_PORT 20000
+#define CAN_BRIDGE_PORT1_REMOTE_PORT 20000
+#define CAN_BRIDGE_PORT2_LOCAL_PORT 20001
+#define CAN_BRIDGE_PORT2_REMOTE_PORT 20001
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_CAN_BRIDGE_COMPONENT_CONFIG_H_
@@ -0,0 +1,186 @@
+//==============================================================================
+//includes:
+
+#include <string.h>
+#include "CanBridgePacket.h"
+//==============================================================================
+//functions:
+
+static inline void privateWrite32(uint8_t* data, uint32_t value)
+{
+	data[0] = value >> 24;
+	data[1] = value >> 16;
+	data[2] = value >> 8;
+	data[3] = value;
+}
+//------------------------------------------------------------------------------
+static inline uint32_t privateRead32(const uint8_t* data)
+{
+	return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+}
+//------------------------------------------------------------------------------
+/// @brief the header of the datagram, its count is written by CanBridgePacketEnd
+void CanBridgePacketBegin(CanBridgePacketT* packet, uint8_t* buffer, uint16_t size, uint8_t sequence)
+{
+	packet->Buffer = buffer;
+	packet->Size = size;
+	packet->Count = 0;
+	packet->Length = CAN_BRIDGE_PACKET_HEADER_SIZE;
+
+	buffer[0] = CAN_BRIDGE_PACKET_VERSION;
+	buffer[1] = CAN_BRIDGE_PACKET_DATA;
+	buffer[2] = sequence;
+}
+//------------------------------------------------------------------------------
+/// @return false - the frame does not fit the datagram, it is not added
+bool CanBridgePacketAdd(CanBridgePacketT* packet, const CanBusFrameT* frame)
+{
+	bool isRemote = frame->Flags & CAN_BUS_FRAME_REMOTE;
+	uint8_t length = frame->Dlc > 8 ? 8 : frame->Dlc;
+	uint16_t size = 5 + (isRemote ? 0 : length);
+
+	if (packet->Length + size > packet->Size || packet->Count == UINT16_MAX)
+	{
+		return false;
+	}
+
+	uint32_t id = frame->Flags & CAN_BUS_FRAME_EXTENDED
+			? (frame->Id & CAN_BRIDGE_PACKET_EFF_MASK) | CAN_BRIDGE_PACKET_EFF_FLAG
+			: frame->Id & CAN_BRIDGE_PACKET_SFF_MASK;
+
+	if (isRemote)
+	{
+		id |= CAN_BRIDGE_PACKET_RTR_FLAG;
+	}
+
+	uint8_t* data = packet->Buffer + packet->Length;
+
+	privateWrite32(data, id);
+	data[4] = length;
+
+	//a remote frame carries its length only
+	if (!isRemote)
+	{
+		memcpy(data + 5, frame->Data, length);
+	}
+
+	packet->Length += size;
+	packet->Count++;
+
+	return true;
+}
+//------------------------------------------------------------------------------
+/// @return bytes of the datagram
+uint16_t CanBridgePacketEnd(CanBridgePacketT* packet)
+{
+	packet->Buffer[3] = packet->Count >> 8;
+	packet->Buffer[4] = packet->Count;
+
+	return packet->Length;
+}
+//------------------------------------------------------------------------------
+/**
+ * @return xResultAccept - the frames follow, xResultNotSupported - another version or
+ * op_code, xResultError - shorter than the header
+ */
+xResult CanBridgeReaderInit(CanBridgeReaderT* reader, const uint8_t* data, uint16_t size)
+{
+	memset(reader, 0, sizeof(CanBridgeReaderT));
+
+	if (size < CAN_BRIDGE_PACKET_HEADER_SIZE)
+	{
+		return xResultError;
+	}
+
+	if (data[0] != CAN_BRIDGE_PACKET_VERSION || data[1] != CAN_BRIDGE_PACKET_DATA)
+	{
+		return xResultNotSupported;
+	}
+
+	reader->Data = data;
+	reader->Size = size;
+	reader->Offset = CAN_BRIDGE_PACKET_HEADER_SIZE;
+	reader->Sequence = data[2];
+	reader->Count = ((uint16_t)data[3] << 8) | data[4];
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/// @return false - no frames left or the datagram is malformed
+bool CanBridgeReaderNext(CanBridgeReaderT* reader, CanBusFrameT* frame)
+{
+	while (reader->Count)
+	{
+		const uint8_t* data = reader->Data + reader->Offset;
+		uint16_t left = reader->Size - reader->Offset;
+
+		if (left < 5)
+		{
+			break;
+		}
+
+		uint32_t id = privateRead32(data);
+		uint8_t length = data[4];
+		uint16_t size = 5;
+		bool isFd = length & CAN_BRIDGE_PACKET_FD_FRAME;
+
+		if (isFd)
+		{
+			length &= ~CAN_BRIDGE_PACKET_FD_FRAME;
+			size++;
+		}
+
+		if (!(id & CAN_BRIDGE_PACKET_RTR_FLAG))
+		{
+			size += length;
+		}
+
+		if ((isFd ? length > CAN_BRIDGE_PACKET_FD_DATA_MAX : length > 8) || size > left)
+		{
+			break;
+		}
+
+		reader->Offset += size;
+		reader->Count--;
+
+		if (isFd || (id & CAN_BRIDGE_PACKET_ERR_FLAG))
+		{
+			reader->Skipped++;
+			continue;
+		}
+
+		memset(frame, 0, sizeof(CanBusFrameT));
+
+		if (id & CAN_BRIDGE_PACKET_EFF_FLAG)
+		{
+			frame->Id = id & CAN_BRIDGE_PACKET_EFF_MASK;
+			frame->Flags = CAN_BUS_FRAME_EXTENDED;
+		}
+		else
+		{
+			frame->Id = id & CAN_BRIDGE_PACKET_SFF_MASK;
+		}
+
+		frame->Dlc = length;
+
+		if (id & CAN_BRIDGE_PACKET_RTR_FLAG)
+		{
+			frame->Flags |= CAN_BUS_FRAME_REMOTE;
+		}
+		else
+		{
+			memcpy(frame->Data, data + size - length, length);
+		}
+
+		return true;
+	}
+
+	if (reader->Count)
+	{
+		reader->IsMalformed = true;
+		reader->Count = 0;
+	}
+
+	return false;
+}
+//==============================================================================
@@ -0,0 +1,74 @@
+//==============================================================================
+//header:
+
+#ifndef _CAN_BRIDGE_PACKET_H_
+#define _CAN_BRIDGE_PACKET_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "CanBus/CanBusRing.h"
+//==============================================================================
+//defines:
+
+//cannelloni v2 over UDP: the header, then the frames as SocketCAN writes can_frame
+#define CAN_BRIDGE_PACKET_VERSION 2
+#define CAN_BRIDGE_PACKET_DATA 0 //op_code of the frames, ACK and NACK are for SCTP
+#define CAN_BRIDGE_PACKET_HEADER_SIZE 5 //version, op_code, seq_no, count (big endian)
+#define CAN_BRIDGE_PACKET_FRAME_SIZE_MAX 13 //can_id (big endian), len, data[8]
+
+//can_id of SocketCAN
+#define CAN_BRIDGE_PACKET_EFF_FLAG 0x80000000
+#define CAN_BRIDGE_PACKET_RTR_FLAG 0x40000000
+#define CAN_BRIDGE_PACKET_ERR_FLAG 0x20000000
+#define CAN_BRIDGE_PACKET_EFF_MASK 0x1fffffff
+#define CAN_BRIDGE_PACKET_SFF_MASK 0x7ff
+
+#define CAN_BRIDGE_PACKET_FD_FRAME 0x80 //in len: a flags byte and up to 64 bytes follow
+#define CAN_BRIDGE_PACKET_FD_DATA_MAX 64
+//==============================================================================
+//types:
+
+/// @brief a datagram being filled
+typedef struct
+{
+	uint8_t* Buffer;
+	uint16_t Size;
+
+	uint16_t Length;
+	uint16_t Count;
+
+} CanBridgePacketT;
+//------------------------------------------------------------------------------
+/// @brief a received datagram taken frame by frame
+typedef struct
+{
+	const uint8_t* Data;
+	uint16_t Size;
+
+	uint16_t Offset;
+	uint16_t Count; //frames the header announced that were not taken yet
+	uint8_t Sequence;
+
+	uint16_t Skipped; //CAN FD and error frames, the controllers send neither
+	bool IsMalformed; //the datagram ended inside a frame or before its count
+
+} CanBridgeReaderT;
+//==============================================================================
+//functions:
+
+void CanBridgePacketBegin(CanBridgePacketT* packet, uint8_t* buffer, uint16_t size, uint8_t sequence);
+bool CanBridgePacketAdd(CanBridgePacketT* packet, const CanBusFrameT* frame);
+uint16_t CanBridgePacketEnd(CanBridgePacketT* packet);
+
+xResult CanBridgeReaderInit(CanBridgeReaderT* reader, const uint8_t* data, uint16_t size);
+bool CanBridgeReaderNext(CanBridgeReaderT* reader, CanBusFrameT* frame);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_CAN_BRIDGE_PACKET_H_
@@ -0,0 +1,438 @@
+//==============================================================================
+//includes:
+
+#include <string.h>
+#include "CanBus-Adapter.h"
+//==============================================================================
+//defines:
+
+//RF1R has the bits of RF0R at the same places
+#define CAN_BUS_RF_FMP CAN_RF0R_FMP0
+#define CAN_BUS_RF_FULL CAN_RF0R_FULL0
+#define CAN_BUS_RF_FOVR CAN_RF0R_FOVR0
+#define CAN_BUS_RF_RFOM CAN_RF0R_RFOM0
+
+//TSR: the bits of mailbox 1 and 2 follow those of mailbox 0 by 8 and 16
+#define CAN_BUS_TSR_SENT (CAN_TSR_RQCP0 | CAN_TSR_TXOK0)
+#define CAN_BUS_TX_MAILBOXES_COUNT 3
+//==============================================================================
+//functions:
+
+static inline volatile uint32_t* privateGetFifoRegister(CAN_TypeDef* can, CanBusFifoT fifo)
+{
+	return fifo == CanBusFifoBulk ? &can->RF0R : &can->RF1R;
+}
+//------------------------------------------------------------------------------
+/// @brief RIxR and TIxR, RDTxR and TDTxR share the layout of the identifier and the length
+static inline void privateReadFrame(uint32_t identifier, uint32_t length, uint32_t low, uint32_t high, CanBusFrameT* frame)
+{
+	if (identifier & CAN_RI0R_IDE)
+	{
+		frame->Id = (identifier & (CAN_RI0R_EXID_Msk | CAN_RI0R_STID_Msk)) >> CAN_RI0R_EXID_Pos;
+		frame->Flags = CAN_BUS_FRAME_EXTENDED;
+	}
+	else
+	{
+		frame->Id = identifier >> CAN_RI0R_STID_Pos;
+		frame->Flags = 0;
+	}
+
+	if (identifier & CAN_RI0R_RTR)
+	{
+		frame->Flags |= CAN_BUS_FRAME_REMOTE;
+	}
+
+	frame->Dlc = length & CAN_RDT0R_DLC;
+
+	memcpy(frame->Data, &low, sizeof(low));
+	memcpy(frame->Data + sizeof(low), &high, sizeof(high));
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the ticks of the timer: the interrupts of both controllers and the task extend the
+ * same count, it is read and extended with the interrupts masked
+ */
+uint64_t CanBusAdapterReadTime(CanBusTimeT* time, TIM_TypeDef* timer)
+{
+	uint32_t mask = __get_PRIMASK();
+
+	__disable_irq();
+
+	uint64_t ticks = CanBusTimeExtend(time, timer->CNT);
+
+	__set_PRIMASK(mask);
+
+	return ticks;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the SOF of the frame on the system time base from the TIME of RDTxR or TDTxR,
+ * the time it was read without TTCM. The receive and transmit interrupts preempt each other:
+ * the timer and the sync are taken with the interrupts masked.
+ */
+static void privateStamp(CanBusAdapterT* adapter, CanBusFrameT* frame, uint32_t length)
+{
+	if (!adapter->Time)
+	{
+		return;
+	}
+
+	uint32_t mask = __get_PRIMASK();
+
+	__disable_irq();
+
+	uint64_t ticks = CanBusTimeExtend(adapter->Time, adapter->Timer->CNT);
+
+	if (adapter->Sync.TicksPerBit)
+	{
+		ticks = CanBusTimeSyncStamp(&adapter->Sync,
+									ticks,
+									(length & CAN_RDT0R_TIME) >> CAN_RDT0R_TIME_Pos,
+									CanBusTimeGetFrameBits(frame));
+	}
+
+	__set_PRIMASK(mask);
+
+	frame->Timestamp = CanBusTimeToMicroseconds(adapter->Time, ticks);
+}
+//------------------------------------------------------------------------------
+static inline void privateReadMailbox(CanBusAdapterT* adapter, CAN_FIFOMailBox_TypeDef* mailbox, CanBusFifoT fifo, CanBusFrameT* frame)
+{
+	uint32_t length = mailbox->RDTR;
+
+	privateReadFrame(mailbox->RIR, length, mailbox->RDLR, mailbox->RDHR, frame);
+
+	frame->FilterIndex = (length & CAN_RDT0R_FMI) >> CAN_RDT0R_FMI_Pos;
+	frame->Fifo = fifo;
+
+	privateStamp(adapter, frame, length);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief FMP and FOVR of one FIFO: every pending frame goes to its ring and the output
+ * mailbox is released at once, a frame that does not fit the ring is dropped and counted
+ */
+void CanBusAdapterRxIRQ(CanBusAdapterT* adapter, CanBusFifoT fifo)
+{
+	CAN_TypeDef* can = adapter->Handle->Instance;
+	volatile uint32_t* status = privateGetFifoRegister(can, fifo);
+	CAN_FIFOMailBox_TypeDef* mailbox = &can->sFIFOMailBox[fifo];
+	CanBusRingT* ring = &adapter->Rings[fifo];
+	CanBusFifoStatisticT* statistic = &adapter->Statistic[fifo];
+	uint8_t pending = *status & CAN_BUS_RF_FMP;
+
+	statistic->Irqs++;
+
+	if (pending > statistic->FifoPeak)
+	{
+		statistic->FifoPeak = pending;
+	}
+
+	while (*status & CAN_BUS_RF_FMP)
+	{
+		CanBusFrameT* frame = CanBusRingReserve(ring);
+
+		if (frame)
+		{
+			privateReadMailbox(adapter, mailbox, fifo, frame);
+			CanBusRingCommit(ring);
+			statistic->Frames++;
+		}
+		else
+		{
+			statistic->RingOverflows++;
+		}
+
+		*status = CAN_BUS_RF_RFOM;
+
+		//RFOM is cleared by the hardware when the next frame is in the output mailbox
+		while (*status & CAN_BUS_RF_RFOM)
+		{
+		}
+	}
+
+	if (*status & CAN_BUS_RF_FOVR)
+	{
+		statistic->FifoOverruns++;
+	}
+
+	//rc_w1: FMP and RFOM are not touched by the zeros
+	*status = CAN_BUS_RF_FOVR | CAN_BUS_RF_FULL;
+
+	if (adapter->RxTask)
+	{
+		BaseType_t woken = pdFALSE;
+
+		vTaskNotifyGiveFromISR(adapter->RxTask, &woken);
+		portYIELD_FROM_ISR(woken);
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the completed mailboxes that were sent go to the TX ring with the stamp of their SOF,
+ * called before the CAN-Ports driver clears RQCP and refills the mailboxes
+ */
+void CanBusAdapterTxIRQ(CanBusAdapterT* adapter)
+{
+	CAN_TypeDef* can = adapter->Handle->Instance;
+	uint32_t status = can->TSR;
+
+	adapter->TxStatistic.Irqs++;
+
+	for (uint8_t i = 0; i < CAN_BUS_TX_MAILBOXES_COUNT; i++)
+	{
+		uint32_t sent = CAN_BUS_TSR_SENT << (i * 8);
+
+		if ((status & sent) != sent)
+		{
+			continue;
+		}
+
+		CAN_TxMailBox_TypeDef* mailbox = &can->sTxMailBox[i];
+		CanBusFrameT* frame = CanBusRingReserve(&adapter->TxRing);
+
+		if (!frame)
+		{
+			adapter->TxStatistic.RingOverflows++;
+			continue;
+		}
+
+		privateReadFrame(mailbox->TIR, mailbox->TDTR, mailbox->TDLR, mailbox->TDHR, frame);
+
+		frame->Flags |= CAN_BUS_FRAME_TRANSMITTED;
+		frame->FilterIndex = 0;
+		frame->Fifo = 0;
+
+		privateStamp(adapter, frame, mailbox->TDTR);
+
+		CanBusRingCommit(&adapter->TxRing);
+		adapter->TxStatistic.Frames++;
+	}
+
+	if (adapter->RxTask)
+	{
+		BaseType_t woken = pdFALSE;
+
+		vTaskNotifyGiveFromISR(adapter->RxTask, &woken);
+		portYIELD_FROM_ISR(woken);
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the queued frames go to the empty mailboxes: the CAN-Ports driver loads them too,
+ * the controller sends whichever it holds by the priority of the identifier.
+ * Called from the transmit interrupt and from the tasks with the interrupts masked.
+ */
+static void privateLoadMailboxes(CanBusAdapterT* adapter)
+{
+	CAN_TypeDef* can = adapter->Handle->Instance;
+	CanBusFrameT* frame;
+
+	while ((can->TSR & CAN_TSR_TME) && (frame = CanBusRingPeek(&adapter->TxQueue)))
+	{
+		//CODE: the number of an empty mailbox while any is empty
+		CAN_TxMailBox_TypeDef* mailbox = &can->sTxMailBox[(can->TSR & CAN_TSR_CODE) >> CAN_TSR_CODE_Pos];
+		uint32_t identifier = frame->Flags & CAN_BUS_FRAME_EXTENDED
+				? (frame->Id << CAN_TI0R_EXID_Pos) | CAN_TI0R_IDE
+				: frame->Id << CAN_TI0R_STID_Pos;
+		uint32_t low;
+		uint32_t high;
+
+		if (frame->Flags & CAN_BUS_FRAME_REMOTE)
+		{
+			identifier |= CAN_TI0R_RTR;
+		}
+
+		memcpy(&low, frame->Data, sizeof(low));
+		memcpy(&high, frame->Data + sizeof(low), sizeof(high));
+
+		mailbox->TDTR = frame->Dlc > 8 ? 8 : frame->Dlc;
+		mailbox->TDLR = low;
+		mailbox->TDHR = high;
+		mailbox->TIR = identifier | CAN_TI0R_TXRQ;
+
+		CanBusRingRelease(&adapter->TxQueue);
+	}
+
+	//the rest follows when a mailbox is sent
+	if (CanBusRingGetCount(&adapter->TxQueue))
+	{
+		SET_BIT(can->IER, CAN_IER_TMEIE);
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief the transmit interrupt after the CAN-Ports driver and the tasks that may miss it
+void CanBusAdapterLoadMailboxes(CanBusAdapterT* adapter)
+{
+	if (!adapter->Handle || !adapter->TxQueue.Frames)
+	{
+		return;
+	}
+
+	uint32_t mask = __get_PRIMASK();
+
+	__disable_irq();
+
+	privateLoadMailboxes(adapter);
+
+	__set_PRIMASK(mask);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the frame goes to the queue of the controller and to a mailbox if one is empty,
+ * the callers of any task share the queue: it is written with the interrupts masked
+ * @return xResultBusy - the queue is full, the frame is not sent
+ */
+xResult CanBusAdapterTransmit(CanBusAdapterT* adapter, const CanBusFrameT* frame)
+{
+	if (!adapter->Handle || !adapter->TxQueue.Frames)
+	{
+		return xResultError;
+	}
+
+	xResult result = xResultBusy;
+	uint32_t mask = __get_PRIMASK();
+
+	__disable_irq();
+
+	CanBusFrameT* entry = CanBusRingReserve(&adapter->TxQueue);
+
+	if (entry)
+	{
+		*entry = *frame;
+		CanBusRingCommit(&adapter->TxQueue);
+
+		adapter->TxStatistic.Queued++;
+		result = xResultAccept;
+
+		privateLoadMailboxes(adapter);
+	}
+	else
+	{
+		adapter->TxStatistic.QueueOverflows++;
+	}
+
+	__set_PRIMASK(mask);
+
+	return result;
+}
+//------------------------------------------------------------------------------
+void CanBusAdapterSetRxTask(CanBusAdapterT* adapter, TaskHandle_t task)
+{
+	adapter->RxTask = task;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief writes the banks to the filters of CAN1, the master of both controllers: the banks
+ * that are not in the list are deactivated. Of the banks that match a frame the controller
+ * takes the 32-bit over the 16-bit, the list over the mask, then the lower number.
+ */
+void CanBusAdapterApplyFilters(CAN_HandleTypeDef* master, const CanBusFilterBankT* banks, uint8_t count, uint8_t slaveStartBank)
+{
+	CAN_TypeDef* can = master->Instance;
+	uint32_t active = 0;
+
+	SET_BIT(can->FMR, CAN_FMR_FINIT);
+
+	MODIFY_REG(can->FMR, CAN_FMR_CAN2SB, (uint32_t)slaveStartBank << CAN_FMR_CAN2SB_Pos);
+
+	can->FA1R = 0;
+
+	for (uint8_t i = 0; i < count; i++)
+	{
+		const CanBusFilterBankT* bank = &banks[i];
+		uint32_t bit = 1UL << bank->Number;
+
+		if (bank->Number >= CAN_BUS_FILTER_BANKS_COUNT)
+		{
+			continue;
+		}
+
+		can->sFilterRegister[bank->Number].FR1 = bank->Registers[0];
+		can->sFilterRegister[bank->Number].FR2 = bank->Registers[1];
+
+		MODIFY_REG(can->FM1R, bit, bank->IsList ? bit : 0);
+		MODIFY_REG(can->FS1R, bit, bank->Is32Bit ? bit : 0);
+		MODIFY_REG(can->FFA1R, bit, bank->Fifo == CanBusFifoPriority ? bit : 0);
+
+		active |= bit;
+	}
+
+	can->FA1R = active;
+
+	CLEAR_BIT(can->FMR, CAN_FMR_FINIT);
+}
+//==============================================================================
+//initialization:
+
+/// @brief the timer ticks of one bit time: the controller counts the APB1 clock by BRP and the quanta of a bit
+static uint32_t privateGetTicksPerBit(CAN_TypeDef* can, uint32_t frequency)
+{
+	uint32_t timing = can->BTR;
+	uint32_t prescaler = (timing & CAN_BTR_BRP) + 1;
+	uint32_t quanta = 3 + ((timing & CAN_BTR_TS1) >> CAN_BTR_TS1_Pos) + ((timing & CAN_BTR_TS2) >> CAN_BTR_TS2_Pos);
+
+	return (uint32_t)((uint64_t)prescaler * quanta * frequency / HAL_RCC_GetPCLK1Freq());
+}
+//------------------------------------------------------------------------------
+
+/**
+ * @brief takes over the receive of the controller: both FIFOs interrupt, the frames go to
+ * the rings of the adapter. The transmit stays with the CAN-Ports driver, the frames of
+ * CanBusAdapterTransmit share the mailboxes with it.
+ */
+xResult CanBusAdapterInit(CanBusAdapterT* adapter, CanBusAdapterInitT* init)
+{
+	if (!adapter || !init || !init->Handle)
+	{
+		return xResultError;
+	}
+
+	memset(adapter, 0, sizeof(CanBusAdapterT));
+
+	for (uint8_t fifo = 0; fifo < CanBusFifosCount; fifo++)
+	{
+		CanBusRingInit(&adapter->Rings[fifo], init->Frames[fifo], init->SizeMasks[fifo]);
+
+		//the receive calls the FreeRTOS API: it may not stay above configMAX_SYSCALL_INTERRUPT_PRIORITY
+		HAL_NVIC_SetPriority(init->Irqs[fifo], init->IrqPriorities[fifo], 0);
+		HAL_NVIC_EnableIRQ(init->Irqs[fifo]);
+	}
+
+	if (init->TxFrames)
+	{
+		CanBusRingInit(&adapter->TxRing, init->TxFrames, init->TxSizeMask);
+	}
+
+	if (init->TxQueueFrames)
+	{
+		CanBusRingInit(&adapter->TxQueue, init->TxQueueFrames, init->TxQueueSizeMask);
+	}
+
+	adapter->Time = init->Time;
+	adapter->Timer = init->Timer;
+
+	//TTCM is written in the init mode only: a controller started by another driver is stamped at the read
+	if (init->Handle->State == HAL_CAN_STATE_READY)
+	{
+		SET_BIT(init->Handle->Instance->MCR, CAN_MCR_TTCM);
+	}
+
+	if (adapter->Time && READ_BIT(init->Handle->Instance->MCR, CAN_MCR_TTCM))
+	{
+		CanBusTimeSyncInit(&adapter->Sync, privateGetTicksPerBit(init->Handle->Instance, adapter->Time->Frequency));
+	}
+
+	//the interrupts of the controller come to the adapter from here
+	adapter->Handle = init->Handle;
+
+	if (init->Handle->State == HAL_CAN_STATE_READY)
+	{
+		HAL_CAN_Start(init->Handle);
+	}
+
+	SET_BIT(init->Handle->Instance->IER, CAN_IER_FMPIE0 | CAN_IER_FOVIE0 | CAN_IER_FMPIE1 | CAN_IER_FOVIE1);
+
+	return xResultAccept;
+}
+//==============================================================================
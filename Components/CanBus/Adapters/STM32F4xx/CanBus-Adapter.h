@@ -0,0 +1,112 @@
+//==============================================================================
+//header:
+
+#ifndef _CAN_BUS_ADAPTER_H_
+#define _CAN_BUS_ADAPTER_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+#include "CanBus/CanBusRing.h"
+#include "CanBus/CanBusFilter.h"
+#include "CanBus/CanBusTime.h"
+#include "main.h"
+#include "FreeRTOS.h"
+#include "task.h"
+//==============================================================================
+//types:
+
+typedef enum
+{
+	CanBusFifoBulk, //FIFO0: everything the priority filters do not take
+	CanBusFifoPriority, //FIFO1: the identifiers of the priority filters, own interrupt
+
+	CanBusFifosCount
+
+} CanBusFifoT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Frames; //put to the ring
+	uint32_t Irqs;
+	uint32_t FifoOverruns; //FOVR: a frame came to the full FIFO of the controller and was lost
+	uint32_t RingOverflows; //taken from the FIFO with the ring full and dropped
+	uint8_t FifoPeak; //the most pending frames seen on entry of the interrupt, 3 - full
+
+} CanBusFifoStatisticT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Frames; //completed mailboxes put to the ring
+	uint32_t Irqs;
+	uint32_t RingOverflows;
+
+	uint32_t Queued; //taken by CanBusAdapterTransmit
+	uint32_t QueueOverflows; //refused with the queue full
+
+} CanBusTxStatisticT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	CAN_HandleTypeDef* Handle;
+
+	CanBusRingT Rings[CanBusFifosCount];
+	CanBusFifoStatisticT Statistic[CanBusFifosCount];
+
+	CanBusRingT TxRing; //the sent frames with their stamps
+	CanBusRingT TxQueue; //the frames to send, loaded into the free mailboxes
+	CanBusTxStatisticT TxStatistic;
+
+	CanBusTimeT* Time; //shared by the controllers
+	TIM_TypeDef* Timer;
+	CanBusTimeSyncT Sync; //the CAN timer of the controller on Time, TicksPerBit 0 - no TTCM
+
+	TaskHandle_t RxTask; //notified by both receive interrupts, 0 - polled
+
+} CanBusAdapterT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	CAN_HandleTypeDef* Handle;
+
+	IRQn_Type Irqs[CanBusFifosCount]; //moved to the priorities below, the events use the FreeRTOS API
+	uint8_t IrqPriorities[CanBusFifosCount];
+
+	CanBusFrameT* Frames[CanBusFifosCount];
+	uint16_t SizeMasks[CanBusFifosCount];
+
+	CanBusFrameT* TxFrames;
+	uint16_t TxSizeMask;
+
+	CanBusFrameT* TxQueueFrames; //0 - the adapter does not transmit
+	uint16_t TxQueueSizeMask;
+
+	CanBusTimeT* Time;
+	TIM_TypeDef* Timer; //32-bit, free-running at Time->Frequency
+
+} CanBusAdapterInitT;
+//==============================================================================
+//functions:
+
+xResult CanBusAdapterInit(CanBusAdapterT* adapter, CanBusAdapterInitT* init);
+
+void CanBusAdapterSetRxTask(CanBusAdapterT* adapter, TaskHandle_t task);
+void CanBusAdapterRxIRQ(CanBusAdapterT* adapter, CanBusFifoT fifo);
+void CanBusAdapterTxIRQ(CanBusAdapterT* adapter);
+
+xResult CanBusAdapterTransmit(CanBusAdapterT* adapter, const CanBusFrameT* frame);
+void CanBusAdapterLoadMailboxes(CanBusAdapterT* adapter);
+
+uint64_t CanBusAdapterReadTime(CanBusTimeT* time, TIM_TypeDef* timer);
+
+void CanBusAdapterApplyFilters(CAN_HandleTypeDef* master, const CanBusFilterBankT* banks, uint8_t count, uint8_t slaveStartBank);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_CAN_BUS_ADAPTER_H_
@@ -0,0 +1,675 @@
+//==============================================================================
+//header:
+
+
+//==============================================================================
+//includes:
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CanBus-Component.h"
+#include "Components.h"
+#include "TerminalCommands/TerminalCommands.h"
+//==============================================================================
+//types:
+
+typedef struct
+{
+	CanBusAdapterInitT Adapter;
+
+	const CanBusSubscriptionT* Subscriptions;
+	uint8_t SubscriptionsCount;
+	bool IsSlave;
+
+} CanBusPortInitT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	CanBusFrameListenerT Listener;
+	void* Context;
+
+} CanBusListenerT;
+//------------------------------------------------------------------------------
+/// @brief the frames the banks took beyond the subscriptions, checked while the set is not exact
+typedef struct
+{
+	uint32_t Accepted;
+	uint32_t Dropped;
+
+} CanBusSoftwareFilterT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Min;
+	uint32_t Max;
+	uint64_t Sum;
+	uint64_t Last; //0 - no frame yet
+
+} CanBusIntervalT;
+//------------------------------------------------------------------------------
+/// @brief the intervals of one identifier by the stamps of the frames and by the time the task took them
+typedef struct
+{
+	bool IsEnabled;
+	uint8_t Port;
+	uint32_t Id;
+
+	uint32_t Count;
+	CanBusIntervalT Stamp;
+	CanBusIntervalT Task;
+
+} CanBusJitterT;
+//==============================================================================
+//variables:
+
+static TaskHandle_t taskHandle;
+static StaticTask_t taskBuffer;
+static StackType_t taskStack[CAN_BUS_TASK_STACK_SIZE] CAN_BUS_COMPONENT_MAIN_TASK_STACK_SECTION;
+
+static int RTOS_CanBusTaskStackWaterMark;
+
+#if CAN_BUS_PORT1_ENABLE == 1
+static CanBusFrameT privatePort1BulkFrames[CAN_BUS_PORT1_BULK_RING_SIZE_MASK + 1] CAN_BUS_MEM_SECTION;
+static CanBusFrameT privatePort1PriorityFrames[CAN_BUS_PORT1_PRIORITY_RING_SIZE_MASK + 1] CAN_BUS_MEM_SECTION;
+static CanBusFrameT privatePort1TxFrames[CAN_BUS_PORT1_TX_RING_SIZE_MASK + 1] CAN_BUS_MEM_SECTION;
+static CanBusFrameT privatePort1TxQueueFrames[CAN_BUS_PORT1_TX_QUEUE_SIZE_MASK + 1] CAN_BUS_MEM_SECTION;
+static const CanBusSubscriptionT privatePort1Subscriptions[] = CAN_BUS_PORT1_SUBSCRIPTIONS;
+#endif
+
+#if CAN_BUS_PORT2_ENABLE == 1
+static CanBusFrameT privatePort2BulkFrames[CAN_BUS_PORT2_BULK_RING_SIZE_MASK + 1] CAN_BUS_MEM_SECTION;
+static CanBusFrameT privatePort2PriorityFrames[CAN_BUS_PORT2_PRIORITY_RING_SIZE_MASK + 1] CAN_BUS_MEM_SECTION;
+static CanBusFrameT privatePort2TxFrames[CAN_BUS_PORT2_TX_RING_SIZE_MASK + 1] CAN_BUS_MEM_SECTION;
+static CanBusFrameT privatePort2TxQueueFrames[CAN_BUS_PORT2_TX_QUEUE_SIZE_MASK + 1] CAN_BUS_MEM_SECTION;
+static const CanBusSubscriptionT privatePort2Subscriptions[] = CAN_BUS_PORT2_SUBSCRIPTIONS;
+#endif
+
+static const CanBusPortInitT privatePortInits[CAN_BUS_PORTS_COUNT] =
+{
+#if CAN_BUS_PORT1_ENABLE == 1
+	[CAN_BUS_PORT1] =
+	{
+		.Adapter =
+		{
+			.Handle = &CAN_BUS_PORT1_HANDLE,
+			.Irqs = { [CanBusFifoBulk] = CAN1_RX0_IRQn, [CanBusFifoPriority] = CAN1_RX1_IRQn },
+			.IrqPriorities = { [CanBusFifoBulk] = CAN_BUS_BULK_IRQ_PRIORITY, [CanBusFifoPriority] = CAN_BUS_PRIORITY_IRQ_PRIORITY },
+			.Frames = { [CanBusFifoBulk] = privatePort1BulkFrames, [CanBusFifoPriority] = privatePort1PriorityFrames },
+			.SizeMasks = { [CanBusFifoBulk] = CAN_BUS_PORT1_BULK_RING_SIZE_MASK, [CanBusFifoPriority] = CAN_BUS_PORT1_PRIORITY_RING_SIZE_MASK },
+			.TxFrames = privatePort1TxFrames,
+			.TxSizeMask = CAN_BUS_PORT1_TX_RING_SIZE_MASK,
+			.TxQueueFrames = privatePort1TxQueueFrames,
+			.TxQueueSizeMask = CAN_BUS_PORT1_TX_QUEUE_SIZE_MASK
+		},
+
+		.Subscriptions = privatePort1Subscriptions,
+		.SubscriptionsCount = sizeof(privatePort1Subscriptions) / sizeof(privatePort1Subscriptions[0]),
+		.IsSlave = CAN_BUS_PORT1_IS_SLAVE
+	},
+#endif
+
+#if CAN_BUS_PORT2_ENABLE == 1
+	[CAN_BUS_PORT2] =
+	{
+		.Adapter =
+		{
+			.Handle = &CAN_BUS_PORT2_HANDLE,
+			.Irqs = { [CanBusFifoBulk] = CAN2_RX0_IRQn, [CanBusFifoPriority] = CAN2_RX1_IRQn },
+			.IrqPriorities = { [CanBusFifoBulk] = CAN_BUS_BULK_IRQ_PRIORITY, [CanBusFifoPriority] = CAN_BUS_PRIORITY_IRQ_PRIORITY },
+			.Frames = { [CanBusFifoBulk] = privatePort2BulkFrames, [CanBusFifoPriority] = privatePort2PriorityFrames },
+			.SizeMasks = { [CanBusFifoBulk] = CAN_BUS_PORT2_BULK_RING_SIZE_MASK, [CanBusFifoPriority] = CAN_BUS_PORT2_PRIORITY_RING_SIZE_MASK },
+			.TxFrames = privatePort2TxFrames,
+			.TxSizeMask = CAN_BUS_PORT2_TX_RING_SIZE_MASK,
+			.TxQueueFrames = privatePort2TxQueueFrames,
+			.TxQueueSizeMask = CAN_BUS_PORT2_TX_QUEUE_SIZE_MASK
+		},
+
+		.Subscriptions = privatePort2Subscriptions,
+		.SubscriptionsCount = sizeof(privatePort2Subscriptions) / sizeof(privatePort2Subscriptions[0]),
+		.IsSlave = CAN_BUS_PORT2_IS_SLAVE
+	},
+#endif
+};
+
+static CanBusListenerT privateListeners[CAN_BUS_LISTENERS_COUNT];
+static uint8_t privateListenersCount;
+
+static CanBusSubscriptionT privateSubscriptions[CAN_BUS_PORTS_COUNT][CAN_BUS_SUBSCRIPTIONS_COUNT];
+static CanBusFilterSetT privateFilterSets[CAN_BUS_PORTS_COUNT];
+static CanBusFilterBlockT privateFilterBlocks[CAN_BUS_FILTER_BLOCKS_COUNT] CAN_BUS_MEM_SECTION;
+static CanBusFilterPlanT privateFilterPlan;
+static CanBusSoftwareFilterT privateSoftwareFilters[CAN_BUS_PORTS_COUNT];
+static volatile bool privateIsFiltersChanged;
+
+static CanBusTimeT privateTime;
+static CanBusJitterT privateJitter;
+
+CanBusAdapterT CanBusAdapters[CAN_BUS_PORTS_COUNT];
+//==============================================================================
+//functions:
+
+/**
+ * @brief RX0 and RX1 of the controller: the adapter when it took the receive over,
+ * the xCAN driver otherwise
+ */
+void CanBusComponentRxIRQ(uint8_t port, CanBusFifoT fifo, xCAN_Numbers can)
+{
+	if (CanBusAdapters[port].Handle)
+	{
+		CanBusAdapterRxIRQ(&CanBusAdapters[port], fifo);
+	}
+	else if (fifo == CanBusFifoBulk)
+	{
+		xCAN_RxIRQ_Handler(can);
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the sent mailboxes are stamped before the xCAN driver takes the interrupt,
+ * the queue of CanBusComponentTransmit takes the mailboxes it left empty
+ */
+void CanBusComponentTxIRQ(uint8_t port, xCAN_Numbers can)
+{
+	if (CanBusAdapters[port].Handle)
+	{
+		CanBusAdapterTxIRQ(&CanBusAdapters[port]);
+	}
+
+	xCAN_TxIRQ_Handler(can);
+
+	CanBusAdapterLoadMailboxes(&CanBusAdapters[port]);
+}
+//------------------------------------------------------------------------------
+/// @brief us of the system time base, the time of the frame stamps: for the events of other components
+uint64_t CanBusComponentGetTime()
+{
+	return CanBusTimeToMicroseconds(&privateTime, CanBusAdapterReadTime(&privateTime, CAN_BUS_TIME_TIMER.Instance));
+}
+//------------------------------------------------------------------------------
+/// @brief not for the interrupts, the listeners are added before the frames come
+xResult CanBusComponentAddListener(CanBusFrameListenerT listener, void* context)
+{
+	if (!listener || privateListenersCount >= CAN_BUS_LISTENERS_COUNT)
+	{
+		return xResultError;
+	}
+
+	privateListeners[privateListenersCount].Listener = listener;
+	privateListeners[privateListenersCount].Context = context;
+	privateListenersCount++;
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief queues the frame to the controller of the port beside the CAN-Ports driver,
+ * for the tasks: the sent frame comes back to the listeners with CAN_BUS_FRAME_TRANSMITTED
+ * @return xResultBusy - the queue is full
+ */
+xResult CanBusComponentTransmit(uint8_t port, const CanBusFrameT* frame)
+{
+	if (port >= CAN_BUS_PORTS_COUNT || !frame)
+	{
+		return xResultError;
+	}
+
+	return CanBusAdapterTransmit(&CanBusAdapters[port], frame);
+}
+//------------------------------------------------------------------------------
+static void privateUpdateInterval(CanBusIntervalT* interval, uint64_t time)
+{
+	if (interval->Last)
+	{
+		uint32_t value = (uint32_t)(time - interval->Last);
+
+		if (!interval->Sum || value < interval->Min)
+		{
+			interval->Min = value;
+		}
+
+		if (value > interval->Max)
+		{
+			interval->Max = value;
+		}
+
+		interval->Sum += value;
+	}
+
+	interval->Last = time;
+}
+//------------------------------------------------------------------------------
+static void privateMeasureJitter(uint8_t port, CanBusFrameT* frame)
+{
+	CanBusJitterT* jitter = &privateJitter;
+
+	if (!jitter->IsEnabled
+		|| port != jitter->Port
+		|| frame->Id != jitter->Id
+		|| (frame->Flags & CAN_BUS_FRAME_TRANSMITTED))
+	{
+		return;
+	}
+
+	if (jitter->Stamp.Last)
+	{
+		jitter->Count++;
+	}
+
+	privateUpdateInterval(&jitter->Stamp, frame->Timestamp);
+	privateUpdateInterval(&jitter->Task, CanBusComponentGetTime());
+}
+//------------------------------------------------------------------------------
+static void privateDispatch(uint8_t port, CanBusFrameT* frame)
+{
+	privateMeasureJitter(port, frame);
+
+	//the banks were widened to fit: the identifiers nobody subscribed to stop here
+	if (!privateFilterPlan.IsExact[port] && !(frame->Flags & CAN_BUS_FRAME_TRANSMITTED))
+	{
+		if (!CanBusFilterSetMatch(&privateFilterSets[port], frame))
+		{
+			privateSoftwareFilters[port].Dropped++;
+			return;
+		}
+
+		privateSoftwareFilters[port].Accepted++;
+	}
+
+	for (uint8_t i = 0; i < privateListenersCount; i++)
+	{
+		privateListeners[i].Listener(privateListeners[i].Context, port, frame);
+	}
+}
+//------------------------------------------------------------------------------
+/// @return frames left in the ring after count of them
+static uint16_t privateDrain(uint8_t port, CanBusRingT* ring, uint16_t count)
+{
+	CanBusFrameT* frame;
+
+	while (count && (frame = CanBusRingPeek(ring)))
+	{
+		privateDispatch(port, frame);
+		CanBusRingRelease(ring);
+		count--;
+	}
+
+	return CanBusRingGetCount(ring);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the priority rings and the sent frames are emptied first and again after each batch
+ * of the bulk frames: a long bulk burst does not hold an urgent frame for more than one batch
+ */
+static void privateReceive()
+{
+	bool isPending = true;
+
+	while (isPending)
+	{
+		isPending = false;
+
+		for (uint8_t port = 0; port < CAN_BUS_PORTS_COUNT; port++)
+		{
+			privateDrain(port, &CanBusAdapters[port].Rings[CanBusFifoPriority], UINT16_MAX);
+			privateDrain(port, &CanBusAdapters[port].TxRing, UINT16_MAX);
+		}
+
+		for (uint8_t port = 0; port < CAN_BUS_PORTS_COUNT; port++)
+		{
+			if (privateDrain(port, &CanBusAdapters[port].Rings[CanBusFifoBulk], CAN_BUS_BULK_BATCH))
+			{
+				isPending = true;
+			}
+		}
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the banks of both controllers from the subscriptions of the ports: the set of a port
+ * is its index, the banks of CAN1 come first
+ */
+static void privateApplyFilters()
+{
+	privateIsFiltersChanged = false;
+
+	CanBusFilterCompile(privateFilterSets,
+						CAN_BUS_PORTS_COUNT,
+						privateFilterBlocks,
+						CAN_BUS_FILTER_BLOCKS_COUNT,
+						&privateFilterPlan);
+
+	CanBusAdapterApplyFilters(&CAN_BUS_FILTER_MASTER_HANDLE,
+								privateFilterPlan.Banks,
+								privateFilterPlan.BanksCount,
+								privateFilterPlan.SlaveStartBank);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the identifiers first..last of the kind in flags go to the listeners of the port,
+ * CAN_BUS_SUBSCRIPTION_PRIORITY puts them into FIFO1. The banks are compiled again by the task.
+ */
+xResult CanBusComponentSubscribe(uint8_t port, uint32_t first, uint32_t last, uint8_t flags)
+{
+	if (port >= CAN_BUS_PORTS_COUNT || first > last)
+	{
+		return xResultError;
+	}
+
+	CanBusFilterSetT* set = &privateFilterSets[port];
+	xResult result = xResultError;
+
+	taskENTER_CRITICAL();
+
+	if (set->Count < CAN_BUS_SUBSCRIPTIONS_COUNT)
+	{
+		CanBusSubscriptionT* subscription = &privateSubscriptions[port][set->Count];
+
+		subscription->First = first;
+		subscription->Last = last;
+		subscription->Flags = flags;
+
+		set->Count++;
+		privateIsFiltersChanged = true;
+		result = xResultAccept;
+	}
+
+	taskEXIT_CRITICAL();
+
+	if (result == xResultAccept && taskHandle)
+	{
+		xTaskNotifyGive(taskHandle);
+	}
+
+	return result;
+}
+//------------------------------------------------------------------------------
+static void privateTask(void* arg)
+{
+	while (true)
+	{
+		RTOS_CanBusTaskStackWaterMark = uxTaskGetStackHighWaterMark(NULL);
+
+		//notified by the RX0, RX1 and TX interrupts of both controllers
+		ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CAN_BUS_TASK_PERIOD));
+
+		//the timer is read more often than it wraps without frames too
+		CanBusComponentGetTime();
+
+		if (privateIsFiltersChanged)
+		{
+			privateApplyFilters();
+		}
+
+		//the xCAN driver may take TMEIE away while the queue waits
+		for (uint8_t port = 0; port < CAN_BUS_PORTS_COUNT; port++)
+		{
+			CanBusAdapterLoadMailboxes(&CanBusAdapters[port]);
+		}
+
+		privateReceive();
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief "can-rx [-p port]": the frames, interrupts and losses of both FIFOs of the port,
+ * the statistic is cleared after the report
+ */
+static xResult privateRxCommand(xPortT* port, TerminalCommandArgumentsT* arguments)
+{
+	static const char* const names[CanBusFifosCount] = { "bulk", "priority" };
+
+	uint32_t number = TerminalCommandGetNumber(arguments, 'p', 1);
+	char line[224];
+
+	if (TerminalCommandCheckOptions(arguments, "p", NULL) != xResultAccept || !number || number > CAN_BUS_PORTS_COUNT)
+	{
+		return xResultError;
+	}
+
+	CanBusAdapterT* adapter = &CanBusAdapters[number - 1];
+
+	for (uint8_t fifo = 0; fifo < CanBusFifosCount; fifo++)
+	{
+		CanBusFifoStatisticT* statistic = &adapter->Statistic[fifo];
+		CanBusRingT* ring = &adapter->Rings[fifo];
+
+		snprintf(line, sizeof(line), "[can-rx] port %lu %s: frames %lu, irq %lu, fifo overruns %lu, ring overflows %lu, fifo peak %u, ring peak %u/%u\r",
+					number,
+					names[fifo],
+					statistic->Frames,
+					statistic->Irqs,
+					statistic->FifoOverruns,
+					statistic->RingOverflows,
+					statistic->FifoPeak,
+					ring->Peak,
+					ring->SizeMask);
+
+		memset(statistic, 0, sizeof(CanBusFifoStatisticT));
+		ring->Peak = 0;
+
+		xPortStartTransmission(port);
+		xPortTransmitString(port, line);
+		xPortEndTransmission(port);
+	}
+
+	CanBusTxStatisticT* statistic = &adapter->TxStatistic;
+	CanBusTimeSyncT* sync = &adapter->Sync;
+
+	snprintf(line, sizeof(line), "[can-rx] port %lu tx: frames %lu, irq %lu, ring overflows %lu, ring peak %u/%u, queued %lu, queue overflows %lu, queue peak %u/%u, ttcm %s, %lu ticks per bit, steps %lu, relocks %lu\r",
+				number,
+				statistic->Frames,
+				statistic->Irqs,
+				statistic->RingOverflows,
+				adapter->TxRing.Peak,
+				adapter->TxRing.SizeMask,
+				statistic->Queued,
+				statistic->QueueOverflows,
+				adapter->TxQueue.Peak,
+				adapter->TxQueue.SizeMask,
+				sync->TicksPerBit ? "on" : "off",
+				sync->TicksPerBit,
+				sync->Steps,
+				sync->Relocks);
+
+	memset(statistic, 0, sizeof(CanBusTxStatisticT));
+	adapter->TxRing.Peak = 0;
+	adapter->TxQueue.Peak = 0;
+
+	xPortStartTransmission(port);
+	xPortTransmitString(port, line);
+	xPortEndTransmission(port);
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static uint32_t privateGetPeakToPeak(CanBusIntervalT* interval)
+{
+	return interval->Max - interval->Min;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief "can-jitter [-p port -i id]": with the options the intervals of the identifier (hex)
+ * are measured from here, without them the intervals so far are reported. The stamps of the
+ * frames and the time the task took them are compared: their peak-to-peak is the jitter.
+ */
+static xResult privateJitterCommand(xPortT* port, TerminalCommandArgumentsT* arguments)
+{
+	CanBusJitterT* jitter = &privateJitter;
+	char line[200];
+
+	if (TerminalCommandCheckOptions(arguments, "pi", NULL) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	char* number = TerminalCommandGetOption(arguments, 'p');
+	char* id = TerminalCommandGetOption(arguments, 'i');
+
+	if (number || id)
+	{
+		uint32_t value = number ? strtoul(number, NULL, 10) : 0;
+
+		if (!id || !value || value > CAN_BUS_PORTS_COUNT)
+		{
+			return xResultError;
+		}
+
+		jitter->IsEnabled = false;
+
+		memset(jitter, 0, sizeof(CanBusJitterT));
+
+		jitter->Port = value - 1;
+		jitter->Id = strtoul(id, NULL, 16);
+		jitter->IsEnabled = true;
+	}
+
+	if (!jitter->IsEnabled || !jitter->Count)
+	{
+		snprintf(line, sizeof(line), "[can-jitter] %s\r", jitter->IsEnabled ? "no intervals yet" : "off");
+	}
+	else
+	{
+		snprintf(line, sizeof(line), "[can-jitter] port %u id 0x%lx: %lu intervals, stamp min %lu max %lu avg %lu p-p %lu us, task min %lu max %lu avg %lu p-p %lu us\r",
+					jitter->Port + 1,
+					jitter->Id,
+					jitter->Count,
+					jitter->Stamp.Min,
+					jitter->Stamp.Max,
+					(uint32_t)(jitter->Stamp.Sum / jitter->Count),
+					privateGetPeakToPeak(&jitter->Stamp),
+					jitter->Task.Min,
+					jitter->Task.Max,
+					(uint32_t)(jitter->Task.Sum / jitter->Count),
+					privateGetPeakToPeak(&jitter->Task));
+	}
+
+	xPortStartTransmission(port);
+	xPortTransmitString(port, line);
+	xPortEndTransmission(port);
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief "can-filters": the banks of each port, the blocks joined to fit them, the share of
+ * the accepted identifiers nobody subscribed to and the frames the software filter dropped
+ */
+static xResult privateFiltersCommand(xPortT* port, TerminalCommandArgumentsT* arguments)
+{
+	CanBusFilterPlanT* plan = &privateFilterPlan;
+	char line[160];
+
+	if (arguments->Count)
+	{
+		return xResultError;
+	}
+
+	snprintf(line, sizeof(line), "[can-filters] banks %u/%u, CAN2SB %u, merges %u\r",
+				plan->BanksCount,
+				CAN_BUS_FILTER_BANKS_COUNT,
+				plan->SlaveStartBank,
+				plan->Merges);
+
+	xPortStartTransmission(port);
+	xPortTransmitString(port, line);
+	xPortEndTransmission(port);
+
+	for (uint8_t number = 0; number < CAN_BUS_PORTS_COUNT; number++)
+	{
+		CanBusSoftwareFilterT* filter = &privateSoftwareFilters[number];
+		uint64_t wanted = plan->Wanted[number];
+		uint64_t covered = plan->Covered[number];
+
+		//per mille of the accepted identifiers, the overlapped subscriptions count once per range
+		uint32_t unwanted = covered > wanted ? (uint32_t)((covered - wanted) * 1000 / covered) : 0;
+
+		snprintf(line, sizeof(line), "[can-filters] port %u: banks %u, %s, unwanted %lu.%lu%%, accepted %lu, dropped %lu\r",
+					number + 1,
+					plan->SetBanks[number],
+					plan->IsExact[number] ? "exact" : "software filter",
+					unwanted / 10,
+					unwanted % 10,
+					filter->Accepted,
+					filter->Dropped);
+
+		memset(filter, 0, sizeof(CanBusSoftwareFilterT));
+
+		xPortStartTransmission(port);
+		xPortTransmitString(port, line);
+		xPortEndTransmission(port);
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static const TerminalCommandT privateCommands[] =
+{
+	{
+		.Name = "can-rx",
+		.Usage = "[-p port]",
+		.Handler = privateRxCommand
+	},
+	{
+		.Name = "can-filters",
+		.Usage = "",
+		.Handler = privateFiltersCommand
+	},
+	{
+		.Name = "can-jitter",
+		.Usage = "[-p port -i id]",
+		.Handler = privateJitterCommand
+	}
+};
+//==============================================================================
+//initialization:
+
+xResult CanBusComponentInit(void* parent)
+{
+	TerminalCommandsAdd(privateCommands, sizeof(privateCommands) / sizeof(privateCommands[0]));
+
+	//the time base of the stamps: the timer runs from here, the task reads it too
+	HAL_TIM_Base_Start(&CAN_BUS_TIME_TIMER);
+
+	CanBusTimeInit(&privateTime,
+					CAN_BUS_TIME_TIMER_FREQUENCY,
+					CAN_BUS_TIME_TIMER.Instance->CNT,
+					(uint64_t)xSystemGetTime() * 1000);
+
+	//the task is the consumer of the rings: created before the interrupts
+	taskHandle = xTaskCreateStatic(privateTask, // Function that implements the task.
+									"can bus task", // Text name for the task.
+									CAN_BUS_TASK_STACK_SIZE, // Number of indexes in the xStack array.
+									NULL, // Parameter passed into the task.
+									osPriorityAboveNormal, // Priority at which the task is created.
+									taskStack, // Array to use as the task's stack.
+									&taskBuffer);
+
+	for (uint8_t port = 0; port < CAN_BUS_PORTS_COUNT; port++)
+	{
+		const CanBusPortInitT* init = &privatePortInits[port];
+
+		memcpy(privateSubscriptions[port], init->Subscriptions, sizeof(CanBusSubscriptionT) * init->SubscriptionsCount);
+
+		privateFilterSets[port].Subscriptions = privateSubscriptions[port];
+		privateFilterSets[port].Count = init->SubscriptionsCount;
+		privateFilterSets[port].IsSlave = init->IsSlave;
+	}
+
+	privateApplyFilters();
+
+	for (uint8_t port = 0; port < CAN_BUS_PORTS_COUNT; port++)
+	{
+		CanBusAdapterInitT init = privatePortInits[port].Adapter;
+
+		init.Time = &privateTime;
+		init.Timer = CAN_BUS_TIME_TIMER.Instance;
+
+		CanBusAdapterInit(&CanBusAdapters[port], &init);
+		CanBusAdapterSetRxTask(&CanBusAdapters[port], taskHandle);
+	}
+
+	return xResultAccept;
+}
+//==============================================================================
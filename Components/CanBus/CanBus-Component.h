@@ -0,0 +1,53 @@
+//==============================================================================
+//header:
+
+#ifndef _CAN_BUS_COMPONENT_H_
+#define _CAN_BUS_COMPONENT_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "CanBus-ComponentConfig.h"
+#include "Adapters/STM32F4xx/CanBus-Adapter.h"
+#include "Abstractions/xPort/xPort.h"
+#include "Peripherals/CAN/xCAN.h"
+//==============================================================================
+//types:
+
+/**
+ * @brief called by the task of the component, the frame is valid for the call only:
+ * the received frames and the sent ones with CAN_BUS_FRAME_TRANSMITTED, both stamped
+ */
+typedef void (*CanBusFrameListenerT)(void* context, uint8_t port, CanBusFrameT* frame);
+//==============================================================================
+//functions:
+
+xResult CanBusComponentInit(void* parent);
+
+void CanBusComponentRxIRQ(uint8_t port, CanBusFifoT fifo, xCAN_Numbers can);
+void CanBusComponentTxIRQ(uint8_t port, xCAN_Numbers can);
+
+uint64_t CanBusComponentGetTime();
+
+xResult CanBusComponentAddListener(CanBusFrameListenerT listener, void* context);
+xResult CanBusComponentSubscribe(uint8_t port, uint32_t first, uint32_t last, uint8_t flags);
+
+xResult CanBusComponentTransmit(uint8_t port, const CanBusFrameT* frame);
+//==============================================================================
+//override:
+
+#define CanBusComponentHandler()
+#define CanBusComponentTimeSynchronization()
+//==============================================================================
+//export:
+
+extern CanBusAdapterT CanBusAdapters[CAN_BUS_PORTS_COUNT];
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_CAN_BUS_COMPONENT_H_
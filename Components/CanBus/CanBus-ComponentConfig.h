@@ -0,0 +1,97 @@
+//==============================================================================
+//header:
+
+#ifndef _CAN_BUS_COMPONENT_CONFIG_H_
+#define _CAN_BUS_COMPONENT_CONFIG_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+#include "main.h"
+//==============================================================================
+//defines:
+
+#define CAN_BUS_COMPONENT_MAIN_TASK_STACK_SECTION __attribute__((section("._user_heap_stack")))
+#define CAN_BUS_MEM_SECTION __attribute__((section("._user_heap_stack")))
+
+#define CAN_BUS_TASK_STACK_SIZE 0x200 //the listeners of the frames run in the task
+#define CAN_BUS_TASK_PERIOD 100 //ms without a receive event
+#define CAN_BUS_LISTENERS_COUNT 4
+
+#define CAN_BUS_BULK_IRQ_PRIORITY 6 //RX0, not above configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY (5)
+#define CAN_BUS_PRIORITY_IRQ_PRIORITY 5 //RX1 preempts RX0
+#define CAN_BUS_BULK_BATCH 8 //bulk frames of a port between two looks at the priority rings
+
+#define CAN_BUS_FILTER_MASTER_HANDLE hcan1 //the filters of both controllers are in CAN1
+#define CAN_BUS_SUBSCRIPTIONS_COUNT 32 //per port, the defaults included
+#define CAN_BUS_FILTER_BLOCKS_COUNT 256 //work memory of the filter compiler
+
+#define CAN_BUS_TIME_TIMER htim5 //32-bit, free-running: the time base of the stamps
+#define CAN_BUS_TIME_TIMER_FREQUENCY (HAL_RCC_GetPCLK1Freq() * 2) //the APB1 timers run at twice PCLK1 with its prescaler above 1
+//------------------------------------------------------------------------------
+
+#define CAN_BUS_PORT1_ENABLE 1
+#define CAN_BUS_PORT2_ENABLE 1
+
+enum
+{
+#if CAN_BUS_PORT1_ENABLE == 1
+	CAN_BUS_PORT1,
+#endif
+
+#if CAN_BUS_PORT2_ENABLE == 1
+	CAN_BUS_PORT2,
+#endif
+
+	CAN_BUS_PORTS_COUNT
+};
+//------------------------------------------------------------------------------
+extern CAN_HandleTypeDef hcan1;
+extern CAN_HandleTypeDef hcan2;
+extern TIM_HandleTypeDef htim5;
+
+#if CAN_BUS_PORT1_ENABLE == 1
+#define CAN_BUS_PORT1_HANDLE hcan1
+#define CAN_BUS_PORT1_IS_SLAVE false
+
+#define CAN_BUS_PORT1_BULK_RING_SIZE_MASK 0x7f
+#define CAN_BUS_PORT1_PRIORITY_RING_SIZE_MASK 0x1f
+#define CAN_BUS_PORT1_TX_RING_SIZE_MASK 0x1f //the sent frames, three mailboxes per interrupt
+#define CAN_BUS_PORT1_TX_QUEUE_SIZE_MASK 0x7f //the frames to send of CanBusComponentTransmit
+
+//standard 0x000..0x07f: they win the arbitration, they are the urgent ones of the bus,
+//the rest of the bus is taken too until the consumers narrow the defaults
+#define CAN_BUS_PORT1_SUBSCRIPTIONS \
+{ \
+	{ .First = 0x000, .Last = 0x07f, .Flags = CAN_BUS_SUBSCRIPTION_PRIORITY }, \
+	{ .First = 0x080, .Last = 0x7ff }, \
+	{ .First = 0x00000000, .Last = 0x1fffffff, .Flags = CAN_BUS_FRAME_EXTENDED } \
+}
+#endif
+
+#if CAN_BUS_PORT2_ENABLE == 1
+#define CAN_BUS_PORT2_HANDLE hcan2
+#define CAN_BUS_PORT2_IS_SLAVE true
+
+#define CAN_BUS_PORT2_BULK_RING_SIZE_MASK 0x7f
+#define CAN_BUS_PORT2_PRIORITY_RING_SIZE_MASK 0x1f
+#define CAN_BUS_PORT2_TX_RING_SIZE_MASK 0x1f //the sent frames, three mailboxes per interrupt
+#define CAN_BUS_PORT2_TX_QUEUE_SIZE_MASK 0x7f //the frames to send of CanBusComponentTransmit
+
+#define CAN_BUS_PORT2_SUBSCRIPTIONS \
+{ \
+	{ .First = 0x000, .Last = 0x07f, .Flags = CAN_BUS_SUBSCRIPTION_PRIORITY }, \
+	{ .First = 0x080, .Last = 0x7ff }, \
+	{ .First = 0x00000000, .Last = 0x1fffffff, .Flags = CAN_BUS_FRAME_EXTENDED } \
+}
+#endif
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_CAN_BUS_COMPONENT_CONFIG_H_
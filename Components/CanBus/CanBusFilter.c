@@ -0,0 +1,641 @@
+//==============================================================================
+//includes:
+
+#include <string.h>
+#include "CanBusFilter.h"
+//==============================================================================
+//defines:
+
+#define CAN_BUS_FILTER_STANDARD_BITS 11
+#define CAN_BUS_FILTER_EXTENDED_BITS 29
+
+#define CAN_BUS_FILTER_KIND (CAN_BUS_FRAME_EXTENDED | CAN_BUS_SUBSCRIPTION_PRIORITY)
+//==============================================================================
+//functions:
+
+static inline uint8_t privateGetWidth(uint8_t flags)
+{
+	return flags & CAN_BUS_FRAME_EXTENDED ? CAN_BUS_FILTER_EXTENDED_BITS : CAN_BUS_FILTER_STANDARD_BITS;
+}
+//------------------------------------------------------------------------------
+static inline uint32_t privateGetWidthMask(uint8_t flags)
+{
+	return (1UL << privateGetWidth(flags)) - 1;
+}
+//------------------------------------------------------------------------------
+/// @brief identifiers accepted by the block
+static inline uint64_t privateGetCoverage(const CanBusFilterT* filter)
+{
+	uint32_t mask = filter->Mask & privateGetWidthMask(filter->Flags);
+
+	return 1ULL << (privateGetWidth(filter->Flags) - __builtin_popcount(mask));
+}
+//------------------------------------------------------------------------------
+static inline bool privateIsSingle(const CanBusFilterT* filter)
+{
+	uint32_t widthMask = privateGetWidthMask(filter->Flags);
+
+	return (filter->Mask & widthMask) == widthMask;
+}
+//------------------------------------------------------------------------------
+/// @brief the order of the groups in the banks of a set: the priority ones first, in the lower banks
+static inline uint8_t privateGetOrder(const CanBusFilterBlockT* block)
+{
+	uint8_t order = block->Filter.Flags & CAN_BUS_SUBSCRIPTION_PRIORITY ? 0 : 2;
+
+	return order + (block->Filter.Flags & CAN_BUS_FRAME_EXTENDED ? 1 : 0);
+}
+//------------------------------------------------------------------------------
+static inline bool privateIsSameGroup(const CanBusFilterBlockT* first, const CanBusFilterBlockT* second)
+{
+	return first->Set == second->Set
+			&& ((first->Filter.Flags ^ second->Filter.Flags) & CAN_BUS_FILTER_KIND) == 0;
+}
+//------------------------------------------------------------------------------
+static uint32_t privateEncode(uint32_t id, uint8_t flags)
+{
+	if (flags & CAN_BUS_FRAME_EXTENDED)
+	{
+		return (id << CAN_BUS_FILTER_EXID_POSITION) | CAN_BUS_FILTER_IDE;
+	}
+
+	return id << CAN_BUS_FILTER_STID_POSITION;
+}
+//------------------------------------------------------------------------------
+static uint32_t privateEncode16(uint32_t id, uint8_t flags)
+{
+	if (flags & CAN_BUS_FRAME_EXTENDED)
+	{
+		return ((id >> 18) << CAN_BUS_FILTER16_STID_POSITION) | CAN_BUS_FILTER16_IDE | ((id >> 15) & 0x07);
+	}
+
+	return id << CAN_BUS_FILTER16_STID_POSITION;
+}
+//------------------------------------------------------------------------------
+/// @brief the identifier of the frame as the controller compares it: RTR and IDE included
+uint32_t CanBusFilterGetRegister(const CanBusFrameT* frame)
+{
+	uint32_t value = privateEncode(frame->Id, frame->Flags);
+
+	return frame->Flags & CAN_BUS_FRAME_REMOTE ? value | CAN_BUS_FILTER_RTR : value;
+}
+//------------------------------------------------------------------------------
+/// @brief one 32-bit mask bank, IDE is always compared, RTR is not
+void CanBusFilterEncodeMask32(const CanBusFilterT* filter, uint8_t number, uint8_t fifo, CanBusFilterBankT* bank)
+{
+	bank->Number = number;
+	bank->Fifo = fifo;
+	bank->IsList = false;
+	bank->Is32Bit = true;
+
+	bank->Registers[0] = privateEncode(filter->Id, filter->Flags);
+	bank->Registers[1] = privateEncode(filter->Mask, filter->Flags) | CAN_BUS_FILTER_IDE;
+}
+//------------------------------------------------------------------------------
+/// @brief the acceptance of the controller, for the checks of the configuration off the target
+bool CanBusFilterBankMatch(const CanBusFilterBankT* bank, const CanBusFrameT* frame)
+{
+	if (bank->Is32Bit)
+	{
+		uint32_t value = CanBusFilterGetRegister(frame);
+
+		if (bank->IsList)
+		{
+			return value == bank->Registers[0] || value == bank->Registers[1];
+		}
+
+		return ((value ^ bank->Registers[0]) & bank->Registers[1]) == 0;
+	}
+
+	uint16_t value = privateEncode16(frame->Id, frame->Flags);
+	uint16_t halves[4] =
+	{
+		bank->Registers[0], bank->Registers[0] >> 16,
+		bank->Registers[1], bank->Registers[1] >> 16
+	};
+
+	if (frame->Flags & CAN_BUS_FRAME_REMOTE)
+	{
+		value |= CAN_BUS_FILTER16_RTR;
+	}
+
+	if (bank->IsList)
+	{
+		return value == halves[0] || value == halves[1] || value == halves[2] || value == halves[3];
+	}
+
+	return ((value ^ halves[0]) & halves[1]) == 0 || ((value ^ halves[2]) & halves[3]) == 0;
+}
+//------------------------------------------------------------------------------
+/// @brief the software filter of a set the banks accept more than
+bool CanBusFilterSetMatch(const CanBusFilterSetT* set, const CanBusFrameT* frame)
+{
+	for (uint16_t i = 0; i < set->Count; i++)
+	{
+		const CanBusSubscriptionT* subscription = &set->Subscriptions[i];
+
+		if (((subscription->Flags ^ frame->Flags) & CAN_BUS_FRAME_EXTENDED) == 0
+			&& frame->Id >= subscription->First
+			&& frame->Id <= subscription->Last)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the range as aligned blocks of a power of two identifiers, at most two per bit of the width
+ * @param blocks 0 - the blocks are only counted
+ * @return the blocks of the range
+ */
+static uint16_t privateSplit(const CanBusSubscriptionT* subscription, uint8_t set, CanBusFilterBlockT* blocks)
+{
+	uint8_t flags = subscription->Flags & CAN_BUS_FILTER_KIND;
+	uint32_t widthMask = privateGetWidthMask(flags);
+	uint32_t first = subscription->First;
+	uint32_t last = subscription->Last > widthMask ? widthMask : subscription->Last;
+	uint16_t count = 0;
+
+	while (first <= last)
+	{
+		//the largest block aligned at first that does not pass last
+		uint32_t size = first ? first & -first : widthMask + 1;
+
+		while (first + size - 1 > last)
+		{
+			size >>= 1;
+		}
+
+		if (blocks)
+		{
+			blocks[count].Filter.Id = first;
+			blocks[count].Filter.Mask = widthMask & ~(size - 1);
+			blocks[count].Filter.Flags = flags;
+			blocks[count].Set = set;
+		}
+
+		count++;
+		first += size;
+	}
+
+	return count;
+}
+//------------------------------------------------------------------------------
+/// @brief a block inside another one of its group is not needed
+static uint16_t privateRemoveContained(CanBusFilterBlockT* blocks, uint16_t count)
+{
+	for (uint16_t i = 0; i < count; i++)
+	{
+		for (uint16_t j = 0; j < count; j++)
+		{
+			CanBusFilterT* inner = &blocks[i].Filter;
+			CanBusFilterT* outer = &blocks[j].Filter;
+
+			if (i != j
+				&& privateIsSameGroup(&blocks[i], &blocks[j])
+				&& (outer->Mask & ~inner->Mask) == 0
+				&& ((inner->Id ^ outer->Id) & outer->Mask) == 0)
+			{
+				blocks[i--] = blocks[--count];
+				break;
+			}
+		}
+	}
+
+	return count;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief banks of one group: a standard 16-bit list bank takes four identifiers, a mask bank two
+ * blocks, the identifiers left from the lists share the mask banks. An extended list bank takes
+ * two identifiers, a mask bank one block.
+ * @param lists the list banks of the smallest count
+ */
+static uint16_t privateGetGroupBanks(uint16_t singles, uint16_t masks, bool isExtended, uint16_t* lists)
+{
+	if (isExtended)
+	{
+		*lists = (singles + 1) / 2;
+
+		return *lists + masks;
+	}
+
+	uint16_t best = UINT16_MAX;
+
+	for (uint16_t count = 0; count <= (singles + 3) / 4; count++)
+	{
+		uint16_t rest = singles > count * 4 ? singles - count * 4 : 0;
+		uint16_t banks = count + (rest + masks + 1) / 2;
+
+		if (banks < best)
+		{
+			best = banks;
+			*lists = count;
+		}
+	}
+
+	return best;
+}
+//------------------------------------------------------------------------------
+static uint16_t privateGetSetBanks(const CanBusFilterBlockT* blocks, uint16_t count, uint8_t set)
+{
+	uint16_t singles[4] = { 0 };
+	uint16_t masks[4] = { 0 };
+	uint16_t banks = 0;
+	uint16_t lists;
+
+	for (uint16_t i = 0; i < count; i++)
+	{
+		if (blocks[i].Set == set)
+		{
+			uint8_t order = privateGetOrder(&blocks[i]);
+
+			if (privateIsSingle(&blocks[i].Filter))
+			{
+				singles[order]++;
+			}
+			else
+			{
+				masks[order]++;
+			}
+		}
+	}
+
+	for (uint8_t order = 0; order < 4; order++)
+	{
+		banks += privateGetGroupBanks(singles[order], masks[order], order & 1, &lists);
+	}
+
+	return banks;
+}
+//------------------------------------------------------------------------------
+static uint16_t privateGetBanks(const CanBusFilterBlockT* blocks, uint16_t count, uint8_t setsCount)
+{
+	uint16_t banks = 0;
+
+	for (uint8_t set = 0; set < setsCount; set++)
+	{
+		banks += privateGetSetBanks(blocks, count, set);
+	}
+
+	return banks;
+}
+//------------------------------------------------------------------------------
+/// @brief the share of a bank the block takes, in eighths: a standard identifier is a quarter of a list bank
+static inline uint8_t privateGetSlots(const CanBusFilterT* filter)
+{
+	uint8_t slots = privateIsSingle(filter) ? 2 : 4;
+
+	return filter->Flags & CAN_BUS_FRAME_EXTENDED ? slots * 2 : slots;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief joins the two blocks of a group whose common block adds the fewest identifiers nobody
+ * subscribed to per share of a bank it frees. The identifiers are counted as the share of the space
+ * of their kind: an extended block of 256 costs as little as it takes of the uniform traffic.
+ * Two identifiers that become a mask free nothing, they are joined when nothing else is left.
+ * @return blocks after the merge
+ */
+static uint16_t privateMergeCheapest(CanBusFilterBlockT* blocks, uint16_t count, CanBusFilterPlanT* plan)
+{
+	uint64_t bestAdded = 0;
+	uint8_t bestFreed = 1;
+	uint16_t bestFirst = 0;
+	uint16_t bestSecond = 0;
+	uint32_t bestMask = 0;
+	bool isFound = false;
+
+	for (uint16_t i = 0; i < count; i++)
+	{
+		for (uint16_t j = i + 1; j < count; j++)
+		{
+			if (!privateIsSameGroup(&blocks[i], &blocks[j]))
+			{
+				continue;
+			}
+
+			CanBusFilterT* first = &blocks[i].Filter;
+			CanBusFilterT* second = &blocks[j].Filter;
+			CanBusFilterT merged = { .Mask = first->Mask & second->Mask & ~(first->Id ^ second->Id), .Flags = first->Flags };
+
+			//disjoint aligned blocks: the common one holds both, the standard space is scaled to the extended one
+			uint64_t added = privateGetCoverage(&merged) - privateGetCoverage(first) - privateGetCoverage(second);
+			int8_t freed = privateGetSlots(first) + privateGetSlots(second) - privateGetSlots(&merged);
+
+			added <<= CAN_BUS_FILTER_EXTENDED_BITS - privateGetWidth(first->Flags);
+
+			//a merge that frees nothing counts as an eighth: added / freed < bestAdded / bestFreed
+			if (freed < 1)
+			{
+				freed = 1;
+			}
+
+			if (!isFound || added * bestFreed < bestAdded * freed)
+			{
+				isFound = true;
+				bestAdded = added;
+				bestFreed = freed;
+				bestFirst = i;
+				bestSecond = j;
+				bestMask = merged.Mask;
+			}
+		}
+	}
+
+	if (!isFound)
+	{
+		return count;
+	}
+
+	blocks[bestFirst].Filter.Mask = bestMask;
+	blocks[bestFirst].Filter.Id &= bestMask;
+	blocks[bestSecond] = blocks[--count];
+
+	//two neighbours that make one aligned block add nothing: the set stays exact
+	if (bestAdded)
+	{
+		plan->IsExact[blocks[bestFirst].Set] = false;
+	}
+
+	plan->Merges++;
+
+	//the common block may hold others of its group
+	CanBusFilterBlockT* merged = &blocks[bestFirst];
+
+	for (uint16_t i = 0; i < count; i++)
+	{
+		if (&blocks[i] != merged
+			&& privateIsSameGroup(&blocks[i], merged)
+			&& (merged->Filter.Mask & ~blocks[i].Filter.Mask) == 0
+			&& ((blocks[i].Filter.Id ^ merged->Filter.Id) & merged->Filter.Mask) == 0)
+		{
+			count--;
+
+			//the last block takes the place, the merged one too
+			if (merged == &blocks[count])
+			{
+				merged = &blocks[i];
+			}
+
+			blocks[i--] = blocks[count];
+		}
+	}
+
+	return count;
+}
+//------------------------------------------------------------------------------
+/// @brief by set, group, the identifiers before the masks: each group is one run
+static inline uint16_t privateGetSortKey(const CanBusFilterBlockT* block)
+{
+	return (block->Set << 3) | (privateGetOrder(block) << 1) | (privateIsSingle(&block->Filter) ? 0 : 1);
+}
+//------------------------------------------------------------------------------
+static void privateSort(CanBusFilterBlockT* blocks, uint16_t count)
+{
+	for (uint16_t i = 1; i < count; i++)
+	{
+		CanBusFilterBlockT block = blocks[i];
+		uint16_t key = privateGetSortKey(&block);
+		uint16_t j = i;
+
+		while (j && privateGetSortKey(&blocks[j - 1]) > key)
+		{
+			blocks[j] = blocks[j - 1];
+			j--;
+		}
+
+		blocks[j] = block;
+	}
+}
+//------------------------------------------------------------------------------
+static CanBusFilterBankT* privateAddBank(CanBusFilterPlanT* plan, uint8_t fifo, bool isList, bool is32Bit)
+{
+	CanBusFilterBankT* bank = &plan->Banks[plan->BanksCount];
+
+	bank->Number = plan->BanksCount++;
+	bank->Fifo = fifo;
+	bank->IsList = isList;
+	bank->Is32Bit = is32Bit;
+
+	return bank;
+}
+//------------------------------------------------------------------------------
+/// @brief the banks of one group: singles[0..singlesCount) and the masks after them
+static void privateEmitGroup(const CanBusFilterBlockT* singles, uint16_t singlesCount, uint16_t masksCount, CanBusFilterPlanT* plan)
+{
+	const CanBusFilterBlockT* masks = singles + singlesCount;
+	const CanBusFilterBlockT* first = singlesCount ? singles : masks;
+	bool isExtended = first->Filter.Flags & CAN_BUS_FRAME_EXTENDED;
+	uint8_t fifo = first->Filter.Flags & CAN_BUS_SUBSCRIPTION_PRIORITY ? 1 : 0;
+	uint16_t lists = 0;
+
+	privateGetGroupBanks(singlesCount, masksCount, isExtended, &lists);
+
+	if (isExtended)
+	{
+		//the last list bank repeats its identifier when the count is odd
+		for (uint16_t i = 0; i < singlesCount; i += 2)
+		{
+			CanBusFilterBankT* bank = privateAddBank(plan, fifo, true, true);
+			uint16_t next = i + 1 < singlesCount ? i + 1 : i;
+
+			bank->Registers[0] = privateEncode(singles[i].Filter.Id, singles[i].Filter.Flags);
+			bank->Registers[1] = privateEncode(singles[next].Filter.Id, singles[next].Filter.Flags);
+		}
+
+		for (uint16_t i = 0; i < masksCount; i++)
+		{
+			CanBusFilterEncodeMask32(&masks[i].Filter, plan->BanksCount, fifo, &plan->Banks[plan->BanksCount]);
+			plan->BanksCount++;
+		}
+
+		return;
+	}
+
+	uint16_t used = 0;
+
+	for (uint16_t i = 0; i < lists; i++)
+	{
+		CanBusFilterBankT* bank = privateAddBank(plan, fifo, true, false);
+		uint16_t values[4];
+
+		for (uint8_t slot = 0; slot < 4; slot++)
+		{
+			uint16_t index = used < singlesCount ? used++ : singlesCount - 1;
+
+			values[slot] = privateEncode16(singles[index].Filter.Id, singles[index].Filter.Flags);
+		}
+
+		bank->Registers[0] = values[0] | ((uint32_t)values[1] << 16);
+		bank->Registers[1] = values[2] | ((uint32_t)values[3] << 16);
+	}
+
+	//the identifiers left and the masks, two per bank: an identifier is a mask of all bits
+	const CanBusFilterBlockT* rest = singles + used;
+	uint16_t restCount = singlesCount - used + masksCount;
+
+	for (uint16_t i = 0; i < restCount; i += 2)
+	{
+		CanBusFilterBankT* bank = privateAddBank(plan, fifo, false, false);
+		uint16_t next = i + 1 < restCount ? i + 1 : i;
+		const CanBusFilterT* pair[2] = { &rest[i].Filter, &rest[next].Filter };
+
+		for (uint8_t slot = 0; slot < 2; slot++)
+		{
+			uint16_t id = privateEncode16(pair[slot]->Id, pair[slot]->Flags);
+			uint16_t mask = privateEncode16(pair[slot]->Mask, pair[slot]->Flags) | CAN_BUS_FILTER16_IDE;
+
+			bank->Registers[slot] = id | ((uint32_t)mask << 16);
+		}
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief the banks of a set in the order of its groups
+static void privateEmitSet(const CanBusFilterBlockT* blocks, uint16_t count, uint8_t set, CanBusFilterPlanT* plan)
+{
+	uint8_t start = plan->BanksCount;
+	uint16_t i = 0;
+
+	while (i < count)
+	{
+		if (blocks[i].Set != set)
+		{
+			i++;
+			continue;
+		}
+
+		uint16_t singles = 0;
+		uint16_t masks = 0;
+		uint16_t j = i;
+
+		while (j < count && privateIsSameGroup(&blocks[i], &blocks[j]))
+		{
+			privateIsSingle(&blocks[j].Filter) ? singles++ : masks++;
+			j++;
+		}
+
+		privateEmitGroup(&blocks[i], singles, masks, plan);
+
+		i = j;
+	}
+
+	plan->SetBanks[set] = plan->BanksCount - start;
+}
+//------------------------------------------------------------------------------
+/// @brief one accept-all bank per set, everything goes to the software filter
+static void privateAcceptAll(const CanBusFilterSetT* sets, uint8_t setsCount, CanBusFilterPlanT* plan)
+{
+	plan->BanksCount = 0;
+
+	for (uint8_t pass = 0; pass < 2; pass++)
+	{
+		if (pass)
+		{
+			plan->SlaveStartBank = plan->BanksCount;
+		}
+
+		for (uint8_t set = 0; set < setsCount; set++)
+		{
+			if (sets[set].IsSlave == pass)
+			{
+				CanBusFilterBankT* bank = privateAddBank(plan, 0, false, true);
+
+				bank->Registers[0] = 0;
+				bank->Registers[1] = 0;
+
+				plan->SetBanks[set] = 1;
+				plan->IsExact[set] = false;
+				plan->Covered[set] = (1ULL << CAN_BUS_FILTER_STANDARD_BITS) + (1ULL << CAN_BUS_FILTER_EXTENDED_BITS);
+			}
+		}
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the banks of both controllers for their subscriptions:
+ * - each range is split into aligned blocks, the blocks inside other ones are dropped;
+ * - while the banks do not fit, the two blocks of a group with the cheapest common block are joined;
+ * - the single identifiers go to list banks, the blocks to mask banks, 16-bit for the standard ones;
+ * - CAN2SB is put after the banks of CAN1.
+ * A set with joined blocks is not exact: its frames are checked by CanBusFilterSetMatch.
+ * Without room for the blocks each set gets an accept-all bank and the software filter.
+ * @param blocks the work memory of the compiler
+ */
+xResult CanBusFilterCompile(const CanBusFilterSetT* sets,
+							uint8_t setsCount,
+							CanBusFilterBlockT* blocks,
+							uint16_t blocksSize,
+							CanBusFilterPlanT* plan)
+{
+	if (!sets || !blocks || !plan || setsCount > CAN_BUS_FILTER_SETS_COUNT)
+	{
+		return xResultError;
+	}
+
+	memset(plan, 0, sizeof(CanBusFilterPlanT));
+
+	uint16_t count = 0;
+
+	for (uint8_t set = 0; set < setsCount; set++)
+	{
+		plan->IsExact[set] = true;
+
+		for (uint16_t i = 0; i < sets[set].Count; i++)
+		{
+			const CanBusSubscriptionT* subscription = &sets[set].Subscriptions[i];
+			uint32_t widthMask = privateGetWidthMask(subscription->Flags);
+
+			if (subscription->First > subscription->Last || subscription->First > widthMask)
+			{
+				continue;
+			}
+
+			if (count + privateSplit(subscription, set, NULL) > blocksSize)
+			{
+				privateAcceptAll(sets, setsCount, plan);
+
+				return xResultAccept;
+			}
+
+			count += privateSplit(subscription, set, blocks + count);
+
+			plan->Wanted[set] += (subscription->Last > widthMask ? widthMask : subscription->Last) - subscription->First + 1;
+		}
+	}
+
+	count = privateRemoveContained(blocks, count);
+
+	while (privateGetBanks(blocks, count, setsCount) > CAN_BUS_FILTER_BANKS_COUNT)
+	{
+		count = privateMergeCheapest(blocks, count, plan);
+	}
+
+	for (uint16_t i = 0; i < count; i++)
+	{
+		plan->Covered[blocks[i].Set] += privateGetCoverage(&blocks[i].Filter);
+	}
+
+	privateSort(blocks, count);
+
+	//the banks of CAN1 first, CAN2 takes the rest from CAN2SB
+	for (uint8_t pass = 0; pass < 2; pass++)
+	{
+		if (pass)
+		{
+			plan->SlaveStartBank = plan->BanksCount;
+		}
+
+		for (uint8_t set = 0; set < setsCount; set++)
+		{
+			if (sets[set].IsSlave == pass)
+			{
+				privateEmitSet(blocks, count, set, plan);
+			}
+		}
+	}
+
+	return xResultAccept;
+}
+//==============================================================================
@@ -0,0 +1,116 @@
+//==============================================================================
+//header:
+
+#ifndef _CAN_BUS_FILTER_H_
+#define _CAN_BUS_FILTER_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "CanBusRing.h"
+//==============================================================================
+//defines:
+
+#define CAN_BUS_FILTER_BANKS_COUNT 28 //shared by CAN1 and CAN2
+#define CAN_BUS_FILTER_SETS_COUNT 2 //one per controller
+
+//the layout of CAN_RIxR, the 32-bit filter registers use it too
+#define CAN_BUS_FILTER_STID_POSITION 21
+#define CAN_BUS_FILTER_EXID_POSITION 3
+#define CAN_BUS_FILTER_IDE 0x04
+#define CAN_BUS_FILTER_RTR 0x02
+
+//the layout of a 16-bit filter: STID[10:0], RTR, IDE, EXID[17:15]
+#define CAN_BUS_FILTER16_STID_POSITION 5
+#define CAN_BUS_FILTER16_IDE 0x08
+#define CAN_BUS_FILTER16_RTR 0x10
+
+#define CAN_BUS_SUBSCRIPTION_PRIORITY 0x80 //the identifiers go to FIFO1
+//==============================================================================
+//types:
+
+/// @brief the frames with (id & Mask) == (Id & Mask), the kind of the identifier must match
+typedef struct
+{
+	uint32_t Id;
+	uint32_t Mask;
+	uint8_t Flags; //CAN_BUS_FRAME_EXTENDED, CAN_BUS_SUBSCRIPTION_PRIORITY
+
+} CanBusFilterT;
+//------------------------------------------------------------------------------
+/// @brief one bank as the controller takes it: FR1 and FR2 in the layout of CAN_RIxR
+typedef struct
+{
+	uint8_t Number; //0..27, the banks from CAN2SB belong to CAN2
+	uint8_t Fifo;
+	bool IsList; //FR1 and FR2 are identifiers, not an identifier and a mask
+	bool Is32Bit; //16-bit: each register holds two identifiers or an identifier and a mask
+
+	uint32_t Registers[2];
+
+} CanBusFilterBankT;
+//------------------------------------------------------------------------------
+/// @brief the identifiers First..Last of one kind a consumer takes from the bus
+typedef struct
+{
+	uint32_t First;
+	uint32_t Last;
+	uint8_t Flags; //CAN_BUS_FRAME_EXTENDED, CAN_BUS_SUBSCRIPTION_PRIORITY
+
+} CanBusSubscriptionT;
+//------------------------------------------------------------------------------
+/// @brief the subscriptions of one controller
+typedef struct
+{
+	const CanBusSubscriptionT* Subscriptions;
+	uint16_t Count;
+	bool IsSlave; //CAN2: its banks follow CAN2SB
+
+} CanBusFilterSetT;
+//------------------------------------------------------------------------------
+/// @brief an aligned block of identifiers of one set, the unit of the compiler
+typedef struct
+{
+	CanBusFilterT Filter;
+	uint8_t Set;
+
+} CanBusFilterBlockT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	CanBusFilterBankT Banks[CAN_BUS_FILTER_BANKS_COUNT];
+	uint8_t BanksCount;
+	uint8_t SlaveStartBank;
+
+	uint8_t SetBanks[CAN_BUS_FILTER_SETS_COUNT];
+	uint16_t Merges; //blocks joined to fit the banks, each one widens the acceptance
+
+	uint64_t Wanted[CAN_BUS_FILTER_SETS_COUNT]; //identifiers of the subscriptions
+	uint64_t Covered[CAN_BUS_FILTER_SETS_COUNT]; //identifiers the banks accept
+	bool IsExact[CAN_BUS_FILTER_SETS_COUNT]; //false - the frames are checked again by CanBusFilterSetMatch
+
+} CanBusFilterPlanT;
+//==============================================================================
+//functions:
+
+void CanBusFilterEncodeMask32(const CanBusFilterT* filter, uint8_t number, uint8_t fifo, CanBusFilterBankT* bank);
+
+uint32_t CanBusFilterGetRegister(const CanBusFrameT* frame);
+bool CanBusFilterBankMatch(const CanBusFilterBankT* bank, const CanBusFrameT* frame);
+
+bool CanBusFilterSetMatch(const CanBusFilterSetT* set, const CanBusFrameT* frame);
+
+xResult CanBusFilterCompile(const CanBusFilterSetT* sets,
+							uint8_t setsCount,
+							CanBusFilterBlockT* blocks,
+							uint16_t blocksSize,
+							CanBusFilterPlanT* plan);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_CAN_BUS_FILTER_H_
@@ -0,0 +1,77 @@
+//==============================================================================
+//includes:
+
+#include "CanBusRing.h"
+//==============================================================================
+//defines:
+
+//the frame is written before the index that gives it away and read after the index that shows it
+#define CAN_BUS_RING_LOAD(index) __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+#define CAN_BUS_RING_STORE(index, value) __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+//==============================================================================
+//functions:
+
+uint16_t CanBusRingGetCount(CanBusRingT* ring)
+{
+	return (CAN_BUS_RING_LOAD(ring->Head) - CAN_BUS_RING_LOAD(ring->Tail)) & ring->SizeMask;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the entry at Head, the producer fills it and commits
+ * @return 0 - the ring is full
+ */
+CanBusFrameT* CanBusRingReserve(CanBusRingT* ring)
+{
+	uint16_t head = ring->Head;
+
+	if (((head + 1) & ring->SizeMask) == CAN_BUS_RING_LOAD(ring->Tail))
+	{
+		return 0;
+	}
+
+	return &ring->Frames[head];
+}
+//------------------------------------------------------------------------------
+void CanBusRingCommit(CanBusRingT* ring)
+{
+	uint16_t head = (ring->Head + 1) & ring->SizeMask;
+	uint16_t count = (head - CAN_BUS_RING_LOAD(ring->Tail)) & ring->SizeMask;
+
+	CAN_BUS_RING_STORE(ring->Head, head);
+
+	if (count > ring->Peak)
+	{
+		ring->Peak = count;
+	}
+}
+//------------------------------------------------------------------------------
+/// @return the oldest frame, 0 - the ring is empty
+CanBusFrameT* CanBusRingPeek(CanBusRingT* ring)
+{
+	uint16_t tail = ring->Tail;
+
+	if (tail == CAN_BUS_RING_LOAD(ring->Head))
+	{
+		return 0;
+	}
+
+	return &ring->Frames[tail];
+}
+//------------------------------------------------------------------------------
+/// @brief the peeked frame is handled, its entry goes back to the producer
+void CanBusRingRelease(CanBusRingT* ring)
+{
+	CAN_BUS_RING_STORE(ring->Tail, (ring->Tail + 1) & ring->SizeMask);
+}
+//==============================================================================
+//initialization:
+
+void CanBusRingInit(CanBusRingT* ring, CanBusFrameT* frames, uint16_t sizeMask)
+{
+	ring->Frames = frames;
+	ring->SizeMask = sizeMask;
+	ring->Head = 0;
+	ring->Tail = 0;
+	ring->Peak = 0;
+}
+//==============================================================================
@@ -0,0 +1,69 @@
+//==============================================================================
+//header:
+
+#ifndef _CAN_BUS_RING_H_
+#define _CAN_BUS_RING_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+//==============================================================================
+//defines:
+
+#define CAN_BUS_FRAME_EXTENDED 0x01 //29-bit identifier
+#define CAN_BUS_FRAME_REMOTE 0x02
+#define CAN_BUS_FRAME_TRANSMITTED 0x04 //sent by the controller, not received
+//==============================================================================
+//types:
+
+typedef struct
+{
+	uint32_t Id; //11 or 29 bits, CAN_BUS_FRAME_EXTENDED tells which
+	uint8_t Dlc;
+	uint8_t Flags; //CAN_BUS_FRAME_...
+	uint8_t Fifo; //of the controller that took the frame
+	uint8_t FilterIndex; //FMI of the controller: the filter that accepted the frame
+
+	uint8_t Data[8];
+
+	uint64_t Timestamp; //us of the system time base at the SOF of the frame
+
+} CanBusFrameT;
+//------------------------------------------------------------------------------
+/**
+ * @brief single producer, single consumer ring of frames without locks: the receive
+ * interrupt writes at Head, the task reads at Tail. One entry stays free.
+ */
+typedef struct
+{
+	CanBusFrameT* Frames;
+	uint16_t SizeMask; //size - 1, the size is a power of two
+
+	uint16_t Head; //written by the producer only
+	uint16_t Tail; //written by the consumer only
+
+	uint16_t Peak; //the largest count seen by the producer
+
+} CanBusRingT;
+//==============================================================================
+//functions:
+
+void CanBusRingInit(CanBusRingT* ring, CanBusFrameT* frames, uint16_t sizeMask);
+
+uint16_t CanBusRingGetCount(CanBusRingT* ring);
+
+CanBusFrameT* CanBusRingReserve(CanBusRingT* ring);
+void CanBusRingCommit(CanBusRingT* ring);
+
+CanBusFrameT* CanBusRingPeek(CanBusRingT* ring);
+void CanBusRingRelease(CanBusRingT* ring);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_CAN_BUS_RING_H_
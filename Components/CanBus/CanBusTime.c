@@ -0,0 +1,132 @@
+//==============================================================================
+//includes:
+
+#include <string.h>
+#include "CanBusTime.h"
+//==============================================================================
+//functions:
+
+/**
+ * @brief the ticks of the count: called more often than the count wraps (51 s at 84 MHz),
+ * the callers from the interrupts are serialized by the caller
+ */
+uint64_t CanBusTimeExtend(CanBusTimeT* time, uint32_t count)
+{
+	if (count < time->Last)
+	{
+		time->Wraps += 1ULL << 32;
+	}
+
+	time->Last = count;
+
+	return time->Wraps | count;
+}
+//------------------------------------------------------------------------------
+uint64_t CanBusTimeToMicroseconds(const CanBusTimeT* time, uint64_t ticks)
+{
+	int64_t elapsed = (int64_t)(ticks - time->Origin);
+
+	return time->BaseMicroseconds + elapsed / (int64_t)time->TicksPerMicrosecond;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief bit times from the SOF to the frame valid at the sixth bit of EOF,
+ * without the stuff bits: the shortest the frame can take
+ */
+uint16_t CanBusTimeGetFrameBits(const CanBusFrameT* frame)
+{
+	uint16_t bits = frame->Flags & CAN_BUS_FRAME_EXTENDED ? 63 : 43;
+
+	if (!(frame->Flags & CAN_BUS_FRAME_REMOTE))
+	{
+		bits += (frame->Dlc > 8 ? 8 : frame->Dlc) * 8;
+	}
+
+	return bits;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the ticks of the SOF of a frame:
+ * - the frame was taken now, the stamp is the CAN timer at its SOF, bits is its shortest length;
+ * - a frame taken at once sets the reference exactly, a late one sets it too high:
+ *   the lowest reference wins and it rises by the drift of the clocks only;
+ * - the SOF is the last time before now the CAN timer read the stamp.
+ * The frame must be taken within a wrap of the CAN timer (0.52 s at 125 kbit/s).
+ */
+uint64_t CanBusTimeSyncStamp(CanBusTimeSyncT* sync, uint64_t now, uint16_t stamp, uint16_t bits)
+{
+	uint64_t offset = (uint64_t)stamp * sync->TicksPerBit;
+	uint64_t candidate = now - (uint64_t)bits * sync->TicksPerBit - offset;
+	int64_t wrap = sync->Wrap;
+
+	if (!sync->IsLocked)
+	{
+		sync->Reference = candidate;
+		sync->IsLocked = true;
+	}
+	else
+	{
+		//the candidate and the reference in the same wrap of the CAN timer
+		int64_t delta = (int64_t)(candidate - sync->Reference) % wrap;
+
+		if (delta > wrap / 2)
+		{
+			delta -= wrap;
+		}
+		else if (delta <= -wrap / 2)
+		{
+			delta += wrap;
+		}
+
+		if (delta < 0)
+		{
+			sync->Reference += delta;
+			sync->Steps++;
+		}
+		else if (delta > wrap >> CAN_BUS_TIME_RELOCK_SHIFT)
+		{
+			sync->Reference = candidate;
+			sync->Relocks++;
+		}
+		else
+		{
+			uint64_t rise = (now - sync->LastUpdate) >> CAN_BUS_TIME_DRIFT_SHIFT;
+
+			sync->Reference += (uint64_t)delta < rise ? (uint64_t)delta : rise;
+		}
+	}
+
+	sync->LastUpdate = now;
+
+	int64_t age = (int64_t)(now - offset - sync->Reference) % wrap;
+
+	if (age < 0)
+	{
+		age += wrap;
+	}
+
+	return now - age;
+}
+//==============================================================================
+//initialization:
+
+void CanBusTimeInit(CanBusTimeT* time, uint32_t frequency, uint32_t count, uint64_t baseMicroseconds)
+{
+	memset(time, 0, sizeof(CanBusTimeT));
+
+	time->Frequency = frequency;
+	time->TicksPerMicrosecond = frequency / 1000000;
+	time->BaseMicroseconds = baseMicroseconds;
+	time->Last = count;
+	time->Origin = count;
+}
+//------------------------------------------------------------------------------
+/// @brief ticksPerBit 0 - the controller is not in TTCM: the frames take the time they were read
+void CanBusTimeSyncInit(CanBusTimeSyncT* sync, uint32_t ticksPerBit)
+{
+	memset(sync, 0, sizeof(CanBusTimeSyncT));
+
+	sync->TicksPerBit = ticksPerBit;
+	sync->Wrap = ticksPerBit << 16;
+}
+//==============================================================================
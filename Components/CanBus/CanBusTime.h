@@ -0,0 +1,68 @@
+//==============================================================================
+//header:
+
+#ifndef _CAN_BUS_TIME_H_
+#define _CAN_BUS_TIME_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "CanBusRing.h"
+//==============================================================================
+//defines:
+
+#define CAN_BUS_TIME_DRIFT_SHIFT 12 //the bit clock of the bus may fall behind the timer by 1/4096 (244 ppm)
+#define CAN_BUS_TIME_RELOCK_SHIFT 3 //a latency above 1/8 of the CAN timer wrap: the controller was restarted
+//==============================================================================
+//types:
+
+/// @brief the free-running 32-bit timer extended to 64 bits and tied to the system time base
+typedef struct
+{
+	uint32_t Frequency; //Hz of the timer
+	uint32_t TicksPerMicrosecond;
+
+	uint64_t Origin; //ticks at BaseMicroseconds
+	uint64_t BaseMicroseconds; //the system time base at Origin
+
+	uint32_t Last; //the last count read
+	uint64_t Wraps; //the ticks of the wraps of the count
+
+} CanBusTimeT;
+//------------------------------------------------------------------------------
+/**
+ * @brief the 16-bit timer of a controller in TTCM: it counts bit times and is captured at the SOF
+ * of each frame. Its place on the timer is the lowest latency seen, allowed to rise by the drift only.
+ */
+typedef struct
+{
+	uint32_t TicksPerBit; //0 - the controller does not stamp the frames
+	uint32_t Wrap; //ticks of the 65536 bit times
+
+	uint64_t Reference; //ticks when the CAN timer read 0
+	uint64_t LastUpdate;
+	bool IsLocked;
+
+	uint32_t Steps; //a lower latency moved the reference down
+	uint32_t Relocks;
+
+} CanBusTimeSyncT;
+//==============================================================================
+//functions:
+
+void CanBusTimeInit(CanBusTimeT* time, uint32_t frequency, uint32_t count, uint64_t baseMicroseconds);
+uint64_t CanBusTimeExtend(CanBusTimeT* time, uint32_t count);
+uint64_t CanBusTimeToMicroseconds(const CanBusTimeT* time, uint64_t ticks);
+
+void CanBusTimeSyncInit(CanBusTimeSyncT* sync, uint32_t ticksPerBit);
+uint16_t CanBusTimeGetFrameBits(const CanBusFrameT* frame);
+uint64_t CanBusTimeSyncStamp(CanBusTimeSyncT* sync, uint64_t now, uint16_t stamp, uint16_t bits);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_CAN_BUS_TIME_H_
@@ -0,0 +1,300 @@
+//==============================================================================
+//includes:
+
+#include <string.h>
+#include "Cobs.h"
+//==============================================================================
+//types:
+
+/// @brief the code of a block is written when its end is known: on a zero or after COBS_BLOCK_SIZE bytes
+typedef struct
+{
+	uint8_t* Code;
+	uint8_t* Write;
+	uint8_t Count; //the code of the open block: its data bytes + 1
+
+} CobsEncoderT;
+//==============================================================================
+//functions:
+
+static inline void privateEncoderStart(CobsEncoderT* encoder, uint8_t* out)
+{
+	encoder->Code = out;
+	encoder->Write = out + 1;
+	encoder->Count = 1;
+}
+//------------------------------------------------------------------------------
+static inline void privateEncoderPut(CobsEncoderT* encoder, uint8_t value)
+{
+	if (value != COBS_DELIMITER)
+	{
+		*encoder->Write++ = value;
+
+		if (++encoder->Count != COBS_BLOCK_SIZE + 1)
+		{
+			return;
+		}
+	}
+
+	*encoder->Code = encoder->Count;
+	encoder->Code = encoder->Write++;
+	encoder->Count = 1;
+}
+//------------------------------------------------------------------------------
+static inline uint8_t* privateEncoderEnd(CobsEncoderT* encoder)
+{
+	*encoder->Code = encoder->Count;
+
+	return encoder->Write;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the data without zeros, the delimiters are not added
+ * @param out COBS_ENCODED_SIZE(size) bytes, may not overlap the data
+ * @return encoded bytes
+ */
+uint32_t CobsEncode(const uint8_t* data, uint32_t size, uint8_t* out)
+{
+	CobsEncoderT encoder;
+
+	privateEncoderStart(&encoder, out);
+
+	while (size--)
+	{
+		privateEncoderPut(&encoder, *data++);
+	}
+
+	return privateEncoderEnd(&encoder) - out;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief decodes the data without the delimiters in place: the output is never longer
+ * @return decoded bytes, -1 - a zero in the data or a block longer than the data
+ */
+int32_t CobsDecode(uint8_t* data, uint32_t size)
+{
+	const uint8_t* read = data;
+	const uint8_t* end = data + size;
+	uint8_t* write = data;
+
+	while (read < end)
+	{
+		uint8_t code = *read++;
+
+		if (code == COBS_DELIMITER || code - 1 > end - read)
+		{
+			return -1;
+		}
+
+		for (uint8_t i = 1; i < code; i++)
+		{
+			if (*read == COBS_DELIMITER)
+			{
+				return -1;
+			}
+
+			*write++ = *read++;
+		}
+
+		if (code != COBS_BLOCK_SIZE + 1 && read < end)
+		{
+			*write++ = 0;
+		}
+	}
+
+	return write - data;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief "\0<COBS of payload and CRC>\0", the frame for CobsReceiverT
+ * @param frame COBS_FRAME_SIZE(size) bytes
+ * @return bytes of the frame
+ */
+uint32_t CobsFrameEncode(const void* payload, uint32_t size, CobsCrcT crc, uint8_t* frame)
+{
+	const uint8_t* data = payload;
+	uint32_t value = crc(payload, size);
+	CobsEncoderT encoder;
+
+	frame[0] = COBS_DELIMITER;
+
+	privateEncoderStart(&encoder, frame + 1);
+
+	while (size--)
+	{
+		privateEncoderPut(&encoder, *data++);
+	}
+
+	for (uint8_t i = 0; i < COBS_CRC_SIZE; i++)
+	{
+		privateEncoderPut(&encoder, value >> (i * 8));
+	}
+
+	uint8_t* end = privateEncoderEnd(&encoder);
+
+	*end++ = COBS_DELIMITER;
+
+	return end - frame;
+}
+//------------------------------------------------------------------------------
+void CobsReceiverClear(CobsReceiverT* receiver)
+{
+	receiver->Size = 0;
+	receiver->Remaining = 0;
+	receiver->Code = 0;
+	receiver->IsFrame = false;
+	receiver->IsOverflow = false;
+}
+//------------------------------------------------------------------------------
+/// @brief the closing delimiter: a zero right after the opening one keeps the frame open
+static void privateFrameEnd(CobsReceiverT* receiver)
+{
+	if (!receiver->Code)
+	{
+		return;
+	}
+
+	if (receiver->IsOverflow)
+	{
+		receiver->Statistic.Overflows++;
+	}
+	else if (receiver->Remaining || receiver->Size < COBS_CRC_SIZE)
+	{
+		receiver->Statistic.Errors++;
+	}
+	else
+	{
+		uint32_t size = receiver->Size - COBS_CRC_SIZE;
+		uint8_t* crc = receiver->Buffer + size;
+		uint32_t value = crc[0] | ((uint32_t)crc[1] << 8) | ((uint32_t)crc[2] << 16) | ((uint32_t)crc[3] << 24);
+
+		if (value == receiver->Crc(receiver->Buffer, size))
+		{
+			receiver->Statistic.Frames++;
+			receiver->Listener(receiver->Context, receiver->Buffer, size);
+		}
+		else
+		{
+			receiver->Statistic.CrcErrors++;
+		}
+	}
+
+	CobsReceiverClear(receiver);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the bytes of a frame are decoded as they come, the zeros of the blocks are put
+ * when the next code shows the block was not the last one
+ */
+static uint32_t privateReceiveFrame(CobsReceiverT* receiver, const uint8_t* data, uint32_t size)
+{
+	const uint8_t* read = data;
+	const uint8_t* end = data + size;
+
+	while (read < end)
+	{
+		uint8_t value = *read++;
+
+		if (value == COBS_DELIMITER)
+		{
+			privateFrameEnd(receiver);
+
+			if (!receiver->IsFrame)
+			{
+				break;
+			}
+
+			continue;
+		}
+
+		if (receiver->IsOverflow)
+		{
+			continue;
+		}
+
+		if (receiver->Remaining)
+		{
+			receiver->Remaining--;
+		}
+		else
+		{
+			bool isZero = receiver->Code && receiver->Code != COBS_BLOCK_SIZE + 1;
+
+			receiver->Code = value;
+			receiver->Remaining = value - 1;
+
+			if (!isZero)
+			{
+				continue;
+			}
+
+			value = 0;
+		}
+
+		if (receiver->Size == receiver->BufferSize)
+		{
+			receiver->IsOverflow = true;
+			continue;
+		}
+
+		receiver->Buffer[receiver->Size++] = value;
+	}
+
+	return read - data;
+}
+//------------------------------------------------------------------------------
+/// @brief called by the receive owner of the port with the bytes in the order of the line
+void CobsReceiverReceive(CobsReceiverT* receiver, uint8_t* data, uint32_t size)
+{
+	while (size)
+	{
+		uint32_t count;
+
+		if (receiver->IsFrame)
+		{
+			count = privateReceiveFrame(receiver, data, size);
+		}
+		else
+		{
+			uint8_t* delimiter = memchr(data, COBS_DELIMITER, size);
+
+			count = delimiter ? delimiter - data : size;
+
+			if (count && receiver->Text)
+			{
+				xRxReceiverReceive(receiver->Text, data, count);
+			}
+
+			if (delimiter)
+			{
+				receiver->IsFrame = true;
+				count++;
+			}
+		}
+
+		data += count;
+		size -= count;
+	}
+}
+//==============================================================================
+//initialization:
+
+xResult CobsReceiverInit(CobsReceiverT* receiver, CobsReceiverInitT* init)
+{
+	if (!receiver || !init || !init->Listener || !init->Crc || !init->Buffer || init->BufferSize <= COBS_CRC_SIZE)
+	{
+		return xResultError;
+	}
+
+	memset(receiver, 0, sizeof(CobsReceiverT));
+
+	receiver->Text = init->Text;
+	receiver->Listener = init->Listener;
+	receiver->Context = init->Context;
+	receiver->Crc = init->Crc;
+	receiver->Buffer = init->Buffer;
+	receiver->BufferSize = init->BufferSize;
+
+	return xResultAccept;
+}
+//==============================================================================
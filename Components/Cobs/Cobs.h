@@ -0,0 +1,95 @@
+//==============================================================================
+//header:
+
+#ifndef _COBS_H_
+#define _COBS_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+#include "Common/xRxReceiver.h"
+//==============================================================================
+//defines:
+
+#define COBS_DELIMITER 0
+#define COBS_BLOCK_SIZE 254 //data bytes of a block without a zero
+#define COBS_CRC_SIZE 4 //CRC-32 of the payload after it, little endian
+
+#define COBS_ENCODED_SIZE(size) ((size) + (size) / COBS_BLOCK_SIZE + 1) //the largest
+#define COBS_FRAME_SIZE(payload) (COBS_ENCODED_SIZE((payload) + COBS_CRC_SIZE) + 2) //with both delimiters
+//==============================================================================
+//types:
+
+typedef uint32_t (*CobsCrcT)(const void* data, uint32_t size);
+//------------------------------------------------------------------------------
+/// @brief the payload without the CRC, decoded in the buffer of the receiver
+typedef void (*CobsFrameListenerT)(void* context, uint8_t* payload, uint32_t size);
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Frames;
+	uint32_t CrcErrors;
+	uint32_t Errors; //broken coding: a block cut by the delimiter or a frame shorter than the CRC
+	uint32_t Overflows; //frames longer than the buffer
+
+} CobsReceiverStatisticT;
+//------------------------------------------------------------------------------
+/**
+ * @brief the text goes to the xRxReceiverT as before, a zero opens a frame and the next zero
+ * closes it: "\0<COBS of payload and CRC>\0". The text never has zeros, so both share the stream.
+ */
+typedef struct
+{
+	xRxReceiverT* Text; //the bytes out of the frames, 0 - dropped
+
+	CobsFrameListenerT Listener;
+	void* Context;
+	CobsCrcT Crc;
+
+	uint8_t* Buffer;
+	uint32_t BufferSize;
+
+	uint32_t Size; //decoded bytes of the frame
+	uint8_t Remaining; //data bytes left in the block, 0 - the next byte is a code
+	uint8_t Code; //of the current block, 0 - no block yet
+
+	bool IsFrame;
+	bool IsOverflow;
+
+	CobsReceiverStatisticT Statistic;
+
+} CobsReceiverT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	xRxReceiverT* Text;
+
+	CobsFrameListenerT Listener;
+	void* Context;
+	CobsCrcT Crc;
+
+	uint8_t* Buffer; //the largest payload and the CRC
+	uint32_t BufferSize;
+
+} CobsReceiverInitT;
+//==============================================================================
+//functions:
+
+uint32_t CobsEncode(const uint8_t* data, uint32_t size, uint8_t* out);
+int32_t CobsDecode(uint8_t* data, uint32_t size);
+
+uint32_t CobsFrameEncode(const void* payload, uint32_t size, CobsCrcT crc, uint8_t* frame);
+
+xResult CobsReceiverInit(CobsReceiverT* receiver, CobsReceiverInitT* init);
+void CobsReceiverReceive(CobsReceiverT* receiver, uint8_t* data, uint32_t size);
+void CobsReceiverClear(CobsReceiverT* receiver);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_COBS_H_
@@ -0,0 +1,99 @@
+//==============================================================================
+//includes:
+
+#include <string.h>
+#include "CobsPort.h"
+//==============================================================================
+//functions:
+
+/// @brief the listener of the receivers of all the adapters: the request is handled, the reply is framed
+static void privateFrameListener(void* context, uint8_t* payload, uint32_t size)
+{
+	CobsPortT* cobs = context;
+	RxDataPacketT packet =
+	{
+		.Data = payload,
+		.FullSize = size,
+		.Size = size
+	};
+
+	cobs->ReplySize = 0;
+	cobs->Replier = xTaskGetCurrentTaskHandle();
+
+	cobs->Handler(cobs->Port, &packet);
+
+	cobs->Replier = 0;
+
+	if (!cobs->ReplySize)
+	{
+		return;
+	}
+
+	//the request is taken by the handler: its buffer holds the frame, the transmit of the adapter copies it
+	size = CobsFrameEncode(cobs->Reply, cobs->ReplySize, cobs->Receiver.Crc, cobs->Receiver.Buffer);
+
+	xPortStartTransmission(cobs->Port);
+	xPortTransmitData(cobs->Port, cobs->Receiver.Buffer, size);
+	xPortEndTransmission(cobs->Port);
+
+	cobs->Statistic.Replies++;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief called by the transmit of the adapter: the data of the task handling a frame is its reply
+ * @return true - taken into the reply, false - the data goes to the line
+ */
+bool CobsPortTransmit(CobsPortT* cobs, const void* data, uint32_t size)
+{
+	if (!cobs->Replier || cobs->Replier != xTaskGetCurrentTaskHandle())
+	{
+		return false;
+	}
+
+	if (size > cobs->ReplyBufferSize - cobs->ReplySize)
+	{
+		size = cobs->ReplyBufferSize - cobs->ReplySize;
+		cobs->Statistic.ReplyOverflows++;
+	}
+
+	memcpy(cobs->Reply + cobs->ReplySize, data, size);
+	cobs->ReplySize += size;
+
+	return true;
+}
+//==============================================================================
+//initialization:
+
+xResult CobsPortInit(CobsPortT* cobs, xPortT* port, CobsPortInitT* init)
+{
+	if (!cobs || !port || !init || !init->Handler || !init->ReplyBuffer
+		|| COBS_FRAME_SIZE(init->ReplyBufferSize) > init->BufferSize)
+	{
+		return xResultError;
+	}
+
+	memset(cobs, 0, sizeof(CobsPortT));
+
+	CobsReceiverInitT receiverInit =
+	{
+		.Text = init->Text,
+		.Listener = privateFrameListener,
+		.Context = cobs,
+		.Crc = init->Crc,
+		.Buffer = init->Buffer,
+		.BufferSize = init->BufferSize
+	};
+
+	if (CobsReceiverInit(&cobs->Receiver, &receiverInit) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	cobs->Port = port;
+	cobs->Handler = init->Handler;
+	cobs->Reply = init->ReplyBuffer;
+	cobs->ReplyBufferSize = init->ReplyBufferSize;
+
+	return xResultAccept;
+}
+//==============================================================================
@@ -0,0 +1,76 @@
+//==============================================================================
+//header:
+
+#ifndef _COBS_PORT_H_
+#define _COBS_PORT_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+#include "Cobs/Cobs.h"
+#include "Abstractions/xPort/xPort.h"
+#include "FreeRTOS.h"
+#include "task.h"
+//==============================================================================
+//types:
+
+/// @brief the payload of a frame as a packet of the port: TerminalCommandsReceive takes it as a line
+typedef void (*CobsPortHandlerT)(xPortT* port, RxDataPacketT* packet);
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Replies;
+	uint32_t ReplyOverflows; //the reply was cut to ReplyBufferSize
+
+} CobsPortStatisticT;
+//------------------------------------------------------------------------------
+/**
+ * @brief the COBS frames of a port adapter. The handler takes the payload, whatever it transmits
+ * to the port meanwhile goes back in one frame; the text lines keep their text replies.
+ */
+typedef struct
+{
+	xPortT* Port; //0 - text only
+
+	CobsReceiverT Receiver; //decodes the request, then holds the frame of the reply
+	CobsPortHandlerT Handler;
+
+	uint8_t* Reply;
+	uint32_t ReplyBufferSize;
+	uint32_t ReplySize;
+	TaskHandle_t Replier; //the task handling the frame, 0 - none
+
+	CobsPortStatisticT Statistic;
+
+} CobsPortT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	xRxReceiverT* Text;
+
+	CobsPortHandlerT Handler;
+	CobsCrcT Crc;
+
+	uint8_t* Buffer; //the largest request and its CRC
+	uint32_t BufferSize;
+
+	uint8_t* ReplyBuffer; //COBS_FRAME_SIZE(ReplyBufferSize) fits BufferSize
+	uint32_t ReplyBufferSize;
+
+} CobsPortInitT;
+//==============================================================================
+//functions:
+
+xResult CobsPortInit(CobsPortT* cobs, xPortT* port, CobsPortInitT* init);
+
+bool CobsPortTransmit(CobsPortT* cobs, const void* data, uint32_t size);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_COBS_PORT_H_
@@ -17,6 +17,14 @@ extern "C" {
 
 #define NET_ENABLE 1
 #define MQTT_ENABLE 1
+#define IPERF_ENABLE 1
+#define MQTT_BENCH_ENABLE 1
+#define HTTP_CLIENT_ENABLE 1
+#define USART_DMA_ENABLE 1
+#define MODBUS_ENABLE 1 //on the RS485 port of USART_DMA_ENABLE
+#define CRC_ENABLE 1
+#define CAN_BUS_ENABLE 1 //the receive of both CAN controllers, after CAN-Ports of DEVICE_CONTROL_ENABLE
+#define CAN_BRIDGE_ENABLE 1 //both CAN buses over UDP (cannelloni), needs NET_ENABLE and CAN_BUS_ENABLE
 
 #define FREERTOS_ENABLE 1
 #define DEVICE_CONTROL_ENABLE 1
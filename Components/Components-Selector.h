@@ -20,6 +20,14 @@ extern "C" {
 #include "Components/USART-Ports/USART-Ports-Component.h"
 #include "Net/Net-Component.h"
 #include "MqttClient/MqttClient-Component.h"
+#include "Iperf/Iperf-Component.h"
+#include "MqttBench/MqttBench-Component.h"
+#include "HttpClient/HttpClient-Component.h"
+#include "UsartDma/UsartDma-Component.h"
+#include "Modbus/Modbus-Component.h"
+#include "Crc/Crc-Component.h"
+#include "CanBus/CanBus-Component.h"
+#include "CanBridge/CanBridge-Component.h"
 
 #include "CAN-Ports/CAN_Ports-Component.h"
 
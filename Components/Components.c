@@ -12,11 +12,6 @@
 #if FREERTOS_ENABLE == 1
 #define COMPONENTS_MAIN_TASK_STACK_SIZE 0x200
 #endif
-//------------------------------------------------------------------------------
-#define HTTP_HOST "device-api.sintez.by"
-#define HTTP_HOST_AUTHORIZATION "X-Sintez-Auth: 6b9f7b57e10f498e634204e77009e472"
-#define HTTP_REPORT_DEVICE_ID "ce501046-f876-4bf6-8151-117b711340c5"
-#define HTTP_GET_HEADER "GET /v0.4/devices/" HTTP_REPORT_DEVICE_ID " HTTP/1.1\r\n" HTTP_HOST_AUTHORIZATION "\r\n" "Host: " HTTP_HOST "\r\n\r\n"
 //==============================================================================
 //variables:
 
@@ -120,10 +115,26 @@ xResult ComponentsInit(void* parent)
 {
 	xSystemInit(parent);
 
+	//the cycle counter (DWT->CYCCNT) of the statistics and the benches of the components
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
 	TerminalComponentInit(parent);
 
 	UsartPortsComponentInit(parent);
 
+#if CRC_ENABLE == 1 //before the ports: the CRC of their COBS frames
+	CrcComponentInit(parent);
+#endif
+
+#if USART_DMA_ENABLE == 1
+	UsartDmaComponentInit(parent);
+#endif
+
+#if MODBUS_ENABLE == 1
+	ModbusComponentInit(parent);
+#endif
+
 #if NET_ENABLE == 1
 	NetComponentInit(parent);
 
@@ -131,6 +142,18 @@ xResult ComponentsInit(void* parent)
 	MqttClientComponentInit(parent);
 #endif
 
+#if IPERF_ENABLE == 1
+	IperfComponentInit(parent);
+#endif
+
+#if MQTT_BENCH_ENABLE == 1
+	MqttBenchComponentInit(parent);
+#endif
+
+#if HTTP_CLIENT_ENABLE == 1
+	HttpClientComponentInit(parent);
+#endif
+
 #endif
 
 #if DEVICE_CONTROL_ENABLE == 1
@@ -147,6 +170,14 @@ xResult ComponentsInit(void* parent)
 
 #endif
 
+#if CAN_BUS_ENABLE == 1 //after CAN-Ports: the filters and the receive interrupts are taken over
+	CanBusComponentInit(parent);
+#endif
+
+#if CAN_BRIDGE_ENABLE == 1 //after CanBus: a listener of its frames
+	CanBridgeComponentInit(parent);
+#endif
+
 	xTimerCoreBind(xTimer4, Timer4_IRQ_Handler, rTimer4, 0);
 	rTimer4->DMAOrInterrupts.UpdateInterruptEnable = true;
 	rTimer4->Control1.CounterEnable = true;
@@ -52,6 +52,7 @@
 #define ipconfigTCP_WIN_SEG_COUNT				12
 
 #define ipconfigSOCK_DEFAULT_RECEIVE_BLOCK_TIME	10000
+#define ipconfigSOCKET_HAS_USER_SEMAPHORE		1	// sockets give a semaphore on rx/tx/close events (MQTT port)
 
 #define iptraceSTACK_TX_EVENT_LOST(x)
 #define iptraceETHERNET_RX_EVENT_LOST()
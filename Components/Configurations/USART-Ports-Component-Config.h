@@ -91,6 +91,8 @@ extern DMA_HandleTypeDef hdma_usart2_rx;
 //------------------------------------------------------------------------------
 #if SERIAL3_ENABLE == 1
 extern DMA_HandleTypeDef hdma_usart3_rx;
+extern DMA_HandleTypeDef hdma_usart3_tx;
+extern UART_HandleTypeDef huart3;
 
 #define SERIAL3_RX_CIRCLE_BUF_SIZE_MASK 0xff
 #define SERIAL3_RX_OBJECT_BUF_SIZE 0x1ff
@@ -98,6 +100,10 @@ extern DMA_HandleTypeDef hdma_usart3_rx;
 #define SERIAL3_REG USART3
 #define SERIAL3_PORT_NUMBER xUSART3
 #define SERIAL3_RX_DMA hdma_usart3_rx
+#define SERIAL3_TX_DMA hdma_usart3_tx
+#define SERIAL3_HANDLE huart3
+#define SERIAL3_IRQ USART3_IRQn
+#define SERIAL3_TX_DMA_ENABLE 1 //UsartDma adapter instead of a TXE interrupt per byte
 
 #define SERIAL3_TX_CIRCLE_BUF_MEM_SECTION __attribute__((section("._user_heap_stack")))
 #define SERIAL3_RX_CIRCLE_BUF_MEM_SECTION //__attribute__((section("._user_heap_stack")))
@@ -135,6 +141,8 @@ extern DMA_HandleTypeDef hdma_usart3_rx;
 //------------------------------------------------------------------------------
 #if SERIAL6_ENABLE == 1
 extern DMA_HandleTypeDef hdma_usart6_rx;
+extern DMA_HandleTypeDef hdma_usart6_tx;
+extern UART_HandleTypeDef huart6;
 
 #define SERIAL6_RX_CIRCLE_BUF_SIZE_MASK 0xff
 #define SERIAL6_RX_OBJECT_BUF_SIZE 0x1ff
@@ -142,6 +150,10 @@ extern DMA_HandleTypeDef hdma_usart6_rx;
 #define SERIAL6_REG USART6
 #define SERIAL6_PORT_NUMBER xUSART6
 #define SERIAL6_RX_DMA hdma_usart6_rx
+#define SERIAL6_TX_DMA hdma_usart6_tx
+#define SERIAL6_HANDLE huart6
+#define SERIAL6_IRQ USART6_IRQn
+#define SERIAL6_TX_DMA_ENABLE 1 //UsartDma adapter instead of a TXE interrupt per byte
 
 #define SERIAL6_TX_CIRCLE_BUF_MEM_SECTION __attribute__((section("._user_heap_stack")))
 #define SERIAL6_RX_CIRCLE_BUF_MEM_SECTION //__attribute__((section("._user_heap_stack")))
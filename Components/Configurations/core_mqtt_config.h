@@ -10,12 +10,16 @@ extern "C" {
 //==============================================================================
 //includes:
 
-
+#include <stdint.h>
 //==============================================================================
 //defines:
 
 #define MQTT_RECV_POLLING_TIMEOUT_MS 0
 
+//coreMQTT v2.1.1 never updates lastPacketRxTime: after PACKET_RX_TIMEOUT_MS of uptime every pass
+//without data would send PINGREQ. The keep-alive goes by lastPacketTxTime only
+#define PACKET_RX_TIMEOUT_MS UINT32_MAX
+
 typedef struct NetworkContext
 {
 	void* Context;
@@ -0,0 +1,107 @@
+//==============================================================================
+//header:
+
+#ifndef _WOLFSSL_USER_SETTINGS_H_
+#define _WOLFSSL_USER_SETTINGS_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//defines:
+
+//the wolfSSL sources are built with the MQTT TLS only: the seed and the pool come from MqttTls.c
+#if !defined(MQTT_PORT_TLS_ENABLE) || MQTT_PORT_TLS_ENABLE != 1
+#error "wolfSSL requires MQTT_PORT_TLS_ENABLE=1 of the build (cmake -DMQTT_TLS=ON)"
+#endif
+
+//platform
+#define FREERTOS
+#define WOLFSSL_STM32F4
+#define WOLFSSL_STM32_CUBEMX
+#define NO_STM32_CRYPTO //STM32F407 has no CRYP/HASH units
+#define NO_STM32_HASH
+#define NO_STM32_RNG //the seed is taken from hrng, see MqttTlsGenerateSeed
+#define SIZEOF_LONG_LONG 8
+#define WOLFSSL_GENERAL_ALIGNMENT 4
+#define WOLFSSL_IGNORE_FILE_WARN
+
+#define NO_FILESYSTEM
+#define NO_WRITEV
+#define NO_DEV_RANDOM
+#define NO_MAIN_DRIVER
+#define WOLFSSL_USER_IO //the IO callbacks are set by MqttTls over FreeRTOS+TCP sockets
+
+//time: the validity dates of the certificates are checked against the SNTP time given to MqttTlsInit,
+//not against the RTC of the board (HAL_RTC_MODULE_ENABLED would select stm32_hal_time)
+#include <time.h>
+extern time_t MqttTlsTime(time_t* timer);
+#define TIME_OVERRIDES
+#define HAVE_TIME_T_TYPE
+#define HAVE_TM_TYPE
+#define XTIME(timer) MqttTlsTime(timer)
+#define XGMTIME(timer, tmp) gmtime_r(timer, tmp)
+
+//memory: all the allocations are taken from the static pool given to MqttTlsInit
+#define WOLFSSL_STATIC_MEMORY
+#define WOLFSSL_NO_MALLOC //no WOLFSSL_SMALL_STACK with the static pool: the big numbers are on the stack of the MQTT task
+#define WOLFSSL_DYN_CERT //the RSA key of a CA is copied to the pool, without it an RSA chain fails with BAD_FUNC_ARG
+#define WOLFMEM_MAX_BUCKETS 9
+#define WOLFMEM_BUCKETS 64,128,256,512,1024,2432,3456,4544,16128
+#define WOLFMEM_DIST 28,10,8,10,4,4,2,2,1
+
+//RNG
+extern int MqttTlsGenerateSeed(unsigned char* output, unsigned int size);
+#define CUSTOM_RAND_GENERATE_SEED MqttTlsGenerateSeed
+#define HAVE_HASHDRBG
+
+//TLS
+#define NO_WOLFSSL_SERVER
+#define NO_OLD_TLS
+#define HAVE_TLS_EXTENSIONS
+#define HAVE_SUPPORTED_CURVES
+#define HAVE_EXTENDED_MASTER
+#define HAVE_ENCRYPT_THEN_MAC
+#define HAVE_SNI
+#define WOLFSSL_IP_ALT_NAME //MQTT_TLS_SERVER_NAME may be the IP address of the broker
+#include <stdio.h> //asn.c prints the IP alt names with XSNPRINTF
+#define HAVE_MAX_FRAGMENT
+#define HAVE_SESSION_TICKET
+#define SMALL_SESSION_CACHE
+
+//ciphers: ECDHE with AES-GCM or ChaCha20-Poly1305
+#define HAVE_ECC
+#define ECC_TIMING_RESISTANT
+#define ECC_USER_CURVES //P-256 only
+#define HAVE_AESGCM
+#define GCM_SMALL
+#define WOLFSSL_AES_SMALL_TABLES
+#define HAVE_CHACHA
+#define HAVE_POLY1305
+#define HAVE_ONE_TIME_AUTH
+#define WC_RSA_BLINDING
+#define TFM_TIMING_RESISTANT
+
+//math
+#define WOLFSSL_SP_MATH_ALL
+#define WOLFSSL_SP_SMALL
+#define SP_INT_BITS 2048 //RSA-2048 certificates, the numbers on the stack are sized by it
+#define WOLFSSL_HAVE_SP_ECC
+#define WOLFSSL_HAVE_SP_RSA
+#define WOLFSSL_SP_ARM_CORTEX_M_ASM
+
+#define NO_DH
+#define NO_DSA
+#define NO_DES3
+#define NO_RC4
+#define NO_MD4
+#define NO_MD5
+#define NO_PSK
+#define NO_PWDBASED
+#define WOLFSSL_NO_SHAKE256
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_WOLFSSL_USER_SETTINGS_H_
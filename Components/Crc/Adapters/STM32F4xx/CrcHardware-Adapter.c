@@ -0,0 +1,207 @@
+//==============================================================================
+//includes:
+
+#include "CrcHardware-Adapter.h"
+//==============================================================================
+//defines:
+
+#define CRC_HARDWARE_POLYNOMIAL 0x04c11db7
+#define CRC_HARDWARE_INIT 0xffffffff
+#define CRC_HARDWARE_DMA_MAX_WORDS 0xffff //NDTR
+//==============================================================================
+//functions:
+
+/**
+ * @brief the unit is reset to CRC_HARDWARE_INIT only: the word that brings it to the register
+ * is found by 32 steps of the shift register backwards
+ */
+static void privateLoad(CRC_TypeDef* crc, uint32_t value)
+{
+	WRITE_REG(crc->CR, CRC_CR_RESET);
+
+	if (value == CRC_HARDWARE_INIT)
+	{
+		return;
+	}
+
+	for (uint8_t i = 0; i < 32; i++)
+	{
+		value = (value & 1) ? ((value ^ CRC_HARDWARE_POLYNOMIAL) >> 1) | 0x80000000 : value >> 1;
+	}
+
+	WRITE_REG(crc->DR, value ^ CRC_HARDWARE_INIT);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the unit takes the most significant bit first: a reflected variant is the normal one with
+ * the bits reversed, a normal variant of bytes wants the first byte in the high bits
+ */
+static void privateWrite(CRC_TypeDef* crc, const CrcParametersT* parameters, const uint8_t* data, uint32_t words)
+{
+	const uint8_t* end = data + words * sizeof(uint32_t);
+
+	if (parameters->Reflected)
+	{
+		for (; data < end; data += sizeof(uint32_t))
+		{
+			WRITE_REG(crc->DR, __RBIT(__UNALIGNED_UINT32_READ(data)));
+		}
+	}
+	else if (!parameters->Words)
+	{
+		for (; data < end; data += sizeof(uint32_t))
+		{
+			WRITE_REG(crc->DR, __REV(__UNALIGNED_UINT32_READ(data)));
+		}
+	}
+	else
+	{
+		for (; data < end; data += sizeof(uint32_t))
+		{
+			WRITE_REG(crc->DR, __UNALIGNED_UINT32_READ(data));
+		}
+	}
+}
+//------------------------------------------------------------------------------
+static inline uint32_t privateGetRegister(const CrcParametersT* parameters, uint32_t state)
+{
+	return parameters->Reflected ? __RBIT(state) : state;
+}
+//------------------------------------------------------------------------------
+static void privateDmaEvent(DMA_HandleTypeDef* dma)
+{
+	CrcHardwareAdapterT* adapter = dma->Parent;
+	BaseType_t woken = pdFALSE;
+
+	xSemaphoreGiveFromISR(adapter->DmaSemaphore, &woken);
+	portYIELD_FROM_ISR(woken);
+}
+//------------------------------------------------------------------------------
+/// @brief CRC-32, CRC-32/MPEG-2 and CRC-32/STM32, the others are left to the software
+bool CrcHardwareAdapterIsSupported(const CrcParametersT* parameters)
+{
+	return parameters->Width == 32
+			&& parameters->Polynomial == CRC_HARDWARE_POLYNOMIAL
+			&& parameters->Init == CRC_HARDWARE_INIT;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the DMA copies the memory as it is: only the variant of words matches the unit,
+ * the words have to be aligned and the CCM RAM is out of reach of the DMA
+ */
+bool CrcHardwareAdapterIsDmaSupported(CrcHardwareAdapterT* adapter, const CrcParametersT* parameters, const void* data)
+{
+	uint32_t address = (uint32_t)(uintptr_t)data;
+
+	return adapter->Dma
+			&& CrcHardwareAdapterIsSupported(parameters)
+			&& parameters->Words
+			&& !(address & (sizeof(uint32_t) - 1))
+			&& (address < CCMDATARAM_BASE || address > CCMDATARAM_END);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the CPU writes the words to the unit, the tail goes to the software engine
+ * @param state register of the engine, see CrcEngineStart and CrcEngineResume
+ * @return register of the engine after the data
+ */
+uint32_t CrcHardwareAdapterUpdate(CrcHardwareAdapterT* adapter, CrcEngineT* engine, uint32_t state, const void* data, uint32_t size)
+{
+	const CrcParametersT* parameters = engine->Parameters;
+	CRC_TypeDef* crc = adapter->Handle->Instance;
+	uint32_t words = size / sizeof(uint32_t);
+
+	if (words)
+	{
+		privateLoad(crc, privateGetRegister(parameters, state));
+		privateWrite(crc, parameters, data, words);
+
+		state = privateGetRegister(parameters, READ_REG(crc->DR));
+
+		adapter->Statistic.CpuBytes += words * sizeof(uint32_t);
+	}
+
+	return CrcEngineUpdate(engine, state, (const uint8_t*)data + words * sizeof(uint32_t), size & (sizeof(uint32_t) - 1));
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the words go to DR by the memory to memory stream, the task waits for it.
+ * A block that fails is repeated by the CPU from the register before it.
+ * @return register of the engine after the data, see CrcHardwareAdapterUpdate
+ */
+uint32_t CrcHardwareAdapterUpdateDma(CrcHardwareAdapterT* adapter, CrcEngineT* engine, uint32_t state, const void* data, uint32_t size)
+{
+	if (!CrcHardwareAdapterIsDmaSupported(adapter, engine->Parameters, data))
+	{
+		return CrcHardwareAdapterUpdate(adapter, engine, state, data, size);
+	}
+
+	CRC_TypeDef* crc = adapter->Handle->Instance;
+	DMA_HandleTypeDef* dma = adapter->Dma;
+	const uint8_t* words = data;
+	uint32_t count = size / sizeof(uint32_t);
+
+	privateLoad(crc, state);
+
+	while (count)
+	{
+		uint32_t block = count < CRC_HARDWARE_DMA_MAX_WORDS ? count : CRC_HARDWARE_DMA_MAX_WORDS;
+
+		//a late event of the previous block
+		xSemaphoreTake(adapter->DmaSemaphore, 0);
+
+		if (HAL_DMA_Start_IT(dma, (uint32_t)(uintptr_t)words, (uint32_t)(uintptr_t)&crc->DR, block) != HAL_OK
+			|| xSemaphoreTake(adapter->DmaSemaphore, pdMS_TO_TICKS(adapter->DmaTimeout)) != pdTRUE
+			|| dma->ErrorCode != HAL_DMA_ERROR_NONE)
+		{
+			HAL_DMA_Abort(dma);
+
+			adapter->Statistic.DmaErrors++;
+
+			privateLoad(crc, state);
+			privateWrite(crc, engine->Parameters, words, block);
+
+			adapter->Statistic.CpuBytes += block * sizeof(uint32_t);
+		}
+		else
+		{
+			adapter->Statistic.DmaBytes += block * sizeof(uint32_t);
+			adapter->Statistic.DmaTransfers++;
+		}
+
+		state = READ_REG(crc->DR);
+
+		words += block * sizeof(uint32_t);
+		count -= block;
+	}
+
+	return CrcEngineUpdate(engine, state, words, size & (sizeof(uint32_t) - 1));
+}
+//==============================================================================
+//initialization:
+
+xResult CrcHardwareAdapterInit(CrcHardwareAdapterT* adapter, CrcHardwareAdapterInitT* init)
+{
+	if (!adapter || !init || !init->Handle)
+	{
+		return xResultError;
+	}
+
+	adapter->Handle = init->Handle;
+	adapter->Dma = init->Dma;
+	adapter->DmaTimeout = init->DmaTimeout;
+
+	if (init->Dma)
+	{
+		adapter->DmaSemaphore = xSemaphoreCreateBinary();
+
+		init->Dma->Parent = adapter;
+		init->Dma->XferCpltCallback = privateDmaEvent;
+		init->Dma->XferErrorCallback = privateDmaEvent;
+		init->Dma->XferHalfCpltCallback = NULL;
+		init->Dma->XferAbortCallback = NULL;
+	}
+
+	return xResultAccept;
+}
+//==============================================================================
@@ -0,0 +1,68 @@
+//==============================================================================
+//header:
+
+#ifndef _CRC_HARDWARE_ADAPTER_H_
+#define _CRC_HARDWARE_ADAPTER_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+#include "Crc/Crc.h"
+#include "main.h"
+#include "FreeRTOS.h"
+#include "semphr.h"
+//==============================================================================
+//types:
+
+typedef struct
+{
+	uint32_t CpuBytes; //written to the unit by the CPU
+	uint32_t DmaBytes;
+	uint32_t DmaTransfers;
+	uint32_t DmaErrors; //errors and timeouts, the block was repeated by the CPU
+
+} CrcHardwareStatisticT;
+//------------------------------------------------------------------------------
+/**
+ * @brief the CRC unit of the STM32F4: CRC-32/MPEG-2 of 32 bit words, the register is set by a reset only.
+ * The caller owns the unit for the whole call.
+ */
+typedef struct
+{
+	CRC_HandleTypeDef* Handle;
+	DMA_HandleTypeDef* Dma; //memory to memory into DR, 0 - the CPU writes the words
+
+	SemaphoreHandle_t DmaSemaphore; //given on the end of the transfer
+	uint32_t DmaTimeout; //ms
+
+	CrcHardwareStatisticT Statistic;
+
+} CrcHardwareAdapterT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	CRC_HandleTypeDef* Handle;
+	DMA_HandleTypeDef* Dma;
+	uint32_t DmaTimeout;
+
+} CrcHardwareAdapterInitT;
+//==============================================================================
+//functions:
+
+xResult CrcHardwareAdapterInit(CrcHardwareAdapterT* adapter, CrcHardwareAdapterInitT* init);
+
+bool CrcHardwareAdapterIsSupported(const CrcParametersT* parameters);
+bool CrcHardwareAdapterIsDmaSupported(CrcHardwareAdapterT* adapter, const CrcParametersT* parameters, const void* data);
+
+uint32_t CrcHardwareAdapterUpdate(CrcHardwareAdapterT* adapter, CrcEngineT* engine, uint32_t state, const void* data, uint32_t size);
+uint32_t CrcHardwareAdapterUpdateDma(CrcHardwareAdapterT* adapter, CrcEngineT* engine, uint32_t state, const void* data, uint32_t size);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_CRC_HARDWARE_ADAPTER_H_
@@ -0,0 +1,279 @@
+//==============================================================================
+//header:
+
+
+//==============================================================================
+//includes:
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Crc-Component.h"
+#include "Components.h"
+#include "TerminalCommands/TerminalCommands.h"
+#include "task.h"
+//==============================================================================
+//defines:
+
+#define CRC_CHECK_STRING "123456789"
+//==============================================================================
+//variables:
+
+//the unit is shared by the tasks, a small buffer does not wait for it
+static SemaphoreHandle_t privateMutex;
+
+static uint32_t privateTable32[CRC_TABLE_SIZE(CRC_HARDWARE_SLICES)] CRC_TABLES_SECTION;
+static uint32_t privateTableMpeg2[CRC_TABLE_SIZE(CRC_HARDWARE_SLICES)] CRC_TABLES_SECTION; //CRC-32/STM32 too
+static uint32_t privateTable32C[CRC_TABLE_SIZE(CRC_SOFTWARE_SLICES)] CRC_TABLES_SECTION;
+static uint32_t privateTable16Modbus[CRC_TABLE_SIZE(CRC_SOFTWARE_SLICES)] CRC_TABLES_SECTION;
+static uint32_t privateTable16CcittFalse[CRC_TABLE_SIZE(CRC_SOFTWARE_SLICES)] CRC_TABLES_SECTION;
+
+static uint32_t privateBenchBuffer[CRC_BENCH_BUFFER_SIZE / sizeof(uint32_t)];
+
+static char privateReportBuffer[CRC_REPORT_BUFFER_SIZE];
+
+CrcEngineT CrcEngines[CrcVariantsCount];
+CrcHardwareAdapterT CrcHardware;
+CrcComponentStatisticT CrcComponentStatistic;
+//==============================================================================
+//functions:
+
+static void privateReport(xPortT* port, const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	vsnprintf(privateReportBuffer, sizeof(privateReportBuffer), format, args);
+	va_end(args);
+
+	xPortStartTransmission(port);
+	xPortTransmitString(port, privateReportBuffer);
+	xPortEndTransmission(port);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the unit takes the variants it supports when it is free or when the buffer is worth
+ * the wait, the rest goes to the tables. Not for the interrupts: the unit is taken by a mutex.
+ */
+static uint32_t privateUpdate(CrcVariantT variant, uint32_t state, const void* data, uint32_t size)
+{
+	CrcEngineT* engine = &CrcEngines[variant];
+
+	if (size < CRC_HARDWARE_THRESHOLD
+		|| !CrcHardwareAdapterIsSupported(engine->Parameters)
+		|| xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+	{
+		CrcComponentStatistic.SoftwareBytes += size;
+
+		return CrcEngineUpdate(engine, state, data, size);
+	}
+
+	if (xSemaphoreTake(privateMutex, size >= CRC_DMA_THRESHOLD ? portMAX_DELAY : 0) != pdTRUE)
+	{
+		CrcComponentStatistic.Contentions++;
+		CrcComponentStatistic.SoftwareBytes += size;
+
+		return CrcEngineUpdate(engine, state, data, size);
+	}
+
+	CrcComponentStatistic.HardwareRequests++;
+
+	if (size >= CRC_DMA_THRESHOLD)
+	{
+		state = CrcHardwareAdapterUpdateDma(&CrcHardware, engine, state, data, size);
+	}
+	else
+	{
+		state = CrcHardwareAdapterUpdate(&CrcHardware, engine, state, data, size);
+	}
+
+	xSemaphoreGive(privateMutex);
+
+	return state;
+}
+//------------------------------------------------------------------------------
+uint32_t CrcComponentCalculate(CrcVariantT variant, const void* data, uint32_t size)
+{
+	CrcEngineT* engine = &CrcEngines[variant];
+
+	return CrcEngineFinish(engine, privateUpdate(variant, CrcEngineStart(engine), data, size));
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief goes on from a finished CRC as if the data followed the data of it,
+ * CRC-32/STM32 is given the data by multiples of 4 bytes except the last call
+ */
+uint32_t CrcComponentUpdate(CrcVariantT variant, uint32_t crc, const void* data, uint32_t size)
+{
+	CrcEngineT* engine = &CrcEngines[variant];
+
+	return CrcEngineFinish(engine, privateUpdate(variant, CrcEngineResume(engine, crc), data, size));
+}
+//------------------------------------------------------------------------------
+/// @brief KB/s of the count runs of one backend, 0 - not supported. The result of the last run goes to crc.
+static uint32_t privateBenchRun(CrcVariantT variant, uint8_t backend, uint32_t size, uint32_t count, uint32_t* crc)
+{
+	CrcEngineT* engine = &CrcEngines[variant];
+
+	if (backend && !CrcHardwareAdapterIsSupported(engine->Parameters))
+	{
+		return 0;
+	}
+
+	if (backend == 2 && !CrcHardwareAdapterIsDmaSupported(&CrcHardware, engine->Parameters, privateBenchBuffer))
+	{
+		return 0;
+	}
+
+	if (backend)
+	{
+		xSemaphoreTake(privateMutex, portMAX_DELAY);
+	}
+
+	uint32_t start = DWT->CYCCNT;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint32_t state = CrcEngineStart(engine);
+
+		switch (backend)
+		{
+			case 0: state = CrcEngineUpdate(engine, state, privateBenchBuffer, size); break;
+			case 1: state = CrcHardwareAdapterUpdate(&CrcHardware, engine, state, privateBenchBuffer, size); break;
+			default: state = CrcHardwareAdapterUpdateDma(&CrcHardware, engine, state, privateBenchBuffer, size); break;
+		}
+
+		*crc = CrcEngineFinish(engine, state);
+	}
+
+	uint32_t cycles = DWT->CYCCNT - start;
+
+	if (backend)
+	{
+		xSemaphoreGive(privateMutex);
+	}
+
+	return cycles ? (uint64_t)size * count * (SystemCoreClock / 1000) / cycles : 0;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief checks each variant on CRC_CHECK_STRING and the backends against the bitwise CRC,
+ * then measures the software, the CPU writes to the unit and the DMA
+ */
+static void privateBench(xPortT* port, uint32_t size, uint32_t count)
+{
+	uint32_t seed = DWT->CYCCNT;
+	uint8_t* bytes = (uint8_t*)privateBenchBuffer;
+
+	for (uint32_t i = 0; i < size; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		bytes[i] = seed >> 16;
+	}
+
+	for (uint8_t variant = 0; variant < CrcVariantsCount; variant++)
+	{
+		CrcEngineT* engine = &CrcEngines[variant];
+		CrcEngineT bitwise;
+
+		CrcEngineInit(&bitwise, engine->Parameters, NULL, 0);
+
+		uint32_t expected = CrcEngineCalculate(&bitwise, privateBenchBuffer, size);
+		uint32_t check = CrcComponentCalculate(variant, CRC_CHECK_STRING, sizeof_str(CRC_CHECK_STRING));
+		uint32_t results[3] = { expected, expected, expected };
+		uint32_t speeds[3];
+
+		for (uint8_t backend = 0; backend < 3; backend++)
+		{
+			speeds[backend] = privateBenchRun(variant, backend, size, count, &results[backend]);
+		}
+
+		privateReport(port, "[crc-bench] %s: check %s, software %lu KB/s (%u slices), cpu %lu KB/s, dma %lu KB/s%s\r",
+						engine->Parameters->Name,
+						check == engine->Parameters->Check ? "ok" : "FAIL",
+						speeds[0],
+						engine->Slices,
+						speeds[1],
+						speeds[2],
+						results[0] != expected || results[1] != expected || results[2] != expected ? ", MISMATCH" : "");
+	}
+
+	privateReport(port, "[crc-bench] %lu bytes x %lu, cpu %lu bytes, dma %lu bytes in %lu transfers, dma errors %lu, contentions %lu\r",
+					size,
+					count,
+					CrcHardware.Statistic.CpuBytes,
+					CrcHardware.Statistic.DmaBytes,
+					CrcHardware.Statistic.DmaTransfers,
+					CrcHardware.Statistic.DmaErrors,
+					CrcComponentStatistic.Contentions);
+}
+//------------------------------------------------------------------------------
+/// @brief "crc-bench [-s size] [-n count]"
+static xResult privateBenchCommand(xPortT* port, TerminalCommandArgumentsT* arguments)
+{
+	if (TerminalCommandCheckOptions(arguments, "sn", NULL) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	uint32_t size = TerminalCommandGetNumber(arguments, 's', CRC_BENCH_DEFAULT_SIZE);
+	uint32_t count = TerminalCommandGetNumber(arguments, 'n', CRC_BENCH_DEFAULT_COUNT);
+
+	if (!size || size > CRC_BENCH_BUFFER_SIZE || !count)
+	{
+		return xResultError;
+	}
+
+	privateBench(port, size, count);
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static const TerminalCommandT privateCommands[] =
+{
+	{
+		.Name = "crc-bench",
+		.Usage = "[-s size] [-n count]",
+		.Handler = privateBenchCommand
+	}
+};
+//==============================================================================
+//initialization:
+
+xResult CrcComponentInit(void* parent)
+{
+	static uint32_t* const tables[CrcVariantsCount] =
+	{
+		[CrcVariant32] = privateTable32,
+		[CrcVariant32Mpeg2] = privateTableMpeg2,
+		[CrcVariant32Stm32] = privateTableMpeg2,
+		[CrcVariant32C] = privateTable32C,
+		[CrcVariant16Modbus] = privateTable16Modbus,
+		[CrcVariant16CcittFalse] = privateTable16CcittFalse
+	};
+
+	for (uint8_t variant = 0; variant < CrcVariantsCount; variant++)
+	{
+		const CrcParametersT* parameters = &CrcParameters[variant];
+
+		CrcEngineInit(&CrcEngines[variant],
+						parameters,
+						tables[variant],
+						CrcHardwareAdapterIsSupported(parameters) ? CRC_HARDWARE_SLICES : CRC_SOFTWARE_SLICES);
+	}
+
+	privateMutex = xSemaphoreCreateMutex();
+
+	TerminalCommandsAdd(privateCommands, sizeof(privateCommands) / sizeof(privateCommands[0]));
+
+	CrcHardwareAdapterInitT init =
+	{
+		.Handle = &CRC_HARDWARE_HANDLE,
+		.Dma = &CRC_HARDWARE_DMA,
+		.DmaTimeout = CRC_DMA_TIMEOUT
+	};
+
+	return CrcHardwareAdapterInit(&CrcHardware, &init);
+}
+//==============================================================================
@@ -0,0 +1,50 @@
+//==============================================================================
+//header:
+
+#ifndef _CRC_COMPONENT_H_
+#define _CRC_COMPONENT_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Crc-ComponentConfig.h"
+#include "Crc.h"
+#include "Crc/Adapters/STM32F4xx/CrcHardware-Adapter.h"
+#include "Abstractions/xPort/xPort.h"
+//==============================================================================
+//types:
+
+typedef struct
+{
+	uint32_t SoftwareBytes;
+	uint32_t HardwareRequests;
+	uint32_t Contentions; //the unit was busy, the buffer went to the software
+
+} CrcComponentStatisticT;
+//==============================================================================
+//functions:
+
+xResult CrcComponentInit(void* parent);
+
+uint32_t CrcComponentCalculate(CrcVariantT variant, const void* data, uint32_t size);
+uint32_t CrcComponentUpdate(CrcVariantT variant, uint32_t crc, const void* data, uint32_t size);
+//==============================================================================
+//override:
+
+#define CrcComponentHandler()
+#define CrcComponentTimeSynchronization()
+//==============================================================================
+//export:
+
+extern CrcEngineT CrcEngines[CrcVariantsCount];
+extern CrcHardwareAdapterT CrcHardware;
+extern CrcComponentStatisticT CrcComponentStatistic;
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_CRC_COMPONENT_H_
@@ -0,0 +1,42 @@
+//==============================================================================
+//header:
+
+#ifndef _CRC_COMPONENT_CONFIG_H_
+#define _CRC_COMPONENT_CONFIG_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+#include "main.h"
+//==============================================================================
+//defines:
+
+extern CRC_HandleTypeDef hcrc;
+extern DMA_HandleTypeDef hdma_memtomem_dma2_stream0;
+
+#define CRC_HARDWARE_HANDLE hcrc
+#define CRC_HARDWARE_DMA hdma_memtomem_dma2_stream0
+#define CRC_DMA_TIMEOUT 100 //ms of one block of 256 KB
+
+#define CRC_SOFTWARE_SLICES 4 //1, 4 or 8: 1 KB of table per slice and variant
+#define CRC_HARDWARE_SLICES 1 //tables of the variants of the unit: tails, small buffers and a busy unit
+#define CRC_TABLES_SECTION //the CCM RAM is taken by the TLS pool of the MQTT client
+
+#define CRC_HARDWARE_THRESHOLD 64 //bytes, smaller buffers stay in the software
+#define CRC_DMA_THRESHOLD 1024 //bytes, larger ones wait for a busy unit and go by DMA when they can
+
+#define CRC_BENCH_BUFFER_SIZE 4096 //"crc-bench": the largest size, aligned and in SRAM
+#define CRC_BENCH_DEFAULT_SIZE 4096
+#define CRC_BENCH_DEFAULT_COUNT 64
+
+#define CRC_REPORT_BUFFER_SIZE 128
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_CRC_COMPONENT_CONFIG_H_
@@ -0,0 +1,357 @@
+//==============================================================================
+//includes:
+
+#include "Crc.h"
+//==============================================================================
+//defines:
+
+//the compiler turns both into one load, with a byte reverse for the big endian one
+#define CRC_LOAD_LE(data) ((uint32_t)(data)[0] | ((uint32_t)(data)[1] << 8) | ((uint32_t)(data)[2] << 16) | ((uint32_t)(data)[3] << 24))
+#define CRC_LOAD_BE(data) ((uint32_t)(data)[3] | ((uint32_t)(data)[2] << 8) | ((uint32_t)(data)[1] << 16) | ((uint32_t)(data)[0] << 24))
+//==============================================================================
+//variables:
+
+const CrcParametersT CrcParameters[CrcVariantsCount] =
+{
+	[CrcVariant32] =
+	{
+		.Name = "crc-32",
+		.Width = 32,
+		.Reflected = true,
+		.Polynomial = 0x04c11db7,
+		.Init = 0xffffffff,
+		.XorOut = 0xffffffff,
+		.Check = 0xcbf43926
+	},
+
+	[CrcVariant32Mpeg2] =
+	{
+		.Name = "crc-32/mpeg-2",
+		.Width = 32,
+		.Polynomial = 0x04c11db7,
+		.Init = 0xffffffff,
+		.Check = 0x0376e6e7
+	},
+
+	[CrcVariant32Stm32] =
+	{
+		.Name = "crc-32/stm32",
+		.Width = 32,
+		.Words = true,
+		.Polynomial = 0x04c11db7,
+		.Init = 0xffffffff,
+		.Check = 0xbf99399c
+	},
+
+	[CrcVariant32C] =
+	{
+		.Name = "crc-32c",
+		.Width = 32,
+		.Reflected = true,
+		.Polynomial = 0x1edc6f41,
+		.Init = 0xffffffff,
+		.XorOut = 0xffffffff,
+		.Check = 0xe3069283
+	},
+
+	[CrcVariant16Modbus] =
+	{
+		.Name = "crc-16/modbus",
+		.Width = 16,
+		.Reflected = true,
+		.Polynomial = 0x8005,
+		.Init = 0xffff,
+		.Check = 0x4b37
+	},
+
+	[CrcVariant16CcittFalse] =
+	{
+		.Name = "crc-16/ccitt-false",
+		.Width = 16,
+		.Polynomial = 0x1021,
+		.Init = 0xffff,
+		.Check = 0x29b1
+	}
+};
+//==============================================================================
+//functions:
+
+static uint32_t privateReflect(uint32_t value, uint8_t width)
+{
+	uint32_t result = 0;
+
+	for (uint8_t i = 0; i < width; i++)
+	{
+		result = (result << 1) | (value & 1);
+		value >>= 1;
+	}
+
+	return result;
+}
+//------------------------------------------------------------------------------
+/// @brief the register after 8 bits: the reflected one shifts right, the normal one shifts left
+static uint32_t privateByteStep(const CrcParametersT* parameters, uint32_t state)
+{
+	if (parameters->Reflected)
+	{
+		uint32_t polynomial = privateReflect(parameters->Polynomial, parameters->Width);
+
+		for (uint8_t i = 0; i < 8; i++)
+		{
+			state = (state & 1) ? (state >> 1) ^ polynomial : state >> 1;
+		}
+	}
+	else
+	{
+		uint32_t polynomial = parameters->Polynomial << (32 - parameters->Width);
+
+		for (uint8_t i = 0; i < 8; i++)
+		{
+			state = (state & 0x80000000) ? (state << 1) ^ polynomial : state << 1;
+		}
+	}
+
+	return state;
+}
+//------------------------------------------------------------------------------
+static uint32_t privateUpdateByte(CrcEngineT* engine, uint32_t state, uint8_t data)
+{
+	const CrcParametersT* parameters = engine->Parameters;
+	const uint32_t* table = engine->Table;
+
+	if (parameters->Reflected)
+	{
+		state ^= data;
+
+		return table ? (state >> 8) ^ table[state & 0xff] : privateByteStep(parameters, state);
+	}
+
+	state ^= (uint32_t)data << 24;
+
+	return table ? (state << 8) ^ table[state >> 24] : privateByteStep(parameters, state);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the bytes of one word of the Words variants, last byte of the memory first.
+ * A tail shorter than a word goes in order.
+ */
+static uint32_t privateUpdateWords(CrcEngineT* engine, uint32_t state, const uint8_t* data, uint32_t size)
+{
+	while (size >= sizeof(uint32_t))
+	{
+		for (uint8_t i = sizeof(uint32_t); i > 0; i--)
+		{
+			state = privateUpdateByte(engine, state, data[i - 1]);
+		}
+
+		data += sizeof(uint32_t);
+		size -= sizeof(uint32_t);
+	}
+
+	while (size--)
+	{
+		state = privateUpdateByte(engine, state, *data++);
+	}
+
+	return state;
+}
+//------------------------------------------------------------------------------
+/// @brief slicing: each byte of the block has its own table of the bytes after it
+static uint32_t privateUpdateReflected(CrcEngineT* engine, uint32_t state, const uint8_t* data, uint32_t size)
+{
+	const uint32_t* table = engine->Table;
+
+	if (engine->Slices == 8)
+	{
+		while (size >= 8)
+		{
+			uint32_t first = CRC_LOAD_LE(data) ^ state;
+			uint32_t second = CRC_LOAD_LE(data + 4);
+
+			state = table[7 * 256 + (first & 0xff)]
+					^ table[6 * 256 + ((first >> 8) & 0xff)]
+					^ table[5 * 256 + ((first >> 16) & 0xff)]
+					^ table[4 * 256 + (first >> 24)]
+					^ table[3 * 256 + (second & 0xff)]
+					^ table[2 * 256 + ((second >> 8) & 0xff)]
+					^ table[1 * 256 + ((second >> 16) & 0xff)]
+					^ table[second >> 24];
+
+			data += 8;
+			size -= 8;
+		}
+	}
+
+	if (engine->Slices >= 4)
+	{
+		while (size >= 4)
+		{
+			uint32_t word = CRC_LOAD_LE(data) ^ state;
+
+			state = table[3 * 256 + (word & 0xff)]
+					^ table[2 * 256 + ((word >> 8) & 0xff)]
+					^ table[1 * 256 + ((word >> 16) & 0xff)]
+					^ table[word >> 24];
+
+			data += 4;
+			size -= 4;
+		}
+	}
+
+	while (size--)
+	{
+		state = privateUpdateByte(engine, state, *data++);
+	}
+
+	return state;
+}
+//------------------------------------------------------------------------------
+/// @brief as the reflected one with the words in big endian order, the Words variants take them as they are
+static uint32_t privateUpdateNormal(CrcEngineT* engine, uint32_t state, const uint8_t* data, uint32_t size)
+{
+	const uint32_t* table = engine->Table;
+	bool words = engine->Parameters->Words;
+
+	if (engine->Slices == 8)
+	{
+		while (size >= 8)
+		{
+			uint32_t first = (words ? CRC_LOAD_LE(data) : CRC_LOAD_BE(data)) ^ state;
+			uint32_t second = words ? CRC_LOAD_LE(data + 4) : CRC_LOAD_BE(data + 4);
+
+			state = table[7 * 256 + (first >> 24)]
+					^ table[6 * 256 + ((first >> 16) & 0xff)]
+					^ table[5 * 256 + ((first >> 8) & 0xff)]
+					^ table[4 * 256 + (first & 0xff)]
+					^ table[3 * 256 + (second >> 24)]
+					^ table[2 * 256 + ((second >> 16) & 0xff)]
+					^ table[1 * 256 + ((second >> 8) & 0xff)]
+					^ table[second & 0xff];
+
+			data += 8;
+			size -= 8;
+		}
+	}
+
+	if (engine->Slices >= 4)
+	{
+		while (size >= 4)
+		{
+			uint32_t word = (words ? CRC_LOAD_LE(data) : CRC_LOAD_BE(data)) ^ state;
+
+			state = table[3 * 256 + (word >> 24)]
+					^ table[2 * 256 + ((word >> 16) & 0xff)]
+					^ table[1 * 256 + ((word >> 8) & 0xff)]
+					^ table[word & 0xff];
+
+			data += 4;
+			size -= 4;
+		}
+	}
+
+	if (words)
+	{
+		return privateUpdateWords(engine, state, data, size);
+	}
+
+	while (size--)
+	{
+		state = privateUpdateByte(engine, state, *data++);
+	}
+
+	return state;
+}
+//------------------------------------------------------------------------------
+/// @brief the register before the first byte
+uint32_t CrcEngineStart(CrcEngineT* engine)
+{
+	const CrcParametersT* parameters = engine->Parameters;
+
+	return parameters->Reflected ? parameters->Init : parameters->Init << (32 - parameters->Width);
+}
+//------------------------------------------------------------------------------
+/// @brief the register after the data of a finished CRC: the calculation goes on from there
+uint32_t CrcEngineResume(CrcEngineT* engine, uint32_t crc)
+{
+	const CrcParametersT* parameters = engine->Parameters;
+
+	crc ^= parameters->XorOut;
+
+	return parameters->Reflected ? crc : crc << (32 - parameters->Width);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief takes the data into the register. The Words variants count the words from the
+ * beginning of each call: the data is given by multiples of 4 bytes, except the last call.
+ */
+uint32_t CrcEngineUpdate(CrcEngineT* engine, uint32_t state, const void* data, uint32_t size)
+{
+	if (engine->Parameters->Reflected)
+	{
+		return privateUpdateReflected(engine, state, data, size);
+	}
+
+	return privateUpdateNormal(engine, state, data, size);
+}
+//------------------------------------------------------------------------------
+uint32_t CrcEngineFinish(CrcEngineT* engine, uint32_t state)
+{
+	const CrcParametersT* parameters = engine->Parameters;
+
+	if (!parameters->Reflected)
+	{
+		state >>= 32 - parameters->Width;
+	}
+
+	return state ^ parameters->XorOut;
+}
+//------------------------------------------------------------------------------
+uint32_t CrcEngineCalculate(CrcEngineT* engine, const void* data, uint32_t size)
+{
+	return CrcEngineFinish(engine, CrcEngineUpdate(engine, CrcEngineStart(engine), data, size));
+}
+//==============================================================================
+//initialization:
+
+/**
+ * @brief fills the table of the engine, the engines of the same polynomial and reflection may share it
+ * @param table CRC_TABLE_SIZE(slices) entries, 0 - bitwise, slices are ignored
+ */
+xResult CrcEngineInit(CrcEngineT* engine, const CrcParametersT* parameters, uint32_t* table, uint8_t slices)
+{
+	if (!engine || !parameters || (parameters->Width != 16 && parameters->Width != 32)
+		|| (parameters->Words && parameters->Reflected)
+		|| (table && slices != 1 && slices != 4 && slices != 8))
+	{
+		return xResultError;
+	}
+
+	engine->Parameters = parameters;
+	engine->Table = table;
+	engine->Slices = table ? slices : 0;
+
+	if (!table)
+	{
+		return xResultAccept;
+	}
+
+	for (uint16_t i = 0; i < 256; i++)
+	{
+		table[i] = privateByteStep(parameters, parameters->Reflected ? i : (uint32_t)i << 24);
+	}
+
+	//the byte followed by (slice) zero bytes
+	for (uint16_t i = 0; i < 256; i++)
+	{
+		uint32_t state = table[i];
+
+		for (uint8_t slice = 1; slice < slices; slice++)
+		{
+			state = parameters->Reflected ? (state >> 8) ^ table[state & 0xff] : (state << 8) ^ table[state >> 24];
+			table[slice * 256 + i] = state;
+		}
+	}
+
+	return xResultAccept;
+}
+//==============================================================================
@@ -0,0 +1,83 @@
+//==============================================================================
+//header:
+
+#ifndef _CRC_H_
+#define _CRC_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+//==============================================================================
+//defines:
+
+#define CRC_TABLE_SIZE(slices) ((slices) * 256) //entries of the table of an engine
+//==============================================================================
+//types:
+
+typedef enum
+{
+	CrcVariant32, //CRC-32 of zlib, Ethernet, PNG
+	CrcVariant32Mpeg2, //polynomial of the STM32 unit, bytes in order
+	CrcVariant32Stm32, //CRC-32/MPEG-2 over little endian words as the STM32 unit reads the memory, the tail bytes in order
+	CrcVariant32C, //Castagnoli, iSCSI, ext4
+	CrcVariant16Modbus,
+	CrcVariant16CcittFalse,
+
+	CrcVariantsCount
+
+} CrcVariantT;
+//------------------------------------------------------------------------------
+/// @brief Rocksoft model of the variant
+typedef struct
+{
+	const char* Name;
+
+	uint8_t Width; //16 or 32
+	bool Reflected; //input and output
+	bool Words; //the data is taken by 32 bit words: the bytes of each word in reverse order
+
+	uint32_t Polynomial; //normal form
+	uint32_t Init;
+	uint32_t XorOut;
+
+	uint32_t Check; //of "123456789"
+
+} CrcParametersT;
+//------------------------------------------------------------------------------
+/**
+ * @brief software CRC of one variant. The state is the register: reflected - in the low bits,
+ * normal - in the high bits, so the tables of both are 32 bit and a word is taken at once.
+ */
+typedef struct
+{
+	const CrcParametersT* Parameters;
+
+	const uint32_t* Table; //CRC_TABLE_SIZE(Slices) entries, 0 - bitwise
+	uint8_t Slices; //bytes taken at once by the tables: 1, 4 or 8
+
+} CrcEngineT;
+//==============================================================================
+//functions:
+
+xResult CrcEngineInit(CrcEngineT* engine, const CrcParametersT* parameters, uint32_t* table, uint8_t slices);
+
+uint32_t CrcEngineStart(CrcEngineT* engine);
+uint32_t CrcEngineResume(CrcEngineT* engine, uint32_t crc);
+uint32_t CrcEngineUpdate(CrcEngineT* engine, uint32_t state, const void* data, uint32_t size);
+uint32_t CrcEngineFinish(CrcEngineT* engine, uint32_t state);
+
+uint32_t CrcEngineCalculate(CrcEngineT* engine, const void* data, uint32_t size);
+//==============================================================================
+//export:
+
+extern const CrcParametersT CrcParameters[CrcVariantsCount];
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_CRC_H_
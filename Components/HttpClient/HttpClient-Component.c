@@ -0,0 +1,408 @@
+//==============================================================================
+//header:
+
+
+//==============================================================================
+//includes:
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "HttpClient-Component.h"
+#include "Components.h"
+#include "TerminalCommands/TerminalCommands.h"
+#include "Net/Net-Component.h"
+//==============================================================================
+//defines:
+
+#define HTTP_REPORT_CONTENT_TYPE "application/json"
+#define HTTP_REPORT_BODY_SIZE 96
+
+#define HTTP_IDLE_DELAY 100 //ms, nothing is waiting for a response
+#define HTTP_BENCH_TIMEOUT 1000 //ms for each report of the burst
+//==============================================================================
+//types:
+
+typedef struct
+{
+	xNetSocketT Socket;
+
+	xNetAddressT Address; //0 - not resolved
+	uint16_t Port;
+
+} HttpClientConnectionT;
+//==============================================================================
+//variables:
+
+static TaskHandle_t taskHandle;
+static StaticTask_t taskBuffer;
+static StackType_t taskStack[HTTP_CLIENT_TASK_STACK_SIZE] HTTP_CLIENT_COMPONENT_MAIN_TASK_STACK_SECTION;
+
+static int RTOS_HttpClientTaskStackWaterMark;
+
+//the request slots and the receive buffer, shared by the burst of "http-report" while the reports wait
+static uint8_t privateMemory[HTTP_PIPELINE_DEPTH * HTTP_REQUEST_SIZE + HTTP_RX_BUFFER_SIZE];
+
+static HttpClientConnectionT privateConnection = { .Port = HTTP_SERVER_PORT };
+static uint32_t privateResolveTimeStamp;
+static uint32_t privateReportTimeStamp;
+
+static HttpClientT privateBenchClient;
+static HttpClientConnectionT privateBenchConnection;
+static HttpClientBenchRequestT privateBenchRequest;
+static volatile uint8_t privateBenchIsPending;
+
+static char privateReportBuffer[HTTP_REPORT_BUFFER_SIZE];
+
+HttpClientT HttpClient;
+//==============================================================================
+//functions:
+
+static void privateReport(const char* format, ...)
+{
+	xPortT* port = privateBenchRequest.ReportPort;
+
+	if (!port)
+	{
+		return;
+	}
+
+	va_list args;
+	va_start(args, format);
+	vsnprintf(privateReportBuffer, sizeof(privateReportBuffer), format, args);
+	va_end(args);
+
+	xPortStartTransmission(port);
+	xPortTransmitString(port, privateReportBuffer);
+	xPortEndTransmission(port);
+}
+//------------------------------------------------------------------------------
+static xResult privateConnect(void* context)
+{
+	HttpClientConnectionT* connection = context;
+
+	if (!connection->Address.Value || xNetInitTcpSocket(&Net, &connection->Socket) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	if (xNetConnect(&connection->Socket, connection->Address, connection->Port) != xResultAccept)
+	{
+		xNetClose(&connection->Socket);
+
+		return xResultError;
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static int32_t privateTransmit(void* context, const void* data, uint32_t size)
+{
+	HttpClientConnectionT* connection = context;
+
+	return xNetTransmit(&connection->Socket, (void*)data, size);
+}
+//------------------------------------------------------------------------------
+static int32_t privateReceive(void* context, void* data, uint32_t size)
+{
+	HttpClientConnectionT* connection = context;
+
+	return xNetReceive(&connection->Socket, data, size);
+}
+//------------------------------------------------------------------------------
+static void privateClose(void* context)
+{
+	HttpClientConnectionT* connection = context;
+
+	xNetClose(&connection->Socket);
+}
+//------------------------------------------------------------------------------
+static uint16_t privateReportBody(char* body, uint16_t size, uint32_t sequence)
+{
+	int length = snprintf(body, size,
+							"{\"uptime\":%lu,\"heap\":%d,\"sequence\":%lu}",
+							(unsigned long)xSystemGetTime(),
+							RTOS_FreeHeapSize,
+							(unsigned long)sequence);
+
+	return length > 0 && length < size ? length : 0;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the host is resolved once and kept for the next connections,
+ * again only after a failed connection.
+ */
+static void privateResolve()
+{
+	uint32_t time = xSystemGetTime();
+
+	if (!privateConnection.Address.Value
+		&& time - privateResolveTimeStamp >= HTTP_CONNECT_RETRY_PERIOD)
+	{
+		privateResolveTimeStamp = time;
+
+		xNetGetHostByName(&Net, HTTP_HOST, &privateConnection.Address);
+	}
+}
+//------------------------------------------------------------------------------
+static void privateBenchRun()
+{
+	HttpClientBenchRequestT* request = &privateBenchRequest;
+
+	if (HttpClient.Count)
+	{
+		privateReport("[http-report] busy, %u reports wait for the host\r", HttpClient.Count);
+		return;
+	}
+
+	//the connection of the reports is taken again after the burst
+	HttpClientClose(&HttpClient);
+
+	privateBenchConnection.Address = request->Address.Value ? request->Address : privateConnection.Address;
+	privateBenchConnection.Port = request->Port ? request->Port : HTTP_SERVER_PORT;
+
+	HttpClientInitT init = { 0 };
+	init.Transport = HttpClient.Transport;
+	init.Transport.Context = &privateBenchConnection;
+	init.Host = HTTP_HOST;
+	init.Headers = HTTP_HOST_AUTHORIZATION "\r\n";
+	init.Memory = privateMemory;
+	init.MemorySize = sizeof(privateMemory);
+	init.SlotSize = HTTP_REQUEST_SIZE;
+	init.PipelineDepth = request->PipelineDepth;
+	init.RxBufferSize = HTTP_RX_BUFFER_SIZE;
+
+	if (HttpClientInit(&privateBenchClient, &init) != xResultAccept)
+	{
+		privateReport("[http-report] init error\r");
+		return;
+	}
+
+	HttpClientT* client = &privateBenchClient;
+	char body[HTTP_REPORT_BODY_SIZE];
+	uint32_t queued = 0;
+
+	uint32_t start = xSystemGetTime();
+	uint32_t timeout = request->Count * HTTP_BENCH_TIMEOUT;
+
+	while (client->Statistic.Responses < request->Count && xSystemGetTime() - start < timeout)
+	{
+		while (queued < request->Count && HttpClientGetFreeSlots(client))
+		{
+			uint16_t length = privateReportBody(body, sizeof(body), queued);
+
+			HttpClientRequest(client, HTTP_REPORT_METHOD, HTTP_REPORT_PATH, HTTP_REPORT_CONTENT_TYPE, body, length);
+			queued++;
+		}
+
+		HttpClientHandler(client);
+	}
+
+	uint32_t duration = xSystemGetTime() - start;
+
+	HttpClientClose(client);
+
+	HttpClientStatisticT* statistic = &client->Statistic;
+	uint32_t responses = statistic->Responses ? statistic->Responses : 1;
+
+	privateReport("[http-report] %lu/%u reports in %lu ms, %lu reports/s, depth %u\r",
+					statistic->Responses,
+					request->Count,
+					duration,
+					duration ? statistic->Responses * 1000 / duration : 0,
+					client->PipelineDepth);
+
+	privateReport("[http-report] per report: tx %lu B, rx %lu B; connects %lu, resent %lu, failures %lu\r",
+					statistic->TxBytes / responses,
+					statistic->RxBytes / responses,
+					statistic->Connects,
+					statistic->Resent,
+					statistic->Failures);
+}
+//------------------------------------------------------------------------------
+static void privateTask(void* arg)
+{
+	uint32_t sequence = 0;
+
+	while (true)
+	{
+		RTOS_HttpClientTaskStackWaterMark = uxTaskGetStackHighWaterMark(NULL);
+
+		if (!Net.DHCP_Complite)
+		{
+			vTaskDelay(pdMS_TO_TICKS(HTTP_IDLE_DELAY));
+			continue;
+		}
+
+		if (privateBenchIsPending)
+		{
+			privateBenchRun();
+			privateBenchIsPending = false;
+		}
+
+		uint32_t time = xSystemGetTime();
+
+		if (time - privateReportTimeStamp >= HTTP_REPORT_PERIOD)
+		{
+			privateReportTimeStamp = time;
+
+			char body[HTTP_REPORT_BODY_SIZE];
+			uint16_t length = privateReportBody(body, sizeof(body), sequence++);
+
+			//the oldest report is kept when the host doesn't answer
+			HttpClientComponentReport(body, length);
+		}
+
+		privateResolve();
+
+		HttpClientHandler(&HttpClient);
+
+		if (HttpClient.Count && !HttpClient.IsConnected)
+		{
+			//resolved again before the next attempt
+			privateConnection.Address.Value = 0;
+		}
+
+		if (!HttpClient.Sent)
+		{
+			//the connection stays open until the next report
+			vTaskDelay(pdMS_TO_TICKS(HTTP_IDLE_DELAY));
+		}
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief queues a report to HTTP_REPORT_PATH, it goes out over the open connection with the pending ones.
+ * @return xResultBusy - HTTP_PIPELINE_DEPTH reports wait for the host
+ */
+xResult HttpClientComponentReport(const char* body, uint16_t length)
+{
+	return HttpClientRequest(&HttpClient, HTTP_REPORT_METHOD, HTTP_REPORT_PATH, HTTP_REPORT_CONTENT_TYPE, body, length);
+}
+//------------------------------------------------------------------------------
+xResult HttpClientComponentBenchStart(HttpClientBenchRequestT* request)
+{
+	if (!request)
+	{
+		return xResultError;
+	}
+
+	if (privateBenchIsPending)
+	{
+		return xResultBusy;
+	}
+
+	privateBenchRequest = *request;
+
+	if (!privateBenchRequest.Count)
+	{
+		privateBenchRequest.Count = HTTP_BENCH_DEFAULT_COUNT;
+	}
+
+	if (!privateBenchRequest.PipelineDepth || privateBenchRequest.PipelineDepth > HTTP_PIPELINE_DEPTH)
+	{
+		privateBenchRequest.PipelineDepth = HTTP_PIPELINE_DEPTH;
+	}
+
+	privateBenchIsPending = true;
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static uint8_t privateParseAddress(const char* text, xNetAddressT* address)
+{
+	uint8_t* octets = (uint8_t*)&address->Value;
+	char* end;
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		unsigned long value = strtoul(text, &end, 10);
+
+		if (end == text || value > 255 || (i < 3 && *end != '.'))
+		{
+			return false;
+		}
+
+		octets[i] = value;
+		text = end + 1;
+	}
+
+	return true;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief "http-report [-n count] [-d depth] [-a a.b.c.d] [-p port]"
+ * without an address the burst goes to HTTP_HOST.
+ */
+static xResult privateCommand(xPortT* port, TerminalCommandArgumentsT* arguments)
+{
+	if (TerminalCommandCheckOptions(arguments, "ndap", NULL) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	HttpClientBenchRequestT request = { 0 };
+	request.ReportPort = port;
+	request.Count = TerminalCommandGetNumber(arguments, 'n', 0);
+	request.PipelineDepth = TerminalCommandGetNumber(arguments, 'd', 0);
+	request.Port = TerminalCommandGetNumber(arguments, 'p', 0);
+
+	char* address = TerminalCommandGetOption(arguments, 'a');
+
+	if (address && !privateParseAddress(address, &request.Address))
+	{
+		return xResultError;
+	}
+
+	return HttpClientComponentBenchStart(&request);
+}
+//------------------------------------------------------------------------------
+static const TerminalCommandT privateCommands[] =
+{
+	{
+		.Name = "http-report",
+		.Usage = "[-n count] [-d depth] [-a a.b.c.d] [-p port]",
+		.Handler = privateCommand
+	}
+};
+//==============================================================================
+//initialization:
+
+xResult HttpClientComponentInit(void* parent)
+{
+	HttpClientInitT init = { 0 };
+	init.Transport.Connect = privateConnect;
+	init.Transport.Transmit = privateTransmit;
+	init.Transport.Receive = privateReceive;
+	init.Transport.Close = privateClose;
+	init.Transport.Context = &privateConnection;
+	init.Host = HTTP_HOST;
+	init.Headers = HTTP_HOST_AUTHORIZATION "\r\n";
+	init.Memory = privateMemory;
+	init.MemorySize = sizeof(privateMemory);
+	init.SlotSize = HTTP_REQUEST_SIZE;
+	init.PipelineDepth = HTTP_PIPELINE_DEPTH;
+	init.RxBufferSize = HTTP_RX_BUFFER_SIZE;
+
+	if (HttpClientInit(&HttpClient, &init) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	privateBenchRequest.ReportPort = &SerialPort;
+
+	TerminalCommandsAdd(privateCommands, sizeof(privateCommands) / sizeof(privateCommands[0]));
+
+	taskHandle = xTaskCreateStatic(privateTask, // Function that implements the task.
+									"http client task", // Text name for the task.
+									HTTP_CLIENT_TASK_STACK_SIZE, // Number of indexes in the xStack array.
+									NULL, // Parameter passed into the task.
+									osPriorityBelowNormal, // Priority at which the task is created.
+									taskStack, // Array to use as the task's stack.
+									&taskBuffer);
+
+	return xResultAccept;
+}
+//==============================================================================
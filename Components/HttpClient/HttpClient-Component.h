@@ -0,0 +1,53 @@
+//==============================================================================
+//header:
+
+#ifndef _HTTP_CLIENT_COMPONENT_H_
+#define _HTTP_CLIENT_COMPONENT_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "HttpClient-ComponentConfig.h"
+#include "HttpClient.h"
+#include "Abstractions/xPort/xPort.h"
+#include "Abstractions/xNet/xNet.h"
+//==============================================================================
+//types:
+
+/// @brief burst of reports to measure the client, to the host or to a local stand-in
+typedef struct
+{
+	uint16_t Count;
+	uint8_t PipelineDepth; //0 - HTTP_PIPELINE_DEPTH
+
+	xNetAddressT Address; //0 - HTTP_HOST
+	uint16_t Port; //0 - HTTP_SERVER_PORT
+
+	xPortT* ReportPort;
+
+} HttpClientBenchRequestT;
+//==============================================================================
+//functions:
+
+xResult HttpClientComponentInit(void* parent);
+
+xResult HttpClientComponentReport(const char* body, uint16_t length);
+xResult HttpClientComponentBenchStart(HttpClientBenchRequestT* request);
+//==============================================================================
+//override:
+
+#define HttpClientComponentHandler()
+#define HttpClientComponentTimeSynchronization()
+//==============================================================================
+//export:
+
+extern HttpClientT HttpClient;
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_HTTP_CLIENT_COMPONENT_H_
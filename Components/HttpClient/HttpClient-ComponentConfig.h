@@ -0,0 +1,44 @@
+//==============================================================================
+//header:
+
+#ifndef _HTTP_CLIENT_COMPONENT_CONFIG_H_
+#define _HTTP_CLIENT_COMPONENT_CONFIG_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+//==============================================================================
+//defines:
+
+#define HTTP_CLIENT_COMPONENT_MAIN_TASK_STACK_SECTION __attribute__((section("._user_heap_stack")))
+
+#define HTTP_CLIENT_TASK_STACK_SIZE 0x200
+
+#define HTTP_HOST "device-api.sintez.by"
+#define HTTP_HOST_AUTHORIZATION "X-Sintez-Auth: 6b9f7b57e10f498e634204e77009e472"
+#define HTTP_REPORT_DEVICE_ID "ce501046-f876-4bf6-8151-117b711340c5"
+#define HTTP_GET_HEADER "GET /v0.4/devices/" HTTP_REPORT_DEVICE_ID " HTTP/1.1\r\n" HTTP_HOST_AUTHORIZATION "\r\n" "Host: " HTTP_HOST "\r\n\r\n"
+
+#define HTTP_SERVER_PORT 80
+#define HTTP_REPORT_METHOD "POST"
+#define HTTP_REPORT_PATH "/v0.4/devices/" HTTP_REPORT_DEVICE_ID "/reports"
+#define HTTP_REPORT_PERIOD 10000 //ms
+
+#define HTTP_PIPELINE_DEPTH 4 //requests sent without waiting for the responses
+#define HTTP_REQUEST_SIZE 320 //headers and body of one request
+#define HTTP_RX_BUFFER_SIZE 256 //one receive, the response bodies are not buffered
+
+#define HTTP_CONNECT_RETRY_PERIOD 5000 //ms, also resolves the host again
+#define HTTP_BENCH_DEFAULT_COUNT 200 //reports of "http-report"
+
+#define HTTP_REPORT_BUFFER_SIZE 128
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_HTTP_CLIENT_COMPONENT_CONFIG_H_
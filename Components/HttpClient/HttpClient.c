@@ -0,0 +1,523 @@
+//==============================================================================
+//includes:
+
+#include "HttpClient.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+//==============================================================================
+//functions:
+
+static char privateToLower(char value)
+{
+	return (value >= 'A' && value <= 'Z') ? value + ('a' - 'A') : value;
+}
+//------------------------------------------------------------------------------
+static bool privateNameEquals(const char* name, uint16_t length, const char* expected)
+{
+	uint16_t i = 0;
+
+	for (; i < length && expected[i]; i++)
+	{
+		if (privateToLower(name[i]) != expected[i])
+		{
+			return false;
+		}
+	}
+
+	return i == length && !expected[i];
+}
+//------------------------------------------------------------------------------
+/// @brief case-insensitive search of a lowercase token in a header value
+static bool privateValueContains(const char* value, const char* token)
+{
+	uint16_t length = strlen(token);
+
+	for (; *value; value++)
+	{
+		uint16_t i = 0;
+
+		while (i < length && value[i] && privateToLower(value[i]) == token[i])
+		{
+			i++;
+		}
+
+		if (i == length)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+//------------------------------------------------------------------------------
+static void privateHeader(HttpParserT* parser)
+{
+	char* separator = memchr(parser->Line, ':', parser->LineLength);
+
+	if (!separator)
+	{
+		return;
+	}
+
+	uint16_t nameLength = separator - parser->Line;
+	char* value = separator + 1;
+
+	while (*value == ' ' || *value == '\t')
+	{
+		value++;
+	}
+
+	if (privateNameEquals(parser->Line, nameLength, "content-length"))
+	{
+		parser->Remaining = strtoul(value, NULL, 10);
+		parser->HasLength = true;
+	}
+	else if (privateNameEquals(parser->Line, nameLength, "transfer-encoding"))
+	{
+		parser->IsChunked = privateValueContains(value, "chunked");
+	}
+	else if (privateNameEquals(parser->Line, nameLength, "connection"))
+	{
+		if (privateValueContains(value, "close"))
+		{
+			parser->KeepAlive = false;
+		}
+		else if (privateValueContains(value, "keep-alive"))
+		{
+			parser->KeepAlive = true;
+		}
+	}
+}
+//------------------------------------------------------------------------------
+static void privateHeadersComplete(HttpParserT* parser)
+{
+	if (parser->StatusCode / 100 == 1)
+	{
+		//100 Continue and the other interim responses are followed by the final one
+		parser->State = HttpParserStatusLine;
+	}
+	else if (parser->StatusCode == 204 || parser->StatusCode == 304)
+	{
+		parser->State = HttpParserComplete;
+	}
+	else if (parser->IsChunked)
+	{
+		parser->State = HttpParserChunkSize;
+	}
+	else if (parser->HasLength)
+	{
+		parser->State = parser->Remaining ? HttpParserBody : HttpParserComplete;
+	}
+	else
+	{
+		parser->State = HttpParserBodyUntilClose;
+		parser->KeepAlive = false;
+	}
+}
+//------------------------------------------------------------------------------
+static void privateLine(HttpParserT* parser)
+{
+	switch ((uint8_t)parser->State)
+	{
+		case HttpParserStatusLine:
+		{
+			if (!parser->LineLength)
+			{
+				//CRLF left between the responses
+				return;
+			}
+
+			//"HTTP/1.x 200 Reason"
+			if (parser->LineLength < 12 || memcmp(parser->Line, "HTTP/1.", 7) != 0 || parser->Line[8] != ' ')
+			{
+				parser->State = HttpParserError;
+				return;
+			}
+
+			parser->StatusCode = strtoul(parser->Line + 9, NULL, 10);
+			parser->KeepAlive = parser->Line[7] == '1';
+			parser->IsChunked = false;
+			parser->HasLength = false;
+			parser->Remaining = 0;
+
+			parser->State = parser->StatusCode >= 100 && parser->StatusCode < 600 ? HttpParserHeaderLine : HttpParserError;
+			break;
+		}
+
+		case HttpParserHeaderLine:
+		{
+			if (parser->LineLength)
+			{
+				privateHeader(parser);
+			}
+			else
+			{
+				privateHeadersComplete(parser);
+			}
+			break;
+		}
+
+		case HttpParserChunkSize:
+		{
+			char* end;
+			parser->Remaining = strtoul(parser->Line, &end, 16);
+
+			if (end == parser->Line)
+			{
+				parser->State = HttpParserError;
+			}
+			else
+			{
+				parser->State = parser->Remaining ? HttpParserChunkData : HttpParserTrailer;
+			}
+			break;
+		}
+
+		case HttpParserChunkDataEnd:
+		{
+			parser->State = parser->LineLength ? HttpParserError : HttpParserChunkSize;
+			break;
+		}
+
+		case HttpParserTrailer:
+		{
+			if (!parser->LineLength)
+			{
+				parser->State = HttpParserComplete;
+			}
+			break;
+		}
+	}
+}
+//------------------------------------------------------------------------------
+void HttpParserReset(HttpParserT* parser)
+{
+	memset(parser, 0, sizeof(HttpParserT));
+
+	parser->State = HttpParserStatusLine;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief parses the received bytes up to the end of the response, the bytes of the next
+ * pipelined response are left to the call after HttpParserReset.
+ * @return consumed bytes, -1 - the response is malformed
+ */
+int32_t HttpParserReceive(HttpParserT* parser, const uint8_t* data, uint32_t size, HttpParserBodyT body, void* context)
+{
+	uint32_t position = 0;
+
+	while (position < size && parser->State != HttpParserComplete && parser->State != HttpParserError)
+	{
+		switch ((uint8_t)parser->State)
+		{
+			case HttpParserBody:
+			case HttpParserChunkData:
+			case HttpParserBodyUntilClose:
+			{
+				uint32_t count = size - position;
+
+				if (parser->State != HttpParserBodyUntilClose && count > parser->Remaining)
+				{
+					count = parser->Remaining;
+				}
+
+				if (body)
+				{
+					body(context, parser->StatusCode, data + position, count);
+				}
+
+				position += count;
+
+				if (parser->State != HttpParserBodyUntilClose)
+				{
+					parser->Remaining -= count;
+
+					if (!parser->Remaining)
+					{
+						parser->State = parser->State == HttpParserBody ? HttpParserComplete : HttpParserChunkDataEnd;
+					}
+				}
+				break;
+			}
+
+			default:
+			{
+				char value = data[position++];
+
+				if (value == '\n')
+				{
+					if (parser->LineLength && parser->Line[parser->LineLength - 1] == '\r')
+					{
+						parser->LineLength--;
+					}
+
+					parser->Line[parser->LineLength] = 0;
+					privateLine(parser);
+					parser->LineLength = 0;
+				}
+				else if (parser->LineLength < sizeof(parser->Line) - 1)
+				{
+					parser->Line[parser->LineLength++] = value;
+				}
+				break;
+			}
+		}
+	}
+
+	return parser->State == HttpParserError ? -1 : (int32_t)position;
+}
+//------------------------------------------------------------------------------
+/// @brief the connection is closed: completes the body without a length
+void HttpParserClose(HttpParserT* parser)
+{
+	if (parser->State == HttpParserBodyUntilClose)
+	{
+		parser->State = HttpParserComplete;
+	}
+	else if (parser->State != HttpParserComplete)
+	{
+		parser->State = HttpParserError;
+	}
+}
+//------------------------------------------------------------------------------
+static void privateClose(HttpClientT* client)
+{
+	if (client->IsConnected)
+	{
+		client->Transport.Close(client->Transport.Context);
+	}
+
+	//sent again on the next connection
+	client->Statistic.Resent += client->Sent;
+
+	client->IsConnected = false;
+	client->IsPersistent = false;
+	client->Sent = 0;
+
+	HttpParserReset(&client->Parser);
+}
+//------------------------------------------------------------------------------
+static void privateResponseComplete(HttpClientT* client)
+{
+	uint16_t status = client->Parser.StatusCode;
+
+	client->Statistic.Responses++;
+
+	if (status / 100 != 2)
+	{
+		client->Statistic.Failures++;
+	}
+
+	client->Head = (client->Head + 1) % client->PipelineDepth;
+	client->Count--;
+	client->Sent--;
+
+	if (client->Response)
+	{
+		client->Response(client->Context, status);
+	}
+}
+//------------------------------------------------------------------------------
+static xResult privateTransmit(HttpClientT* client)
+{
+	//one request until the server keeps the connection, the pipelined ones would be sent again
+	uint8_t limit = client->IsPersistent ? client->Count : 1;
+
+	while (client->Sent < client->Count && client->Sent < limit)
+	{
+		uint8_t slot = (client->Head + client->Sent) % client->PipelineDepth;
+		uint16_t length = client->Lengths[slot];
+
+		if (client->Transport.Transmit(client->Transport.Context, client->Slots + slot * client->SlotSize, length) != length)
+		{
+			return xResultError;
+		}
+
+		client->Statistic.TxBytes += length;
+		client->Sent++;
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static xResult privateReceive(HttpClientT* client)
+{
+	int32_t received = client->Transport.Receive(client->Transport.Context, client->RxBuffer, client->RxBufferSize);
+
+	if (received < 0)
+	{
+		HttpParserClose(&client->Parser);
+
+		if (client->Parser.State == HttpParserComplete && client->Sent)
+		{
+			privateResponseComplete(client);
+		}
+
+		return xResultError;
+	}
+
+	client->Statistic.RxBytes += received;
+
+	int32_t position = 0;
+
+	while (position < received && client->Sent)
+	{
+		int32_t used = HttpParserReceive(&client->Parser,
+											client->RxBuffer + position,
+											received - position,
+											client->Body,
+											client->Context);
+
+		if (used < 0)
+		{
+			return xResultError;
+		}
+
+		position += used;
+
+		if (client->Parser.State == HttpParserComplete)
+		{
+			bool keepAlive = client->Parser.KeepAlive;
+
+			privateResponseComplete(client);
+
+			if (!keepAlive)
+			{
+				return xResultError;
+			}
+
+			client->IsPersistent = true;
+			HttpParserReset(&client->Parser);
+		}
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief connects when there are queued requests, sends all of them and receives the responses
+ * available within the timeout of the transport. The connection stays open between the calls.
+ */
+void HttpClientHandler(HttpClientT* client)
+{
+	if (!client->IsConnected)
+	{
+		if (!client->Count || client->Transport.Connect(client->Transport.Context) != xResultAccept)
+		{
+			return;
+		}
+
+		client->IsConnected = true;
+		client->Statistic.Connects++;
+
+		HttpParserReset(&client->Parser);
+	}
+
+	if (privateTransmit(client) != xResultAccept)
+	{
+		privateClose(client);
+		return;
+	}
+
+	if (client->Sent && privateReceive(client) != xResultAccept)
+	{
+		privateClose(client);
+	}
+}
+//------------------------------------------------------------------------------
+void HttpClientClose(HttpClientT* client)
+{
+	privateClose(client);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief serializes the request into the next free slot, it is sent by HttpClientHandler.
+ * @return xResultBusy - all slots wait for their responses
+ */
+xResult HttpClientRequest(HttpClientT* client,
+							const char* method,
+							const char* path,
+							const char* contentType,
+							const void* body,
+							uint16_t length)
+{
+	if (client->Count >= client->PipelineDepth)
+	{
+		return xResultBusy;
+	}
+
+	uint8_t slot = (client->Head + client->Count) % client->PipelineDepth;
+	char* request = (char*)client->Slots + slot * client->SlotSize;
+	int size;
+
+	if (body)
+	{
+		size = snprintf(request, client->SlotSize,
+						"%s %s HTTP/1.1\r\nHost: %s\r\n%sContent-Type: %s\r\nContent-Length: %u\r\n\r\n",
+						method, path, client->Host, client->Headers, contentType, length);
+	}
+	else
+	{
+		size = snprintf(request, client->SlotSize,
+						"%s %s HTTP/1.1\r\nHost: %s\r\n%s\r\n",
+						method, path, client->Host, client->Headers);
+		length = 0;
+	}
+
+	if (size < 0 || size + length > client->SlotSize)
+	{
+		return xResultError;
+	}
+
+	if (length)
+	{
+		memcpy(request + size, body, length);
+	}
+
+	client->Lengths[slot] = size + length;
+	client->Count++;
+	client->Statistic.Requests++;
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+uint8_t HttpClientGetFreeSlots(HttpClientT* client)
+{
+	return client->PipelineDepth - client->Count;
+}
+//==============================================================================
+//initialization:
+
+xResult HttpClientInit(HttpClientT* client, HttpClientInitT* init)
+{
+	if (!client || !init
+		|| !init->PipelineDepth
+		|| init->PipelineDepth > HTTP_CLIENT_MAX_PIPELINE
+		|| init->MemorySize < (uint32_t)init->PipelineDepth * init->SlotSize + init->RxBufferSize)
+	{
+		return xResultError;
+	}
+
+	memset(client, 0, sizeof(HttpClientT));
+
+	client->Transport = init->Transport;
+	client->Host = init->Host;
+	client->Headers = init->Headers ? init->Headers : "";
+
+	client->Slots = init->Memory;
+	client->SlotSize = init->SlotSize;
+	client->PipelineDepth = init->PipelineDepth;
+
+	client->RxBuffer = init->Memory + init->PipelineDepth * init->SlotSize;
+	client->RxBufferSize = init->RxBufferSize;
+
+	client->Response = init->Response;
+	client->Body = init->Body;
+	client->Context = init->Context;
+
+	HttpParserReset(&client->Parser);
+
+	return xResultAccept;
+}
+//==============================================================================
@@ -0,0 +1,176 @@
+//==============================================================================
+//header:
+
+#ifndef _HTTP_CLIENT_H_
+#define _HTTP_CLIENT_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+//==============================================================================
+//defines:
+
+#ifndef HTTP_CLIENT_LINE_SIZE
+#define HTTP_CLIENT_LINE_SIZE 64 //longer header lines are truncated, the parsed headers fit
+#endif
+
+#ifndef HTTP_CLIENT_MAX_PIPELINE
+#define HTTP_CLIENT_MAX_PIPELINE 8
+#endif
+//==============================================================================
+//types:
+
+typedef enum
+{
+	HttpParserStatusLine,
+	HttpParserHeaderLine,
+	HttpParserBody, //Remaining bytes of Content-Length
+	HttpParserBodyUntilClose, //no length: the body ends with the connection
+	HttpParserChunkSize,
+	HttpParserChunkData,
+	HttpParserChunkDataEnd, //CRLF after the chunk
+	HttpParserTrailer,
+	HttpParserComplete,
+	HttpParserError
+
+} HttpParserStateT;
+//------------------------------------------------------------------------------
+/// @brief body bytes of the response as they are received, the body is not buffered
+typedef void (*HttpParserBodyT)(void* context, uint16_t status, const uint8_t* data, uint32_t size);
+//------------------------------------------------------------------------------
+/// @brief incremental HTTP/1.x response parser: status line, Content-Length, chunked
+/// transfer coding and Connection. Only the current header line is buffered
+typedef struct
+{
+	HttpParserStateT State;
+
+	uint16_t StatusCode;
+	uint32_t Remaining;
+
+	char Line[HTTP_CLIENT_LINE_SIZE];
+	uint16_t LineLength;
+
+	struct
+	{
+		uint8_t IsChunked : 1;
+		uint8_t HasLength : 1;
+		uint8_t KeepAlive : 1;
+	};
+
+} HttpParserT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	xResult (*Connect)(void* context);
+
+	/// @return sent bytes, negative - the connection is lost
+	int32_t (*Transmit)(void* context, const void* data, uint32_t size);
+
+	/// @return received bytes, 0 - nothing within the timeout of the transport, negative - the connection is closed
+	int32_t (*Receive)(void* context, void* data, uint32_t size);
+
+	void (*Close)(void* context);
+
+	void* Context;
+
+} HttpClientTransportT;
+//------------------------------------------------------------------------------
+/// @brief the response of the oldest request is complete
+typedef void (*HttpClientResponseT)(void* context, uint16_t status);
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Requests;
+	uint32_t Responses;
+	uint32_t Failures; //responses with a status other than 2xx
+	uint32_t Connects;
+	uint32_t Resent; //requests sent again after the connection was lost before their responses
+
+	uint32_t TxBytes;
+	uint32_t RxBytes;
+
+} HttpClientStatisticT;
+//------------------------------------------------------------------------------
+/// @brief HTTP/1.1 client over one persistent connection. The requests are queued in a ring of
+/// PipelineDepth slots and sent without waiting for the previous responses, the responses are
+/// matched in order. The requests not answered when the connection is lost are sent again
+typedef struct
+{
+	HttpClientTransportT Transport;
+	HttpParserT Parser;
+
+	const char* Host;
+	const char* Headers; //added to each request, every line ends with CRLF
+
+	uint8_t* Slots;
+	uint16_t SlotSize;
+	uint16_t Lengths[HTTP_CLIENT_MAX_PIPELINE];
+	uint8_t PipelineDepth;
+
+	uint8_t Head; //the oldest request
+	uint8_t Count; //queued requests
+	uint8_t Sent; //requests from Head sent on the current connection
+
+	uint8_t* RxBuffer;
+	uint16_t RxBufferSize;
+
+	HttpClientResponseT Response;
+	HttpParserBodyT Body;
+	void* Context;
+
+	HttpClientStatisticT Statistic;
+
+	bool IsConnected;
+	bool IsPersistent; //a response on the current connection kept it open, the requests are pipelined
+
+} HttpClientT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	HttpClientTransportT Transport;
+
+	const char* Host;
+	const char* Headers;
+
+	/// @brief PipelineDepth slots of SlotSize for the requests and RxBufferSize for the receiving
+	uint8_t* Memory;
+	uint32_t MemorySize;
+	uint16_t SlotSize;
+	uint8_t PipelineDepth;
+	uint16_t RxBufferSize;
+
+	HttpClientResponseT Response;
+	HttpParserBodyT Body;
+	void* Context;
+
+} HttpClientInitT;
+//==============================================================================
+//functions:
+
+void HttpParserReset(HttpParserT* parser);
+int32_t HttpParserReceive(HttpParserT* parser, const uint8_t* data, uint32_t size, HttpParserBodyT body, void* context);
+void HttpParserClose(HttpParserT* parser);
+
+xResult HttpClientInit(HttpClientT* client, HttpClientInitT* init);
+
+xResult HttpClientRequest(HttpClientT* client,
+							const char* method,
+							const char* path,
+							const char* contentType,
+							const void* body,
+							uint16_t length);
+
+void HttpClientHandler(HttpClientT* client);
+void HttpClientClose(HttpClientT* client);
+
+uint8_t HttpClientGetFreeSlots(HttpClientT* client);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_HTTP_CLIENT_H_
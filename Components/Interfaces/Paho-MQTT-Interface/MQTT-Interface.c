@@ -83,19 +83,76 @@ void TimerInit(MQTTTimerT* timer)
 }
 
 
+static void NetworkSetTimeout(MQTTNetworkT* n, int option, TickType_t* value, TickType_t ticks)
+{
+	if (*value == ticks)
+		return;
+
+	FreeRTOS_setsockopt(n->my_socket, 0, option, &ticks, sizeof(ticks));
+	n->statistic.setsockopt_calls++;
+
+	*value = ticks;
+}
+
+
+static int NetworkReadAheadTake(MQTTNetworkT* n, unsigned char* buffer, int len)
+{
+	int size = len < n->read_ahead_count ? len : n->read_ahead_count;
+
+	memcpy(buffer, n->read_ahead + n->read_ahead_head, size);
+	n->read_ahead_head += size;
+	n->read_ahead_count -= size;
+
+	return size;
+}
+
+
+static int NetworkRecv(MQTTNetworkT* n, unsigned char* buffer, int len, BaseType_t flags)
+{
+	int rc;
+
+	n->statistic.recv_calls++;
+
+	/* a short read is taken in bulk: the header bytes MQTTClient reads one by one come from the buffer */
+	if (n->read_ahead && len < n->read_ahead_size)
+	{
+		rc = FreeRTOS_recv(n->my_socket, n->read_ahead, n->read_ahead_size, flags);
+
+		if (rc <= 0)
+			return rc;
+
+		n->read_ahead_head = 0;
+		n->read_ahead_count = rc;
+
+		return NetworkReadAheadTake(n, buffer, len);
+	}
+
+	return FreeRTOS_recv(n->my_socket, buffer, len, flags);
+}
+
+
 int FreeRTOS_read(MQTTNetworkT* n, unsigned char* buffer, int len, int timeout_ms)
 {
 	TickType_t xTicksToWait = timeout_ms / portTICK_PERIOD_MS; /* convert milliseconds to ticks */
 	TimeOut_t xTimeOut;
-	int recvLen = 0;
+	int recvLen = n->read_ahead_count ? NetworkReadAheadTake(n, buffer, len) : 0;
 
 	vTaskSetTimeOutState(&xTimeOut); /* Record the time at which this function was entered. */
-	do
+	while (recvLen < len)
 	{
-		int rc = 0;
+		/* the bytes already in the socket are taken without blocking */
+		int rc = NetworkRecv(n, buffer + recvLen, len - recvLen, FREERTOS_MSG_DONTWAIT);
+
+		if (rc == 0)
+		{
+			if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+				break;
+
+			/* nothing yet: blocks until the socket is readable or the remaining deadline is over */
+			NetworkSetTimeout(n, FREERTOS_SO_RCVTIMEO, &n->rcv_timeout, xTicksToWait);
+			rc = NetworkRecv(n, buffer + recvLen, len - recvLen, 0);
+		}
 
-		FreeRTOS_setsockopt(n->my_socket, 0, FREERTOS_SO_RCVTIMEO, &xTicksToWait, sizeof(xTicksToWait));
-		rc = FreeRTOS_recv(n->my_socket, buffer + recvLen, len - recvLen, 0);
 		if (rc > 0)
 			recvLen += rc;
 		else if (rc < 0)
@@ -103,7 +160,7 @@ int FreeRTOS_read(MQTTNetworkT* n, unsigned char* buffer, int len, int timeout_m
 			recvLen = rc;
 			break;
 		}
-	} while (recvLen < len && xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) == pdFALSE);
+	}
 
 	return recvLen;
 }
@@ -116,12 +173,29 @@ int FreeRTOS_write(MQTTNetworkT* n, unsigned char* buffer, int len, int timeout_
 	int sentLen = 0;
 
 	vTaskSetTimeOutState(&xTimeOut); /* Record the time at which this function was entered. */
-	do
+	while (sentLen < len)
 	{
-		int rc = 0;
+		/* the packet usually fits the tx stream of the socket and is queued without blocking */
+		int rc = FreeRTOS_send(n->my_socket, buffer + sentLen, len - sentLen, FREERTOS_MSG_DONTWAIT);
+		n->statistic.send_calls++;
+
+		if (rc == -pdFREERTOS_ERRNO_ENOSPC)
+			rc = 0;
+
+		if (rc == 0)
+		{
+			if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE)
+				break;
+
+			/* blocks until the stream has space or the remaining deadline is over */
+			NetworkSetTimeout(n, FREERTOS_SO_SNDTIMEO, &n->snd_timeout, xTicksToWait);
+			rc = FreeRTOS_send(n->my_socket, buffer + sentLen, len - sentLen, 0);
+			n->statistic.send_calls++;
+
+			if (rc == -pdFREERTOS_ERRNO_ENOSPC)
+				rc = 0;
+		}
 
-		FreeRTOS_setsockopt(n->my_socket, 0, FREERTOS_SO_RCVTIMEO, &xTicksToWait, sizeof(xTicksToWait));
-		rc = FreeRTOS_send(n->my_socket, buffer + sentLen, len - sentLen, 0);
 		if (rc > 0)
 			sentLen += rc;
 		else if (rc < 0)
@@ -129,15 +203,27 @@ int FreeRTOS_write(MQTTNetworkT* n, unsigned char* buffer, int len, int timeout_
 			sentLen = rc;
 			break;
 		}
-	} while (sentLen < len && xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) == pdFALSE);
+	}
 
 	return sentLen;
 }
 
 
+static uint32_t NetworkGetTime(void)
+{
+	return xTaskGetTickCount() * portTICK_PERIOD_MS;
+}
+
+
 void FreeRTOS_disconnect(MQTTNetworkT* n)
 {
 	FreeRTOS_closesocket(n->my_socket);
+
+	if (n->reconnect && n->is_connected)
+		NetReconnectDisconnected(n->reconnect, NetworkGetTime());
+
+	n->is_connected = 0;
+	n->read_ahead_count = 0;
 }
 
 
@@ -147,6 +233,34 @@ void NetworkInit(MQTTNetworkT* n)
 	n->mqttread = FreeRTOS_read;
 	n->mqttwrite = FreeRTOS_write;
 	n->disconnect = FreeRTOS_disconnect;
+	n->reconnect = NULL;
+	n->is_connected = 0;
+	n->read_ahead = NULL;
+	n->read_ahead_size = 0;
+	n->read_ahead_head = 0;
+	n->read_ahead_count = 0;
+	memset(&n->statistic, 0, sizeof(n->statistic));
+}
+
+
+void NetworkSetReadAhead(MQTTNetworkT* n, unsigned char* buffer, int size)
+{
+	n->read_ahead = buffer;
+	n->read_ahead_size = buffer ? size : 0;
+	n->read_ahead_head = 0;
+	n->read_ahead_count = 0;
+}
+
+
+/* bytes ready for MQTTClient: the socket event semaphore is not given for the ones already read ahead */
+int NetworkPending(MQTTNetworkT* n)
+{
+	int pending = n->read_ahead_count;
+
+	if (n->is_connected)
+		pending += FreeRTOS_recvcount(n->my_socket);
+
+	return pending;
 }
 
 
@@ -156,6 +270,10 @@ int NetworkConnect(MQTTNetworkT* n, char* addr, int port)
 	int retVal = -1;
 	uint32_t ipAddress;
 
+	/* the attempt is refused until the backoff delay of the previous failure is over */
+	if (n->reconnect && !NetReconnectIsAllowed(n->reconnect, NetworkGetTime()))
+		return -pdFREERTOS_ERRNO_EAGAIN;
+
 	if ((ipAddress = FreeRTOS_gethostbyname(addr)) == 0)
 		goto exit;
 
@@ -171,7 +289,22 @@ int NetworkConnect(MQTTNetworkT* n, char* addr, int port)
 	    goto exit;
 	}
 
+	/* a new socket starts with the default timeouts, they are written by the first blocking read or write */
+	n->rcv_timeout = ipconfigSOCK_DEFAULT_RECEIVE_BLOCK_TIME;
+	n->snd_timeout = ipconfigSOCK_DEFAULT_SEND_BLOCK_TIME;
+	n->read_ahead_count = 0;
+
 exit:
+	if (n->reconnect)
+	{
+		if (retVal < 0)
+			NetReconnectFailed(n->reconnect, NetworkGetTime());
+		else
+			NetReconnectConnected(n->reconnect, NetworkGetTime());
+	}
+
+	n->is_connected = retVal >= 0;
+
 	return retVal;
 }
 
@@ -21,6 +21,7 @@
 #include "semphr.h"
 #include "task.h"
 #include "FreeRTOS_IP.h"
+#include "Net/Reconnect/NetReconnect.h"
 
 typedef struct MQTTTimer
 {
@@ -28,6 +29,13 @@ typedef struct MQTTTimer
 	TimeOut_t xTimeOut;
 } MQTTTimerT;
 
+typedef struct MQTTNetworkStatistic
+{
+	uint32_t recv_calls;
+	uint32_t send_calls;
+	uint32_t setsockopt_calls;
+} MQTTNetworkStatisticT;
+
 typedef struct MQTTNetwork MQTTNetworkT;
 
 struct MQTTNetwork
@@ -36,6 +44,21 @@ struct MQTTNetwork
 	int (*mqttread) (MQTTNetworkT*, unsigned char*, int, int);
 	int (*mqttwrite) (MQTTNetworkT*, unsigned char*, int, int);
 	void (*disconnect) (MQTTNetworkT*);
+
+	NetReconnectT* reconnect; /* backoff of NetworkConnect, NULL - an attempt on each call */
+	char is_connected;
+
+	/* bytes received ahead of the reads of MQTTClient, NULL - each read goes to the socket */
+	unsigned char* read_ahead;
+	int read_ahead_size;
+	int read_ahead_head;
+	int read_ahead_count;
+
+	/* values of FREERTOS_SO_RCVTIMEO/SNDTIMEO of my_socket, the options are written only on a change */
+	TickType_t rcv_timeout;
+	TickType_t snd_timeout;
+
+	MQTTNetworkStatisticT statistic;
 };
 
 void TimerInit(MQTTTimerT*);
@@ -65,6 +88,8 @@ int FreeRTOS_write(MQTTNetworkT*, unsigned char*, int, int);
 void FreeRTOS_disconnect(MQTTNetworkT*);
 
 void NetworkInit(MQTTNetworkT*);
+void NetworkSetReadAhead(MQTTNetworkT*, unsigned char*, int);
+int NetworkPending(MQTTNetworkT*);
 int NetworkConnect(MQTTNetworkT*, char*, int);
 /*int NetworkConnectTLS(Network*, char*, int, SlSockSecureFiles_t*, unsigned char, unsigned int, char);*/
 
@@ -0,0 +1,895 @@
+//==============================================================================
+//header:
+
+
+//==============================================================================
+//includes:
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+
+#include "Iperf-Component.h"
+#include "Components.h"
+#include "TerminalCommands/TerminalCommands.h"
+
+#if NET_TARGET_LAYOUT == NET_LWIP_LAYOUT
+
+#include "lwip/sockets.h"
+#include "lwip/errno.h"
+
+#elif NET_TARGET_LAYOUT == NET_FREERTOS_LAYOUT
+
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+
+#endif
+//==============================================================================
+//defines:
+
+//iperf2 header flags
+#define IPERF_HEADER_VERSION1 0x80000000
+
+#define IPERF_CLIENT_HEADER_OFFSET_TCP 0
+#define IPERF_CLIENT_HEADER_OFFSET_UDP sizeof(IperfUdpHeaderT)
+//==============================================================================
+//types:
+
+#if NET_TARGET_LAYOUT == NET_LWIP_LAYOUT
+
+typedef int IperfSocketT;
+#define IPERF_INVALID_SOCKET -1
+
+#elif NET_TARGET_LAYOUT == NET_FREERTOS_LAYOUT
+
+typedef Socket_t IperfSocketT;
+#define IPERF_INVALID_SOCKET NULL
+
+#endif
+//------------------------------------------------------------------------------
+//iperf2 wire format, all fields are in network byte order
+typedef struct
+{
+	int32_t Id;
+	uint32_t Seconds;
+	uint32_t Microseconds;
+
+} IperfUdpHeaderT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	int32_t Flags;
+	int32_t NumThreads;
+	int32_t Port;
+	int32_t BufferLength;
+	int32_t WinBand;
+	int32_t Amount;
+
+} IperfClientHeaderT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	int32_t Flags;
+	int32_t TotalLength1;
+	int32_t TotalLength2;
+	int32_t StopSeconds;
+	int32_t StopMicroseconds;
+	int32_t ErrorCount;
+	int32_t OutOfOrderCount;
+	int32_t Datagrams;
+	int32_t Jitter1;
+	int32_t Jitter2;
+
+} IperfServerHeaderT;
+//==============================================================================
+//variables:
+
+static TaskHandle_t taskHandle;
+static StaticTask_t taskBuffer;
+static StackType_t taskStack[IPERF_TASK_STACK_SIZE] IPERF_COMPONENT_MAIN_TASK_STACK_SECTION;
+
+static uint8_t privateBuffer[IPERF_BUFFER_SIZE] IPERF_BUFFER_MEM_SECTION;
+static char privateReportBuffer[IPERF_REPORT_BUFFER_SIZE];
+
+static IperfRequestT privateRequest;
+static volatile uint8_t privateStopRequest;
+static volatile uint8_t privateIsBusy;
+
+static int RTOS_IperfTaskStackWaterMark;
+
+IperfStatisticT IperfStatistic;
+//==============================================================================
+//functions:
+
+#if NET_TARGET_LAYOUT == NET_LWIP_LAYOUT
+
+static IperfSocketT privateSocketOpen(uint8_t udp)
+{
+	int socketNumber = udp ? socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP) : socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+	if (socketNumber >= 0)
+	{
+		int timeout = IPERF_SOCKET_TIMEOUT;
+		setsockopt(socketNumber, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+		setsockopt(socketNumber, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+	}
+
+	return socketNumber;
+}
+//------------------------------------------------------------------------------
+static void privateSocketClose(IperfSocketT socket)
+{
+	if (socket != IPERF_INVALID_SOCKET)
+	{
+		close(socket);
+	}
+}
+//------------------------------------------------------------------------------
+static xResult privateSocketBind(IperfSocketT socket, uint16_t port, uint8_t listen_)
+{
+	struct sockaddr_in address = { 0 };
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = INADDR_ANY;
+
+	if (bind(socket, (struct sockaddr*)&address, sizeof(address)) < 0)
+	{
+		return xResultError;
+	}
+
+	if (listen_ && listen(socket, 1) < 0)
+	{
+		return xResultError;
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static IperfSocketT privateSocketAccept(IperfSocketT server, uint32_t* address)
+{
+	struct sockaddr_in clientAddress;
+	socklen_t length = sizeof(clientAddress);
+
+	int client = accept(server, (struct sockaddr*)&clientAddress, &length);
+
+	if (client >= 0)
+	{
+		*address = clientAddress.sin_addr.s_addr;
+
+		int timeout = IPERF_SOCKET_TIMEOUT;
+		setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	}
+
+	return client < 0 ? IPERF_INVALID_SOCKET : client;
+}
+//------------------------------------------------------------------------------
+static xResult privateSocketConnect(IperfSocketT socket, uint32_t address, uint16_t port)
+{
+	struct sockaddr_in serverAddress = { 0 };
+	serverAddress.sin_family = AF_INET;
+	serverAddress.sin_port = htons(port);
+	serverAddress.sin_addr.s_addr = address;
+
+	return connect(socket, (struct sockaddr*)&serverAddress, sizeof(serverAddress)) < 0 ? xResultError : xResultAccept;
+}
+//------------------------------------------------------------------------------
+/**
+ * @return >0 - bytes received, 0 - timeout, <0 - connection closed or error
+ */
+static int privateSocketReceive(IperfSocketT socket, void* buffer, int size, uint32_t* address, uint16_t* port)
+{
+	struct sockaddr_in from;
+	socklen_t length = sizeof(from);
+
+	int result = address ? recvfrom(socket, buffer, size, 0, (struct sockaddr*)&from, &length) : recv(socket, buffer, size, 0);
+
+	if (result < 0)
+	{
+		return (errno == EWOULDBLOCK || errno == EAGAIN) ? 0 : -1;
+	}
+
+	if (result == 0 && !address)
+	{
+		return -1;
+	}
+
+	if (address)
+	{
+		*address = from.sin_addr.s_addr;
+		*port = ntohs(from.sin_port);
+	}
+
+	return result;
+}
+//------------------------------------------------------------------------------
+static int privateSocketSend(IperfSocketT socket, void* data, int size, uint32_t address, uint16_t port)
+{
+	if (!address)
+	{
+		return send(socket, data, size, 0);
+	}
+
+	struct sockaddr_in to = { 0 };
+	to.sin_family = AF_INET;
+	to.sin_port = htons(port);
+	to.sin_addr.s_addr = address;
+
+	return sendto(socket, data, size, 0, (struct sockaddr*)&to, sizeof(to));
+}
+
+#elif NET_TARGET_LAYOUT == NET_FREERTOS_LAYOUT
+
+static IperfSocketT privateSocketOpen(uint8_t udp)
+{
+	Socket_t socket = udp
+			? FreeRTOS_socket(FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP)
+			: FreeRTOS_socket(FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP);
+
+	if (socket == FREERTOS_INVALID_SOCKET)
+	{
+		return IPERF_INVALID_SOCKET;
+	}
+
+	TickType_t timeout = pdMS_TO_TICKS(IPERF_SOCKET_TIMEOUT);
+	FreeRTOS_setsockopt(socket, 0, FREERTOS_SO_RCVTIMEO, &timeout, sizeof(timeout));
+	FreeRTOS_setsockopt(socket, 0, FREERTOS_SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+	return socket;
+}
+//------------------------------------------------------------------------------
+static void privateSocketClose(IperfSocketT socket)
+{
+	if (socket != IPERF_INVALID_SOCKET)
+	{
+		FreeRTOS_shutdown(socket, FREERTOS_SHUT_RDWR);
+		FreeRTOS_closesocket(socket);
+	}
+}
+//------------------------------------------------------------------------------
+static xResult privateSocketBind(IperfSocketT socket, uint16_t port, uint8_t listen)
+{
+	struct freertos_sockaddr address = { 0 };
+	address.sin_port = FreeRTOS_htons(port);
+
+	if (FreeRTOS_bind(socket, &address, sizeof(address)) != 0)
+	{
+		return xResultError;
+	}
+
+	if (listen && FreeRTOS_listen(socket, 1) != 0)
+	{
+		return xResultError;
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static IperfSocketT privateSocketAccept(IperfSocketT server, uint32_t* address)
+{
+	struct freertos_sockaddr clientAddress;
+	socklen_t length = sizeof(clientAddress);
+
+	Socket_t client = FreeRTOS_accept(server, &clientAddress, &length);
+
+	if (client == NULL || client == FREERTOS_INVALID_SOCKET)
+	{
+		return IPERF_INVALID_SOCKET;
+	}
+
+	*address = clientAddress.sin_addr;
+
+	return client;
+}
+//------------------------------------------------------------------------------
+static xResult privateSocketConnect(IperfSocketT socket, uint32_t address, uint16_t port)
+{
+	struct freertos_sockaddr serverAddress = { 0 };
+	serverAddress.sin_port = FreeRTOS_htons(port);
+	serverAddress.sin_addr = address;
+
+	return FreeRTOS_connect(socket, &serverAddress, sizeof(serverAddress)) < 0 ? xResultError : xResultAccept;
+}
+//------------------------------------------------------------------------------
+/**
+ * @return >0 - bytes received, 0 - timeout, <0 - connection closed or error
+ */
+static int privateSocketReceive(IperfSocketT socket, void* buffer, int size, uint32_t* address, uint16_t* port)
+{
+	if (address)
+	{
+		struct freertos_sockaddr from;
+		socklen_t length = sizeof(from);
+
+		int result = FreeRTOS_recvfrom(socket, buffer, size, 0, &from, &length);
+
+		if (result > 0)
+		{
+			*address = from.sin_addr;
+			*port = FreeRTOS_ntohs(from.sin_port);
+		}
+
+		return result < 0 ? 0 : result;
+	}
+
+	return FreeRTOS_recv(socket, buffer, size, 0);
+}
+//------------------------------------------------------------------------------
+static int privateSocketSend(IperfSocketT socket, void* data, int size, uint32_t address, uint16_t port)
+{
+	if (!address)
+	{
+		return FreeRTOS_send(socket, data, size, 0);
+	}
+
+	struct freertos_sockaddr to = { 0 };
+	to.sin_port = FreeRTOS_htons(port);
+	to.sin_addr = address;
+
+	return FreeRTOS_sendto(socket, data, size, 0, &to, sizeof(to));
+}
+
+#endif
+//------------------------------------------------------------------------------
+static inline uint32_t privateSwap32(uint32_t value)
+{
+	return __builtin_bswap32(value);
+}
+//------------------------------------------------------------------------------
+static void privateReport(const char* format, ...)
+{
+	xPortT* port = privateRequest.ReportPort;
+
+	if (!port)
+	{
+		return;
+	}
+
+	va_list args;
+	va_start(args, format);
+	vsnprintf(privateReportBuffer, sizeof(privateReportBuffer), format, args);
+	va_end(args);
+
+	xPortStartTransmission(port);
+	xPortTransmitString(port, privateReportBuffer);
+	xPortEndTransmission(port);
+}
+//------------------------------------------------------------------------------
+static void privateReportBandwidth(uint32_t from, uint32_t to, uint64_t bytes)
+{
+	uint32_t time = to - from;
+	uint32_t kbits = time ? (uint32_t)((bytes * 8) / time) : 0;
+
+	privateReport("[iperf] %2lu.%lu-%2lu.%lu sec %6lu KBytes %4lu.%02lu Mbits/sec\r",
+					from / 1000, (from % 1000) / 100,
+					to / 1000, (to % 1000) / 100,
+					(uint32_t)(bytes >> 10),
+					kbits / 1000, (kbits % 1000) / 10);
+}
+//------------------------------------------------------------------------------
+static void privateReportAddress(const char* prefix, uint32_t address, uint16_t port)
+{
+	uint8_t* octets = (uint8_t*)&address;
+
+	privateReport("[iperf] %s %u.%u.%u.%u port %u\r", prefix, octets[0], octets[1], octets[2], octets[3], port);
+}
+//------------------------------------------------------------------------------
+static void privateStatisticReset()
+{
+	memset(&IperfStatistic, 0, sizeof(IperfStatistic));
+	IperfStatistic.StartTime = xSystemGetTime();
+	IperfStatistic.LastTime = IperfStatistic.StartTime;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief prints the interval report when the interval is over
+ * @param intervalBytes bytes transferred since the previous interval report
+ */
+static void privateIntervalHandler(uint64_t* intervalBytes)
+{
+	if (!privateRequest.Interval)
+	{
+		return;
+	}
+
+	uint32_t time = xSystemGetTime();
+
+	if (time - IperfStatistic.LastTime >= privateRequest.Interval * 1000)
+	{
+		privateReportBandwidth(IperfStatistic.LastTime - IperfStatistic.StartTime,
+								time - IperfStatistic.StartTime,
+								*intervalBytes);
+
+		IperfStatistic.LastTime = time;
+		*intervalBytes = 0;
+	}
+}
+//------------------------------------------------------------------------------
+static void privateTcpServer()
+{
+	IperfSocketT server = privateSocketOpen(false);
+
+	if (server == IPERF_INVALID_SOCKET || privateSocketBind(server, privateRequest.Port, true) != xResultAccept)
+	{
+		privateReport("[iperf] tcp server: bind error\r");
+		goto end;
+	}
+
+	privateReport("[iperf] tcp server listening on port %u\r", privateRequest.Port);
+
+	while (!privateStopRequest)
+	{
+		uint32_t address = 0;
+		IperfSocketT client = privateSocketAccept(server, &address);
+
+		if (client == IPERF_INVALID_SOCKET)
+		{
+			continue;
+		}
+
+		privateReportAddress("connected with", address, 0);
+		privateStatisticReset();
+
+		uint64_t intervalBytes = 0;
+
+		while (!privateStopRequest)
+		{
+			int result = privateSocketReceive(client, privateBuffer, sizeof(privateBuffer), NULL, NULL);
+
+			if (result < 0)
+			{
+				break;
+			}
+
+			IperfStatistic.Bytes += result;
+			intervalBytes += result;
+
+			privateIntervalHandler(&intervalBytes);
+		}
+
+		privateSocketClose(client);
+
+		privateReportBandwidth(0, xSystemGetTime() - IperfStatistic.StartTime, IperfStatistic.Bytes);
+	}
+
+	end:;
+	privateSocketClose(server);
+}
+//------------------------------------------------------------------------------
+static void privateUdpServer()
+{
+	IperfSocketT server = privateSocketOpen(true);
+
+	if (server == IPERF_INVALID_SOCKET || privateSocketBind(server, privateRequest.Port, false) != xResultAccept)
+	{
+		privateReport("[iperf] udp server: bind error\r");
+		goto end;
+	}
+
+	privateReport("[iperf] udp server listening on port %u\r", privateRequest.Port);
+
+	uint64_t intervalBytes = 0;
+	int32_t lastId = -1;
+	int32_t lastTransit = 0;
+	uint8_t isStarted = false;
+
+	while (!privateStopRequest)
+	{
+		uint32_t address;
+		uint16_t port;
+
+		int result = privateSocketReceive(server, privateBuffer, sizeof(privateBuffer), &address, &port);
+
+		if (result < (int)sizeof(IperfUdpHeaderT))
+		{
+			continue;
+		}
+
+		IperfUdpHeaderT* header = (IperfUdpHeaderT*)privateBuffer;
+		int32_t id = (int32_t)privateSwap32(header->Id);
+		uint32_t time = xSystemGetTime();
+
+		if (id < 0)
+		{
+			//the client repeats the final datagram until it receives the server report,
+			//so the report is resent from the statistic of the finished session
+			uint32_t duration = time - IperfStatistic.StartTime;
+
+			IperfServerHeaderT* report = (IperfServerHeaderT*)(privateBuffer + sizeof(IperfUdpHeaderT));
+			report->Flags = privateSwap32(IPERF_HEADER_VERSION1);
+			report->TotalLength1 = privateSwap32((uint32_t)(IperfStatistic.Bytes >> 32));
+			report->TotalLength2 = privateSwap32((uint32_t)IperfStatistic.Bytes);
+			report->StopSeconds = privateSwap32(duration / 1000);
+			report->StopMicroseconds = privateSwap32((duration % 1000) * 1000);
+			report->ErrorCount = privateSwap32(IperfStatistic.Lost);
+			report->OutOfOrderCount = privateSwap32(IperfStatistic.OutOfOrder);
+			report->Datagrams = privateSwap32(lastId + 1);
+			report->Jitter1 = privateSwap32(IperfStatistic.Jitter / 1000000);
+			report->Jitter2 = privateSwap32(IperfStatistic.Jitter % 1000000);
+
+			privateSocketSend(server, privateBuffer, sizeof(IperfUdpHeaderT) + sizeof(IperfServerHeaderT), address, port);
+
+			if (isStarted)
+			{
+				privateReportBandwidth(0, duration, IperfStatistic.Bytes);
+				privateReport("[iperf] jitter %lu us, lost %lu/%lu, out of order %lu\r",
+								IperfStatistic.Jitter,
+								IperfStatistic.Lost,
+								lastId + 1,
+								IperfStatistic.OutOfOrder);
+
+			}
+
+			isStarted = false;
+			continue;
+		}
+
+		if (!isStarted)
+		{
+			privateReportAddress("connected with", address, port);
+			privateStatisticReset();
+
+			intervalBytes = 0;
+			lastId = -1;
+			isStarted = true;
+		}
+
+		IperfStatistic.Bytes += result;
+		IperfStatistic.Datagrams++;
+		intervalBytes += result;
+
+		if (id > lastId + 1)
+		{
+			IperfStatistic.Lost += id - (lastId + 1);
+		}
+		else if (id < lastId + 1)
+		{
+			IperfStatistic.OutOfOrder++;
+
+			if (IperfStatistic.Lost)
+			{
+				IperfStatistic.Lost--;
+			}
+		}
+
+		if (id > lastId)
+		{
+			lastId = id;
+		}
+
+		//RFC 1889 interarrival jitter, the clock offset cancels in the transit difference
+		int32_t sent = (int32_t)(privateSwap32(header->Seconds) * 1000000 + privateSwap32(header->Microseconds));
+		int32_t transit = (int32_t)(time * 1000) - sent;
+
+		if (IperfStatistic.Datagrams > 1)
+		{
+			int32_t delta = transit - lastTransit;
+
+			if (delta < 0)
+			{
+				delta = -delta;
+			}
+
+			IperfStatistic.Jitter += ((int32_t)delta - (int32_t)IperfStatistic.Jitter) / 16;
+		}
+
+		lastTransit = transit;
+
+		privateIntervalHandler(&intervalBytes);
+	}
+
+	end:;
+	privateSocketClose(server);
+}
+//------------------------------------------------------------------------------
+static void privateFillPayload(uint32_t headerOffset)
+{
+	for (uint32_t i = 0; i < sizeof(privateBuffer); i++)
+	{
+		privateBuffer[i] = '0' + (i % 10);
+	}
+
+	//flags = 0: plain transfer, no dual test and no server-side settings
+	memset(privateBuffer + headerOffset, 0, sizeof(IperfClientHeaderT));
+}
+//------------------------------------------------------------------------------
+static void privateTcpClient()
+{
+	IperfSocketT client = privateSocketOpen(false);
+
+	if (client == IPERF_INVALID_SOCKET
+		|| privateSocketConnect(client, privateRequest.Address, privateRequest.Port) != xResultAccept)
+	{
+		privateReport("[iperf] tcp client: connect error\r");
+		goto end;
+	}
+
+	privateReportAddress("connected to", privateRequest.Address, privateRequest.Port);
+
+	privateFillPayload(IPERF_CLIENT_HEADER_OFFSET_TCP);
+	privateStatisticReset();
+
+	uint64_t intervalBytes = 0;
+	uint32_t duration = privateRequest.Duration * 1000;
+
+	while (!privateStopRequest && xSystemGetTime() - IperfStatistic.StartTime < duration)
+	{
+		int result = privateSocketSend(client, privateBuffer, privateRequest.Length, 0, 0);
+
+		if (result < 0)
+		{
+			privateReport("[iperf] tcp client: connection lost\r");
+			break;
+		}
+
+		IperfStatistic.Bytes += result;
+		intervalBytes += result;
+
+		privateIntervalHandler(&intervalBytes);
+	}
+
+	privateReportBandwidth(0, xSystemGetTime() - IperfStatistic.StartTime, IperfStatistic.Bytes);
+
+	end:;
+	privateSocketClose(client);
+}
+//------------------------------------------------------------------------------
+static void privateUdpClient()
+{
+	IperfSocketT client = privateSocketOpen(true);
+
+	if (client == IPERF_INVALID_SOCKET)
+	{
+		privateReport("[iperf] udp client: socket error\r");
+		return;
+	}
+
+	privateReportAddress("sending to", privateRequest.Address, privateRequest.Port);
+
+	privateFillPayload(IPERF_CLIENT_HEADER_OFFSET_UDP);
+	privateStatisticReset();
+
+	IperfUdpHeaderT* header = (IperfUdpHeaderT*)privateBuffer;
+	uint64_t intervalBytes = 0;
+	uint32_t duration = privateRequest.Duration * 1000;
+	uint32_t time = IperfStatistic.StartTime;
+	int32_t id = 0;
+
+	//datagrams are paced against the system tick: everything that is due by now is sent in one burst
+	uint64_t bitsPerMs = privateRequest.Bandwidth;
+	uint32_t datagramBits = privateRequest.Length * 8;
+
+	while (!privateStopRequest && (time = xSystemGetTime()) - IperfStatistic.StartTime < duration)
+	{
+		uint32_t due = (uint32_t)(((time - IperfStatistic.StartTime + 1) * bitsPerMs) / datagramBits);
+
+		if ((uint32_t)id >= due)
+		{
+			vTaskDelay(1);
+			continue;
+		}
+
+		header->Id = privateSwap32(id);
+		header->Seconds = privateSwap32(time / 1000);
+		header->Microseconds = privateSwap32((time % 1000) * 1000);
+
+		if (privateSocketSend(client, privateBuffer, privateRequest.Length, privateRequest.Address, privateRequest.Port) > 0)
+		{
+			IperfStatistic.Bytes += privateRequest.Length;
+			intervalBytes += privateRequest.Length;
+		}
+
+		id++;
+		IperfStatistic.Datagrams++;
+
+		privateIntervalHandler(&intervalBytes);
+	}
+
+	privateReportBandwidth(0, time - IperfStatistic.StartTime, IperfStatistic.Bytes);
+	privateReport("[iperf] sent %lu datagrams\r", IperfStatistic.Datagrams);
+
+	//the final datagram carries a negative id, the server answers with its report
+	for (uint8_t i = 0; i < IPERF_UDP_FIN_ATTEMPTS; i++)
+	{
+		time = xSystemGetTime();
+
+		header->Id = privateSwap32(-id);
+		header->Seconds = privateSwap32(time / 1000);
+		header->Microseconds = privateSwap32((time % 1000) * 1000);
+
+		privateSocketSend(client, privateBuffer, privateRequest.Length, privateRequest.Address, privateRequest.Port);
+
+		uint32_t address;
+		uint16_t port;
+
+		int result = privateSocketReceive(client, privateBuffer, sizeof(privateBuffer), &address, &port);
+
+		if (result >= (int)(sizeof(IperfUdpHeaderT) + sizeof(IperfServerHeaderT)))
+		{
+			IperfServerHeaderT* report = (IperfServerHeaderT*)(privateBuffer + sizeof(IperfUdpHeaderT));
+
+			privateReport("[iperf] server report: jitter %lu us, lost %lu/%lu, out of order %lu\r",
+							privateSwap32(report->Jitter1) * 1000000 + privateSwap32(report->Jitter2),
+							privateSwap32(report->ErrorCount),
+							privateSwap32(report->Datagrams),
+							privateSwap32(report->OutOfOrderCount));
+			break;
+		}
+	}
+
+	privateSocketClose(client);
+}
+//------------------------------------------------------------------------------
+static void privateTask(void* arg)
+{
+	while (true)
+	{
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+		privateStopRequest = false;
+
+		switch ((int)privateRequest.Mode)
+		{
+			case IperfModeTcpServer: privateTcpServer(); break;
+			case IperfModeUdpServer: privateUdpServer(); break;
+			case IperfModeTcpClient: privateTcpClient(); break;
+			case IperfModeUdpClient: privateUdpClient(); break;
+			default: break;
+		}
+
+		privateReport("[iperf] done\r");
+
+		privateRequest.Mode = IperfModeIdle;
+		privateIsBusy = false;
+
+		RTOS_IperfTaskStackWaterMark = uxTaskGetStackHighWaterMark(NULL);
+	}
+}
+//------------------------------------------------------------------------------
+xResult IperfComponentStart(IperfRequestT* request)
+{
+	if (!request || request->Mode == IperfModeIdle)
+	{
+		return xResultError;
+	}
+
+	if (privateIsBusy || !Net.PhyIsConnecnted)
+	{
+		return xResultBusy;
+	}
+
+	privateRequest = *request;
+
+	if (!privateRequest.Port)
+	{
+		privateRequest.Port = IPERF_DEFAULT_PORT;
+	}
+
+	if (!privateRequest.Duration)
+	{
+		privateRequest.Duration = IPERF_DEFAULT_DURATION;
+	}
+
+	if (!privateRequest.Bandwidth)
+	{
+		privateRequest.Bandwidth = IPERF_DEFAULT_UDP_BANDWIDTH;
+	}
+
+	if (!privateRequest.Length || privateRequest.Length > sizeof(privateBuffer))
+	{
+		privateRequest.Length = request->Mode == IperfModeUdpClient ? IPERF_DEFAULT_UDP_LENGTH : IPERF_DEFAULT_TCP_LENGTH;
+	}
+
+	if (privateRequest.Length < sizeof(IperfUdpHeaderT) + sizeof(IperfClientHeaderT))
+	{
+		privateRequest.Length = sizeof(IperfUdpHeaderT) + sizeof(IperfClientHeaderT);
+	}
+
+	privateIsBusy = true;
+	xTaskNotifyGive(taskHandle);
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+void IperfComponentStop()
+{
+	privateStopRequest = true;
+}
+//------------------------------------------------------------------------------
+static uint8_t privateParseAddress(const char* text, uint32_t* address)
+{
+	uint8_t* octets = (uint8_t*)address;
+	char* end;
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		unsigned long value = strtoul(text, &end, 10);
+
+		if (end == text || value > 255 || (i < 3 && *end != '.'))
+		{
+			return false;
+		}
+
+		octets[i] = value;
+		text = end + 1;
+	}
+
+	return true;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief iperf2 style command line:
+ *  "iperf -s [-u] [-p port] [-i sec]"
+ *  "iperf -c a.b.c.d [-u] [-p port] [-t sec] [-i sec] [-b Kbits] [-l len]"
+ *  "iperf stop"
+ * the report of a running session stays on its port
+ */
+static xResult privateCommand(xPortT* port, TerminalCommandArgumentsT* arguments)
+{
+	if (arguments->Count == 1 && strcmp(arguments->Values[0], "stop") == 0)
+	{
+		IperfComponentStop();
+		return xResultAccept;
+	}
+
+	if (TerminalCommandCheckOptions(arguments, "cptibl", "su") != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	IperfRequestT request = { 0 };
+	request.ReportPort = port;
+	request.Interval = TerminalCommandGetNumber(arguments, 'i', IPERF_DEFAULT_INTERVAL);
+	request.Port = TerminalCommandGetNumber(arguments, 'p', 0);
+	request.Duration = TerminalCommandGetNumber(arguments, 't', 0);
+	request.Bandwidth = TerminalCommandGetNumber(arguments, 'b', 0);
+	request.Length = TerminalCommandGetNumber(arguments, 'l', 0);
+
+	char* address = TerminalCommandGetOption(arguments, 'c');
+	bool isServer = TerminalCommandHasFlag(arguments, 's');
+	bool isUdp = TerminalCommandHasFlag(arguments, 'u');
+
+	if (address && !privateParseAddress(address, &request.Address))
+	{
+		return xResultError;
+	}
+
+	if (isServer == (address != NULL))
+	{
+		return xResultError;
+	}
+
+	request.Mode = isServer
+			? (isUdp ? IperfModeUdpServer : IperfModeTcpServer)
+			: (isUdp ? IperfModeUdpClient : IperfModeTcpClient);
+
+	return IperfComponentStart(&request);
+}
+//------------------------------------------------------------------------------
+static const TerminalCommandT privateCommands[] =
+{
+	{
+		.Name = "iperf",
+		.Usage = "-s|-c a.b.c.d [-u] [-p port] [-t sec] [-i sec] [-b Kbits] [-l len] | stop",
+		.Handler = privateCommand
+	}
+};
+//==============================================================================
+//initialization:
+
+xResult IperfComponentInit(void* parent)
+{
+	privateRequest.ReportPort = &SerialPort;
+
+	TerminalCommandsAdd(privateCommands, sizeof(privateCommands) / sizeof(privateCommands[0]));
+
+	taskHandle = xTaskCreateStatic(privateTask, // Function that implements the task.
+									"iperf task", // Text name for the task.
+									IPERF_TASK_STACK_SIZE, // Number of indexes in the xStack array.
+									NULL, // Parameter passed into the task.
+									osPriorityBelowNormal, // Priority at which the task is created.
+									taskStack, // Array to use as the task's stack.
+									&taskBuffer);
+
+	return xResultAccept;
+}
+//==============================================================================
@@ -0,0 +1,77 @@
+//==============================================================================
+//header:
+
+#ifndef _IPERF_COMPONENT_H_
+#define _IPERF_COMPONENT_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Iperf-ComponentConfig.h"
+#include "Abstractions/xPort/xPort.h"
+//==============================================================================
+//types:
+
+typedef enum
+{
+	IperfModeIdle,
+	IperfModeTcpServer,
+	IperfModeUdpServer,
+	IperfModeTcpClient,
+	IperfModeUdpClient
+
+} IperfModeT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	IperfModeT Mode;
+
+	uint32_t Address; //network byte order, client only
+	uint16_t Port;
+
+	uint16_t Length;
+	uint16_t Duration; //seconds, client only
+	uint16_t Interval; //seconds, 0 - final report only
+	uint32_t Bandwidth; //Kbits/sec, UDP client only
+
+	xPortT* ReportPort;
+
+} IperfRequestT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint64_t Bytes;
+	uint32_t Datagrams;
+	uint32_t Lost;
+	uint32_t OutOfOrder;
+	uint32_t Jitter; //us
+
+	uint32_t StartTime;
+	uint32_t LastTime;
+
+} IperfStatisticT;
+//==============================================================================
+//functions:
+
+xResult IperfComponentInit(void* parent);
+
+xResult IperfComponentStart(IperfRequestT* request);
+void IperfComponentStop();
+//==============================================================================
+//override:
+
+#define IperfComponentHandler()
+#define IperfComponentTimeSynchronization()
+//==============================================================================
+//export:
+
+extern IperfStatisticT IperfStatistic;
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_IPERF_COMPONENT_H_
@@ -0,0 +1,45 @@
+//==============================================================================
+//header:
+
+#ifndef _IPERF_COMPONENT_CONFIG_H_
+#define _IPERF_COMPONENT_CONFIG_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+#include "Net/Net-ComponentConfig.h"
+//==============================================================================
+//defines:
+
+#define IPERF_COMPONENT_MAIN_TASK_STACK_SECTION __attribute__((section("._user_heap_stack")))
+#define IPERF_BUFFER_MEM_SECTION __attribute__((section("._user_heap_stack")))
+
+#define IPERF_TASK_STACK_SIZE 0x180
+
+#define IPERF_DEFAULT_PORT 5001
+#define IPERF_DEFAULT_DURATION 10 //seconds
+#define IPERF_DEFAULT_INTERVAL 1 //seconds
+#define IPERF_DEFAULT_UDP_BANDWIDTH 1000 //Kbits/sec, iperf2 default
+#define IPERF_DEFAULT_TCP_LENGTH 1460
+#define IPERF_DEFAULT_UDP_LENGTH 1470
+
+#define IPERF_BUFFER_SIZE 1472
+
+#define IPERF_SOCKET_TIMEOUT 500 //ms
+#define IPERF_UDP_FIN_ATTEMPTS 10
+
+#define IPERF_REPORT_BUFFER_SIZE 128
+//==============================================================================
+//import:
+
+
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_IPERF_COMPONENT_CONFIG_H_
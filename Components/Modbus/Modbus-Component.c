@@ -0,0 +1,578 @@
+//==============================================================================
+//header:
+
+
+//==============================================================================
+//includes:
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Modbus-Component.h"
+#include "Components.h"
+#include "TerminalCommands/TerminalCommands.h"
+#include "UsartDma/UsartDma-Component.h"
+//==============================================================================
+//defines:
+
+#if USART_DMA_ENABLE != 1 || USART_DMA_RS485_ENABLE != 1
+#error "Modbus RTU runs on the RS485 port of the USART DMA component"
+#endif
+
+#if CRC_ENABLE != 1
+#error "the frames are checked by CRC-16/MODBUS of the CRC component"
+#endif
+
+#define MODBUS_REPORT_VALUES 8 //registers in one line of the report
+#define MODBUS_SPEC_SILENCE 1750 //us above 19200 baud
+//==============================================================================
+//variables:
+
+static TaskHandle_t taskHandle;
+static StaticTask_t taskBuffer;
+static StackType_t taskStack[MODBUS_TASK_STACK_SIZE] MODBUS_COMPONENT_MAIN_TASK_STACK_SECTION;
+
+static int RTOS_ModbusTaskStackWaterMark;
+
+//the master is shared by the receive of the USART DMA task and by the Modbus task
+static SemaphoreHandle_t privateMutex;
+static uint32_t privateWakeTime; //the Modbus task checks the timeouts at this time
+
+//the frames are built here when the TX ring has no room for them in one piece
+static uint8_t privateFrame[MODBUS_RTU_ADU_SIZE];
+
+static uint8_t privateCoils[(MODBUS_COILS_COUNT + 7) / 8];
+static uint8_t privateDiscreteInputs[(MODBUS_DISCRETE_INPUTS_COUNT + 7) / 8];
+static uint16_t privateHoldingRegisters[MODBUS_HOLDING_REGISTERS_COUNT];
+static uint16_t privateInputRegisters[MODBUS_INPUT_REGISTERS_COUNT];
+
+//"modbus": the written values and the read ones share the buffers, the frame is built before the response
+static ModbusRequestT privateCommand;
+static uint16_t privateCommandRegisters[MODBUS_MAX_READ_REGISTERS];
+static uint8_t privateCommandBits[(MODBUS_MAX_READ_BITS + 7) / 8];
+static xPortT* privateCommandPort;
+static volatile uint8_t privateCommandIsComplete;
+
+static ModbusBenchRequestT privateBenchRequest;
+static ModbusRequestT privateBenchRequests[MODBUS_BENCH_DEPTH];
+static uint16_t privateBenchRegisters[MODBUS_BENCH_DEPTH][MODBUS_MAX_READ_REGISTERS];
+static uint16_t privateBenchQueued;
+static uint16_t privateBenchDone;
+static uint16_t privateBenchFailed;
+static uint32_t privateBenchStart;
+static uint32_t privateBenchEnd;
+static volatile uint8_t privateBenchIsRunning;
+static volatile uint8_t privateBenchIsComplete;
+
+static char privateReportBuffer[MODBUS_REPORT_BUFFER_SIZE];
+
+ModbusMasterT ModbusMaster;
+ModbusSlaveT ModbusSlave;
+//==============================================================================
+//functions:
+
+static void privateReport(xPortT* port, const char* format, ...)
+{
+	if (!port)
+	{
+		return;
+	}
+
+	va_list args;
+	va_start(args, format);
+	vsnprintf(privateReportBuffer, sizeof(privateReportBuffer), format, args);
+	va_end(args);
+
+	xPortStartTransmission(port);
+	xPortTransmitString(port, privateReportBuffer);
+	xPortEndTransmission(port);
+}
+//------------------------------------------------------------------------------
+/// @brief called between xPortStartTransmission and xPortEndTransmission: privateFrame is taken with the port
+static uint8_t* privateTxReserve()
+{
+	uint8_t* frame = UsartDmaPortAdapterTxReserve(&MODBUS_PORT, MODBUS_RTU_ADU_SIZE);
+
+	return frame ? frame : privateFrame;
+}
+//------------------------------------------------------------------------------
+static void privateTxCommit(uint8_t* frame, uint16_t size)
+{
+	if (!size)
+	{
+		return;
+	}
+
+	if (frame == privateFrame)
+	{
+		xPortTransmitData(&MODBUS_PORT, frame, size);
+	}
+	else
+	{
+		UsartDmaPortAdapterTxCommit(&MODBUS_PORT, size);
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief the oldest request goes to the bus when nothing waits for a response, called with privateMutex
+static void privateMasterStart()
+{
+	if (ModbusMaster.Current || !ModbusMaster.Head)
+	{
+		return;
+	}
+
+	xPortStartTransmission(&MODBUS_PORT);
+
+	uint8_t* frame = privateTxReserve();
+
+	privateTxCommit(frame, ModbusMasterStart(&ModbusMaster, xSystemGetTime(), frame));
+
+	xPortEndTransmission(&MODBUS_PORT);
+
+	//the task sleeps past the new deadline
+	if ((int32_t)(ModbusMaster.Deadline - privateWakeTime) < 0)
+	{
+		xTaskNotifyGive(taskHandle);
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief a frame of the bus, called by the USART DMA task on the silence after it.
+ * A frame while a request waits is its response, the next request goes out from here.
+ * The other frames are requests to the slave, its response is built in the TX ring.
+ */
+static void privateFrameListener(xPortT* port, uint8_t* frame, uint16_t size, void* context)
+{
+	xSemaphoreTake(privateMutex, portMAX_DELAY);
+
+	if (ModbusMaster.Current)
+	{
+		if (ModbusMasterReceive(&ModbusMaster, frame, size) == xResultAccept)
+		{
+			privateMasterStart();
+		}
+	}
+	else if (ModbusSlave.Address)
+	{
+		xPortStartTransmission(port);
+
+		uint8_t* response = privateTxReserve();
+
+		privateTxCommit(response, ModbusSlaveProcess(&ModbusSlave, frame, size, response));
+
+		xPortEndTransmission(port);
+	}
+
+	xSemaphoreGive(privateMutex);
+}
+//------------------------------------------------------------------------------
+static void privateCommandComplete(ModbusRequestT* request)
+{
+	privateCommandIsComplete = true;
+	xTaskNotifyGive(taskHandle);
+}
+//------------------------------------------------------------------------------
+static void privateCommandReport()
+{
+	ModbusRequestT* request = &privateCommand;
+	xPortT* port = privateCommandPort;
+
+	switch ((uint8_t)request->State)
+	{
+		case ModbusRequestException:
+			privateReport(port, "[modbus] slave %u, function %u: exception %u\r", request->Slave, request->Function, request->Exception);
+			return;
+
+		case ModbusRequestTimeout:
+			privateReport(port, "[modbus] slave %u, function %u: timeout\r", request->Slave, request->Function);
+			return;
+
+		case ModbusRequestError:
+			privateReport(port, "[modbus] slave %u, function %u: wrong response\r", request->Slave, request->Function);
+			return;
+	}
+
+	switch ((uint8_t)request->Function)
+	{
+		case ModbusFunctionReadCoils:
+		case ModbusFunctionReadDiscreteInputs:
+		{
+			uint16_t count = request->Count < MODBUS_REPORT_BUFFER_SIZE - 32 ? request->Count : MODBUS_REPORT_BUFFER_SIZE - 32;
+			char bits[MODBUS_REPORT_BUFFER_SIZE - 31];
+
+			for (uint16_t i = 0; i < count; i++)
+			{
+				bits[i] = (request->Bits[i >> 3] & (1 << (i & 7))) ? '1' : '0';
+			}
+
+			bits[count] = 0;
+
+			privateReport(port, "[modbus] %u: %s\r", request->Address, bits);
+		}
+		return;
+
+		case ModbusFunctionReadHoldingRegisters:
+		case ModbusFunctionReadInputRegisters:
+		case ModbusFunctionReadWriteMultipleRegisters:
+		{
+			for (uint16_t i = 0; i < request->Count; i += MODBUS_REPORT_VALUES)
+			{
+				char line[MODBUS_REPORT_VALUES * 7 + 1];
+				uint8_t length = 0;
+
+				for (uint16_t j = i; j < request->Count && j < i + MODBUS_REPORT_VALUES; j++)
+				{
+					length += snprintf(line + length, sizeof(line) - length, " 0x%04x", request->Registers[j]);
+				}
+
+				privateReport(port, "[modbus] %u:%s\r", request->Address + i, line);
+			}
+		}
+		return;
+	}
+
+	privateReport(port, "[modbus] slave %u, function %u: written\r", request->Slave, request->Function);
+}
+//------------------------------------------------------------------------------
+/// @brief runs with privateMutex: from the receive of the response or from the timeout of the task
+static void privateBenchComplete(ModbusRequestT* request)
+{
+	if (request->State == ModbusRequestComplete)
+	{
+		privateBenchDone++;
+	}
+	else
+	{
+		privateBenchFailed++;
+	}
+
+	if (privateBenchQueued < privateBenchRequest.Count)
+	{
+		ModbusMasterSubmit(&ModbusMaster, request);
+		privateBenchQueued++;
+	}
+	else if (privateBenchDone + privateBenchFailed == privateBenchQueued)
+	{
+		privateBenchEnd = xSystemGetTime();
+		privateBenchIsComplete = true;
+
+		xTaskNotifyGive(taskHandle);
+	}
+}
+//------------------------------------------------------------------------------
+static void privateBenchReport()
+{
+	ModbusBenchRequestT* request = &privateBenchRequest;
+	ModbusMasterStatisticT* statistic = &ModbusMaster.Statistic;
+	uint32_t duration = privateBenchEnd - privateBenchStart;
+
+	privateReport(request->ReportPort, "[modbus-bench] %u/%u transactions in %lu ms, %lu transactions/s, %u registers, %lu baud\r",
+					privateBenchDone,
+					request->Count,
+					duration,
+					duration ? (uint32_t)privateBenchDone * 1000 / duration : 0,
+					request->Registers,
+					MODBUS_PORT_ADAPTER.Handle->Init.BaudRate);
+
+	privateReport(request->ReportPort, "[modbus-bench] failed %u: timeouts %lu, exceptions %lu, crc errors %lu, errors %lu\r",
+					privateBenchFailed,
+					statistic->Timeouts,
+					statistic->Exceptions,
+					statistic->CrcErrors,
+					statistic->Errors);
+}
+//------------------------------------------------------------------------------
+static void privateUpdateInputs()
+{
+	uint32_t uptime = xSystemGetTime() / 1000;
+
+	privateInputRegisters[0] = uptime >> 16;
+	privateInputRegisters[1] = uptime;
+	privateInputRegisters[2] = ModbusSlave.Statistic.Requests;
+	privateInputRegisters[3] = ModbusSlave.Statistic.Exceptions;
+}
+//------------------------------------------------------------------------------
+static void privateTask(void* arg)
+{
+	while (true)
+	{
+		RTOS_ModbusTaskStackWaterMark = uxTaskGetStackHighWaterMark(NULL);
+
+		xSemaphoreTake(privateMutex, portMAX_DELAY);
+
+		uint32_t time = xSystemGetTime();
+		uint32_t wait = MODBUS_TASK_PERIOD;
+
+		ModbusMasterHandler(&ModbusMaster, time);
+		privateMasterStart();
+
+		if (ModbusMaster.Current)
+		{
+			int32_t remaining = ModbusMaster.Deadline - time;
+
+			wait = remaining <= 0 ? 1 : (remaining < MODBUS_TASK_PERIOD ? remaining : MODBUS_TASK_PERIOD);
+		}
+
+		privateWakeTime = time + wait;
+
+		if (privateBenchIsRunning && time - privateBenchStart >= MODBUS_BENCH_TIMEOUT)
+		{
+			privateBenchRequest.Count = privateBenchQueued;
+		}
+
+		xSemaphoreGive(privateMutex);
+
+		privateUpdateInputs();
+
+		if (privateCommandIsComplete)
+		{
+			privateCommandIsComplete = false;
+			privateCommandReport();
+		}
+
+		if (privateBenchIsComplete)
+		{
+			privateBenchReport();
+
+			privateBenchIsComplete = false;
+			privateBenchIsRunning = false;
+		}
+
+		ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief queues the request of the master, it goes out at once when the bus waits for nothing.
+ * The completion is called from the USART DMA task or from the Modbus task.
+ */
+xResult ModbusComponentSubmit(ModbusRequestT* request)
+{
+	xSemaphoreTake(privateMutex, portMAX_DELAY);
+
+	xResult result = ModbusMasterSubmit(&ModbusMaster, request);
+
+	if (result == xResultAccept)
+	{
+		privateMasterStart();
+	}
+
+	xSemaphoreGive(privateMutex);
+
+	return result;
+}
+//------------------------------------------------------------------------------
+xResult ModbusComponentBenchStart(ModbusBenchRequestT* request)
+{
+	if (!request || request->Registers > MODBUS_MAX_READ_REGISTERS)
+	{
+		return xResultError;
+	}
+
+	if (privateBenchIsRunning)
+	{
+		return xResultBusy;
+	}
+
+	xSemaphoreTake(privateMutex, portMAX_DELAY);
+
+	privateBenchRequest = *request;
+
+	if (!privateBenchRequest.Count)
+	{
+		privateBenchRequest.Count = MODBUS_BENCH_DEFAULT_COUNT;
+	}
+
+	if (!privateBenchRequest.Registers)
+	{
+		privateBenchRequest.Registers = MODBUS_BENCH_DEFAULT_REGISTERS;
+	}
+
+	memset(&ModbusMaster.Statistic, 0, sizeof(ModbusMaster.Statistic));
+
+	privateBenchQueued = 0;
+	privateBenchDone = 0;
+	privateBenchFailed = 0;
+	privateBenchStart = xSystemGetTime();
+	privateBenchIsRunning = true;
+
+	for (uint8_t i = 0; i < MODBUS_BENCH_DEPTH && privateBenchQueued < privateBenchRequest.Count; i++)
+	{
+		ModbusRequestT* benchRequest = &privateBenchRequests[i];
+
+		memset(benchRequest, 0, sizeof(ModbusRequestT));
+
+		benchRequest->Slave = privateBenchRequest.Slave;
+		benchRequest->Function = ModbusFunctionReadHoldingRegisters;
+		benchRequest->Count = privateBenchRequest.Registers;
+		benchRequest->Registers = privateBenchRegisters[i];
+		benchRequest->Complete = privateBenchComplete;
+
+		ModbusMasterSubmit(&ModbusMaster, benchRequest);
+		privateBenchQueued++;
+	}
+
+	privateMasterStart();
+
+	xSemaphoreGive(privateMutex);
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief "modbus -a slave -f function -r register [-n count] [-v value] [-w register]"
+ * the value is written to all the registers or coils of the write functions, -w is the write of 23
+ */
+static xResult privateTransactionCommand(xPortT* port, TerminalCommandArgumentsT* arguments)
+{
+	if (TerminalCommandCheckOptions(arguments, "afrnvw", NULL) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	ModbusRequestT* request = &privateCommand;
+	uint32_t slave = TerminalCommandGetNumber(arguments, 'a', UINT32_MAX);
+	uint32_t function = TerminalCommandGetNumber(arguments, 'f', 0);
+	uint32_t address = TerminalCommandGetNumber(arguments, 'r', 0);
+	uint32_t count = TerminalCommandGetNumber(arguments, 'n', 1);
+	uint32_t value = TerminalCommandGetNumber(arguments, 'v', 0);
+	uint32_t writeAddress = TerminalCommandGetNumber(arguments, 'w', UINT32_MAX);
+
+	xResult result = xResultError;
+
+	if (slave <= 247 && address <= UINT16_MAX && count && count <= MODBUS_MAX_READ_BITS)
+	{
+		if (request->State == ModbusRequestQueued || request->State == ModbusRequestSent)
+		{
+			result = xResultBusy;
+		}
+		else
+		{
+			memset(request, 0, sizeof(ModbusRequestT));
+
+			request->Slave = slave;
+			request->Function = function;
+			request->Address = address;
+			request->Count = count;
+			request->Bits = privateCommandBits;
+			request->Registers = privateCommandRegisters;
+			request->Complete = privateCommandComplete;
+
+			memset(privateCommandBits, value ? 0xff : 0, sizeof(privateCommandBits));
+
+			for (uint16_t i = 0; i < MODBUS_MAX_READ_REGISTERS; i++)
+			{
+				privateCommandRegisters[i] = value;
+			}
+
+			request->WriteAddress = writeAddress <= UINT16_MAX ? writeAddress : address;
+			request->WriteCount = count;
+			request->WriteRegisters = privateCommandRegisters;
+
+			privateCommandPort = port;
+
+			result = ModbusComponentSubmit(request);
+		}
+	}
+
+	return result;
+}
+//------------------------------------------------------------------------------
+/// @brief "modbus-bench [-a slave] [-n count] [-c registers]"
+static xResult privateBenchCommand(xPortT* port, TerminalCommandArgumentsT* arguments)
+{
+	if (TerminalCommandCheckOptions(arguments, "anc", NULL) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	ModbusBenchRequestT request = { 0 };
+	request.Slave = TerminalCommandGetNumber(arguments, 'a', MODBUS_SLAVE_ADDRESS ? MODBUS_SLAVE_ADDRESS : 1);
+	request.Count = TerminalCommandGetNumber(arguments, 'n', 0);
+	request.Registers = TerminalCommandGetNumber(arguments, 'c', 0);
+	request.ReportPort = port;
+
+	return request.Slave ? ModbusComponentBenchStart(&request) : xResultError;
+}
+//------------------------------------------------------------------------------
+static const TerminalCommandT privateCommands[] =
+{
+	{
+		.Name = "modbus",
+		.Usage = "-a slave -f 1-6|15|16|23 -r register [-n count] [-v value] [-w register]",
+		.Handler = privateTransactionCommand
+	},
+	{
+		.Name = "modbus-bench",
+		.Usage = "[-a slave] [-n count] [-c registers]",
+		.Handler = privateBenchCommand
+	}
+};
+//------------------------------------------------------------------------------
+void ModbusComponentSilenceIRQ()
+{
+	UsartDmaPortAdapterSilenceIRQ(&MODBUS_PORT);
+}
+//==============================================================================
+//initialization:
+
+xResult ModbusComponentInit(void* parent)
+{
+	UART_InitTypeDef* usart = &MODBUS_PORT_ADAPTER.Handle->Init;
+
+	TerminalCommandsAdd(privateCommands, sizeof(privateCommands) / sizeof(privateCommands[0]));
+
+	//start, data, parity and stop bits as the USART is set
+	uint32_t bits = 1 + (usart->WordLength == UART_WORDLENGTH_9B ? 9 : 8) + (usart->StopBits == UART_STOPBITS_2 ? 2 : 1);
+	uint32_t silence = bits * 3500000 / usart->BaudRate;
+
+#if MODBUS_SILENCE_FIXED == 1
+	if (usart->BaudRate > 19200)
+	{
+		silence = MODBUS_SPEC_SILENCE;
+	}
+#endif
+
+	ModbusSlave.Address = MODBUS_SLAVE_ADDRESS;
+	ModbusSlave.Crc = &CrcEngines[CrcVariant16Modbus];
+	ModbusSlave.Map.Coils = privateCoils;
+	ModbusSlave.Map.CoilsCount = MODBUS_COILS_COUNT;
+	ModbusSlave.Map.DiscreteInputs = privateDiscreteInputs;
+	ModbusSlave.Map.DiscreteInputsCount = MODBUS_DISCRETE_INPUTS_COUNT;
+	ModbusSlave.Map.HoldingRegisters = privateHoldingRegisters;
+	ModbusSlave.Map.HoldingRegistersCount = MODBUS_HOLDING_REGISTERS_COUNT;
+	ModbusSlave.Map.InputRegisters = privateInputRegisters;
+	ModbusSlave.Map.InputRegistersCount = MODBUS_INPUT_REGISTERS_COUNT;
+
+	ModbusMasterInitT masterInit =
+	{
+		.Timeout = MODBUS_TIMEOUT,
+		.BroadcastDelay = MODBUS_BROADCAST_DELAY,
+		.ByteTimeUs = bits * 1000000 / usart->BaudRate + 1,
+		.Crc = &CrcEngines[CrcVariant16Modbus]
+	};
+
+	ModbusMasterInit(&ModbusMaster, &masterInit);
+
+	privateMutex = xSemaphoreCreateMutex();
+
+	taskHandle = xTaskCreateStatic(privateTask, // Function that implements the task.
+									"modbus task", // Text name for the task.
+									MODBUS_TASK_STACK_SIZE, // Number of indexes in the xStack array.
+									NULL, // Parameter passed into the task.
+									osPriorityNormal, // Priority at which the task is created.
+									taskStack, // Array to use as the task's stack.
+									&taskBuffer);
+
+	UsartDmaFramingInitT framingInit =
+	{
+		.SilenceTimer = &MODBUS_SILENCE_TIMER,
+		.SilenceUs = silence,
+		.Listener = privateFrameListener
+	};
+
+	return UsartDmaPortAdapterSetFraming(&MODBUS_PORT, &framingInit);
+}
+//==============================================================================
@@ -0,0 +1,53 @@
+//==============================================================================
+//header:
+
+#ifndef _MODBUS_COMPONENT_H_
+#define _MODBUS_COMPONENT_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Modbus-ComponentConfig.h"
+#include "ModbusRtu.h"
+#include "Abstractions/xPort/xPort.h"
+//==============================================================================
+//types:
+
+/// @brief reads of holding registers back to back to measure the transactions per second
+typedef struct
+{
+	uint8_t Slave;
+	uint16_t Count; //0 - MODBUS_BENCH_DEFAULT_COUNT
+	uint16_t Registers; //0 - MODBUS_BENCH_DEFAULT_REGISTERS
+
+	xPortT* ReportPort;
+
+} ModbusBenchRequestT;
+//==============================================================================
+//functions:
+
+xResult ModbusComponentInit(void* parent);
+
+void ModbusComponentSilenceIRQ();
+
+xResult ModbusComponentSubmit(ModbusRequestT* request);
+xResult ModbusComponentBenchStart(ModbusBenchRequestT* request);
+//==============================================================================
+//override:
+
+#define ModbusComponentHandler()
+#define ModbusComponentTimeSynchronization()
+//==============================================================================
+//export:
+
+extern ModbusMasterT ModbusMaster;
+extern ModbusSlaveT ModbusSlave;
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MODBUS_COMPONENT_H_
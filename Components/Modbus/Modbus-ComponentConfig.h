@@ -0,0 +1,52 @@
+//==============================================================================
+//header:
+
+#ifndef _MODBUS_COMPONENT_CONFIG_H_
+#define _MODBUS_COMPONENT_CONFIG_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+#include "main.h"
+//==============================================================================
+//defines:
+
+#define MODBUS_COMPONENT_MAIN_TASK_STACK_SECTION __attribute__((section("._user_heap_stack")))
+
+#define MODBUS_TASK_STACK_SIZE 0x200 //timeouts and reports, the frames are handled in the USART DMA task
+#define MODBUS_TASK_PERIOD 100 //ms without a request on the bus
+
+extern TIM_HandleTypeDef htim6;
+
+#define MODBUS_PORT Rs485Port
+#define MODBUS_PORT_ADAPTER UsartDmaRs485Adapter
+#define MODBUS_SILENCE_TIMER htim6
+
+#define MODBUS_SLAVE_ADDRESS 1 //0 - master only
+#define MODBUS_SILENCE_FIXED 1 //1750 us above 19200 baud as the spec recommends, 0 - 3.5 characters at any baud rate
+
+#define MODBUS_TIMEOUT 100 //ms from the last byte of the request to the response
+#define MODBUS_BROADCAST_DELAY 100 //ms, turnaround of the slaves after a broadcast
+
+//input registers 0-1: uptime in seconds, 2: requests to the slave, 3: its exceptions
+#define MODBUS_COILS_COUNT 64
+#define MODBUS_DISCRETE_INPUTS_COUNT 64
+#define MODBUS_HOLDING_REGISTERS_COUNT 128
+#define MODBUS_INPUT_REGISTERS_COUNT 32
+
+#define MODBUS_BENCH_DEFAULT_COUNT 1000 //transactions of "modbus-bench"
+#define MODBUS_BENCH_DEFAULT_REGISTERS 10
+#define MODBUS_BENCH_DEPTH 4 //requests queued ahead, the next one goes out from the receive of the response
+#define MODBUS_BENCH_TIMEOUT 60000 //ms
+
+#define MODBUS_REPORT_BUFFER_SIZE 128
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MODBUS_COMPONENT_CONFIG_H_
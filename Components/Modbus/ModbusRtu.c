@@ -0,0 +1,738 @@
+//==============================================================================
+//includes:
+
+#include "ModbusRtu.h"
+#include <string.h>
+//==============================================================================
+//functions:
+
+/// @brief the engine of the Crc component is of CrcVariant16Modbus: its tables take several bytes at once
+bool ModbusRtuCrcIsValid(const CrcEngineT* crc)
+{
+	return crc && crc->Parameters == &CrcParameters[CrcVariant16Modbus];
+}
+//------------------------------------------------------------------------------
+/// @brief the CRC goes to the line low byte first, a frame with its CRC gives 0
+uint16_t ModbusRtuCrc(CrcEngineT* crc, const uint8_t* data, uint16_t size)
+{
+	return CrcEngineCalculate(crc, data, size);
+}
+//------------------------------------------------------------------------------
+static inline uint16_t privateGetWord(const uint8_t* data)
+{
+	return (uint16_t)(data[0] << 8) | data[1];
+}
+//------------------------------------------------------------------------------
+static inline uint8_t* privatePutWord(uint8_t* data, uint16_t value)
+{
+	data[0] = value >> 8;
+	data[1] = value;
+
+	return data + 2;
+}
+//------------------------------------------------------------------------------
+/// @return size of the frame with the CRC appended at the end
+static uint16_t privateSeal(CrcEngineT* engine, uint8_t* frame, uint8_t* end)
+{
+	uint16_t size = end - frame;
+	uint16_t crc = ModbusRtuCrc(engine, frame, size);
+
+	end[0] = crc;
+	end[1] = crc >> 8;
+
+	return size + 2;
+}
+//------------------------------------------------------------------------------
+/// @brief count bits from the offset of the source to the beginning of the destination, the rest of the last byte is 0
+static void privateReadBits(uint8_t* destination, const uint8_t* source, uint16_t offset, uint16_t count)
+{
+	uint16_t first = offset >> 3;
+	uint16_t last = (offset + count - 1) >> 3;
+	uint16_t bytes = (count + 7) >> 3;
+	uint8_t shift = offset & 7;
+
+	for (uint16_t i = 0; i < bytes; i++)
+	{
+		uint16_t value = source[first + i] >> shift;
+
+		if (shift && first + i < last)
+		{
+			value |= source[first + i + 1] << (8 - shift);
+		}
+
+		destination[i] = value;
+	}
+
+	if (count & 7)
+	{
+		destination[bytes - 1] &= (1 << (count & 7)) - 1;
+	}
+}
+//------------------------------------------------------------------------------
+static void privateWriteBits(uint8_t* destination, uint16_t offset, const uint8_t* source, uint16_t count)
+{
+	for (uint16_t i = 0; i < count; i++, offset++)
+	{
+		uint8_t mask = 1 << (offset & 7);
+
+		if (source[i >> 3] & (1 << (i & 7)))
+		{
+			destination[offset >> 3] |= mask;
+		}
+		else
+		{
+			destination[offset >> 3] &= ~mask;
+		}
+	}
+}
+//------------------------------------------------------------------------------
+static inline bool privateIsInRange(uint16_t address, uint16_t count, uint16_t total)
+{
+	return (uint32_t)address + count <= total;
+}
+//------------------------------------------------------------------------------
+static void privateNotifyWrite(ModbusSlaveT* slave, ModbusFunctionT function, uint16_t address, uint16_t count)
+{
+	if (slave->WriteListener)
+	{
+		slave->WriteListener(slave->Context, function, address, count);
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the response is written field by field after the request was decoded and applied,
+ * response may be the request itself. The registers go from the map straight into it.
+ * @return size of the response, 0 - none: no CRC engine, the CRC is wrong, the frame is for another slave or a broadcast
+ */
+uint16_t ModbusSlaveProcess(ModbusSlaveT* slave, uint8_t* request, uint16_t size, uint8_t* response)
+{
+	ModbusRegisterMapT* map = &slave->Map;
+
+	if (!ModbusRtuCrcIsValid(slave->Crc))
+	{
+		return 0;
+	}
+
+	if (size < 4 || ModbusRtuCrc(slave->Crc, request, size))
+	{
+		slave->Statistic.CrcErrors++;
+		return 0;
+	}
+
+	uint8_t address = request[0];
+	uint8_t function = request[1];
+
+	if (address != slave->Address && address != MODBUS_BROADCAST_ADDRESS)
+	{
+		slave->Statistic.Ignored++;
+		return 0;
+	}
+
+	bool isBroadcast = address == MODBUS_BROADCAST_ADDRESS;
+	bool isRead = function <= ModbusFunctionReadInputRegisters || function == ModbusFunctionReadWriteMultipleRegisters;
+
+	//the reads have nobody to answer to
+	if (isBroadcast && isRead)
+	{
+		slave->Statistic.Ignored++;
+		return 0;
+	}
+
+	slave->Statistic.Requests++;
+	slave->Statistic.Broadcasts += isBroadcast;
+
+	uint16_t first = size >= 8 ? privateGetWord(request + 2) : 0;
+	uint16_t count = size >= 8 ? privateGetWord(request + 4) : 0;
+	uint8_t bytes = size >= 9 ? request[6] : 0;
+
+	ModbusExceptionT exception = ModbusExceptionNone;
+	uint8_t* end = response + 2;
+
+	switch (function)
+	{
+		case ModbusFunctionReadCoils:
+		case ModbusFunctionReadDiscreteInputs:
+		{
+			const uint8_t* bits = function == ModbusFunctionReadCoils ? map->Coils : map->DiscreteInputs;
+			uint16_t total = function == ModbusFunctionReadCoils ? map->CoilsCount : map->DiscreteInputsCount;
+
+			if (size != 8 || !count || count > MODBUS_MAX_READ_BITS)
+			{
+				exception = ModbusExceptionIllegalDataValue;
+			}
+			else if (!bits || !privateIsInRange(first, count, total))
+			{
+				exception = ModbusExceptionIllegalDataAddress;
+			}
+			else
+			{
+				*end++ = (count + 7) >> 3;
+
+				privateReadBits(end, bits, first, count);
+				end += (count + 7) >> 3;
+			}
+		}
+		break;
+
+		case ModbusFunctionReadHoldingRegisters:
+		case ModbusFunctionReadInputRegisters:
+		{
+			const uint16_t* registers = function == ModbusFunctionReadHoldingRegisters ? map->HoldingRegisters : map->InputRegisters;
+			uint16_t total = function == ModbusFunctionReadHoldingRegisters ? map->HoldingRegistersCount : map->InputRegistersCount;
+
+			if (size != 8 || !count || count > MODBUS_MAX_READ_REGISTERS)
+			{
+				exception = ModbusExceptionIllegalDataValue;
+			}
+			else if (!registers || !privateIsInRange(first, count, total))
+			{
+				exception = ModbusExceptionIllegalDataAddress;
+			}
+			else
+			{
+				*end++ = count * 2;
+
+				for (uint16_t i = 0; i < count; i++)
+				{
+					end = privatePutWord(end, registers[first + i]);
+				}
+			}
+		}
+		break;
+
+		case ModbusFunctionWriteSingleCoil:
+		{
+			if (size != 8 || (count != 0xff00 && count != 0))
+			{
+				exception = ModbusExceptionIllegalDataValue;
+			}
+			else if (!map->Coils || first >= map->CoilsCount)
+			{
+				exception = ModbusExceptionIllegalDataAddress;
+			}
+			else
+			{
+				uint8_t value = count ? 1 : 0;
+
+				privateWriteBits(map->Coils, first, &value, 1);
+				privateNotifyWrite(slave, function, first, 1);
+
+				//the response is the request
+				memmove(response, request, 6);
+				end = response + 6;
+			}
+		}
+		break;
+
+		case ModbusFunctionWriteSingleRegister:
+		{
+			if (size != 8)
+			{
+				exception = ModbusExceptionIllegalDataValue;
+			}
+			else if (!map->HoldingRegisters || first >= map->HoldingRegistersCount)
+			{
+				exception = ModbusExceptionIllegalDataAddress;
+			}
+			else
+			{
+				map->HoldingRegisters[first] = count;
+				privateNotifyWrite(slave, function, first, 1);
+
+				memmove(response, request, 6);
+				end = response + 6;
+			}
+		}
+		break;
+
+		case ModbusFunctionWriteMultipleCoils:
+		{
+			if (size < 9 || !count || count > MODBUS_MAX_WRITE_BITS || bytes != (count + 7) >> 3 || size != 9 + bytes)
+			{
+				exception = ModbusExceptionIllegalDataValue;
+			}
+			else if (!map->Coils || !privateIsInRange(first, count, map->CoilsCount))
+			{
+				exception = ModbusExceptionIllegalDataAddress;
+			}
+			else
+			{
+				privateWriteBits(map->Coils, first, request + 7, count);
+				privateNotifyWrite(slave, function, first, count);
+
+				//address and quantity of the request
+				memmove(response, request, 6);
+				end = response + 6;
+			}
+		}
+		break;
+
+		case ModbusFunctionWriteMultipleRegisters:
+		{
+			if (size < 9 || !count || count > MODBUS_MAX_WRITE_REGISTERS || bytes != count * 2 || size != 9 + bytes)
+			{
+				exception = ModbusExceptionIllegalDataValue;
+			}
+			else if (!map->HoldingRegisters || !privateIsInRange(first, count, map->HoldingRegistersCount))
+			{
+				exception = ModbusExceptionIllegalDataAddress;
+			}
+			else
+			{
+				for (uint16_t i = 0; i < count; i++)
+				{
+					map->HoldingRegisters[first + i] = privateGetWord(request + 7 + i * 2);
+				}
+
+				privateNotifyWrite(slave, function, first, count);
+
+				memmove(response, request, 6);
+				end = response + 6;
+			}
+		}
+		break;
+
+		case ModbusFunctionReadWriteMultipleRegisters:
+		{
+			uint16_t writeFirst = size >= 13 ? privateGetWord(request + 6) : 0;
+			uint16_t writeCount = size >= 13 ? privateGetWord(request + 8) : 0;
+
+			bytes = size >= 13 ? request[10] : 0;
+
+			if (size < 13
+				|| !count || count > MODBUS_MAX_READ_REGISTERS
+				|| !writeCount || writeCount > MODBUS_MAX_READ_WRITE_REGISTERS
+				|| bytes != writeCount * 2 || size != 13 + bytes)
+			{
+				exception = ModbusExceptionIllegalDataValue;
+			}
+			else if (!map->HoldingRegisters
+					|| !privateIsInRange(first, count, map->HoldingRegistersCount)
+					|| !privateIsInRange(writeFirst, writeCount, map->HoldingRegistersCount))
+			{
+				exception = ModbusExceptionIllegalDataAddress;
+			}
+			else
+			{
+				//the write goes first, the read returns the written values
+				for (uint16_t i = 0; i < writeCount; i++)
+				{
+					map->HoldingRegisters[writeFirst + i] = privateGetWord(request + 11 + i * 2);
+				}
+
+				privateNotifyWrite(slave, function, writeFirst, writeCount);
+
+				*end++ = count * 2;
+
+				for (uint16_t i = 0; i < count; i++)
+				{
+					end = privatePutWord(end, map->HoldingRegisters[first + i]);
+				}
+			}
+		}
+		break;
+
+		default:
+			exception = ModbusExceptionIllegalFunction;
+			break;
+	}
+
+	if (exception)
+	{
+		slave->Statistic.Exceptions++;
+
+		function |= 0x80;
+		end = response + 2;
+		*end++ = exception;
+	}
+
+	if (isBroadcast)
+	{
+		return 0;
+	}
+
+	response[0] = slave->Address;
+	response[1] = function;
+
+	return privateSeal(slave->Crc, response, end);
+}
+//------------------------------------------------------------------------------
+static bool privateRequestIsValid(ModbusRequestT* request)
+{
+	bool isBroadcast = request->Slave == MODBUS_BROADCAST_ADDRESS;
+
+	switch ((uint8_t)request->Function)
+	{
+		case ModbusFunctionReadCoils:
+		case ModbusFunctionReadDiscreteInputs:
+			return !isBroadcast && request->Bits && request->Count && request->Count <= MODBUS_MAX_READ_BITS;
+
+		case ModbusFunctionReadHoldingRegisters:
+		case ModbusFunctionReadInputRegisters:
+			return !isBroadcast && request->Registers && request->Count && request->Count <= MODBUS_MAX_READ_REGISTERS;
+
+		case ModbusFunctionWriteSingleCoil:
+			return request->Bits != NULL;
+
+		case ModbusFunctionWriteSingleRegister:
+			return request->Registers != NULL;
+
+		case ModbusFunctionWriteMultipleCoils:
+			return request->Bits && request->Count && request->Count <= MODBUS_MAX_WRITE_BITS;
+
+		case ModbusFunctionWriteMultipleRegisters:
+			return request->Registers && request->Count && request->Count <= MODBUS_MAX_WRITE_REGISTERS;
+
+		case ModbusFunctionReadWriteMultipleRegisters:
+			return !isBroadcast
+					&& request->Registers && request->Count && request->Count <= MODBUS_MAX_READ_REGISTERS
+					&& request->WriteRegisters && request->WriteCount && request->WriteCount <= MODBUS_MAX_READ_WRITE_REGISTERS;
+	}
+
+	return false;
+}
+//------------------------------------------------------------------------------
+static uint32_t privateGetTimeout(ModbusMasterT* master, ModbusRequestT* request)
+{
+	if (request->Slave == MODBUS_BROADCAST_ADDRESS)
+	{
+		return master->BroadcastDelay;
+	}
+
+	if (request->Timeout)
+	{
+		return request->Timeout;
+	}
+
+	for (uint8_t i = 0; i < MODBUS_MASTER_SLAVE_TIMEOUTS; i++)
+	{
+		if (master->Timeouts[i].Timeout && master->Timeouts[i].Slave == request->Slave)
+		{
+			return master->Timeouts[i].Timeout;
+		}
+	}
+
+	return master->Timeout;
+}
+//------------------------------------------------------------------------------
+static void privateComplete(ModbusMasterT* master, ModbusRequestT* request, ModbusRequestStateT state)
+{
+	master->Current = NULL;
+	request->State = state;
+
+	if (request->Complete)
+	{
+		request->Complete(request);
+	}
+}
+//------------------------------------------------------------------------------
+static bool privateParseResponse(ModbusRequestT* request, const uint8_t* frame, uint16_t size)
+{
+	uint8_t bytes = frame[2];
+
+	if (frame[1] != request->Function)
+	{
+		return false;
+	}
+
+	switch ((uint8_t)request->Function)
+	{
+		case ModbusFunctionReadCoils:
+		case ModbusFunctionReadDiscreteInputs:
+		{
+			if (bytes != (request->Count + 7) >> 3 || size != 5 + bytes)
+			{
+				return false;
+			}
+
+			memcpy(request->Bits, frame + 3, bytes);
+		}
+		return true;
+
+		case ModbusFunctionReadHoldingRegisters:
+		case ModbusFunctionReadInputRegisters:
+		case ModbusFunctionReadWriteMultipleRegisters:
+		{
+			if (bytes != request->Count * 2 || size != 5 + bytes)
+			{
+				return false;
+			}
+
+			for (uint16_t i = 0; i < request->Count; i++)
+			{
+				request->Registers[i] = privateGetWord(frame + 3 + i * 2);
+			}
+		}
+		return true;
+
+		case ModbusFunctionWriteSingleCoil:
+			return size == 8
+					&& privateGetWord(frame + 2) == request->Address
+					&& privateGetWord(frame + 4) == ((request->Bits[0] & 1) ? 0xff00 : 0);
+
+		case ModbusFunctionWriteSingleRegister:
+			return size == 8
+					&& privateGetWord(frame + 2) == request->Address
+					&& privateGetWord(frame + 4) == request->Registers[0];
+
+		case ModbusFunctionWriteMultipleCoils:
+		case ModbusFunctionWriteMultipleRegisters:
+			return size == 8
+					&& privateGetWord(frame + 2) == request->Address
+					&& privateGetWord(frame + 4) == request->Count;
+	}
+
+	return false;
+}
+//------------------------------------------------------------------------------
+/// @return xResultBusy - the request waits in the queue or on the bus
+xResult ModbusMasterSubmit(ModbusMasterT* master, ModbusRequestT* request)
+{
+	if (!master || !master->Crc || !request || !privateRequestIsValid(request))
+	{
+		return xResultError;
+	}
+
+	if (request->State == ModbusRequestQueued || request->State == ModbusRequestSent)
+	{
+		return xResultBusy;
+	}
+
+	request->State = ModbusRequestQueued;
+	request->Exception = ModbusExceptionNone;
+	request->Next = NULL;
+
+	if (master->Tail)
+	{
+		master->Tail->Next = request;
+	}
+	else
+	{
+		master->Head = request;
+	}
+
+	master->Tail = request;
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the oldest request goes to the bus when nothing waits for a response,
+ * its timeout starts after the last byte of the frame.
+ * @return size of the frame built at frame, 0 - nothing to send
+ */
+uint16_t ModbusMasterStart(ModbusMasterT* master, uint32_t time, uint8_t* frame)
+{
+	ModbusRequestT* request = master->Head;
+
+	if (master->Current || !request)
+	{
+		return 0;
+	}
+
+	master->Head = request->Next;
+
+	if (!master->Head)
+	{
+		master->Tail = NULL;
+	}
+
+	request->Next = NULL;
+
+	uint8_t* end = frame;
+
+	*end++ = request->Slave;
+	*end++ = request->Function;
+
+	end = privatePutWord(end, request->Address);
+
+	switch ((uint8_t)request->Function)
+	{
+		case ModbusFunctionWriteSingleCoil:
+			end = privatePutWord(end, (request->Bits[0] & 1) ? 0xff00 : 0);
+			break;
+
+		case ModbusFunctionWriteSingleRegister:
+			end = privatePutWord(end, request->Registers[0]);
+			break;
+
+		case ModbusFunctionWriteMultipleCoils:
+		{
+			uint8_t bytes = (request->Count + 7) >> 3;
+
+			end = privatePutWord(end, request->Count);
+			*end++ = bytes;
+
+			privateReadBits(end, request->Bits, 0, request->Count);
+			end += bytes;
+		}
+		break;
+
+		case ModbusFunctionWriteMultipleRegisters:
+		{
+			end = privatePutWord(end, request->Count);
+			*end++ = request->Count * 2;
+
+			for (uint16_t i = 0; i < request->Count; i++)
+			{
+				end = privatePutWord(end, request->Registers[i]);
+			}
+		}
+		break;
+
+		case ModbusFunctionReadWriteMultipleRegisters:
+		{
+			end = privatePutWord(end, request->Count);
+			end = privatePutWord(end, request->WriteAddress);
+			end = privatePutWord(end, request->WriteCount);
+			*end++ = request->WriteCount * 2;
+
+			for (uint16_t i = 0; i < request->WriteCount; i++)
+			{
+				end = privatePutWord(end, request->WriteRegisters[i]);
+			}
+		}
+		break;
+
+		default:
+			end = privatePutWord(end, request->Count);
+			break;
+	}
+
+	uint16_t size = privateSeal(master->Crc, frame, end);
+
+	request->State = ModbusRequestSent;
+
+	master->Current = request;
+	master->Deadline = time + privateGetTimeout(master, request) + (size * master->ByteTimeUs + 999) / 1000;
+	master->Statistic.Requests++;
+
+	return size;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief completes the current request with the frame
+ * @return xResultAccept - the frame was the response, xResultNotSupported - of another slave
+ * or nothing was sent, xResultError - the CRC is wrong, the request still waits
+ */
+xResult ModbusMasterReceive(ModbusMasterT* master, const uint8_t* frame, uint16_t size)
+{
+	ModbusRequestT* request = master->Current;
+
+	if (!master->Crc)
+	{
+		return xResultNotSupported;
+	}
+
+	if (size < 4 || ModbusRtuCrc(master->Crc, frame, size))
+	{
+		master->Statistic.CrcErrors++;
+		return xResultError;
+	}
+
+	if (!request || request->Slave == MODBUS_BROADCAST_ADDRESS || frame[0] != request->Slave)
+	{
+		master->Statistic.Unexpected++;
+		return xResultNotSupported;
+	}
+
+	if (frame[1] == (request->Function | 0x80) && size == 5)
+	{
+		master->Statistic.Exceptions++;
+		request->Exception = frame[2];
+
+		privateComplete(master, request, ModbusRequestException);
+	}
+	else if (privateParseResponse(request, frame, size))
+	{
+		master->Statistic.Responses++;
+
+		privateComplete(master, request, ModbusRequestComplete);
+	}
+	else
+	{
+		master->Statistic.Errors++;
+
+		privateComplete(master, request, ModbusRequestError);
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/// @brief the timeout of the current request, a broadcast completes after its delay
+void ModbusMasterHandler(ModbusMasterT* master, uint32_t time)
+{
+	ModbusRequestT* request = master->Current;
+
+	if (!request || (int32_t)(time - master->Deadline) < 0)
+	{
+		return;
+	}
+
+	if (request->Slave == MODBUS_BROADCAST_ADDRESS)
+	{
+		privateComplete(master, request, ModbusRequestComplete);
+		return;
+	}
+
+	master->Statistic.Timeouts++;
+
+	privateComplete(master, request, ModbusRequestTimeout);
+}
+//------------------------------------------------------------------------------
+/// @brief 0 - the slave takes the default timeout again
+xResult ModbusMasterSetTimeout(ModbusMasterT* master, uint8_t slave, uint16_t timeout)
+{
+	ModbusSlaveTimeoutT* free = NULL;
+
+	for (uint8_t i = 0; i < MODBUS_MASTER_SLAVE_TIMEOUTS; i++)
+	{
+		ModbusSlaveTimeoutT* entry = &master->Timeouts[i];
+
+		if (entry->Timeout && entry->Slave == slave)
+		{
+			entry->Timeout = timeout;
+			return xResultAccept;
+		}
+
+		if (!entry->Timeout && !free)
+		{
+			free = entry;
+		}
+	}
+
+	if (!timeout)
+	{
+		return xResultAccept;
+	}
+
+	if (!free)
+	{
+		return xResultBusy;
+	}
+
+	free->Slave = slave;
+	free->Timeout = timeout;
+
+	return xResultAccept;
+}
+//==============================================================================
+//initialization:
+
+xResult ModbusMasterInit(ModbusMasterT* master, ModbusMasterInitT* init)
+{
+	if (!master || !init || !ModbusRtuCrcIsValid(init->Crc))
+	{
+		return xResultError;
+	}
+
+	memset(master, 0, sizeof(ModbusMasterT));
+
+	master->Timeout = init->Timeout;
+	master->BroadcastDelay = init->BroadcastDelay;
+	master->ByteTimeUs = init->ByteTimeUs;
+	master->Crc = init->Crc;
+
+	return xResultAccept;
+}
+//==============================================================================
@@ -0,0 +1,221 @@
+//==============================================================================
+//header:
+
+#ifndef _MODBUS_RTU_H_
+#define _MODBUS_RTU_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+#include "Crc/Crc.h"
+//==============================================================================
+//defines:
+
+#define MODBUS_RTU_ADU_SIZE 256 //address, PDU and CRC
+#define MODBUS_BROADCAST_ADDRESS 0
+
+#define MODBUS_MAX_READ_BITS 2000
+#define MODBUS_MAX_READ_REGISTERS 125
+#define MODBUS_MAX_WRITE_BITS 1968
+#define MODBUS_MAX_WRITE_REGISTERS 123
+#define MODBUS_MAX_READ_WRITE_REGISTERS 121 //written registers of the function 23
+
+#ifndef MODBUS_MASTER_SLAVE_TIMEOUTS
+#define MODBUS_MASTER_SLAVE_TIMEOUTS 8 //slaves with their own response timeout
+#endif
+//==============================================================================
+//types:
+
+typedef enum
+{
+	ModbusFunctionReadCoils = 1,
+	ModbusFunctionReadDiscreteInputs = 2,
+	ModbusFunctionReadHoldingRegisters = 3,
+	ModbusFunctionReadInputRegisters = 4,
+	ModbusFunctionWriteSingleCoil = 5,
+	ModbusFunctionWriteSingleRegister = 6,
+	ModbusFunctionWriteMultipleCoils = 15,
+	ModbusFunctionWriteMultipleRegisters = 16,
+	ModbusFunctionReadWriteMultipleRegisters = 23
+
+} ModbusFunctionT;
+//------------------------------------------------------------------------------
+typedef enum
+{
+	ModbusExceptionNone,
+	ModbusExceptionIllegalFunction,
+	ModbusExceptionIllegalDataAddress,
+	ModbusExceptionIllegalDataValue,
+	ModbusExceptionServerDeviceFailure
+
+} ModbusExceptionT;
+//------------------------------------------------------------------------------
+/// @brief the bits are packed as on the line: the first one is the lowest bit of the first byte
+typedef struct
+{
+	uint8_t* Coils;
+	uint16_t CoilsCount;
+
+	const uint8_t* DiscreteInputs;
+	uint16_t DiscreteInputsCount;
+
+	uint16_t* HoldingRegisters;
+	uint16_t HoldingRegistersCount;
+
+	const uint16_t* InputRegisters;
+	uint16_t InputRegistersCount;
+
+} ModbusRegisterMapT;
+//------------------------------------------------------------------------------
+/// @brief coils or holding registers were written by the master
+typedef void (*ModbusWriteListenerT)(void* context, ModbusFunctionT function, uint16_t address, uint16_t count);
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Requests; //addressed to the slave, broadcasts included
+	uint32_t Broadcasts;
+	uint32_t Exceptions;
+	uint32_t CrcErrors;
+	uint32_t Ignored; //other addresses
+
+} ModbusSlaveStatisticT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint8_t Address;
+	ModbusRegisterMapT Map;
+
+	CrcEngineT* Crc; //CRC-16/MODBUS of the Crc component, 0 - no frame is processed
+
+	ModbusWriteListenerT WriteListener;
+	void* Context;
+
+	ModbusSlaveStatisticT Statistic;
+
+} ModbusSlaveT;
+//------------------------------------------------------------------------------
+typedef enum
+{
+	ModbusRequestIdle,
+	ModbusRequestQueued,
+	ModbusRequestSent,
+	ModbusRequestComplete,
+	ModbusRequestException, //Exception holds the code of the slave
+	ModbusRequestTimeout,
+	ModbusRequestError //response of another function or of a wrong size
+
+} ModbusRequestStateT;
+//------------------------------------------------------------------------------
+typedef struct ModbusRequestT ModbusRequestT;
+
+/// @brief called once for each submitted request, the request may be submitted again from it
+typedef void (*ModbusCompleteT)(ModbusRequestT* request);
+//------------------------------------------------------------------------------
+/**
+ * @brief one transaction of the master, the buffers stay with the caller until the completion.
+ * Address and Count describe the read of the functions 1-4 and 23 and the write of 5, 6, 15, 16.
+ * Bits: coils of 1, 2, 5, 15. Registers: registers of 3, 4, 6, 16 and the read of 23.
+ */
+struct ModbusRequestT
+{
+	uint8_t Slave;
+	ModbusFunctionT Function;
+
+	uint16_t Address;
+	uint16_t Count;
+
+	uint8_t* Bits;
+	uint16_t* Registers;
+
+	uint16_t WriteAddress; //function 23
+	uint16_t WriteCount;
+	const uint16_t* WriteRegisters;
+
+	uint32_t Timeout; //ms, 0 - the timeout of the slave
+
+	ModbusCompleteT Complete;
+	void* Context;
+
+	ModbusRequestStateT State;
+	uint8_t Exception;
+
+	ModbusRequestT* Next;
+};
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint8_t Slave;
+	uint16_t Timeout; //ms
+
+} ModbusSlaveTimeoutT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Requests; //frames sent
+	uint32_t Responses;
+	uint32_t Exceptions;
+	uint32_t Timeouts;
+	uint32_t Errors; //responses that don't match the request
+	uint32_t CrcErrors;
+	uint32_t Unexpected; //frames of other slaves or without a request
+
+} ModbusMasterStatisticT;
+//------------------------------------------------------------------------------
+/**
+ * @brief the requests wait in a queue, one of them is on the bus. The next frame is built
+ * by the caller right after the completion, in the context of the receive.
+ */
+typedef struct
+{
+	ModbusRequestT* Head;
+	ModbusRequestT* Tail;
+
+	ModbusRequestT* Current; //sent, waits for the response
+	uint32_t Deadline;
+
+	uint32_t Timeout; //ms, default of the slaves
+	uint32_t BroadcastDelay; //ms, turnaround of the slaves after a broadcast
+	uint32_t ByteTimeUs; //the frame is on the line before its timeout starts
+
+	ModbusSlaveTimeoutT Timeouts[MODBUS_MASTER_SLAVE_TIMEOUTS];
+
+	CrcEngineT* Crc;
+
+	ModbusMasterStatisticT Statistic;
+
+} ModbusMasterT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Timeout;
+	uint32_t BroadcastDelay;
+	uint32_t ByteTimeUs;
+
+	CrcEngineT* Crc; //CRC-16/MODBUS of the Crc component
+
+} ModbusMasterInitT;
+//==============================================================================
+//functions:
+
+bool ModbusRtuCrcIsValid(const CrcEngineT* crc);
+uint16_t ModbusRtuCrc(CrcEngineT* crc, const uint8_t* data, uint16_t size);
+
+uint16_t ModbusSlaveProcess(ModbusSlaveT* slave, uint8_t* request, uint16_t size, uint8_t* response);
+
+xResult ModbusMasterInit(ModbusMasterT* master, ModbusMasterInitT* init);
+xResult ModbusMasterSetTimeout(ModbusMasterT* master, uint8_t slave, uint16_t timeout);
+
+xResult ModbusMasterSubmit(ModbusMasterT* master, ModbusRequestT* request);
+uint16_t ModbusMasterStart(ModbusMasterT* master, uint32_t time, uint8_t* frame);
+xResult ModbusMasterReceive(ModbusMasterT* master, const uint8_t* frame, uint16_t size);
+void ModbusMasterHandler(ModbusMasterT* master, uint32_t time);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MODBUS_RTU_H_
@@ -0,0 +1,780 @@
+//==============================================================================
+//header:
+
+
+//==============================================================================
+//includes:
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "MqttBench-Component.h"
+#include "Components.h"
+#include "TerminalCommands/TerminalCommands.h"
+#include "main.h"
+#include "MqttBroker/MqttBroker.h"
+#include "FreeRTOS-Plus-MQTT/include/core_mqtt.h"
+#if MQTT_BENCH_PAHO_ENABLE == 1
+#include "MQTTClient.h"
+#endif
+#include "MqttClient/MqttClient-Component.h"
+#include "MqttClient/Adapters/Ports/MqttPort-Selector.h"
+//==============================================================================
+//defines:
+
+#define MQTT_BENCH_PAYLOAD_HEADER_SIZE 8 //cycle counter of the publish and the sequence number
+
+#define MQTT_BENCH_QOS_RECORDS 4 //in-flight QoS1 records of coreMQTT
+#define MQTT_BENCH_DRAIN_LIMIT 64 //packets read from the pipe after each request
+
+#if MQTT_TARGET_LAYOUT == MQTT_FREERTOS_LAYOUT
+#define MQTT_BENCH_PORT_ENGINE_NAME "port/coreMQTT"
+#elif MQTT_TARGET_LAYOUT == MQTT_PAHO_LAYOUT
+#define MQTT_BENCH_PORT_ENGINE_NAME "port/Paho"
+#else
+#define MQTT_BENCH_PORT_ENGINE_NAME "port/lwIP"
+#endif
+//==============================================================================
+//types:
+
+/// @brief bytes from the broker to the client. The broker sends whole packets into the
+/// ring, the client sends its packets straight into the broker: the exchange is synchronous
+typedef struct
+{
+	uint8_t Buffer[MQTT_BENCH_PIPE_SIZE];
+	uint16_t Head;
+	uint16_t Count;
+	uint16_t Peak;
+
+	uint8_t Session;
+
+} MqttBenchPipeT;
+//==============================================================================
+//prototypes:
+
+#if MQTT_BENCH_PAHO_ENABLE == 1
+//one read of MQTTClient with the keep-alive, not declared by MQTTClient.h
+int cycle(MQTTClient* c, MQTTTimerT* timer);
+#endif
+//==============================================================================
+//variables:
+
+static TaskHandle_t taskHandle;
+static StaticTask_t taskBuffer;
+static StackType_t taskStack[MQTT_BENCH_TASK_STACK_SIZE] MQTT_BENCH_COMPONENT_MAIN_TASK_STACK_SECTION;
+
+static char privateReportBuffer[MQTT_BENCH_REPORT_BUFFER_SIZE];
+
+static MqttBrokerT privateBroker;
+static MqttBrokerSessionT privateBrokerSessions[MQTT_BENCH_BROKER_SESSIONS];
+static uint8_t privateBrokerMemory[MQTT_BENCH_PACKET_SIZE * (MQTT_BENCH_BROKER_SESSIONS + 1)];
+
+static MqttBenchPipeT privatePipe;
+
+//shared by the engines, they run one after another
+static uint8_t privateClientBuffer[MQTT_BENCH_PACKET_SIZE];
+static uint8_t privateClientReadBuffer[MQTT_BENCH_PACKET_SIZE];
+static uint8_t privatePayload[MQTT_BENCH_PACKET_SIZE / 2];
+
+static MQTTContext_t privateCoreContext;
+static MQTTPubAckInfo_t privateCoreOutgoingRecords[MQTT_BENCH_QOS_RECORDS];
+static MQTTPubAckInfo_t privateCoreIncomingRecords[MQTT_BENCH_QOS_RECORDS];
+
+#if MQTT_BENCH_PAHO_ENABLE == 1
+static MQTTClient privatePahoClient;
+static MQTTNetworkT privatePahoNetwork;
+#endif
+
+static uint32_t privateSamples[MQTT_BENCH_MAX_SAMPLES]; //latencies in cycles
+static uint16_t privateSamplesCount;
+static MqttBenchResultT* privateResult;
+
+static MqttBenchRequestT privateRequest;
+static volatile uint8_t privateIsBusy;
+
+static int RTOS_MqttBenchTaskStackWaterMark;
+
+MqttBenchResultT MqttBenchResult[MqttBenchEngineCount];
+//==============================================================================
+//functions:
+
+static void privateReport(const char* format, ...)
+{
+	xPortT* port = privateRequest.ReportPort;
+
+	if (!port)
+	{
+		return;
+	}
+
+	va_list args;
+	va_start(args, format);
+	vsnprintf(privateReportBuffer, sizeof(privateReportBuffer), format, args);
+	va_end(args);
+
+	xPortStartTransmission(port);
+	xPortTransmitString(port, privateReportBuffer);
+	xPortEndTransmission(port);
+}
+//------------------------------------------------------------------------------
+static inline uint32_t privateCyclesToUs(uint64_t cycles)
+{
+	return cycles / (SystemCoreClock / 1000000);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief MqttBrokerSendT of the bench session: a packet that doesn't fit the ring is dropped whole.
+ */
+static int32_t privatePipeWrite(void* context, const void* data, uint32_t size)
+{
+	MqttBenchPipeT* pipe = context;
+
+	if (size > sizeof(pipe->Buffer) - pipe->Count)
+	{
+		return 0;
+	}
+
+	const uint8_t* source = data;
+	uint16_t tail = (pipe->Head + pipe->Count) % sizeof(pipe->Buffer);
+
+	for (uint32_t i = 0; i < size; i++)
+	{
+		pipe->Buffer[tail] = source[i];
+		tail = (tail + 1) % sizeof(pipe->Buffer);
+	}
+
+	pipe->Count += size;
+
+	if (pipe->Count > pipe->Peak)
+	{
+		pipe->Peak = pipe->Count;
+	}
+
+	return size;
+}
+//------------------------------------------------------------------------------
+static int32_t privatePipeRead(MqttBenchPipeT* pipe, void* data, uint32_t size)
+{
+	uint8_t* destination = data;
+
+	if (size > pipe->Count)
+	{
+		size = pipe->Count;
+	}
+
+	for (uint32_t i = 0; i < size; i++)
+	{
+		destination[i] = pipe->Buffer[pipe->Head];
+		pipe->Head = (pipe->Head + 1) % sizeof(pipe->Buffer);
+	}
+
+	pipe->Count -= size;
+
+	return size;
+}
+//------------------------------------------------------------------------------
+static xResult privatePipeOpen()
+{
+	MqttBrokerInitT init =
+	{
+		.Sessions = privateBrokerSessions,
+		.SessionsSize = MQTT_BENCH_BROKER_SESSIONS,
+		.Memory = privateBrokerMemory,
+		.MemorySize = sizeof(privateBrokerMemory),
+		.PacketSize = MQTT_BENCH_PACKET_SIZE
+	};
+
+	memset(&privatePipe, 0, sizeof(privatePipe));
+
+	if (MqttBrokerInit(&privateBroker, &init) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	return MqttBrokerOpen(&privateBroker, privatePipeWrite, &privatePipe, &privatePipe.Session);
+}
+//------------------------------------------------------------------------------
+static int32_t privatePipeSend(const void* data, uint32_t size)
+{
+	return MqttBrokerReceive(&privateBroker, privatePipe.Session, data, size) == xResultAccept ? (int32_t)size : -1;
+}
+//------------------------------------------------------------------------------
+static void privatePayloadFill(uint32_t sequence)
+{
+	uint32_t cycles = DWT->CYCCNT;
+
+	memcpy(privatePayload, &cycles, sizeof(cycles));
+	memcpy(privatePayload + sizeof(cycles), &sequence, sizeof(sequence));
+}
+//------------------------------------------------------------------------------
+static void privateSampleAdd(const void* payload, uint32_t size)
+{
+	uint32_t cycles;
+
+	if (size < MQTT_BENCH_PAYLOAD_HEADER_SIZE)
+	{
+		return;
+	}
+
+	memcpy(&cycles, payload, sizeof(cycles));
+
+	if (privateSamplesCount < MQTT_BENCH_MAX_SAMPLES)
+	{
+		privateSamples[privateSamplesCount] = DWT->CYCCNT - cycles;
+		privateSamplesCount++;
+	}
+
+	privateResult->Received++;
+}
+//------------------------------------------------------------------------------
+static int privateSampleCompare(const void* a, const void* b)
+{
+	uint32_t left = *(const uint32_t*)a;
+	uint32_t right = *(const uint32_t*)b;
+
+	return (left > right) - (left < right);
+}
+//------------------------------------------------------------------------------
+static uint32_t privatePercentile(uint8_t percent)
+{
+	uint32_t index = (privateSamplesCount * percent + 99) / 100;
+
+	return privateCyclesToUs(privateSamples[index ? index - 1 : 0]);
+}
+//------------------------------------------------------------------------------
+static void privateResultComplete(MqttBenchResultT* result, uint64_t cycles, uint32_t engineMemory)
+{
+	result->Duration = privateCyclesToUs(cycles);
+
+	if (result->Published)
+	{
+		result->CyclesPerMessage = cycles / result->Published;
+	}
+
+	if (result->Duration)
+	{
+		result->Throughput = (uint64_t)result->Received * privateRequest.Length * 1000000 / result->Duration;
+	}
+
+	if (privateSamplesCount)
+	{
+		qsort(privateSamples, privateSamplesCount, sizeof(privateSamples[0]), privateSampleCompare);
+
+		result->LatencyP50 = privatePercentile(50);
+		result->LatencyP90 = privatePercentile(90);
+		result->LatencyP99 = privatePercentile(99);
+		result->LatencyMax = privateCyclesToUs(privateSamples[privateSamplesCount - 1]);
+	}
+
+	uint32_t stackUsed = (MQTT_BENCH_TASK_STACK_SIZE - uxTaskGetStackHighWaterMark(NULL)) * sizeof(StackType_t);
+
+	result->RamPeak = engineMemory + sizeof(privateBrokerMemory) + sizeof(privateBrokerSessions) + privatePipe.Peak + stackUsed;
+}
+//------------------------------------------------------------------------------
+static int32_t privateCoreSend(NetworkContext_t* context, const void* data, size_t size)
+{
+	(void)context;
+
+	return privatePipeSend(data, size);
+}
+//------------------------------------------------------------------------------
+static int32_t privateCoreReceive(NetworkContext_t* context, void* data, size_t size)
+{
+	(void)context;
+
+	return privatePipeRead(&privatePipe, data, size);
+}
+//------------------------------------------------------------------------------
+static uint32_t privateCoreGetTime(void)
+{
+	return xSystemGetTime();
+}
+//------------------------------------------------------------------------------
+static void privateCoreEventCallback(MQTTContext_t* context, MQTTPacketInfo_t* packetInfo, MQTTDeserializedInfo_t* info)
+{
+	(void)context;
+
+	if ((packetInfo->type & 0xF0U) == MQTT_PACKET_TYPE_PUBLISH)
+	{
+		privateSampleAdd(info->pPublishInfo->pPayload, info->pPublishInfo->payloadLength);
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the broker answers within the send, the answers are already in the pipe.
+ */
+static void privateCoreDrain()
+{
+	for (uint8_t i = 0; i < MQTT_BENCH_DRAIN_LIMIT; i++)
+	{
+		if ((!privatePipe.Count && !privateCoreContext.index)
+			|| MQTT_ReceiveLoop(&privateCoreContext) != MQTTSuccess)
+		{
+			break;
+		}
+	}
+}
+//------------------------------------------------------------------------------
+static void privateCoreMqttRun(MqttBenchResultT* result)
+{
+	NetworkContextT networkContext = { .Context = &privatePipe };
+	TransportInterface_t transport = { 0 };
+	MQTTFixedBuffer_t buffer = { .pBuffer = privateClientBuffer, .size = sizeof(privateClientBuffer) };
+
+	transport.send = privateCoreSend;
+	transport.recv = privateCoreReceive;
+	transport.pNetworkContext = (void*)&networkContext;
+
+	if (MQTT_Init(&privateCoreContext, &transport, privateCoreGetTime, privateCoreEventCallback, &buffer) != MQTTSuccess
+		|| MQTT_InitStatefulQoS(&privateCoreContext,
+								privateCoreOutgoingRecords, MQTT_BENCH_QOS_RECORDS,
+								privateCoreIncomingRecords, MQTT_BENCH_QOS_RECORDS) != MQTTSuccess)
+	{
+		privateReport("[mqtt-bench] coreMQTT init error\r");
+		return;
+	}
+
+	MQTTConnectInfo_t connectInfo = { 0 };
+	connectInfo.cleanSession = true;
+	connectInfo.pClientIdentifier = MQTT_BENCH_CLIENT_ID;
+	connectInfo.clientIdentifierLength = sizeof_str(MQTT_BENCH_CLIENT_ID);
+	connectInfo.keepAliveSeconds = 60;
+
+	bool sessionPresent;
+	uint32_t cycles = DWT->CYCCNT;
+
+	if (MQTT_Connect(&privateCoreContext, &connectInfo, NULL, MQTT_BENCH_COMMAND_TIMEOUT, &sessionPresent) != MQTTSuccess)
+	{
+		privateReport("[mqtt-bench] coreMQTT connect error\r");
+		return;
+	}
+
+	result->ConnectTime = privateCyclesToUs(DWT->CYCCNT - cycles);
+
+	MQTTSubscribeInfo_t subscription = { 0 };
+	subscription.qos = (MQTTQoS_t)privateRequest.QoS;
+	subscription.pTopicFilter = MQTT_BENCH_TOPIC;
+	subscription.topicFilterLength = sizeof_str(MQTT_BENCH_TOPIC);
+
+	if (MQTT_Subscribe(&privateCoreContext, &subscription, 1, MQTT_GetPacketId(&privateCoreContext)) != MQTTSuccess)
+	{
+		privateReport("[mqtt-bench] coreMQTT subscribe error\r");
+		return;
+	}
+
+	privateCoreDrain();
+
+	MQTTPublishInfo_t publishInfo = { 0 };
+	publishInfo.qos = (MQTTQoS_t)privateRequest.QoS;
+	publishInfo.pTopicName = MQTT_BENCH_TOPIC;
+	publishInfo.topicNameLength = sizeof_str(MQTT_BENCH_TOPIC);
+	publishInfo.pPayload = privatePayload;
+	publishInfo.payloadLength = privateRequest.Length;
+
+	//accumulated per publish, the cycle counter wraps in seconds
+	uint64_t duration = 0;
+
+	for (uint32_t i = 0; i < privateRequest.Count; i++)
+	{
+		cycles = DWT->CYCCNT;
+
+		privatePayloadFill(i);
+
+		uint16_t packetId = publishInfo.qos ? MQTT_GetPacketId(&privateCoreContext) : 0;
+
+		if (MQTT_Publish(&privateCoreContext, &publishInfo, packetId) != MQTTSuccess)
+		{
+			break;
+		}
+
+		result->Published++;
+		privateCoreDrain();
+
+		duration += DWT->CYCCNT - cycles;
+	}
+
+	MQTT_Disconnect(&privateCoreContext);
+
+	privateResultComplete(result, duration, sizeof(privateCoreContext)
+											+ sizeof(privateClientBuffer)
+											+ sizeof(privateCoreOutgoingRecords)
+											+ sizeof(privateCoreIncomingRecords));
+}
+//------------------------------------------------------------------------------
+#if MQTT_BENCH_PAHO_ENABLE == 1
+static int privatePahoRead(MQTTNetworkT* network, unsigned char* data, int size, int timeout)
+{
+	(void)network;
+	(void)timeout;
+
+	return privatePipeRead(&privatePipe, data, size);
+}
+//------------------------------------------------------------------------------
+static int privatePahoWrite(MQTTNetworkT* network, unsigned char* data, int size, int timeout)
+{
+	(void)network;
+	(void)timeout;
+
+	return privatePipeSend(data, size);
+}
+//------------------------------------------------------------------------------
+static void privatePahoDisconnect(MQTTNetworkT* network)
+{
+	(void)network;
+
+	MqttBrokerClose(&privateBroker, privatePipe.Session);
+}
+//------------------------------------------------------------------------------
+static void privatePahoMessageHandler(MessageData* data)
+{
+	privateSampleAdd(data->message->payload, data->message->payloadlen);
+}
+//------------------------------------------------------------------------------
+static void privatePahoDrain()
+{
+	for (uint8_t i = 0; i < MQTT_BENCH_DRAIN_LIMIT && privatePipe.Count; i++)
+	{
+		//MQTTYield with a zero timeout gives an expired timer to the PUBACK of a QoS1 delivery, its send fails
+		MQTTTimerT timer;
+		TimerInit(&timer);
+		TimerCountdownMS(&timer, MQTT_BENCH_COMMAND_TIMEOUT);
+
+		if (cycle(&privatePahoClient, &timer) < 0)
+		{
+			break;
+		}
+	}
+}
+//------------------------------------------------------------------------------
+static void privatePahoRun(MqttBenchResultT* result)
+{
+	NetworkInit(&privatePahoNetwork);
+
+	privatePahoNetwork.mqttread = privatePahoRead;
+	privatePahoNetwork.mqttwrite = privatePahoWrite;
+	privatePahoNetwork.disconnect = privatePahoDisconnect;
+
+	MQTTClientInit(&privatePahoClient, &privatePahoNetwork, MQTT_BENCH_COMMAND_TIMEOUT,
+					privateClientBuffer, sizeof(privateClientBuffer),
+					privateClientReadBuffer, sizeof(privateClientReadBuffer));
+
+	MQTTPacket_connectData connectData = MQTTPacket_connectData_initializer;
+	connectData.MQTTVersion = 4;
+	connectData.clientID.cstring = MQTT_BENCH_CLIENT_ID;
+	connectData.keepAliveInterval = 60;
+	connectData.cleansession = 1;
+
+	uint32_t cycles = DWT->CYCCNT;
+
+	if (MQTTConnect(&privatePahoClient, &connectData) != MQTT_RESULT_SUCCESS)
+	{
+		privateReport("[mqtt-bench] Paho connect error\r");
+		return;
+	}
+
+	result->ConnectTime = privateCyclesToUs(DWT->CYCCNT - cycles);
+
+	if (MQTTSubscribe(&privatePahoClient, MQTT_BENCH_TOPIC, (enum QoS)privateRequest.QoS, privatePahoMessageHandler) != MQTT_RESULT_SUCCESS)
+	{
+		privateReport("[mqtt-bench] Paho subscribe error\r");
+		return;
+	}
+
+	privatePahoDrain();
+
+	MQTTMessage message = { 0 };
+	message.qos = (enum QoS)privateRequest.QoS;
+	message.payload = privatePayload;
+	message.payloadlen = privateRequest.Length;
+
+	uint64_t duration = 0;
+
+	for (uint32_t i = 0; i < privateRequest.Count; i++)
+	{
+		cycles = DWT->CYCCNT;
+
+		privatePayloadFill(i);
+
+		if (MQTTPublish(&privatePahoClient, MQTT_BENCH_TOPIC, &message) != MQTT_RESULT_SUCCESS)
+		{
+			break;
+		}
+
+		result->Published++;
+		privatePahoDrain();
+
+		duration += DWT->CYCCNT - cycles;
+	}
+
+	MQTTDisconnect(&privatePahoClient);
+
+	privateResultComplete(result, duration, sizeof(privatePahoClient)
+											+ sizeof(privatePahoNetwork)
+											+ sizeof(privateClientBuffer)
+											+ sizeof(privateClientReadBuffer));
+}
+#endif
+//------------------------------------------------------------------------------
+/**
+ * @brief publishes through MqttPort: the engine selected by MQTT_TARGET_LAYOUT with its network stack
+ * and the configured broker. There is no loopback, the publishes accepted by the engine are counted as received,
+ * the cycles per message are taken from the statistic of the adapter.
+ */
+static void privatePortRun(MqttBenchResultT* result)
+{
+	if (!MqttPort.IsConnected)
+	{
+		privateReport("[mqtt-bench] %s is not connected\r", MQTT_BENCH_PORT_ENGINE_NAME);
+		return;
+	}
+
+	MqttPortAdapterT* adapter = (MqttPortAdapterT*)MqttPort.Adapter.Content;
+	MqttPortStatisticT statistic = adapter->Internal.Statistic;
+
+#if MQTT_TARGET_LAYOUT == MQTT_PAHO_LAYOUT
+	MQTTNetworkStatisticT network = adapter->Internal.Network.statistic;
+#endif
+
+	uint64_t duration = 0;
+
+	for (uint32_t i = 0; i < privateRequest.Count; i++)
+	{
+		uint32_t cycles = DWT->CYCCNT;
+
+		privatePayloadFill(i);
+
+		xPortStartTransmission(&MqttPort);
+		xPortTransmitData(&MqttPort, privatePayload, privateRequest.Length);
+		xPortEndTransmission(&MqttPort);
+
+		result->Published++;
+
+		duration += DWT->CYCCNT - cycles;
+	}
+
+	result->Received = adapter->Internal.Statistic.Published - statistic.Published;
+
+	privateResultComplete(result, duration, sizeof(MqttPortAdapterT));
+
+	if (result->Received)
+	{
+		result->CyclesPerMessage = (adapter->Internal.Statistic.PublishCycles - statistic.PublishCycles) / result->Received;
+	}
+
+	//only the adapter is measured, the broker and the pipe are not used
+	result->RamPeak -= sizeof(privateBrokerMemory) + sizeof(privateBrokerSessions) + privatePipe.Peak;
+
+#if MQTT_TARGET_LAYOUT == MQTT_PAHO_LAYOUT
+	if (result->Published)
+	{
+		MQTTNetworkStatisticT* current = &adapter->Internal.Network.statistic;
+
+		//socket calls of the transport, x100 per message
+		privateReport("[mqtt-bench] %s socket calls/msg x100: recv %lu, send %lu, setsockopt %lu\r",
+						MQTT_BENCH_PORT_ENGINE_NAME,
+						(current->recv_calls - network.recv_calls) * 100 / result->Published,
+						(current->send_calls - network.send_calls) * 100 / result->Published,
+						(current->setsockopt_calls - network.setsockopt_calls) * 100 / result->Published);
+	}
+#endif
+}
+//------------------------------------------------------------------------------
+static void privateResultReport(const char* engine, MqttBenchResultT* result)
+{
+	uint32_t rate = result->Duration ? (uint64_t)result->Received * 1000000 / result->Duration : 0;
+
+	privateReport("[mqtt-bench] %s qos%u %lu/%lu msg, connect %lu us, %lu msg/s, %lu B/s\r",
+					engine,
+					privateRequest.QoS,
+					result->Received,
+					result->Published,
+					result->ConnectTime,
+					rate,
+					result->Throughput);
+
+	privateReport("[mqtt-bench] %s latency p50 %lu p90 %lu p99 %lu max %lu us, %lu cycles/msg, ram %lu B\r",
+					engine,
+					result->LatencyP50,
+					result->LatencyP90,
+					result->LatencyP99,
+					result->LatencyMax,
+					result->CyclesPerMessage,
+					result->RamPeak);
+}
+//------------------------------------------------------------------------------
+static void privateEngineRun(MqttBenchEngineT engine)
+{
+	static const char* names[MqttBenchEngineCount] = { "coreMQTT", "Paho", MQTT_BENCH_PORT_ENGINE_NAME };
+
+	MqttBenchResultT* result = &MqttBenchResult[engine];
+
+	memset(result, 0, sizeof(MqttBenchResultT));
+	privateResult = result;
+	privateSamplesCount = 0;
+
+	if (engine != MqttBenchEnginePort && privatePipeOpen() != xResultAccept)
+	{
+		privateReport("[mqtt-bench] broker init error\r");
+		return;
+	}
+
+	switch ((uint8_t)engine)
+	{
+		case MqttBenchEngineCoreMqtt: privateCoreMqttRun(result); break;
+#if MQTT_BENCH_PAHO_ENABLE == 1
+		case MqttBenchEnginePaho: privatePahoRun(result); break;
+#else
+		case MqttBenchEnginePaho: privateReport("[mqtt-bench] Paho is not built, see MQTT_BENCH_PAHO_ENABLE\r"); return;
+#endif
+		case MqttBenchEnginePort: privatePortRun(result); break;
+		default: break;
+	}
+
+	if (engine != MqttBenchEnginePort && (privateBroker.Statistic.Errors || privateBroker.Statistic.Dropped))
+	{
+		privateReport("[mqtt-bench] %s broker errors %lu, dropped %lu\r",
+						names[engine],
+						privateBroker.Statistic.Errors,
+						privateBroker.Statistic.Dropped);
+	}
+
+	privateResultReport(names[engine], result);
+}
+//------------------------------------------------------------------------------
+static void privateTask(void* arg)
+{
+	while (true)
+	{
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+		for (uint8_t engine = 0; engine < MqttBenchEngineCount; engine++)
+		{
+			if (privateRequest.Engines & (1 << engine))
+			{
+				privateEngineRun(engine);
+			}
+		}
+
+		privateReport("[mqtt-bench] done\r");
+
+		privateIsBusy = false;
+
+		RTOS_MqttBenchTaskStackWaterMark = uxTaskGetStackHighWaterMark(NULL);
+	}
+}
+//------------------------------------------------------------------------------
+xResult MqttBenchComponentStart(MqttBenchRequestT* request)
+{
+	if (!request || request->QoS > 1)
+	{
+		return xResultError;
+	}
+
+	if (privateIsBusy)
+	{
+		return xResultBusy;
+	}
+
+	privateRequest = *request;
+
+	if (!(privateRequest.Engines & ((1 << MqttBenchEngineCount) - 1)))
+	{
+		privateRequest.Engines = (1 << MqttBenchEngineCount) - 1;
+
+#if MQTT_BENCH_PAHO_ENABLE != 1
+		privateRequest.Engines &= ~(1 << MqttBenchEnginePaho);
+#endif
+	}
+
+	if (!privateRequest.Count)
+	{
+		privateRequest.Count = MQTT_BENCH_DEFAULT_COUNT;
+	}
+
+	if (!privateRequest.Length || privateRequest.Length > sizeof(privatePayload))
+	{
+		privateRequest.Length = MQTT_BENCH_DEFAULT_LENGTH;
+	}
+
+	if (privateRequest.Length < MQTT_BENCH_PAYLOAD_HEADER_SIZE)
+	{
+		privateRequest.Length = MQTT_BENCH_PAYLOAD_HEADER_SIZE;
+	}
+
+	privateIsBusy = true;
+	xTaskNotifyGive(taskHandle);
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief "mqtt-bench [core|paho|port] [-n count] [-l len] [-q 0|1]"
+ * without an engine name all engines run one after another, "port" publishes with MQTT_PORT_QOS.
+ */
+static xResult privateCommand(xPortT* port, TerminalCommandArgumentsT* arguments)
+{
+	MqttBenchRequestT request = { 0 };
+	request.ReportPort = port;
+	request.Count = TerminalCommandGetNumber(arguments, 'n', 0);
+	request.Length = TerminalCommandGetNumber(arguments, 'l', 0);
+	request.QoS = TerminalCommandGetNumber(arguments, 'q', 0);
+
+	for (uint8_t i = 0; i < arguments->Count; i++)
+	{
+		char* word = arguments->Values[i];
+
+		if (strcmp(word, "core") == 0)
+		{
+			request.Engines |= 1 << MqttBenchEngineCoreMqtt;
+		}
+		else if (strcmp(word, "paho") == 0)
+		{
+			request.Engines |= 1 << MqttBenchEnginePaho;
+		}
+		else if (strcmp(word, "port") == 0)
+		{
+			request.Engines |= 1 << MqttBenchEnginePort;
+		}
+		else if (word[0] == '-' && word[1] && !word[2] && strchr("nlq", word[1]) && i + 1 < arguments->Count)
+		{
+			i++;
+		}
+		else
+		{
+			return xResultError;
+		}
+	}
+
+	return MqttBenchComponentStart(&request);
+}
+//------------------------------------------------------------------------------
+static const TerminalCommandT privateCommands[] =
+{
+	{
+		.Name = "mqtt-bench",
+		.Usage = "[core|paho|port] [-n count] [-l len] [-q 0|1]",
+		.Handler = privateCommand
+	}
+};
+//==============================================================================
+//initialization:
+
+xResult MqttBenchComponentInit(void* parent)
+{
+	privateRequest.ReportPort = &SerialPort;
+
+	TerminalCommandsAdd(privateCommands, sizeof(privateCommands) / sizeof(privateCommands[0]));
+
+	taskHandle = xTaskCreateStatic(privateTask, // Function that implements the task.
+									"mqtt bench task", // Text name for the task.
+									MQTT_BENCH_TASK_STACK_SIZE, // Number of indexes in the xStack array.
+									NULL, // Parameter passed into the task.
+									osPriorityBelowNormal, // Priority at which the task is created.
+									taskStack, // Array to use as the task's stack.
+									&taskBuffer);
+
+	return xResultAccept;
+}
+//==============================================================================
@@ -0,0 +1,81 @@
+//==============================================================================
+//header:
+
+#ifndef _MQTT_BENCH_COMPONENT_H_
+#define _MQTT_BENCH_COMPONENT_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "MqttBench-ComponentConfig.h"
+#include "Abstractions/xPort/xPort.h"
+//==============================================================================
+//types:
+
+/// @brief MQTT client engines driven against the in-process broker
+typedef enum
+{
+	MqttBenchEngineCoreMqtt, //engine of the FreeRTOS+TCP port adapter
+	MqttBenchEnginePaho, //Paho MQTTClient of the Paho interface, MQTT_BENCH_PAHO_ENABLE
+	MqttBenchEnginePort, //MqttPort of the engine selected by MQTT_TARGET_LAYOUT, to the configured broker
+
+	MqttBenchEngineCount
+
+} MqttBenchEngineT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint8_t Engines; //bit mask of MqttBenchEngineT
+	uint16_t Count;
+	uint16_t Length;
+	uint8_t QoS;
+
+	xPortT* ReportPort;
+
+} MqttBenchRequestT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t ConnectTime; //us, CONNECT to CONNACK
+	uint32_t Duration; //us, the publishes and their loopback deliveries
+
+	uint32_t Published;
+	uint32_t Received;
+
+	uint32_t Throughput; //bytes per second of the payload
+
+	//us, publish to the delivery of the loopback subscription
+	uint32_t LatencyP50;
+	uint32_t LatencyP90;
+	uint32_t LatencyP99;
+	uint32_t LatencyMax;
+
+	uint32_t CyclesPerMessage; //CPU cycles of the publish call, for the loopback engines with the delivery
+
+	uint32_t RamPeak; //bytes: the engine buffers, the broker, the pipe peak and the task stack used
+
+} MqttBenchResultT;
+//==============================================================================
+//functions:
+
+xResult MqttBenchComponentInit(void* parent);
+
+xResult MqttBenchComponentStart(MqttBenchRequestT* request);
+//==============================================================================
+//override:
+
+#define MqttBenchComponentHandler()
+#define MqttBenchComponentTimeSynchronization()
+//==============================================================================
+//export:
+
+extern MqttBenchResultT MqttBenchResult[MqttBenchEngineCount];
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MQTT_BENCH_COMPONENT_H_
@@ -0,0 +1,45 @@
+//==============================================================================
+//header:
+
+#ifndef _MQTT_BENCH_COMPONENT_CONFIG_H_
+#define _MQTT_BENCH_COMPONENT_CONFIG_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+//==============================================================================
+//defines:
+
+#define MQTT_BENCH_COMPONENT_MAIN_TASK_STACK_SECTION __attribute__((section("._user_heap_stack")))
+
+#define MQTT_BENCH_TASK_STACK_SIZE 0x300
+
+//the Paho MQTTClient engine: CMake builds Components/Paho-MQTT and sets it,
+//the IDE project excludes Paho-MQTT and Interfaces/Paho-MQTT-Interface
+#ifndef MQTT_BENCH_PAHO_ENABLE
+#define MQTT_BENCH_PAHO_ENABLE 0
+#endif
+
+#define MQTT_BENCH_TOPIC "bench/loop"
+#define MQTT_BENCH_CLIENT_ID "bench"
+
+#define MQTT_BENCH_DEFAULT_COUNT 500 //publishes of one run
+#define MQTT_BENCH_DEFAULT_LENGTH 64 //bytes, the payload starts with the time stamp and the sequence number
+#define MQTT_BENCH_MAX_SAMPLES 1000 //latencies kept for the percentiles
+
+#define MQTT_BENCH_PACKET_SIZE 512 //the largest packet of the broker and the clients
+#define MQTT_BENCH_PIPE_SIZE 2048 //bytes from the broker not yet read by the client
+#define MQTT_BENCH_BROKER_SESSIONS 2
+#define MQTT_BENCH_COMMAND_TIMEOUT 1000 //ms
+
+#define MQTT_BENCH_REPORT_BUFFER_SIZE 128
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MQTT_BENCH_COMPONENT_CONFIG_H_
@@ -0,0 +1,460 @@
+//==============================================================================
+//includes:
+
+#include "MqttBroker.h"
+#include "MQTTPacket.h"
+#include <string.h>
+//==============================================================================
+//defines:
+
+#define MQTT_BROKER_SUBSCRIBE_FAILURE 0x80
+//==============================================================================
+//functions:
+
+static void privateSend(MqttBrokerT* broker, MqttBrokerSessionT* session, int size)
+{
+	if (size <= 0 || session->Send(session->Context, broker->TxBuffer, size) != size)
+	{
+		broker->Statistic.Dropped++;
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @return size of the packet with the fixed header, 0 - the remaining length is not received yet,
+ * -1 - the remaining length is malformed
+ */
+static int32_t privatePacketSize(const uint8_t* data, uint16_t count)
+{
+	uint32_t length = 0;
+
+	for (uint8_t i = 1; i < 5; i++)
+	{
+		if (i >= count)
+		{
+			return 0;
+		}
+
+		length |= (uint32_t)(data[i] & 0x7F) << (7 * (i - 1));
+
+		if (!(data[i] & 0x80))
+		{
+			return 1 + i + length;
+		}
+	}
+
+	return -1;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief MQTT 3.1.1 matching: "+" takes one level, "#" the rest of the topic and the parent level,
+ * the wildcards in the first level don't match the system topics ("$SYS/...").
+ */
+static bool privateTopicMatches(const char* filter, const char* topic, uint16_t length)
+{
+	uint16_t position = 0;
+
+	if (length && topic[0] == '$' && (filter[0] == '+' || filter[0] == '#'))
+	{
+		return false;
+	}
+
+	while (*filter)
+	{
+		if (*filter == '#')
+		{
+			return true;
+		}
+
+		if (*filter == '+')
+		{
+			while (position < length && topic[position] != '/')
+			{
+				position++;
+			}
+
+			filter++;
+			continue;
+		}
+
+		if (position >= length || topic[position] != *filter)
+		{
+			//"a/#" matches "a"
+			return position == length && filter[0] == '/' && filter[1] == '#' && !filter[2];
+		}
+
+		position++;
+		filter++;
+	}
+
+	return position == length;
+}
+//------------------------------------------------------------------------------
+static uint8_t privateSubscribe(MqttBrokerSessionT* session, MQTTString* filter, int qos)
+{
+	int length = filter->lenstring.len;
+
+	if (length <= 0 || length >= MQTT_BROKER_FILTER_SIZE || qos < 0 || qos > 2)
+	{
+		return MQTT_BROKER_SUBSCRIBE_FAILURE;
+	}
+
+	//the same filter replaces the subscription
+	MqttBrokerSubscriptionT* subscription = NULL;
+
+	for (uint8_t i = 0; i < session->SubscriptionsCount; i++)
+	{
+		if (MQTTPacket_equals(filter, session->Subscriptions[i].Filter))
+		{
+			subscription = &session->Subscriptions[i];
+			break;
+		}
+	}
+
+	if (!subscription)
+	{
+		if (session->SubscriptionsCount >= MQTT_BROKER_SESSION_SUBSCRIPTIONS)
+		{
+			return MQTT_BROKER_SUBSCRIBE_FAILURE;
+		}
+
+		subscription = &session->Subscriptions[session->SubscriptionsCount++];
+		memcpy(subscription->Filter, filter->lenstring.data, length);
+		subscription->Filter[length] = 0;
+	}
+
+	//QoS2 is granted as QoS1
+	subscription->QoS = qos > 1 ? 1 : qos;
+
+	return subscription->QoS;
+}
+//------------------------------------------------------------------------------
+static void privateUnsubscribe(MqttBrokerSessionT* session, MQTTString* filter)
+{
+	for (uint8_t i = 0; i < session->SubscriptionsCount; i++)
+	{
+		if (MQTTPacket_equals(filter, session->Subscriptions[i].Filter))
+		{
+			session->Subscriptions[i] = session->Subscriptions[--session->SubscriptionsCount];
+			return;
+		}
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief delivers the publish to each session with a matching subscription once,
+ * with the lower QoS of the publish and the subscription.
+ */
+static void privateDeliver(MqttBrokerT* broker, MQTTString* topic, int qos, uint8_t* payload, int payloadLength)
+{
+	for (uint8_t i = 0; i < broker->SessionsSize; i++)
+	{
+		MqttBrokerSessionT* session = &broker->Sessions[i];
+
+		if (!session->IsConnected)
+		{
+			continue;
+		}
+
+		for (uint8_t j = 0; j < session->SubscriptionsCount; j++)
+		{
+			MqttBrokerSubscriptionT* subscription = &session->Subscriptions[j];
+
+			if (!privateTopicMatches(subscription->Filter, topic->lenstring.data, topic->lenstring.len))
+			{
+				continue;
+			}
+
+			int deliveryQoS = qos < subscription->QoS ? qos : subscription->QoS;
+			uint16_t packetId = 0;
+
+			if (deliveryQoS)
+			{
+				if (++session->PacketId == 0)
+				{
+					session->PacketId = 1;
+				}
+
+				packetId = session->PacketId;
+			}
+
+			privateSend(broker, session, MQTTSerialize_publish(broker->TxBuffer, broker->PacketSize,
+																0, deliveryQoS, 0, packetId,
+																*topic, payload, payloadLength));
+
+			broker->Statistic.Delivered++;
+			break;
+		}
+	}
+}
+//------------------------------------------------------------------------------
+static xResult privatePacketHandle(MqttBrokerT* broker, MqttBrokerSessionT* session, uint8_t* packet, int size)
+{
+	uint8_t type = packet[0] >> 4;
+
+	if (!session->IsConnected && type != CONNECT)
+	{
+		return xResultError;
+	}
+
+	switch (type)
+	{
+		case CONNECT:
+		{
+			MQTTPacket_connectData connectData = MQTTPacket_connectData_initializer;
+
+			if (session->IsConnected || MQTTDeserialize_connect(&connectData, packet, size) != 1)
+			{
+				return xResultError;
+			}
+
+			session->IsConnected = true;
+			session->SubscriptionsCount = 0;
+
+			broker->Statistic.Connects++;
+
+			privateSend(broker, session, MQTTSerialize_connack(broker->TxBuffer, broker->PacketSize, 0, 0));
+			break;
+		}
+
+		case SUBSCRIBE:
+		{
+			MQTTString filters[MQTT_BROKER_SESSION_SUBSCRIPTIONS];
+			int requestedQoS[MQTT_BROKER_SESSION_SUBSCRIPTIONS];
+			int grantedQoS[MQTT_BROKER_SESSION_SUBSCRIPTIONS];
+			unsigned short packetId;
+			unsigned char dup;
+			int count;
+
+			if (MQTTDeserialize_subscribe(&dup, &packetId, MQTT_BROKER_SESSION_SUBSCRIPTIONS, &count,
+											filters, requestedQoS, packet, size) != 1)
+			{
+				return xResultError;
+			}
+
+			for (int i = 0; i < count; i++)
+			{
+				grantedQoS[i] = privateSubscribe(session, &filters[i], requestedQoS[i]);
+			}
+
+			privateSend(broker, session, MQTTSerialize_suback(broker->TxBuffer, broker->PacketSize, packetId, count, grantedQoS));
+			break;
+		}
+
+		case UNSUBSCRIBE:
+		{
+			MQTTString filters[MQTT_BROKER_SESSION_SUBSCRIPTIONS];
+			unsigned short packetId;
+			unsigned char dup;
+			int count;
+
+			if (MQTTDeserialize_unsubscribe(&dup, &packetId, MQTT_BROKER_SESSION_SUBSCRIPTIONS, &count,
+											filters, packet, size) != 1)
+			{
+				return xResultError;
+			}
+
+			for (int i = 0; i < count; i++)
+			{
+				privateUnsubscribe(session, &filters[i]);
+			}
+
+			privateSend(broker, session, MQTTSerialize_unsuback(broker->TxBuffer, broker->PacketSize, packetId));
+			break;
+		}
+
+		case PUBLISH:
+		{
+			MQTTString topic;
+			uint8_t* payload;
+			int payloadLength;
+			unsigned short packetId;
+			unsigned char dup;
+			unsigned char retained;
+			int qos;
+
+			if (MQTTDeserialize_publish(&dup, &qos, &retained, &packetId, &topic, &payload, &payloadLength, packet, size) != 1
+				|| qos > 1)
+			{
+				return xResultError;
+			}
+
+			broker->Statistic.Publishes++;
+
+			if (qos == 1)
+			{
+				privateSend(broker, session, MQTTSerialize_puback(broker->TxBuffer, broker->PacketSize, packetId));
+			}
+
+			privateDeliver(broker, &topic, qos, payload, payloadLength);
+			break;
+		}
+
+		case PUBACK:
+			broker->Statistic.Acknowledged++;
+			break;
+
+		case PINGREQ:
+			broker->TxBuffer[0] = PINGRESP << 4;
+			broker->TxBuffer[1] = 0;
+
+			broker->Statistic.Pings++;
+
+			privateSend(broker, session, 2);
+			break;
+
+		case DISCONNECT:
+			session->IsOpen = false;
+			session->IsConnected = false;
+			break;
+
+		default: return xResultError;
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief feeds the bytes of the client stream, the complete packets are handled and answered
+ * through the send function of the session before the return.
+ * @return xResultError if the session was closed on a malformed or unsupported packet
+ */
+xResult MqttBrokerReceive(MqttBrokerT* broker, uint8_t sessionIndex, const void* data, uint32_t size)
+{
+	if (sessionIndex >= broker->SessionsSize || !broker->Sessions[sessionIndex].IsOpen)
+	{
+		return xResultError;
+	}
+
+	MqttBrokerSessionT* session = &broker->Sessions[sessionIndex];
+	const uint8_t* input = data;
+
+	while (size)
+	{
+		uint32_t part = broker->PacketSize - session->RxCount;
+
+		if (part > size)
+		{
+			part = size;
+		}
+
+		memcpy(session->RxBuffer + session->RxCount, input, part);
+		session->RxCount += part;
+		input += part;
+		size -= part;
+
+		for (;;)
+		{
+			int32_t packetSize = privatePacketSize(session->RxBuffer, session->RxCount);
+
+			if (packetSize < 0 || packetSize > broker->PacketSize)
+			{
+				broker->Statistic.Errors++;
+				MqttBrokerClose(broker, sessionIndex);
+
+				return xResultError;
+			}
+
+			if (packetSize == 0 || packetSize > session->RxCount)
+			{
+				break;
+			}
+
+			if ((uint32_t)packetSize > broker->Statistic.PeakRxBytes)
+			{
+				broker->Statistic.PeakRxBytes = packetSize;
+			}
+
+			if (privatePacketHandle(broker, session, session->RxBuffer, packetSize) != xResultAccept)
+			{
+				broker->Statistic.Errors++;
+				MqttBrokerClose(broker, sessionIndex);
+
+				return xResultError;
+			}
+
+			if (!session->IsOpen)
+			{
+				return xResultAccept;
+			}
+
+			session->RxCount -= packetSize;
+			memmove(session->RxBuffer, session->RxBuffer + packetSize, session->RxCount);
+		}
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+xResult MqttBrokerOpen(MqttBrokerT* broker, MqttBrokerSendT send, void* context, uint8_t* sessionIndex)
+{
+	for (uint8_t i = 0; i < broker->SessionsSize; i++)
+	{
+		MqttBrokerSessionT* session = &broker->Sessions[i];
+
+		if (session->IsOpen)
+		{
+			continue;
+		}
+
+		session->Send = send;
+		session->Context = context;
+		session->RxCount = 0;
+		session->SubscriptionsCount = 0;
+		session->PacketId = 0;
+		session->IsConnected = false;
+		session->IsOpen = true;
+
+		*sessionIndex = i;
+
+		return xResultAccept;
+	}
+
+	return xResultError;
+}
+//------------------------------------------------------------------------------
+void MqttBrokerClose(MqttBrokerT* broker, uint8_t sessionIndex)
+{
+	if (sessionIndex < broker->SessionsSize)
+	{
+		broker->Sessions[sessionIndex].IsOpen = false;
+		broker->Sessions[sessionIndex].IsConnected = false;
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief static RAM of the broker: the sessions and the packet buffers.
+ */
+uint32_t MqttBrokerGetMemorySize(MqttBrokerT* broker)
+{
+	return sizeof(MqttBrokerT)
+			+ broker->SessionsSize * (sizeof(MqttBrokerSessionT) + broker->PacketSize)
+			+ broker->PacketSize;
+}
+//==============================================================================
+//initialization:
+
+xResult MqttBrokerInit(MqttBrokerT* broker, MqttBrokerInitT* init)
+{
+	if (broker && init && init->Sessions && init->SessionsSize && init->Memory
+		&& init->PacketSize >= 16
+		&& init->MemorySize >= (uint32_t)(init->SessionsSize + 1) * init->PacketSize)
+	{
+		memset(broker, 0, sizeof(MqttBrokerT));
+		memset(init->Sessions, 0, init->SessionsSize * sizeof(MqttBrokerSessionT));
+
+		broker->Sessions = init->Sessions;
+		broker->SessionsSize = init->SessionsSize;
+		broker->PacketSize = init->PacketSize;
+		broker->TxBuffer = init->Memory;
+
+		for (uint8_t i = 0; i < init->SessionsSize; i++)
+		{
+			broker->Sessions[i].RxBuffer = init->Memory + (i + 1) * init->PacketSize;
+		}
+
+		return xResultAccept;
+	}
+
+	return xResultError;
+}
+//==============================================================================
@@ -0,0 +1,110 @@
+//==============================================================================
+//header:
+
+#ifndef _MQTT_BROKER_H_
+#define _MQTT_BROKER_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+//==============================================================================
+//defines:
+
+#ifndef MQTT_BROKER_SESSION_SUBSCRIPTIONS
+#define MQTT_BROKER_SESSION_SUBSCRIPTIONS 4
+#endif
+
+#ifndef MQTT_BROKER_FILTER_SIZE
+#define MQTT_BROKER_FILTER_SIZE 32 //with the terminating zero
+#endif
+//==============================================================================
+//types:
+
+/// @brief gives the packet to the client of the session
+/// @return sent bytes, a partial send drops the packet
+typedef int32_t (*MqttBrokerSendT)(void* context, const void* data, uint32_t size);
+//------------------------------------------------------------------------------
+typedef struct
+{
+	char Filter[MQTT_BROKER_FILTER_SIZE];
+	uint8_t QoS;
+
+} MqttBrokerSubscriptionT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	MqttBrokerSendT Send;
+	void* Context;
+
+	uint8_t* RxBuffer; //assembly of the incoming packet
+	uint16_t RxCount;
+
+	MqttBrokerSubscriptionT Subscriptions[MQTT_BROKER_SESSION_SUBSCRIPTIONS];
+	uint8_t SubscriptionsCount;
+
+	uint16_t PacketId; //of the QoS1 deliveries
+
+	bool IsOpen;
+	bool IsConnected; //CONNECT is accepted
+
+} MqttBrokerSessionT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Connects;
+	uint32_t Publishes;
+	uint32_t Delivered;
+	uint32_t Acknowledged; //PUBACK of the QoS1 deliveries
+	uint32_t Pings;
+	uint32_t Dropped; //deliveries not taken by the client transport
+	uint32_t Errors; //sessions closed on a malformed or unsupported packet
+
+	uint32_t PeakRxBytes; //the largest incoming packet assembled
+
+} MqttBrokerStatisticT;
+//------------------------------------------------------------------------------
+/// @brief in-process stand-in of an MQTT 3.1.1 broker: CONNECT, SUBSCRIBE, UNSUBSCRIBE,
+/// PUBLISH QoS0/QoS1, PINGREQ, DISCONNECT. No retained messages, no persistent sessions
+typedef struct
+{
+	MqttBrokerSessionT* Sessions;
+	uint8_t SessionsSize;
+
+	uint8_t* TxBuffer;
+	uint16_t PacketSize;
+
+	MqttBrokerStatisticT Statistic;
+
+} MqttBrokerT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	MqttBrokerSessionT* Sessions;
+	uint8_t SessionsSize;
+
+	/// @brief one buffer of PacketSize for each session and one for the outgoing packets
+	uint8_t* Memory;
+	uint32_t MemorySize;
+	uint16_t PacketSize;
+
+} MqttBrokerInitT;
+//==============================================================================
+//functions:
+
+xResult MqttBrokerInit(MqttBrokerT* broker, MqttBrokerInitT* init);
+
+xResult MqttBrokerOpen(MqttBrokerT* broker, MqttBrokerSendT send, void* context, uint8_t* session);
+xResult MqttBrokerReceive(MqttBrokerT* broker, uint8_t session, const void* data, uint32_t size);
+void MqttBrokerClose(MqttBrokerT* broker, uint8_t session);
+
+uint32_t MqttBrokerGetMemorySize(MqttBrokerT* broker);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MQTT_BROKER_H_
@@ -1,53 +1,819 @@
 //==============================================================================
 //includes:
 
+#include "MqttClient/MqttClient-ComponentConfig.h"
+
+#if MQTT_TARGET_LAYOUT == MQTT_FREERTOS_LAYOUT
 #include "MqttPort-Adapter.h"
 #include "Components.h"
+#include "TerminalCommands/TerminalCommands.h"
+#include "main.h"
 #include "Common/xCircleBuffer.h"
 #include "Abstractions/xMQTT/xMQTT.h"
+#include "FreeRTOS-Plus-MQTT/include/core_mqtt_state.h"
+#include "MqttClient/Compress/MqttCompress.h"
+
+#if MQTT_PORT_TLS_ENABLE == 1
+#include "MqttClient/Tls/MqttTls.h"
+#endif
 //==============================================================================
 //defines:
 
+#ifndef MQTT_PORT_IN_FLIGHT_WAIT_TIME
+#define MQTT_PORT_IN_FLIGHT_WAIT_TIME 1000
+#endif
+
+#ifndef MQTT_PORT_CONNACK_TIMEOUT
+#define MQTT_PORT_CONNACK_TIMEOUT 3000
+#endif
+
+#ifndef MQTT_PORT_SEND_TIMEOUT
+#define MQTT_PORT_SEND_TIMEOUT 1000
+#endif
+
+#ifndef MQTT_PORT_TLS_HANDSHAKE_TIMEOUT
+#define MQTT_PORT_TLS_HANDSHAKE_TIMEOUT 10000
+#endif
+
+#ifndef MQTT_OUTBOX_REPLAY_BURST
+#define MQTT_OUTBOX_REPLAY_BURST 4
+#endif
+
+#ifndef MQTT_PORT_PUBLISH_FRAGMENTS
+#define MQTT_PORT_PUBLISH_FRAGMENTS 6 //maximum fragments of MqttPortAdapterPublish
+#endif
+
+#ifndef MQTT_EGRESS_BURST
+#define MQTT_EGRESS_BURST 8 //egress records published by one handler call
+#endif
+
+#ifndef MQTT_PORT_RECEIVE_BURST
+#define MQTT_PORT_RECEIVE_BURST 8 //incoming packets handled by one handler call
+#endif
+
+#ifndef MQTT_PORT_SUBSCRIBE_BATCH
+#define MQTT_PORT_SUBSCRIBE_BATCH 8 //filters in one SUBSCRIBE, limited by MqttBufferSize
+#endif
+
+//==============================================================================
+//types:
+
+enum
+{
+	ConncetionStateCreateSocket,
+	ConncetionStateConnectSocket,
+	ConncetionStateConnectToBroker,
+	ConncetionStateSubscribe,
+	ConncetionStateComplited
+
+};
+//==============================================================================
+//variables:
+
+
+//==============================================================================
+//prototypes:
+
+static uint32_t privateMQTTGetTime(void);
+
+static void privateMQTTCallback(struct MQTTContext * pContext,
+        struct MQTTPacketInfo * pPacketInfo,
+        struct MQTTDeserializedInfo * pDeserializedInfo);
+
+static void privateCoalesceFlush(xPortT* port, MqttPortAdapterT* adapter);
+static void privateOutboxReplay(xPortT* port, MqttPortAdapterT* adapter);
+static void privateEgressSchedule(xPortT* port, MqttPortAdapterT* adapter);
+
+static int32_t privateTransportWritev(NetworkContext_t* pNetworkContext, TransportOutVector_t* pIoVec, size_t ioVecCount);
+//==============================================================================
+//functions:
+
+static void privateSocketClose(xPortT* port, MqttPortAdapterT* adapter)
+{
+#if MQTT_PORT_TLS_ENABLE == 1
+	if (adapter->Internal.Tls)
+	{
+		MqttTlsClose(adapter->Internal.Tls);
+	}
+#endif
+
+	FreeRTOS_closesocket(adapter->Internal.Socket);
+	adapter->Internal.Socket = NULL;
+
+	if (port->IsConnected && adapter->Internal.Reconnect)
+	{
+		NetReconnectDisconnected(adapter->Internal.Reconnect, xSystemGetTime());
+	}
+
+	port->IsConnected = false;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief a failed attempt starts from a new socket after the backoff delay.
+ */
+static xResult privateConnectFailed(xPortT* port, MqttPortAdapterT* adapter)
+{
+	if (adapter->Internal.Socket)
+	{
+		privateSocketClose(port, adapter);
+	}
+
+	if (adapter->Internal.Reconnect)
+	{
+		NetReconnectFailed(adapter->Internal.Reconnect, xSystemGetTime());
+	}
+
+	return xResultError;
+}
+//------------------------------------------------------------------------------
+static void PrivateHandler(xPortT* port)
+{
+	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
+
+#ifdef INC_FREERTOS_H
+	//the context is shared with the publishing tasks
+	xSemaphoreTakeRecursive(adapter->Internal.TransactionMutex, portMAX_DELAY);
+#endif
+
+	if (adapter->Internal.CoalesceBuffer.DataSize
+		&& xSystemGetTime() - adapter->Internal.CoalesceTimeStamp >= adapter->Internal.CoalesceDeadline)
+	{
+		privateCoalesceFlush(port, adapter);
+	}
+
+	//the live records go before the replay of the stored ones
+	if (adapter->Internal.Egress)
+	{
+		privateEgressSchedule(port, adapter);
+	}
+
+	if (adapter->Internal.Outbox && port->IsConnected)
+	{
+		privateOutboxReplay(port, adapter);
+	}
+
+	adapter->Internal.IsReceiving = true;
+
+	//a pass takes one packet, the pass that receives nothing handles the keep-alive:
+	//sends PINGREQ when the connection is idle for KeepAlive, times out the PINGRESP
+	//(the library returns MQTTSuccess for no data too, the received bytes tell the passes apart)
+	MQTTContext_t* context = &adapter->Internal.MQTTContext;
+	MQTTStatus_t result;
+	uint8_t packets = 0;
+	bool isReceived;
+
+	do
+	{
+		uint32_t rxBytes = adapter->Internal.RxBytes;
+
+		result = MQTT_ProcessLoop(context);
+		isReceived = adapter->Internal.RxBytes != rxBytes || context->index;
+	}
+	while (result == MQTTSuccess && isReceived && ++packets < MQTT_PORT_RECEIVE_BURST);
+
+	//the rest is taken by the next pass without waiting for a socket event,
+	//the rest of a partial packet comes with its own event
+	adapter->Internal.IsReceivePending = result == MQTTSuccess && isReceived;
+	adapter->Internal.IsReceiving = false;
+
+	if (result == MQTTKeepAliveTimeout && adapter->Internal.Socket)
+	{
+		//the broker did not answer PINGREQ in MQTT_PINGRESP_TIMEOUT_MS
+		privateSocketClose(port, adapter);
+	}
+
+#ifdef INC_FREERTOS_H
+	xSemaphoreGiveRecursive(adapter->Internal.TransactionMutex);
+#endif
+}
+//------------------------------------------------------------------------------
+static MqttPortInFlightPublishT* privateInFlightFind(MqttPortAdapterT* adapter, uint16_t packetId)
+{
+	for (uint8_t i = 0; i < adapter->Internal.InFlightWindow; i++)
+	{
+		if (adapter->Internal.InFlight[i].PacketId == packetId)
+		{
+			return &adapter->Internal.InFlight[i];
+		}
+	}
+
+	return NULL;
+}
+//------------------------------------------------------------------------------
+static MQTTStatus_t privatePublish(MqttPortAdapterT* adapter, MqttPortInFlightPublishT* slot, bool dup)
+{
+	MQTTPublishInfo_t publishInfo = { 0 };
+	publishInfo.qos = adapter->QoS;
+	publishInfo.dup = dup;
+	publishInfo.pTopicName = slot->Topic;
+	publishInfo.topicNameLength = slot->TopicLength;
+	publishInfo.pPayload = slot->Data;
+	publishInfo.payloadLength = slot->Size;
+
+	return MQTT_Publish(&adapter->Internal.MQTTContext, &publishInfo, slot->PacketId);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief resends the unacknowledged publishes after the connection to the broker is restored.
+ * If the broker kept the session the publishes are resent with their packet ids and the DUP flag,
+ * otherwise the records were cleared by the library and the publishes are sent as new ones.
+ */
+static void privateInFlightResend(MqttPortAdapterT* adapter, bool sessionPresent)
+{
+	if (sessionPresent)
+	{
+		MQTTStateCursor_t cursor = MQTT_STATE_CURSOR_INITIALIZER;
+		uint16_t packetId;
+
+		while ((packetId = MQTT_PublishToResend(&adapter->Internal.MQTTContext, &cursor)) != MQTT_PACKET_ID_INVALID)
+		{
+			MqttPortInFlightPublishT* slot = privateInFlightFind(adapter, packetId);
+
+			if (slot && privatePublish(adapter, slot, true) == MQTTSuccess)
+			{
+				adapter->Internal.Statistic.Resent++;
+			}
+		}
+
+		return;
+	}
+
+	for (uint8_t i = 0; i < adapter->Internal.InFlightWindow; i++)
+	{
+		MqttPortInFlightPublishT* slot = &adapter->Internal.InFlight[i];
+
+		if (slot->PacketId == MQTT_PACKET_ID_INVALID)
+		{
+			continue;
+		}
+
+		slot->PacketId = MQTT_GetPacketId(&adapter->Internal.MQTTContext);
+
+		if (privatePublish(adapter, slot, false) == MQTTSuccess)
+		{
+			adapter->Internal.Statistic.Resent++;
+		}
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief takes a free slot of the in-flight window. While the window is full the acknowledgments
+ * are received here, the caller holds the transaction mutex so the context is not shared.
+ * Between the passes the task sleeps on the socket events up to MQTT_PORT_IN_FLIGHT_WAIT_TIME,
+ * without the event semaphore one pass is made. A publish made from the receive callback
+ * (terminal echo) can't wait for the window.
+ */
+static MqttPortInFlightPublishT* privateInFlightTake(xPortT* port, MqttPortAdapterT* adapter)
+{
+	if (adapter->Internal.InFlightCount >= adapter->Internal.InFlightWindow)
+	{
+		adapter->Internal.Statistic.WindowIsFull++;
+
+		uint32_t timeStamp = xSystemGetTime();
+		uint32_t elapsed = 0;
+		bool isEventTaken = false;
+
+		while (port->IsConnected
+				&& !adapter->Internal.IsReceiving
+				&& elapsed < MQTT_PORT_IN_FLIGHT_WAIT_TIME)
+		{
+			adapter->Internal.IsReceiving = true;
+			MQTTStatus_t result = MQTT_ReceiveLoop(&adapter->Internal.MQTTContext);
+			adapter->Internal.IsReceiving = false;
+
+			//the rest of a partial packet comes with its own event
+			if ((result != MQTTSuccess && result != MQTTNeedMoreBytes)
+				|| adapter->Internal.InFlightCount < adapter->Internal.InFlightWindow)
+			{
+				break;
+			}
+
+#ifdef INC_FREERTOS_H
+			isEventTaken |= xSemaphoreTake(adapter->Internal.EventSemaphore,
+											pdMS_TO_TICKS(MQTT_PORT_IN_FLIGHT_WAIT_TIME - elapsed)) == pdTRUE;
+			elapsed = xSystemGetTime() - timeStamp;
+#else
+			break;
+#endif
+		}
+
+#ifdef INC_FREERTOS_H
+		//a taken event can be for the port task as well (a command, a second packet): it checks the socket once more
+		if (isEventTaken)
+		{
+			xSemaphoreGive(adapter->Internal.EventSemaphore);
+		}
+#endif
+	}
+
+	return privateInFlightFind(adapter, MQTT_PACKET_ID_INVALID);
+}
+//------------------------------------------------------------------------------
+static uint32_t privateFragmentsSize(const MqttPortFragmentT* fragments, uint8_t count)
+{
+	uint32_t size = 0;
+
+	for (uint8_t i = 0; i < count; i++)
+	{
+		size += fragments[i].Size;
+	}
+
+	return size;
+}
+//------------------------------------------------------------------------------
+static uint32_t privateFragmentsGather(const MqttPortFragmentT* fragments, uint8_t count, uint8_t* buffer)
+{
+	uint32_t size = 0;
+
+	for (uint8_t i = 0; i < count; i++)
+	{
+		memcpy(buffer + size, fragments[i].Data, fragments[i].Size);
+		size += fragments[i].Size;
+	}
+
+	return size;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief QoS0 publish without copying: the header, the topic and the fragments
+ * are given to the transport as one vector.
+ */
+static MQTTStatus_t privatePublishVector(xPortT* port, MqttPortAdapterT* adapter,
+											const char* topic, uint16_t topicLength,
+											const MqttPortFragmentT* fragments, uint8_t count)
+{
+	TransportOutVector_t vector[MQTT_PORT_PUBLISH_FRAGMENTS + 2];
+	uint8_t header[7]; //fixed header, remaining length and topic length
+	size_t headerSize;
+	size_t remainingLength;
+	size_t packetSize;
+
+	MQTTPublishInfo_t publishInfo = { 0 };
+	publishInfo.qos = MQTTQoS0;
+	publishInfo.pTopicName = topic;
+	publishInfo.topicNameLength = topicLength;
+	publishInfo.payloadLength = privateFragmentsSize(fragments, count);
+
+	MQTTStatus_t result = MQTT_GetPublishPacketSize(&publishInfo, &remainingLength, &packetSize);
+
+	if (result == MQTTSuccess)
+	{
+		result = MQTT_SerializePublishHeaderWithoutTopic(&publishInfo, remainingLength, header, &headerSize);
+	}
+
+	if (result != MQTTSuccess)
+	{
+		return result;
+	}
+
+	size_t vectorCount = 0;
+
+	vector[vectorCount].iov_base = header;
+	vector[vectorCount++].iov_len = headerSize;
+
+	vector[vectorCount].iov_base = topic;
+	vector[vectorCount++].iov_len = topicLength;
+
+	for (uint8_t i = 0; i < count; i++)
+	{
+		if (fragments[i].Size)
+		{
+			vector[vectorCount].iov_base = fragments[i].Data;
+			vector[vectorCount++].iov_len = fragments[i].Size;
+		}
+	}
+
+	TransportOutVector_t* iterator = vector;
+	size_t sended = 0;
+	uint32_t timeStamp = xSystemGetTime();
+
+	while (sended < packetSize)
+	{
+		int32_t len = privateTransportWritev((void*)port, iterator, vectorCount);
+
+		if (len < 0 || (len == 0 && xSystemGetTime() - timeStamp >= MQTT_PORT_SEND_TIMEOUT))
+		{
+			return MQTTSendFailed;
+		}
+
+		sended += len;
+
+		//skips the sent vectors and the sent part of the current one
+		while (vectorCount && (size_t)len >= iterator->iov_len)
+		{
+			len -= iterator->iov_len;
+			iterator++;
+			vectorCount--;
+		}
+
+		if (vectorCount)
+		{
+			iterator->iov_base = (const uint8_t*)iterator->iov_base + len;
+			iterator->iov_len -= len;
+		}
+	}
+
+	//the keep-alive counts from the last transmission: the packets sent past MQTT_Publish don't update it.
+	//A field of MQTTContext_t of the pinned coreMQTT v2.1.1 (MQTT_LIBRARY_VERSION), not of its API:
+	//check it on an update of Components/FreeRTOS-Plus-MQTT
+	adapter->Internal.MQTTContext.lastPacketTxTime = xSystemGetTime();
+
+	return MQTTSuccess;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief QoS0 - sends the publish, QoS1/QoS2 - takes a slot of the window and sends it from there.
+ * @return xResultAccept - sent or kept in a slot until PUBACK/PUBCOMP, xResultBusy - no free slot,
+ * xResultError - the transport failed (QoS0) or the payload doesn't fit in a slot
+ */
+static xResult privatePublishDirect(xPortT* port, MqttPortAdapterT* adapter,
+									const char* topic, uint16_t topicLength,
+									const MqttPortFragmentT* fragments, uint8_t count)
+{
+	uint32_t cycles = DWT->CYCCNT;
+	uint32_t size = privateFragmentsSize(fragments, count);
+
+	if (adapter->QoS == MQTTQoS0)
+	{
+		if (privatePublishVector(port, adapter, topic, topicLength, fragments, count) != MQTTSuccess)
+		{
+			return xResultError;
+		}
+	}
+	else
+	{
+		if (size > adapter->Internal.InFlightPayloadSize)
+		{
+			return xResultError;
+		}
+
+		//the publish is not waited for: up to InFlightWindow publishes are outstanding,
+		//the slots are released by PUBACK/PUBCOMP in privateMQTTCallback
+		MqttPortInFlightPublishT* slot = privateInFlightTake(port, adapter);
+
+		if (!slot)
+		{
+			return xResultBusy;
+		}
+
+		//QoS1/QoS2 keep a copy of the payload for the resend after a reconnect
+		slot->Size = privateFragmentsGather(fragments, count, slot->Data);
+		slot->Topic = topic;
+		slot->TopicLength = topicLength;
+		slot->PacketId = MQTT_GetPacketId(&adapter->Internal.MQTTContext);
+
+		adapter->Internal.InFlightCount++;
+
+		//on a transport error the slot stays taken and is resent after the reconnect
+		privatePublish(adapter, slot, false);
+	}
+
+	adapter->Internal.Statistic.Published++;
+	adapter->Internal.Statistic.PublishedBytes += size;
+	adapter->Internal.Statistic.PublishCycles += DWT->CYCCNT - cycles;
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief compresses the fragments into CompressBuffer. The payload that doesn't shrink
+ * is copied with the raw header, so the receiving side always gets the header.
+ */
+static xResult privateCompress(MqttPortAdapterT* adapter, const MqttPortFragmentT* fragments, uint8_t count, MqttPortFragmentT* result)
+{
+	uint32_t cycles = DWT->CYCCNT;
+	uint32_t size = privateFragmentsSize(fragments, count);
+	MqttCompressEncoderT encoder;
+
+	MqttCompressBegin(&encoder,
+						adapter->Internal.CompressBuffer,
+						adapter->Internal.CompressBufferSize,
+						adapter->Internal.CompressWindowBits,
+						adapter->Internal.CompressLookaheadBits);
+
+	for (uint8_t i = 0; i < count; i++)
+	{
+		MqttCompressAdd(&encoder, fragments[i].Data, fragments[i].Size);
+	}
+
+	int32_t compressedSize = MqttCompressEnd(&encoder);
+
+	if (compressedSize < 0 || (uint32_t)compressedSize > size + MQTT_COMPRESS_HEADER_SIZE)
+	{
+		if (size + MQTT_COMPRESS_HEADER_SIZE > adapter->Internal.CompressBufferSize)
+		{
+			return xResultError;
+		}
+
+		adapter->Internal.CompressBuffer[0] = MQTT_COMPRESS_HEADER_RAW;
+		compressedSize = privateFragmentsGather(fragments, count, adapter->Internal.CompressBuffer + MQTT_COMPRESS_HEADER_SIZE);
+		compressedSize += MQTT_COMPRESS_HEADER_SIZE;
+	}
+
+	result->Data = adapter->Internal.CompressBuffer;
+	result->Size = compressedSize;
+
+	adapter->Internal.Statistic.CompressInputBytes += size;
+	adapter->Internal.Statistic.CompressOutputBytes += compressedSize;
+	adapter->Internal.Statistic.CompressCycles += DWT->CYCCNT - cycles;
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static void privatePublishFragments(xPortT* port, MqttPortAdapterT* adapter, const MqttPortFragmentT* fragments, uint8_t count)
+{
+	MqttOutboxT* outbox = adapter->Internal.Outbox;
+	MqttPortFragmentT compressed;
+
+	//the outbox stores the compressed payloads, they are replayed as they are
+	if (adapter->Internal.CompressBuffer)
+	{
+		if (privateCompress(adapter, fragments, count, &compressed) != xResultAccept)
+		{
+			adapter->Internal.Statistic.Dropped++;
+			return;
+		}
+
+		fragments = &compressed;
+		count = 1;
+	}
+
+	//while the outbox is not replayed the new publishes go after the stored ones
+	if (outbox && (!port->IsConnected || !MqttOutboxIsEmpty(outbox)))
+	{
+		const void* data = fragments[0].Data;
+		uint32_t size = fragments[0].Size;
+
+		//the outbox stores contiguous records
+		if (count > 1)
+		{
+			size = privateFragmentsSize(fragments, count);
+
+			if (size <= adapter->Internal.ReplayBufferSize)
+			{
+				privateFragmentsGather(fragments, count, adapter->Internal.ReplayBuffer);
+				data = adapter->Internal.ReplayBuffer;
+			}
+		}
+
+		if (size > UINT16_MAX || MqttOutboxAppend(outbox, data, size) != xResultAccept)
+		{
+			adapter->Internal.Statistic.Dropped++;
+		}
+
+		return;
+	}
+
+	if (privatePublishDirect(port, adapter, adapter->TxTopic, adapter->Internal.TxTopicLength, fragments, count) != xResultAccept)
+	{
+		adapter->Internal.Statistic.Dropped++;
+	}
+}
+//------------------------------------------------------------------------------
+static void privatePublishPayload(xPortT* port, MqttPortAdapterT* adapter, uint8_t* data, uint16_t size)
+{
+	MqttPortFragmentT fragment =
+	{
+		.Data = data,
+		.Size = size
+	};
+
+	privatePublishFragments(port, adapter, &fragment, 1);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief publishes the stored records, not faster than one per ReplayPeriod
+ * with a burst of MQTT_OUTBOX_REPLAY_BURST records after an idle time.
+ */
+static void privateOutboxReplay(xPortT* port, MqttPortAdapterT* adapter)
+{
+	MqttOutboxT* outbox = adapter->Internal.Outbox;
+	uint32_t time = xSystemGetTime();
+
+	if (MqttOutboxIsEmpty(outbox))
+	{
+		adapter->Internal.IsReplaying = false;
+		return;
+	}
+
+	if (!adapter->Internal.IsReplaying)
+	{
+		adapter->Internal.IsReplaying = true;
+		outbox->Statistic.ReplayStartTime = time;
+		outbox->Statistic.Replayed = 0;
+	}
+
+	uint32_t burst = adapter->Internal.ReplayPeriod * MQTT_OUTBOX_REPLAY_BURST;
+
+	if (time - adapter->Internal.ReplayTimeStamp > burst)
+	{
+		adapter->Internal.ReplayTimeStamp = time - burst;
+	}
+
+	while (port->IsConnected
+			&& !MqttOutboxIsEmpty(outbox)
+			&& time - adapter->Internal.ReplayTimeStamp >= adapter->Internal.ReplayPeriod)
+	{
+		//the replay doesn't wait for the window, it continues on the next acknowledgments
+		if (adapter->QoS != MQTTQoS0 && adapter->Internal.InFlightCount >= adapter->Internal.InFlightWindow)
+		{
+			break;
+		}
+
+		int size = MqttOutboxPeek(outbox, adapter->Internal.ReplayBuffer, adapter->Internal.ReplayBufferSize);
+
+		if (size == 0)
+		{
+			break;
+		}
+
+		if (size > 0)
+		{
+			MqttPortFragmentT fragment =
+			{
+				.Data = adapter->Internal.ReplayBuffer,
+				.Size = size
+			};
+
+			//the record stays in the outbox until the publish is sent (QoS0) or has its slot,
+			//the ReplayBuffer is not larger than a slot, so a read record always fits
+			if (privatePublishDirect(port, adapter, adapter->TxTopic, adapter->Internal.TxTopicLength, &fragment, 1) != xResultAccept)
+			{
+				break;
+			}
+		}
+
+		//a record that can't be read is removed to not block the replay
+		MqttOutboxRemove(outbox);
+
+		adapter->Internal.ReplayTimeStamp += adapter->Internal.ReplayPeriod;
+		outbox->Statistic.ReplayTime = time - outbox->Statistic.ReplayStartTime;
+	}
+}
+//------------------------------------------------------------------------------
+static void privateCoalesceFlush(xPortT* port, MqttPortAdapterT* adapter)
+{
+	uint32_t latency = xSystemGetTime() - adapter->Internal.CoalesceTimeStamp;
+
+	if (latency > adapter->Internal.Statistic.CoalesceLatency)
+	{
+		adapter->Internal.Statistic.CoalesceLatency = latency;
+	}
+
+	privatePublishPayload(port, adapter, adapter->Internal.CoalesceBuffer.Data, adapter->Internal.CoalesceBuffer.DataSize);
+
+	xDataBufferClear(&adapter->Internal.CoalesceBuffer);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief adds a record to the coalescing buffer. Each record is prefixed by its size
+ * (2 bytes, big endian), so the receiving side can split the publish back into records.
+ * The buffer is published when it reaches CoalesceThreshold, or by the handler
+ * when CoalesceDeadline has passed since the first record was added.
+ */
+static void privateCoalesce(xPortT* port, MqttPortAdapterT* adapter, uint8_t* data, uint16_t size)
+{
+	uint8_t header[] = { (uint8_t)(size >> 8), (uint8_t)size };
+
+	if (xDataBufferGetFreeSize(&adapter->Internal.CoalesceBuffer) < size + sizeof(header))
+	{
+		if (adapter->Internal.CoalesceBuffer.DataSize)
+		{
+			privateCoalesceFlush(port, adapter);
+		}
+
+		if (xDataBufferGetFreeSize(&adapter->Internal.CoalesceBuffer) < size + sizeof(header))
+		{
+			adapter->Internal.Statistic.Dropped++;
+			return;
+		}
+	}
+
+	if (!adapter->Internal.CoalesceBuffer.DataSize)
+	{
+		adapter->Internal.CoalesceTimeStamp = xSystemGetTime();
+
+#ifdef INC_FREERTOS_H
+		//the port task has to wake up on the deadline
+		xSemaphoreGive(adapter->Internal.EventSemaphore);
+#endif
+	}
 
-//==============================================================================
-//types:
+	xDataBufferAdd(&adapter->Internal.CoalesceBuffer, header, sizeof(header));
+	xDataBufferAdd(&adapter->Internal.CoalesceBuffer, data, size);
 
-enum
+	adapter->Internal.Statistic.Records++;
+
+	if (adapter->Internal.CoalesceBuffer.DataSize >= adapter->Internal.CoalesceThreshold)
+	{
+		privateCoalesceFlush(port, adapter);
+	}
+}
+//------------------------------------------------------------------------------
+static void privateTransmissionPublish(xPortT* port, MqttPortAdapterT* adapter, uint8_t* data, uint16_t size)
 {
-	ConncetionStateCreateSocket,
-	ConncetionStateConnectSocket,
-	ConncetionStateConnectToBroker,
-	ConncetionStateSubscribe,
-	ConncetionStateComplited
+	if (adapter->Internal.CoalesceThreshold)
+	{
+		privateCoalesce(port, adapter, data, size);
+	}
+	else
+	{
+		privatePublishPayload(port, adapter, data, size);
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief publishes the queued records selected by the egress scheduler. The records of
+ * EgressPortTopic take the path of the port transmissions, the others are published as they are.
+ */
+static void privateEgressSchedule(xPortT* port, MqttPortAdapterT* adapter)
+{
+	MqttEgressT* egress = adapter->Internal.Egress;
+	MqttEgressRecordT record;
+	uint8_t burst = MQTT_EGRESS_BURST;
 
-};
-//==============================================================================
-//variables:
+	while (port->IsConnected && burst-- && MqttEgressPeek(egress, xSystemGetTime(), &record))
+	{
+		//the records wait in their queues for a free slot of the window
+		if (adapter->QoS != MQTTQoS0 && adapter->Internal.InFlightCount >= adapter->Internal.InFlightWindow)
+		{
+			break;
+		}
+
+		if (record.Topic == adapter->Internal.EgressPortTopic)
+		{
+			privateTransmissionPublish(port, adapter, record.Data, record.Size);
+		}
+		else
+		{
+			MqttEgressTopicT* topic = &egress->Topics[record.Topic];
+			MqttPortFragmentT fragment =
+			{
+				.Data = record.Data,
+				.Size = record.Size
+			};
 
+			if (privatePublishDirect(port, adapter, topic->Name, topic->NameLength, &fragment, 1) != xResultAccept)
+			{
+				adapter->Internal.Statistic.Dropped++;
+			}
+		}
 
-//==============================================================================
-//prototypes:
+		MqttEgressRemove(egress, &record, xSystemGetTime());
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief subscribes to RxTopic and to the filters of the router.
+ */
+static xResult privateSubscribe(MqttPortAdapterT* adapter)
+{
+	MQTTSubscribeInfo_t info[MQTT_PORT_SUBSCRIBE_BATCH];
+	MqttRouterT* router = adapter->Internal.Router;
+	uint16_t filtersCount = 1 + (router ? router->RoutesCount : 0);
+	uint16_t filter = 0;
 
-static uint32_t privateMQTTGetTime(void);
+	while (filter < filtersCount)
+	{
+		uint8_t count = 0;
 
-static void privateMQTTCallback(struct MQTTContext * pContext,
-        struct MQTTPacketInfo * pPacketInfo,
-        struct MQTTDeserializedInfo * pDeserializedInfo);
-//==============================================================================
-//functions:
+		while (count < MQTT_PORT_SUBSCRIBE_BATCH && filter < filtersCount)
+		{
+			const char* topicFilter = filter == 0 ? adapter->RxTopic : router->Routes[filter - 1].Filter;
 
-static void PrivateHandler(xPortT* port)
-{
-	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
+			info[count].qos = adapter->QoS;
+			info[count].pTopicFilter = topicFilter;
+			info[count].topicFilterLength = strlen(topicFilter);
+
+			count++;
+			filter++;
+		}
+
+		uint16_t packetId = MQTT_GetPacketId(&adapter->Internal.MQTTContext);
+
+		MQTTStatus_t result = MQTT_Subscribe(&adapter->Internal.MQTTContext,
+				info,
+				count,
+				packetId);
+
+		if (result != MQTTSuccess)
+		{
+			return xResultError;
+		}
+	}
 
-	MQTT_ReceiveLoop(&adapter->Internal.MQTTContext);
-	MQTT_ProcessLoop(&adapter->Internal.MQTTContext);
+	return xResultAccept;
 }
 //------------------------------------------------------------------------------
 static xResult privateConnectHandler(xPortT* port, MqttPortAdapterT* adapter)
 {
 	if (adapter->Internal.Socket == NULL)
 	{
+		if (adapter->Internal.Reconnect && !NetReconnectIsAllowed(adapter->Internal.Reconnect, xSystemGetTime()))
+		{
+			return xResultError;
+		}
+
 		adapter->Internal.ConnectState = ConncetionStateCreateSocket;
 	}
 
@@ -59,9 +825,18 @@ static xResult privateConnectHandler(xPortT* port, MqttPortAdapterT* adapter)
 
 			if (socket == NULL)
 			{
-				break;
+				return privateConnectFailed(port, adapter);
 			}
 
+#ifdef INC_FREERTOS_H
+			FreeRTOS_setsockopt(socket, 0, FREERTOS_SO_SET_SEMAPHORE,
+								&adapter->Internal.EventSemaphore,
+								sizeof(adapter->Internal.EventSemaphore));
+#endif
+
+			TickType_t sendTimeout = pdMS_TO_TICKS(MQTT_PORT_SEND_TIMEOUT);
+			FreeRTOS_setsockopt(socket, 0, FREERTOS_SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+
 			adapter->Internal.Socket = socket;
 			adapter->Internal.ConnectState = ConncetionStateConnectSocket;
 		}
@@ -74,8 +849,25 @@ static xResult privateConnectHandler(xPortT* port, MqttPortAdapterT* adapter)
 
 			if (FreeRTOS_connect(adapter->Internal.Socket, &sAddr, sizeof(sAddr)) < 0)
 			{
-				break;
+				return privateConnectFailed(port, adapter);
+			}
+
+#if MQTT_PORT_TLS_ENABLE == 1
+			if (adapter->Internal.Tls)
+			{
+				TickType_t handshakeTimeout = pdMS_TO_TICKS(MQTT_PORT_TLS_HANDSHAKE_TIMEOUT);
+				FreeRTOS_setsockopt(adapter->Internal.Socket, 0, FREERTOS_SO_RCVTIMEO, &handshakeTimeout, sizeof(handshakeTimeout));
+
+				if (MqttTlsConnect(adapter->Internal.Tls, adapter->Internal.Socket, MQTT_PORT_TLS_HANDSHAKE_TIMEOUT) != xResultAccept)
+				{
+					return privateConnectFailed(port, adapter);
+				}
 			}
+#endif
+
+			//the receiving doesn't block, the port task waits for the socket events instead
+			TickType_t receiveTimeout = 0;
+			FreeRTOS_setsockopt(adapter->Internal.Socket, 0, FREERTOS_SO_RCVTIMEO, &receiveTimeout, sizeof(receiveTimeout));
 
 			adapter->Internal.ConnectState = ConncetionStateConnectToBroker;
 		}
@@ -84,8 +876,9 @@ static xResult privateConnectHandler(xPortT* port, MqttPortAdapterT* adapter)
 		{
 			MQTTConnectInfo_t connectInfo;
 			memset(&connectInfo, 0, sizeof(connectInfo));
-			connectInfo.keepAliveSeconds = 0;
-			connectInfo.cleanSession = true;
+			connectInfo.keepAliveSeconds = adapter->KeepAlive;
+			//the session keeps the QoS1/QoS2 state over reconnects
+			connectInfo.cleanSession = adapter->QoS == MQTTQoS0;
 			connectInfo.pClientIdentifier = adapter->Id;
 			connectInfo.clientIdentifierLength = strlen(adapter->Id);
 
@@ -94,38 +887,33 @@ static xResult privateConnectHandler(xPortT* port, MqttPortAdapterT* adapter)
 			MQTTStatus_t result = MQTT_Connect(&adapter->Internal.MQTTContext,
 					&connectInfo,
 					NULL,
-					100,
+					MQTT_PORT_CONNACK_TIMEOUT,
 					&sessionPresent);
 
 			if (result != MQTTSuccess)
 			{
-				break;
+				return privateConnectFailed(port, adapter);
 			}
 
+			privateInFlightResend(adapter, sessionPresent);
+
 			adapter->Internal.ConnectState = ConncetionStateSubscribe;
 		}
 
 		case ConncetionStateSubscribe:
 		{
-			MQTTSubscribeInfo_t info;
-			info.qos = MQTTQoS0;
-			info.pTopicFilter = adapter->RxTopic;
-			info.topicFilterLength = strlen(adapter->RxTopic);
-
-			uint16_t packetId = MQTT_GetPacketId(&adapter->Internal.MQTTContext);
-
-			MQTTStatus_t result = MQTT_Subscribe(&adapter->Internal.MQTTContext,
-					&info,
-					1,
-					packetId);
-
-			if (result != MQTTSuccess)
+			if (privateSubscribe(adapter) != xResultAccept)
 			{
-				return xResultError;
+				return privateConnectFailed(port, adapter);
 			}
 
 			adapter->Internal.ConnectState = ConncetionStateComplited;
 			port->IsConnected = true;
+
+			if (adapter->Internal.Reconnect)
+			{
+				NetReconnectConnected(adapter->Internal.Reconnect, xSystemGetTime());
+			}
 		}
 
 		default: break;
@@ -158,12 +946,20 @@ static xResult PrivateRequestListener(xPortT* port, xPortAdapterRequestSelector
 											privateMQTTCallback,
 											&adapter->Internal.MQTTFixedBuffer);
 
+			if (result == MQTTSuccess && adapter->Internal.InFlightWindow)
+			{
+				result = MQTT_InitStatefulQoS(&adapter->Internal.MQTTContext,
+											adapter->Internal.OutgoingPublishRecords,
+											adapter->Internal.InFlightWindow,
+											adapter->Internal.IncomingPublishRecords,
+											adapter->Internal.InFlightWindow);
+			}
+
 			if (result == MQTTSuccess)
 			{
 				port->IsOpen = true;
 			}
 
-
 			break;
 		}
 
@@ -187,7 +983,7 @@ static xResult PrivateRequestListener(xPortT* port, xPortAdapterRequestSelector
 
 		case xPortAdapterRequestStartTransmission:
 #ifdef INC_FREERTOS_H
-			xSemaphoreTake(adapter->Internal.TransactionMutex, portMAX_DELAY);
+			xSemaphoreTakeRecursive(adapter->Internal.TransactionMutex, portMAX_DELAY);
 #endif
 			break;
 
@@ -195,23 +991,31 @@ static xResult PrivateRequestListener(xPortT* port, xPortAdapterRequestSelector
 		{
 			if (adapter->Internal.TxDataBuffer.DataSize)
 			{
-				MQTTPublishInfo_t publishInfo = { 0 };
-				publishInfo.qos = MQTTQoS0;
-				publishInfo.pTopicName = adapter->TxTopic;
-				publishInfo.topicNameLength = adapter->Internal.TxTopicLength;
-				publishInfo.pPayload = adapter->Internal.TxDataBuffer.Data;
-				publishInfo.payloadLength = adapter->Internal.TxDataBuffer.DataSize;
-
-				MQTT_Publish(&adapter->Internal.MQTTContext, &publishInfo, 0);
-
-				//xSemaphoreTake(adapter->Internal.TxSemaphore, 2000);
+				//while the broker is unreachable the transmissions go to the outbox directly
+				if (adapter->Internal.Egress
+					&& adapter->Internal.EgressPortTopic != MQTT_PORT_EGRESS_TOPIC_NONE
+					&& port->IsConnected)
+				{
+					MqttEgressAdd(adapter->Internal.Egress,
+									adapter->Internal.EgressPortTopic,
+									adapter->Internal.TxDataBuffer.Data,
+									adapter->Internal.TxDataBuffer.DataSize,
+									xSystemGetTime());
+#ifdef INC_FREERTOS_H
+					xSemaphoreGive(adapter->Internal.EventSemaphore);
+#endif
+				}
+				else
+				{
+					privateTransmissionPublish(port, adapter, adapter->Internal.TxDataBuffer.Data, adapter->Internal.TxDataBuffer.DataSize);
+				}
 
 				xDataBufferClear(&adapter->Internal.TxDataBuffer);
 			}
 
 #ifdef INC_FREERTOS_H
 
-			xSemaphoreGive(adapter->Internal.TransactionMutex);
+			xSemaphoreGiveRecursive(adapter->Internal.TransactionMutex);
 #endif
 			break;
 		}
@@ -242,21 +1046,34 @@ static int32_t privateTransportReceive(NetworkContext_t* pNetworkContext, void*
 		return -1;
 	}
 
-	BaseType_t flags = 0;//FREERTOS_MSG_DONTWAIT;
+	//the library calls it with TransactionMutex held: a blocking receive would stall the transmitting tasks,
+	//the port task waits for the socket events instead
+	BaseType_t flags = FREERTOS_MSG_DONTWAIT;
 
 	adapter->Internal.RxAttempts++;
 
-	BaseType_t bytesRead = FreeRTOS_recv(adapter->Internal.Socket, pBuffer, bytesToRecv, flags);
+	BaseType_t bytesRead;
+
+#if MQTT_PORT_TLS_ENABLE == 1
+	if (adapter->Internal.Tls)
+	{
+		bytesRead = MqttTlsReceive(adapter->Internal.Tls, pBuffer, bytesToRecv);
+	}
+	else
+#endif
+	{
+		bytesRead = FreeRTOS_recv(adapter->Internal.Socket, pBuffer, bytesToRecv, flags);
+	}
 
 	if (bytesRead < 0)
 	{
-		FreeRTOS_closesocket(adapter->Internal.Socket);
-		adapter->Internal.Socket = NULL;
-		port->IsConnected = false;
+		privateSocketClose(port, adapter);
 
 		return -1;
 	}
 
+	adapter->Internal.RxBytes += bytesRead;
+
 	return bytesRead;
 }
 //------------------------------------------------------------------------------
@@ -277,13 +1094,22 @@ static int32_t privateTransportSend(NetworkContext_t* pNetworkContext, const voi
 
 	while (sended < bytesToSend)
 	{
-		int len = FreeRTOS_send(adapter->Internal.Socket, mem + sended, bytesToSend - sended, 0);
+		int len;
+
+#if MQTT_PORT_TLS_ENABLE == 1
+		if (adapter->Internal.Tls)
+		{
+			len = MqttTlsSend(adapter->Internal.Tls, mem + sended, bytesToSend - sended);
+		}
+		else
+#endif
+		{
+			len = FreeRTOS_send(adapter->Internal.Socket, mem + sended, bytesToSend - sended, 0);
+		}
 
 		if(len < 0)
 		{
-			FreeRTOS_closesocket(adapter->Internal.Socket);
-			adapter->Internal.Socket = NULL;
-			port->IsConnected = false;
+			privateSocketClose(port, adapter);
 
 			return -1;
 		}
@@ -294,20 +1120,133 @@ static int32_t privateTransportSend(NetworkContext_t* pNetworkContext, const voi
 	return sended;
 }
 //------------------------------------------------------------------------------
+/**
+ * @brief the vectors are copied straight into the TX stream of the socket and committed
+ * at once, so the packet is one copy and one event for the IP task instead of one per vector.
+ * If the stream has no space for the whole packet (or TLS is used) the first vector is sent
+ * by privateTransportSend and the library continues with the rest.
+ */
+static int32_t privateTransportWritev(NetworkContext_t* pNetworkContext, TransportOutVector_t* pIoVec, size_t ioVecCount)
+{
+	xPortT* port = (void*)pNetworkContext;
+	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
+
+	if (!port->IsOpen || adapter->Internal.Socket == NULL)
+	{
+		return -1;
+	}
+
+	size_t bytesToSend = 0;
+
+	for (size_t i = 0; i < ioVecCount; i++)
+	{
+		bytesToSend += pIoVec[i].iov_len;
+	}
+
+	BaseType_t length;
+	uint8_t* head = adapter->Internal.Tls ? NULL : FreeRTOS_get_tx_head(adapter->Internal.Socket, &length);
+
+	//the TX stream is created by the first FreeRTOS_send
+	if (!head || FreeRTOS_tx_space(adapter->Internal.Socket) < (BaseType_t)bytesToSend)
+	{
+		return privateTransportSend(pNetworkContext, pIoVec->iov_base, pIoVec->iov_len);
+	}
+
+	adapter->Internal.TxAttempts++;
+
+	BaseType_t added = 0;
+
+	for (size_t i = 0; i < ioVecCount; i++)
+	{
+		const uint8_t* data = pIoVec[i].iov_base;
+		size_t size = pIoVec[i].iov_len;
+
+		while (size)
+		{
+			//the stream is circular: the part up to its end is committed and the head is taken again
+			if (added == length)
+			{
+				if (FreeRTOS_send(adapter->Internal.Socket, NULL, added, 0) < 0)
+				{
+					privateSocketClose(port, adapter);
+
+					return -1;
+				}
+
+				added = 0;
+
+				head = FreeRTOS_get_tx_head(adapter->Internal.Socket, &length);
+			}
+
+			size_t part = size < (size_t)(length - added) ? size : (size_t)(length - added);
+
+			memcpy(head + added, data, part);
+
+			added += part;
+			data += part;
+			size -= part;
+		}
+	}
+
+	if (FreeRTOS_send(adapter->Internal.Socket, NULL, added, 0) < 0)
+	{
+		privateSocketClose(port, adapter);
+
+		return -1;
+	}
+
+	return bytesToSend;
+}
+//------------------------------------------------------------------------------
 static void privateMQTTCallback(struct MQTTContext * pContext,
         struct MQTTPacketInfo * pPacketInfo,
         struct MQTTDeserializedInfo * pDeserializedInfo)
 {
+	xPortT* port = (void*)pContext->transportInterface.pNetworkContext;
+	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
+
+	//PUBREC and PUBREL are answered by the library, the publish is complete on PUBACK or PUBCOMP
+	if (pPacketInfo->type == MQTT_PACKET_TYPE_PUBACK || pPacketInfo->type == MQTT_PACKET_TYPE_PUBCOMP)
+	{
+		MqttPortInFlightPublishT* slot = privateInFlightFind(adapter, pDeserializedInfo->packetIdentifier);
+
+		if (slot && pDeserializedInfo->packetIdentifier != MQTT_PACKET_ID_INVALID)
+		{
+			slot->PacketId = MQTT_PACKET_ID_INVALID;
+			adapter->Internal.InFlightCount--;
+			adapter->Internal.Statistic.Acknowledged++;
+		}
+
+		return;
+	}
+
+	//taken by MQTT_ReceiveLoop while waiting for a slot of the window, the library leaves the wait set
+	if (pPacketInfo->type == MQTT_PACKET_TYPE_PINGRESP)
+	{
+		pContext->waitingForPingResp = false;
+		return;
+	}
+
 	if (pDeserializedInfo->pPublishInfo)
 	{
-		xPortT* port = (void*)pContext->transportInterface.pNetworkContext;
+		MQTTPublishInfo_t* publishInfo = pDeserializedInfo->pPublishInfo;
+
+		if (adapter->Internal.Router
+			&& MqttRouterDispatch(adapter->Internal.Router,
+									publishInfo->pTopicName,
+									publishInfo->topicNameLength,
+									(void*)publishInfo->pPayload,
+									publishInfo->payloadLength))
+		{
+			return;
+		}
 
 		RxDataPacketT rxPacket;
 		rxPacket.Data = (void*)pDeserializedInfo->pPublishInfo->pPayload;
 		rxPacket.FullSize = pDeserializedInfo->pPublishInfo->payloadLength;
 		rxPacket.Size = rxPacket.FullSize - 1;
 
-		TerminalReceiveData(port, &rxPacket);
+		TerminalCommandsReceive(port, &rxPacket);
 	}
 
 	//MQTT_Publish(pContext, &publishInfo, 0);
@@ -338,6 +1277,160 @@ static int PrivateReceive(xPortT* port, void* data, uint32_t size)
 {
 	return -xResultNotSupported;
 }
+//------------------------------------------------------------------------------
+static void privateWaitTimeUpdate(uint32_t* waitTime, uint32_t time, uint32_t deadline)
+{
+	int32_t remaining = (int32_t)(deadline - time);
+
+	if (remaining < 0)
+	{
+		remaining = 0;
+	}
+
+	if ((uint32_t)remaining < *waitTime)
+	{
+		*waitTime = remaining;
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief blocks the port task until the socket has an event (data, ack, close),
+ * a deferred publish is added, or the nearest timer expires: the keep-alive PINGREQ,
+ * the PINGRESP timeout, the coalescing deadline, the next reconnect attempt or the refill
+ * of an egress bucket. Not longer than maxTime.
+ */
+void MqttPortAdapterWaitEvent(xPortT* port, uint32_t maxTime)
+{
+	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
+	MQTTContext_t* context = &adapter->Internal.MQTTContext;
+
+	uint32_t time = xSystemGetTime();
+	uint32_t waitTime = maxTime;
+
+	if (port->IsConnected)
+	{
+		if (context->waitingForPingResp)
+		{
+			//coreMQTT times out after MQTT_PINGRESP_TIMEOUT_MS, waking at it would spin for a tick
+			privateWaitTimeUpdate(&waitTime, time, context->pingReqSendTimeMs + MQTT_PINGRESP_TIMEOUT_MS + 1);
+		}
+		else if (adapter->KeepAlive)
+		{
+			privateWaitTimeUpdate(&waitTime, time, context->lastPacketTxTime + adapter->KeepAlive * 1000);
+		}
+	}
+
+	if (adapter->Internal.CoalesceBuffer.DataSize)
+	{
+		privateWaitTimeUpdate(&waitTime, time, adapter->Internal.CoalesceTimeStamp + adapter->Internal.CoalesceDeadline);
+	}
+
+	if (port->IsConnected && adapter->Internal.Egress)
+	{
+		uint32_t egressTime = MqttEgressGetWaitTime(adapter->Internal.Egress, time);
+
+		if (egressTime < waitTime)
+		{
+			waitTime = egressTime;
+		}
+	}
+
+	if (!port->IsConnected && adapter->Internal.Reconnect)
+	{
+		uint32_t reconnectTime = NetReconnectGetWaitTime(adapter->Internal.Reconnect, time);
+
+		if (reconnectTime < waitTime)
+		{
+			waitTime = reconnectTime;
+		}
+	}
+
+#if MQTT_PORT_TLS_ENABLE == 1
+	if (adapter->Internal.Tls && MqttTlsPending(adapter->Internal.Tls))
+	{
+		waitTime = 0;
+	}
+#endif
+
+	if (port->IsConnected && adapter->Internal.IsReceivePending)
+	{
+		waitTime = 0;
+	}
+
+	if (port->IsConnected && adapter->Internal.Outbox && !MqttOutboxIsEmpty(adapter->Internal.Outbox))
+	{
+		privateWaitTimeUpdate(&waitTime, time, adapter->Internal.ReplayTimeStamp + adapter->Internal.ReplayPeriod);
+	}
+
+#ifdef INC_FREERTOS_H
+	if (waitTime)
+	{
+		xSemaphoreTake(adapter->Internal.EventSemaphore, pdMS_TO_TICKS(waitTime));
+	}
+#endif
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief publishes the caller-owned fragments as one payload to TxTopic. With QoS0 the fragments
+ * go to the socket without an intermediate copy, with QoS1/QoS2 they are gathered into
+ * the in-flight slot (the copy is kept for the resend), while the broker is unreachable
+ * they are stored in the outbox. The coalesced transmissions are published before.
+ */
+xResult MqttPortAdapterPublish(xPortT* port, const MqttPortFragmentT* fragments, uint8_t count)
+{
+	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
+
+	if (!fragments || !count || count > MQTT_PORT_PUBLISH_FRAGMENTS)
+	{
+		return xResultError;
+	}
+
+#ifdef INC_FREERTOS_H
+	xSemaphoreTakeRecursive(adapter->Internal.TransactionMutex, portMAX_DELAY);
+#endif
+
+	if (adapter->Internal.CoalesceBuffer.DataSize)
+	{
+		privateCoalesceFlush(port, adapter);
+	}
+
+	privatePublishFragments(port, adapter, fragments, count);
+
+#ifdef INC_FREERTOS_H
+	xSemaphoreGiveRecursive(adapter->Internal.TransactionMutex);
+#endif
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief queues the record to the egress topic, it is published by the port task
+ * in the order of the class priority and within the budget of the topic.
+ * @return xResultError if the record is dropped by the policy of the topic or there is no scheduler
+ */
+xResult MqttPortAdapterEnqueue(xPortT* port, uint8_t topic, const void* data, uint16_t size)
+{
+	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
+
+	if (!adapter->Internal.Egress)
+	{
+		return xResultError;
+	}
+
+#ifdef INC_FREERTOS_H
+	xSemaphoreTakeRecursive(adapter->Internal.TransactionMutex, portMAX_DELAY);
+#endif
+
+	xResult result = MqttEgressAdd(adapter->Internal.Egress, topic, data, size, xSystemGetTime());
+
+#ifdef INC_FREERTOS_H
+	xSemaphoreGiveRecursive(adapter->Internal.TransactionMutex);
+
+	xSemaphoreGive(adapter->Internal.EventSemaphore);
+#endif
+
+	return result;
+}
 //==============================================================================
 //initializations:
 
@@ -363,8 +1456,9 @@ xResult MqttPortAdapterInit(xPortT* port, MqttPortAdapterT* adapter, MqttPortAda
 		memset(&adapter->Internal, 0, sizeof(adapter->Internal));
 
 #ifdef INC_FREERTOS_H
-		adapter->Internal.TransactionMutex = xSemaphoreCreateMutex();
+		adapter->Internal.TransactionMutex = xSemaphoreCreateRecursiveMutex();
 		adapter->Internal.TxSemaphore = xSemaphoreCreateBinary();
+		adapter->Internal.EventSemaphore = xSemaphoreCreateBinary();
 #endif
 
 		adapter->TxTopic = init->TxTopic;
@@ -376,6 +1470,44 @@ xResult MqttPortAdapterInit(xPortT* port, MqttPortAdapterT* adapter, MqttPortAda
 		adapter->Internal.TxDataBuffer.Memory = init->TxBuffer;
 		adapter->Internal.TxDataBuffer.Size = init->TxBufferSize;
 
+		adapter->Internal.OutgoingPublishRecords = init->OutgoingPublishRecords;
+		adapter->Internal.IncomingPublishRecords = init->IncomingPublishRecords;
+		adapter->Internal.InFlight = init->InFlight;
+		adapter->Internal.InFlightPayloadSize = init->InFlightPayloadSize;
+		adapter->Internal.InFlightWindow = init->InFlight ? init->InFlightWindow : 0;
+
+		adapter->Internal.CoalesceBuffer.Memory = init->CoalesceBuffer;
+		adapter->Internal.CoalesceBuffer.Size = init->CoalesceBufferSize;
+		adapter->Internal.CoalesceThreshold = init->CoalesceBuffer ? init->CoalesceThreshold : 0;
+		adapter->Internal.CoalesceDeadline = init->CoalesceDeadline;
+
+		adapter->Internal.Tls = init->Tls;
+		adapter->Internal.Router = init->Router;
+		adapter->Internal.Reconnect = init->Reconnect;
+		adapter->Internal.Egress = init->Egress;
+		adapter->Internal.EgressPortTopic = init->EgressPortTopic;
+
+		adapter->Internal.CompressBuffer = init->CompressBuffer;
+		adapter->Internal.CompressBufferSize = init->CompressBufferSize;
+		adapter->Internal.CompressWindowBits = init->CompressWindowBits;
+		adapter->Internal.CompressLookaheadBits = init->CompressLookaheadBits;
+
+		adapter->Internal.Outbox = init->ReplayBuffer ? init->Outbox : NULL;
+		adapter->Internal.ReplayBuffer = init->ReplayBuffer;
+		adapter->Internal.ReplayBufferSize = init->ReplayBufferSize;
+		adapter->Internal.ReplayPeriod = init->ReplayRate ? 1000 / init->ReplayRate : 0;
+
+		for (uint8_t i = 0; i < adapter->Internal.InFlightWindow; i++)
+		{
+			adapter->Internal.InFlight[i].Data = init->InFlightMemory + i * init->InFlightPayloadSize;
+			adapter->Internal.InFlight[i].PacketId = MQTT_PACKET_ID_INVALID;
+		}
+
+		if (!adapter->Internal.InFlightWindow)
+		{
+			adapter->QoS = MQTTQoS0;
+		}
+
 		/*adapter->Internal.RxReceiver.Base.Parent = port;
 		adapter->Internal.RxReceiver.Buffer = init->RxBuffer;
 		adapter->Internal.RxReceiver.BufferSize = init->RxBufferSize;
@@ -385,6 +1517,7 @@ xResult MqttPortAdapterInit(xPortT* port, MqttPortAdapterT* adapter, MqttPortAda
 
 		memset(&adapter->Internal.MQTTContext, 0, sizeof(adapter->Internal.MQTTContext));
 		adapter->Internal.TransportInterface.send = privateTransportSend;
+		adapter->Internal.TransportInterface.writev = privateTransportWritev;
 		adapter->Internal.TransportInterface.recv = privateTransportReceive;
 		adapter->Internal.TransportInterface.pNetworkContext = (void*)port;
 
@@ -397,3 +1530,4 @@ xResult MqttPortAdapterInit(xPortT* port, MqttPortAdapterT* adapter, MqttPortAda
   return xResultError;
 }
 //==============================================================================
+#endif //MQTT_TARGET_LAYOUT
@@ -16,14 +16,64 @@ extern "C" {
 #include "Abstractions/xNet/xNet.h"
 #include "FreeRTOS_IP.h"
 #include "FreeRTOS-Plus-MQTT/include/core_mqtt.h"
+#include "MqttClient/Outbox/MqttOutbox.h"
+#include "MqttClient/Router/MqttRouter.h"
+#include "MqttClient/Egress/MqttEgress.h"
+#include "Net/Reconnect/NetReconnect.h"
+//==============================================================================
+//defines:
+
+#define MQTT_PORT_EGRESS_TOPIC_NONE 0xFF //the port transmissions don't take the egress scheduler
 //==============================================================================
 //types:
 
+/// @brief copy of an unacknowledged QoS1/QoS2 publish, kept for the resend after a reconnect
+typedef struct
+{
+	uint8_t* Data;
+	uint16_t Size;
+
+	const char* Topic;
+	uint16_t TopicLength;
+
+	uint16_t PacketId; //0 - the slot is free
+
+} MqttPortInFlightPublishT;
+//------------------------------------------------------------------------------
+/// @brief caller-owned part of a publish payload, see MqttPortAdapterPublish
+typedef struct
+{
+	const void* Data;
+	uint16_t Size;
+
+} MqttPortFragmentT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Published;
+	uint32_t Acknowledged;
+	uint32_t Resent;
+	uint32_t WindowIsFull;
+	uint32_t Dropped;
+
+	uint32_t Records; //records added to the coalescing buffer
+	uint32_t CoalesceLatency; //ms, maximum time a record waited in the coalescing buffer
+
+	uint32_t PublishedBytes; //payload bytes given to the socket
+	uint64_t PublishCycles; //CPU cycles spent on them: PublishCycles * 1024 / PublishedBytes - cycles per KB
+
+	uint32_t CompressInputBytes;
+	uint32_t CompressOutputBytes; //CompressOutputBytes / CompressInputBytes - ratio
+	uint32_t CompressCycles; //CompressCycles / CompressInputBytes - cycles per byte
+
+} MqttPortStatisticT;
+//------------------------------------------------------------------------------
 typedef struct
 {
 #ifdef INC_FREERTOS_H
 	SemaphoreHandle_t TransactionMutex;
 	SemaphoreHandle_t TxSemaphore;
+	SemaphoreHandle_t EventSemaphore; //given by the socket events and by the deferred publishes
 #endif
 
 	TransportInterface_t TransportInterface;
@@ -31,15 +81,51 @@ typedef struct
 
 	MQTTContext_t MQTTContext;
 	xSocket_t Socket;
+	void* Tls; //MqttTlsT, NULL - plain TCP
+
+	MqttRouterT* Router;
+	NetReconnectT* Reconnect;
+
+	MqttEgressT* Egress;
+	uint8_t EgressPortTopic;
+
+	uint8_t* CompressBuffer;
+	uint16_t CompressBufferSize;
+	uint8_t CompressWindowBits;
+	uint8_t CompressLookaheadBits;
 
 	uint32_t TxAttempts;
 	uint32_t RxAttempts;
+	uint32_t RxBytes;
 
 	MQTTFixedBuffer_t MQTTFixedBuffer;
 
 	xDataBufferT TxDataBuffer;
 	//xRxReceiverT RxReceiver;
 
+	MQTTPubAckInfo_t* OutgoingPublishRecords;
+	MQTTPubAckInfo_t* IncomingPublishRecords;
+	MqttPortInFlightPublishT* InFlight;
+	uint16_t InFlightPayloadSize;
+	uint8_t InFlightWindow;
+	uint8_t InFlightCount;
+	bool IsReceiving; //the receive loop is active, the context must not be reentered
+	bool IsReceivePending; //the last pass stopped on MQTT_PORT_RECEIVE_BURST with packets left
+
+	xDataBufferT CoalesceBuffer;
+	uint32_t CoalesceTimeStamp;
+	uint16_t CoalesceThreshold;
+	uint16_t CoalesceDeadline;
+
+	MqttOutboxT* Outbox;
+	uint8_t* ReplayBuffer;
+	uint16_t ReplayBufferSize;
+	uint16_t ReplayPeriod; //ms between the replayed records
+	uint32_t ReplayTimeStamp;
+	bool IsReplaying;
+
+	MqttPortStatisticT Statistic;
+
 	uint8_t RxTopicLength;
 	uint8_t TxTopicLength;
 	uint8_t ConnectState;
@@ -58,6 +144,9 @@ typedef struct
 	xNetAddressT NetAddress;
 	uint16_t NetPort;
 
+	MQTTQoS_t QoS;
+	uint16_t KeepAlive; //seconds, 0 - disabled
+
 } MqttPortAdapterT;
 //------------------------------------------------------------------------------
 typedef struct
@@ -71,6 +160,54 @@ typedef struct
 	uint8_t* TxBuffer;
 	uint16_t TxBufferSize;
 
+	/// @brief QoS1/QoS2 state, the arrays must hold InFlightWindow elements.
+	/// InFlightMemory holds InFlightWindow payloads of InFlightPayloadSize bytes
+	MQTTPubAckInfo_t* OutgoingPublishRecords;
+	MQTTPubAckInfo_t* IncomingPublishRecords;
+	MqttPortInFlightPublishT* InFlight;
+	uint8_t* InFlightMemory;
+	uint16_t InFlightPayloadSize;
+	uint8_t InFlightWindow;
+
+	/// @brief coalescing of the transmissions into one publish, disabled if CoalesceBuffer is NULL.
+	/// With QoS1/QoS2 InFlightPayloadSize must not be less than CoalesceBufferSize
+	uint8_t* CoalesceBuffer;
+	uint16_t CoalesceBufferSize;
+	uint16_t CoalesceThreshold; //bytes
+	uint16_t CoalesceDeadline; //ms
+
+	/// @brief store-and-forward: while the broker is unreachable the publishes are appended
+	/// to the outbox and replayed in order after the reconnect, ReplayRate records per second
+	MqttOutboxT* Outbox;
+	uint8_t* ReplayBuffer;
+	uint16_t ReplayBufferSize;
+	uint16_t ReplayRate;
+
+	/// @brief initialized MqttTlsT (MQTT_PORT_TLS_ENABLE), NULL - plain TCP
+	void* Tls;
+
+	/// @brief the filters of the router are subscribed with RxTopic, the received publishes
+	/// are dispatched by the topic, unmatched ones go to the terminal. NULL - RxTopic only
+	MqttRouterT* Router;
+
+	/// @brief backoff of the connection attempts, NULL - an attempt on each connect request
+	NetReconnectT* Reconnect;
+
+	/// @brief egress scheduler, NULL - the transmissions are published in the order of the calls.
+	/// While the broker is connected the port transmissions are queued to EgressPortTopic and published
+	/// (coalesced, compressed) when the scheduler selects them, so the higher classes go first.
+	/// MQTT_PORT_EGRESS_TOPIC_NONE - the transmissions are published in the order of the calls
+	MqttEgressT* Egress;
+	uint8_t EgressPortTopic;
+
+	/// @brief compression of the publishes to TxTopic, disabled if CompressBuffer is NULL.
+	/// The payload starts with MqttCompress header, the receiving side uses MqttCompressDecode.
+	/// CompressBuffer must hold the largest payload and MQTT_COMPRESS_HEADER_SIZE
+	uint8_t* CompressBuffer;
+	uint16_t CompressBufferSize;
+	uint8_t CompressWindowBits;
+	uint8_t CompressLookaheadBits;
+
 	//uint8_t* RxBuffer;
 	//uint16_t RxBufferSize;
 
@@ -79,6 +216,11 @@ typedef struct
 //functions:
 
 xResult MqttPortAdapterInit(xPortT* port, MqttPortAdapterT* adapter, MqttPortAdapterInitT* init);
+
+void MqttPortAdapterWaitEvent(xPortT* port, uint32_t maxTime);
+
+xResult MqttPortAdapterPublish(xPortT* port, const MqttPortFragmentT* fragments, uint8_t count);
+xResult MqttPortAdapterEnqueue(xPortT* port, uint8_t topic, const void* data, uint16_t size);
 //==============================================================================
 #ifdef __cplusplus
 }
@@ -1,13 +1,30 @@
 //==============================================================================
 //includes:
 
+#include "MqttClient/MqttClient-ComponentConfig.h"
+
+#if MQTT_TARGET_LAYOUT == MQTT_LWIP_LAYOUT
 #include "MqttPort-Adapter.h"
 #include "Components.h"
+#include "TerminalCommands/TerminalCommands.h"
+#include "main.h"
 #include "Common/xCircleBuffer.h"
+#include "lwip/tcpip.h"
 //==============================================================================
 //defines:
 
 #define RX_CIRCLE_BUFFER_MASK 0xff
+
+#ifndef MQTT_PORT_CONNACK_TIMEOUT
+#define MQTT_PORT_CONNACK_TIMEOUT 3000
+#endif
+
+#ifndef MQTT_PORT_SEND_TIMEOUT
+#define MQTT_PORT_SEND_TIMEOUT 1000
+#endif
+
+#define MQTT_PORT_CONNECT_PENDING 0xFFFF //ConnectStatus until the connection callback
+#define MQTT_PORT_REQUEST_PENDING 1 //RequestResult until the request callback, err_t values are not positive
 //==============================================================================
 //types:
 
@@ -41,186 +58,327 @@ static xCircleBufferT rxCircleBuffer =
 //==============================================================================
 //functions:
 
-static void PrivateHandler(xPortT* port)
+static void RxReceiverEventListener(xRxReceiverT* receiver, xRxReceiverEventSelector selector, void* arg)
 {
-	xRxReceiverRead(&rxReceiver, &rxCircleBuffer);
+	if (selector == xRxReceiverEventEndLine)
+	{
+		TerminalCommandsReceive(receiver->Base.Parent, arg);
+	}
+	else
+	{
+		TerminalReceiveData(receiver->Base.Parent, arg);
+	}
+
+	extern uint32_t EthernetRxTimeStamp;
+	EthernetRxTimeStamp = xSystemGetTime();
 }
 //------------------------------------------------------------------------------
-static void RxReceiverEventListener(xRxReceiverT* receiver, xRxReceiverEventSelector selector, void* arg)
+static void privateIncomingPublish(void* arg, const char* topic, u32_t totalLength)
 {
-	TerminalReceiveData(receiver->Base.Parent, arg);
+	xPortT* port = arg;
+	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
 
-	extern uint32_t EthernetRxTimeStamp;
-	EthernetRxTimeStamp = xSystemGetTime(NULL);
+	adapter->Internal.RxTopicConfirmed = strcmp(topic, adapter->RxTopic) == 0;
 }
 //------------------------------------------------------------------------------
-static void mqtt_incoming_publish_cb(void *arg, const char *topic, u32_t tot_len)
+static void privateIncomingData(void* arg, const u8_t* data, u16_t length, u8_t flags)
 {
 	xPortT* port = arg;
 	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
 
-	uint8_t i = 0;
-	while(adapter->RxTopic[i] != 0)
+	if (!adapter->Internal.RxTopicConfirmed)
 	{
-		if (topic[i] != adapter->RxTopic[i])
-		{
-			return;
-		}
-
-		i++;
+		return;
 	}
 
-	if (topic[i] != 0)
+	//the port task takes the data from the circle buffer in the handler
+	xCircleBufferAdd(&rxCircleBuffer, (uint8_t*)data, length);
+
+	if (flags & MQTT_DATA_FLAG_LAST)
 	{
-		return;
+		adapter->Internal.RxTopicConfirmed = false;
 	}
 
-	adapter->RxTopicConfirmed = true;
+#ifdef INC_FREERTOS_H
+	xSemaphoreGive(adapter->Internal.EventSemaphore);
+#endif
 }
 //------------------------------------------------------------------------------
-static void mqtt_incoming_data_cb(void *arg, const u8_t *data, u16_t len, u8_t flags)
+static void privateConnection(mqtt_client_t* client, void* arg, mqtt_connection_status_t status)
 {
 	xPortT* port = arg;
 	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
 
-	if (adapter->RxTopicConfirmed)
-	{
-		adapter->RxTopicConfirmed = false;
+	adapter->Internal.ConnectStatus = status;
 
-		//xRxReceiverReceive(&adapter->RxReceiver, (void*)data, len);
-		/*RxDataPacketT packet =
-		{
-			.Data = (void*)data,
-			.Size = len - 1,
-			.FullSize = len,
-			.Content = NULL
-		};*/
-
-		//xPortEventListener(port, xPortObjectEventRxFoundEndLine, &packet);
-		xCircleBufferAdd(&rxCircleBuffer, (uint8_t*)data, len);
-	}
+#ifdef INC_FREERTOS_H
+	xSemaphoreGive(adapter->Internal.EventSemaphore);
+#endif
 }
 //------------------------------------------------------------------------------
-static void mqtt_pub_request_cb(void *arg, err_t result)
+static void privateRequestComplete(void* arg, err_t result)
 {
-	MqttPortAdapterT* adapter = (MqttPortAdapterT*)arg;
+	MqttPortAdapterT* adapter = arg;
 
-	adapter->TxResult = result == ERR_OK ? xResultAccept : xResultError;
+	adapter->Internal.RequestResult = result;
 
-	xSemaphoreGive(adapter->TxSemaphore);
+#ifdef INC_FREERTOS_H
+	xSemaphoreGive(adapter->Internal.TxSemaphore);
+#endif
 }
 //------------------------------------------------------------------------------
-static void mqtt_sub_request_cb(void *arg, err_t result)
+/**
+ * @brief waits for the callback of the subscribe or publish request started before.
+ */
+static err_t privateRequestWait(MqttPortAdapterT* adapter, uint32_t timeout)
 {
+#ifdef INC_FREERTOS_H
+	xSemaphoreTake(adapter->Internal.TxSemaphore, pdMS_TO_TICKS(timeout));
+#endif
 
+	return adapter->Internal.RequestResult == MQTT_PORT_REQUEST_PENDING ? ERR_TIMEOUT : adapter->Internal.RequestResult;
 }
 //------------------------------------------------------------------------------
-static xResult PrivateRequestListener(xPortT* port, xPortAdapterRequestSelector selector, void* arg)
+static void privateDisconnect(xPortT* port, MqttPortAdapterT* adapter)
 {
-	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
+	LOCK_TCPIP_CORE();
+	mqtt_disconnect(adapter->Internal.Client);
+	UNLOCK_TCPIP_CORE();
 
-	switch ((uint32_t)selector)
-		{
-			case xPortAdapterRequestGetTxBufferSize:
-				*(uint32_t*)arg = adapter->TxDataBuffer.Size;
-				break;
+	if (port->IsConnected && adapter->Internal.Reconnect)
+	{
+		NetReconnectDisconnected(adapter->Internal.Reconnect, xSystemGetTime());
+	}
 
-			case xPortAdapterRequestGetTxBufferFreeSize:
-				*(uint32_t*)arg = xDataBufferGetFreeSize(&adapter->TxDataBuffer);
-				break;
+	port->IsConnected = false;
+}
+//------------------------------------------------------------------------------
+static xResult privateConnectFailed(xPortT* port, MqttPortAdapterT* adapter)
+{
+	LOCK_TCPIP_CORE();
+	mqtt_disconnect(adapter->Internal.Client);
+	UNLOCK_TCPIP_CORE();
 
-			case xPortAdapterRequestOpen:
-			{
-				adapter->Client = arg;
-				/* Setup callback for incoming publish requests */
-				mqtt_set_inpub_callback(adapter->Client, mqtt_incoming_publish_cb, mqtt_incoming_data_cb, port);
-				mqtt_subscribe(adapter->Client, adapter->RxTopic, 0, mqtt_sub_request_cb, port);
+	if (adapter->Internal.Reconnect)
+	{
+		NetReconnectFailed(adapter->Internal.Reconnect, xSystemGetTime());
+	}
 
-				break;
-			}
+	return xResultError;
+}
+//------------------------------------------------------------------------------
+static void PrivateHandler(xPortT* port)
+{
+	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
 
-			case xPortAdapterRequestClose:
-			{
+	xRxReceiverRead(&rxReceiver, &rxCircleBuffer);
 
-				break;
-			}
+	//the keep-alive runs in the tcpip thread, the client reports the lost connection with the callback
+	if (port->IsConnected && adapter->Internal.ConnectStatus != MQTT_CONNECT_ACCEPTED)
+	{
+		privateDisconnect(port, adapter);
+	}
+}
+//------------------------------------------------------------------------------
+static xResult privateConnectHandler(xPortT* port, MqttPortAdapterT* adapter)
+{
+	if (adapter->Internal.Reconnect && !NetReconnectIsAllowed(adapter->Internal.Reconnect, xSystemGetTime()))
+	{
+		return xResultError;
+	}
 
-			case xPortAdapterRequestClearRxBuffer:
-			{
-				xRxReceiverClear(&rxReceiver);
-				break;
-			}
+	ip_addr_t address;
+	IP_ADDR4(&address,
+			adapter->NetAddress.Octet1,
+			adapter->NetAddress.Octet2,
+			adapter->NetAddress.Octet3,
+			adapter->NetAddress.Octet4);
 
-/*
-			case xPortAdapterRequestGetRxCircleBuffer:
-			{
-				xCircleBufferT** out = arg;
-				*out = &adapter->RxCircleBuffer;
+	struct mqtt_connect_client_info_t clientInfo = { 0 };
+	clientInfo.client_id = adapter->Id;
+	clientInfo.keep_alive = adapter->KeepAlive;
 
-				break;
-			}
-			*/
-/*
-			case xPortAdapterRequesExtendedTransmission:
-			{
-				xCircleBufferAddObject(&adapter->TxCircleBuffer, arg, 1, 0, 0);
 #ifdef INC_FREERTOS_H
-				xSemaphoreGive(adapter->TxSemaphore);
+	xSemaphoreTake(adapter->Internal.EventSemaphore, 0);
 #endif
-				break;
-			}
-*/
-			case xPortAdapterRequestStartTransmission:
+
+	adapter->Internal.ConnectStatus = MQTT_PORT_CONNECT_PENDING;
+
+	LOCK_TCPIP_CORE();
+	err_t result = mqtt_client_connect(adapter->Internal.Client,
+										&address,
+										adapter->NetPort,
+										privateConnection,
+										port,
+										&clientInfo);
+	UNLOCK_TCPIP_CORE();
+
+	if (result != ERR_OK)
+	{
+		return privateConnectFailed(port, adapter);
+	}
+
+	uint32_t timeStamp = xSystemGetTime();
+
+	while (adapter->Internal.ConnectStatus == MQTT_PORT_CONNECT_PENDING
+			&& xSystemGetTime() - timeStamp < MQTT_PORT_CONNACK_TIMEOUT)
+	{
 #ifdef INC_FREERTOS_H
-				xSemaphoreTake(adapter->TransactionMutex, portMAX_DELAY);
+		xSemaphoreTake(adapter->Internal.EventSemaphore, pdMS_TO_TICKS(MQTT_PORT_CONNACK_TIMEOUT));
 #endif
-				break;
+	}
 
-			case xPortAdapterRequestEndTransmission:
-			{
-				if (adapter->TxDataBuffer.DataSize)
-				{
-					uint8_t qos = 0; /* 0 1 or 2, see MQTT specification */
-					uint8_t retain = 0; /* No don't retain such crappy payload... */
+	if (adapter->Internal.ConnectStatus != MQTT_CONNECT_ACCEPTED)
+	{
+		return privateConnectFailed(port, adapter);
+	}
 
-					adapter->TxResult = xResultError;
+	adapter->Internal.RequestResult = MQTT_PORT_REQUEST_PENDING;
 
-					extern uint32_t MqttTxTimeStamp;
-					MqttTxTimeStamp = xSystemGetTime(NULL);
+	LOCK_TCPIP_CORE();
+	result = mqtt_subscribe(adapter->Internal.Client, adapter->RxTopic, adapter->QoS, privateRequestComplete, adapter);
+	UNLOCK_TCPIP_CORE();
 
-					mqtt_publish(adapter->Client,
-							adapter->TxTopic,
-							adapter->TxDataBuffer.Data,
-							adapter->TxDataBuffer.DataSize,
-							qos,
-							retain,
-							mqtt_pub_request_cb,
-							adapter);
+	if (result != ERR_OK || privateRequestWait(adapter, MQTT_PORT_CONNACK_TIMEOUT) != ERR_OK)
+	{
+		return privateConnectFailed(port, adapter);
+	}
+
+	port->IsConnected = true;
 
-					xSemaphoreTake(adapter->TxSemaphore, 2000);
+	if (adapter->Internal.Reconnect)
+	{
+		NetReconnectConnected(adapter->Internal.Reconnect, xSystemGetTime());
+	}
 
-					xDataBufferClear(&adapter->TxDataBuffer);
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static void privatePublish(xPortT* port, MqttPortAdapterT* adapter, uint8_t* data, uint16_t size)
+{
+	if (!port->IsConnected)
+	{
+		adapter->Internal.Statistic.Dropped++;
+		return;
+	}
+
+	extern uint32_t MqttTxTimeStamp;
+	MqttTxTimeStamp = xSystemGetTime();
+
+	uint32_t cycles = DWT->CYCCNT;
+
+	adapter->Internal.RequestResult = MQTT_PORT_REQUEST_PENDING;
+
+	//the payload is copied to the output ring of the client
+	LOCK_TCPIP_CORE();
+	err_t result = mqtt_publish(adapter->Internal.Client,
+								adapter->TxTopic,
+								data,
+								size,
+								adapter->QoS,
+								0,
+								privateRequestComplete,
+								adapter);
+	UNLOCK_TCPIP_CORE();
+
+	//QoS0 completes on the TCP acknowledgement, QoS1 on PUBACK
+	if (result != ERR_OK || privateRequestWait(adapter, MQTT_PORT_SEND_TIMEOUT) != ERR_OK)
+	{
+		adapter->Internal.Statistic.Dropped++;
+		return;
+	}
+
+	adapter->Internal.Statistic.PublishCycles += DWT->CYCCNT - cycles;
+	adapter->Internal.Statistic.PublishedBytes += size;
+	adapter->Internal.Statistic.Published++;
+}
+//------------------------------------------------------------------------------
+static xResult PrivateRequestListener(xPortT* port, xPortAdapterRequestSelector selector, uint32_t description, void* arg)
+{
+	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
+
+	switch ((uint32_t)selector)
+	{
+		case xPortAdapterRequestGetTxBufferSize:
+			*(uint32_t*)arg = adapter->Internal.TxDataBuffer.Size;
+			break;
+
+		case xPortAdapterRequestGetTxBufferFreeSize:
+			*(uint32_t*)arg = xDataBufferGetFreeSize(&adapter->Internal.TxDataBuffer);
+			break;
+
+		case xPortAdapterRequestOpen:
+		{
+			if (!adapter->Internal.Client)
+			{
+				LOCK_TCPIP_CORE();
+				adapter->Internal.Client = mqtt_client_new();
+
+				if (adapter->Internal.Client)
+				{
+					mqtt_set_inpub_callback(adapter->Internal.Client, privateIncomingPublish, privateIncomingData, port);
 				}
+				UNLOCK_TCPIP_CORE();
+			}
+
+			port->IsOpen = adapter->Internal.Client != NULL;
+			break;
+		}
 
-				uint8_t result = adapter->TxResult;
+		case xPortAdapterRequestConnect:
+		{
+#ifdef INC_FREERTOS_H
+			xSemaphoreTake(adapter->Internal.TransactionMutex, portMAX_DELAY);
+#endif
+			xResult result = privateConnectHandler(port, adapter);
 
 #ifdef INC_FREERTOS_H
+			xSemaphoreGive(adapter->Internal.TransactionMutex);
+#endif
+			return result;
+		}
 
-				xSemaphoreGive(adapter->TransactionMutex);
+		case xPortAdapterRequestClose:
+		{
+			port->IsOpen = false;
+			break;
+		}
+
+		case xPortAdapterRequestClearRxBuffer:
+		{
+			xRxReceiverClear(&rxReceiver);
+			break;
+		}
+
+		case xPortAdapterRequestStartTransmission:
+#ifdef INC_FREERTOS_H
+			xSemaphoreTake(adapter->Internal.TransactionMutex, portMAX_DELAY);
 #endif
-				return result;
+			break;
+
+		case xPortAdapterRequestEndTransmission:
+		{
+			if (adapter->Internal.TxDataBuffer.DataSize)
+			{
+				privatePublish(port, adapter, adapter->Internal.TxDataBuffer.Data, adapter->Internal.TxDataBuffer.DataSize);
+
+				xDataBufferClear(&adapter->Internal.TxDataBuffer);
 			}
 
-			default : return xResultRequestIsNotFound;
+#ifdef INC_FREERTOS_H
+			xSemaphoreGive(adapter->Internal.TransactionMutex);
+#endif
+			break;
 		}
 
+		default : return xResultRequestIsNotFound;
+	}
+
 	return xResultAccept;
 }
 //------------------------------------------------------------------------------
-static void PrivateEventListener(xPortT* port, xPortAdapterEventSelector selector, void* arg)
+static void PrivateEventListener(xPortT* port, xPortAdapterEventSelector selector, uint32_t description, void* arg)
 {
-	//register UsartPortAdapterT* adapter = (UsartPortAdapterT*)port->Adapter;
-
 	switch((int)selector)
 	{
 		default: return;
@@ -231,19 +389,14 @@ static int PrivateTransmit(xPortT* port, void* data, uint32_t size)
 {
 	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
 
-	if (!mqtt_client_is_connected(adapter->Client))
-	{
-		return -xResultError;
-	}
-
-	uint16_t freeSize = xDataBufferGetFreeSize(&adapter->TxDataBuffer);
+	uint16_t freeSize = xDataBufferGetFreeSize(&adapter->Internal.TxDataBuffer);
 
 	if (freeSize < size)
 	{
 		return -xResultError;
 	}
 
-	xDataBufferAdd(&adapter->TxDataBuffer, data, size);
+	xDataBufferAdd(&adapter->Internal.TxDataBuffer, data, size);
 
 	return size;
 }
@@ -252,6 +405,34 @@ static int PrivateReceive(xPortT* port, void* data, uint32_t size)
 {
 	return -xResultNotSupported;
 }
+//------------------------------------------------------------------------------
+/**
+ * @brief blocks the port task until the client reports incoming data or the state of the connection,
+ * or the next reconnect attempt is allowed. Not longer than maxTime.
+ */
+void MqttPortAdapterWaitEvent(xPortT* port, uint32_t maxTime)
+{
+	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
+
+	uint32_t waitTime = maxTime;
+
+	if (!port->IsConnected && adapter->Internal.Reconnect)
+	{
+		uint32_t reconnectTime = NetReconnectGetWaitTime(adapter->Internal.Reconnect, xSystemGetTime());
+
+		if (reconnectTime < waitTime)
+		{
+			waitTime = reconnectTime;
+		}
+	}
+
+#ifdef INC_FREERTOS_H
+	if (waitTime)
+	{
+		xSemaphoreTake(adapter->Internal.EventSemaphore, pdMS_TO_TICKS(waitTime));
+	}
+#endif
+}
 //==============================================================================
 //initializations:
 
@@ -274,18 +455,29 @@ xResult MqttPortAdapterInit(xPortT* port, MqttPortAdapterT* adapter, MqttPortAda
 		port->Adapter.Content = adapter;
 		port->Adapter.Interface = &privatePortInterface;
 
+		memset(&adapter->Internal, 0, sizeof(adapter->Internal));
+
 #ifdef INC_FREERTOS_H
-		adapter->TransactionMutex = xSemaphoreCreateMutex();
-		adapter->TxSemaphore = xSemaphoreCreateBinary();
+		adapter->Internal.TransactionMutex = xSemaphoreCreateMutex();
+		adapter->Internal.TxSemaphore = xSemaphoreCreateBinary();
+		adapter->Internal.EventSemaphore = xSemaphoreCreateBinary();
 #endif
-		adapter->TxDataBuffer.Memory = init->TxBuffer;
-		adapter->TxDataBuffer.Size = init->TxBufferSize;
+
+		adapter->TxTopic = init->TxTopic;
+		adapter->RxTopic = init->RxTopic;
+
+		adapter->Internal.TxDataBuffer.Memory = init->TxBuffer;
+		adapter->Internal.TxDataBuffer.Size = init->TxBufferSize;
+
+		adapter->Internal.Reconnect = init->Reconnect;
+		adapter->Internal.ConnectStatus = MQTT_CONNECT_DISCONNECTED;
 
 		rxReceiver.Base.Parent = port;
 
 		return xResultAccept;
 	}
-  
-  return xResultError;
+
+	return xResultError;
 }
 //==============================================================================
+#endif //MQTT_TARGET_LAYOUT
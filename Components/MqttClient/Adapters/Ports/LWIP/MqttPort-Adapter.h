@@ -6,39 +6,72 @@
 //------------------------------------------------------------------------------
 #ifdef __cplusplus
 extern "C" {
-#endif 
+#endif
 //==============================================================================
 //includes:
 
 #include "Common/xRxReceiver.h"
 #include "Common/xDataBuffer.h"
 #include "Abstractions/xPort/xPort.h"
+#include "Abstractions/xNet/xNet.h"
 #include "lwip/api.h"
 #include "lwip/sys.h"
 #include "lwip/apps/mqtt.h"
+#include "Net/Reconnect/NetReconnect.h"
 //==============================================================================
 //types:
 
+typedef struct
+{
+	uint32_t Published;
+	uint32_t Dropped;
+
+	uint32_t PublishedBytes; //payload bytes given to the client
+	uint32_t PublishCycles; //CPU cycles spent on them: PublishCycles / Published - cycles per message
+
+} MqttPortStatisticT;
+//------------------------------------------------------------------------------
 typedef struct
 {
 #ifdef INC_FREERTOS_H
 	SemaphoreHandle_t TransactionMutex;
-	SemaphoreHandle_t TxSemaphore;
+	SemaphoreHandle_t TxSemaphore; //given by the request callbacks
+	SemaphoreHandle_t EventSemaphore; //given by the connection and the incoming data callbacks
 #endif
 
-	char* RxTopic;
-	char* TxTopic;
+	mqtt_client_t* Client;
+	NetReconnectT* Reconnect;
 
 	xDataBufferT TxDataBuffer;
 
-	mqtt_client_t* Client;
+	MqttPortStatisticT Statistic;
+
+	//written by the callbacks in the tcpip thread
+	volatile uint16_t ConnectStatus; //mqtt_connection_status_t
+	volatile int8_t RequestResult; //err_t
 
 	struct
 	{
 		uint8_t RxTopicConfirmed : 1;
-		uint8_t TxResult : 3;
 	};
 
+} MqttPortAdapterInternalT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	MqttPortAdapterInternalT Internal;
+
+	char* RxTopic;
+	char* TxTopic;
+
+	char* Id;
+
+	xNetAddressT NetAddress;
+	uint16_t NetPort;
+
+	uint8_t QoS;
+	uint16_t KeepAlive; //seconds, 0 - disabled
+
 } MqttPortAdapterT;
 //------------------------------------------------------------------------------
 typedef struct
@@ -46,14 +79,23 @@ typedef struct
 	char* RxTopic;
 	char* TxTopic;
 
+	/// @brief not used: apps/mqtt serializes into its own ring of MQTT_OUTPUT_RINGBUF_SIZE
+	uint8_t* MqttBuffer;
+	uint16_t MqttBufferSize;
+
 	uint8_t* TxBuffer;
 	uint16_t TxBufferSize;
 
+	/// @brief backoff of the connection attempts, NULL - an attempt on each connect request
+	NetReconnectT* Reconnect;
+
 } MqttPortAdapterInitT;
 //==============================================================================
 //functions:
 
 xResult MqttPortAdapterInit(xPortT* port, MqttPortAdapterT* adapter, MqttPortAdapterInitT* init);
+
+void MqttPortAdapterWaitEvent(xPortT* port, uint32_t maxTime);
 //==============================================================================
 #ifdef __cplusplus
 }
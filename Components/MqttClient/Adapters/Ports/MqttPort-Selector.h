@@ -0,0 +1,48 @@
+//==============================================================================
+//header:
+
+#ifndef _MQTT_PORT_SELECTOR_H_
+#define _MQTT_PORT_SELECTOR_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "MqttClient/MqttClient-ComponentConfig.h"
+
+/*
+ * port contract of the MQTT engines, MQTT_TARGET_LAYOUT selects one of them:
+ *  MqttPortAdapterT: Id, NetAddress, NetPort, QoS, KeepAlive, Internal.Statistic (MqttPortStatisticT)
+ *  MqttPortAdapterInitT: RxTopic, TxTopic, MqttBuffer, TxBuffer, Reconnect
+ *  MqttPortAdapterInit(port, adapter, init), MqttPortAdapterWaitEvent(port, maxTime)
+ *
+ *  xPortAdapterRequestOpen - the engine is initialized, port->IsOpen
+ *  xPortAdapterRequestConnect - one connection attempt (NetReconnect backoff), subscribes RxTopic, port->IsConnected
+ *  xPortAdapterRequestEndTransmission - the transmission is published to TxTopic with QoS
+ *  xPortDirectlyHandler - receives, the publishes to RxTopic go to the terminal, keeps the connection alive
+ */
+#if MQTT_TARGET_LAYOUT == MQTT_FREERTOS_LAYOUT
+
+#include "FreeRTOS-MQTT/MqttPort-Adapter.h"
+
+#elif MQTT_TARGET_LAYOUT == MQTT_PAHO_LAYOUT
+
+#include "Paho/MqttPort-Adapter.h"
+
+#elif MQTT_TARGET_LAYOUT == MQTT_LWIP_LAYOUT
+
+#include "LWIP/MqttPort-Adapter.h"
+
+#else
+
+#error "MQTT_TARGET_LAYOUT is not selected"
+
+#endif
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MQTT_PORT_SELECTOR_H_
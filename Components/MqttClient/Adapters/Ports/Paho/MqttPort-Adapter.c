@@ -0,0 +1,377 @@
+//==============================================================================
+//includes:
+
+#include "MqttClient/MqttClient-ComponentConfig.h"
+
+#if MQTT_TARGET_LAYOUT == MQTT_PAHO_LAYOUT
+#include <stdio.h>
+
+#include "MqttPort-Adapter.h"
+#include "Components.h"
+#include "TerminalCommands/TerminalCommands.h"
+#include "main.h"
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+//==============================================================================
+//defines:
+
+#ifndef MQTT_PORT_COMMAND_TIMEOUT
+#define MQTT_PORT_COMMAND_TIMEOUT 3000 //ms, CONNACK, SUBACK, PUBACK
+#endif
+
+#ifndef MQTT_PORT_READ_TIMEOUT
+#define MQTT_PORT_READ_TIMEOUT 100 //ms, the rest of a packet whose first byte is received
+#endif
+
+#ifndef MQTT_PORT_HANDLER_PACKETS
+#define MQTT_PORT_HANDLER_PACKETS 8 //packets read in one handler call
+#endif
+//==============================================================================
+//prototypes:
+
+//one read of MQTTClient with the keep-alive, not declared by MQTTClient.h
+int cycle(MQTTClient* c, MQTTTimerT* timer);
+//==============================================================================
+//variables:
+
+//the message handlers of MQTTClient have no context
+static xPortT* privatePort;
+//==============================================================================
+//functions:
+
+static void privateDisconnect(xPortT* port, MqttPortAdapterT* adapter)
+{
+	MQTTCloseSession(&adapter->Internal.Client);
+
+	if (adapter->Internal.Network.is_connected)
+	{
+		//the reconnect backoff is updated by the network
+		adapter->Internal.Network.disconnect(&adapter->Internal.Network);
+	}
+
+	port->IsConnected = false;
+}
+//------------------------------------------------------------------------------
+static void privateMessageHandler(MessageData* data)
+{
+	RxDataPacketT rxPacket;
+	rxPacket.Data = data->message->payload;
+	rxPacket.FullSize = data->message->payloadlen;
+	rxPacket.Size = rxPacket.FullSize - 1;
+
+	TerminalCommandsReceive(privatePort, &rxPacket);
+}
+//------------------------------------------------------------------------------
+static void PrivateHandler(xPortT* port)
+{
+	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
+	MQTTClient* client = &adapter->Internal.Client;
+
+	if (!port->IsConnected)
+	{
+		return;
+	}
+
+#ifdef INC_FREERTOS_H
+	xSemaphoreTakeRecursive(adapter->Internal.TransactionMutex, portMAX_DELAY);
+#endif
+
+	uint8_t packets = 0;
+	int result;
+
+	do
+	{
+		//without data the cycle only sends PINGREQ when it is due, it must not wait for the first byte
+		uint32_t timeout = NetworkPending(&adapter->Internal.Network) > 0 ? MQTT_PORT_READ_TIMEOUT : 0;
+
+		MQTTTimerT timer;
+		TimerInit(&timer);
+		TimerCountdownMS(&timer, timeout);
+
+		result = cycle(client, &timer);
+		packets++;
+	}
+	while (result >= 0
+			&& packets < MQTT_PORT_HANDLER_PACKETS
+			&& NetworkPending(&adapter->Internal.Network) > 0);
+
+	if (result < 0 || !client->isconnected)
+	{
+		privateDisconnect(port, adapter);
+	}
+
+#ifdef INC_FREERTOS_H
+	xSemaphoreGiveRecursive(adapter->Internal.TransactionMutex);
+#endif
+}
+//------------------------------------------------------------------------------
+static xResult privateConnectHandler(xPortT* port, MqttPortAdapterT* adapter)
+{
+	MQTTNetworkT* network = &adapter->Internal.Network;
+	char address[16];
+
+	snprintf(address, sizeof(address), "%u.%u.%u.%u",
+			adapter->NetAddress.Octet1,
+			adapter->NetAddress.Octet2,
+			adapter->NetAddress.Octet3,
+			adapter->NetAddress.Octet4);
+
+	//refused while the backoff delay of NetReconnect is running
+	if (NetworkConnect(network, address, adapter->NetPort) < 0)
+	{
+		return xResultError;
+	}
+
+#ifdef INC_FREERTOS_H
+	FreeRTOS_setsockopt(network->my_socket, 0, FREERTOS_SO_SET_SEMAPHORE,
+						&adapter->Internal.EventSemaphore,
+						sizeof(adapter->Internal.EventSemaphore));
+#endif
+
+	MQTTPacket_connectData connectData = MQTTPacket_connectData_initializer;
+	connectData.MQTTVersion = 4;
+	connectData.clientID.cstring = adapter->Id;
+	connectData.keepAliveInterval = adapter->KeepAlive;
+	connectData.cleansession = adapter->QoS == QOS0;
+
+	if (MQTTConnect(&adapter->Internal.Client, &connectData) != MQTT_RESULT_SUCCESS
+		|| MQTTSubscribe(&adapter->Internal.Client, adapter->RxTopic, (enum QoS)adapter->QoS, privateMessageHandler) != MQTT_RESULT_SUCCESS)
+	{
+		//the short-lived connection keeps the backoff of NetReconnect
+		privateDisconnect(port, adapter);
+
+		return xResultError;
+	}
+
+	port->IsConnected = true;
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static void privatePublish(xPortT* port, MqttPortAdapterT* adapter, uint8_t* data, uint16_t size)
+{
+	if (!port->IsConnected)
+	{
+		adapter->Internal.Statistic.Dropped++;
+		return;
+	}
+
+	MQTTMessage message = { 0 };
+	message.qos = (enum QoS)adapter->QoS;
+	message.payload = data;
+	message.payloadlen = size;
+
+	uint32_t cycles = DWT->CYCCNT;
+
+	//QoS1 waits for PUBACK here, MQTTClient has no in-flight window
+	if (MQTTPublish(&adapter->Internal.Client, adapter->TxTopic, &message) != MQTT_RESULT_SUCCESS)
+	{
+		adapter->Internal.Statistic.Dropped++;
+		privateDisconnect(port, adapter);
+
+		return;
+	}
+
+	adapter->Internal.Statistic.PublishCycles += DWT->CYCCNT - cycles;
+	adapter->Internal.Statistic.PublishedBytes += size;
+	adapter->Internal.Statistic.Published++;
+}
+//------------------------------------------------------------------------------
+static xResult PrivateRequestListener(xPortT* port, xPortAdapterRequestSelector selector, uint32_t description, void* arg)
+{
+	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
+
+	switch ((uint32_t)selector)
+	{
+		case xPortAdapterRequestGetTxBufferSize:
+			*(uint32_t*)arg = adapter->Internal.TxDataBuffer.Size;
+			break;
+
+		case xPortAdapterRequestGetTxBufferFreeSize:
+			*(uint32_t*)arg = xDataBufferGetFreeSize(&adapter->Internal.TxDataBuffer);
+			break;
+
+		case xPortAdapterRequestOpen:
+		{
+			MQTTClientInit(&adapter->Internal.Client,
+							&adapter->Internal.Network,
+							MQTT_PORT_COMMAND_TIMEOUT,
+							adapter->Internal.MqttBuffer,
+							adapter->Internal.MqttBufferSize,
+							adapter->Internal.ReadBuffer,
+							adapter->Internal.ReadBufferSize);
+
+			port->IsOpen = true;
+			break;
+		}
+
+		case xPortAdapterRequestConnect:
+		{
+#ifdef INC_FREERTOS_H
+			xSemaphoreTakeRecursive(adapter->Internal.TransactionMutex, portMAX_DELAY);
+#endif
+			xResult result = privateConnectHandler(port, adapter);
+
+#ifdef INC_FREERTOS_H
+			xSemaphoreGiveRecursive(adapter->Internal.TransactionMutex);
+#endif
+			return result;
+		}
+
+		case xPortAdapterRequestClose:
+		{
+			port->IsOpen = false;
+			break;
+		}
+
+		case xPortAdapterRequestClearRxBuffer:
+			break;
+
+		case xPortAdapterRequestStartTransmission:
+#ifdef INC_FREERTOS_H
+			xSemaphoreTakeRecursive(adapter->Internal.TransactionMutex, portMAX_DELAY);
+#endif
+			break;
+
+		case xPortAdapterRequestEndTransmission:
+		{
+			if (adapter->Internal.TxDataBuffer.DataSize)
+			{
+				privatePublish(port, adapter, adapter->Internal.TxDataBuffer.Data, adapter->Internal.TxDataBuffer.DataSize);
+
+				xDataBufferClear(&adapter->Internal.TxDataBuffer);
+			}
+
+#ifdef INC_FREERTOS_H
+			xSemaphoreGiveRecursive(adapter->Internal.TransactionMutex);
+#endif
+			break;
+		}
+
+		default : return xResultRequestIsNotFound;
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static void PrivateEventListener(xPortT* port, xPortAdapterEventSelector selector, uint32_t description, void* arg)
+{
+	switch((int)selector)
+	{
+		default: return;
+	}
+}
+//------------------------------------------------------------------------------
+static int PrivateTransmit(xPortT* port, void* data, uint32_t size)
+{
+	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
+
+	uint16_t freeSize = xDataBufferGetFreeSize(&adapter->Internal.TxDataBuffer);
+
+	if (freeSize < size)
+	{
+		return -xResultError;
+	}
+
+	xDataBufferAdd(&adapter->Internal.TxDataBuffer, data, size);
+
+	return size;
+}
+//------------------------------------------------------------------------------
+static int PrivateReceive(xPortT* port, void* data, uint32_t size)
+{
+	return -xResultNotSupported;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief blocks the port task until the socket has an event, half of the keep-alive period
+ * passes (MQTTClient sends PINGREQ from the handler) or the next reconnect attempt is allowed.
+ * Not longer than maxTime.
+ */
+void MqttPortAdapterWaitEvent(xPortT* port, uint32_t maxTime)
+{
+	MqttPortAdapterT* adapter = (MqttPortAdapterT*)port->Adapter.Content;
+	NetReconnectT* reconnect = adapter->Internal.Network.reconnect;
+
+	uint32_t waitTime = maxTime;
+
+	if (port->IsConnected && adapter->KeepAlive && adapter->KeepAlive * 500U < waitTime)
+	{
+		waitTime = adapter->KeepAlive * 500U;
+	}
+
+	if (!port->IsConnected && reconnect)
+	{
+		uint32_t reconnectTime = NetReconnectGetWaitTime(reconnect, xSystemGetTime());
+
+		if (reconnectTime < waitTime)
+		{
+			waitTime = reconnectTime;
+		}
+	}
+
+#ifdef INC_FREERTOS_H
+	if (waitTime)
+	{
+		xSemaphoreTake(adapter->Internal.EventSemaphore, pdMS_TO_TICKS(waitTime));
+	}
+#endif
+}
+//==============================================================================
+//initializations:
+
+static xPortAdapterInterfaceT privatePortInterface =
+{
+	.Handler = (xPortAdapterHandlerT)PrivateHandler,
+
+	.RequestListener = (xPortAdapterRequestListenerT)PrivateRequestListener,
+	.EventListener = (xPortAdapterEventListenerT)PrivateEventListener,
+
+	.Transmit = (xPortAdapterTransmitActionT)PrivateTransmit,
+	.Receive = (xPortAdapterReceiveActionT)PrivateReceive
+};
+//------------------------------------------------------------------------------
+xResult MqttPortAdapterInit(xPortT* port, MqttPortAdapterT* adapter, MqttPortAdapterInitT* init)
+{
+	if (port && init && init->MqttBuffer && init->ReadBuffer)
+	{
+		port->Adapter.Description = nameof(MqttPortAdapterT);
+		port->Adapter.Content = adapter;
+		port->Adapter.Interface = &privatePortInterface;
+
+		memset(&adapter->Internal, 0, sizeof(adapter->Internal));
+
+#ifdef INC_FREERTOS_H
+		adapter->Internal.TransactionMutex = xSemaphoreCreateRecursiveMutex();
+		adapter->Internal.EventSemaphore = xSemaphoreCreateBinary();
+#endif
+
+		adapter->TxTopic = init->TxTopic;
+		adapter->RxTopic = init->RxTopic;
+
+		if (adapter->QoS > QOS1)
+		{
+			adapter->QoS = QOS1;
+		}
+
+		adapter->Internal.MqttBuffer = init->MqttBuffer;
+		adapter->Internal.MqttBufferSize = init->MqttBufferSize;
+		adapter->Internal.ReadBuffer = init->ReadBuffer;
+		adapter->Internal.ReadBufferSize = init->ReadBufferSize;
+
+		adapter->Internal.TxDataBuffer.Memory = init->TxBuffer;
+		adapter->Internal.TxDataBuffer.Size = init->TxBufferSize;
+
+		NetworkInit(&adapter->Internal.Network);
+		NetworkSetReadAhead(&adapter->Internal.Network, init->ReadAheadBuffer, init->ReadAheadBufferSize);
+		adapter->Internal.Network.reconnect = init->Reconnect;
+
+		privatePort = port;
+
+		return xResultAccept;
+	}
+
+	return xResultError;
+}
+//==============================================================================
+#endif //MQTT_TARGET_LAYOUT
@@ -0,0 +1,104 @@
+//==============================================================================
+//header:
+
+#ifndef _MQTT_PORT_ADAPTER_H_
+#define _MQTT_PORT_ADAPTER_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Common/xDataBuffer.h"
+#include "Abstractions/xPort/xPort.h"
+#include "Abstractions/xNet/xNet.h"
+#include "MQTTClient.h"
+#include "Net/Reconnect/NetReconnect.h"
+//==============================================================================
+//types:
+
+typedef struct
+{
+	uint32_t Published;
+	uint32_t Dropped;
+
+	uint32_t PublishedBytes; //payload bytes given to the socket
+	uint32_t PublishCycles; //CPU cycles spent on them: PublishCycles / Published - cycles per message
+
+} MqttPortStatisticT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+#ifdef INC_FREERTOS_H
+	SemaphoreHandle_t TransactionMutex;
+	SemaphoreHandle_t EventSemaphore; //given by the socket events
+#endif
+
+	MQTTClient Client;
+	MQTTNetworkT Network;
+
+	uint8_t* MqttBuffer;
+	uint16_t MqttBufferSize;
+	uint8_t* ReadBuffer;
+	uint16_t ReadBufferSize;
+
+	xDataBufferT TxDataBuffer;
+
+	MqttPortStatisticT Statistic;
+
+} MqttPortAdapterInternalT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	MqttPortAdapterInternalT Internal;
+
+	char* RxTopic;
+	char* TxTopic;
+
+	char* Id;
+
+	xNetAddressT NetAddress;
+	uint16_t NetPort;
+
+	uint8_t QoS; //0 or 1, QoS2 is not used by the port
+	uint16_t KeepAlive; //seconds, 0 - disabled
+
+} MqttPortAdapterT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	char* RxTopic;
+	char* TxTopic;
+
+	/// @brief outgoing packets, MQTTClient serializes the publish with its payload here
+	uint8_t* MqttBuffer;
+	uint16_t MqttBufferSize;
+
+	/// @brief incoming packets, a packet larger than the buffer breaks the connection
+	uint8_t* ReadBuffer;
+	uint16_t ReadBufferSize;
+
+	/// @brief bytes received from the socket in bulk ahead of the reads of MQTTClient, NULL - a socket read per read
+	uint8_t* ReadAheadBuffer;
+	uint16_t ReadAheadBufferSize;
+
+	uint8_t* TxBuffer;
+	uint16_t TxBufferSize;
+
+	/// @brief backoff of the connection attempts, NULL - an attempt on each connect request
+	NetReconnectT* Reconnect;
+
+} MqttPortAdapterInitT;
+//==============================================================================
+//functions:
+
+xResult MqttPortAdapterInit(xPortT* port, MqttPortAdapterT* adapter, MqttPortAdapterInitT* init);
+
+void MqttPortAdapterWaitEvent(xPortT* port, uint32_t maxTime);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MQTT_PORT_ADAPTER_H_
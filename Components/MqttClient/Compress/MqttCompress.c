@@ -0,0 +1,219 @@
+//==============================================================================
+//includes:
+
+#include "MqttCompress.h"
+#include <string.h>
+//==============================================================================
+//functions:
+
+static void privateBitsWrite(MqttCompressEncoderT* encoder, uint32_t value, uint8_t count)
+{
+	while (count--)
+	{
+		encoder->BitBuffer = (encoder->BitBuffer << 1) | ((value >> count) & 1);
+		encoder->BitCount++;
+
+		if (encoder->BitCount == 8)
+		{
+			if (encoder->Position < encoder->OutputSize)
+			{
+				encoder->Output[encoder->Position++] = encoder->BitBuffer;
+			}
+			else
+			{
+				encoder->IsOverflowed = true;
+			}
+
+			encoder->BitBuffer = 0;
+			encoder->BitCount = 0;
+		}
+	}
+}
+//------------------------------------------------------------------------------
+static uint32_t privateBitsRead(const uint8_t* bits, uint32_t* bit, uint8_t count)
+{
+	uint32_t value = 0;
+
+	while (count--)
+	{
+		value = (value << 1) | ((bits[*bit >> 3] >> (7 - (*bit & 7))) & 1);
+		(*bit)++;
+	}
+
+	return value;
+}
+//------------------------------------------------------------------------------
+void MqttCompressBegin(MqttCompressEncoderT* encoder, uint8_t* output, uint32_t outputSize, uint8_t windowBits, uint8_t lookaheadBits)
+{
+	memset(encoder, 0, sizeof(MqttCompressEncoderT));
+
+	encoder->Output = output;
+	encoder->OutputSize = outputSize;
+	encoder->WindowBits = windowBits;
+	encoder->LookaheadBits = lookaheadBits;
+
+	if (outputSize < MQTT_COMPRESS_HEADER_SIZE
+		|| windowBits < MQTT_COMPRESS_MIN_WINDOW_BITS || windowBits > MQTT_COMPRESS_MAX_WINDOW_BITS
+		|| lookaheadBits < MQTT_COMPRESS_MIN_LOOKAHEAD_BITS || lookaheadBits > MQTT_COMPRESS_MAX_LOOKAHEAD_BITS
+		|| lookaheadBits > windowBits)
+	{
+		encoder->IsOverflowed = true;
+		return;
+	}
+
+	output[encoder->Position++] = MQTT_COMPRESS_HEADER_FLAG | (lookaheadBits << 4) | windowBits;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief encodes the fragment. The longest match is searched in the last 2^WindowBits bytes
+ * of the fragment, the search is stopped early on the maximum match length.
+ */
+void MqttCompressAdd(MqttCompressEncoderT* encoder, const void* data, uint32_t size)
+{
+	const uint8_t* input = data;
+	uint32_t window = 1U << encoder->WindowBits;
+	uint32_t maxMatch = (1U << encoder->LookaheadBits) - 1 + MQTT_COMPRESS_MIN_MATCH;
+	uint32_t position = 0;
+
+	while (position < size && !encoder->IsOverflowed)
+	{
+		uint32_t start = position > window ? position - window : 0;
+		uint32_t limit = size - position < maxMatch ? size - position : maxMatch;
+		uint32_t bestLength = 0;
+		uint32_t bestDistance = 0;
+
+		for (uint32_t candidate = position; candidate-- > start && bestLength < limit; )
+		{
+			if (input[candidate] != input[position])
+			{
+				continue;
+			}
+
+			uint32_t length = 1;
+
+			//the match may overlap the current position, as the decoder copies byte by byte
+			while (length < limit && input[candidate + length] == input[position + length])
+			{
+				length++;
+			}
+
+			if (length > bestLength)
+			{
+				bestLength = length;
+				bestDistance = position - candidate;
+			}
+		}
+
+		if (bestLength >= MQTT_COMPRESS_MIN_MATCH)
+		{
+			privateBitsWrite(encoder, 0, 1);
+			privateBitsWrite(encoder, bestDistance - 1, encoder->WindowBits);
+			privateBitsWrite(encoder, bestLength - MQTT_COMPRESS_MIN_MATCH, encoder->LookaheadBits);
+
+			position += bestLength;
+		}
+		else
+		{
+			privateBitsWrite(encoder, 1, 1);
+			privateBitsWrite(encoder, input[position], 8);
+
+			position++;
+		}
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @return size of the compressed payload with the header, -1 if it doesn't fit the output
+ */
+int32_t MqttCompressEnd(MqttCompressEncoderT* encoder)
+{
+	//the padding is shorter than any token, the decoder stops on it
+	if (encoder->BitCount)
+	{
+		privateBitsWrite(encoder, 0, 8 - encoder->BitCount);
+	}
+
+	return encoder->IsOverflowed ? -1 : (int32_t)encoder->Position;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief decodes a payload made by the encoder or marked as raw.
+ * Has no target dependencies, the same file is built for the host side.
+ * @return size of the decoded data, -1 if the payload is corrupted or the output is too small
+ */
+int32_t MqttCompressDecode(const void* input, uint32_t size, uint8_t* output, uint32_t outputSize)
+{
+	const uint8_t* data = input;
+
+	if (size < MQTT_COMPRESS_HEADER_SIZE)
+	{
+		return -1;
+	}
+
+	if (data[0] == MQTT_COMPRESS_HEADER_RAW)
+	{
+		size -= MQTT_COMPRESS_HEADER_SIZE;
+
+		if (size > outputSize)
+		{
+			return -1;
+		}
+
+		memcpy(output, data + MQTT_COMPRESS_HEADER_SIZE, size);
+
+		return size;
+	}
+
+	uint8_t windowBits = data[0] & 0x0F;
+	uint8_t lookaheadBits = (data[0] >> 4) & 0x07;
+
+	if (!(data[0] & MQTT_COMPRESS_HEADER_FLAG)
+		|| windowBits < MQTT_COMPRESS_MIN_WINDOW_BITS
+		|| lookaheadBits < MQTT_COMPRESS_MIN_LOOKAHEAD_BITS)
+	{
+		return -1;
+	}
+
+	const uint8_t* bits = data + MQTT_COMPRESS_HEADER_SIZE;
+	uint32_t bitsCount = (size - MQTT_COMPRESS_HEADER_SIZE) * 8;
+	uint32_t bit = 0;
+	uint32_t position = 0;
+
+	//any token is longer than the padding (up to 7 bits)
+	while (bitsCount - bit >= 8)
+	{
+		if (privateBitsRead(bits, &bit, 1))
+		{
+			if (bitsCount - bit < 8 || position >= outputSize)
+			{
+				return -1;
+			}
+
+			output[position++] = privateBitsRead(bits, &bit, 8);
+
+			continue;
+		}
+
+		if (bitsCount - bit < (uint32_t)(windowBits + lookaheadBits))
+		{
+			return -1;
+		}
+
+		uint32_t distance = privateBitsRead(bits, &bit, windowBits) + 1;
+		uint32_t length = privateBitsRead(bits, &bit, lookaheadBits) + MQTT_COMPRESS_MIN_MATCH;
+
+		if (distance > position || position + length > outputSize)
+		{
+			return -1;
+		}
+
+		while (length--)
+		{
+			output[position] = output[position - distance];
+			position++;
+		}
+	}
+
+	return position;
+}
+//==============================================================================
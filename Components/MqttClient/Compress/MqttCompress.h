@@ -0,0 +1,66 @@
+//==============================================================================
+//header:
+
+#ifndef _MQTT_COMPRESS_H_
+#define _MQTT_COMPRESS_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include <stdint.h>
+#include <stdbool.h>
+//==============================================================================
+//defines:
+
+/// @brief first byte of the payload: MQTT_COMPRESS_HEADER_RAW or
+/// MQTT_COMPRESS_HEADER_FLAG | (LookaheadBits << 4) | WindowBits
+#define MQTT_COMPRESS_HEADER_SIZE 1
+#define MQTT_COMPRESS_HEADER_RAW 0x00
+#define MQTT_COMPRESS_HEADER_FLAG 0x80
+
+#define MQTT_COMPRESS_MIN_WINDOW_BITS 4
+#define MQTT_COMPRESS_MAX_WINDOW_BITS 15
+#define MQTT_COMPRESS_MIN_LOOKAHEAD_BITS 3 //a token is at least 8 bits
+#define MQTT_COMPRESS_MAX_LOOKAHEAD_BITS 7
+
+#define MQTT_COMPRESS_MIN_MATCH 2
+//==============================================================================
+//types:
+
+/**
+ * @brief LZSS encoder (heatshrink bitstream): a literal is 1 + 8 bits, a back-reference
+ * is 0 + WindowBits (distance - 1) + LookaheadBits (length - MIN_MATCH).
+ * The window is the already added part of the current fragment, the encoder keeps no copy of it.
+ */
+typedef struct
+{
+	uint8_t* Output;
+	uint32_t OutputSize;
+	uint32_t Position;
+
+	uint8_t BitBuffer;
+	uint8_t BitCount;
+
+	uint8_t WindowBits;
+	uint8_t LookaheadBits;
+
+	bool IsOverflowed;
+
+} MqttCompressEncoderT;
+//==============================================================================
+//functions:
+
+void MqttCompressBegin(MqttCompressEncoderT* encoder, uint8_t* output, uint32_t outputSize, uint8_t windowBits, uint8_t lookaheadBits);
+void MqttCompressAdd(MqttCompressEncoderT* encoder, const void* data, uint32_t size);
+int32_t MqttCompressEnd(MqttCompressEncoderT* encoder);
+
+int32_t MqttCompressDecode(const void* input, uint32_t size, uint8_t* output, uint32_t outputSize);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MQTT_COMPRESS_H_
@@ -0,0 +1,391 @@
+//==============================================================================
+//includes:
+
+#include "MqttEgress.h"
+#include <string.h>
+//==============================================================================
+//functions:
+
+static void privateHeaderWrite(MqttEgressTopicT* topic, uint16_t offset, uint16_t size, uint32_t timeStamp)
+{
+	memcpy(topic->Memory + offset, &size, sizeof(size));
+	memcpy(topic->Memory + offset + sizeof(size), &timeStamp, sizeof(timeStamp));
+}
+//------------------------------------------------------------------------------
+static uint16_t privateHeaderReadSize(MqttEgressTopicT* topic, uint16_t offset)
+{
+	uint16_t size;
+
+	memcpy(&size, topic->Memory + offset, sizeof(size));
+
+	return size;
+}
+//------------------------------------------------------------------------------
+static uint32_t privateHeaderReadTime(MqttEgressTopicT* topic, uint16_t offset)
+{
+	uint32_t timeStamp;
+
+	memcpy(&timeStamp, topic->Memory + offset + sizeof(uint16_t), sizeof(timeStamp));
+
+	return timeStamp;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief finds the place for a record of "need" bytes. The data is in [Head, Tail)
+ * or, after the wrap, in [Head, end) and [0, Tail).
+ */
+static bool privateReserve(MqttEgressTopicT* topic, uint16_t need, uint16_t* offset)
+{
+	if (!topic->Count)
+	{
+		topic->Head = 0;
+		topic->Tail = 0;
+	}
+	else if (topic->Tail == topic->Head)
+	{
+		return false;
+	}
+
+	if (topic->Tail > topic->Head || !topic->Count)
+	{
+		if (topic->Size - topic->Tail >= need)
+		{
+			*offset = topic->Tail;
+			return true;
+		}
+
+		if (topic->Head >= need)
+		{
+			//the reader skips the rest of the memory on the mark or if no header fits there
+			if (topic->Size - topic->Tail >= MQTT_EGRESS_RECORD_HEADER_SIZE)
+			{
+				privateHeaderWrite(topic, topic->Tail, MQTT_EGRESS_RECORD_WRAP, 0);
+			}
+
+			*offset = 0;
+			return true;
+		}
+
+		return false;
+	}
+
+	if (topic->Head - topic->Tail >= need)
+	{
+		*offset = topic->Tail;
+		return true;
+	}
+
+	return false;
+}
+//------------------------------------------------------------------------------
+static uint16_t privateHeadGet(MqttEgressTopicT* topic)
+{
+	if (topic->Size - topic->Head < MQTT_EGRESS_RECORD_HEADER_SIZE
+		|| privateHeaderReadSize(topic, topic->Head) == MQTT_EGRESS_RECORD_WRAP)
+	{
+		topic->Head = 0;
+	}
+
+	return topic->Head;
+}
+//------------------------------------------------------------------------------
+static void privateRefill(MqttEgressTopicT* topic, uint32_t time)
+{
+	if (!topic->Rate)
+	{
+		return;
+	}
+
+	//thousandths of a token: exact for the rates above 1000 bytes per second as well
+	uint64_t credit = (uint64_t)(time - topic->RefillTime) * topic->Rate + topic->RefillRemainder;
+	uint64_t tokens = credit / 1000;
+
+	topic->RefillTime = time;
+
+	if (topic->Tokens + (int64_t)tokens >= topic->Burst)
+	{
+		topic->Tokens = topic->Burst;
+		topic->RefillRemainder = 0;
+		return;
+	}
+
+	//the remainder of a token is kept for the next refill
+	topic->Tokens += tokens;
+	topic->RefillRemainder = credit % 1000;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief a record larger than the bucket is sent on the full bucket.
+ */
+static bool privateIsAllowed(MqttEgressTopicT* topic, uint16_t size)
+{
+	return !topic->Rate || topic->Tokens >= size || topic->Tokens >= topic->Burst;
+}
+//------------------------------------------------------------------------------
+static bool privateMerge(MqttEgressTopicT* topic, const void* data, uint16_t size)
+{
+	uint16_t tail = topic->Tail;
+	uint16_t last = topic->Last;
+	uint16_t lastSize = privateHeaderReadSize(topic, last);
+	uint32_t timeStamp = privateHeaderReadTime(topic, last);
+
+	//the last record is taken back, the new one may take its place or go further
+	topic->Tail = last;
+	topic->Count--;
+	topic->QueuedBytes -= lastSize;
+
+	uint16_t head = topic->Head;
+	uint16_t offset;
+
+	if (!privateReserve(topic, MQTT_EGRESS_RECORD_HEADER_SIZE + size, &offset))
+	{
+		topic->Head = head;
+		topic->Tail = tail;
+		topic->Count++;
+		topic->QueuedBytes += lastSize;
+
+		return false;
+	}
+
+	//the record keeps the time of the replaced one, the latency counts from the first value
+	privateHeaderWrite(topic, offset, size, timeStamp);
+	memcpy(topic->Memory + offset + MQTT_EGRESS_RECORD_HEADER_SIZE, data, size);
+
+	topic->Last = offset;
+	topic->Tail = offset + MQTT_EGRESS_RECORD_HEADER_SIZE + size;
+	topic->Count++;
+	topic->QueuedBytes += size;
+
+	return true;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief adds the record to the queue of the topic applying the policy of the topic.
+ * @return xResultAccept if the record is queued or merged, xResultError if it is dropped
+ */
+xResult MqttEgressAdd(MqttEgressT* egress, uint8_t topicIndex, const void* data, uint16_t size, uint32_t time)
+{
+	if (topicIndex >= egress->TopicsCount)
+	{
+		return xResultError;
+	}
+
+	MqttEgressTopicT* topic = &egress->Topics[topicIndex];
+	MqttEgressClassStatisticT* statistic = &egress->Statistic[topic->Class];
+	uint32_t need = MQTT_EGRESS_RECORD_HEADER_SIZE + size;
+
+	privateRefill(topic, time);
+
+	//the first record is always queued, it waits for the tokens
+	bool isOverBudget = topic->Rate && topic->Count && topic->QueuedBytes + size > (uint32_t)(topic->Tokens > 0 ? topic->Tokens : 0);
+
+	if (isOverBudget && topic->Policy == MqttEgressPolicyDrop)
+	{
+		statistic->Dropped++;
+		return xResultError;
+	}
+
+	if (isOverBudget && topic->Policy == MqttEgressPolicyMerge)
+	{
+		if (!privateMerge(topic, data, size))
+		{
+			statistic->Dropped++;
+			return xResultError;
+		}
+
+		statistic->Merged++;
+		return xResultAccept;
+	}
+
+	uint16_t offset;
+
+	if (need > topic->Size || !privateReserve(topic, need, &offset))
+	{
+		statistic->Dropped++;
+		return xResultError;
+	}
+
+	privateHeaderWrite(topic, offset, size, time);
+	memcpy(topic->Memory + offset + MQTT_EGRESS_RECORD_HEADER_SIZE, data, size);
+
+	topic->Last = offset;
+	topic->Tail = offset + need;
+	topic->Count++;
+	topic->QueuedBytes += size;
+
+	statistic->Queued++;
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief selects the next record to send: the highest class first, round-robin between
+ * the topics of a class, a topic is skipped while its bucket doesn't cover the head record.
+ * @return false if no record is allowed now, see MqttEgressGetWaitTime
+ */
+bool MqttEgressPeek(MqttEgressT* egress, uint32_t time, MqttEgressRecordT* record)
+{
+	for (uint8_t priority = 0; priority < MqttEgressClassCount; priority++)
+	{
+		for (uint8_t i = 0; i < egress->TopicsCount; i++)
+		{
+			uint8_t index = (egress->Next[priority] + i) % egress->TopicsCount;
+			MqttEgressTopicT* topic = &egress->Topics[index];
+
+			if (topic->Class != priority || !topic->Count)
+			{
+				continue;
+			}
+
+			uint16_t head = privateHeadGet(topic);
+			uint16_t size = privateHeaderReadSize(topic, head);
+
+			privateRefill(topic, time);
+
+			if (!privateIsAllowed(topic, size))
+			{
+				continue;
+			}
+
+			record->Topic = index;
+			record->Data = topic->Memory + head + MQTT_EGRESS_RECORD_HEADER_SIZE;
+			record->Size = size;
+			record->TimeStamp = privateHeaderReadTime(topic, head);
+
+			return true;
+		}
+	}
+
+	return false;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief removes the sent record, takes its tokens and updates the class latency.
+ */
+void MqttEgressRemove(MqttEgressT* egress, MqttEgressRecordT* record, uint32_t time)
+{
+	MqttEgressTopicT* topic = &egress->Topics[record->Topic];
+	MqttEgressClassStatisticT* statistic = &egress->Statistic[topic->Class];
+	uint32_t latency = time - record->TimeStamp;
+
+	if (topic->Rate)
+	{
+		topic->Tokens -= record->Size;
+	}
+
+	topic->Head = privateHeadGet(topic) + MQTT_EGRESS_RECORD_HEADER_SIZE + record->Size;
+	topic->Count--;
+	topic->QueuedBytes -= record->Size;
+
+	if (!topic->Count)
+	{
+		topic->Head = 0;
+		topic->Tail = 0;
+	}
+
+	egress->Next[topic->Class] = record->Topic + 1;
+
+	statistic->Sent++;
+	statistic->Latency += latency;
+
+	if (latency > statistic->MaxLatency)
+	{
+		statistic->MaxLatency = latency;
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @return ms until a queued record is allowed by its bucket, 0 - now, UINT32_MAX - the queues are empty
+ */
+uint32_t MqttEgressGetWaitTime(MqttEgressT* egress, uint32_t time)
+{
+	uint32_t waitTime = UINT32_MAX;
+
+	for (uint8_t i = 0; i < egress->TopicsCount; i++)
+	{
+		MqttEgressTopicT* topic = &egress->Topics[i];
+
+		if (!topic->Count)
+		{
+			continue;
+		}
+
+		uint16_t size = privateHeaderReadSize(topic, privateHeadGet(topic));
+
+		privateRefill(topic, time);
+
+		if (privateIsAllowed(topic, size))
+		{
+			return 0;
+		}
+
+		//the refill above is done at the time: only the remainder of a token is accumulated
+		int32_t required = (size < topic->Burst ? size : topic->Burst) - topic->Tokens;
+		uint32_t refillTime = ((uint32_t)required * 1000 - topic->RefillRemainder + topic->Rate - 1) / topic->Rate;
+
+		refillTime = refillTime ? refillTime : 1;
+
+		if (refillTime < waitTime)
+		{
+			waitTime = refillTime;
+		}
+	}
+
+	return waitTime;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief topics are indexed in the order of the addition, the index is given to MqttEgressAdd.
+ * The name must stay valid, it is used for the publishes.
+ */
+xResult MqttEgressAddTopic(MqttEgressT* egress, MqttEgressTopicInitT* init, uint8_t* index)
+{
+	if (!init || !init->Name || !init->Memory || init->Size <= MQTT_EGRESS_RECORD_HEADER_SIZE
+		|| init->Class >= MqttEgressClassCount
+		|| (init->Rate && !init->Burst)
+		|| egress->TopicsCount >= egress->TopicsSize)
+	{
+		return xResultError;
+	}
+
+	MqttEgressTopicT* topic = &egress->Topics[egress->TopicsCount];
+
+	memset(topic, 0, sizeof(MqttEgressTopicT));
+
+	topic->Name = init->Name;
+	topic->NameLength = strlen(init->Name);
+	topic->Class = init->Class;
+	topic->Policy = init->Policy;
+	topic->Rate = init->Rate;
+	topic->Burst = init->Burst;
+	topic->Tokens = init->Burst;
+	topic->Memory = init->Memory;
+	topic->Size = init->Size;
+
+	if (index)
+	{
+		*index = egress->TopicsCount;
+	}
+
+	egress->TopicsCount++;
+
+	return xResultAccept;
+}
+//==============================================================================
+//initialization:
+
+xResult MqttEgressInit(MqttEgressT* egress, MqttEgressInitT* init)
+{
+	if (egress && init && init->Topics && init->TopicsSize)
+	{
+		memset(egress, 0, sizeof(MqttEgressT));
+
+		egress->Topics = init->Topics;
+		egress->TopicsSize = init->TopicsSize;
+
+		return xResultAccept;
+	}
+
+	return xResultError;
+}
+//==============================================================================
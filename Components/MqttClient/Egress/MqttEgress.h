@@ -0,0 +1,144 @@
+//==============================================================================
+//header:
+
+#ifndef _MQTT_EGRESS_H_
+#define _MQTT_EGRESS_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+//==============================================================================
+//defines:
+
+#define MQTT_EGRESS_RECORD_HEADER_SIZE 6 //size and time stamp of the record
+#define MQTT_EGRESS_RECORD_WRAP 0xFFFF //the next record is at the start of the queue memory
+//==============================================================================
+//types:
+
+/// @brief the classes are served in the order of priority: a record of a lower class is sent
+/// only when no record of the higher classes is allowed by its token bucket
+typedef enum
+{
+	MqttEgressClassAlarm,
+	MqttEgressClassTelemetry,
+	MqttEgressClassLog,
+
+	MqttEgressClassCount
+
+} MqttEgressClassT;
+//------------------------------------------------------------------------------
+/// @brief what happens with a record that exceeds the budget of its topic:
+/// the queued records and the new one need more bytes than the bucket holds
+typedef enum
+{
+	MqttEgressPolicyQueue, //the record waits for the tokens, dropped only when the queue is full
+	MqttEgressPolicyDrop, //the new record is dropped
+	MqttEgressPolicyMerge //the new record replaces the last queued record of the topic
+
+} MqttEgressPolicyT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Queued;
+	uint32_t Sent;
+	uint32_t Dropped;
+	uint32_t Merged;
+
+	uint32_t Latency; //ms, sum of the queue latencies of the sent records: Latency / Sent - average
+	uint32_t MaxLatency; //ms
+
+} MqttEgressClassStatisticT;
+//------------------------------------------------------------------------------
+/// @brief topic with its own queue and token bucket. The queue is a ring of records,
+/// each record is contiguous: a record that doesn't fit the end starts from the beginning
+typedef struct
+{
+	const char* Name;
+	uint16_t NameLength;
+
+	uint8_t Class;
+	uint8_t Policy;
+
+	uint16_t Rate; //bytes per second, 0 - unlimited
+	uint16_t Burst; //bytes, size of the bucket
+	int32_t Tokens; //negative after a record larger than the bucket
+	uint32_t RefillTime;
+	uint16_t RefillRemainder; //thousandths of a token carried to the next refill
+
+	uint8_t* Memory;
+	uint16_t Size;
+	uint16_t Head;
+	uint16_t Tail;
+	uint16_t Last; //offset of the last added record, the merging target
+	uint16_t Count;
+	uint32_t QueuedBytes;
+
+} MqttEgressTopicT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	const char* Name;
+
+	MqttEgressClassT Class;
+	MqttEgressPolicyT Policy;
+
+	uint16_t Rate;
+	uint16_t Burst;
+
+	uint8_t* Memory;
+	uint16_t Size;
+
+} MqttEgressTopicInitT;
+//------------------------------------------------------------------------------
+/// @brief the record at the head of a topic queue, valid until it is removed
+typedef struct
+{
+	uint8_t Topic;
+
+	uint8_t* Data;
+	uint16_t Size;
+
+	uint32_t TimeStamp; //time of the enqueueing
+
+} MqttEgressRecordT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	MqttEgressTopicT* Topics;
+	uint8_t TopicsSize;
+	uint8_t TopicsCount;
+
+	uint8_t Next[MqttEgressClassCount]; //round-robin position between the topics of a class
+
+	MqttEgressClassStatisticT Statistic[MqttEgressClassCount];
+
+} MqttEgressT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	MqttEgressTopicT* Topics;
+	uint8_t TopicsSize;
+
+} MqttEgressInitT;
+//==============================================================================
+//functions:
+
+xResult MqttEgressInit(MqttEgressT* egress, MqttEgressInitT* init);
+
+xResult MqttEgressAddTopic(MqttEgressT* egress, MqttEgressTopicInitT* init, uint8_t* topic);
+
+xResult MqttEgressAdd(MqttEgressT* egress, uint8_t topic, const void* data, uint16_t size, uint32_t time);
+bool MqttEgressPeek(MqttEgressT* egress, uint32_t time, MqttEgressRecordT* record);
+void MqttEgressRemove(MqttEgressT* egress, MqttEgressRecordT* record, uint32_t time);
+
+uint32_t MqttEgressGetWaitTime(MqttEgressT* egress, uint32_t time);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MQTT_EGRESS_H_
@@ -8,12 +8,52 @@
 #include "MqttClient-Component.h"
 #include "Net/Net-Component.h"
 #include "Components/USART-Ports/USART-Ports-Component.h"
+#include "Adapters/Ports/MqttPort-Selector.h"
+
+#if MQTT_TARGET_LAYOUT == MQTT_FREERTOS_LAYOUT
 #include "Adapters/FreeRTOS-MQTT/MqttClient-Adapter.h"
-#include "Adapters/Ports/FreeRTOS-MQTT/MqttPort-Adapter.h"
+#endif
+
+#include "Outbox/MqttOutbox-W25Q.h"
+#include "Outbox/MqttOutbox-RamFlash.h"
+#include "Router/MqttRouter.h"
+#include "Compress/MqttCompress.h"
+#include "Egress/MqttEgress.h"
+#include "Net/Reconnect/NetReconnect.h"
+#include "Crc/Crc-Component.h"
+#include "rng.h"
+
+#if MQTT_PORT_TLS_ENABLE == 1
+#include "Tls/MqttTls.h"
+#include "Tls/MqttTlsBench.h"
+#include "TerminalCommands/TerminalCommands.h"
+#include <stdio.h>
+
+#ifndef MQTT_TLS_CA_CERTIFICATE
+#error "MQTT_TLS_CA_CERTIFICATE is required to verify the broker"
+#endif
+#endif
+
+#if MQTT_OUTBOX_ENABLE == 1 && CRC_ENABLE != 1
+#error "the outbox records are checked by CRC-32 of the CRC component"
+#endif
+
+#if MQTT_TARGET_LAYOUT == MQTT_LWIP_LAYOUT && NET_TARGET_LAYOUT != NET_LWIP_LAYOUT
+#error "MQTT_LWIP_LAYOUT requires NET_LWIP_LAYOUT"
+#endif
+
+#if MQTT_TARGET_LAYOUT != MQTT_LWIP_LAYOUT && NET_TARGET_LAYOUT != NET_FREERTOS_LAYOUT
+#error "MQTT_FREERTOS_LAYOUT and MQTT_PAHO_LAYOUT require NET_FREERTOS_LAYOUT"
+#endif
 //==============================================================================
 //defines:
 
-#define MQTT_PORT_TX_BUFFER 200
+#if MQTT_PORT_COMPRESS_ENABLE == 1
+//the payload that doesn't shrink is published raw with the compression header
+#define MQTT_PORT_PAYLOAD_SIZE (MQTT_PORT_PUBLISH_SIZE + MQTT_COMPRESS_HEADER_SIZE)
+#else
+#define MQTT_PORT_PAYLOAD_SIZE MQTT_PORT_PUBLISH_SIZE
+#endif
 //==============================================================================
 //import:
 
@@ -31,14 +71,89 @@ static int RTOS_MqttClientTaskStackWaterMark;
 static uint8_t privateMqttTxBuffer[MQTT_TX_BUFFER_SIZE];
 static uint8_t privateMqttPortTxBuffer[MQTT_PORT_TX_BUFFER];
 
+#if MQTT_TARGET_LAYOUT == MQTT_FREERTOS_LAYOUT
+static MQTTPubAckInfo_t privateOutgoingPublishRecords[MQTT_PORT_IN_FLIGHT_WINDOW];
+static MQTTPubAckInfo_t privateIncomingPublishRecords[MQTT_PORT_IN_FLIGHT_WINDOW];
+static MqttPortInFlightPublishT privateInFlight[MQTT_PORT_IN_FLIGHT_WINDOW];
+static uint8_t privateInFlightMemory[MQTT_PORT_IN_FLIGHT_WINDOW * MQTT_PORT_PAYLOAD_SIZE];
+#elif MQTT_TARGET_LAYOUT == MQTT_PAHO_LAYOUT
+static uint8_t privateMqttRxBuffer[MQTT_RX_BUFFER_SIZE];
+static uint8_t privateMqttReadAheadBuffer[MQTT_READ_AHEAD_SIZE];
+#endif
+
+#if MQTT_PORT_COALESCE_ENABLE == 1
+static uint8_t privateCoalesceBuffer[MQTT_PORT_PUBLISH_SIZE];
+#endif
+
+#if MQTT_OUTBOX_ENABLE == 1
+static MqttOutboxFlashInterfaceT privateOutboxFlashInterface;
+
+#if MQTT_OUTBOX_FLASH_SIMULATOR == 1
+static MqttOutboxRamFlashT privateOutboxFlash;
+static uint8_t privateOutboxFlashMemory[MQTT_OUTBOX_SIMULATOR_SECTOR_COUNT * MQTT_OUTBOX_SECTOR_SIZE];
+#else
+static MqttOutboxW25QT privateOutboxFlash =
+{
+	.Handle = &hspi2,
+	.ChipSelectPort = W25Q128_CS_GPIO_Port,
+	.ChipSelectPin = W25Q128_CS_Pin
+};
+#endif
+
+static uint8_t privateOutboxReplayBuffer[MQTT_PORT_PAYLOAD_SIZE];
+
+MqttOutboxT MqttOutbox;
+#endif
+
+#if MQTT_PORT_COMPRESS_ENABLE == 1
+static uint8_t privateCompressBuffer[MQTT_PORT_PAYLOAD_SIZE];
+#endif
+
+#if MQTT_ROUTER_ENABLE == 1
+static MqttRouterNodeT privateRouterNodes[MQTT_ROUTER_NODES];
+static MqttRouteT privateRoutes[MQTT_ROUTER_ROUTES];
+
+MqttRouterT MqttRouter;
+#endif
+
+#if MQTT_EGRESS_ENABLE == 1
+static MqttEgressTopicT privateEgressTopics[MQTT_EGRESS_PORT_LOG_ENABLE == 1 ? 3 : 2];
+static uint8_t privateEgressAlarmQueue[MQTT_EGRESS_ALARM_QUEUE];
+static uint8_t privateEgressTelemetryQueue[MQTT_EGRESS_TELEMETRY_QUEUE];
+#if MQTT_EGRESS_PORT_LOG_ENABLE == 1
+static uint8_t privateEgressLogQueue[MQTT_EGRESS_LOG_QUEUE];
+#endif
+
+MqttEgressT MqttEgress;
+#endif
+
+#if MQTT_PORT_TLS_ENABLE == 1
+static uint8_t privateTlsMemory[MQTT_TLS_MEMORY_SIZE] MQTT_TLS_MEMORY_SECTION;
+static uint8_t privateTlsBenchBuffer[MQTT_TLS_BENCH_BUFFER_SIZE];
+static char privateTlsReportBuffer[128];
+
+MqttTlsT MqttTls;
+#endif
+
+NetReconnectT MqttReconnect;
+
 xPortT MqttPort;
+
+#if MQTT_TARGET_LAYOUT == MQTT_FREERTOS_LAYOUT
 xMqttT MqttClient;
+#endif
 
 uint32_t MqttTxTimeStamp = 0;
 //==============================================================================
 //functions:
 
-
+#if MQTT_OUTBOX_ENABLE == 1
+/// @brief the CRC-32 of the outbox records
+static uint32_t privateOutboxCrc(const void* data, uint32_t size)
+{
+	return CrcComponentCalculate(CrcVariant32, data, size);
+}
+#endif
 //------------------------------------------------------------------------------
 static void privateTask(void* arg)
 {
@@ -97,15 +212,30 @@ static void privateTask(void* arg)
 		{
 			xPortRequestListener(&MqttPort, xPortAdapterRequestOpen, 0, NULL);
 
+			if (!MqttPort.IsOpen)
+			{
+				vTaskDelay(pdMS_TO_TICKS(MQTT_TASK_RECONNECT_PERIOD));
+			}
+
 			continue;
 		}
 
-		xPortDirectlyHandler(MqttPort);
-
 		if (!MqttPort.IsConnected)
 		{
 			xPortRequestListener(&MqttPort, xPortAdapterRequestConnect, 0, NULL);
+
+			if (!MqttPort.IsConnected)
+			{
+				//sleeps until the next attempt allowed by MqttReconnect
+				MqttPortAdapterWaitEvent(&MqttPort, MQTT_TASK_MAX_WAIT_TIME);
+
+				continue;
+			}
 		}
+
+		xPortDirectlyHandler(MqttPort);
+
+		MqttPortAdapterWaitEvent(&MqttPort, MQTT_TASK_MAX_WAIT_TIME);
 	}
 }
 //------------------------------------------------------------------------------
@@ -121,13 +251,105 @@ static void privateEventListener(xPortT* port, int selector, uint32_t descriptio
 		default: break;
 	}
 }
+//------------------------------------------------------------------------------
+#if MQTT_PORT_TLS_ENABLE == 1
+/**
+ * @brief the SNTP time carried by the system clock from the first call after the synchronization,
+ * 0 until Net has it: the TLS handshake waits for it
+ */
+static uint32_t privateTlsGetTime()
+{
+	static uint32_t time;
+	static uint32_t synchronized;
+	static uint32_t stamp;
+
+	if (!Net.SNTP_Complite)
+	{
+		return 0;
+	}
+
+	uint32_t now = xSystemGetTime();
+
+	if (Net.SNTP.LastTime != synchronized)
+	{
+		synchronized = Net.SNTP.LastTime;
+		time = synchronized;
+		stamp = now;
+	}
+
+	//the whole seconds are moved to the time: the ms counter doesn't wrap under the stamp
+	uint32_t seconds = (now - stamp) / 1000;
+
+	time += seconds;
+	stamp += seconds * 1000;
+
+	return time;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief "mqtt-tls-bench [-s size] [-n count]": KB/s of the record ciphers of MQTT_TLS_CIPHER_LIST,
+ * AES-GCM is done by the tables of the software, the STM32F407 has no CRYP unit
+ */
+static xResult privateTlsBenchCommand(xPortT* port, TerminalCommandArgumentsT* arguments)
+{
+	if (TerminalCommandCheckOptions(arguments, "sn", NULL) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	uint32_t size = TerminalCommandGetNumber(arguments, 's', MQTT_TLS_BENCH_DEFAULT_SIZE);
+	uint32_t count = TerminalCommandGetNumber(arguments, 'n', MQTT_TLS_BENCH_DEFAULT_COUNT);
+
+	if (!size || size > MQTT_TLS_BENCH_BUFFER_SIZE || !count)
+	{
+		return xResultError;
+	}
+
+	for (uint8_t cipher = 0; cipher < MqttTlsBenchCiphersCount; cipher++)
+	{
+		uint32_t start = DWT->CYCCNT;
+		xResult result = MqttTlsBenchSeal(cipher, privateTlsBenchBuffer, size, count);
+		uint32_t cycles = DWT->CYCCNT - start;
+
+		snprintf(privateTlsReportBuffer, sizeof(privateTlsReportBuffer),
+					"[mqtt-tls-bench] %s: %lu records of %lu bytes, %lu KB/s, %lu cycles/byte%s\r",
+					MqttTlsBenchCipherNames[cipher],
+					count,
+					size,
+					cycles ? (uint32_t)((uint64_t)size * count * (SystemCoreClock / 1000) / cycles) : 0,
+					cycles / (size * count),
+					result != xResultAccept ? ", FAIL" : "");
+
+		xPortStartTransmission(port);
+		xPortTransmitString(port, privateTlsReportBuffer);
+		xPortEndTransmission(port);
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static const TerminalCommandT privateCommands[] =
+{
+	{
+		.Name = "mqtt-tls-bench",
+		.Usage = "[-s size] [-n count]",
+		.Handler = privateTlsBenchCommand
+	}
+};
+#endif
 //==============================================================================
 //initializations:
 
 static MqttPortAdapterT privateMqttPortAdapter =
 {
 	.Id = MQTT_CLIENT_ID,
+#if MQTT_PORT_TLS_ENABLE == 1
+	.NetPort = MQTT_BROKER_TLS_PORT,
+#else
 	.NetPort = MQTT_BROKER_PORT,
+#endif
+	.QoS = MQTT_PORT_QOS,
+	.KeepAlive = MQTT_PORT_KEEP_ALIVE,
 	.NetAddress =
 	{
 		.Octet1 = MQTT_BROKER_IP_ADDR3,
@@ -139,6 +361,93 @@ static MqttPortAdapterT privateMqttPortAdapter =
 //==============================================================================
 //initialization:
 
+#if MQTT_OUTBOX_ENABLE == 1
+static MqttOutboxT* privateOutboxInit()
+{
+	MqttOutboxInitT init = { 0 };
+	init.Flash = &privateOutboxFlashInterface;
+	init.Crc = privateOutboxCrc;
+	init.SectorSize = MQTT_OUTBOX_SECTOR_SIZE;
+
+#if MQTT_OUTBOX_FLASH_SIMULATOR == 1
+	MqttOutboxRamFlashInit(&privateOutboxFlash,
+							&privateOutboxFlashInterface,
+							privateOutboxFlashMemory,
+							sizeof(privateOutboxFlashMemory),
+							MQTT_OUTBOX_SECTOR_SIZE);
+
+	init.SectorCount = MQTT_OUTBOX_SIMULATOR_SECTOR_COUNT;
+#else
+	if (MqttOutboxW25QInit(&privateOutboxFlash, &privateOutboxFlashInterface) != xResultAccept)
+	{
+		return NULL;
+	}
+
+	init.Address = MQTT_OUTBOX_FLASH_ADDRESS;
+	init.SectorCount = MQTT_OUTBOX_SECTOR_COUNT;
+#endif
+
+	//the records left from the previous run are restored here and replayed after the connection
+	return MqttOutboxInit(&MqttOutbox, &init) == xResultAccept ? &MqttOutbox : NULL;
+}
+#endif
+//------------------------------------------------------------------------------
+#if MQTT_EGRESS_ENABLE == 1
+static MqttEgressT* privateEgressInit()
+{
+	MqttEgressInitT init = { 0 };
+	init.Topics = privateEgressTopics;
+	init.TopicsSize = sizeof(privateEgressTopics) / sizeof(privateEgressTopics[0]);
+
+	if (MqttEgressInit(&MqttEgress, &init) != xResultAccept)
+	{
+		return NULL;
+	}
+
+	//added in the order of MqttClientEgressTopicAlarm, MqttClientEgressTopicTelemetry, MqttClientEgressTopicLog
+	MqttEgressTopicInitT topics[] =
+	{
+		{
+			.Name = MQTT_EGRESS_ALARM_TOPIC,
+			.Class = MqttEgressClassAlarm,
+			.Policy = MqttEgressPolicyQueue,
+			.Memory = privateEgressAlarmQueue,
+			.Size = sizeof(privateEgressAlarmQueue)
+		},
+		{
+			.Name = MQTT_EGRESS_TELEMETRY_TOPIC,
+			.Class = MqttEgressClassTelemetry,
+			.Policy = MqttEgressPolicyMerge,
+			.Rate = MQTT_EGRESS_TELEMETRY_RATE,
+			.Burst = MQTT_EGRESS_TELEMETRY_BURST,
+			.Memory = privateEgressTelemetryQueue,
+			.Size = sizeof(privateEgressTelemetryQueue)
+		},
+#if MQTT_EGRESS_PORT_LOG_ENABLE == 1
+		{
+			.Name = MQTT_TOPIC_TX,
+			.Class = MqttEgressClassLog,
+			.Policy = MqttEgressPolicyDrop,
+			.Rate = MQTT_EGRESS_LOG_RATE,
+			.Burst = MQTT_EGRESS_LOG_BURST,
+			.Memory = privateEgressLogQueue,
+			.Size = sizeof(privateEgressLogQueue)
+		}
+#endif
+	};
+
+	for (uint8_t i = 0; i < sizeof(topics) / sizeof(topics[0]); i++)
+	{
+		if (MqttEgressAddTopic(&MqttEgress, &topics[i], NULL) != xResultAccept)
+		{
+			return NULL;
+		}
+	}
+
+	return &MqttEgress;
+}
+#endif
+//------------------------------------------------------------------------------
 xResult MqttClientComponentInit(void* parent)
 {
 	/*
@@ -161,6 +470,93 @@ xResult MqttClientComponentInit(void* parent)
 	portAdapterInit.TxBuffer = privateMqttPortTxBuffer;
 	portAdapterInit.TxBufferSize = sizeof(privateMqttPortTxBuffer);
 
+#if MQTT_TARGET_LAYOUT == MQTT_FREERTOS_LAYOUT
+	portAdapterInit.OutgoingPublishRecords = privateOutgoingPublishRecords;
+	portAdapterInit.IncomingPublishRecords = privateIncomingPublishRecords;
+	portAdapterInit.InFlight = privateInFlight;
+	portAdapterInit.InFlightMemory = privateInFlightMemory;
+	portAdapterInit.InFlightPayloadSize = MQTT_PORT_PAYLOAD_SIZE;
+	portAdapterInit.InFlightWindow = MQTT_PORT_IN_FLIGHT_WINDOW;
+#elif MQTT_TARGET_LAYOUT == MQTT_PAHO_LAYOUT
+	portAdapterInit.ReadBuffer = privateMqttRxBuffer;
+	portAdapterInit.ReadBufferSize = sizeof(privateMqttRxBuffer);
+	portAdapterInit.ReadAheadBuffer = privateMqttReadAheadBuffer;
+	portAdapterInit.ReadAheadBufferSize = sizeof(privateMqttReadAheadBuffer);
+#endif
+
+#if MQTT_PORT_COALESCE_ENABLE == 1
+	portAdapterInit.CoalesceBuffer = privateCoalesceBuffer;
+	portAdapterInit.CoalesceBufferSize = sizeof(privateCoalesceBuffer);
+	portAdapterInit.CoalesceThreshold = MQTT_PORT_COALESCE_THRESHOLD;
+	portAdapterInit.CoalesceDeadline = MQTT_PORT_COALESCE_DEADLINE;
+#endif
+
+#if MQTT_PORT_COMPRESS_ENABLE == 1
+	portAdapterInit.CompressBuffer = privateCompressBuffer;
+	portAdapterInit.CompressBufferSize = sizeof(privateCompressBuffer);
+	portAdapterInit.CompressWindowBits = MQTT_PORT_COMPRESS_WINDOW_BITS;
+	portAdapterInit.CompressLookaheadBits = MQTT_PORT_COMPRESS_LOOKAHEAD_BITS;
+#endif
+
+#if MQTT_PORT_TLS_ENABLE == 1
+	MqttTlsInitT tlsInit = { 0 };
+	tlsInit.Memory = privateTlsMemory;
+	tlsInit.MemorySize = sizeof(privateTlsMemory);
+	tlsInit.CaCertificate = MQTT_TLS_CA_CERTIFICATE;
+	tlsInit.ServerName = MQTT_TLS_SERVER_NAME;
+	tlsInit.GetTime = privateTlsGetTime;
+	tlsInit.CipherList = MQTT_TLS_CIPHER_LIST;
+
+	if (MqttTlsInit(&MqttTls, &tlsInit) == xResultAccept)
+	{
+		portAdapterInit.Tls = &MqttTls;
+	}
+
+	TerminalCommandsAdd(privateCommands, sizeof(privateCommands) / sizeof(privateCommands[0]));
+#endif
+
+#if MQTT_ROUTER_ENABLE == 1
+	MqttRouterInitT routerInit = { 0 };
+	routerInit.Nodes = privateRouterNodes;
+	routerInit.NodesSize = MQTT_ROUTER_NODES;
+	routerInit.Routes = privateRoutes;
+	routerInit.RoutesSize = MQTT_ROUTER_ROUTES;
+
+	//the routes are added by the other components with MqttRouterAdd before the connection
+	if (MqttRouterInit(&MqttRouter, &routerInit) == xResultAccept)
+	{
+		portAdapterInit.Router = &MqttRouter;
+	}
+#endif
+
+	NetReconnectInitT reconnectInit = { 0 };
+	reconnectInit.Name = nameof(MqttPort);
+	reconnectInit.BaseDelay = MQTT_PORT_RECONNECT_BASE_DELAY;
+	reconnectInit.MaxDelay = MQTT_PORT_RECONNECT_MAX_DELAY;
+	reconnectInit.StableTime = MQTT_PORT_RECONNECT_STABLE_TIME;
+	HAL_RNG_GenerateRandomNumber(&hrng, &reconnectInit.Seed);
+
+	if (NetReconnectInit(&MqttReconnect, &reconnectInit) == xResultAccept)
+	{
+		portAdapterInit.Reconnect = &MqttReconnect;
+	}
+
+#if MQTT_EGRESS_ENABLE == 1
+	portAdapterInit.Egress = privateEgressInit();
+#if MQTT_EGRESS_PORT_LOG_ENABLE == 1
+	portAdapterInit.EgressPortTopic = MqttClientEgressTopicLog;
+#else
+	portAdapterInit.EgressPortTopic = MQTT_PORT_EGRESS_TOPIC_NONE;
+#endif
+#endif
+
+#if MQTT_OUTBOX_ENABLE == 1
+	portAdapterInit.Outbox = privateOutboxInit();
+	portAdapterInit.ReplayBuffer = privateOutboxReplayBuffer;
+	portAdapterInit.ReplayBufferSize = sizeof(privateOutboxReplayBuffer);
+	portAdapterInit.ReplayRate = MQTT_OUTBOX_REPLAY_RATE;
+#endif
+
 	MqttPortAdapterInit(&MqttPort, &privateMqttPortAdapter, &portAdapterInit);
 
 	xPortInitT portInit = { 0 };
@@ -12,10 +12,18 @@ extern "C" {
 
 #include "MqttClient-ComponentConfig.h"
 #include "Abstractions/xMQTT/xMQTT-Types.h"
+#include "MqttClient/Router/MqttRouter.h"
+#include "MqttClient/Egress/MqttEgress.h"
 //==============================================================================
-//defines:
-
+//types:
 
+/// @brief egress topics of MqttPortAdapterEnqueue(&MqttPort, ...)
+enum
+{
+	MqttClientEgressTopicAlarm,
+	MqttClientEgressTopicTelemetry,
+	MqttClientEgressTopicLog //the port transmissions, MQTT_EGRESS_PORT_LOG_ENABLE
+};
 //==============================================================================
 //functions:
 
@@ -34,6 +42,15 @@ void MqttClientComponentHandler();
 //==============================================================================
 //export:
 
+#if MQTT_ROUTER_ENABLE == 1
+extern MqttRouterT MqttRouter;
+#endif
+
+#if MQTT_EGRESS_ENABLE == 1
+extern MqttEgressT MqttEgress;
+#endif
+
+extern xPortT MqttPort;
 
 //==============================================================================
 #ifdef __cplusplus
@@ -16,7 +16,28 @@ extern "C" {
 
 #define MQTT_CLIENT_COMPONENT_MAIN_TASK_STACK_SECTION __attribute__((section("._user_heap_stack")))
 
-#define MQTT_TASK_STACK_SIZE 0x100
+//set by the build together with the wolfSSL sources: cmake -DMQTT_TLS=ON, in the IDE the symbol
+//MQTT_PORT_TLS_ENABLE=1 and Middlewares/wolfSSL removed from the excluded resources
+#ifndef MQTT_PORT_TLS_ENABLE
+#define MQTT_PORT_TLS_ENABLE 0
+#endif
+
+#if MQTT_PORT_TLS_ENABLE == 1
+//words: the handshake runs in the MQTT task, mqtt-tls-handshake-bench measured 14.2 KB for the ECDSA chain and 8 KB for RSA-2048 on a 64-bit host
+//(wc_ecc_verify_hash_ex 8.5 KB of SP_INT_BITS numbers, sp_ecc_verify_256 1.1 KB, AddCA 1.1 KB)
+#define MQTT_TASK_STACK_SIZE 0x1000
+#else
+//words: the deepest pass is a terminal command received on the port and answered from the same pass, ~2.2 KB
+//(coreMQTT receive 0.2, router at 3 topic levels 0.5, command 0.5, reply publish with FreeRTOS_send 0.65,
+//FPU context 0.2), see RTOS_MqttClientTaskStackWaterMark on the target
+#define MQTT_TASK_STACK_SIZE 0x300
+#endif
+#define MQTT_TASK_MAX_WAIT_TIME 1000 //ms, the task is idle until a socket event or a timer
+#define MQTT_TASK_RECONNECT_PERIOD 1000 //ms, retry of the port opening
+
+#define MQTT_PORT_RECONNECT_BASE_DELAY 1000 //ms, the backoff ceiling after the first failure
+#define MQTT_PORT_RECONNECT_MAX_DELAY 60000 //ms
+#define MQTT_PORT_RECONNECT_STABLE_TIME 60000 //ms, the connection that lived so long resets the backoff
 
 #define MQTT_BROKER_IP_ADDR0 90
 #define MQTT_BROKER_IP_ADDR1 156
@@ -25,18 +46,96 @@ extern "C" {
 
 #define MQTT_BROKER_ADDRESS	"90.156.229.205"
 #define MQTT_BROKER_PORT    1883
+#define MQTT_BROKER_TLS_PORT 8883
 #define MQTT_CLIENT_ID      "bro-123456"
 #define MQTT_TOPIC_RX		"bro-rx"
 #define MQTT_TOPIC_TX		"bro-tx"
 
 #define MQTT_TX_BUFFER_SIZE	250
+#define MQTT_RX_BUFFER_SIZE	250 //incoming packets of the Paho engine, coreMQTT and lwIP use MQTT_TX_BUFFER_SIZE
+#define MQTT_READ_AHEAD_SIZE	256 //socket bytes received in bulk by the Paho engine, serves the byte reads of the packet header
+#define MQTT_PORT_TX_BUFFER 200
+
+#define MQTT_PORT_QOS 1 //0, 1 or 2
+#define MQTT_PORT_KEEP_ALIVE 30 //seconds, a dead broker is detected in KEEP_ALIVE + MQTT_PINGRESP_TIMEOUT_MS
+#define MQTT_PORT_IN_FLIGHT_WINDOW 4 //unacknowledged publishes, QoS1/QoS2 only
+#define MQTT_PORT_IN_FLIGHT_WAIT_TIME 1000 //ms, waiting for a free slot of the window
+
+#define MQTT_PORT_COALESCE_ENABLE 0 //changes the payload of MQTT_TOPIC_TX: the receiving side must split the size-prefixed records
+#define MQTT_PORT_PUBLISH_SIZE 512 //maximum payload of one publish
+#define MQTT_PORT_COALESCE_THRESHOLD 384 //bytes, the coalesced records are published on reaching
+#define MQTT_PORT_COALESCE_DEADLINE 20 //ms, maximum time a record waits for coalescing
+
+#define MQTT_TLS_MEMORY_SECTION __attribute__((section(".ccmram"))) //accessed by the CPU only
+#define MQTT_TLS_MEMORY_SIZE (60 * 1024) //static pool of wolfSSL, see WOLFMEM_BUCKETS in user_settings.h
+#define MQTT_TLS_SERVER_NAME MQTT_BROKER_ADDRESS //DNS name or IP address in the broker certificate (subject alt name or CN)
+#define MQTT_TLS_CIPHER_LIST "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:"\
+							"ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305"
+#define MQTT_PORT_TLS_HANDSHAKE_TIMEOUT 10000 //ms
+#define MQTT_TLS_BENCH_BUFFER_SIZE 1024 //"mqtt-tls-bench": the largest record
+#define MQTT_TLS_BENCH_DEFAULT_SIZE 256
+#define MQTT_TLS_BENCH_DEFAULT_COUNT 256
+//#define MQTT_TLS_CA_CERTIFICATE "-----BEGIN CERTIFICATE-----\n...\n-----END CERTIFICATE-----\n"
 
+#define MQTT_PORT_COMPRESS_ENABLE 0 //the receiving side must decode the payloads with MqttCompressDecode
+#define MQTT_PORT_COMPRESS_WINDOW_BITS 8 //256 bytes
+#define MQTT_PORT_COMPRESS_LOOKAHEAD_BITS 4 //matches up to 17 bytes
+
+#define MQTT_EGRESS_ENABLE 1 //priority classes and token buckets of the publishes
+#define MQTT_EGRESS_BURST 8 //records published by one pass of the port task
+#define MQTT_EGRESS_ALARM_TOPIC "bro-alarm"
+#define MQTT_EGRESS_ALARM_QUEUE 512 //bytes, the alarms are not limited by the rate
+#define MQTT_EGRESS_TELEMETRY_TOPIC "bro-telemetry"
+#define MQTT_EGRESS_TELEMETRY_QUEUE 1024
+#define MQTT_EGRESS_TELEMETRY_RATE 512 //bytes per second, the excess replaces the last queued value
+#define MQTT_EGRESS_TELEMETRY_BURST 1024
+//the port transmissions to MQTT_TOPIC_TX take the log class: the terminal replies above
+//MQTT_EGRESS_LOG_RATE are dropped. 0 - they are published directly in the order of the calls
+#define MQTT_EGRESS_PORT_LOG_ENABLE 0
+#define MQTT_EGRESS_LOG_QUEUE 2048
+#define MQTT_EGRESS_LOG_RATE 2048 //bytes per second, the excess is dropped
+#define MQTT_EGRESS_LOG_BURST 1024
+
+#define MQTT_ROUTER_ENABLE 1
+#define MQTT_ROUTER_ROUTES 16 //topic filters besides MQTT_TOPIC_RX
+#define MQTT_ROUTER_NODES 512 //one node per distinct character of the filters
+#define MQTT_PORT_SUBSCRIBE_BATCH 8 //filters in one SUBSCRIBE
+#define MQTT_PORT_PUBLISH_FRAGMENTS 6 //caller-owned fragments of one MqttPortAdapterPublish
+
+#define MQTT_OUTBOX_ENABLE 1
+#define MQTT_OUTBOX_FLASH_SIMULATOR 0 //the outbox in RAM instead of the 25Q64 flash
+#define MQTT_OUTBOX_FLASH_ADDRESS 0
+#define MQTT_OUTBOX_SECTOR_SIZE 4096
+#define MQTT_OUTBOX_SECTOR_COUNT 256 //1MB of the 8MB flash
+#define MQTT_OUTBOX_SIMULATOR_SECTOR_COUNT 4
+#define MQTT_OUTBOX_REPLAY_RATE 20 //records per second
+#define MQTT_OUTBOX_REPLAY_BURST 4 //records
+
+//engine of MqttPort, all of them implement the port contract of Adapters/Ports/MqttPort-Selector.h
 #define MQTT_UNDEFINED_LAYOUT 0
-#define MQTT_LWIP_LAYOUT 1
-#define MQTT_FREERTOS_LAYOUT 2
+#define MQTT_LWIP_LAYOUT 1 //lwIP apps/mqtt, requires NET_LWIP_LAYOUT
+#define MQTT_FREERTOS_LAYOUT 2 //coreMQTT over FreeRTOS+TCP
+#define MQTT_PAHO_LAYOUT 3 //Paho embedded-C over FreeRTOS+TCP
 
 #ifndef MQTT_TARGET_LAYOUT
-#define MQTT_TARGET_LAYOUT NET_FREERTOS_LAYOUT
+#define MQTT_TARGET_LAYOUT MQTT_FREERTOS_LAYOUT
+#endif
+
+#if MQTT_TARGET_LAYOUT != MQTT_FREERTOS_LAYOUT
+//the delivery features are built on the coreMQTT port
+#undef MQTT_PORT_TLS_ENABLE
+#undef MQTT_PORT_COALESCE_ENABLE
+#undef MQTT_PORT_COMPRESS_ENABLE
+#undef MQTT_EGRESS_ENABLE
+#undef MQTT_ROUTER_ENABLE
+#undef MQTT_OUTBOX_ENABLE
+
+#define MQTT_PORT_TLS_ENABLE 0
+#define MQTT_PORT_COALESCE_ENABLE 0
+#define MQTT_PORT_COMPRESS_ENABLE 0
+#define MQTT_EGRESS_ENABLE 0
+#define MQTT_ROUTER_ENABLE 0
+#define MQTT_OUTBOX_ENABLE 0
 #endif
 //==============================================================================
 //import:
@@ -0,0 +1,85 @@
+//==============================================================================
+//includes:
+
+#include "MqttOutbox-RamFlash.h"
+#include <string.h>
+//==============================================================================
+//functions:
+
+static xResult privateRead(MqttOutboxRamFlashT* flash, uint32_t address, void* data, uint32_t size)
+{
+	if (address + size > flash->Size)
+	{
+		return xResultError;
+	}
+
+	memcpy(data, flash->Memory + address, size);
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static xResult privateWrite(MqttOutboxRamFlashT* flash, uint32_t address, const void* data, uint32_t size)
+{
+	const uint8_t* in = data;
+
+	if (address + size > flash->Size)
+	{
+		return xResultError;
+	}
+
+	for (uint32_t i = 0; i < size; i++)
+	{
+		//as NOR flash: programming only clears bits
+		if (in[i] & ~flash->Memory[address + i])
+		{
+			flash->ProgramErrors++;
+		}
+
+		flash->Memory[address + i] &= in[i];
+	}
+
+	flash->ProgrammedBytes += size;
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static xResult privateErase(MqttOutboxRamFlashT* flash, uint32_t address)
+{
+	address -= address % flash->SectorSize;
+
+	if (address + flash->SectorSize > flash->Size)
+	{
+		return xResultError;
+	}
+
+	memset(flash->Memory + address, 0xFF, flash->SectorSize);
+	flash->ErasedSectors++;
+
+	return xResultAccept;
+}
+//==============================================================================
+//initialization:
+
+xResult MqttOutboxRamFlashInit(MqttOutboxRamFlashT* flash, MqttOutboxFlashInterfaceT* interface, uint8_t* memory, uint32_t size, uint32_t sectorSize)
+{
+	if (flash && interface && memory && sectorSize)
+	{
+		memset(flash, 0, sizeof(MqttOutboxRamFlashT));
+
+		flash->Memory = memory;
+		flash->Size = size;
+		flash->SectorSize = sectorSize;
+
+		memset(memory, 0xFF, size);
+
+		interface->Read = (void*)privateRead;
+		interface->Write = (void*)privateWrite;
+		interface->Erase = (void*)privateErase;
+		interface->Context = flash;
+
+		return xResultAccept;
+	}
+
+	return xResultError;
+}
+//==============================================================================
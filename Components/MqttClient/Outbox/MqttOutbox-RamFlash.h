@@ -0,0 +1,38 @@
+//==============================================================================
+//header:
+
+#ifndef _MQTT_OUTBOX_RAM_FLASH_H_
+#define _MQTT_OUTBOX_RAM_FLASH_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "MqttOutbox.h"
+//==============================================================================
+//types:
+
+/// @brief NOR flash simulator in RAM to run the outbox without the 25Q64 chip.
+typedef struct
+{
+	uint8_t* Memory;
+	uint32_t Size;
+	uint32_t SectorSize;
+
+	uint32_t ProgrammedBytes;
+	uint32_t ErasedSectors;
+	uint32_t ProgramErrors; //writes that tried to set bits to 1 without an erase
+
+} MqttOutboxRamFlashT;
+//==============================================================================
+//functions:
+
+xResult MqttOutboxRamFlashInit(MqttOutboxRamFlashT* flash, MqttOutboxFlashInterfaceT* interface, uint8_t* memory, uint32_t size, uint32_t sectorSize);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MQTT_OUTBOX_RAM_FLASH_H_
@@ -0,0 +1,199 @@
+//==============================================================================
+//includes:
+
+#include "MqttOutbox-W25Q.h"
+#include "Components.h"
+//==============================================================================
+//defines:
+
+#define W25Q_COMMAND_WRITE_ENABLE 0x06
+#define W25Q_COMMAND_READ_STATUS1 0x05
+#define W25Q_COMMAND_READ_DATA 0x03
+#define W25Q_COMMAND_PAGE_PROGRAM 0x02
+#define W25Q_COMMAND_SECTOR_ERASE 0x20
+#define W25Q_COMMAND_JEDEC_ID 0x9F
+#define W25Q_COMMAND_RELEASE_POWER_DOWN 0xAB
+
+#define W25Q_STATUS_BUSY 0x01
+//==============================================================================
+//functions:
+
+static inline void privateSelect(MqttOutboxW25QT* flash)
+{
+	HAL_GPIO_WritePin(flash->ChipSelectPort, flash->ChipSelectPin, GPIO_PIN_RESET);
+}
+//------------------------------------------------------------------------------
+static inline void privateDeselect(MqttOutboxW25QT* flash)
+{
+	HAL_GPIO_WritePin(flash->ChipSelectPort, flash->ChipSelectPin, GPIO_PIN_SET);
+}
+//------------------------------------------------------------------------------
+static xResult privateCommand(MqttOutboxW25QT* flash, uint8_t command, uint32_t address, bool hasAddress)
+{
+	uint8_t frame[] = { command, (uint8_t)(address >> 16), (uint8_t)(address >> 8), (uint8_t)address };
+
+	if (HAL_SPI_Transmit(flash->Handle, frame, hasAddress ? sizeof(frame) : 1, W25Q_TIMEOUT) != HAL_OK)
+	{
+		return xResultError;
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static xResult privateWriteEnable(MqttOutboxW25QT* flash)
+{
+	privateSelect(flash);
+	xResult result = privateCommand(flash, W25Q_COMMAND_WRITE_ENABLE, 0, false);
+	privateDeselect(flash);
+
+	return result;
+}
+//------------------------------------------------------------------------------
+static xResult privateWaitReady(MqttOutboxW25QT* flash, uint32_t timeout)
+{
+	uint32_t timeStamp = xSystemGetTime();
+	uint8_t status;
+
+	do
+	{
+		privateSelect(flash);
+		privateCommand(flash, W25Q_COMMAND_READ_STATUS1, 0, false);
+		HAL_StatusTypeDef result = HAL_SPI_Receive(flash->Handle, &status, sizeof(status), W25Q_TIMEOUT);
+		privateDeselect(flash);
+
+		if (result != HAL_OK)
+		{
+			return xResultError;
+		}
+
+		if (!(status & W25Q_STATUS_BUSY))
+		{
+			return xResultAccept;
+		}
+
+#ifdef INC_FREERTOS_H
+		//the sector erase takes tens of milliseconds, the other tasks are not blocked
+		vTaskDelay(1);
+#endif
+	}
+	while (xSystemGetTime() - timeStamp < timeout);
+
+	return xResultError;
+}
+//------------------------------------------------------------------------------
+static xResult privateRead(MqttOutboxW25QT* flash, uint32_t address, void* data, uint32_t size)
+{
+	privateSelect(flash);
+
+	xResult result = privateCommand(flash, W25Q_COMMAND_READ_DATA, address, true);
+
+	if (result == xResultAccept && HAL_SPI_Receive(flash->Handle, data, size, W25Q_TIMEOUT) != HAL_OK)
+	{
+		result = xResultError;
+	}
+
+	privateDeselect(flash);
+
+	return result;
+}
+//------------------------------------------------------------------------------
+static xResult privateWrite(MqttOutboxW25QT* flash, uint32_t address, const void* data, uint32_t size)
+{
+	const uint8_t* in = data;
+
+	while (size)
+	{
+		//page program wraps inside the page, the writes are split on the page boundaries
+		uint32_t part = W25Q_PAGE_SIZE - (address % W25Q_PAGE_SIZE);
+
+		if (part > size)
+		{
+			part = size;
+		}
+
+		if (privateWriteEnable(flash) != xResultAccept)
+		{
+			return xResultError;
+		}
+
+		privateSelect(flash);
+
+		xResult result = privateCommand(flash, W25Q_COMMAND_PAGE_PROGRAM, address, true);
+
+		if (result == xResultAccept && HAL_SPI_Transmit(flash->Handle, (uint8_t*)in, part, W25Q_TIMEOUT) != HAL_OK)
+		{
+			result = xResultError;
+		}
+
+		privateDeselect(flash);
+
+		if (result != xResultAccept || privateWaitReady(flash, W25Q_PROGRAM_TIMEOUT) != xResultAccept)
+		{
+			return xResultError;
+		}
+
+		address += part;
+		in += part;
+		size -= part;
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static xResult privateErase(MqttOutboxW25QT* flash, uint32_t address)
+{
+	if (privateWriteEnable(flash) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	privateSelect(flash);
+	xResult result = privateCommand(flash, W25Q_COMMAND_SECTOR_ERASE, address, true);
+	privateDeselect(flash);
+
+	if (result != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	return privateWaitReady(flash, W25Q_ERASE_TIMEOUT);
+}
+//==============================================================================
+//initialization:
+
+xResult MqttOutboxW25QInit(MqttOutboxW25QT* flash, MqttOutboxFlashInterfaceT* interface)
+{
+	if (flash && interface && flash->Handle)
+	{
+		privateDeselect(flash);
+
+		privateSelect(flash);
+		privateCommand(flash, W25Q_COMMAND_RELEASE_POWER_DOWN, 0, false);
+		privateDeselect(flash);
+
+		uint8_t id[3] = { 0 };
+
+		privateSelect(flash);
+		privateCommand(flash, W25Q_COMMAND_JEDEC_ID, 0, false);
+		HAL_SPI_Receive(flash->Handle, id, sizeof(id), W25Q_TIMEOUT);
+		privateDeselect(flash);
+
+		flash->JedecId = (id[0] << 16) | (id[1] << 8) | id[2];
+
+		//no answer on the bus: 0x000000 or 0xFFFFFF
+		if (flash->JedecId == 0 || flash->JedecId == 0xFFFFFF)
+		{
+			return xResultError;
+		}
+
+		interface->Read = (void*)privateRead;
+		interface->Write = (void*)privateWrite;
+		interface->Erase = (void*)privateErase;
+		interface->Context = flash;
+
+		return xResultAccept;
+	}
+
+	return xResultError;
+}
+//==============================================================================
@@ -0,0 +1,46 @@
+//==============================================================================
+//header:
+
+#ifndef _MQTT_OUTBOX_W25Q_H_
+#define _MQTT_OUTBOX_W25Q_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "MqttOutbox.h"
+#include "spi.h"
+//==============================================================================
+//defines:
+
+#define W25Q_PAGE_SIZE 256
+#define W25Q_SECTOR_SIZE 4096
+
+#define W25Q_TIMEOUT 100 //ms, SPI transfer
+#define W25Q_ERASE_TIMEOUT 500 //ms, 4KB sector erase: 400ms max
+#define W25Q_PROGRAM_TIMEOUT 5 //ms, page program: 3ms max
+//==============================================================================
+//types:
+
+typedef struct
+{
+	SPI_HandleTypeDef* Handle;
+
+	GPIO_TypeDef* ChipSelectPort;
+	uint16_t ChipSelectPin;
+
+	uint32_t JedecId;
+
+} MqttOutboxW25QT;
+//==============================================================================
+//functions:
+
+xResult MqttOutboxW25QInit(MqttOutboxW25QT* flash, MqttOutboxFlashInterfaceT* interface);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MQTT_OUTBOX_W25Q_H_
@@ -0,0 +1,406 @@
+//==============================================================================
+//includes:
+
+#include "MqttOutbox.h"
+#include <string.h>
+//==============================================================================
+//defines:
+
+#define SECTOR_DATA_OFFSET (sizeof(MqttOutboxSectorHeaderT))
+#define RECORD_SIZE_EMPTY 0xFFFF
+//==============================================================================
+//functions:
+
+static inline uint32_t privateRecordSpace(uint16_t size)
+{
+	uint32_t space = sizeof(MqttOutboxRecordHeaderT) + size;
+
+	return (space + MQTT_OUTBOX_RECORD_ALIGNMENT - 1) & ~(MQTT_OUTBOX_RECORD_ALIGNMENT - 1);
+}
+//------------------------------------------------------------------------------
+static inline uint32_t privateSectorAddress(MqttOutboxT* outbox, uint16_t sector)
+{
+	return outbox->Address + sector * outbox->SectorSize;
+}
+//------------------------------------------------------------------------------
+static xResult privateRead(MqttOutboxT* outbox, uint16_t sector, uint32_t offset, void* data, uint32_t size)
+{
+	return outbox->Flash->Read(outbox->Flash->Context, privateSectorAddress(outbox, sector) + offset, data, size);
+}
+//------------------------------------------------------------------------------
+static xResult privateWrite(MqttOutboxT* outbox, uint16_t sector, uint32_t offset, const void* data, uint32_t size)
+{
+	outbox->Statistic.ProgrammedBytes += size;
+
+	return outbox->Flash->Write(outbox->Flash->Context, privateSectorAddress(outbox, sector) + offset, data, size);
+}
+//------------------------------------------------------------------------------
+static bool privateSectorHeaderRead(MqttOutboxT* outbox, uint16_t sector, MqttOutboxSectorHeaderT* header)
+{
+	if (privateRead(outbox, sector, 0, header, sizeof(*header)) != xResultAccept)
+	{
+		return false;
+	}
+
+	return header->Magic == MQTT_OUTBOX_SECTOR_MAGIC;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief erases the sector and marks it as the newest one. The sectors are used strictly
+ * round-robin, so the erases are spread evenly over the region; EraseCount is kept
+ * in the sector header to check it.
+ */
+static xResult privateSectorOpen(MqttOutboxT* outbox, uint16_t sector)
+{
+	MqttOutboxSectorHeaderT header;
+	uint32_t eraseCount = privateSectorHeaderRead(outbox, sector, &header) ? header.EraseCount : 0;
+
+	if (outbox->Flash->Erase(outbox->Flash->Context, privateSectorAddress(outbox, sector)) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	outbox->Statistic.ErasedSectors++;
+	outbox->HeadSequence++;
+
+	header.Magic = MQTT_OUTBOX_SECTOR_MAGIC;
+	header.Sequence = outbox->HeadSequence;
+	header.EraseCount = eraseCount + 1;
+	header.Reserved = 0xFFFFFFFF;
+
+	outbox->HeadSector = sector;
+	outbox->HeadOffset = SECTOR_DATA_OFFSET;
+
+	return privateWrite(outbox, sector, 0, &header, sizeof(header));
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief reads the record header at the offset.
+ * @return false if there are no more records in the sector
+ */
+static bool privateRecordRead(MqttOutboxT* outbox, uint16_t sector, uint32_t offset, MqttOutboxRecordHeaderT* record)
+{
+	if (offset + sizeof(*record) > outbox->SectorSize
+		|| privateRead(outbox, sector, offset, record, sizeof(*record)) != xResultAccept
+		|| record->Size == RECORD_SIZE_EMPTY)
+	{
+		return false;
+	}
+
+	//a damaged size closes the sector
+	return offset + privateRecordSpace(record->Size) <= outbox->SectorSize;
+}
+//------------------------------------------------------------------------------
+static uint32_t privateSectorCount(MqttOutboxT* outbox, uint16_t sector, uint32_t offset, uint32_t end)
+{
+	MqttOutboxRecordHeaderT record;
+	uint32_t count = 0;
+
+	while (offset < end && privateRecordRead(outbox, sector, offset, &record))
+	{
+		if (record.State == MQTT_OUTBOX_RECORD_STATE_VALID)
+		{
+			count++;
+		}
+
+		offset += privateRecordSpace(record.Size);
+	}
+
+	return count;
+}
+//------------------------------------------------------------------------------
+static uint32_t privateSectorEnd(MqttOutboxT* outbox, uint16_t sector)
+{
+	MqttOutboxRecordHeaderT record;
+	uint32_t offset = SECTOR_DATA_OFFSET;
+
+	while (privateRecordRead(outbox, sector, offset, &record))
+	{
+		offset += privateRecordSpace(record.Size);
+	}
+
+	//the sector is closed if the header that follows is not erased
+	if (offset + sizeof(record) <= outbox->SectorSize && record.Size != RECORD_SIZE_EMPTY)
+	{
+		return outbox->SectorSize;
+	}
+
+	return offset;
+}
+//------------------------------------------------------------------------------
+static inline uint16_t privateSectorNext(MqttOutboxT* outbox, uint16_t sector)
+{
+	return (sector + 1) % outbox->SectorCount;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief moves the tail to the next record waiting for replay.
+ */
+static void privateTailSeek(MqttOutboxT* outbox)
+{
+	MqttOutboxRecordHeaderT record;
+
+	while (outbox->Count)
+	{
+		uint32_t end = outbox->TailSector == outbox->HeadSector ? outbox->HeadOffset : outbox->SectorSize;
+
+		if (outbox->TailOffset >= end || !privateRecordRead(outbox, outbox->TailSector, outbox->TailOffset, &record))
+		{
+			if (outbox->TailSector == outbox->HeadSector)
+			{
+				//the records counter went wrong, there is nothing to replay
+				outbox->Count = 0;
+				break;
+			}
+
+			outbox->TailSector = privateSectorNext(outbox, outbox->TailSector);
+			outbox->TailOffset = SECTOR_DATA_OFFSET;
+			continue;
+		}
+
+		if (record.State == MQTT_OUTBOX_RECORD_STATE_VALID)
+		{
+			break;
+		}
+
+		outbox->TailOffset += privateRecordSpace(record.Size);
+	}
+}
+//------------------------------------------------------------------------------
+static xResult privateHeadAdvance(MqttOutboxT* outbox)
+{
+	uint16_t next = privateSectorNext(outbox, outbox->HeadSector);
+
+	if (outbox->Count && outbox->TailSector == next)
+	{
+		//the ring is full: the oldest sector is overwritten
+		uint32_t dropped = privateSectorCount(outbox, next, outbox->TailOffset, outbox->SectorSize);
+
+		outbox->Statistic.Dropped += dropped;
+		outbox->Count -= dropped;
+
+		outbox->TailSector = privateSectorNext(outbox, next);
+		outbox->TailOffset = SECTOR_DATA_OFFSET;
+	}
+
+	return privateSectorOpen(outbox, next);
+}
+//------------------------------------------------------------------------------
+xResult MqttOutboxAppend(MqttOutboxT* outbox, const void* data, uint16_t size)
+{
+	uint32_t space = privateRecordSpace(size);
+
+	if (!outbox->Flash || size == RECORD_SIZE_EMPTY || space > outbox->SectorSize - SECTOR_DATA_OFFSET)
+	{
+		return xResultError;
+	}
+
+	if (outbox->HeadOffset + space > outbox->SectorSize && privateHeadAdvance(outbox) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	MqttOutboxRecordHeaderT record =
+	{
+		.State = MQTT_OUTBOX_RECORD_STATE_EMPTY,
+		.Reserved = 0xFF,
+		.Size = size,
+		.Crc = outbox->Crc(data, size)
+	};
+
+	uint32_t offset = outbox->HeadOffset;
+	outbox->HeadOffset += space;
+
+	//the state is programmed last: a record torn by a reset stays not valid and is skipped
+	if (privateWrite(outbox, outbox->HeadSector, offset, &record, sizeof(record)) != xResultAccept
+		|| privateWrite(outbox, outbox->HeadSector, offset + sizeof(record), data, size) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	record.State = MQTT_OUTBOX_RECORD_STATE_VALID;
+
+	if (privateWrite(outbox, outbox->HeadSector, offset, &record.State, sizeof(record.State)) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	if (!outbox->Count)
+	{
+		outbox->TailSector = outbox->HeadSector;
+		outbox->TailOffset = offset;
+	}
+
+	outbox->Count++;
+	outbox->Statistic.Appended++;
+	outbox->Statistic.PayloadBytes += size;
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief reads the oldest record without removing it. The records with a wrong CRC are skipped.
+ * @return size of the record, 0 if the outbox is empty, negative xResult on error
+ */
+int MqttOutboxPeek(MqttOutboxT* outbox, void* data, uint16_t size)
+{
+	MqttOutboxRecordHeaderT record;
+
+	while (outbox->Count)
+	{
+		privateTailSeek(outbox);
+
+		if (!outbox->Count || !privateRecordRead(outbox, outbox->TailSector, outbox->TailOffset, &record))
+		{
+			break;
+		}
+
+		if (record.Size > size)
+		{
+			return -xResultError;
+		}
+
+		if (privateRead(outbox, outbox->TailSector, outbox->TailOffset + sizeof(record), data, record.Size) != xResultAccept)
+		{
+			return -xResultError;
+		}
+
+		if (outbox->Crc(data, record.Size) == record.Crc)
+		{
+			return record.Size;
+		}
+
+		outbox->Statistic.Corrupted++;
+
+		uint8_t state = MQTT_OUTBOX_RECORD_STATE_CONSUMED;
+		privateWrite(outbox, outbox->TailSector, outbox->TailOffset, &state, sizeof(state));
+
+		outbox->TailOffset += privateRecordSpace(record.Size);
+		outbox->Count--;
+	}
+
+	return 0;
+}
+//------------------------------------------------------------------------------
+xResult MqttOutboxRemove(MqttOutboxT* outbox)
+{
+	MqttOutboxRecordHeaderT record;
+
+	privateTailSeek(outbox);
+
+	if (!outbox->Count || !privateRecordRead(outbox, outbox->TailSector, outbox->TailOffset, &record))
+	{
+		return xResultError;
+	}
+
+	uint8_t state = MQTT_OUTBOX_RECORD_STATE_CONSUMED;
+
+	if (privateWrite(outbox, outbox->TailSector, outbox->TailOffset, &state, sizeof(state)) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	outbox->TailOffset += privateRecordSpace(record.Size);
+	outbox->Count--;
+	outbox->Statistic.Replayed++;
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+xResult MqttOutboxFormat(MqttOutboxT* outbox)
+{
+	outbox->Count = 0;
+	outbox->HeadSequence = 0;
+
+	xResult result = privateSectorOpen(outbox, 0);
+
+	outbox->TailSector = outbox->HeadSector;
+	outbox->TailOffset = outbox->HeadOffset;
+
+	return result;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief restores the ring from the flash: the head is the sector with the highest sequence,
+ * the tail is the oldest sector of the unbroken sequence chain that ends at the head.
+ */
+static xResult privateMount(MqttOutboxT* outbox)
+{
+	MqttOutboxSectorHeaderT header;
+	bool isFound = false;
+
+	for (uint16_t sector = 0; sector < outbox->SectorCount; sector++)
+	{
+		if (privateSectorHeaderRead(outbox, sector, &header)
+			&& (!isFound || (int32_t)(header.Sequence - outbox->HeadSequence) > 0))
+		{
+			isFound = true;
+			outbox->HeadSector = sector;
+			outbox->HeadSequence = header.Sequence;
+		}
+	}
+
+	if (!isFound)
+	{
+		return MqttOutboxFormat(outbox);
+	}
+
+	outbox->HeadOffset = privateSectorEnd(outbox, outbox->HeadSector);
+
+	uint16_t tail = outbox->HeadSector;
+	uint32_t sequence = outbox->HeadSequence;
+
+	for (uint16_t i = 1; i < outbox->SectorCount; i++)
+	{
+		uint16_t previous = (tail + outbox->SectorCount - 1) % outbox->SectorCount;
+
+		if (!privateSectorHeaderRead(outbox, previous, &header) || header.Sequence != sequence - 1)
+		{
+			break;
+		}
+
+		tail = previous;
+		sequence--;
+	}
+
+	outbox->Count = 0;
+	outbox->TailSector = tail;
+	outbox->TailOffset = SECTOR_DATA_OFFSET;
+
+	for (uint16_t sector = tail; ; sector = privateSectorNext(outbox, sector))
+	{
+		uint32_t end = sector == outbox->HeadSector ? outbox->HeadOffset : outbox->SectorSize;
+
+		outbox->Count += privateSectorCount(outbox, sector, SECTOR_DATA_OFFSET, end);
+
+		if (sector == outbox->HeadSector)
+		{
+			break;
+		}
+	}
+
+	privateTailSeek(outbox);
+
+	return xResultAccept;
+}
+//==============================================================================
+//initialization:
+
+xResult MqttOutboxInit(MqttOutboxT* outbox, MqttOutboxInitT* init)
+{
+	if (outbox && init && init->Flash && init->Crc && init->SectorCount > 1)
+	{
+		memset(outbox, 0, sizeof(MqttOutboxT));
+
+		outbox->Flash = init->Flash;
+		outbox->Crc = init->Crc;
+		outbox->Address = init->Address;
+		outbox->SectorSize = init->SectorSize;
+		outbox->SectorCount = init->SectorCount;
+
+		return privateMount(outbox);
+	}
+
+	return xResultError;
+}
+//==============================================================================
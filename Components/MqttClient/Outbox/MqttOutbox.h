@@ -0,0 +1,125 @@
+//==============================================================================
+//header:
+
+#ifndef _MQTT_OUTBOX_H_
+#define _MQTT_OUTBOX_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+//==============================================================================
+//defines:
+
+#define MQTT_OUTBOX_SECTOR_MAGIC 0x584F424DU //"MBOX"
+#define MQTT_OUTBOX_RECORD_ALIGNMENT 8
+
+#define MQTT_OUTBOX_RECORD_STATE_EMPTY 0xFF
+#define MQTT_OUTBOX_RECORD_STATE_VALID 0x7F //set after the record was programmed
+#define MQTT_OUTBOX_RECORD_STATE_CONSUMED 0x00 //set after the record was replayed
+//==============================================================================
+//types:
+
+/// @brief CRC-32 of the payloads, CrcVariant32 of the Crc component
+typedef uint32_t (*MqttOutboxCrcT)(const void* data, uint32_t size);
+//------------------------------------------------------------------------------
+/// @brief NOR flash access: Write can only clear bits, Erase sets a sector to 0xFF.
+typedef struct
+{
+	xResult (*Read)(void* context, uint32_t address, void* data, uint32_t size);
+	xResult (*Write)(void* context, uint32_t address, const void* data, uint32_t size);
+	xResult (*Erase)(void* context, uint32_t address);
+
+	void* Context;
+
+} MqttOutboxFlashInterfaceT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Magic;
+	uint32_t Sequence; //increased on each use of a sector, the oldest sector has the lowest one
+	uint32_t EraseCount;
+	uint32_t Reserved;
+
+} MqttOutboxSectorHeaderT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint8_t State;
+	uint8_t Reserved;
+	uint16_t Size;
+	uint32_t Crc; //CRC32 of the payload
+
+} MqttOutboxRecordHeaderT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Appended;
+	uint32_t Replayed;
+	uint32_t Dropped; //records lost on overwriting of the oldest sector
+	uint32_t Corrupted;
+
+	uint32_t PayloadBytes; //bytes requested to be stored
+	uint32_t ProgrammedBytes; //bytes programmed to the flash, headers and state updates included
+	uint32_t ErasedSectors;
+
+	uint32_t ReplayStartTime;
+	uint32_t ReplayTime; //ms, time of the last replay: Replayed / ReplayTime - replay rate
+
+} MqttOutboxStatisticT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	MqttOutboxFlashInterfaceT* Flash;
+	MqttOutboxCrcT Crc;
+
+	uint32_t Address; //start of the region
+	uint32_t SectorSize;
+	uint16_t SectorCount;
+
+	uint16_t HeadSector;
+	uint32_t HeadOffset;
+	uint32_t HeadSequence;
+
+	uint16_t TailSector;
+	uint32_t TailOffset;
+
+	uint32_t Count; //records waiting for replay
+
+	MqttOutboxStatisticT Statistic;
+
+} MqttOutboxT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	MqttOutboxFlashInterfaceT* Flash;
+	MqttOutboxCrcT Crc;
+
+	uint32_t Address;
+	uint32_t SectorSize;
+	uint16_t SectorCount;
+
+} MqttOutboxInitT;
+//==============================================================================
+//functions:
+
+xResult MqttOutboxInit(MqttOutboxT* outbox, MqttOutboxInitT* init);
+
+xResult MqttOutboxAppend(MqttOutboxT* outbox, const void* data, uint16_t size);
+int MqttOutboxPeek(MqttOutboxT* outbox, void* data, uint16_t size);
+xResult MqttOutboxRemove(MqttOutboxT* outbox);
+
+xResult MqttOutboxFormat(MqttOutboxT* outbox);
+//==============================================================================
+//macros:
+
+#define MqttOutboxIsEmpty(outbox) ((outbox)->Count == 0)
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MQTT_OUTBOX_H_
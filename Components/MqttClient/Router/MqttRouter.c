@@ -0,0 +1,309 @@
+//==============================================================================
+//includes:
+
+#include "MqttRouter.h"
+#include "Components.h"
+#include "TerminalCommands/TerminalCommands.h"
+#include <string.h>
+//==============================================================================
+//defines:
+
+#define MQTT_ROUTER_ROOT 0
+#define MQTT_ROUTER_NONE 0
+//==============================================================================
+//functions:
+
+static uint16_t privateChildFind(MqttRouterT* router, uint16_t node, char symbol)
+{
+	for (uint16_t child = router->Nodes[node].Child; child != MQTT_ROUTER_NONE; child = router->Nodes[child].Sibling)
+	{
+		router->Statistic.VisitedNodes++;
+
+		if (router->Nodes[child].Symbol == symbol)
+		{
+			return child;
+		}
+	}
+
+	return MQTT_ROUTER_NONE;
+}
+//------------------------------------------------------------------------------
+static uint16_t privateChildAdd(MqttRouterT* router, uint16_t node, char symbol)
+{
+	if (router->NodesCount >= router->NodesSize)
+	{
+		return MQTT_ROUTER_NONE;
+	}
+
+	uint16_t child = router->NodesCount++;
+
+	router->Nodes[child].Symbol = symbol;
+	router->Nodes[child].Route = 0;
+	router->Nodes[child].Child = MQTT_ROUTER_NONE;
+	router->Nodes[child].Sibling = router->Nodes[node].Child;
+
+	router->Nodes[node].Child = child;
+
+	return child;
+}
+//------------------------------------------------------------------------------
+static bool privateFilterIsValid(const char* filter)
+{
+	uint16_t length = strlen(filter);
+
+	if (!length)
+	{
+		return false;
+	}
+
+	for (uint16_t i = 0; i < length; i++)
+	{
+		bool isLevelStart = i == 0 || filter[i - 1] == '/';
+		bool isLevelEnd = i + 1 == length || filter[i + 1] == '/';
+
+		//the wildcards take the whole level, "#" is the last level only
+		if ((filter[i] == '+' || filter[i] == '#') && !(isLevelStart && isLevelEnd))
+		{
+			return false;
+		}
+
+		if (filter[i] == '#' && i + 1 != length)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+//------------------------------------------------------------------------------
+static void privateMatched(MqttRouterT* router, uint16_t node, uint8_t* matches,
+							const char* topic, uint16_t topicLength, uint8_t* payload, uint32_t size)
+{
+	uint8_t index = router->Nodes[node].Route;
+
+	if (!index)
+	{
+		return;
+	}
+
+	MqttRouteT* route = &router->Routes[index - 1];
+
+	route->Matches++;
+	(*matches)++;
+
+	if (route->Handler)
+	{
+		route->Handler(route->Context, topic, topicLength, payload, size);
+	}
+	else if (route->Port)
+	{
+		RxDataPacketT rxPacket;
+		rxPacket.Data = payload;
+		rxPacket.FullSize = size;
+		rxPacket.Size = size;
+
+		TerminalCommandsReceive(route->Port, &rxPacket);
+	}
+}
+//------------------------------------------------------------------------------
+typedef struct
+{
+	const char* Topic;
+	uint16_t TopicLength;
+
+	uint8_t* Payload;
+	uint32_t Size;
+
+	uint8_t Matches;
+
+} MqttRouterDispatchT;
+
+static void privateMatchLevel(MqttRouterT* router, MqttRouterDispatchT* dispatch, uint16_t node, uint16_t position);
+//------------------------------------------------------------------------------
+/**
+ * @brief continues the match after a level: position is at '/' or at the end of the topic.
+ */
+static void privateMatchNext(MqttRouterT* router, MqttRouterDispatchT* dispatch, uint16_t node, uint16_t position)
+{
+	uint16_t separator = privateChildFind(router, node, '/');
+
+	if (position == dispatch->TopicLength)
+	{
+		privateMatched(router, node, &dispatch->Matches, dispatch->Topic, dispatch->TopicLength, dispatch->Payload, dispatch->Size);
+
+		//"a/#" matches "a" too
+		uint16_t multiLevel = separator ? privateChildFind(router, separator, '#') : MQTT_ROUTER_NONE;
+
+		if (multiLevel)
+		{
+			privateMatched(router, multiLevel, &dispatch->Matches, dispatch->Topic, dispatch->TopicLength, dispatch->Payload, dispatch->Size);
+		}
+
+		return;
+	}
+
+	if (separator)
+	{
+		privateMatchLevel(router, dispatch, separator, position + 1);
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief matches one level of the topic starting at the position. Each level is walked
+ * at most three times (exact, "+", "#"), so the cost depends on the topic length and
+ * the wildcards on its path, not on the number of the filters.
+ */
+static void privateMatchLevel(MqttRouterT* router, MqttRouterDispatchT* dispatch, uint16_t node, uint16_t position)
+{
+	const char* topic = dispatch->Topic;
+	uint16_t length = dispatch->TopicLength;
+
+	//the wildcards in the first level don't match the system topics ("$SYS/...")
+	if (position != 0 || length == 0 || topic[0] != '$')
+	{
+		uint16_t multiLevel = privateChildFind(router, node, '#');
+
+		if (multiLevel)
+		{
+			privateMatched(router, multiLevel, &dispatch->Matches, topic, length, dispatch->Payload, dispatch->Size);
+		}
+
+		uint16_t singleLevel = privateChildFind(router, node, '+');
+
+		if (singleLevel)
+		{
+			uint16_t end = position;
+
+			while (end < length && topic[end] != '/')
+			{
+				end++;
+			}
+
+			privateMatchNext(router, dispatch, singleLevel, end);
+		}
+	}
+
+	while (position < length && topic[position] != '/')
+	{
+		node = privateChildFind(router, node, topic[position]);
+
+		if (!node)
+		{
+			return;
+		}
+
+		position++;
+	}
+
+	privateMatchNext(router, dispatch, node, position);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief delivers the payload to all the routes whose filters match the topic.
+ * @return number of the matched routes
+ */
+uint8_t MqttRouterDispatch(MqttRouterT* router, const char* topic, uint16_t topicLength, uint8_t* payload, uint32_t size)
+{
+	MqttRouterDispatchT dispatch =
+	{
+		.Topic = topic,
+		.TopicLength = topicLength,
+		.Payload = payload,
+		.Size = size,
+		.Matches = 0
+	};
+
+	router->Statistic.VisitedNodes = 0;
+	router->Statistic.Dispatched++;
+
+	privateMatchLevel(router, &dispatch, MQTT_ROUTER_ROOT, 0);
+
+	if (!dispatch.Matches)
+	{
+		router->Statistic.Unmatched++;
+	}
+
+	return dispatch.Matches;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief compiles the filter into the trie. The filter string must stay valid,
+ * it is used for the subscriptions.
+ */
+xResult MqttRouterAdd(MqttRouterT* router, const char* filter, MqttRouteHandlerT handler, void* context, xPortT* port)
+{
+	if (!filter || !privateFilterIsValid(filter) || router->RoutesCount >= router->RoutesSize)
+	{
+		return xResultError;
+	}
+
+	uint16_t node = MQTT_ROUTER_ROOT;
+	uint16_t nodesCount = router->NodesCount;
+
+	for (const char* symbol = filter; *symbol; symbol++)
+	{
+		uint16_t child = privateChildFind(router, node, *symbol);
+
+		if (!child)
+		{
+			child = privateChildAdd(router, node, *symbol);
+		}
+
+		if (!child)
+		{
+			//out of nodes: the added branch is dropped
+			router->NodesCount = nodesCount;
+
+			for (uint16_t i = 0; i < nodesCount; i++)
+			{
+				if (router->Nodes[i].Child >= nodesCount)
+				{
+					router->Nodes[i].Child = router->Nodes[router->Nodes[i].Child].Sibling;
+				}
+			}
+
+			return xResultError;
+		}
+
+		node = child;
+	}
+
+	if (router->Nodes[node].Route)
+	{
+		return xResultError;
+	}
+
+	MqttRouteT* route = &router->Routes[router->RoutesCount++];
+	route->Filter = filter;
+	route->Handler = handler;
+	route->Context = context;
+	route->Port = port;
+	route->Matches = 0;
+
+	router->Nodes[node].Route = router->RoutesCount;
+
+	return xResultAccept;
+}
+//==============================================================================
+//initialization:
+
+xResult MqttRouterInit(MqttRouterT* router, MqttRouterInitT* init)
+{
+	if (router && init && init->Nodes && init->NodesSize && init->Routes)
+	{
+		memset(router, 0, sizeof(MqttRouterT));
+
+		router->Nodes = init->Nodes;
+		router->NodesSize = init->NodesSize;
+		router->Routes = init->Routes;
+		router->RoutesSize = init->RoutesSize;
+
+		memset(&router->Nodes[MQTT_ROUTER_ROOT], 0, sizeof(MqttRouterNodeT));
+		router->NodesCount = 1;
+
+		return xResultAccept;
+	}
+
+	return xResultError;
+}
+//==============================================================================
@@ -0,0 +1,88 @@
+//==============================================================================
+//header:
+
+#ifndef _MQTT_ROUTER_H_
+#define _MQTT_ROUTER_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+#include "Abstractions/xPort/xPort.h"
+//==============================================================================
+//types:
+
+typedef void (*MqttRouteHandlerT)(void* context, const char* topic, uint16_t topicLength, uint8_t* payload, uint32_t size);
+//------------------------------------------------------------------------------
+typedef struct
+{
+	const char* Filter; //"+" and "#" wildcards
+
+	/// @brief the payload is given to the handler, or to the terminal of the port if Handler is NULL
+	MqttRouteHandlerT Handler;
+	void* Context;
+	xPortT* Port;
+
+	uint32_t Matches;
+
+} MqttRouteT;
+//------------------------------------------------------------------------------
+/// @brief node of the filters trie: one character of a filter,
+/// the children of a node are linked by Sibling. Index 0 is the root and means "none" for the links
+typedef struct
+{
+	char Symbol;
+	uint8_t Route; //index + 1 of the route that ends on the node, 0 - none
+
+	uint16_t Child;
+	uint16_t Sibling;
+
+} MqttRouterNodeT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Dispatched;
+	uint32_t Unmatched;
+	uint32_t VisitedNodes; //of the last dispatch: grows with the topic length, not with the routes count
+
+} MqttRouterStatisticT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	MqttRouterNodeT* Nodes;
+	uint16_t NodesCount;
+	uint16_t NodesSize;
+
+	MqttRouteT* Routes;
+	uint8_t RoutesCount;
+	uint8_t RoutesSize;
+
+	MqttRouterStatisticT Statistic;
+
+} MqttRouterT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	MqttRouterNodeT* Nodes;
+	uint16_t NodesSize;
+
+	MqttRouteT* Routes;
+	uint8_t RoutesSize;
+
+} MqttRouterInitT;
+//==============================================================================
+//functions:
+
+xResult MqttRouterInit(MqttRouterT* router, MqttRouterInitT* init);
+
+xResult MqttRouterAdd(MqttRouterT* router, const char* filter, MqttRouteHandlerT handler, void* context, xPortT* port);
+uint8_t MqttRouterDispatch(MqttRouterT* router, const char* topic, uint16_t topicLength, uint8_t* payload, uint32_t size);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MQTT_ROUTER_H_
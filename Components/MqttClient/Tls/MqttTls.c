@@ -0,0 +1,338 @@
+//==============================================================================
+//includes:
+
+#include "MqttClient/MqttClient-ComponentConfig.h"
+
+#if MQTT_PORT_TLS_ENABLE == 1
+#include "MqttTls.h"
+#include "Components.h"
+#include "rng.h"
+#include <string.h>
+//==============================================================================
+//defines:
+
+#define MQTT_TLS_MAX_CONNECTIONS 1
+//==============================================================================
+//variables:
+
+static uint32_t (*privateGetTime)();
+//==============================================================================
+//functions:
+
+int MqttTlsGenerateSeed(unsigned char* output, unsigned int size)
+{
+	while (size)
+	{
+		uint32_t value;
+
+		if (HAL_RNG_GenerateRandomNumber(&hrng, &value) != HAL_OK)
+		{
+			return -1;
+		}
+
+		uint32_t part = size < sizeof(value) ? size : sizeof(value);
+
+		memcpy(output, &value, part);
+
+		output += part;
+		size -= part;
+	}
+
+	return 0;
+}
+//------------------------------------------------------------------------------
+/// @brief XTIME of the settings: the validity dates of the certificates are checked against it
+time_t MqttTlsTime(time_t* timer)
+{
+	time_t time = privateGetTime ? privateGetTime() : 0;
+
+	if (timer)
+	{
+		*timer = time;
+	}
+
+	return time;
+}
+//------------------------------------------------------------------------------
+static int privateReceive(WOLFSSL* ssl, char* data, int size, void* context)
+{
+	MqttTlsT* tls = context;
+
+	BaseType_t result = FreeRTOS_recv(tls->Socket, data, size, 0);
+
+	if (result > 0)
+	{
+		return result;
+	}
+
+	//FreeRTOS_recv returns 0 on the receive timeout
+	if (result == 0)
+	{
+		return WOLFSSL_CBIO_ERR_WANT_READ;
+	}
+
+	return result == -pdFREERTOS_ERRNO_ENOTCONN ? WOLFSSL_CBIO_ERR_CONN_CLOSE : WOLFSSL_CBIO_ERR_GENERAL;
+}
+//------------------------------------------------------------------------------
+static int privateSend(WOLFSSL* ssl, char* data, int size, void* context)
+{
+	MqttTlsT* tls = context;
+
+	BaseType_t result = FreeRTOS_send(tls->Socket, data, size, 0);
+
+	if (result > 0)
+	{
+		return result;
+	}
+
+	if (result == 0)
+	{
+		return WOLFSSL_CBIO_ERR_WANT_WRITE;
+	}
+
+	return result == -pdFREERTOS_ERRNO_ENOTCONN ? WOLFSSL_CBIO_ERR_CONN_CLOSE : WOLFSSL_CBIO_ERR_GENERAL;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief makes the handshake over the connected socket. If the session of the previous
+ * connection is kept, it is offered to the broker (session ticket or session id)
+ * and the handshake is shortened when the broker accepts it.
+ */
+xResult MqttTlsConnect(MqttTlsT* tls, xSocket_t socket, uint32_t timeout)
+{
+	//an expired certificate can't be told from a valid one before the time is synchronized
+	if (!tls->Context || !privateGetTime())
+	{
+		return xResultError;
+	}
+
+	MqttTlsClose(tls);
+
+	tls->Session = wolfSSL_new(tls->Context);
+
+	if (!tls->Session)
+	{
+		return xResultError;
+	}
+
+	tls->Socket = socket;
+
+	wolfSSL_SetIOReadCtx(tls->Session, tls);
+	wolfSSL_SetIOWriteCtx(tls->Session, tls);
+
+	wolfSSL_UseSessionTicket(tls->Session);
+
+	//SNI carries DNS names only (RFC 6066), the certificate is checked against the name or the address
+	if (!FreeRTOS_inet_addr(tls->ServerName))
+	{
+		wolfSSL_UseSNI(tls->Session, WOLFSSL_SNI_HOST_NAME, tls->ServerName, strlen(tls->ServerName));
+	}
+
+	if (wolfSSL_check_domain_name(tls->Session, tls->ServerName) != WOLFSSL_SUCCESS)
+	{
+		MqttTlsClose(tls);
+
+		return xResultError;
+	}
+
+	if (tls->Resumption)
+	{
+		wolfSSL_set_session(tls->Session, tls->Resumption);
+	}
+
+	uint32_t timeStamp = xSystemGetTime();
+	int result;
+
+	do
+	{
+		result = wolfSSL_connect(tls->Session);
+
+		if (result == WOLFSSL_SUCCESS)
+		{
+			break;
+		}
+
+		tls->Statistic.LastError = wolfSSL_get_error(tls->Session, result);
+	}
+	while ((tls->Statistic.LastError == WOLFSSL_ERROR_WANT_READ || tls->Statistic.LastError == WOLFSSL_ERROR_WANT_WRITE)
+			&& xSystemGetTime() - timeStamp < timeout);
+
+	if (result != WOLFSSL_SUCCESS)
+	{
+		MqttTlsClose(tls);
+
+		return xResultError;
+	}
+
+	tls->Statistic.HandshakeTime = xSystemGetTime() - timeStamp;
+	tls->Statistic.Handshakes++;
+
+	if (wolfSSL_session_reused(tls->Session))
+	{
+		tls->Statistic.ResumedHandshakes++;
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+void MqttTlsClose(MqttTlsT* tls)
+{
+	if (!tls->Session)
+	{
+		return;
+	}
+
+	if (wolfSSL_is_init_finished(tls->Session))
+	{
+		WOLFSSL_MEM_CONN_STATS stats;
+
+		if (wolfSSL_is_static_memory(tls->Session, &stats) == 1 && stats.peakMem > tls->Statistic.PeakMemory)
+		{
+			tls->Statistic.PeakMemory = stats.peakMem;
+		}
+
+		//the session (with the ticket) outlives the connection and is offered on the reconnect
+		WOLFSSL_SESSION* session = wolfSSL_get1_session(tls->Session);
+
+		if (session)
+		{
+			if (tls->Resumption)
+			{
+				wolfSSL_SESSION_free(tls->Resumption);
+			}
+
+			tls->Resumption = session;
+		}
+
+		wolfSSL_shutdown(tls->Session);
+	}
+
+	wolfSSL_free(tls->Session);
+
+	tls->Session = NULL;
+	tls->Socket = NULL;
+}
+//------------------------------------------------------------------------------
+/**
+ * @return sent bytes, 0 if the socket is busy, -1 if the connection is lost
+ */
+int32_t MqttTlsSend(MqttTlsT* tls, const void* data, uint32_t size)
+{
+	if (!tls->Session)
+	{
+		return -1;
+	}
+
+	int result = wolfSSL_write(tls->Session, data, size);
+
+	if (result > 0)
+	{
+		tls->Statistic.BytesSent += result;
+
+		return result;
+	}
+
+	tls->Statistic.LastError = wolfSSL_get_error(tls->Session, result);
+
+	//the same data must be given again on the next call
+	if (tls->Statistic.LastError == WOLFSSL_ERROR_WANT_WRITE || tls->Statistic.LastError == WOLFSSL_ERROR_WANT_READ)
+	{
+		return 0;
+	}
+
+	return -1;
+}
+//------------------------------------------------------------------------------
+/**
+ * @return received bytes, 0 if there is no data, -1 if the connection is lost
+ */
+int32_t MqttTlsReceive(MqttTlsT* tls, void* data, uint32_t size)
+{
+	if (!tls->Session)
+	{
+		return -1;
+	}
+
+	int result = wolfSSL_read(tls->Session, data, size);
+
+	if (result > 0)
+	{
+		tls->Statistic.BytesReceived += result;
+
+		return result;
+	}
+
+	tls->Statistic.LastError = wolfSSL_get_error(tls->Session, result);
+
+	if (tls->Statistic.LastError == WOLFSSL_ERROR_WANT_READ || tls->Statistic.LastError == WOLFSSL_ERROR_WANT_WRITE)
+	{
+		return 0;
+	}
+
+	return -1;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief decrypted bytes kept by wolfSSL: they don't raise a socket event.
+ */
+uint32_t MqttTlsPending(MqttTlsT* tls)
+{
+	return tls->Session ? wolfSSL_pending(tls->Session) : 0;
+}
+//==============================================================================
+//initialization:
+
+xResult MqttTlsInit(MqttTlsT* tls, MqttTlsInitT* init)
+{
+	if (tls && init && init->Memory && init->CaCertificate && init->ServerName && init->GetTime)
+	{
+		memset(tls, 0, sizeof(MqttTlsT));
+
+		tls->ServerName = init->ServerName;
+		privateGetTime = init->GetTime;
+
+		if (wolfSSL_Init() != WOLFSSL_SUCCESS)
+		{
+			return xResultError;
+		}
+
+		//the context and all the connections are allocated from init->Memory, the general heap is not used
+		if (wolfSSL_CTX_load_static_memory(&tls->Context,
+											wolfTLSv1_2_client_method_ex,
+											init->Memory,
+											init->MemorySize,
+											WOLFMEM_GENERAL | WOLFMEM_TRACK_STATS,
+											MQTT_TLS_MAX_CONNECTIONS) != WOLFSSL_SUCCESS)
+		{
+			return xResultError;
+		}
+
+		//the init runs before SNTP: the dates of the CA are not checked on the load, the ones of the broker on the handshake
+		if (wolfSSL_CTX_load_verify_buffer_ex(tls->Context,
+												(const unsigned char*)init->CaCertificate,
+												strlen(init->CaCertificate),
+												WOLFSSL_FILETYPE_PEM,
+												0,
+												WOLFSSL_LOAD_FLAG_DATE_ERR_OKAY) != WOLFSSL_SUCCESS)
+		{
+			return xResultError;
+		}
+
+		wolfSSL_CTX_set_verify(tls->Context, WOLFSSL_VERIFY_PEER, NULL);
+
+		//a list without a single known suite would fall back to the defaults of wolfSSL
+		if (init->CipherList && wolfSSL_CTX_set_cipher_list(tls->Context, init->CipherList) != WOLFSSL_SUCCESS)
+		{
+			return xResultError;
+		}
+
+		wolfSSL_CTX_SetIORecv(tls->Context, privateReceive);
+		wolfSSL_CTX_SetIOSend(tls->Context, privateSend);
+
+		return xResultAccept;
+	}
+
+	return xResultError;
+}
+//==============================================================================
+#endif //MQTT_PORT_TLS_ENABLE
@@ -0,0 +1,80 @@
+//==============================================================================
+//header:
+
+#ifndef _MQTT_TLS_H_
+#define _MQTT_TLS_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+#include "wolfssl/wolfcrypt/settings.h"
+#include "wolfssl/ssl.h"
+//==============================================================================
+//types:
+
+typedef struct
+{
+	uint32_t Handshakes;
+	uint32_t ResumedHandshakes;
+	uint32_t HandshakeTime; //ms, last handshake
+
+	uint32_t PeakMemory; //bytes of the static pool used by the connection
+	uint32_t BytesSent;
+	uint32_t BytesReceived;
+
+	int LastError;
+
+} MqttTlsStatisticT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	WOLFSSL_CTX* Context;
+	WOLFSSL* Session;
+	WOLFSSL_SESSION* Resumption; //kept from the last connection to skip the full handshake
+
+	xSocket_t Socket;
+	const char* ServerName;
+
+	MqttTlsStatisticT Statistic;
+
+} MqttTlsT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	/// @brief static pool for all the wolfSSL allocations
+	uint8_t* Memory;
+	uint32_t MemorySize;
+
+	/// @brief PEM, the broker certificate is verified against it
+	const char* CaCertificate;
+	const char* ServerName; //DNS name or IP address the broker certificate is issued to, a DNS name is also sent as SNI
+
+	/// @brief seconds of UTC for the validity dates of the certificates, 0 - not known yet: the handshake waits for it
+	uint32_t (*GetTime)();
+
+	const char* CipherList; //NULL - wolfSSL defaults
+
+} MqttTlsInitT;
+//==============================================================================
+//functions:
+
+xResult MqttTlsInit(MqttTlsT* tls, MqttTlsInitT* init);
+
+xResult MqttTlsConnect(MqttTlsT* tls, xSocket_t socket, uint32_t timeout);
+void MqttTlsClose(MqttTlsT* tls);
+
+int32_t MqttTlsSend(MqttTlsT* tls, const void* data, uint32_t size);
+int32_t MqttTlsReceive(MqttTlsT* tls, void* data, uint32_t size);
+uint32_t MqttTlsPending(MqttTlsT* tls);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MQTT_TLS_H_
@@ -0,0 +1,100 @@
+//==============================================================================
+//includes:
+
+#include "MqttClient/MqttClient-ComponentConfig.h"
+
+#if MQTT_PORT_TLS_ENABLE == 1
+#include "MqttTlsBench.h"
+#include "wolfssl/wolfcrypt/settings.h"
+#include "wolfssl/wolfcrypt/aes.h"
+#include "wolfssl/wolfcrypt/chacha20_poly1305.h"
+//==============================================================================
+//defines:
+
+//TLS 1.2 record: the explicit or implicit nonce, the sequence number, type, version and length as the additional data
+#define TLS_NONCE_SIZE 12
+#define TLS_ADDITIONAL_DATA_SIZE 13
+#define TLS_TAG_SIZE 16
+//==============================================================================
+//variables:
+
+static const uint8_t privateKey[CHACHA20_POLY1305_AEAD_KEYSIZE] = { 0x4d, 0x51, 0x54, 0x54 };
+static const uint8_t privateNonce[TLS_NONCE_SIZE] = { 0x01 };
+static const uint8_t privateAdditionalData[TLS_ADDITIONAL_DATA_SIZE] = { 0, 0, 0, 0, 0, 0, 0, 1, 0x17, 0x03, 0x03 };
+
+static uint8_t privateTag[TLS_TAG_SIZE]; //of the last sealed record
+static Aes privateAes; //the key schedule and the GCM table are not on the stack of the terminal
+
+const char* const MqttTlsBenchCipherNames[MqttTlsBenchCiphersCount] =
+{
+	[MqttTlsBenchAes128Gcm] = "aes-128-gcm",
+	[MqttTlsBenchChaCha20Poly1305] = "chacha20-poly1305"
+};
+//==============================================================================
+//functions:
+
+/**
+ * @brief encrypts the data in place count times as the records of the cipher, the time of it
+ * is the cost of the cipher suite per byte once the handshake is done
+ */
+xResult MqttTlsBenchSeal(MqttTlsBenchCipherT cipher, uint8_t* data, uint32_t size, uint32_t count)
+{
+	if (cipher == MqttTlsBenchAes128Gcm)
+	{
+		if (wc_AesInit(&privateAes, NULL, INVALID_DEVID) || wc_AesGcmSetKey(&privateAes, privateKey, AES_128_KEY_SIZE))
+		{
+			return xResultError;
+		}
+
+		while (count--)
+		{
+			if (wc_AesGcmEncrypt(&privateAes, data, data, size,
+									privateNonce, sizeof(privateNonce),
+									privateTag, sizeof(privateTag),
+									privateAdditionalData, sizeof(privateAdditionalData)))
+			{
+				return xResultError;
+			}
+		}
+
+		wc_AesFree(&privateAes);
+
+		return xResultAccept;
+	}
+
+	while (count--)
+	{
+		if (wc_ChaCha20Poly1305_Encrypt(privateKey, privateNonce,
+										privateAdditionalData, sizeof(privateAdditionalData),
+										data, size, data, privateTag))
+		{
+			return xResultError;
+		}
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/// @brief decrypts the data of the last sealed record in place, xResultError - the tag doesn't match
+xResult MqttTlsBenchOpen(MqttTlsBenchCipherT cipher, uint8_t* data, uint32_t size)
+{
+	if (cipher == MqttTlsBenchAes128Gcm)
+	{
+		int result = wc_AesInit(&privateAes, NULL, INVALID_DEVID)
+						|| wc_AesGcmSetKey(&privateAes, privateKey, AES_128_KEY_SIZE)
+						|| wc_AesGcmDecrypt(&privateAes, data, data, size,
+											privateNonce, sizeof(privateNonce),
+											privateTag, sizeof(privateTag),
+											privateAdditionalData, sizeof(privateAdditionalData));
+
+		wc_AesFree(&privateAes);
+
+		return result ? xResultError : xResultAccept;
+	}
+
+	return wc_ChaCha20Poly1305_Decrypt(privateKey, privateNonce,
+										privateAdditionalData, sizeof(privateAdditionalData),
+										data, size, privateTag, data) ? xResultError : xResultAccept;
+}
+//==============================================================================
+#endif //MQTT_PORT_TLS_ENABLE
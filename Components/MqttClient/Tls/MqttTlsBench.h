@@ -0,0 +1,40 @@
+//==============================================================================
+//header:
+
+#ifndef _MQTT_TLS_BENCH_H_
+#define _MQTT_TLS_BENCH_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+//==============================================================================
+//types:
+
+/// @brief the record ciphers of MQTT_TLS_CIPHER_LIST
+typedef enum
+{
+	MqttTlsBenchAes128Gcm,
+	MqttTlsBenchChaCha20Poly1305,
+
+	MqttTlsBenchCiphersCount
+
+} MqttTlsBenchCipherT;
+//==============================================================================
+//functions:
+
+xResult MqttTlsBenchSeal(MqttTlsBenchCipherT cipher, uint8_t* data, uint32_t size, uint32_t count);
+xResult MqttTlsBenchOpen(MqttTlsBenchCipherT cipher, uint8_t* data, uint32_t size);
+//==============================================================================
+//export:
+
+extern const char* const MqttTlsBenchCipherNames[MqttTlsBenchCiphersCount];
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MQTT_TLS_BENCH_H_
@@ -225,11 +225,11 @@ static xResult PrivateRequestListener(void* object, xNetAdapterRequestSelector s
 				return xResultError;
 			}
 
-			uint32_t timeout = SOCKET_RX_BLOCK_TIME;
-			FreeRTOS_setsockopt(netSocket->Handle, 0, FREERTOS_SO_RCVTIMEO, &timeout, sizeof(timeout));
+			TickType_t timeout = pdMS_TO_TICKS(SOCKET_RX_BLOCK_TIME);
+			FreeRTOS_setsockopt(socket, 0, FREERTOS_SO_RCVTIMEO, &timeout, sizeof(timeout));
 
-			timeout = SOCKET_TX_BLOCK_TIME;
-			FreeRTOS_setsockopt(netSocket->Handle, 0, FREERTOS_SO_SNDTIMEO, &timeout, sizeof(timeout));
+			timeout = pdMS_TO_TICKS(SOCKET_TX_BLOCK_TIME);
+			FreeRTOS_setsockopt(socket, 0, FREERTOS_SO_SNDTIMEO, &timeout, sizeof(timeout));
 
 			netSocket->Handle = socket;
 			netSocket->Net = object;
@@ -348,42 +348,38 @@ static xResult PrivateRequestListener(void* object, xNetAdapterRequestSelector s
 
 		case xNetAdapterGetHostByName:
 		{
-			/*
 			xNetRequesGetHostByNameArgT* request = arg;
-			ip_addr_t hostent_addr;
 
-			err_t err = netconn_gethostbyname(request->Name, &hostent_addr);
+			uint32_t address = FreeRTOS_gethostbyname(request->Name);
 
-			if (err != ERR_OK || hostent_addr.addr == 0)
+			if (address == 0)
 			{
 				return xResultError;
 			}
 
-			request->Result->Value = hostent_addr.addr;
-			*/
-
-			break;
+			request->Result->Value = address;
 		}
+		break;
 
 		case xNetAdapterConnect:
 		{
-			/*
 			xNetSocketT* client = object;
 
 			CHECK_LWIP_SOCKET(client->Handle);
 
-			struct sockaddr_in server_addr;
+			struct freertos_sockaddr serverAddress = { 0 };
+			serverAddress.sin_family = FREERTOS_AF_INET;
+			serverAddress.sin_port = FreeRTOS_htons(client->Port);
+			serverAddress.sin_addr = client->Address.Value;
 
-			memset(&server_addr, 0, sizeof(server_addr));
-			server_addr.sin_family = AF_INET;
-			server_addr.sin_addr.s_addr = client->Address.Value;
-			server_addr.sin_port = htons(client->Port);
+			if (FreeRTOS_connect(client->Handle, &serverAddress, sizeof(serverAddress)) != 0)
+			{
+				return xResultError;
+			}
 
-			int result = connect((int)client->Handle, (struct sockaddr*)&server_addr, sizeof(server_addr));
-			return result < 0 ? xResultError : xResultAccept;
-			*/
+			client->State = xNetSocketEstablished;
 
-			break;
+			return xResultAccept;
 		}
 
 		case xNetAdapterInit:
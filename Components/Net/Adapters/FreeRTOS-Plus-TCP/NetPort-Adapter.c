@@ -1,6 +1,7 @@
 //==============================================================================
 //includes:
 
+#include <string.h>
 #include "NetPort-Adapter.h"
 #include "lwip/err.h"
 #include "lwip/sockets.h"
@@ -32,7 +33,11 @@ static void PrivateHandler(xPortT* port)
 			{
 				int len = xNetReceive(socket, adapter->RxOperationBuffer, rcvbuf);
 
-				if (len > 0)
+				if (len > 0 && adapter->Cobs.Port)
+				{
+					CobsReceiverReceive(&adapter->Cobs.Receiver, adapter->RxOperationBuffer, len);
+				}
+				else if (len > 0)
 				{
 					xRxReceiverReceive(&adapter->RxReceiver, adapter->RxOperationBuffer, len);
 				}
@@ -78,6 +83,11 @@ static xResult PrivateRequestListener(xPortT* port, xPortAdapterRequestSelector
 
 		case xPortAdapterRequestClearRxBuffer:
 			adapter->RxReceiver.BytesReceived = 0;
+
+			if (adapter->Cobs.Port)
+			{
+				CobsReceiverClear(&adapter->Cobs.Receiver);
+			}
 			break;
 
 		case xPortAdapterRequestGetTxBufferSize:
@@ -126,6 +136,11 @@ static int PrivateTransmit(xPortT* port, void* data, uint32_t size)
 	NetPortAdapterT* adapter = (NetPortAdapterT*)port->Adapter.Content;
 	//xNetSocketT* socket = port->Binding;
 
+	if (adapter->Cobs.Port && CobsPortTransmit(&adapter->Cobs, data, size))
+	{
+		return size;
+	}
+
 	xDataBufferAdd(&adapter->TxBuffer, data, size);
 
 	//return xNetTransmit(socket, data, size);
@@ -187,6 +202,24 @@ xResult NetPortAdapterInit(xPortT* port, NetPortAdapterT* adapter, NetPortAdapte
 						adapterInit->RxBuffer,
 						adapterInit->RxBufferSize);
 
+		memset(&adapter->Cobs, 0, sizeof(adapter->Cobs));
+
+		if (adapterInit->CobsBuffer)
+		{
+			CobsPortInitT cobsInit =
+			{
+				.Text = &adapter->RxReceiver,
+				.Handler = adapterInit->CobsHandler,
+				.Crc = adapterInit->CobsCrc,
+				.Buffer = adapterInit->CobsBuffer,
+				.BufferSize = adapterInit->CobsBufferSize,
+				.ReplyBuffer = adapterInit->CobsReplyBuffer,
+				.ReplyBufferSize = adapterInit->CobsReplyBufferSize
+			};
+
+			CobsPortInit(&adapter->Cobs, port, &cobsInit);
+		}
+
 		xDataBufferInit(&adapter->TxBuffer,
 						port,
 						0,
@@ -16,6 +16,7 @@ extern "C" {
 #include "Common/xDataBuffer.h"
 #include "Abstractions/xNet/xNet.h"
 #include "Abstractions/xPort/xPort.h"
+#include "Cobs/CobsPort.h"
 //==============================================================================
 //types:
 
@@ -24,6 +25,7 @@ typedef struct
 	xPortAdapterBaseT Base;
 
 	xRxReceiverT RxReceiver;
+	CobsPortT Cobs; //binary frames among the text lines, Port 0 - text only
 	xDataBufferT TxBuffer;
 
 	uint8_t* RxOperationBuffer;
@@ -44,6 +46,13 @@ typedef struct
 	uint8_t* RxBuffer;
 	int RxBufferSize;
 
+	uint8_t* CobsBuffer; //the largest payload of a frame and its CRC, 0 - text only
+	int CobsBufferSize;
+	uint8_t* CobsReplyBuffer;
+	int CobsReplyBufferSize;
+	CobsCrcT CobsCrc;
+	CobsPortHandlerT CobsHandler;
+
 } NetPortAdapterInitT;
 //==============================================================================
 //functions:
@@ -4,6 +4,7 @@
 
 #include "Net-Component.h"
 #include "Components.h"
+#include "TerminalCommands/TerminalCommands.h"
 
 #if NET_TARGET_LAYOUT == NET_LWIP_LAYOUT
 
@@ -19,7 +20,9 @@
 //==============================================================================
 //defines:
 
-
+#if NET_COBS_ENABLE == 1 && (CRC_ENABLE != 1 || NET_TARGET_LAYOUT != NET_FREERTOS_LAYOUT)
+#error "the COBS frames are checked by CRC-32 of the CRC component and taken by the FreeRTOS-Plus-TCP port"
+#endif
 //==============================================================================
 //import:
 
@@ -35,6 +38,11 @@ static uint8_t private_rx_operation_buffer[NET_RX_OPERATION_BUFFER_SIZE] NET_RX_
 static uint8_t private_rx_buffer[NET_RX_BUFFER_SIZE] NET_RX_BUFFER_MEM_SECTION;
 static uint8_t private_tx_buffer[NET_RX_BUFFER_SIZE] NET_TX_BUFFER_MEM_SECTION;
 
+#if NET_COBS_ENABLE == 1
+static uint8_t private_cobs_buffer[NET_COBS_BUFFER_SIZE] NET_RX_BUFFER_MEM_SECTION;
+static uint8_t private_cobs_reply_buffer[NET_COBS_REPLY_BUFFER_SIZE] NET_TX_BUFFER_MEM_SECTION;
+#endif
+
 static TaskHandle_t taskHandle;
 static StaticTask_t taskBuffer;
 static StackType_t taskStack[NET_TASK_STACK_SIZE] NET_COMPONENT_MAIN_TASK_STACK_SECTION;
@@ -58,6 +66,14 @@ xPortT NetPort NET_PORT_MEM_SECTION = { 0 };
 //==============================================================================
 //functions:
 
+#if NET_COBS_ENABLE == 1
+/// @brief the CRC-32 trailer of the COBS frames
+static uint32_t privateCobsCrc(const void* data, uint32_t size)
+{
+	return CrcComponentCalculate(CrcVariant32, data, size);
+}
+//------------------------------------------------------------------------------
+#endif
 static void privateEventListener(ObjectBaseT* object, int selector, uint32_t description, void* arg)
 {
 	if (object->Description->ObjectId == xPORT_OBJECT_ID)
@@ -68,7 +84,7 @@ static void privateEventListener(ObjectBaseT* object, int selector, uint32_t des
 		{
 			case xPortObjectEventRxFoundEndLine:
 			{
-				TerminalReceiveData(port, arg);
+				TerminalCommandsReceive(port, arg);
 			}
 			break;
 
@@ -231,7 +247,16 @@ xResult NetComponentInit(void* parent)
 		.RxBufferSize = sizeof(private_rx_buffer),
 
 		.TxBuffer = private_tx_buffer,
-		.TxBufferSize = sizeof(private_tx_buffer)
+		.TxBufferSize = sizeof(private_tx_buffer),
+
+#if NET_COBS_ENABLE == 1
+		.CobsBuffer = private_cobs_buffer,
+		.CobsBufferSize = sizeof(private_cobs_buffer),
+		.CobsReplyBuffer = private_cobs_reply_buffer,
+		.CobsReplyBufferSize = sizeof(private_cobs_reply_buffer),
+		.CobsCrc = privateCobsCrc,
+		.CobsHandler = TerminalCommandsReceive
+#endif
 	};
 
 	NetPortAdapterInit(&NetPort, &privateNetPortAdapter, &netPortInit);
@@ -38,6 +38,10 @@ extern "C" {
 #define NET_RX_OPERATION_BUFFER_SIZE 0x200
 #define NET_RX_BUFFER_SIZE 0x200
 #define NET_TX_BUFFER_SIZE 0x400
+
+#define NET_COBS_ENABLE 1 //"\0<COBS of payload and CRC-32>\0" frames among the text lines, FreeRTOS layout only
+#define NET_COBS_BUFFER_SIZE 0x404 //the largest payload and its CRC
+#define NET_COBS_REPLY_BUFFER_SIZE 0x3f0 //the terminal output of a frame, COBS_FRAME_SIZE of it fits the buffer above
 //==============================================================================
 //import:
 
@@ -0,0 +1,121 @@
+//==============================================================================
+//includes:
+
+#include "NetReconnect.h"
+#include <string.h>
+//==============================================================================
+//functions:
+
+static uint32_t privateRandom(NetReconnectT* reconnect)
+{
+	//xorshift32
+	uint32_t value = reconnect->Random;
+
+	value ^= value << 13;
+	value ^= value >> 17;
+	value ^= value << 5;
+
+	reconnect->Random = value;
+
+	return value;
+}
+//------------------------------------------------------------------------------
+static void privateSchedule(NetReconnectT* reconnect, uint32_t time)
+{
+	uint32_t ceiling = reconnect->MaxDelay;
+
+	//BaseDelay * 2^Failures without the overflow
+	if (reconnect->Failures < 32 && reconnect->BaseDelay <= (reconnect->MaxDelay >> reconnect->Failures))
+	{
+		ceiling = reconnect->BaseDelay << reconnect->Failures;
+	}
+
+	reconnect->Delay = ceiling ? privateRandom(reconnect) % (ceiling + 1) : 0;
+	reconnect->NextAttemptTime = time + reconnect->Delay;
+	reconnect->State = NetReconnectStateWaiting;
+
+	if (reconnect->Failures < UINT32_MAX)
+	{
+		reconnect->Failures++;
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief checks whether a connection attempt may be made now, the allowed attempt is counted.
+ */
+bool NetReconnectIsAllowed(NetReconnectT* reconnect, uint32_t time)
+{
+	if (reconnect->State == NetReconnectStateWaiting && (int32_t)(time - reconnect->NextAttemptTime) < 0)
+	{
+		return false;
+	}
+
+	reconnect->State = NetReconnectStateIdle;
+	reconnect->Attempts++;
+
+	return true;
+}
+//------------------------------------------------------------------------------
+/**
+ * @return ms until the next attempt is allowed, 0 - allowed now or connected
+ */
+uint32_t NetReconnectGetWaitTime(NetReconnectT* reconnect, uint32_t time)
+{
+	int32_t remaining = (int32_t)(reconnect->NextAttemptTime - time);
+
+	return reconnect->State == NetReconnectStateWaiting && remaining > 0 ? (uint32_t)remaining : 0;
+}
+//------------------------------------------------------------------------------
+void NetReconnectFailed(NetReconnectT* reconnect, uint32_t time)
+{
+	privateSchedule(reconnect, time);
+}
+//------------------------------------------------------------------------------
+void NetReconnectConnected(NetReconnectT* reconnect, uint32_t time)
+{
+	reconnect->State = NetReconnectStateConnected;
+	reconnect->ConnectedTime = time;
+	reconnect->Connections++;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief a connection that didn't live StableTime keeps the backoff, so a broker
+ * that accepts and drops the connections is not hammered either.
+ */
+void NetReconnectDisconnected(NetReconnectT* reconnect, uint32_t time)
+{
+	if (reconnect->State != NetReconnectStateConnected)
+	{
+		return;
+	}
+
+	if (time - reconnect->ConnectedTime >= reconnect->StableTime)
+	{
+		reconnect->Failures = 0;
+	}
+
+	privateSchedule(reconnect, time);
+}
+//==============================================================================
+//initialization:
+
+xResult NetReconnectInit(NetReconnectT* reconnect, NetReconnectInitT* init)
+{
+	if (reconnect && init && init->MaxDelay >= init->BaseDelay)
+	{
+		memset(reconnect, 0, sizeof(NetReconnectT));
+
+		reconnect->Name = init->Name;
+		reconnect->BaseDelay = init->BaseDelay;
+		reconnect->MaxDelay = init->MaxDelay;
+		reconnect->StableTime = init->StableTime;
+
+		//xorshift32 never leaves the zero state
+		reconnect->Random = init->Seed ? init->Seed : 0x9E3779B9U;
+
+		return xResultAccept;
+	}
+
+	return xResultError;
+}
+//==============================================================================
@@ -0,0 +1,79 @@
+//==============================================================================
+//header:
+
+#ifndef _NET_RECONNECT_H_
+#define _NET_RECONNECT_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+//==============================================================================
+//types:
+
+typedef enum
+{
+	NetReconnectStateIdle, //an attempt is allowed
+	NetReconnectStateWaiting, //the attempt failed, the next one is allowed at NextAttemptTime
+	NetReconnectStateConnected
+
+} NetReconnectStateT;
+//------------------------------------------------------------------------------
+/**
+ * @brief reconnect scheduler of an outbound client: exponential backoff with full jitter.
+ * After a failure the next attempt is delayed by a random time in [0, min(MaxDelay, BaseDelay * 2^Failures)],
+ * the backoff is reset when the connection lived for StableTime.
+ */
+typedef struct
+{
+	const char* Name;
+
+	NetReconnectStateT State;
+
+	uint32_t BaseDelay; //ms
+	uint32_t MaxDelay; //ms
+	uint32_t StableTime; //ms
+
+	uint32_t Failures; //since the last stable connection
+	uint32_t Delay; //ms, the last chosen delay
+	uint32_t NextAttemptTime;
+	uint32_t ConnectedTime;
+
+	uint32_t Attempts;
+	uint32_t Connections;
+
+	uint32_t Random;
+
+} NetReconnectT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	const char* Name;
+
+	uint32_t BaseDelay;
+	uint32_t MaxDelay;
+	uint32_t StableTime;
+
+	uint32_t Seed; //different on each device, so the clients don't reconnect in step
+
+} NetReconnectInitT;
+//==============================================================================
+//functions:
+
+xResult NetReconnectInit(NetReconnectT* reconnect, NetReconnectInitT* init);
+
+bool NetReconnectIsAllowed(NetReconnectT* reconnect, uint32_t time);
+uint32_t NetReconnectGetWaitTime(NetReconnectT* reconnect, uint32_t time);
+
+void NetReconnectFailed(NetReconnectT* reconnect, uint32_t time);
+void NetReconnectConnected(NetReconnectT* reconnect, uint32_t time);
+void NetReconnectDisconnected(NetReconnectT* reconnect, uint32_t time);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_NET_RECONNECT_H_
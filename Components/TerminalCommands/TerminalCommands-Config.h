@@ -0,0 +1,25 @@
+//==============================================================================
+//header:
+
+#ifndef _TERMINAL_COMMANDS_CONFIG_H_
+#define _TERMINAL_COMMANDS_CONFIG_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+//==============================================================================
+//defines:
+
+#define TERMINAL_COMMANDS_COUNT 24 //the commands of all the components
+#define TERMINAL_COMMANDS_LINE_SIZE 128 //the copy of the line is on the stack of the receiving task
+#define TERMINAL_COMMANDS_ARGUMENTS_COUNT 16 //words after the name of the command
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_TERMINAL_COMMANDS_CONFIG_H_
@@ -0,0 +1,199 @@
+//==============================================================================
+//includes:
+
+#include "TerminalCommands.h"
+#include "Components.h"
+#include <string.h>
+#include <stdlib.h>
+//==============================================================================
+//variables:
+
+static const TerminalCommandT* privateCommands[TERMINAL_COMMANDS_COUNT];
+static uint8_t privateCommandsCount;
+//==============================================================================
+//functions:
+
+/**
+ * @brief the commands of a component, added from its initialization before the ports receive
+ * @param commands static, the table is not copied
+ */
+xResult TerminalCommandsAdd(const TerminalCommandT* commands, uint8_t count)
+{
+	if (privateCommandsCount + count > TERMINAL_COMMANDS_COUNT)
+	{
+		return xResultError;
+	}
+
+	for (uint8_t i = 0; i < count; i++)
+	{
+		privateCommands[privateCommandsCount++] = &commands[i];
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static const TerminalCommandT* privateFind(const char* name)
+{
+	for (uint8_t i = 0; i < privateCommandsCount; i++)
+	{
+		if (strcmp(privateCommands[i]->Name, name) == 0)
+		{
+			return privateCommands[i];
+		}
+	}
+
+	return NULL;
+}
+//------------------------------------------------------------------------------
+static void privateReport(xPortT* port, const TerminalCommandT* command, const char* text, const char* usage)
+{
+	xPortStartTransmission(port);
+	xPortTransmitString(port, "[");
+	xPortTransmitString(port, command->Name);
+	xPortTransmitString(port, "] ");
+	xPortTransmitString(port, text);
+
+	if (usage)
+	{
+		xPortTransmitString(port, command->Name);
+
+		if (usage[0])
+		{
+			xPortTransmitString(port, " ");
+			xPortTransmitString(port, usage);
+		}
+	}
+
+	xPortTransmitString(port, "\r");
+	xPortEndTransmission(port);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief a line of any port (network, serial, RS485, MQTT): the first word is looked up in the
+ * commands of the components, the lines of no command go to the terminal as before
+ */
+void TerminalCommandsReceive(xPortT* port, RxDataPacketT* packet)
+{
+	char line[TERMINAL_COMMANDS_LINE_SIZE];
+	TerminalCommandArgumentsT arguments;
+	uint32_t size = packet->Size;
+	bool isTruncated = false;
+
+	if (size >= sizeof(line))
+	{
+		size = sizeof(line) - 1;
+		isTruncated = true;
+	}
+
+	memcpy(line, packet->Data, size);
+	line[size] = 0;
+
+	char* next;
+	char* name = strtok_r(line, " \t\r\n", &next);
+	const TerminalCommandT* command = name ? privateFind(name) : NULL;
+
+	if (!command)
+	{
+		TerminalReceiveData(port, packet);
+		return;
+	}
+
+	arguments.Count = 0;
+
+	char* word = strtok_r(NULL, " \t\r\n", &next);
+
+	while (word)
+	{
+		if (arguments.Count == TERMINAL_COMMANDS_ARGUMENTS_COUNT)
+		{
+			isTruncated = true;
+			break;
+		}
+
+		arguments.Values[arguments.Count++] = word;
+		word = strtok_r(NULL, " \t\r\n", &next);
+	}
+
+	xResult result = isTruncated ? xResultError : command->Handler(port, &arguments);
+
+	if (result == xResultError)
+	{
+		privateReport(port, command, "usage: ", command->Usage);
+	}
+	else if (result == xResultBusy)
+	{
+		privateReport(port, command, "busy", NULL);
+	}
+}
+//------------------------------------------------------------------------------
+static bool privateIsOption(const char* word)
+{
+	return word[0] == '-' && word[1] && !word[2];
+}
+//------------------------------------------------------------------------------
+/// @return the word after "-name", NULL - no such option or no value
+char* TerminalCommandGetOption(TerminalCommandArgumentsT* arguments, char name)
+{
+	for (uint8_t i = 0; i + 1 < arguments->Count; i++)
+	{
+		if (privateIsOption(arguments->Values[i]) && arguments->Values[i][1] == name)
+		{
+			return arguments->Values[i + 1];
+		}
+	}
+
+	return NULL;
+}
+//------------------------------------------------------------------------------
+/// @return the number of "-name" (decimal, 0x hex), value - no such option
+uint32_t TerminalCommandGetNumber(TerminalCommandArgumentsT* arguments, char name, uint32_t value)
+{
+	char* option = TerminalCommandGetOption(arguments, name);
+
+	return option ? strtoul(option, NULL, 0) : value;
+}
+//------------------------------------------------------------------------------
+bool TerminalCommandHasFlag(TerminalCommandArgumentsT* arguments, char name)
+{
+	for (uint8_t i = 0; i < arguments->Count; i++)
+	{
+		if (privateIsOption(arguments->Values[i]) && arguments->Values[i][1] == name)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief every word is one of the options: "-x value" for x in options, "-x" for x in flags
+ * @return xResultError - another word, an unknown option or an option without its value
+ */
+xResult TerminalCommandCheckOptions(TerminalCommandArgumentsT* arguments, const char* options, const char* flags)
+{
+	for (uint8_t i = 0; i < arguments->Count; i++)
+	{
+		char* word = arguments->Values[i];
+
+		if (!privateIsOption(word))
+		{
+			return xResultError;
+		}
+
+		if (options && strchr(options, word[1]))
+		{
+			if (++i == arguments->Count)
+			{
+				return xResultError;
+			}
+		}
+		else if (!flags || !strchr(flags, word[1]))
+		{
+			return xResultError;
+		}
+	}
+
+	return xResultAccept;
+}
+//==============================================================================
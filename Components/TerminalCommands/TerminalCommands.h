@@ -0,0 +1,55 @@
+//==============================================================================
+//header:
+
+#ifndef _TERMINAL_COMMANDS_H_
+#define _TERMINAL_COMMANDS_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "TerminalCommands-Config.h"
+#include "Abstractions/xPort/xPort.h"
+//==============================================================================
+//types:
+
+/// @brief the words of the line after the name of the command, zero terminated
+typedef struct
+{
+	uint8_t Count;
+	char* Values[TERMINAL_COMMANDS_ARGUMENTS_COUNT];
+
+} TerminalCommandArgumentsT;
+//------------------------------------------------------------------------------
+/**
+ * @return xResultAccept - done, xResultError - the usage of the command is reported,
+ * xResultBusy - "busy" is reported
+ */
+typedef xResult (*TerminalCommandHandlerT)(xPortT* port, TerminalCommandArgumentsT* arguments);
+//------------------------------------------------------------------------------
+typedef struct
+{
+	const char* Name; //the first word of the line
+	const char* Usage; //the arguments after the name
+	TerminalCommandHandlerT Handler;
+
+} TerminalCommandT;
+//==============================================================================
+//functions:
+
+xResult TerminalCommandsAdd(const TerminalCommandT* commands, uint8_t count);
+
+void TerminalCommandsReceive(xPortT* port, RxDataPacketT* packet);
+
+char* TerminalCommandGetOption(TerminalCommandArgumentsT* arguments, char name);
+uint32_t TerminalCommandGetNumber(TerminalCommandArgumentsT* arguments, char name, uint32_t value);
+bool TerminalCommandHasFlag(TerminalCommandArgumentsT* arguments, char name);
+xResult TerminalCommandCheckOptions(TerminalCommandArgumentsT* arguments, const char* options, const char* flags);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_TERMINAL_COMMANDS_H_
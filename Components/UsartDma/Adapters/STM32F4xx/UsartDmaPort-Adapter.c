@@ -0,0 +1,893 @@
+//==============================================================================
+//includes:
+
+#include <string.h>
+#include "UsartDmaPort-Adapter.h"
+#include "UsartDma/UsartDma-ComponentConfig.h"
+//==============================================================================
+//functions:
+
+/// @brief the stream is stopped even when it was started by the previous adapter without HAL
+static void privateStopStream(DMA_HandleTypeDef* dma)
+{
+	__HAL_DMA_DISABLE(dma);
+
+	while (dma->Instance->CR & DMA_SxCR_EN)
+	{
+	}
+
+	dma->State = HAL_DMA_STATE_READY;
+	__HAL_UNLOCK(dma);
+}
+//------------------------------------------------------------------------------
+static inline uint16_t privateGetRxWriteIndex(UsartDmaPortAdapterT* adapter)
+{
+	return (adapter->RxCircleBufferSizeMask + 1 - __HAL_DMA_GET_COUNTER(adapter->RxDma)) & adapter->RxCircleBufferSizeMask;
+}
+//------------------------------------------------------------------------------
+static inline uint16_t privateHash(uint16_t hash, uint8_t value)
+{
+	return (uint16_t)((hash << 1) | (hash >> 15)) ^ value;
+}
+//------------------------------------------------------------------------------
+static void privateOnePulseStart(TIM_TypeDef* timer)
+{
+	timer->CNT = 0;
+	timer->CR1 |= TIM_CR1_CEN;
+}
+//------------------------------------------------------------------------------
+static void privateOnePulseStop(TIM_TypeDef* timer)
+{
+	timer->CR1 &= ~TIM_CR1_CEN;
+	timer->SR = ~TIM_SR_UIF;
+}
+//------------------------------------------------------------------------------
+/// @brief the update interrupt comes once, the duration after the start
+static void privateOnePulseInit(TIM_TypeDef* timer, uint32_t nanoseconds)
+{
+	bool isApb2 = (uint32_t)timer >= APB2PERIPH_BASE;
+	uint32_t clock = isApb2 ? HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+
+	//the timers run at twice the clock of a divided bus
+	if (RCC->CFGR & (isApb2 ? RCC_CFGR_PPRE2_2 : RCC_CFGR_PPRE1_2))
+	{
+		clock *= 2;
+	}
+
+	uint32_t ticks = (uint64_t)clock * nanoseconds / 1000000000;
+	uint32_t prescaler = ticks >> 16;
+
+	ticks /= prescaler + 1;
+
+	timer->CR1 &= ~TIM_CR1_CEN;
+	timer->PSC = prescaler;
+	timer->ARR = ticks > 1 ? ticks - 1 : 1;
+	timer->CR1 |= TIM_CR1_OPM | TIM_CR1_URS;
+	timer->EGR = TIM_EGR_UG;
+	timer->SR = ~TIM_SR_UIF;
+	timer->DIER |= TIM_DIER_UIE;
+}
+//------------------------------------------------------------------------------
+/// @brief DE is asserted before the first byte of the frame, a frame within the guard time keeps it
+static void privateRs485Assert(UsartDmaPortAdapterT* adapter, const uint8_t* data, uint16_t size)
+{
+	UsartDmaRs485T* rs485 = &adapter->Rs485;
+
+	if (!rs485->IsTransmitting)
+	{
+		rs485->FrameStart = privateGetRxWriteIndex(adapter);
+		rs485->FrameSize = 0;
+		rs485->FrameHash = 0;
+
+		rs485->DePort->BSRR = rs485->DePin;
+		rs485->IsTransmitting = true;
+
+		adapter->Statistic.Frames++;
+	}
+	else if (rs485->GuardTimer)
+	{
+		privateOnePulseStop(rs485->GuardTimer->Instance);
+	}
+
+	if (rs485->EchoCheck)
+	{
+		rs485->FrameSize += size;
+
+		while (size--)
+		{
+			rs485->FrameHash = privateHash(rs485->FrameHash, *data++);
+		}
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief idle line, half and full transfer: the bytes up to the write index of the ring
+ * are complete, the owning task is woken instead of waiting for the next super-loop pass
+ */
+static void privateRxEvent(UsartDmaPortAdapterT* adapter)
+{
+	adapter->Statistic.RxEvents++;
+
+	if (!adapter->RxEventStamp)
+	{
+		adapter->RxEventStamp = DWT->CYCCNT | 1;
+	}
+
+	if (adapter->RxTask)
+	{
+		BaseType_t woken = pdFALSE;
+
+		vTaskNotifyGiveFromISR(adapter->RxTask, &woken);
+		portYIELD_FROM_ISR(woken);
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief the last stop bit and the guard time are out: the bus is given back
+static void privateRs485Release(UsartDmaPortAdapterT* adapter)
+{
+	UsartDmaRs485T* rs485 = &adapter->Rs485;
+
+	rs485->DePort->BSRR = (uint32_t)rs485->DePin << 16;
+	rs485->IsTransmitting = false;
+
+	if (!rs485->EchoCheck)
+	{
+		return;
+	}
+
+	if ((uint8_t)(rs485->EchoesIn - rs485->EchoesOut) >= USART_DMA_RS485_ECHOES_COUNT)
+	{
+		adapter->Statistic.EchoLosses++;
+		return;
+	}
+
+	UsartDmaEchoT* echo = &rs485->Echoes[rs485->EchoesIn & (USART_DMA_RS485_ECHOES_COUNT - 1)];
+
+	echo->Start = rs485->FrameStart;
+	echo->End = privateGetRxWriteIndex(adapter);
+	echo->Size = rs485->FrameSize;
+	echo->Hash = rs485->FrameHash;
+
+	rs485->EchoesIn++;
+
+	privateRxEvent(adapter);
+}
+//------------------------------------------------------------------------------
+/// @brief the stream is disabled by the hardware after its last byte, before its complete interrupt
+static inline bool privateTxIsIdle(UsartDmaPortAdapterT* adapter)
+{
+	return !adapter->TxRing.Pending || !(adapter->TxDma->Instance->CR & DMA_SxCR_EN);
+}
+//------------------------------------------------------------------------------
+/// @brief called with the DMA interrupt masked or from it
+static void privateStartTransfer(UsartDmaPortAdapterT* adapter)
+{
+	USART_TypeDef* usart = adapter->Handle->Instance;
+	uint8_t* data;
+	uint16_t size = UsartDmaTxRingStart(&adapter->TxRing, &data);
+
+	if (!size)
+	{
+		return;
+	}
+
+	if (adapter->Rs485.DePort)
+	{
+		privateRs485Assert(adapter, data, size);
+
+		//a failed start leaves TC set, DE is released by it
+		SET_BIT(usart->CR1, USART_CR1_TCIE);
+	}
+
+	if (HAL_DMA_Start_IT(adapter->TxDma, (uint32_t)data, (uint32_t)&usart->DR, size) != HAL_OK)
+	{
+		adapter->TxRing.Pending = 0;
+		adapter->Statistic.TxErrors++;
+		return;
+	}
+
+	if (adapter->Rs485.DePort)
+	{
+		usart->SR = ~USART_SR_TC;
+	}
+
+	adapter->Statistic.Transfers++;
+	adapter->Statistic.TxBytes += size;
+}
+//------------------------------------------------------------------------------
+static void privateTxComplete(DMA_HandleTypeDef* dma)
+{
+	xPortT* port = dma->Parent;
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+	BaseType_t woken = pdFALSE;
+
+	//TC and the guard timer of RS485 may not see the span completed but not restarted yet
+	UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+
+	//the wrapped part of the ring is chained here, the task is not involved
+	UsartDmaTxRingComplete(&adapter->TxRing);
+	privateStartTransfer(adapter);
+
+	//TC of the last byte, it was masked while the transfer was pending
+	if (adapter->Rs485.IsTransmitting)
+	{
+		SET_BIT(adapter->Handle->Instance->CR1, USART_CR1_TCIE);
+	}
+
+	taskEXIT_CRITICAL_FROM_ISR(mask);
+
+	xSemaphoreGiveFromISR(adapter->TxSemaphore, &woken);
+	portYIELD_FROM_ISR(woken);
+}
+//------------------------------------------------------------------------------
+static void privateTxError(DMA_HandleTypeDef* dma)
+{
+	xPortT* port = dma->Parent;
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+
+	adapter->Statistic.TxErrors++;
+
+	//a direct mode error leaves the stream running, its transfer complete follows
+	if (dma->State != HAL_DMA_STATE_READY)
+	{
+		return;
+	}
+
+	//the span is dropped, the stream is restarted with the next one
+	privateTxComplete(dma);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the critical section of the task is not used: before the scheduler starts
+ * it keeps the interrupts masked and the transfer complete would never come
+ */
+static void privateKick(UsartDmaPortAdapterT* adapter)
+{
+	UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+
+	privateStartTransfer(adapter);
+
+	taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+//------------------------------------------------------------------------------
+static void privateRxTransferEvent(DMA_HandleTypeDef* dma)
+{
+	xPortT* port = dma->Parent;
+
+	privateRxEvent((UsartDmaPortAdapterT*)port->Adapter.Content);
+}
+//------------------------------------------------------------------------------
+/// @brief the stream is disabled by the error, it is restarted from the beginning of the ring
+static void privateRxError(DMA_HandleTypeDef* dma)
+{
+	xPortT* port = dma->Parent;
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+
+	adapter->Statistic.RxErrors++;
+
+	if (dma->State != HAL_DMA_STATE_READY)
+	{
+		return;
+	}
+
+	adapter->RxPosition = 0;
+
+	HAL_DMA_Start_IT(dma,
+					(uint32_t)&adapter->Handle->Instance->DR,
+					(uint32_t)adapter->RxCircleBuffer,
+					adapter->RxCircleBufferSizeMask + 1);
+}
+//------------------------------------------------------------------------------
+/// @brief bytes from RxPosition up to the index, the order of the echoes and the frame ends
+static inline uint16_t privateGetRxDistance(UsartDmaPortAdapterT* adapter, uint16_t index)
+{
+	return (index - adapter->RxPosition) & adapter->RxCircleBufferSizeMask;
+}
+//------------------------------------------------------------------------------
+/// @brief in the framing mode the bytes are collected in the RxReceiver buffer until the frame end
+static void privateReceiveSpan(UsartDmaPortAdapterT* adapter, uint8_t* data, uint16_t size)
+{
+	UsartDmaFramingT* framing = &adapter->Framing;
+
+	if (!framing->Listener)
+	{
+		if (adapter->Cobs.Port)
+		{
+			CobsReceiverReceive(&adapter->Cobs.Receiver, data, size);
+		}
+		else
+		{
+			xRxReceiverReceive(&adapter->RxReceiver, data, size);
+		}
+
+		return;
+	}
+
+	uint32_t free = adapter->RxReceiver.BufferSize - framing->Size;
+
+	if (size > free)
+	{
+		framing->IsOverflow = true;
+		size = free;
+	}
+
+	memcpy(adapter->RxReceiver.Buffer + framing->Size, data, size);
+	framing->Size += size;
+}
+//------------------------------------------------------------------------------
+static void privateReceiveTo(xPortT* port, uint16_t position)
+{
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+	uint16_t size = adapter->RxCircleBufferSizeMask + 1;
+
+	while (adapter->RxPosition != position)
+	{
+		uint16_t end = position > adapter->RxPosition ? position : size;
+
+		privateReceiveSpan(adapter, adapter->RxCircleBuffer + adapter->RxPosition, end - adapter->RxPosition);
+
+		adapter->RxPosition = end & adapter->RxCircleBufferSizeMask;
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief the listener builds its response from the task of the receive, the frame stays in place
+static void privateFrameEnd(xPortT* port)
+{
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+	UsartDmaFramingT* framing = &adapter->Framing;
+
+	if (framing->IsOverflow)
+	{
+		adapter->Statistic.FrameOverflows++;
+	}
+	else if (framing->Size)
+	{
+		adapter->Statistic.RxFrames++;
+		framing->Listener(port, adapter->RxReceiver.Buffer, framing->Size, framing->Context);
+	}
+
+	framing->Size = 0;
+	framing->IsOverflow = false;
+}
+//------------------------------------------------------------------------------
+static void privateCheckEcho(UsartDmaPortAdapterT* adapter, UsartDmaEchoT* echo)
+{
+	uint16_t hash = 0;
+
+	for (uint16_t i = echo->Start; i != echo->End; i = (i + 1) & adapter->RxCircleBufferSizeMask)
+	{
+		hash = privateHash(hash, adapter->RxCircleBuffer[i]);
+	}
+
+	if (((echo->End - echo->Start) & adapter->RxCircleBufferSizeMask) != echo->Size || hash != echo->Hash)
+	{
+		adapter->Statistic.Collisions++;
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the own frames of RS485 are checked and removed, the frame ends of the framing mode
+ * are given to the listener, the rest goes to RxReceiver
+ */
+static void privateReceive(xPortT* port)
+{
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+	UsartDmaRs485T* rs485 = &adapter->Rs485;
+	UsartDmaFramingT* framing = &adapter->Framing;
+
+	if (!rs485->EchoCheck && !framing->Listener)
+	{
+		privateReceiveTo(port, privateGetRxWriteIndex(adapter));
+		return;
+	}
+
+	//the windows, the ends, the write index and DE are taken together: the interrupts change them
+	UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+
+	uint8_t echoes = rs485->EchoesIn;
+	uint8_t ends = framing->EndsIn;
+	uint16_t position = rs485->IsTransmitting ? rs485->FrameStart : privateGetRxWriteIndex(adapter);
+
+	taskEXIT_CRITICAL_FROM_ISR(mask);
+
+	//both queues are in the order of the ring, they are merged by the distance from RxPosition
+	while (rs485->EchoesOut != echoes || framing->EndsOut != ends)
+	{
+		UsartDmaEchoT* echo = rs485->EchoesOut != echoes
+				? &rs485->Echoes[rs485->EchoesOut & (USART_DMA_RS485_ECHOES_COUNT - 1)] : NULL;
+
+		uint16_t* end = framing->EndsOut != ends
+				? &framing->Ends[framing->EndsOut & (USART_DMA_FRAME_ENDS_COUNT - 1)] : NULL;
+
+		if (end && (!echo || privateGetRxDistance(adapter, *end) <= privateGetRxDistance(adapter, echo->Start)))
+		{
+			privateReceiveTo(port, *end);
+			privateFrameEnd(port);
+
+			framing->EndsOut++;
+			continue;
+		}
+
+		privateReceiveTo(port, echo->Start);
+		privateCheckEcho(adapter, echo);
+
+		//the bus was taken in the middle of a frame: its start is dropped
+		framing->Size = 0;
+		framing->IsOverflow = false;
+
+		adapter->RxPosition = echo->End;
+		rs485->EchoesOut++;
+	}
+
+	privateReceiveTo(port, position);
+}
+//------------------------------------------------------------------------------
+/// @brief the delay of the events is counted for the owning task and for the port handler
+static void privateDispatch(xPortT* port)
+{
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+	uint32_t stamp = adapter->RxEventStamp;
+
+	adapter->RxEventStamp = 0;
+
+	privateReceive(port);
+
+	if (!stamp)
+	{
+		return;
+	}
+
+	uint32_t delay = DWT->CYCCNT - stamp;
+
+	adapter->Statistic.RxDispatches++;
+	adapter->Statistic.RxDelayCycles += delay;
+
+	if (delay > adapter->Statistic.RxDelayMaxCycles)
+	{
+		adapter->Statistic.RxDelayMaxCycles = delay;
+	}
+}
+//------------------------------------------------------------------------------
+static void PrivateHandler(xPortT* port)
+{
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+
+	if (!adapter->RxTask)
+	{
+		privateDispatch(port);
+	}
+}
+//------------------------------------------------------------------------------
+static xResult PrivateRequestListener(xPortT* port, xPortAdapterRequestSelector selector, uint32_t description, void* arg)
+{
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+
+	switch ((uint32_t)selector)
+	{
+		case xPortAdapterRequestUpdateTxStatus:
+			port->Tx.IsEnable = true;
+			break;
+
+		case xPortAdapterRequestUpdateRxStatus:
+			port->Rx.IsEnable = true;
+			break;
+
+		case xPortAdapterRequestGetRxBuffer:
+			*(uint8_t**)arg = adapter->RxReceiver.Buffer;
+			break;
+
+		case xPortAdapterRequestGetRxBufferSize:
+			*(uint32_t*)arg = adapter->RxReceiver.BufferSize;
+			break;
+
+		case xPortAdapterRequestGetRxBufferFreeSize:
+			*(uint32_t*)arg = adapter->RxReceiver.BufferSize - adapter->RxReceiver.BytesReceived;
+			break;
+
+		case xPortAdapterRequestClearRxBuffer:
+			adapter->RxReceiver.BytesReceived = 0;
+
+			if (adapter->Cobs.Port)
+			{
+				CobsReceiverClear(&adapter->Cobs.Receiver);
+			}
+			break;
+
+		case xPortAdapterRequestGetTxBufferSize:
+			*(uint32_t*)arg = adapter->TxRing.SizeMask + 1;
+			break;
+
+		case xPortAdapterRequestGetTxBufferFreeSize:
+			*(uint32_t*)arg = UsartDmaTxRingGetFreeSize(&adapter->TxRing);
+			break;
+
+		case xPortAdapterRequestSetBinding:
+			port->Binding = arg;
+			break;
+
+		case xPortAdapterRequestStartTransmission:
+			xSemaphoreTake(adapter->TransactionMutex, portMAX_DELAY);
+			break;
+
+		case xPortAdapterRequestEndTransmission:
+			xSemaphoreGive(adapter->TransactionMutex);
+			break;
+
+		default : return xResultRequestIsNotFound;
+	}
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static void PrivateEventListener(xPortT* port, xPortAdapterEventSelector selector, uint32_t description, void* arg)
+{
+	switch((int)selector)
+	{
+		default: return;
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief copies the data into the ring and starts a transfer when DMA is idle.
+ * Waits for the running transfer while the ring is full.
+ */
+static int PrivateTransmit(xPortT* port, void* data, uint32_t size)
+{
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+	const uint8_t* bytes = data;
+	uint32_t remaining = size;
+
+	if (adapter->Cobs.Port && CobsPortTransmit(&adapter->Cobs, data, size))
+	{
+		return size;
+	}
+
+	while (remaining)
+	{
+		uint16_t written = UsartDmaTxRingWrite(&adapter->TxRing, bytes, remaining > UINT16_MAX ? UINT16_MAX : remaining);
+
+		bytes += written;
+		remaining -= written;
+
+		privateKick(adapter);
+
+		if (!remaining)
+		{
+			break;
+		}
+
+		adapter->Statistic.TxWaits++;
+
+		if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+		{
+			if (xSemaphoreTake(adapter->TxSemaphore, pdMS_TO_TICKS(USART_DMA_TX_TIMEOUT)) != pdTRUE
+				&& !UsartDmaTxRingGetFreeSize(&adapter->TxRing))
+			{
+				break;
+			}
+		}
+		else
+		{
+			while (!UsartDmaTxRingGetFreeSize(&adapter->TxRing))
+			{
+			}
+		}
+	}
+
+	return size - remaining;
+}
+//------------------------------------------------------------------------------
+static int PrivateReceive(xPortT* port, void* data, uint32_t size)
+{
+	return 0;
+}
+//------------------------------------------------------------------------------
+static void PrivateRxReceiverEventListener(xRxReceiverT* receiver, xRxReceiverEventSelector event, void* arg)
+{
+	register xPortT* port = receiver->Base.Parent;
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+
+	switch ((uint8_t)event)
+	{
+		case xRxReceiverEventEndLine:
+			if (adapter->LineListener)
+			{
+				adapter->LineListener(port, arg);
+				break;
+			}
+
+			xPortEventListener(port, xPortObjectEventRxFoundEndLine, 0, arg);
+			break;
+
+		case xRxReceiverEventBufferIsFull:
+			xPortEventListener(port, xPortObjectEventRxBufferIsFull, 0, arg);
+			break;
+
+		default: return;
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief USART interrupt: the idle line, TC of RS485 and the errors, the flags are cleared by SR then DR
+void UsartDmaPortAdapterIRQ(xPortT* port)
+{
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+	USART_TypeDef* usart = adapter->Handle->Instance;
+	uint32_t status = usart->SR;
+
+	if (status & (USART_SR_IDLE | USART_SR_ORE | USART_SR_NE | USART_SR_FE | USART_SR_PE))
+	{
+		(void)usart->DR;
+
+		//another driver on the bus: the receiver hears the line only if RE is not tied to DE
+		if (adapter->Rs485.EchoCheck && adapter->Rs485.IsTransmitting
+			&& (status & (USART_SR_NE | USART_SR_FE | USART_SR_PE)))
+		{
+			adapter->Statistic.Collisions++;
+		}
+	}
+
+	if ((status & USART_SR_TC) && (usart->CR1 & USART_CR1_TCIE))
+	{
+		CLEAR_BIT(usart->CR1, USART_CR1_TCIE);
+
+		//a running transfer enables TC again on its complete
+		if (privateTxIsIdle(adapter))
+		{
+			if (adapter->Rs485.GuardTimer)
+			{
+				privateOnePulseStart(adapter->Rs485.GuardTimer->Instance);
+			}
+			else
+			{
+				privateRs485Release(adapter);
+			}
+		}
+	}
+
+	if (status & USART_SR_IDLE)
+	{
+		if (adapter->Framing.SilenceTimer)
+		{
+			//the task is woken by the frame end, a byte before it continues the frame
+			adapter->Framing.IdleIndex = privateGetRxWriteIndex(adapter);
+			privateOnePulseStart(adapter->Framing.SilenceTimer->Instance);
+		}
+		else
+		{
+			privateRxEvent(adapter);
+		}
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief update of the guard timer: the end of the guard time after TC
+void UsartDmaPortAdapterGuardIRQ(xPortT* port)
+{
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+	TIM_TypeDef* timer = adapter->Rs485.GuardTimer->Instance;
+
+	if (!(timer->SR & TIM_SR_UIF))
+	{
+		return;
+	}
+
+	timer->SR = ~TIM_SR_UIF;
+
+	if (adapter->Rs485.IsTransmitting && privateTxIsIdle(adapter))
+	{
+		privateRs485Release(adapter);
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief update of the silence timer: the line stayed quiet since the idle line, the frame is complete
+void UsartDmaPortAdapterSilenceIRQ(xPortT* port)
+{
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+	UsartDmaFramingT* framing = &adapter->Framing;
+
+	if (!framing->SilenceTimer || !(framing->SilenceTimer->Instance->SR & TIM_SR_UIF))
+	{
+		return;
+	}
+
+	framing->SilenceTimer->Instance->SR = ~TIM_SR_UIF;
+
+	if (privateGetRxWriteIndex(adapter) != framing->IdleIndex)
+	{
+		return;
+	}
+
+	if ((uint8_t)(framing->EndsIn - framing->EndsOut) >= USART_DMA_FRAME_ENDS_COUNT)
+	{
+		adapter->Statistic.FrameLosses++;
+		return;
+	}
+
+	framing->Ends[framing->EndsIn & (USART_DMA_FRAME_ENDS_COUNT - 1)] = framing->IdleIndex;
+	framing->EndsIn++;
+
+	privateRxEvent(adapter);
+}
+//------------------------------------------------------------------------------
+/// @brief 0 - the port handler polls the ring from the super-loop
+void UsartDmaPortAdapterSetRxTask(xPortT* port, TaskHandle_t task)
+{
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+
+	adapter->RxTask = task;
+}
+//------------------------------------------------------------------------------
+/// @brief called by the owning task after the notification
+void UsartDmaPortAdapterReceive(xPortT* port)
+{
+	privateDispatch(port);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the receive goes to the listener frame by frame instead of RxReceiver.
+ * The silence is counted by the timer from the idle line, one character after the last stop bit.
+ * The listener is set before the timer: the owning task may be receiving meanwhile,
+ * its first frame may start in the middle.
+ */
+xResult UsartDmaPortAdapterSetFraming(xPortT* port, UsartDmaFramingInitT* init)
+{
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+	UsartDmaFramingT* framing = &adapter->Framing;
+	UART_InitTypeDef* usart = &adapter->Handle->Init;
+
+	if (!init || !init->SilenceTimer || !init->Listener)
+	{
+		return xResultError;
+	}
+
+	uint32_t bits = 1 + (usart->WordLength == UART_WORDLENGTH_9B ? 9 : 8) + (usart->StopBits == UART_STOPBITS_2 ? 2 : 1);
+	uint32_t character = (uint64_t)bits * 1000000000 / usart->BaudRate;
+	uint32_t silence = init->SilenceUs * 1000;
+
+	privateOnePulseInit(init->SilenceTimer->Instance, silence > character * 2 ? silence - character : character);
+
+	framing->Size = 0;
+	framing->IsOverflow = false;
+	framing->EndsIn = 0;
+	framing->EndsOut = 0;
+
+	framing->Context = init->Context;
+	framing->Listener = init->Listener;
+	framing->SilenceTimer = init->SilenceTimer;
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief contiguous space of the TX ring, a frame is built there without a copy.
+ * Called between xPortStartTransmission and xPortEndTransmission.
+ * @return 0 - no room for the size in one piece
+ */
+uint8_t* UsartDmaPortAdapterTxReserve(xPortT* port, uint16_t size)
+{
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+	uint8_t* data;
+
+	return UsartDmaTxRingReserve(&adapter->TxRing, &data) >= size ? data : NULL;
+}
+//------------------------------------------------------------------------------
+void UsartDmaPortAdapterTxCommit(xPortT* port, uint16_t size)
+{
+	UsartDmaPortAdapterT* adapter = (UsartDmaPortAdapterT*)port->Adapter.Content;
+
+	UsartDmaTxRingCommit(&adapter->TxRing, size);
+	privateKick(adapter);
+}
+//==============================================================================
+//initializations:
+
+static xPortAdapterInterfaceT privatePortInterface =
+{
+	.Handler = (xPortAdapterHandlerT)PrivateHandler,
+
+	.RequestListener = (xPortAdapterRequestListenerT)PrivateRequestListener,
+	.EventListener = (xPortAdapterEventListenerT)PrivateEventListener,
+
+	.Transmit = (xPortAdapterTransmitActionT)PrivateTransmit,
+	.Receive = (xPortAdapterReceiveActionT)PrivateReceive
+};
+//------------------------------------------------------------------------------
+xResult UsartDmaPortAdapterInit(xPortT* port, UsartDmaPortAdapterT* adapter, UsartDmaPortAdapterInitT* init)
+{
+	if (!port || !adapter || !init || !init->Handle || !init->TxDma || !init->RxDma)
+	{
+		return xResultError;
+	}
+
+	USART_TypeDef* usart = init->Handle->Instance;
+
+	//the byte interrupts of the previous adapter
+	CLEAR_BIT(usart->CR1, USART_CR1_RXNEIE | USART_CR1_TXEIE | USART_CR1_TCIE | USART_CR1_IDLEIE);
+
+	privateStopStream(init->RxDma);
+	privateStopStream(init->TxDma);
+
+	memset(&adapter->Statistic, 0, sizeof(adapter->Statistic));
+	memset(&adapter->Rs485, 0, sizeof(adapter->Rs485));
+	memset(&adapter->Framing, 0, sizeof(adapter->Framing));
+	memset(&adapter->Cobs, 0, sizeof(adapter->Cobs));
+
+	adapter->Handle = init->Handle;
+	adapter->TxDma = init->TxDma;
+	adapter->RxDma = init->RxDma;
+
+	UsartDmaTxRingInit(&adapter->TxRing, init->TxBuffer, init->TxBufferSizeMask);
+
+	adapter->RxCircleBuffer = init->RxCircleBuffer;
+	adapter->RxCircleBufferSizeMask = init->RxCircleBufferSizeMask;
+	adapter->RxPosition = 0;
+	adapter->RxTask = NULL;
+	adapter->RxEventStamp = 0;
+
+	xRxReceiverInit(&adapter->RxReceiver,
+					port,
+					PrivateRxReceiverEventListener,
+					init->RxBuffer,
+					init->RxBufferSize);
+
+	if (init->CobsBuffer)
+	{
+		CobsPortInitT cobsInit =
+		{
+			.Text = &adapter->RxReceiver,
+			.Handler = init->CobsHandler,
+			.Crc = init->CobsCrc,
+			.Buffer = init->CobsBuffer,
+			.BufferSize = init->CobsBufferSize,
+			.ReplyBuffer = init->CobsReplyBuffer,
+			.ReplyBufferSize = init->CobsReplyBufferSize
+		};
+
+		CobsPortInit(&adapter->Cobs, port, &cobsInit);
+	}
+
+	if (init->DePort)
+	{
+		adapter->Rs485.DePort = init->DePort;
+		adapter->Rs485.DePin = init->DePin;
+		adapter->Rs485.EchoCheck = init->EchoCheck;
+
+		init->DePort->BSRR = (uint32_t)init->DePin << 16;
+
+		if (init->GuardTimer && init->GuardBits)
+		{
+			adapter->Rs485.GuardTimer = init->GuardTimer;
+			privateOnePulseInit(init->GuardTimer->Instance, (uint64_t)init->GuardBits * 1000000000 / init->Handle->Init.BaudRate);
+		}
+	}
+
+	adapter->TransactionMutex = xSemaphoreCreateMutex();
+	adapter->TxSemaphore = xSemaphoreCreateBinary();
+
+	init->TxDma->Parent = port;
+	init->TxDma->XferCpltCallback = privateTxComplete;
+	init->TxDma->XferErrorCallback = privateTxError;
+	init->TxDma->XferHalfCpltCallback = NULL;
+
+	init->RxDma->Parent = port;
+	init->RxDma->XferCpltCallback = privateRxTransferEvent;
+	init->RxDma->XferHalfCpltCallback = privateRxTransferEvent;
+	init->RxDma->XferErrorCallback = privateRxError;
+
+	port->Adapter.Description = nameof(UsartDmaPortAdapterT);
+	port->Adapter.Content = adapter;
+	port->Adapter.Interface = &privatePortInterface;
+
+	//the idle line calls the FreeRTOS API: it may not stay above configMAX_SYSCALL_INTERRUPT_PRIORITY
+	HAL_NVIC_SetPriority(init->Irq, USART_DMA_IRQ_PRIORITY, 0);
+
+	HAL_DMA_Start_IT(init->RxDma, (uint32_t)&usart->DR, (uint32_t)init->RxCircleBuffer, init->RxCircleBufferSizeMask + 1);
+
+	(void)usart->SR;
+	(void)usart->DR;
+
+	SET_BIT(usart->CR3, USART_CR3_DMAR | USART_CR3_DMAT | USART_CR3_EIE);
+	SET_BIT(usart->CR1, USART_CR1_IDLEIE);
+
+	return xResultAccept;
+}
+//==============================================================================
@@ -0,0 +1,202 @@
+//==============================================================================
+//header:
+
+#ifndef _USART_DMA_PORT_ADAPTER_H_
+#define _USART_DMA_PORT_ADAPTER_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+#include "Common/xRxReceiver.h"
+#include "Abstractions/xPort/xPort.h"
+#include "UsartDma/UsartDmaTx.h"
+#include "Cobs/CobsPort.h"
+#include "main.h"
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+//==============================================================================
+//defines:
+
+#define USART_DMA_RS485_ECHOES_COUNT 4 //frames between two dispatches of the receive, power of 2
+#define USART_DMA_FRAME_ENDS_COUNT 4 //power of 2
+//==============================================================================
+//types:
+
+typedef struct
+{
+	uint32_t TxBytes;
+	uint32_t Transfers; //DMA transfers started, one per contiguous span of the ring
+	uint32_t TxWaits; //writes that waited for free space in the ring
+	uint32_t TxErrors;
+
+	uint32_t RxEvents; //idle line, half and full transfer interrupts
+	uint32_t RxDispatches; //RxReceiver calls of the owning task after an event
+	uint32_t RxDelayCycles; //from the event to the end of the dispatch, the response included
+	uint32_t RxDelayMaxCycles;
+	uint32_t RxErrors;
+
+	uint32_t Frames; //RS485: DE assertions
+	uint32_t Collisions; //RS485 with EchoCheck: echo different from the frame or receive errors while DE is asserted, 0 otherwise
+	uint32_t EchoLosses; //RS485: echo windows dropped, the receive was not dispatched in time
+
+	uint32_t RxFrames; //framing: frames given to the listener
+	uint32_t FrameOverflows; //framing: frames longer than the RxReceiver buffer
+	uint32_t FrameLosses; //framing: ends dropped, the receive was not dispatched in time
+
+} UsartDmaPortStatisticT;
+//------------------------------------------------------------------------------
+/// @brief the bytes received while DE was asserted, checked against the frame by the receive
+typedef struct
+{
+	uint16_t Start;
+	uint16_t End;
+	uint16_t Size; //of the frame
+	uint16_t Hash; //of the frame
+
+} UsartDmaEchoT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	GPIO_TypeDef* DePort; //0 - RS232
+	uint16_t DePin;
+
+	TIM_HandleTypeDef* GuardTimer; //one pulse from TC to the release of DE, 0 - released on TC
+	bool EchoCheck; //RE is not tied to DE: the own bytes come back and are compared
+
+	volatile bool IsTransmitting; //DE is asserted
+
+	uint16_t FrameStart; //RX write index on the assertion of DE
+	uint16_t FrameSize;
+	uint16_t FrameHash;
+
+	UsartDmaEchoT Echoes[USART_DMA_RS485_ECHOES_COUNT];
+	volatile uint8_t EchoesIn;
+	uint8_t EchoesOut;
+
+} UsartDmaRs485T;
+//------------------------------------------------------------------------------
+typedef void (*UsartDmaFrameListenerT)(xPortT* port, uint8_t* frame, uint16_t size, void* context);
+typedef void (*UsartDmaLineListenerT)(xPortT* port, RxDataPacketT* line);
+//------------------------------------------------------------------------------
+/**
+ * @brief the receive is cut into frames by the silence of the line: the idle line starts a one
+ * pulse for the rest of the silence, the frame ends if no byte came in the meantime
+ */
+typedef struct
+{
+	TIM_HandleTypeDef* SilenceTimer; //0 - the receive goes to RxReceiver
+	UsartDmaFrameListenerT Listener;
+	void* Context;
+
+	uint16_t IdleIndex; //RX write index on the last idle line
+	uint16_t Size; //of the frame collected in the RxReceiver buffer
+	bool IsOverflow;
+
+	uint16_t Ends[USART_DMA_FRAME_ENDS_COUNT];
+	volatile uint8_t EndsIn;
+	uint8_t EndsOut;
+
+} UsartDmaFramingT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	TIM_HandleTypeDef* SilenceTimer;
+	uint32_t SilenceUs; //from the last stop bit to the frame end, a byte received later starts the next frame
+
+	UsartDmaFrameListenerT Listener;
+	void* Context;
+
+} UsartDmaFramingInitT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	xPortAdapterBaseT Base;
+
+	UART_HandleTypeDef* Handle;
+	DMA_HandleTypeDef* TxDma;
+	DMA_HandleTypeDef* RxDma;
+
+	UsartDmaTxRingT TxRing;
+
+	uint8_t* RxCircleBuffer;
+	uint16_t RxCircleBufferSizeMask;
+	uint16_t RxPosition; //next byte of RxCircleBuffer to give to RxReceiver
+
+	xRxReceiverT RxReceiver;
+	CobsPortT Cobs; //binary frames among the text lines, Port 0 - text only
+	UsartDmaLineListenerT LineListener; //takes the lines instead of the listener of the port, 0 - the port
+
+	TaskHandle_t RxTask; //notified by the receive events, 0 - RxReceiver is polled by the port handler
+	volatile uint32_t RxEventStamp; //DWT of the first event not dispatched yet, 0 - none
+
+	UsartDmaRs485T Rs485;
+	UsartDmaFramingT Framing;
+
+	SemaphoreHandle_t TransactionMutex;
+	SemaphoreHandle_t TxSemaphore; //given on the transfer complete
+
+	UsartDmaPortStatisticT Statistic;
+
+} UsartDmaPortAdapterT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	UART_HandleTypeDef* Handle;
+	DMA_HandleTypeDef* TxDma;
+	DMA_HandleTypeDef* RxDma;
+	IRQn_Type Irq; //moved to USART_DMA_IRQ_PRIORITY, the events use the FreeRTOS API
+
+	uint8_t* TxBuffer;
+	uint16_t TxBufferSizeMask;
+
+	uint8_t* RxCircleBuffer;
+	uint16_t RxCircleBufferSizeMask;
+
+	uint8_t* RxBuffer;
+	uint16_t RxBufferSize;
+
+	uint8_t* CobsBuffer; //the largest payload of a frame and its CRC, 0 - text only
+	uint16_t CobsBufferSize;
+	uint8_t* CobsReplyBuffer;
+	uint16_t CobsReplyBufferSize;
+	CobsCrcT CobsCrc;
+	CobsPortHandlerT CobsHandler;
+
+	GPIO_TypeDef* DePort; //RS485 driver enable, 0 - RS232
+	uint16_t DePin;
+	TIM_HandleTypeDef* GuardTimer; //0 - DE is released on TC
+	uint16_t GuardBits; //bit times from the end of the stop bit to the release of DE
+	bool EchoCheck;
+
+} UsartDmaPortAdapterInitT;
+//==============================================================================
+//functions:
+
+/**
+ * @brief takes over the USART of the port: the previous adapter and its interrupts are
+ * replaced, the xPortT object and its API stay the same
+ */
+xResult UsartDmaPortAdapterInit(xPortT* port, UsartDmaPortAdapterT* adapter, UsartDmaPortAdapterInitT* init);
+
+void UsartDmaPortAdapterIRQ(xPortT* port);
+void UsartDmaPortAdapterGuardIRQ(xPortT* port);
+void UsartDmaPortAdapterSilenceIRQ(xPortT* port);
+
+void UsartDmaPortAdapterSetRxTask(xPortT* port, TaskHandle_t task);
+void UsartDmaPortAdapterReceive(xPortT* port);
+
+xResult UsartDmaPortAdapterSetFraming(xPortT* port, UsartDmaFramingInitT* init);
+
+uint8_t* UsartDmaPortAdapterTxReserve(xPortT* port, uint16_t size);
+void UsartDmaPortAdapterTxCommit(xPortT* port, uint16_t size);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_USART_DMA_PORT_ADAPTER_H_
@@ -0,0 +1,663 @@
+//==============================================================================
+//header:
+
+
+//==============================================================================
+//includes:
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "UsartDma-Component.h"
+#include "Components.h"
+#include "TerminalCommands/TerminalCommands.h"
+//==============================================================================
+//defines:
+
+#define USART_DMA_LOAD_BLOCK_SIZE 64
+
+#if USART_DMA_COBS_ENABLE == 1 && CRC_ENABLE != 1
+#error "the COBS frames are checked by CRC-32 of the CRC component"
+#endif
+//==============================================================================
+//variables:
+
+static TaskHandle_t taskHandle;
+static StaticTask_t taskBuffer;
+static StackType_t taskStack[USART_DMA_TASK_STACK_SIZE] USART_DMA_COMPONENT_MAIN_TASK_STACK_SECTION;
+
+static int RTOS_UsartDmaTaskStackWaterMark;
+
+#if USART_DMA_COBS_ENABLE == 1
+static uint32_t privateCobsCrc(const void* data, uint32_t size);
+#endif
+
+#if SERIAL3_ENABLE == 1 && SERIAL3_TX_DMA_ENABLE == 1
+static uint8_t privateSerial3TxBuffer[SERIAL3_TX_CIRCLE_BUF_SIZE_MASK + 1] SERIAL3_TX_CIRCLE_BUF_MEM_SECTION;
+static uint8_t privateSerial3RxCircleBuffer[SERIAL3_RX_CIRCLE_BUF_SIZE_MASK + 1] SERIAL3_RX_CIRCLE_BUF_MEM_SECTION;
+static uint8_t privateSerial3RxBuffer[SERIAL3_RX_OBJECT_BUF_SIZE] SERIAL3_RX_BUFFER_MEM_SECTION;
+
+#if USART_DMA_COBS_ENABLE == 1
+static uint8_t privateSerial3CobsBuffer[USART_DMA_COBS_BUFFER_SIZE] SERIAL3_RX_BUFFER_MEM_SECTION;
+static uint8_t privateSerial3CobsReplyBuffer[USART_DMA_COBS_REPLY_BUFFER_SIZE] SERIAL3_RX_BUFFER_MEM_SECTION;
+#endif
+#endif
+
+#if SERIAL6_ENABLE == 1 && SERIAL6_TX_DMA_ENABLE == 1
+static uint8_t privateSerial6TxBuffer[SERIAL6_TX_CIRCLE_BUF_SIZE_MASK + 1] SERIAL6_TX_CIRCLE_BUF_MEM_SECTION;
+static uint8_t privateSerial6RxCircleBuffer[SERIAL6_RX_CIRCLE_BUF_SIZE_MASK + 1] SERIAL6_RX_CIRCLE_BUF_MEM_SECTION;
+static uint8_t privateSerial6RxBuffer[SERIAL6_RX_OBJECT_BUF_SIZE] SERIAL6_RX_BUFFER_MEM_SECTION;
+
+#if USART_DMA_COBS_ENABLE == 1
+static uint8_t privateSerial6CobsBuffer[USART_DMA_COBS_BUFFER_SIZE] SERIAL6_RX_BUFFER_MEM_SECTION;
+static uint8_t privateSerial6CobsReplyBuffer[USART_DMA_COBS_REPLY_BUFFER_SIZE] SERIAL6_RX_BUFFER_MEM_SECTION;
+#endif
+#endif
+
+/// @brief the serials with a TX DMA stream, Handle is 0 for the others
+static UsartDmaPortAdapterInitT privateAdapterInits[SERIAL_PORTS_COUNT] =
+{
+#if SERIAL3_ENABLE == 1 && SERIAL3_TX_DMA_ENABLE == 1
+	[SERIAL3] =
+	{
+		.Handle = &SERIAL3_HANDLE,
+		.TxDma = &SERIAL3_TX_DMA,
+		.RxDma = &SERIAL3_RX_DMA,
+		.Irq = SERIAL3_IRQ,
+		.TxBuffer = privateSerial3TxBuffer,
+		.TxBufferSizeMask = SERIAL3_TX_CIRCLE_BUF_SIZE_MASK,
+		.RxCircleBuffer = privateSerial3RxCircleBuffer,
+		.RxCircleBufferSizeMask = SERIAL3_RX_CIRCLE_BUF_SIZE_MASK,
+		.RxBuffer = privateSerial3RxBuffer,
+		.RxBufferSize = SERIAL3_RX_OBJECT_BUF_SIZE,
+#if USART_DMA_COBS_ENABLE == 1
+		.CobsBuffer = privateSerial3CobsBuffer,
+		.CobsBufferSize = USART_DMA_COBS_BUFFER_SIZE,
+		.CobsReplyBuffer = privateSerial3CobsReplyBuffer,
+		.CobsReplyBufferSize = USART_DMA_COBS_REPLY_BUFFER_SIZE,
+		.CobsCrc = privateCobsCrc,
+		.CobsHandler = TerminalCommandsReceive
+#endif
+	},
+#endif
+
+#if SERIAL6_ENABLE == 1 && SERIAL6_TX_DMA_ENABLE == 1
+	[SERIAL6] =
+	{
+		.Handle = &SERIAL6_HANDLE,
+		.TxDma = &SERIAL6_TX_DMA,
+		.RxDma = &SERIAL6_RX_DMA,
+		.Irq = SERIAL6_IRQ,
+		.TxBuffer = privateSerial6TxBuffer,
+		.TxBufferSizeMask = SERIAL6_TX_CIRCLE_BUF_SIZE_MASK,
+		.RxCircleBuffer = privateSerial6RxCircleBuffer,
+		.RxCircleBufferSizeMask = SERIAL6_RX_CIRCLE_BUF_SIZE_MASK,
+		.RxBuffer = privateSerial6RxBuffer,
+		.RxBufferSize = SERIAL6_RX_OBJECT_BUF_SIZE,
+#if USART_DMA_COBS_ENABLE == 1
+		.CobsBuffer = privateSerial6CobsBuffer,
+		.CobsBufferSize = USART_DMA_COBS_BUFFER_SIZE,
+		.CobsReplyBuffer = privateSerial6CobsReplyBuffer,
+		.CobsReplyBufferSize = USART_DMA_COBS_REPLY_BUFFER_SIZE,
+		.CobsCrc = privateCobsCrc,
+		.CobsHandler = TerminalCommandsReceive
+#endif
+	},
+#endif
+};
+
+static xPortT* privatePorts[SERIAL_PORTS_COUNT]; //attached to the adapters
+
+#if USART_DMA_RS485_ENABLE == 1
+static uint8_t privateRs485TxBuffer[USART_DMA_RS485_TX_BUFFER_SIZE_MASK + 1] USART_DMA_RS485_MEM_SECTION;
+static uint8_t privateRs485RxCircleBuffer[USART_DMA_RS485_RX_CIRCLE_BUFFER_SIZE_MASK + 1];
+static uint8_t privateRs485RxBuffer[USART_DMA_RS485_RX_BUFFER_SIZE] USART_DMA_RS485_MEM_SECTION;
+
+xPortT Rs485Port USART_DMA_RS485_MEM_SECTION = { 0 };
+UsartDmaPortAdapterT UsartDmaRs485Adapter;
+#endif
+
+static UsartDmaLoadRequestT privateLoadRequest;
+static volatile uint8_t privateLoadIsPending;
+
+static uint8_t privateLoadBlock[USART_DMA_LOAD_BLOCK_SIZE];
+static char privateReportBuffer[128];
+
+UsartDmaPortAdapterT UsartDmaAdapters[SERIAL_PORTS_COUNT];
+UsartDmaIrqStatisticT UsartDmaIrqStatistic[SERIAL_PORTS_COUNT];
+//==============================================================================
+//functions:
+
+#if USART_DMA_COBS_ENABLE == 1
+/// @brief the CRC-32 trailer of the COBS frames
+static uint32_t privateCobsCrc(const void* data, uint32_t size)
+{
+	return CrcComponentCalculate(CrcVariant32, data, size);
+}
+//------------------------------------------------------------------------------
+#endif
+static void privateReport(const char* format, ...)
+{
+	xPortT* port = privateLoadRequest.ReportPort;
+
+	if (!port)
+	{
+		return;
+	}
+
+	va_list args;
+	va_start(args, format);
+	vsnprintf(privateReportBuffer, sizeof(privateReportBuffer), format, args);
+	va_end(args);
+
+	xPortStartTransmission(port);
+	xPortTransmitString(port, privateReportBuffer);
+	xPortEndTransmission(port);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief USART interrupt of the serial: the DMA adapter when the port is attached,
+ * the xUSART driver otherwise. The cycles are counted for both.
+ */
+void UsartDmaComponentIRQ(uint8_t serial, xUSART_Numbers usart)
+{
+	uint32_t cycles = DWT->CYCCNT;
+
+	if (privatePorts[serial])
+	{
+		UsartDmaPortAdapterIRQ(privatePorts[serial]);
+	}
+	else
+	{
+		xUSART_IRQ_Handler(usart);
+	}
+
+	UsartDmaIrqStatistic[serial].UsartIrqs++;
+	UsartDmaIrqStatistic[serial].Cycles += DWT->CYCCNT - cycles;
+}
+//------------------------------------------------------------------------------
+void UsartDmaComponentTxDmaIRQ(uint8_t serial)
+{
+	uint32_t cycles = DWT->CYCCNT;
+
+	HAL_DMA_IRQHandler(privateAdapterInits[serial].TxDma);
+
+	UsartDmaIrqStatistic[serial].DmaIrqs++;
+	UsartDmaIrqStatistic[serial].Cycles += DWT->CYCCNT - cycles;
+}
+//------------------------------------------------------------------------------
+#if USART_DMA_RS485_ENABLE == 1
+void UsartDmaComponentRs485IRQ()
+{
+	UsartDmaPortAdapterIRQ(&Rs485Port);
+}
+//------------------------------------------------------------------------------
+void UsartDmaComponentRs485TxDmaIRQ()
+{
+	HAL_DMA_IRQHandler(&USART_DMA_RS485_TX_DMA);
+}
+//------------------------------------------------------------------------------
+void UsartDmaComponentRs485GuardIRQ()
+{
+	UsartDmaPortAdapterGuardIRQ(&Rs485Port);
+}
+#endif
+//------------------------------------------------------------------------------
+/**
+ * @brief moves the port to the DMA adapter of the serial, the users of the port are not changed,
+ * its lines go through the terminal commands before the listener of the port
+ */
+xResult UsartDmaComponentAttach(xPortT* port, uint8_t serial)
+{
+	if (!port || serial >= SERIAL_PORTS_COUNT || !privateAdapterInits[serial].Handle)
+	{
+		return xResultError;
+	}
+
+	if (UsartDmaPortAdapterInit(port, &UsartDmaAdapters[serial], &privateAdapterInits[serial]) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	UsartDmaAdapters[serial].LineListener = TerminalCommandsReceive;
+	privatePorts[serial] = port;
+
+#if USART_DMA_RX_EVENTS == 1
+	UsartDmaPortAdapterSetRxTask(port, taskHandle);
+#endif
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/// @return the port of the serial: attached or the debug port of the xUSART driver
+xPortT* UsartDmaComponentGetPort(uint8_t serial)
+{
+	if (serial >= SERIAL_PORTS_COUNT)
+	{
+		return NULL;
+	}
+
+	if (privatePorts[serial])
+	{
+		return privatePorts[serial];
+	}
+
+	return serial == DEBUG_SERIAL_PORT_DEFAULT_NUMBER ? &SerialPort : NULL;
+}
+//------------------------------------------------------------------------------
+static uint32_t privateGetTxDataSize(xPortT* port)
+{
+	uint32_t size = 0;
+	uint32_t free = 0;
+
+	xPortRequestListener(port, xPortAdapterRequestGetTxBufferSize, 0, &size);
+	xPortRequestListener(port, xPortAdapterRequestGetTxBufferFreeSize, 0, &free);
+
+	return size - free;
+}
+//------------------------------------------------------------------------------
+/// @brief the receive events of the attached ports: the lines and their responses are handled here
+static void privateReceive()
+{
+	for (uint8_t serial = 0; serial < SERIAL_PORTS_COUNT; serial++)
+	{
+		if (privatePorts[serial])
+		{
+			UsartDmaPortAdapterReceive(privatePorts[serial]);
+		}
+	}
+
+#if USART_DMA_RS485_ENABLE == 1
+	UsartDmaPortAdapterReceive(&Rs485Port);
+#endif
+}
+//------------------------------------------------------------------------------
+static void privateLoadRun()
+{
+	UsartDmaLoadRequestT* request = &privateLoadRequest;
+	xPortT* port = UsartDmaComponentGetPort(request->Serial);
+	UsartDmaIrqStatisticT* statistic = &UsartDmaIrqStatistic[request->Serial];
+
+	if (!port)
+	{
+		privateReport("[usart-load] the port of the serial is not available\r");
+		return;
+	}
+
+	for (uint8_t i = 0; i < sizeof(privateLoadBlock); i++)
+	{
+		privateLoadBlock[i] = i < sizeof(privateLoadBlock) - 1 ? '0' + i % 64 : '\n';
+	}
+
+	UsartDmaIrqStatisticT start = *statistic;
+	uint32_t startCycles = DWT->CYCCNT;
+	uint32_t startTime = xSystemGetTime();
+	uint32_t sent = 0;
+
+	while (sent < request->Size && xSystemGetTime() - startTime < USART_DMA_LOAD_TIMEOUT)
+	{
+		uint32_t size = request->Size - sent;
+
+		if (size > sizeof(privateLoadBlock))
+		{
+			size = sizeof(privateLoadBlock);
+		}
+
+		xPortStartTransmission(port);
+		xPortTransmitData(port, privateLoadBlock, size);
+		xPortEndTransmission(port);
+
+		sent += size;
+
+		//the task owns the receive of the attached ports, it is not stopped by the load
+		privateReceive();
+	}
+
+	//the last bytes of the ring
+	while (privateGetTxDataSize(port) && xSystemGetTime() - startTime < USART_DMA_LOAD_TIMEOUT)
+	{
+		vTaskDelay(1);
+		privateReceive();
+	}
+
+	uint32_t cycles = DWT->CYCCNT - startCycles;
+	uint32_t duration = xSystemGetTime() - startTime;
+	uint32_t irqs = statistic->UsartIrqs - start.UsartIrqs + statistic->DmaIrqs - start.DmaIrqs;
+	uint32_t irqCycles = statistic->Cycles - start.Cycles;
+
+	//permille of the CPU spent in the interrupts of the serial
+	uint32_t load = cycles ? (uint64_t)irqCycles * 1000 / cycles : 0;
+
+	privateReport("[usart-load] %s: %lu B in %lu ms, %lu B/s\r",
+					privatePorts[request->Serial] ? "dma" : "irq",
+					sent,
+					duration,
+					duration ? sent * 1000 / duration : 0);
+
+	privateReport("[usart-load] %lu irq, %lu irq/s, %lu cycles/irq, cpu %lu.%lu%%\r",
+					irqs,
+					duration ? irqs * 1000 / duration : 0,
+					irqs ? irqCycles / irqs : 0,
+					load / 10,
+					load % 10);
+
+	if (privatePorts[request->Serial])
+	{
+		UsartDmaPortStatisticT* adapter = &UsartDmaAdapters[request->Serial].Statistic;
+
+		privateReport("[usart-load] transfers %lu, waits %lu, errors %lu\r",
+						adapter->Transfers,
+						adapter->TxWaits,
+						adapter->TxErrors);
+	}
+}
+//------------------------------------------------------------------------------
+static void privateTask(void* arg)
+{
+	while (true)
+	{
+		RTOS_UsartDmaTaskStackWaterMark = uxTaskGetStackHighWaterMark(NULL);
+
+		//notified by the idle line, half and full transfer interrupts of the attached ports
+		ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(USART_DMA_TASK_PERIOD));
+
+		privateReceive();
+
+		if (privateLoadIsPending)
+		{
+			privateLoadRun();
+			privateLoadIsPending = false;
+		}
+	}
+}
+//------------------------------------------------------------------------------
+xResult UsartDmaComponentLoadStart(UsartDmaLoadRequestT* request)
+{
+	if (!request || request->Serial >= SERIAL_PORTS_COUNT)
+	{
+		return xResultError;
+	}
+
+	if (privateLoadIsPending)
+	{
+		return xResultBusy;
+	}
+
+	privateLoadRequest = *request;
+
+	if (!privateLoadRequest.Size)
+	{
+		privateLoadRequest.Size = USART_DMA_LOAD_DEFAULT_SIZE;
+	}
+
+	privateLoadIsPending = true;
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+/// @return SERIALx of the USART number, SERIAL_PORTS_COUNT - the serial is disabled
+static uint8_t privateGetSerial(uint32_t number)
+{
+	switch (number)
+	{
+#if SERIAL1_ENABLE == 1
+		case 1: return SERIAL1;
+#endif
+#if SERIAL2_ENABLE == 1
+		case 2: return SERIAL2;
+#endif
+#if SERIAL3_ENABLE == 1
+		case 3: return SERIAL3;
+#endif
+#if SERIAL6_ENABLE == 1
+		case 6: return SERIAL6;
+#endif
+		default: return SERIAL_PORTS_COUNT;
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief "usart-rx [-s usart]": the receive events of the serial and the delay from the event
+ * to the end of its dispatch, the statistic is cleared after the report
+ */
+static xResult privateRxCommand(xPortT* port, TerminalCommandArgumentsT* arguments)
+{
+	if (TerminalCommandCheckOptions(arguments, "s", NULL) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	uint8_t serial = privateGetSerial(TerminalCommandGetNumber(arguments, 's', DEBUG_SERIAL_PORT_DEFAULT_NUMBER));
+	char line[128];
+
+	if (serial >= SERIAL_PORTS_COUNT || !privatePorts[serial])
+	{
+		snprintf(line, sizeof(line), "[usart-rx] the serial is not attached\r");
+	}
+	else
+	{
+		UsartDmaPortStatisticT* statistic = &UsartDmaAdapters[serial].Statistic;
+		uint32_t cyclesPerUs = SystemCoreClock / 1000000;
+		uint32_t dispatches = statistic->RxDispatches;
+
+		snprintf(line, sizeof(line), "[usart-rx] %s: events %lu, dispatches %lu, delay avg %lu us, max %lu us, errors %lu\r",
+					UsartDmaAdapters[serial].RxTask ? "task" : "poll",
+					statistic->RxEvents,
+					dispatches,
+					dispatches ? statistic->RxDelayCycles / dispatches / cyclesPerUs : 0,
+					statistic->RxDelayMaxCycles / cyclesPerUs,
+					statistic->RxErrors);
+
+		statistic->RxEvents = 0;
+		statistic->RxDispatches = 0;
+		statistic->RxDelayCycles = 0;
+		statistic->RxDelayMaxCycles = 0;
+	}
+
+	xPortStartTransmission(port);
+	xPortTransmitString(port, line);
+	xPortEndTransmission(port);
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+#if USART_DMA_RS485_ENABLE == 1
+/**
+ * @brief "rs485 [-t text]": the text is sent as a frame, the statistic of the bus is reported
+ * and cleared
+ */
+static xResult privateRs485Command(xPortT* port, TerminalCommandArgumentsT* arguments)
+{
+	if (TerminalCommandCheckOptions(arguments, "t", NULL) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	char line[128];
+	char* text = TerminalCommandGetOption(arguments, 't');
+
+	if (text)
+	{
+		xPortStartTransmission(&Rs485Port);
+		xPortTransmitString(&Rs485Port, text);
+		xPortTransmitString(&Rs485Port, "\r");
+		xPortEndTransmission(&Rs485Port);
+	}
+
+	UsartDmaPortStatisticT* statistic = &UsartDmaRs485Adapter.Statistic;
+
+	if (UsartDmaRs485Adapter.Rs485.EchoCheck)
+	{
+		snprintf(line, sizeof(line), "[rs485] frames %lu, tx %lu B, collisions %lu, echo losses %lu, rx errors %lu\r",
+					statistic->Frames,
+					statistic->TxBytes,
+					statistic->Collisions,
+					statistic->EchoLosses,
+					statistic->RxErrors);
+	}
+	else
+	{
+		//RE is tied to DE: the receiver is off while transmitting, the collisions are not seen
+		snprintf(line, sizeof(line), "[rs485] frames %lu, tx %lu B, collisions not counted (no echo check), rx errors %lu\r",
+					statistic->Frames,
+					statistic->TxBytes,
+					statistic->RxErrors);
+	}
+
+	xPortStartTransmission(port);
+	xPortTransmitString(port, line);
+	xPortEndTransmission(port);
+
+	if (UsartDmaRs485Adapter.Framing.Listener)
+	{
+		snprintf(line, sizeof(line), "[rs485] rx frames %lu, frame overflows %lu, frame losses %lu\r",
+					statistic->RxFrames,
+					statistic->FrameOverflows,
+					statistic->FrameLosses);
+
+		xPortStartTransmission(port);
+		xPortTransmitString(port, line);
+		xPortEndTransmission(port);
+	}
+
+	statistic->Frames = 0;
+	statistic->TxBytes = 0;
+	statistic->Collisions = 0;
+	statistic->EchoLosses = 0;
+	statistic->RxErrors = 0;
+	statistic->RxFrames = 0;
+	statistic->FrameOverflows = 0;
+	statistic->FrameLosses = 0;
+
+	return xResultAccept;
+}
+#endif
+//------------------------------------------------------------------------------
+/**
+ * @brief "usart-load [-s usart] [-n bytes]": the debug serial by default
+ */
+static xResult privateLoadCommand(xPortT* port, TerminalCommandArgumentsT* arguments)
+{
+	if (TerminalCommandCheckOptions(arguments, "sn", NULL) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	UsartDmaLoadRequestT request = { 0 };
+	request.Serial = privateGetSerial(TerminalCommandGetNumber(arguments, 's', DEBUG_SERIAL_PORT_DEFAULT_NUMBER));
+	request.Size = TerminalCommandGetNumber(arguments, 'n', 0);
+	request.ReportPort = port;
+
+	return UsartDmaComponentLoadStart(&request);
+}
+//------------------------------------------------------------------------------
+static const TerminalCommandT privateCommands[] =
+{
+	{
+		.Name = "usart-load",
+		.Usage = "[-s usart] [-n bytes]",
+		.Handler = privateLoadCommand
+	},
+	{
+		.Name = "usart-rx",
+		.Usage = "[-s usart]",
+		.Handler = privateRxCommand
+	},
+#if USART_DMA_RS485_ENABLE == 1
+	{
+		.Name = "rs485",
+		.Usage = "[-t text]",
+		.Handler = privateRs485Command
+	},
+#endif
+};
+//==============================================================================
+//initialization:
+
+#if USART_DMA_RS485_ENABLE == 1
+/// @brief the lines of the bus are terminal requests, the responses go back over the bus
+static void privateRs485EventListener(ObjectBaseT* object, int selector, uint32_t description, void* arg)
+{
+	xPortT* port = (xPortT*)object;
+
+	switch (selector)
+	{
+		case xPortObjectEventRxFoundEndLine:
+			TerminalCommandsReceive(port, arg);
+			break;
+
+		case xPortObjectEventRxBufferIsFull:
+			TerminalReceiveData(port, arg);
+			break;
+
+		default: break;
+	}
+}
+//------------------------------------------------------------------------------
+static void privateRs485Init(void* parent)
+{
+	UsartDmaPortAdapterInitT adapterInit =
+	{
+		.Handle = &USART_DMA_RS485_HANDLE,
+		.TxDma = &USART_DMA_RS485_TX_DMA,
+		.RxDma = &USART_DMA_RS485_RX_DMA,
+		.Irq = USART_DMA_RS485_IRQ,
+
+		.TxBuffer = privateRs485TxBuffer,
+		.TxBufferSizeMask = USART_DMA_RS485_TX_BUFFER_SIZE_MASK,
+
+		.RxCircleBuffer = privateRs485RxCircleBuffer,
+		.RxCircleBufferSizeMask = USART_DMA_RS485_RX_CIRCLE_BUFFER_SIZE_MASK,
+
+		.RxBuffer = privateRs485RxBuffer,
+		.RxBufferSize = sizeof(privateRs485RxBuffer),
+
+		.DePort = USART_DMA_RS485_DE_PORT,
+		.DePin = USART_DMA_RS485_DE_PIN,
+		.GuardTimer = &USART_DMA_RS485_GUARD_TIMER,
+		.GuardBits = USART_DMA_RS485_GUARD_BITS,
+		.EchoCheck = USART_DMA_RS485_ECHO_CHECK
+	};
+
+	UsartDmaPortAdapterInit(&Rs485Port, &UsartDmaRs485Adapter, &adapterInit);
+
+	xPortInitT portInit =
+	{
+		.Parent = parent,
+		.EventListener = (void*)privateRs485EventListener
+	};
+
+	xPortInit(&Rs485Port, &portInit);
+
+#if USART_DMA_RX_EVENTS == 1
+	UsartDmaPortAdapterSetRxTask(&Rs485Port, taskHandle);
+#endif
+}
+#endif
+//------------------------------------------------------------------------------
+xResult UsartDmaComponentInit(void* parent)
+{
+	TerminalCommandsAdd(privateCommands, sizeof(privateCommands) / sizeof(privateCommands[0]));
+
+	//the task is the receive owner of the attached ports: created before them
+	taskHandle = xTaskCreateStatic(privateTask, // Function that implements the task.
+									"usart dma task", // Text name for the task.
+									USART_DMA_TASK_STACK_SIZE, // Number of indexes in the xStack array.
+									NULL, // Parameter passed into the task.
+									osPriorityAboveNormal, // Priority at which the task is created.
+									taskStack, // Array to use as the task's stack.
+									&taskBuffer);
+
+#if USART_DMA_ATTACH_DEBUG_PORT == 1
+	UsartDmaComponentAttach(&SerialPort, DEBUG_SERIAL_PORT_DEFAULT_NUMBER);
+#endif
+
+#if USART_DMA_RS485_ENABLE == 1
+	privateRs485Init(parent);
+#endif
+
+	return xResultAccept;
+}
+//==============================================================================
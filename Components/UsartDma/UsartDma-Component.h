@@ -0,0 +1,73 @@
+//==============================================================================
+//header:
+
+#ifndef _USART_DMA_COMPONENT_H_
+#define _USART_DMA_COMPONENT_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "UsartDma-ComponentConfig.h"
+#include "USART-Ports-Component-Config.h"
+#include "Adapters/STM32F4xx/UsartDmaPort-Adapter.h"
+//==============================================================================
+//types:
+
+/// @brief interrupts of one serial, the same for the DMA adapter and for the xUSART driver
+typedef struct
+{
+	uint32_t UsartIrqs;
+	uint32_t DmaIrqs;
+	uint32_t Cycles; //CPU cycles spent in both
+
+} UsartDmaIrqStatisticT;
+//------------------------------------------------------------------------------
+/// @brief bytes pushed through the port at its baud rate to measure the interrupt load
+typedef struct
+{
+	uint8_t Serial; //SERIALx
+	uint32_t Size; //0 - USART_DMA_LOAD_DEFAULT_SIZE
+
+	xPortT* ReportPort;
+
+} UsartDmaLoadRequestT;
+//==============================================================================
+//functions:
+
+xResult UsartDmaComponentInit(void* parent);
+
+xResult UsartDmaComponentAttach(xPortT* port, uint8_t serial);
+xPortT* UsartDmaComponentGetPort(uint8_t serial);
+
+void UsartDmaComponentIRQ(uint8_t serial, xUSART_Numbers usart);
+void UsartDmaComponentTxDmaIRQ(uint8_t serial);
+
+void UsartDmaComponentRs485IRQ();
+void UsartDmaComponentRs485TxDmaIRQ();
+void UsartDmaComponentRs485GuardIRQ();
+
+xResult UsartDmaComponentLoadStart(UsartDmaLoadRequestT* request);
+//==============================================================================
+//override:
+
+#define UsartDmaComponentHandler()
+#define UsartDmaComponentTimeSynchronization()
+//==============================================================================
+//export:
+
+extern UsartDmaPortAdapterT UsartDmaAdapters[SERIAL_PORTS_COUNT];
+extern UsartDmaIrqStatisticT UsartDmaIrqStatistic[SERIAL_PORTS_COUNT];
+
+#if USART_DMA_RS485_ENABLE == 1
+extern xPortT Rs485Port;
+extern UsartDmaPortAdapterT UsartDmaRs485Adapter;
+#endif
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_USART_DMA_COMPONENT_H_
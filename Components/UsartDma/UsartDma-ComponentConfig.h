@@ -0,0 +1,66 @@
+//==============================================================================
+//header:
+
+#ifndef _USART_DMA_COMPONENT_CONFIG_H_
+#define _USART_DMA_COMPONENT_CONFIG_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+#include "main.h"
+//==============================================================================
+//defines:
+
+#define USART_DMA_COMPONENT_MAIN_TASK_STACK_SECTION __attribute__((section("._user_heap_stack")))
+
+#define USART_DMA_TASK_STACK_SIZE 0x200 //the terminal commands of the attached ports run in the task
+
+#define USART_DMA_ATTACH_DEBUG_PORT 1 //0 - the debug port stays on the xUSART interrupts, "usart-load" measures them
+#define USART_DMA_TX_TIMEOUT 100 //ms without a transfer complete while the ring is full
+
+#define USART_DMA_RX_EVENTS 1 //0 - the attached ports are polled by the super-loop, as the xUSART driver does
+#define USART_DMA_IRQ_PRIORITY 6 //of the attached USART, not above configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY (5)
+#define USART_DMA_TASK_PERIOD 100 //ms without a receive event
+
+#define USART_DMA_LOAD_DEFAULT_SIZE 0x10000 //bytes of "usart-load"
+#define USART_DMA_LOAD_TIMEOUT 30000 //ms
+
+#define USART_DMA_COBS_ENABLE 1 //"\0<COBS of payload and CRC-32>\0" frames among the text lines of the attached ports
+#define USART_DMA_COBS_BUFFER_SIZE 0x204 //the largest payload and its CRC
+#define USART_DMA_COBS_REPLY_BUFFER_SIZE 0x1f8 //the terminal output of a frame, COBS_FRAME_SIZE of it fits the buffer above
+//------------------------------------------------------------------------------
+
+#define USART_DMA_RS485_ENABLE 1 //USART2 on the RS485 transceiver (PD5/PD6), DE on UASRT2_EN (PD7)
+
+#if USART_DMA_RS485_ENABLE == 1
+extern UART_HandleTypeDef huart2;
+extern DMA_HandleTypeDef hdma_usart2_tx;
+extern DMA_HandleTypeDef hdma_usart2_rx;
+extern TIM_HandleTypeDef htim7;
+
+#define USART_DMA_RS485_HANDLE huart2
+#define USART_DMA_RS485_TX_DMA hdma_usart2_tx
+#define USART_DMA_RS485_RX_DMA hdma_usart2_rx
+#define USART_DMA_RS485_IRQ USART2_IRQn
+#define USART_DMA_RS485_DE_PORT UASRT2_EN_GPIO_Port
+#define USART_DMA_RS485_DE_PIN UASRT2_EN_Pin
+#define USART_DMA_RS485_GUARD_TIMER htim7
+
+#define USART_DMA_RS485_GUARD_BITS 1 //DE held after the stop bit of the last byte, 0 - released on TC
+#define USART_DMA_RS485_ECHO_CHECK 0 //1 - RE of the transceiver is not tied to DE, the own frames are compared and collisions are counted
+
+#define USART_DMA_RS485_TX_BUFFER_SIZE_MASK 0x3ff
+#define USART_DMA_RS485_RX_CIRCLE_BUFFER_SIZE_MASK 0x1ff
+#define USART_DMA_RS485_RX_BUFFER_SIZE 0x1ff
+#define USART_DMA_RS485_MEM_SECTION __attribute__((section("._user_heap_stack")))
+#endif
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_USART_DMA_COMPONENT_CONFIG_H_
@@ -0,0 +1,120 @@
+//==============================================================================
+//includes:
+
+#include <string.h>
+#include "UsartDmaTx.h"
+//==============================================================================
+//functions:
+
+/// @brief one byte stays free: Head == Tail is an empty ring
+uint16_t UsartDmaTxRingGetFreeSize(UsartDmaTxRingT* ring)
+{
+	return ring->SizeMask - ((ring->Head - ring->Tail) & ring->SizeMask);
+}
+//------------------------------------------------------------------------------
+/// @brief bytes not sent yet, including the running transfer
+uint16_t UsartDmaTxRingGetDataSize(UsartDmaTxRingT* ring)
+{
+	return (ring->Head - ring->Tail) & ring->SizeMask;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief copies what fits at Head, Head moves after the copy so a transfer started
+ * from the interrupt never sees a half written span.
+ * @return written bytes
+ */
+uint16_t UsartDmaTxRingWrite(UsartDmaTxRingT* ring, const void* data, uint16_t size)
+{
+	uint16_t free = UsartDmaTxRingGetFreeSize(ring);
+	uint16_t head = ring->Head;
+
+	if (size > free)
+	{
+		size = free;
+	}
+
+	uint16_t first = ring->SizeMask + 1 - head;
+
+	if (first > size)
+	{
+		first = size;
+	}
+
+	memcpy(ring->Memory + head, data, first);
+	memcpy(ring->Memory, (const uint8_t*)data + first, size - first);
+
+	ring->Head = (head + size) & ring->SizeMask;
+
+	return size;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief contiguous free space at Head, a frame is built there in place and committed.
+ * An empty ring is moved to the beginning of the memory: nothing runs and no interrupt
+ * touches the indexes, the whole memory is contiguous then.
+ * @return bytes that may be written at data
+ */
+uint16_t UsartDmaTxRingReserve(UsartDmaTxRingT* ring, uint8_t** data)
+{
+	if (!ring->Pending && ring->Head == ring->Tail)
+	{
+		ring->Head = 0;
+		ring->Tail = 0;
+	}
+
+	uint16_t free = UsartDmaTxRingGetFreeSize(ring);
+	uint16_t contiguous = ring->SizeMask + 1 - ring->Head;
+
+	*data = ring->Memory + ring->Head;
+
+	return free < contiguous ? free : contiguous;
+}
+//------------------------------------------------------------------------------
+/// @brief the reserved bytes are written: they are given to the next transfer
+void UsartDmaTxRingCommit(UsartDmaTxRingT* ring, uint16_t size)
+{
+	ring->Head = (ring->Head + size) & ring->SizeMask;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief takes the contiguous span from Tail: up to Head or up to the end of the memory.
+ * Called with the DMA interrupt masked or from it.
+ * @return bytes of the transfer to start, 0 - a transfer is running or the ring is empty
+ */
+uint16_t UsartDmaTxRingStart(UsartDmaTxRingT* ring, uint8_t** data)
+{
+	uint16_t head = ring->Head;
+	uint16_t tail = ring->Tail;
+
+	if (ring->Pending || head == tail)
+	{
+		return 0;
+	}
+
+	uint16_t span = head > tail ? head - tail : ring->SizeMask + 1 - tail;
+
+	ring->Pending = span;
+	*data = ring->Memory + tail;
+
+	return span;
+}
+//------------------------------------------------------------------------------
+/// @brief the running transfer is complete: its span is free
+void UsartDmaTxRingComplete(UsartDmaTxRingT* ring)
+{
+	ring->Tail = (ring->Tail + ring->Pending) & ring->SizeMask;
+	ring->Pending = 0;
+}
+//==============================================================================
+//initialization:
+
+void UsartDmaTxRingInit(UsartDmaTxRingT* ring, uint8_t* memory, uint16_t sizeMask)
+{
+	ring->Memory = memory;
+	ring->SizeMask = sizeMask;
+
+	ring->Head = 0;
+	ring->Tail = 0;
+	ring->Pending = 0;
+}
+//==============================================================================
@@ -0,0 +1,49 @@
+//==============================================================================
+//header:
+
+#ifndef _USART_DMA_TX_H_
+#define _USART_DMA_TX_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+//==============================================================================
+//types:
+
+/// @brief circular transmit buffer drained by DMA transfers: the task writes at Head, each
+/// transfer sends the contiguous span from Tail, the wrapped part is the next transfer
+typedef struct
+{
+	uint8_t* Memory;
+	uint16_t SizeMask; //size - 1, the size is a power of two
+
+	volatile uint16_t Head; //written by the task
+	volatile uint16_t Tail; //advanced on the transfer complete
+	volatile uint16_t Pending; //bytes of the running transfer from Tail, 0 - DMA is idle
+
+} UsartDmaTxRingT;
+//==============================================================================
+//functions:
+
+void UsartDmaTxRingInit(UsartDmaTxRingT* ring, uint8_t* memory, uint16_t sizeMask);
+
+uint16_t UsartDmaTxRingGetFreeSize(UsartDmaTxRingT* ring);
+uint16_t UsartDmaTxRingGetDataSize(UsartDmaTxRingT* ring);
+
+uint16_t UsartDmaTxRingWrite(UsartDmaTxRingT* ring, const void* data, uint16_t size);
+
+uint16_t UsartDmaTxRingReserve(UsartDmaTxRingT* ring, uint8_t** data);
+void UsartDmaTxRingCommit(UsartDmaTxRingT* ring, uint16_t size);
+
+uint16_t UsartDmaTxRingStart(UsartDmaTxRingT* ring, uint8_t** data);
+void UsartDmaTxRingComplete(UsartDmaTxRingT* ring);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_USART_DMA_TX_H_
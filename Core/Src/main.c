@@ -124,6 +124,8 @@ int main(void)
   //MX_RTC_Init();
   MX_TIM5_Init();
   MX_USART6_UART_Init();
+  MX_TIM7_Init();
+  MX_TIM6_Init();
   /* USER CODE BEGIN 2 */
 
   /* USER CODE END 2 */
@@ -60,10 +60,16 @@ extern ETH_HandleTypeDef heth;
 extern CAN_HandleTypeDef hcan1;
 extern CAN_HandleTypeDef hcan2;
 extern TIM_HandleTypeDef htim4;
+extern TIM_HandleTypeDef htim6;
+extern TIM_HandleTypeDef htim7;
+extern DMA_HandleTypeDef hdma_memtomem_dma2_stream0;
 extern DMA_HandleTypeDef hdma_usart1_rx;
 extern DMA_HandleTypeDef hdma_usart2_rx;
+extern DMA_HandleTypeDef hdma_usart2_tx;
 extern DMA_HandleTypeDef hdma_usart3_rx;
 extern DMA_HandleTypeDef hdma_usart6_rx;
+extern DMA_HandleTypeDef hdma_usart3_tx;
+extern DMA_HandleTypeDef hdma_usart6_tx;
 extern UART_HandleTypeDef huart1;
 extern UART_HandleTypeDef huart2;
 extern UART_HandleTypeDef huart3;
@@ -113,6 +119,23 @@ void DMA1_Stream1_IRQHandler(void)
   /* USER CODE END DMA1_Stream1_IRQn 1 */
 }
 
+/**
+  * @brief This function handles DMA1 stream3 global interrupt.
+  */
+void DMA1_Stream3_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Stream3_IRQn 0 */
+#if USART_DMA_ENABLE == 1 && SERIAL3_ENABLE == 1 && SERIAL3_TX_DMA_ENABLE == 1
+	UsartDmaComponentTxDmaIRQ(SERIAL3);
+#else
+	HAL_DMA_IRQHandler(&hdma_usart3_tx);
+#endif
+  /* USER CODE END DMA1_Stream3_IRQn 0 */
+  /* USER CODE BEGIN DMA1_Stream3_IRQn 1 */
+
+  /* USER CODE END DMA1_Stream3_IRQn 1 */
+}
+
 /**
   * @brief This function handles DMA1 stream5 global interrupt.
   */
@@ -127,13 +150,34 @@ void DMA1_Stream5_IRQHandler(void)
   /* USER CODE END DMA1_Stream5_IRQn 1 */
 }
 
+/**
+  * @brief This function handles DMA1 stream6 global interrupt.
+  */
+void DMA1_Stream6_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Stream6_IRQn 0 */
+#if USART_DMA_ENABLE == 1 && USART_DMA_RS485_ENABLE == 1
+	UsartDmaComponentRs485TxDmaIRQ();
+#else
+	HAL_DMA_IRQHandler(&hdma_usart2_tx);
+#endif
+  /* USER CODE END DMA1_Stream6_IRQn 0 */
+  /* USER CODE BEGIN DMA1_Stream6_IRQn 1 */
+
+  /* USER CODE END DMA1_Stream6_IRQn 1 */
+}
+
 /**
   * @brief This function handles CAN1 TX interrupts.
   */
 void CAN1_TX_IRQHandler(void)
 {
   /* USER CODE BEGIN CAN1_TX_IRQn 0 */
+#if CAN_BUS_ENABLE == 1 && CAN_BUS_PORT1_ENABLE == 1
+	CanBusComponentTxIRQ(CAN_BUS_PORT1, xCAN1);
+#else
 	xCAN_TxIRQ_Handler(xCAN1);
+#endif
   /* USER CODE END CAN1_TX_IRQn 0 */
   /* USER CODE BEGIN CAN1_TX_IRQn 1 */
 
@@ -146,13 +190,32 @@ void CAN1_TX_IRQHandler(void)
 void CAN1_RX0_IRQHandler(void)
 {
   /* USER CODE BEGIN CAN1_RX0_IRQn 0 */
+#if CAN_BUS_ENABLE == 1 && CAN_BUS_PORT1_ENABLE == 1
+	CanBusComponentRxIRQ(CAN_BUS_PORT1, CanBusFifoBulk, xCAN1);
+#else
 	xCAN_RxIRQ_Handler(xCAN1);
+#endif
   /* USER CODE END CAN1_RX0_IRQn 0 */
   /* USER CODE BEGIN CAN1_RX0_IRQn 1 */
 
   /* USER CODE END CAN1_RX0_IRQn 1 */
 }
 
+/**
+  * @brief This function handles CAN1 RX1 interrupt.
+  */
+void CAN1_RX1_IRQHandler(void)
+{
+  /* USER CODE BEGIN CAN1_RX1_IRQn 0 */
+#if CAN_BUS_ENABLE == 1 && CAN_BUS_PORT1_ENABLE == 1
+	CanBusComponentRxIRQ(CAN_BUS_PORT1, CanBusFifoPriority, xCAN1);
+#endif
+  /* USER CODE END CAN1_RX1_IRQn 0 */
+  /* USER CODE BEGIN CAN1_RX1_IRQn 1 */
+
+  /* USER CODE END CAN1_RX1_IRQn 1 */
+}
+
 /**
   * @brief This function handles EXTI line[9:5] interrupts.
   */
@@ -199,7 +262,11 @@ void USART1_IRQHandler(void)
 void USART2_IRQHandler(void)
 {
   /* USER CODE BEGIN USART2_IRQn 0 */
+#if USART_DMA_ENABLE == 1 && USART_DMA_RS485_ENABLE == 1
+	UsartDmaComponentRs485IRQ();
+#else
 	xUSART_IRQ_Handler(xUSART2);
+#endif
   /* USER CODE END USART2_IRQn 0 */
   /* USER CODE BEGIN USART2_IRQn 1 */
 
@@ -212,7 +279,11 @@ void USART2_IRQHandler(void)
 void USART3_IRQHandler(void)
 {
   /* USER CODE BEGIN USART3_IRQn 0 */
+#if USART_DMA_ENABLE == 1 && SERIAL3_ENABLE == 1
+	UsartDmaComponentIRQ(SERIAL3, xUSART3);
+#else
 	xUSART_IRQ_Handler(xUSART3);
+#endif
 	//xPortDirectlyIRQ(SerialPort, 0);
   /* USER CODE END USART3_IRQn 0 */
   /* USER CODE BEGIN USART3_IRQn 1 */
@@ -234,6 +305,54 @@ void TIM8_TRG_COM_TIM14_IRQHandler(void)
   /* USER CODE END TIM8_TRG_COM_TIM14_IRQn 1 */
 }
 
+/**
+  * @brief This function handles TIM6 global interrupt, DAC1 and DAC2 underrun error interrupts.
+  */
+void TIM6_DAC_IRQHandler(void)
+{
+  /* USER CODE BEGIN TIM6_DAC_IRQn 0 */
+#if MODBUS_ENABLE == 1
+	ModbusComponentSilenceIRQ();
+#else
+	HAL_TIM_IRQHandler(&htim6);
+#endif
+  /* USER CODE END TIM6_DAC_IRQn 0 */
+  /* USER CODE BEGIN TIM6_DAC_IRQn 1 */
+
+  /* USER CODE END TIM6_DAC_IRQn 1 */
+}
+
+/**
+  * @brief This function handles TIM7 global interrupt.
+  */
+void TIM7_IRQHandler(void)
+{
+  /* USER CODE BEGIN TIM7_IRQn 0 */
+#if USART_DMA_ENABLE == 1 && USART_DMA_RS485_ENABLE == 1
+	UsartDmaComponentRs485GuardIRQ();
+#else
+	HAL_TIM_IRQHandler(&htim7);
+#endif
+  /* USER CODE END TIM7_IRQn 0 */
+  /* USER CODE BEGIN TIM7_IRQn 1 */
+
+  /* USER CODE END TIM7_IRQn 1 */
+}
+
+/**
+  * @brief This function handles DMA2 stream0 global interrupt.
+  */
+void DMA2_Stream0_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA2_Stream0_IRQn 0 */
+
+  /* USER CODE END DMA2_Stream0_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_memtomem_dma2_stream0);
+  /* USER CODE BEGIN DMA2_Stream0_IRQn 1 */
+
+  /* USER CODE END DMA2_Stream0_IRQn 1 */
+}
+
 /**
   * @brief This function handles DMA2 stream1 global interrupt.
   */
@@ -282,7 +401,11 @@ void DMA2_Stream2_IRQHandler(void)
 void CAN2_TX_IRQHandler(void)
 {
   /* USER CODE BEGIN CAN2_TX_IRQn 0 */
+#if CAN_BUS_ENABLE == 1 && CAN_BUS_PORT2_ENABLE == 1
+	CanBusComponentTxIRQ(CAN_BUS_PORT2, xCAN2);
+#else
 	xCAN_TxIRQ_Handler(xCAN2);
+#endif
   /* USER CODE END CAN2_TX_IRQn 0 */
   /* USER CODE BEGIN CAN2_TX_IRQn 1 */
 
@@ -295,20 +418,60 @@ void CAN2_TX_IRQHandler(void)
 void CAN2_RX0_IRQHandler(void)
 {
   /* USER CODE BEGIN CAN2_RX0_IRQn 0 */
+#if CAN_BUS_ENABLE == 1 && CAN_BUS_PORT2_ENABLE == 1
+	CanBusComponentRxIRQ(CAN_BUS_PORT2, CanBusFifoBulk, xCAN2);
+#else
 	xCAN_RxIRQ_Handler(xCAN2);
+#endif
   /* USER CODE END CAN2_RX0_IRQn 0 */
   /* USER CODE BEGIN CAN2_RX0_IRQn 1 */
 
   /* USER CODE END CAN2_RX0_IRQn 1 */
 }
 
+/**
+  * @brief This function handles CAN2 RX1 interrupt.
+  */
+void CAN2_RX1_IRQHandler(void)
+{
+  /* USER CODE BEGIN CAN2_RX1_IRQn 0 */
+#if CAN_BUS_ENABLE == 1 && CAN_BUS_PORT2_ENABLE == 1
+	CanBusComponentRxIRQ(CAN_BUS_PORT2, CanBusFifoPriority, xCAN2);
+#endif
+  /* USER CODE END CAN2_RX1_IRQn 0 */
+  /* USER CODE BEGIN CAN2_RX1_IRQn 1 */
+
+  /* USER CODE END CAN2_RX1_IRQn 1 */
+}
+
+/**
+  * @brief This function handles DMA2 stream6 global interrupt.
+  */
+void DMA2_Stream6_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA2_Stream6_IRQn 0 */
+#if USART_DMA_ENABLE == 1 && SERIAL6_ENABLE == 1 && SERIAL6_TX_DMA_ENABLE == 1
+	UsartDmaComponentTxDmaIRQ(SERIAL6);
+#else
+	HAL_DMA_IRQHandler(&hdma_usart6_tx);
+#endif
+  /* USER CODE END DMA2_Stream6_IRQn 0 */
+  /* USER CODE BEGIN DMA2_Stream6_IRQn 1 */
+
+  /* USER CODE END DMA2_Stream6_IRQn 1 */
+}
+
 /**
   * @brief This function handles USART6 global interrupt.
   */
 void USART6_IRQHandler(void)
 {
   /* USER CODE BEGIN USART6_IRQn 0 */
-
+#if USART_DMA_ENABLE == 1 && SERIAL6_ENABLE == 1
+	UsartDmaComponentIRQ(SERIAL6, xUSART6);
+#else
+	xUSART_IRQ_Handler(xUSART6);
+#endif
   /* USER CODE END USART6_IRQn 0 */
   /* USER CODE BEGIN USART6_IRQn 1 */
 
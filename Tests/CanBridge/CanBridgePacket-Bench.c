@@ -0,0 +1,774 @@
+//==============================================================================
+//includes:
+
+#include "CanBridge/CanBridgePacket.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+//==============================================================================
+//defines:
+
+#define SIMULATION_TIME 20000000ULL //us of both buses
+#define TICK_PERIOD 1000 //us, the tick of FreeRTOS
+
+#define RING_SIZE_MASK 0xff //CAN_BRIDGE_RING_SIZE_MASK
+#define QUEUE_SIZE_MASK 0x7f //the transmit queue of the adapter
+#define PENDING_SIZE_MASK 0xfff //the frames received by the controller, not taken by the CanBus task yet
+#define REFERENCE_SIZE_MASK 0xfffff //the copies of the frames put on the buses
+
+#define DATAGRAM_SIZE 1472 //CAN_BRIDGE_DATAGRAM_SIZE
+#define DATAGRAM_FRAMES_MAX 300
+#define RESYNC_DATAGRAMS 16 //CAN_BRIDGE_RESYNC_DATAGRAMS
+#define WIRE_MAX 256 //datagrams in flight
+
+#define CODEC_DATAGRAMS 200000
+#define LATENCY_MAX 20000 //us, the last bin of the histogram
+#define LATENCY_MARGIN 2000 //us over the deadline for p99: the tick and the stalls of the tasks
+//==============================================================================
+//types:
+
+/// @brief a datagram on the way to the peer and the frames of the bus it carries
+typedef struct
+{
+	uint64_t Time; //us of the arrival
+	uint8_t Port;
+	uint16_t Size;
+	uint8_t Data[DATAGRAM_SIZE];
+
+	uint16_t Count;
+	uint32_t References[DATAGRAM_FRAMES_MAX];
+
+} WireT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	CanBusFrameT Frame;
+	uint32_t Reference;
+
+} PendingT;
+//------------------------------------------------------------------------------
+/// @brief the sequence of the peer as the downlink task tracks it
+typedef struct
+{
+	uint8_t RxSequence;
+	uint8_t RxBehind;
+	bool IsRxSynchronized;
+
+} SequenceT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Deadline; //us
+	uint32_t Batch; //frames
+	double Loss; //of the datagrams
+	double Reorder; //of the datagrams, 1.5 ms late
+	double ExtendedShare; //of the frames
+
+	uint64_t Frames;
+	uint64_t Datagrams;
+	uint64_t Bytes; //with the headers of UDP and IP
+	uint64_t RingOverflows;
+	uint64_t WireOverflows;
+	uint64_t Mismatches;
+	uint64_t Delivered;
+
+	uint64_t Dropped; //datagrams
+	uint64_t DroppedFrames;
+	uint64_t Lost; //datagrams detected by the sequence
+	uint64_t OutOfOrder;
+
+	uint64_t QueueOverflows;
+	uint64_t QueuePeak;
+
+	uint32_t Latency[LATENCY_MAX + 1]; //us from the SOF to the decode at the peer
+
+} RunT;
+//==============================================================================
+//variables:
+
+static uint64_t privateSeed = 88172645463325252ULL;
+
+static WireT privateWire[WIRE_MAX];
+static uint16_t privateWireCount;
+
+static CanBusFrameT privateReferences[2][REFERENCE_SIZE_MASK + 1];
+static uint64_t privateReferencesHead[2];
+static uint32_t privateSlotReferences[2][RING_SIZE_MASK + 1]; //of the frames in the rings
+static uint32_t privateBatchReferences[DATAGRAM_FRAMES_MAX];
+
+static CanBusFrameT privateRingFrames[2][RING_SIZE_MASK + 1];
+static PendingT privatePending[2][PENDING_SIZE_MASK + 1];
+static uint16_t privateQueueBits[2][QUEUE_SIZE_MASK + 1];
+
+static RunT privateResult;
+//==============================================================================
+//functions:
+
+static uint32_t privateRandom()
+{
+	privateSeed ^= privateSeed << 13;
+	privateSeed ^= privateSeed >> 7;
+	privateSeed ^= privateSeed << 17;
+
+	return (uint32_t)privateSeed;
+}
+//------------------------------------------------------------------------------
+static double privateRandomUnit()
+{
+	return (privateRandom() & 0xffffff) / (double)0x1000000;
+}
+//------------------------------------------------------------------------------
+/// @brief the exact length of a data or remote frame on the bus: the stuff bits, CRC delimiter, ACK, EOF and the intermission
+static uint16_t privateGetFrameBits(const CanBusFrameT* frame)
+{
+	uint8_t bits[160];
+	uint16_t count = 0;
+
+	bits[count++] = 0; //SOF
+
+	if (frame->Flags & CAN_BUS_FRAME_EXTENDED)
+	{
+		for (int8_t i = 28; i >= 18; i--)
+		{
+			bits[count++] = (frame->Id >> i) & 1;
+		}
+
+		bits[count++] = 1; //SRR
+		bits[count++] = 1; //IDE
+
+		for (int8_t i = 17; i >= 0; i--)
+		{
+			bits[count++] = (frame->Id >> i) & 1;
+		}
+
+		bits[count++] = 0; //RTR
+		bits[count++] = 0; //r1
+		bits[count++] = 0; //r0
+	}
+	else
+	{
+		for (int8_t i = 10; i >= 0; i--)
+		{
+			bits[count++] = (frame->Id >> i) & 1;
+		}
+
+		bits[count++] = 0; //RTR
+		bits[count++] = 0; //IDE
+		bits[count++] = 0; //r0
+	}
+
+	for (int8_t i = 3; i >= 0; i--)
+	{
+		bits[count++] = (frame->Dlc >> i) & 1;
+	}
+
+	for (uint8_t j = 0; j < frame->Dlc; j++)
+	{
+		for (int8_t i = 7; i >= 0; i--)
+		{
+			bits[count++] = (frame->Data[j] >> i) & 1;
+		}
+	}
+
+	uint16_t crc = 0;
+
+	for (uint16_t i = 0; i < count; i++)
+	{
+		uint8_t next = bits[i] ^ ((crc >> 14) & 1);
+
+		crc = (crc << 1) & 0x7fff;
+		crc ^= next ? 0x4599 : 0;
+	}
+
+	for (int8_t i = 14; i >= 0; i--)
+	{
+		bits[count++] = (crc >> i) & 1;
+	}
+
+	uint16_t stuff = 0;
+	uint8_t run = 1;
+
+	for (uint16_t i = 1; i < count; i++)
+	{
+		if (bits[i] != bits[i - 1])
+		{
+			run = 1;
+		}
+		else if (++run == 5)
+		{
+			stuff++;
+			run = 0;
+		}
+	}
+
+	return count + stuff + 1 + 2 + 7 + 3;
+}
+//------------------------------------------------------------------------------
+static void privateRandomFrame(CanBusFrameT* frame, double extendedShare)
+{
+	memset(frame, 0, sizeof(CanBusFrameT));
+
+	if (privateRandomUnit() < extendedShare)
+	{
+		frame->Flags = CAN_BUS_FRAME_EXTENDED;
+		frame->Id = privateRandom() & 0x1fffffff;
+	}
+	else
+	{
+		frame->Id = privateRandom() & 0x7ff;
+	}
+
+	if ((privateRandom() & 63) == 0)
+	{
+		frame->Flags |= CAN_BUS_FRAME_REMOTE;
+		frame->Dlc = privateRandom() % 9;
+		return;
+	}
+
+	frame->Dlc = privateRandom() % 9;
+
+	for (uint8_t i = 0; i < frame->Dlc; i++)
+	{
+		frame->Data[i] = privateRandom();
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief privateTrackSequence of the component
+static void privateTrackSequence(SequenceT* tracked, RunT* result, uint8_t sequence)
+{
+	uint8_t gap = sequence - tracked->RxSequence;
+
+	if (tracked->IsRxSynchronized && gap >= 0x80)
+	{
+		result->OutOfOrder++;
+
+		if (result->Lost)
+		{
+			result->Lost--;
+		}
+
+		if (++tracked->RxBehind < RESYNC_DATAGRAMS)
+		{
+			return;
+		}
+	}
+	else if (tracked->IsRxSynchronized)
+	{
+		result->Lost += gap;
+	}
+
+	tracked->IsRxSynchronized = true;
+	tracked->RxBehind = 0;
+	tracked->RxSequence = sequence + 1;
+}
+//------------------------------------------------------------------------------
+/// @return true - the frames as the ring gave them, the remote ones without data
+static bool privateIsEqual(const CanBusFrameT* expected, const CanBusFrameT* frame, uint8_t flagsMask)
+{
+	return expected->Id == frame->Id
+		&& expected->Dlc == frame->Dlc
+		&& (expected->Flags & flagsMask) == frame->Flags
+		&& ((frame->Flags & CAN_BUS_FRAME_REMOTE) || !memcmp(expected->Data, frame->Data, frame->Dlc));
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief round trip of full datagrams of random frames, each cut short by a byte;
+ * a datagram with a CAN FD and an error frame, an unknown op_code and a short header
+ * @return the fails
+ */
+static uint64_t privateCodecRun()
+{
+	uint8_t buffer[DATAGRAM_SIZE];
+	CanBusFrameT frames[DATAGRAM_FRAMES_MAX];
+	CanBridgeReaderT reader;
+	CanBusFrameT frame;
+	uint64_t count = 0;
+	uint64_t fails = 0;
+	struct timespec start;
+	struct timespec end;
+
+	privateSeed = 42;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	for (uint32_t n = 0; n < CODEC_DATAGRAMS; n++)
+	{
+		CanBridgePacketT packet;
+		uint16_t added = 0;
+
+		CanBridgePacketBegin(&packet, buffer, sizeof(buffer), n);
+
+		do
+		{
+			privateRandomFrame(&frames[added], 0.3);
+		}
+		while (CanBridgePacketAdd(&packet, &frames[added]) && ++added);
+
+		uint16_t length = CanBridgePacketEnd(&packet);
+
+		fails += packet.Count != added;
+
+		if (CanBridgeReaderInit(&reader, buffer, length) != xResultAccept || reader.Sequence != (uint8_t)n)
+		{
+			fails++;
+		}
+
+		uint16_t taken = 0;
+
+		while (CanBridgeReaderNext(&reader, &frame))
+		{
+			fails += !privateIsEqual(&frames[taken++], &frame, 0xff);
+		}
+
+		fails += taken != added || reader.IsMalformed;
+		count += added;
+
+		//the frames before the cut still come
+		if (CanBridgeReaderInit(&reader, buffer, length - 1) != xResultAccept)
+		{
+			fails++;
+		}
+
+		taken = 0;
+
+		while (CanBridgeReaderNext(&reader, &frame))
+		{
+			taken++;
+		}
+
+		fails += taken != added - 1 || !reader.IsMalformed;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	//a CAN FD frame and an error frame between two classic ones
+	const uint8_t mixed[] =
+	{
+		2, 0, 7, 0, 4,
+		0x00, 0x00, 0x01, 0x23, 2, 0xaa, 0xbb,
+		0x00, 0x00, 0x01, 0x24, 0x80 | 12, 0x01, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+		0x20, 0x00, 0x00, 0x04, 8, 0, 0, 0, 0, 0, 0, 0, 0,
+		0xc0, 0x01, 0x02, 0x03, 4
+	};
+	const CanBusFrameT expected[] =
+	{
+		{ .Id = 0x123, .Dlc = 2, .Data = { 0xaa, 0xbb } },
+		{ .Id = 0x00010203, .Dlc = 4, .Flags = CAN_BUS_FRAME_EXTENDED | CAN_BUS_FRAME_REMOTE }
+	};
+	uint16_t taken = 0;
+
+	CanBridgeReaderInit(&reader, mixed, sizeof(mixed));
+
+	while (CanBridgeReaderNext(&reader, &frame))
+	{
+		fails += taken >= 2 || !privateIsEqual(&expected[taken], &frame, 0xff);
+		taken++;
+	}
+
+	fails += taken != 2 || reader.Skipped != 2 || reader.IsMalformed;
+
+	//op_code 1 is an ACK of SCTP
+	const uint8_t other[] = { 2, 1, 0, 0, 0 };
+
+	fails += CanBridgeReaderInit(&reader, other, sizeof(other)) != xResultNotSupported;
+	fails += CanBridgeReaderInit(&reader, other, CAN_BRIDGE_PACKET_HEADER_SIZE - 1) != xResultError;
+
+	double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+	printf("codec: %llu frames round trip, %llu fails, %.1f Mframes/s encode+decode on the host\n",
+			(unsigned long long)count,
+			(unsigned long long)fails,
+			count / seconds / 1e6);
+
+	return fails;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief two buses at 100% load to the uplink through the rings, the datagrams to the peer
+ * that checks them against the buses and mirrors the frames into the transmit queues of the gateway
+ */
+static void privateRun(RunT* result, uint64_t seed)
+{
+	CanBusRingT rings[2];
+	uint8_t sequences[2] = { 0 };
+	SequenceT tracked[2] = { 0 };
+	uint8_t buffer[DATAGRAM_SIZE];
+	uint64_t lastArrival[2] = { 0 };
+
+	privateSeed = seed;
+	privateWireCount = 0;
+
+	for (uint8_t port = 0; port < 2; port++)
+	{
+		CanBusRingInit(&rings[port], privateRingFrames[port], RING_SIZE_MASK);
+		privateReferencesHead[port] = 0;
+	}
+
+	//the buses: back to back frames, handed to the bridge by the CanBus task
+	CanBusFrameT onBus[2];
+	uint64_t sof[2] = { 0, 7 };
+	uint64_t frameEnd[2];
+
+	privateRandomFrame(&onBus[0], result->ExtendedShare);
+	privateRandomFrame(&onBus[1], result->ExtendedShare);
+
+	frameEnd[0] = privateGetFrameBits(&onBus[0]);
+	frameEnd[1] = 7 + privateGetFrameBits(&onBus[1]);
+
+	//the CanBus task runs late at times, the network stalls the uplink
+	uint32_t pendingHead[2] = { 0 };
+	uint32_t pendingTail[2] = { 0 };
+	uint64_t canTaskBlockedUntil = 0;
+	uint64_t nextCanBlock = 3000;
+	uint64_t uplinkWake = 0;
+	bool isUplinkNotified = false;
+	uint64_t networkBlockedUntil = 0;
+	uint64_t nextNetworkBlock = 50000;
+
+	//the peer sends the frames back to the queues of the same buses, drained at the bus rate
+	uint16_t queueCount[2] = { 0 };
+	uint64_t queueBusy[2] = { 0 };
+	uint32_t queueHead[2] = { 0 };
+	uint32_t queueTail[2] = { 0 };
+
+	for (uint64_t time = 0; time < SIMULATION_TIME; time++)
+	{
+		for (uint8_t port = 0; port < 2; port++)
+		{
+			if (time != frameEnd[port])
+			{
+				continue;
+			}
+
+			PendingT* pending = &privatePending[port][pendingHead[port]++ & PENDING_SIZE_MASK];
+
+			pending->Frame = onBus[port];
+			pending->Frame.Timestamp = sof[port];
+			pending->Reference = privateReferencesHead[port] & REFERENCE_SIZE_MASK;
+
+			privateReferences[port][privateReferencesHead[port]++ & REFERENCE_SIZE_MASK] = pending->Frame;
+			result->Frames++;
+
+			privateRandomFrame(&onBus[port], result->ExtendedShare);
+
+			sof[port] = time;
+			frameEnd[port] = time + privateGetFrameBits(&onBus[port]);
+		}
+
+		//the CanBus task: preempted now and then, 4 us per frame otherwise
+		if (time >= nextCanBlock)
+		{
+			canTaskBlockedUntil = time + (privateRandomUnit() < 0.95 ? 50 + privateRandom() % 300 : 1000 + privateRandom() % 2000);
+			nextCanBlock = canTaskBlockedUntil + 2000 + privateRandom() % 8000;
+		}
+
+		if (time >= canTaskBlockedUntil && (time & 3) == 0)
+		{
+			for (uint8_t port = 0; port < 2; port++)
+			{
+				if (pendingTail[port] == pendingHead[port])
+				{
+					continue;
+				}
+
+				PendingT* pending = &privatePending[port][pendingTail[port]++ & PENDING_SIZE_MASK];
+				CanBusFrameT* entry = CanBusRingReserve(&rings[port]);
+
+				if (!entry)
+				{
+					result->RingOverflows++;
+					continue;
+				}
+
+				*entry = pending->Frame;
+				privateSlotReferences[port][rings[port].Head] = pending->Reference;
+				CanBusRingCommit(&rings[port]);
+
+				//the listener of the component notifies the uplink on the first frame and on a full batch
+				uint16_t count = CanBusRingGetCount(&rings[port]);
+
+				if (count == 1 || count == result->Batch)
+				{
+					isUplinkNotified = true;
+				}
+
+				break;
+			}
+		}
+
+		//the uplink: woken by the notification 20 us later or at the tick of its deadline
+		if (time >= nextNetworkBlock)
+		{
+			networkBlockedUntil = time + 2000 + privateRandom() % 6000;
+			nextNetworkBlock = networkBlockedUntil + 500000 + privateRandom() % 1000000;
+		}
+
+		if (isUplinkNotified && uplinkWake > time + 20)
+		{
+			uplinkWake = time + 20;
+		}
+
+		if (time >= uplinkWake && time >= networkBlockedUntil)
+		{
+			uint32_t wait = 100000;
+
+			isUplinkNotified = false;
+
+			for (uint8_t port = 0; port < 2; port++)
+			{
+				CanBusFrameT* oldest;
+				uint32_t left = UINT32_MAX;
+
+				while ((oldest = CanBusRingPeek(&rings[port])))
+				{
+					uint32_t age = time > oldest->Timestamp ? (uint32_t)(time - oldest->Timestamp) : 0;
+
+					if (CanBusRingGetCount(&rings[port]) < result->Batch && age < result->Deadline)
+					{
+						left = result->Deadline - age;
+						break;
+					}
+
+					CanBridgePacketT packet;
+					CanBusFrameT* frame;
+
+					CanBridgePacketBegin(&packet, buffer, sizeof(buffer), sequences[port]++);
+
+					while (packet.Count < result->Batch
+						&& (frame = CanBusRingPeek(&rings[port]))
+						&& CanBridgePacketAdd(&packet, frame))
+					{
+						privateBatchReferences[packet.Count - 1] = privateSlotReferences[port][rings[port].Tail];
+						CanBusRingRelease(&rings[port]);
+					}
+
+					uint16_t length = CanBridgePacketEnd(&packet);
+
+					result->Datagrams++;
+					result->Bytes += length + 28;
+
+					if (privateRandomUnit() < result->Loss)
+					{
+						result->Dropped++;
+						result->DroppedFrames += packet.Count;
+						continue;
+					}
+
+					if (privateWireCount == WIRE_MAX)
+					{
+						result->WireOverflows++;
+						continue;
+					}
+
+					WireT* wire = &privateWire[privateWireCount++];
+
+					//one path: in order unless reordered
+					wire->Time = time + 150 + privateRandom() % 150;
+					wire->Time = wire->Time > lastArrival[port] ? wire->Time : lastArrival[port] + 1;
+					lastArrival[port] = wire->Time;
+
+					if (privateRandomUnit() < result->Reorder)
+					{
+						wire->Time += 1500;
+					}
+
+					wire->Port = port;
+					wire->Size = length;
+					wire->Count = packet.Count;
+
+					memcpy(wire->Data, buffer, length);
+					memcpy(wire->References, privateBatchReferences, sizeof(uint32_t) * packet.Count);
+				}
+
+				wait = left < wait ? left : wait;
+			}
+
+			uint64_t ticks = (wait + 999) / 1000;
+
+			uplinkWake = (time / TICK_PERIOD + (ticks ? ticks : 1)) * TICK_PERIOD;
+		}
+
+		//the peer: decodes, checks against the buses, mirrors the frames back
+		for (uint16_t i = 0; i < privateWireCount; i++)
+		{
+			WireT* wire = &privateWire[i];
+			CanBridgeReaderT reader;
+			CanBusFrameT frame;
+			uint16_t taken = 0;
+
+			if (wire->Time != time)
+			{
+				continue;
+			}
+
+			if (CanBridgeReaderInit(&reader, wire->Data, wire->Size) != xResultAccept)
+			{
+				result->Mismatches++;
+				*wire = privateWire[--privateWireCount];
+				i--;
+				continue;
+			}
+
+			privateTrackSequence(&tracked[wire->Port], result, reader.Sequence);
+
+			while (CanBridgeReaderNext(&reader, &frame))
+			{
+				CanBusFrameT* expected = taken < wire->Count ? &privateReferences[wire->Port][wire->References[taken]] : NULL;
+
+				taken++;
+
+				if (!expected || !privateIsEqual(expected, &frame, CAN_BUS_FRAME_EXTENDED | CAN_BUS_FRAME_REMOTE))
+				{
+					result->Mismatches++;
+					continue;
+				}
+
+				uint64_t latency = time - expected->Timestamp;
+
+				result->Latency[latency > LATENCY_MAX ? LATENCY_MAX : latency]++;
+				result->Delivered++;
+
+				//into the transmit queue of the gateway
+				uint8_t queue = wire->Port;
+
+				if (queueCount[queue] >= QUEUE_SIZE_MASK)
+				{
+					result->QueueOverflows++;
+					continue;
+				}
+
+				privateQueueBits[queue][queueHead[queue]++ & QUEUE_SIZE_MASK] = privateGetFrameBits(&frame);
+				queueCount[queue]++;
+
+				result->QueuePeak = queueCount[queue] > result->QueuePeak ? queueCount[queue] : result->QueuePeak;
+			}
+
+			result->Mismatches += reader.IsMalformed || taken != wire->Count;
+
+			*wire = privateWire[--privateWireCount];
+			i--;
+		}
+
+		//the gateway sends the queued frames back to back, its receive of them is not modeled
+		for (uint8_t queue = 0; queue < 2; queue++)
+		{
+			if (queueCount[queue] && time >= queueBusy[queue])
+			{
+				queueBusy[queue] = time + privateQueueBits[queue][queueTail[queue]++ & QUEUE_SIZE_MASK];
+				queueCount[queue]--;
+			}
+		}
+	}
+}
+//------------------------------------------------------------------------------
+static uint32_t privateGetPercentile(const uint32_t* histogram, uint64_t count, double share)
+{
+	uint64_t wanted = (uint64_t)(count * share);
+	uint64_t sum = 0;
+
+	for (uint32_t i = 0; i <= LATENCY_MAX; i++)
+	{
+		sum += histogram[i];
+
+		if (sum > wanted)
+		{
+			return i;
+		}
+	}
+
+	return LATENCY_MAX;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	if (privateCodecRun())
+	{
+		printf("FAIL: the codec\n");
+		return 1;
+	}
+
+	const struct
+	{
+		uint32_t Deadline;
+		uint32_t Batch;
+		double Loss;
+		double Reorder;
+
+	} configurations[] =
+	{
+		{ 500, 64, 0.001, 0.001 },
+		{ 1000, 64, 0.001, 0.001 },
+		{ 2000, 64, 0.001, 0.001 },
+		{ 1000, 16, 0.001, 0.001 },
+		{ 1000, 64, 0.02, 0.01 }
+	};
+
+	bool isValid = true;
+
+	for (uint8_t i = 0; i < sizeof(configurations) / sizeof(configurations[0]); i++)
+	{
+		RunT* result = &privateResult;
+		double seconds = SIMULATION_TIME / 1e6;
+
+		memset(result, 0, sizeof(RunT));
+
+		result->Deadline = configurations[i].Deadline;
+		result->Batch = configurations[i].Batch;
+		result->Loss = configurations[i].Loss;
+		result->Reorder = configurations[i].Reorder;
+		result->ExtendedShare = 0.2;
+
+		privateRun(result, 1234567 + i);
+
+		uint32_t latency99 = privateGetPercentile(result->Latency, result->Delivered, 0.99);
+		uint64_t inFlight = result->Frames - result->RingOverflows - result->Delivered - result->DroppedFrames;
+
+		printf("deadline %4u us batch %2u loss %.1f%%: %6.0f frames/s, %5.0f datagrams/s, %4.1f frames/datagram, %5.2f Mbit/s udp, "
+				"ring overflows %llu, latency p50 %u p99 %u max %u us, dropped %llu datagrams (%llu frames), detected lost %llu, "
+				"out of order %llu, mismatches %llu, delivered %llu/%llu, tx queue peak %llu/%u overflows %llu\n",
+				result->Deadline,
+				result->Batch,
+				result->Loss * 100,
+				result->Frames / seconds,
+				result->Datagrams / seconds,
+				(double)(result->Frames - result->RingOverflows) / result->Datagrams,
+				result->Bytes * 8 / seconds / 1e6,
+				(unsigned long long)result->RingOverflows,
+				privateGetPercentile(result->Latency, result->Delivered, 0.5),
+				latency99,
+				privateGetPercentile(result->Latency, result->Delivered, 1.0 - 1e-9),
+				(unsigned long long)result->Dropped,
+				(unsigned long long)result->DroppedFrames,
+				(unsigned long long)result->Lost,
+				(unsigned long long)result->OutOfOrder,
+				(unsigned long long)result->Mismatches,
+				(unsigned long long)result->Delivered,
+				(unsigned long long)result->Frames,
+				(unsigned long long)result->QueuePeak,
+				QUEUE_SIZE_MASK,
+				(unsigned long long)result->QueueOverflows);
+
+		//every frame delivered or dropped with its datagram but the ones in flight at the end,
+		//every drop detected by the sequence, the deadline kept to the tick and the stalls
+		isValid &= !result->RingOverflows
+				&& !result->WireOverflows
+				&& !result->Mismatches
+				&& !result->QueueOverflows
+				&& inFlight < (RING_SIZE_MASK + 1) * 2
+				&& result->Lost == result->Dropped
+				&& latency99 < result->Deadline + LATENCY_MARGIN;
+	}
+
+	if (!isValid)
+	{
+		printf("FAIL: the bridge loses frames, misses its deadline or the sequence\n");
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
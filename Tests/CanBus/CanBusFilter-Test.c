@@ -0,0 +1,350 @@
+//==============================================================================
+//includes:
+
+#include "CanBus/CanBusFilter.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+//==============================================================================
+//defines:
+
+#define SUBSCRIPTIONS_MAX 400 //of each port
+#define BLOCKS_COUNT 256 //the work memory of the compiler
+#define EXTENDED_SAMPLES 2000000 //uniform extended identifiers of each port
+
+#define STANDARD_ID_MAX 0x7ff
+#define EXTENDED_ID_MAX 0x1fffffff
+
+#define ERRORS_PRINTED 5
+//==============================================================================
+//types:
+
+typedef enum
+{
+	WantedNone,
+	WantedBulk,
+	WantedPriority,
+	WantedBoth
+
+} WantedT;
+//==============================================================================
+//variables:
+
+static uint64_t privateSeed = 88172645463325252ULL;
+
+static CanBusSubscriptionT privateSubscriptions[2][SUBSCRIPTIONS_MAX];
+static CanBusFilterBlockT privateBlocks[BLOCKS_COUNT];
+static CanBusFilterSetT privateSets[2] =
+{
+	{ privateSubscriptions[0], 0, false },
+	{ privateSubscriptions[1], 0, true }
+};
+
+static uint64_t privateErrors;
+static uint64_t privateMisrouted; //bulk frames taken by a bank of FIFO1
+//==============================================================================
+//functions:
+
+static uint32_t privateRandom()
+{
+	privateSeed ^= privateSeed << 13;
+	privateSeed ^= privateSeed >> 7;
+	privateSeed ^= privateSeed << 17;
+
+	return (uint32_t)privateSeed;
+}
+//------------------------------------------------------------------------------
+static void privateAdd(uint8_t port, uint32_t first, uint32_t last, uint8_t flags)
+{
+	CanBusFilterSetT* set = &privateSets[port];
+
+	privateSubscriptions[port][set->Count++] = (CanBusSubscriptionT){ first, last, flags };
+}
+//------------------------------------------------------------------------------
+static void privateClear()
+{
+	privateSets[0].Count = 0;
+	privateSets[1].Count = 0;
+}
+//------------------------------------------------------------------------------
+/// @brief the bank the controller takes: 32 bit over 16 bit, list over mask, the lower number
+static const CanBusFilterBankT* privateAccept(const CanBusFilterPlanT* plan, bool isSlave, const CanBusFrameT* frame)
+{
+	const CanBusFilterBankT* accepted = NULL;
+
+	for (uint8_t i = 0; i < plan->BanksCount; i++)
+	{
+		const CanBusFilterBankT* bank = &plan->Banks[i];
+
+		if ((bank->Number >= plan->SlaveStartBank) != isSlave || !CanBusFilterBankMatch(bank, frame))
+		{
+			continue;
+		}
+
+		if (!accepted
+			|| bank->Is32Bit > accepted->Is32Bit
+			|| (bank->Is32Bit == accepted->Is32Bit && bank->IsList > accepted->IsList))
+		{
+			accepted = bank;
+		}
+	}
+
+	return accepted;
+}
+//------------------------------------------------------------------------------
+static WantedT privateGetWanted(const CanBusFilterSetT* set, const CanBusFrameT* frame)
+{
+	WantedT wanted = WantedNone;
+
+	for (uint16_t i = 0; i < set->Count; i++)
+	{
+		const CanBusSubscriptionT* subscription = &set->Subscriptions[i];
+
+		if (((subscription->Flags ^ frame->Flags) & CAN_BUS_FRAME_EXTENDED)
+			|| frame->Id < subscription->First
+			|| frame->Id > subscription->Last)
+		{
+			continue;
+		}
+
+		WantedT kind = subscription->Flags & CAN_BUS_SUBSCRIPTION_PRIORITY ? WantedPriority : WantedBulk;
+
+		if (wanted && wanted != kind)
+		{
+			return WantedBoth;
+		}
+
+		wanted = kind;
+	}
+
+	return wanted;
+}
+//------------------------------------------------------------------------------
+static void privateError(const char* text, const CanBusFrameT* frame)
+{
+	if (++privateErrors < ERRORS_PRINTED)
+	{
+		printf("\nFAIL: %s, id %x%s", text, frame->Id, frame->Flags & CAN_BUS_FRAME_EXTENDED ? " ext" : "");
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief compiles both ports, then every standard identifier, the edges of the extended
+ * subscriptions and uniform extended samples go through the model of the controller
+ */
+static void privateRun(const char* name)
+{
+	CanBusFilterPlanT plan;
+	struct timespec start;
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	CanBusFilterCompile(privateSets, 2, privateBlocks, BLOCKS_COUNT, &plan);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	printf("%-16s %5.2f ms banks %2u CAN2SB %2u merges %3u |",
+			name,
+			(end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6,
+			plan.BanksCount,
+			plan.SlaveStartBank,
+			plan.Merges);
+
+	for (uint8_t port = 0; port < 2; port++)
+	{
+		const CanBusFilterSetT* set = &privateSets[port];
+		uint64_t others[2] = { 0 }; //the unwanted traffic: standard, extended
+		uint64_t unwanted[2] = { 0 }; //of it accepted by the banks
+
+		for (uint8_t extended = 0; extended < 2; extended++)
+		{
+			uint32_t samples = extended ? EXTENDED_SAMPLES : STANDARD_ID_MAX + 1;
+			uint32_t edges = extended ? set->Count * 2 : 0;
+
+			for (uint32_t i = 0; i < samples + edges; i++)
+			{
+				CanBusFrameT frame = { .Flags = extended ? CAN_BUS_FRAME_EXTENDED : 0 };
+
+				if (!extended)
+				{
+					frame.Id = i;
+				}
+				else if (i < samples)
+				{
+					frame.Id = privateRandom() & EXTENDED_ID_MAX;
+				}
+				else
+				{
+					const CanBusSubscriptionT* subscription = &set->Subscriptions[(i - samples) / 2];
+
+					if (!(subscription->Flags & CAN_BUS_FRAME_EXTENDED))
+					{
+						continue;
+					}
+
+					frame.Id = (i & 1) ? subscription->Last : subscription->First;
+				}
+
+				WantedT wanted = privateGetWanted(set, &frame);
+				const CanBusFilterBankT* bank = privateAccept(&plan, set->IsSlave, &frame);
+
+				if (wanted && !bank)
+				{
+					privateError("a subscribed frame is lost", &frame);
+				}
+
+				if (wanted == WantedPriority && plan.Covered[port] < (1ULL << 29) && bank && bank->Fifo != 1)
+				{
+					privateError("a priority frame is not on FIFO1", &frame);
+				}
+
+				if (wanted == WantedBulk && bank && bank->Fifo != 0)
+				{
+					privateMisrouted++;
+				}
+
+				//the software filter of a soft plan drops what the banks let through
+				bool isPassed = plan.IsExact[port] || CanBusFilterSetMatch(set, &frame);
+
+				if (bank && isPassed != (wanted != WantedNone))
+				{
+					privateError("the software filter differs from the subscriptions", &frame);
+				}
+
+				if (i < samples && !wanted)
+				{
+					others[extended]++;
+					unwanted[extended] += bank != NULL;
+				}
+			}
+		}
+
+		printf(" port %u: %2u banks %-5s accepted unwanted std %5.1f%% ext %7.4f%% of the unwanted traffic |",
+				port + 1,
+				plan.SetBanks[port],
+				plan.IsExact[port] ? "exact" : "soft",
+				others[0] ? 100.0 * unwanted[0] / others[0] : 0,
+				others[1] ? 100.0 * unwanted[1] / others[1] : 0);
+	}
+
+	printf(" bulk via FIFO1 %llu, errors %llu\n", (unsigned long long)privateMisrouted, (unsigned long long)privateErrors);
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	//the defaults of the component
+	for (uint8_t port = 0; port < 2; port++)
+	{
+		privateAdd(port, 0, 0x7f, CAN_BUS_SUBSCRIPTION_PRIORITY);
+		privateAdd(port, 0x80, STANDARD_ID_MAX, 0);
+		privateAdd(port, 0, EXTENDED_ID_MAX, CAN_BUS_FRAME_EXTENDED);
+	}
+
+	privateRun("defaults");
+
+	//a few single identifiers
+	privateClear();
+
+	for (uint8_t i = 0; i < 12; i++)
+	{
+		uint32_t id = privateRandom() % (STANDARD_ID_MAX + 1);
+
+		privateAdd(0, id, id, i < 3 ? CAN_BUS_SUBSCRIPTION_PRIORITY : 0);
+	}
+
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		uint32_t id = privateRandom() & EXTENDED_ID_MAX;
+
+		privateAdd(1, id, id, CAN_BUS_FRAME_EXTENDED | (i < 2 ? CAN_BUS_SUBSCRIPTION_PRIORITY : 0));
+	}
+
+	privateRun("few singles");
+
+	//scattered singles beyond the banks
+	for (uint16_t count = 60; count <= 240; count *= 2)
+	{
+		char name[32];
+
+		privateClear();
+
+		for (uint16_t i = 0; i < count; i++)
+		{
+			uint32_t id = privateRandom() % (STANDARD_ID_MAX + 1);
+
+			privateAdd(0, id, id, i < count / 10 ? CAN_BUS_SUBSCRIPTION_PRIORITY : 0);
+		}
+
+		for (uint16_t i = 0; i < count / 2; i++)
+		{
+			uint32_t id = privateRandom() & EXTENDED_ID_MAX;
+
+			privateAdd(1, id, id, CAN_BUS_FRAME_EXTENDED);
+		}
+
+		snprintf(name, sizeof(name), "%u+%u singles", count, count / 2);
+		privateRun(name);
+	}
+
+	//the unaligned standard ranges, the extended blocks of J1939 PGNs
+	privateClear();
+
+	privateAdd(0, 0x010, 0x01f, CAN_BUS_SUBSCRIPTION_PRIORITY);
+	privateAdd(0, 0x123, 0x456, 0);
+	privateAdd(0, 0x701, 0x77f, 0);
+	privateAdd(0, 0x581, 0x581, 0);
+
+	privateAdd(1, 0x18fef100, 0x18fef1ff, CAN_BUS_FRAME_EXTENDED);
+	privateAdd(1, 0x0cf00400, 0x0cf004ff, CAN_BUS_FRAME_EXTENDED | CAN_BUS_SUBSCRIPTION_PRIORITY);
+	privateAdd(1, 0x18eaff00, 0x18eaffff, CAN_BUS_FRAME_EXTENDED);
+	privateAdd(1, 0x100, 0x2ff, 0);
+	privateAdd(1, 0x18da0001, 0x18da00fe, CAN_BUS_FRAME_EXTENDED);
+
+	privateRun("ranges");
+
+	//many unaligned ranges: the blocks are joined
+	privateClear();
+
+	for (uint8_t i = 0; i < 40; i++)
+	{
+		uint32_t first = privateRandom() % (STANDARD_ID_MAX + 1);
+		uint32_t length = privateRandom() % 24;
+
+		privateAdd(0, first, first + length > STANDARD_ID_MAX ? STANDARD_ID_MAX : first + length, 0);
+	}
+
+	for (uint8_t i = 0; i < 20; i++)
+	{
+		uint32_t first = privateRandom() & EXTENDED_ID_MAX;
+		uint32_t length = privateRandom() % 300;
+
+		privateAdd(1, first, first + length > EXTENDED_ID_MAX ? EXTENDED_ID_MAX : first + length, CAN_BUS_FRAME_EXTENDED);
+	}
+
+	privateRun("60 ranges");
+
+	//more blocks than the work memory: accept all and the software filter
+	privateClear();
+
+	for (uint8_t i = 0; i < 200; i++)
+	{
+		uint32_t first = privateRandom() & EXTENDED_ID_MAX;
+		uint32_t length = 1000 + privateRandom() % 3000;
+
+		privateAdd(i & 1, first, first + length > EXTENDED_ID_MAX ? EXTENDED_ID_MAX : first + length, CAN_BUS_FRAME_EXTENDED);
+	}
+
+	privateRun("block overflow");
+
+	if (privateErrors || privateMisrouted)
+	{
+		printf("FAIL: the plans lose frames, misroute them or differ from the software filter\n");
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
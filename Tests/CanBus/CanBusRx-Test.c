@@ -0,0 +1,475 @@
+//==============================================================================
+//includes:
+
+#include "CanBus/CanBusRing.h"
+#include "CanBus/CanBusFilter.h"
+#include <stdio.h>
+#include <string.h>
+//==============================================================================
+//defines:
+
+#define RUN_TIME 20000000 //us of the bus, 1 Mbit/s: one bit per us
+#define ISR_ENTRY_TIME 1 //us
+#define ISR_FRAME_TIME 1 //us per mailbox, ~170 cycles
+#define TASK_FRAME_TIME 4 //us of the listeners per frame
+
+#define HARDWARE_FIFO_SIZE 3
+#define URGENT_ID_END 0x80 //the priority filter: standard 0x000..0x07f
+#define HISTOGRAM_BINS 2001 //10 us bins up to 20 ms
+
+#define RING_OPERATIONS 1000000
+//==============================================================================
+//types:
+
+typedef struct
+{
+	CanBusFrameT Frame;
+	uint64_t Time;
+
+} HardwareEntryT;
+//------------------------------------------------------------------------------
+/// @brief the receive FIFO of bxCAN: three mailboxes, the last one is overwritten on an overrun
+typedef struct
+{
+	HardwareEntryT Entries[HARDWARE_FIFO_SIZE];
+	uint8_t Count;
+
+} HardwareFifoT;
+//------------------------------------------------------------------------------
+/// @brief by the class of the frame: [0] - bulk, [1] - urgent
+typedef struct
+{
+	const char* Name;
+	bool IsDual;
+
+	uint64_t Frames[2];
+	uint64_t FifoLost[2];
+	uint64_t RingLost[2];
+	uint64_t Delivered[2];
+	uint64_t LatencySum[2];
+	uint64_t LatencyMax[2];
+	uint32_t Histogram[2][HISTOGRAM_BINS];
+
+} ResultT;
+//==============================================================================
+//variables:
+
+static uint64_t privateSeed;
+
+static CanBusFrameT privateBulkFrames[128];
+static CanBusFrameT privatePriorityFrames[32];
+static uint64_t privateStamps[2][256]; //the receive time of each entry of the rings
+//==============================================================================
+//functions:
+
+static uint32_t privateRandom()
+{
+	privateSeed ^= privateSeed << 13;
+	privateSeed ^= privateSeed >> 7;
+	privateSeed ^= privateSeed << 17;
+
+	return (uint32_t)privateSeed;
+}
+//------------------------------------------------------------------------------
+static double privateRandomUnit()
+{
+	return (privateRandom() & 0xffffff) / (double)0x1000000;
+}
+//------------------------------------------------------------------------------
+/// @brief bits of a standard data frame on the line with its stuffing, up to the end of the interframe space
+static uint32_t privateGetFrameBits(const CanBusFrameT* frame)
+{
+	uint8_t bits[128];
+	uint32_t count = 0;
+
+	bits[count++] = 0;
+
+	for (int8_t i = 10; i >= 0; i--)
+	{
+		bits[count++] = (frame->Id >> i) & 1;
+	}
+
+	//RTR, IDE, r0
+	bits[count++] = 0;
+	bits[count++] = 0;
+	bits[count++] = 0;
+
+	for (int8_t i = 3; i >= 0; i--)
+	{
+		bits[count++] = (frame->Dlc >> i) & 1;
+	}
+
+	for (uint8_t byte = 0; byte < frame->Dlc; byte++)
+	{
+		for (int8_t i = 7; i >= 0; i--)
+		{
+			bits[count++] = (frame->Data[byte] >> i) & 1;
+		}
+	}
+
+	uint16_t crc = 0;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint8_t next = bits[i] ^ ((crc >> 14) & 1);
+
+		crc = (crc << 1) & 0x7fff;
+
+		if (next)
+		{
+			crc ^= 0x4599;
+		}
+	}
+
+	for (int8_t i = 14; i >= 0; i--)
+	{
+		bits[count++] = (crc >> i) & 1;
+	}
+
+	uint32_t stuffing = 0;
+	uint8_t run = 1;
+
+	for (uint32_t i = 1; i < count; i++)
+	{
+		if (bits[i] != bits[i - 1])
+		{
+			run = 1;
+		}
+		else if (++run == 5)
+		{
+			stuffing++;
+			run = 0; //the stuff bit breaks the run
+		}
+	}
+
+	//CRC delimiter, ACK, EOF, IFS
+	return count + stuffing + 1 + 2 + 7 + 3;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief back to back frames against the FIFOs, the RX0/RX1 interrupts and the task of the component.
+ * The interrupts are masked by the higher ones and the critical sections, the task is preempted.
+ */
+static void privateRun(ResultT* result, uint64_t seed, double urgentShare)
+{
+	CanBusFilterT priority = { .Id = 0x000, .Mask = 0x780 };
+	CanBusFilterBankT banks[2];
+	CanBusRingT rings[2];
+	HardwareFifoT fifos[2];
+
+	privateSeed = seed;
+
+	CanBusFilterEncodeMask32(&priority, 0, 1, &banks[0]);
+	banks[1] = (CanBusFilterBankT){ .Number = 1, .Fifo = 0, .Is32Bit = true };
+
+	CanBusRingInit(&rings[0], privateBulkFrames, 0x7f);
+	CanBusRingInit(&rings[1], privatePriorityFrames, 0x1f);
+	memset(fifos, 0, sizeof(fifos));
+
+	CanBusFrameT onBus = { 0 };
+	uint64_t frameEnd = 0;
+	uint64_t cpuBlockedUntil = 0;
+	uint64_t taskBlockedUntil = 0;
+	uint64_t busyUntil = 0;
+	uint64_t nextBlock = 0;
+	uint64_t nextTaskBlock = 0;
+	int8_t isrFifo = -1; //in service
+
+	for (uint64_t time = 0; time < RUN_TIME; time++)
+	{
+		if (time == frameEnd)
+		{
+			if (time)
+			{
+				uint8_t fifo = 0;
+
+				for (uint8_t i = 0; i < 2 && result->IsDual; i++)
+				{
+					if (CanBusFilterBankMatch(&banks[i], &onBus))
+					{
+						fifo = banks[i].Fifo;
+						break;
+					}
+				}
+
+				HardwareFifoT* hardware = &fifos[fifo];
+
+				result->Frames[onBus.Id < URGENT_ID_END]++;
+
+				if (hardware->Count == HARDWARE_FIFO_SIZE)
+				{
+					result->FifoLost[hardware->Entries[HARDWARE_FIFO_SIZE - 1].Frame.Id < URGENT_ID_END]++;
+					hardware->Count--;
+				}
+
+				hardware->Entries[hardware->Count].Frame = onBus;
+				hardware->Entries[hardware->Count].Time = time;
+				hardware->Count++;
+			}
+
+			onBus.Id = privateRandomUnit() < urgentShare
+						? privateRandom() % URGENT_ID_END
+						: URGENT_ID_END + privateRandom() % (0x800 - URGENT_ID_END);
+			onBus.Dlc = privateRandom() % 9;
+			onBus.Flags = 0;
+
+			for (uint8_t i = 0; i < 8; i++)
+			{
+				onBus.Data[i] = privateRandom();
+			}
+
+			frameEnd = time + privateGetFrameBits(&onBus);
+		}
+
+		//the interrupts masked: the higher ones (Ethernet), the critical sections, the waits of the flash
+		if (time >= nextBlock)
+		{
+			double random = privateRandomUnit();
+			uint64_t duration;
+
+			if (random < 0.70)
+			{
+				duration = 5 + privateRandom() % 15;
+			}
+			else if (random < 0.97)
+			{
+				duration = 30 + privateRandom() % 120;
+			}
+			else
+			{
+				duration = 200 + privateRandom() % 500;
+			}
+
+			cpuBlockedUntil = time + duration;
+			nextBlock = time + duration + 100 + privateRandom() % 900;
+		}
+
+		//the task preempted by the higher tasks (net, MQTT)
+		if (time >= nextTaskBlock)
+		{
+			uint64_t duration = privateRandomUnit() < 0.9 ? 50 + privateRandom() % 450 : 1000 + privateRandom() % 3000;
+
+			taskBlockedUntil = time + duration;
+			nextTaskBlock = time + duration + 2000 + privateRandom() % 8000;
+		}
+
+		if (time < cpuBlockedUntil || time < busyUntil)
+		{
+			continue;
+		}
+
+		//RX1 preempts RX0 between the mailboxes
+		int8_t fifo = fifos[1].Count ? 1 : fifos[0].Count ? 0 : -1;
+
+		if (fifo >= 0)
+		{
+			HardwareFifoT* hardware = &fifos[fifo];
+			CanBusFrameT* entry = CanBusRingReserve(&rings[fifo]);
+
+			if (entry)
+			{
+				*entry = hardware->Entries[0].Frame;
+				privateStamps[fifo][rings[fifo].Head] = hardware->Entries[0].Time;
+				CanBusRingCommit(&rings[fifo]);
+			}
+			else
+			{
+				result->RingLost[hardware->Entries[0].Frame.Id < URGENT_ID_END]++;
+			}
+
+			memmove(hardware->Entries, hardware->Entries + 1, sizeof(HardwareEntryT) * (HARDWARE_FIFO_SIZE - 1));
+			hardware->Count--;
+
+			busyUntil = time + ISR_FRAME_TIME + (isrFifo != fifo ? ISR_ENTRY_TIME : 0);
+			isrFifo = hardware->Count ? fifo : -1;
+			continue;
+		}
+
+		isrFifo = -1;
+
+		if (time < taskBlockedUntil)
+		{
+			continue;
+		}
+
+		//the task: the priority ring before each frame of the bulk one
+		int8_t ring = CanBusRingGetCount(&rings[1]) ? 1 : CanBusRingGetCount(&rings[0]) ? 0 : -1;
+
+		if (ring < 0)
+		{
+			continue;
+		}
+
+		CanBusFrameT* frame = CanBusRingPeek(&rings[ring]);
+		uint8_t class = frame->Id < URGENT_ID_END;
+		uint64_t latency = time + TASK_FRAME_TIME - privateStamps[ring][rings[ring].Tail];
+
+		CanBusRingRelease(&rings[ring]);
+
+		result->Delivered[class]++;
+		result->LatencySum[class] += latency;
+
+		if (latency > result->LatencyMax[class])
+		{
+			result->LatencyMax[class] = latency;
+		}
+
+		result->Histogram[class][latency / 10 < HISTOGRAM_BINS - 1 ? latency / 10 : HISTOGRAM_BINS - 1]++;
+		busyUntil = time + TASK_FRAME_TIME;
+	}
+}
+//------------------------------------------------------------------------------
+static uint64_t privateGetPercentile(const uint32_t* histogram, uint64_t count, double part)
+{
+	uint64_t wanted = (uint64_t)(count * part);
+	uint64_t sum = 0;
+
+	for (uint32_t i = 0; i < HISTOGRAM_BINS; i++)
+	{
+		sum += histogram[i];
+
+		if (sum > wanted)
+		{
+			return i * 10;
+		}
+	}
+
+	return HISTOGRAM_BINS * 10;
+}
+//------------------------------------------------------------------------------
+/// @return the errors of the order under the interleaved producer and consumer
+static uint32_t privateRingRun()
+{
+	CanBusFrameT frames[8];
+	CanBusRingT ring;
+	uint32_t in = 0;
+	uint32_t out = 0;
+	uint32_t errors = 0;
+
+	CanBusRingInit(&ring, frames, 7);
+
+	for (uint32_t i = 0; i < RING_OPERATIONS; i++)
+	{
+		if (privateRandom() & 1)
+		{
+			CanBusFrameT* frame = CanBusRingReserve(&ring);
+
+			if (frame)
+			{
+				frame->Id = in++;
+				CanBusRingCommit(&ring);
+			}
+			else if (CanBusRingGetCount(&ring) != 7)
+			{
+				errors++;
+			}
+		}
+		else
+		{
+			CanBusFrameT* frame = CanBusRingPeek(&ring);
+
+			if (frame)
+			{
+				errors += frame->Id != out++;
+				CanBusRingRelease(&ring);
+			}
+		}
+	}
+
+	printf("ring: %u in, %u out, %u errors\n", in, out, errors);
+
+	return errors;
+}
+//------------------------------------------------------------------------------
+/// @return the errors of the priority bank over the standard identifiers as data, remote and extended frames
+static uint32_t privateFilterRun()
+{
+	CanBusFilterT priority = { .Id = 0x000, .Mask = 0x780 };
+	CanBusFilterBankT bank;
+	uint32_t errors = 0;
+
+	CanBusFilterEncodeMask32(&priority, 0, 1, &bank);
+
+	for (uint32_t id = 0; id < 0x800; id++)
+	{
+		CanBusFrameT frame = { .Id = id };
+
+		errors += CanBusFilterBankMatch(&bank, &frame) != (id < URGENT_ID_END);
+
+		frame.Flags = CAN_BUS_FRAME_REMOTE;
+		errors += CanBusFilterBankMatch(&bank, &frame) != (id < URGENT_ID_END);
+
+		frame.Flags = CAN_BUS_FRAME_EXTENDED;
+		errors += CanBusFilterBankMatch(&bank, &frame);
+	}
+
+	printf("filter: %u errors\n", errors);
+
+	return errors;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	static const double shares[] = { 0.10, 0.25 };
+	static ResultT results[2];
+	bool isValid = true;
+
+	privateSeed = 88172645463325252ULL;
+
+	if (privateRingRun() || privateFilterRun())
+	{
+		printf("FAIL: the ring or the filter\n");
+		return 1;
+	}
+
+	for (uint8_t i = 0; i < sizeof(shares) / sizeof(shares[0]); i++)
+	{
+		memset(results, 0, sizeof(results));
+
+		results[0].Name = "FIFO0 only";
+		results[1].Name = "FIFO0+FIFO1";
+		results[1].IsDual = true;
+
+		for (uint8_t j = 0; j < 2; j++)
+		{
+			ResultT* result = &results[j];
+
+			privateRun(result, 1234567 + i, shares[i]);
+
+			printf("%4.0f%% urgent, %-12s frames %llu/%llu  fifo lost urgent %llu (%.3f%%) bulk %llu (%.3f%%)  ring lost %llu/%llu"
+					"  urgent latency avg %llu p99 %llu max %llu us  bulk p99 %llu us\n",
+					shares[i] * 100,
+					result->Name,
+					(unsigned long long)result->Frames[1],
+					(unsigned long long)result->Frames[0],
+					(unsigned long long)result->FifoLost[1],
+					100.0 * result->FifoLost[1] / result->Frames[1],
+					(unsigned long long)result->FifoLost[0],
+					100.0 * result->FifoLost[0] / result->Frames[0],
+					(unsigned long long)result->RingLost[1],
+					(unsigned long long)result->RingLost[0],
+					(unsigned long long)(result->LatencySum[1] / (result->Delivered[1] ? result->Delivered[1] : 1)),
+					(unsigned long long)privateGetPercentile(result->Histogram[1], result->Delivered[1], 0.99),
+					(unsigned long long)result->LatencyMax[1],
+					(unsigned long long)privateGetPercentile(result->Histogram[0], result->Delivered[0], 0.99));
+
+			isValid &= !result->RingLost[0] && !result->RingLost[1];
+		}
+
+		//FIFO1 keeps the urgent frames: far fewer of them are lost than on FIFO0 alone
+		isValid &= results[1].FifoLost[1] * 4 < results[0].FifoLost[1];
+	}
+
+	if (!isValid)
+	{
+		printf("FAIL: the urgent frames are lost or the rings overflow\n");
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
@@ -0,0 +1,235 @@
+//==============================================================================
+//includes:
+
+#include "CanBus/CanBusTime.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+//==============================================================================
+//defines:
+
+#define TIMER_FREQUENCY 84000000ULL //TIM5
+#define TICKS_PER_BIT 672 //8 us bits at 125 kbit/s
+#define TIME_BASE 5000000 //us of the system time base at the init
+
+#define EXTENSION_READS 10000000
+#define SAMPLES_MAX 200000
+//==============================================================================
+//variables:
+
+static uint64_t privateSeed = 88172645463325252ULL;
+
+static double privateErrors[SAMPLES_MAX]; //us, the hardware stamps placed on the timer
+static double privateIsrErrors[SAMPLES_MAX]; //us, the time of the interrupt
+//==============================================================================
+//functions:
+
+static uint32_t privateRandom()
+{
+	privateSeed ^= privateSeed << 13;
+	privateSeed ^= privateSeed >> 7;
+	privateSeed ^= privateSeed << 17;
+
+	return (uint32_t)privateSeed;
+}
+//------------------------------------------------------------------------------
+static double privateRandomUnit()
+{
+	return (privateRandom() & 0xffffff) / (double)0x1000000;
+}
+//------------------------------------------------------------------------------
+static int privateCompare(const void* a, const void* b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+
+	return x < y ? -1 : x > y;
+}
+//------------------------------------------------------------------------------
+/// @return the errors: the extended time differs from the ticks or goes back
+static uint32_t privateExtensionRun()
+{
+	CanBusTimeT time;
+	uint64_t ticks = 0xfffffff0;
+	uint64_t last = 0;
+	uint32_t errors = 0;
+
+	//monotonic across the wraps when read once per wrap at least
+	CanBusTimeInit(&time, TIMER_FREQUENCY, 0xfffffff0, 0);
+
+	for (uint32_t i = 0; i < EXTENSION_READS; i++)
+	{
+		ticks += privateRandom() % (TIMER_FREQUENCY * 50);
+
+		uint64_t value = CanBusTimeExtend(&time, (uint32_t)ticks);
+
+		errors += value != ticks || value < last;
+		last = value;
+	}
+
+	printf("extension: %.0f s of timer, %u wraps, errors %u, to us %llu\n",
+			(double)ticks / TIMER_FREQUENCY,
+			(uint32_t)(ticks >> 32),
+			errors,
+			(unsigned long long)CanBusTimeToMicroseconds(&time, ticks));
+
+	return errors;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the frames of a bus whose bit clock drifts from TIM5: the TTCM stamps of the controller
+ * are placed on the extended timer by CanBusTimeSyncStamp after a random latency of the interrupt
+ * @return false - the extension failed, the time went back or the stamps are not better than the interrupt
+ */
+static bool privateRun(const char* name, double ppm, double gap, bool isRestarted, uint64_t seconds)
+{
+	uint64_t ticks = 0x12345; //true ticks since the start of the test
+	uint32_t start = 0xfff00000; //TIM5 wraps 4096 ticks after the init
+	CanBusTimeT time;
+	CanBusTimeSyncT sync;
+
+	privateSeed = 1234 + (uint64_t)(ppm * 10) + (uint64_t)gap;
+
+	CanBusTimeInit(&time, TIMER_FREQUENCY, start, TIME_BASE);
+	CanBusTimeSyncInit(&sync, TICKS_PER_BIT);
+
+	double phase = privateRandomUnit() * TICKS_PER_BIT * 65536.0; //the CAN timer started at an unknown time
+	double rate = 1.0 + ppm * 1e-6;
+	uint32_t count = 0;
+	uint32_t errors = 0;
+	uint64_t lastMicroseconds = 0;
+	uint64_t nextTask = 0;
+	uint64_t lastRead = 0;
+
+	while (ticks < seconds * TIMER_FREQUENCY)
+	{
+		//the task reads the time every 100 ms at least
+		while (nextTask < ticks)
+		{
+			if (nextTask >= lastRead)
+			{
+				CanBusTimeExtend(&time, (uint32_t)(start + nextTask));
+				lastRead = nextTask;
+			}
+
+			nextTask += TIMER_FREQUENCY / 10;
+		}
+
+		//a frame: its SOF, the stamp and the end of the frame
+		CanBusFrameT frame =
+		{
+			.Id = privateRandom() & 0x7ff,
+			.Dlc = privateRandom() % 9,
+			.Flags = privateRandom() & 1 ? CAN_BUS_FRAME_EXTENDED : 0
+		};
+
+		uint64_t sof = ticks;
+		uint16_t stamp = (uint16_t)(uint64_t)(((double)sof - phase) * rate / TICKS_PER_BIT);
+		double bits = CanBusTimeGetFrameBits(&frame) * (1.0 + 0.2 * privateRandomUnit()); //the stuff bits
+		uint64_t valid = sof + (uint64_t)(bits * TICKS_PER_BIT / rate);
+
+		//the latency of the interrupt: mostly short, the masked sections, the rare long blocks
+		double random = privateRandomUnit();
+		double latency = random < 0.8 ? 0.5 + 3 * privateRandomUnit()
+						: random < 0.99 ? 20 + 200 * privateRandomUnit()
+						: 500 + 3000 * privateRandomUnit();
+
+		uint64_t isr = valid + (uint64_t)(latency * 84);
+
+		//the FIFO is read in order
+		if (isr < lastRead)
+		{
+			isr = lastRead;
+		}
+
+		lastRead = isr;
+
+		uint64_t now = CanBusTimeExtend(&time, (uint32_t)(start + isr));
+
+		errors += now - start != isr;
+
+		uint64_t stamped = CanBusTimeSyncStamp(&sync, now, stamp, CanBusTimeGetFrameBits(&frame));
+		uint64_t microseconds = CanBusTimeToMicroseconds(&time, stamped);
+		double trueMicroseconds = TIME_BASE + (double)sof / 84.0;
+
+		if (count < SAMPLES_MAX)
+		{
+			privateErrors[count] = fabs((double)microseconds - trueMicroseconds);
+			privateIsrErrors[count] = (double)CanBusTimeToMicroseconds(&time, now) - trueMicroseconds;
+			count++;
+		}
+
+		//no jumps back beyond the reordering by the latency of the interrupt
+		errors += microseconds + 1000 < lastMicroseconds;
+		lastMicroseconds = microseconds;
+
+		//the recovery from bus-off: the CAN timer restarts
+		if (isRestarted && ticks > seconds * TIMER_FREQUENCY / 2)
+		{
+			isRestarted = false;
+			phase = (double)ticks + privateRandomUnit() * TICKS_PER_BIT * 65536.0;
+		}
+
+		ticks = isr > valid ? valid + (uint64_t)(gap * 84000 * privateRandomUnit() * 2) + 3 * TICKS_PER_BIT : valid;
+		ticks += 3 * TICKS_PER_BIT; //the intermission
+	}
+
+	double errorMax = 0;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		errorMax = privateErrors[i] > errorMax ? privateErrors[i] : errorMax;
+	}
+
+	qsort(privateErrors, count, sizeof(double), privateCompare);
+	qsort(privateIsrErrors, count, sizeof(double), privateCompare);
+
+	double error99 = privateErrors[count * 99 / 100];
+	double isrError50 = privateIsrErrors[count / 2];
+
+	printf("%-26s frames %7u  hw error p50 %5.1f p99 %6.1f max %7.1f us | isr stamp p50 %6.1f p99 %7.1f us | steps %u relocks %u errors %u\n",
+			name,
+			count,
+			privateErrors[count / 2],
+			error99,
+			errorMax,
+			isrError50,
+			privateIsrErrors[count * 99 / 100],
+			sync.Steps,
+			sync.Relocks,
+			errors);
+
+	return !errors && error99 < isrError50;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	if (privateExtensionRun())
+	{
+		printf("FAIL: the extension\n");
+		return 1;
+	}
+
+	bool isValid = privateRun("0 ppm, 1 ms gaps", 0, 1, false, 60);
+
+	isValid &= privateRun("0 ppm, back to back", 0, 0, false, 60);
+	isValid &= privateRun("+100 ppm, 1 ms gaps", 100, 1, false, 60);
+	isValid &= privateRun("-100 ppm, 1 ms gaps", -100, 1, false, 60);
+	isValid &= privateRun("+200 ppm, 100 ms gaps", 200, 100, false, 600);
+	isValid &= privateRun("-200 ppm, 100 ms gaps", -200, 100, false, 600);
+	isValid &= privateRun("0 ppm, restart", 0, 1, true, 60);
+
+	//p99 of the placed stamps below the median of the interrupt time in every run
+	if (!isValid)
+	{
+		printf("FAIL: the stamps\n");
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
@@ -0,0 +1,425 @@
+//==============================================================================
+//includes:
+
+#include "Cobs/Cobs.h"
+#include "Cobs/CobsPort.h"
+#include "Crc/Crc.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+//==============================================================================
+//defines:
+
+#define PAYLOAD_SIZE_MAX 4096
+#define RUNS 20000
+#define SMALL_SIZES 600 //the first runs take all the sizes up to it
+#define CORRUPT_PERIOD 10 //every n-th frame has one bit flipped
+#define CHUNK_SIZE_MAX 300 //the stream comes in random chunks as from DMA or a socket
+
+#define BAUD_RATE 921600 //8N1
+#define THROUGHPUT_BYTES 20000000 //of each payload size on the host
+
+#define REPLY_BUFFER_SIZE 64
+//==============================================================================
+//variables:
+
+static CrcEngineT privateCrc;
+static uint32_t privateCrcTable[CRC_TABLE_SIZE(4)];
+
+static uint8_t privateText[1 << 16]; //the bytes out of the frames
+static uint32_t privateTextSize;
+
+static uint8_t privateFrame[PAYLOAD_SIZE_MAX]; //the last frame of the listener
+static uint32_t privateFrameSize;
+static uint32_t privateFrames;
+
+static uint8_t privatePayload[PAYLOAD_SIZE_MAX];
+static uint8_t privateEncoded[COBS_FRAME_SIZE(PAYLOAD_SIZE_MAX)];
+static uint8_t privateStream[COBS_FRAME_SIZE(PAYLOAD_SIZE_MAX) + 64];
+static uint8_t privateBuffer[PAYLOAD_SIZE_MAX + 8];
+
+static uint32_t privateChecks;
+static uint32_t privateFailures;
+static uint32_t privateSeed = 7;
+
+//the port of CobsPortT: its transmit is the one of the adapters
+static xPortT privatePort;
+static CobsPortT privateCobsPort;
+static uint8_t privatePortBuffer[COBS_FRAME_SIZE(REPLY_BUFFER_SIZE)];
+static uint8_t privateReplyBuffer[REPLY_BUFFER_SIZE];
+static uint8_t privateLine[256];
+static uint32_t privateLineSize;
+static int privateTask = 1;
+static int privateOtherTask = 2;
+static TaskHandle_t privateCurrentTask = &privateTask;
+//==============================================================================
+//functions:
+
+static uint32_t privateRandom()
+{
+	privateSeed = privateSeed * 1103515245 + 12345;
+
+	return privateSeed >> 8;
+}
+//------------------------------------------------------------------------------
+static double privateGetTime()
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return time.tv_sec + time.tv_nsec * 1e-9;
+}
+//------------------------------------------------------------------------------
+static void privateCheck(bool isValid, uint32_t line)
+{
+	privateChecks++;
+
+	if (!isValid)
+	{
+		privateFailures++;
+		printf("FAIL: line %u\n", line);
+	}
+}
+//------------------------------------------------------------------------------
+static uint32_t privateCrc32(const void* data, uint32_t size)
+{
+	return CrcEngineCalculate(&privateCrc, data, size);
+}
+//------------------------------------------------------------------------------
+void xRxReceiverReceive(xRxReceiverT* receiver, uint8_t* data, uint32_t size)
+{
+	memcpy(privateText + privateTextSize, data, size);
+	privateTextSize += size;
+}
+//------------------------------------------------------------------------------
+static void privateFrameListener(void* context, uint8_t* payload, uint32_t size)
+{
+	memcpy(privateFrame, payload, size);
+	privateFrameSize = size;
+	privateFrames++;
+}
+//------------------------------------------------------------------------------
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+	return privateCurrentTask;
+}
+//------------------------------------------------------------------------------
+void xPortStartTransmission(xPortT* port)
+{
+}
+//------------------------------------------------------------------------------
+int xPortTransmitData(xPortT* port, void* data, uint32_t size)
+{
+	if (CobsPortTransmit(&privateCobsPort, data, size))
+	{
+		return size;
+	}
+
+	memcpy(privateLine + privateLineSize, data, size);
+	privateLineSize += size;
+
+	return size;
+}
+//------------------------------------------------------------------------------
+void xPortEndTransmission(xPortT* port)
+{
+}
+//------------------------------------------------------------------------------
+/// @brief the terminal of the port: answers the request, another task writes to the port meanwhile
+static void privatePortHandler(xPortT* port, RxDataPacketT* packet)
+{
+	xPortTransmitData(port, "[", 1);
+	xPortTransmitData(port, packet->Data, packet->Size);
+	xPortTransmitData(port, "]\r", 2);
+
+	privateCurrentTask = &privateOtherTask;
+	xPortTransmitData(port, "log\r", 4);
+	privateCurrentTask = &privateTask;
+}
+//------------------------------------------------------------------------------
+/// @brief random payloads: random bytes, mostly zeros, no zeros
+static void privatePayloadFill(uint32_t size)
+{
+	uint8_t mode = privateRandom() % 3;
+
+	for (uint32_t i = 0; i < size; i++)
+	{
+		if (mode == 0)
+		{
+			privatePayload[i] = privateRandom();
+		}
+		else if (mode == 1)
+		{
+			privatePayload[i] = privateRandom() % 4 ? 0 : privateRandom();
+		}
+		else
+		{
+			privatePayload[i] = privateRandom() % 255 + 1;
+		}
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief round trips of the codec, "help\r<frame>ls\r" in random chunks, a tenth of the frames corrupted
+static void privateReceiverRun(CobsReceiverT* receiver)
+{
+	for (uint32_t run = 0; run < RUNS; run++)
+	{
+		uint32_t size = run < SMALL_SIZES ? run : privateRandom() % PAYLOAD_SIZE_MAX;
+
+		privatePayloadFill(size);
+
+		uint32_t encoded = CobsEncode(privatePayload, size, privateEncoded);
+
+		privateCheck(encoded <= COBS_ENCODED_SIZE(size)
+					&& !memchr(privateEncoded, 0, encoded)
+					&& CobsDecode(privateEncoded, encoded) == (int32_t)size
+					&& !memcmp(privateEncoded, privatePayload, size), __LINE__);
+
+		uint32_t frame = CobsFrameEncode(privatePayload, size, privateCrc32, privateEncoded);
+		uint32_t streamSize = 0;
+
+		privateCheck(frame <= COBS_FRAME_SIZE(size), __LINE__);
+
+		memcpy(privateStream, "help\r", 5);
+		streamSize = 5;
+		memcpy(privateStream + streamSize, privateEncoded, frame);
+		streamSize += frame;
+		memcpy(privateStream + streamSize, "ls\r", 3);
+		streamSize += 3;
+
+		bool isCorrupt = run % CORRUPT_PERIOD == CORRUPT_PERIOD - 1;
+
+		if (isCorrupt)
+		{
+			uint8_t* byte = privateStream + 5 + 1 + privateRandom() % (frame - 2);
+
+			*byte ^= 1 << (privateRandom() % 8);
+
+			if (!*byte)
+			{
+				*byte = 0x55;
+			}
+		}
+
+		uint32_t errors = receiver->Statistic.CrcErrors + receiver->Statistic.Errors;
+
+		privateTextSize = 0;
+		privateFrames = 0;
+
+		for (uint32_t i = 0; i < streamSize;)
+		{
+			uint32_t chunk = 1 + privateRandom() % CHUNK_SIZE_MAX;
+
+			if (chunk > streamSize - i)
+			{
+				chunk = streamSize - i;
+			}
+
+			CobsReceiverReceive(receiver, privateStream + i, chunk);
+			i += chunk;
+		}
+
+		if (isCorrupt)
+		{
+			privateCheck(!privateFrames && receiver->Statistic.CrcErrors + receiver->Statistic.Errors == errors + 1, __LINE__);
+		}
+		else
+		{
+			privateCheck(privateFrames == 1
+						&& privateFrameSize == size
+						&& !memcmp(privateFrame, privatePayload, size)
+						&& privateTextSize == 8
+						&& !memcmp(privateText, "help\rls\r", 8), __LINE__);
+		}
+
+		CobsReceiverClear(receiver);
+	}
+
+	//a frame without its opening delimiter, then "\0\0<frame>\0": the receiver resyncs
+	uint32_t frame = CobsFrameEncode("abc", 3, privateCrc32, privateEncoded);
+
+	memcpy(privateStream, privateEncoded + 1, frame - 1);
+	privateStream[frame - 1] = 0;
+	memcpy(privateStream + frame, privateEncoded, frame);
+
+	privateFrames = 0;
+	CobsReceiverReceive(receiver, privateStream, frame * 2);
+
+	privateCheck(privateFrames == 1 && privateFrameSize == 3, __LINE__);
+}
+//------------------------------------------------------------------------------
+/// @brief the shared listener of the adapters: the output of the handler goes back in one frame
+static void privatePortRun()
+{
+	CobsPortInitT init =
+	{
+		.Handler = privatePortHandler,
+		.Crc = privateCrc32,
+		.Buffer = privatePortBuffer,
+		.BufferSize = sizeof(privatePortBuffer),
+		.ReplyBuffer = privateReplyBuffer,
+		.ReplyBufferSize = sizeof(privateReplyBuffer)
+	};
+
+	privateCheck(CobsPortInit(&privateCobsPort, &privatePort, &init) == xResultAccept, __LINE__);
+
+	uint32_t frame = CobsFrameEncode("ls", 2, privateCrc32, privateEncoded);
+
+	privateLineSize = 0;
+	CobsReceiverReceive(&privateCobsPort.Receiver, privateEncoded, frame);
+
+	//the line: the frame of "[ls]\r" after the output of the other task
+	privateCheck(privateLineSize > 4 && !memcmp(privateLine, "log\r", 4), __LINE__);
+
+	CobsReceiverInitT receiverInit =
+	{
+		.Listener = privateFrameListener,
+		.Crc = privateCrc32,
+		.Buffer = privateBuffer,
+		.BufferSize = sizeof(privateBuffer)
+	};
+
+	CobsReceiverT receiver;
+
+	CobsReceiverInit(&receiver, &receiverInit);
+
+	privateFrames = 0;
+	CobsReceiverReceive(&receiver, privateLine + 4, privateLineSize - 4);
+
+	privateCheck(privateFrames == 1 && privateFrameSize == 5 && !memcmp(privateFrame, "[ls]\r", 5), __LINE__);
+	privateCheck(privateCobsPort.Statistic.Replies == 1 && !privateCobsPort.Statistic.ReplyOverflows, __LINE__);
+
+	//the reply is cut to the buffer, the frame still fits the buffer of the receiver
+	memset(privatePayload, 'x', REPLY_BUFFER_SIZE);
+	frame = CobsFrameEncode(privatePayload, REPLY_BUFFER_SIZE, privateCrc32, privateEncoded);
+
+	privateLineSize = 0;
+	CobsReceiverReceive(&privateCobsPort.Receiver, privateEncoded, frame);
+
+	privateFrames = 0;
+	CobsReceiverReceive(&receiver, privateLine + 4, privateLineSize - 4);
+
+	privateCheck(privateFrames == 1 && privateFrameSize == REPLY_BUFFER_SIZE && privateCobsPort.Statistic.ReplyOverflows, __LINE__);
+
+	//a reply buffer whose frame does not fit the receiver
+	init.ReplyBufferSize = sizeof(privatePortBuffer);
+
+	privateCheck(CobsPortInit(&privateCobsPort, &privatePort, &init) == xResultError, __LINE__);
+}
+//------------------------------------------------------------------------------
+/// @brief the bytes on the line and the host time of COBS frames against hex text lines
+static void privateThroughputRun(CobsReceiverT* receiver)
+{
+	static const uint32_t sizes[] = { 16, 64, 256, 1024, 4096 };
+	static const char hex[] = "0123456789abcdef";
+	static char line[PAYLOAD_SIZE_MAX * 2 + 1];
+
+	printf("payload  cobs wire  hex wire  cobs eff  hex eff  @%u: cobs KB/s hex KB/s | host MB/s: cobs enc+dec  hex enc+dec\n",
+			BAUD_RATE);
+
+	for (uint8_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++)
+	{
+		uint32_t size = sizes[k];
+		uint32_t rounds = THROUGHPUT_BYTES / size;
+		volatile uint32_t sink = 0;
+
+		for (uint32_t i = 0; i < size; i++)
+		{
+			privatePayload[i] = privateRandom();
+		}
+
+		uint32_t frame = CobsFrameEncode(privatePayload, size, privateCrc32, privateEncoded);
+		uint32_t text = size * 2 + 1;
+
+		double start = privateGetTime();
+
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			uint32_t encoded = CobsFrameEncode(privatePayload, size, privateCrc32, privateEncoded);
+
+			CobsReceiverReceive(receiver, privateEncoded, encoded);
+			sink += privateFrameSize;
+		}
+
+		double cobsTime = privateGetTime() - start;
+
+		start = privateGetTime();
+
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			for (uint32_t i = 0; i < size; i++)
+			{
+				line[i * 2] = hex[privatePayload[i] >> 4];
+				line[i * 2 + 1] = hex[privatePayload[i] & 15];
+			}
+
+			line[size * 2] = '\r';
+
+			for (uint32_t i = 0; i < size; i++)
+			{
+				char high = line[i * 2];
+				char low = line[i * 2 + 1];
+
+				privateFrame[i] = ((high <= '9' ? high - '0' : high - 'a' + 10) << 4) | (low <= '9' ? low - '0' : low - 'a' + 10);
+			}
+
+			sink += privateFrame[0];
+		}
+
+		double hexTime = privateGetTime() - start;
+
+		printf("%7u  %9u  %8u  %7.1f%%  %6.1f%%  %17.1f %8.1f | %21.0f %12.0f\n",
+				size,
+				frame,
+				text,
+				100.0 * size / frame,
+				100.0 * size / text,
+				BAUD_RATE / 10000.0 * size / frame,
+				BAUD_RATE / 10000.0 * size / text,
+				(double)rounds * size / cobsTime / 1e6,
+				(double)rounds * size / hexTime / 1e6);
+	}
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	CrcEngineInit(&privateCrc, &CrcParameters[CrcVariant32], privateCrcTable, 4);
+
+	xRxReceiverT text;
+	CobsReceiverT receiver;
+	CobsReceiverInitT init =
+	{
+		.Text = &text,
+		.Listener = privateFrameListener,
+		.Crc = privateCrc32,
+		.Buffer = privateBuffer,
+		.BufferSize = sizeof(privateBuffer)
+	};
+
+	CobsReceiverInit(&receiver, &init);
+
+	privateReceiverRun(&receiver);
+	privatePortRun();
+
+	printf("cobs: %u checks, %u failures, crc errors %u, errors %u, overflows %u\n",
+			privateChecks,
+			privateFailures,
+			receiver.Statistic.CrcErrors,
+			receiver.Statistic.Errors,
+			receiver.Statistic.Overflows);
+
+	privateThroughputRun(&receiver);
+
+	if (privateFailures)
+	{
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
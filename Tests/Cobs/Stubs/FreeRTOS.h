@@ -0,0 +1,11 @@
+//==============================================================================
+//header:
+
+#ifndef _FREERTOS_H_
+#define _FREERTOS_H_
+//==============================================================================
+//includes:
+
+#include <stdint.h>
+//==============================================================================
+#endif //_FREERTOS_H_
@@ -0,0 +1,15 @@
+//==============================================================================
+//header:
+
+#ifndef _TASK_H_
+#define _TASK_H_
+//==============================================================================
+//types:
+
+typedef void* TaskHandle_t;
+//==============================================================================
+//functions:
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void); //the task of the test
+//==============================================================================
+#endif //_TASK_H_
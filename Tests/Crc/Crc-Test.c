@@ -0,0 +1,202 @@
+//==============================================================================
+//includes:
+
+#include "Crc/Crc.h"
+#include "Crc/Adapters/STM32F4xx/CrcHardware-Adapter.h"
+#include <stdio.h>
+#include <time.h>
+//==============================================================================
+//defines:
+
+#define BUFFER_SIZE (1 << 20)
+#define BUFFER_OFFSET_MAX 8 //the unaligned starts
+
+#define RUNS 2000 //of each variant and each size of the tables
+#define SMALL_SIZES 100 //the first runs take all the sizes up to it
+#define RUN_SIZE_MAX 3000
+
+#define TABLE_ROUNDS 64 //of BUFFER_SIZE in the throughput
+#define BITWISE_ROUNDS 4
+//==============================================================================
+//variables:
+
+//the CRC unit and its memory to memory stream: main.h of the stubs
+CRC_TypeDef CrcStubUnit;
+uint32_t DmaStubFailPeriod;
+uint32_t DmaStubStarts;
+
+static CRC_HandleTypeDef privateHandle = { &CrcStubUnit };
+static DMA_HandleTypeDef privateDma;
+static CrcHardwareAdapterT privateHardware;
+
+static uint32_t privateTables[CrcVariantsCount][CRC_TABLE_SIZE(8)];
+static uint8_t privateBuffer[BUFFER_SIZE + BUFFER_OFFSET_MAX * 8] __attribute__((aligned(8)));
+
+static uint32_t privateChecks;
+static uint32_t privateFailures;
+static uint32_t privateSeed = 1;
+//==============================================================================
+//functions:
+
+static uint32_t privateRandom()
+{
+	privateSeed = privateSeed * 1103515245 + 12345;
+
+	return privateSeed >> 8;
+}
+//------------------------------------------------------------------------------
+static double privateGetTime()
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return time.tv_sec + time.tv_nsec * 1e-9;
+}
+//------------------------------------------------------------------------------
+static void privateCheck(bool isValid, const char* name, const char* path, uint32_t size, uint32_t split)
+{
+	privateChecks++;
+
+	if (!isValid)
+	{
+		privateFailures++;
+		printf("FAIL: %s %s, size %u, split %u\n", name, path, size, split);
+	}
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the tables of 1, 4 and 8 slices against the bitwise engine at random sizes and offsets:
+ * in one call, resumed from a finished CRC after a split by words, on the unit by the CPU and by DMA
+ */
+static void privateVariantRun(CrcVariantT variant)
+{
+	static const uint8_t slices[] = { 1, 4, 8 };
+	const CrcParametersT* parameters = &CrcParameters[variant];
+	CrcEngineT bitwise;
+
+	CrcEngineInit(&bitwise, parameters, NULL, 0);
+
+	privateCheck(CrcEngineCalculate(&bitwise, "123456789", 9) == parameters->Check, parameters->Name, "check", 9, 0);
+
+	for (uint8_t i = 0; i < sizeof(slices); i++)
+	{
+		CrcEngineT engine;
+
+		CrcEngineInit(&engine, parameters, privateTables[variant], slices[i]);
+
+		for (uint32_t run = 0; run < RUNS; run++)
+		{
+			uint32_t offset = privateRandom() % BUFFER_OFFSET_MAX;
+			uint32_t size = run < SMALL_SIZES ? run : privateRandom() % RUN_SIZE_MAX;
+			uint32_t split = (privateRandom() % (size + 1)) & ~3u;
+			const uint8_t* data = privateBuffer + offset;
+			uint32_t expected = CrcEngineCalculate(&bitwise, data, size);
+
+			privateCheck(CrcEngineCalculate(&engine, data, size) == expected, parameters->Name, "tables", size, split);
+
+			uint32_t crc = CrcEngineCalculate(&engine, data, split);
+
+			crc = CrcEngineFinish(&engine, CrcEngineUpdate(&engine, CrcEngineResume(&engine, crc), data + split, size - split));
+
+			privateCheck(crc == expected, parameters->Name, "resumed", size, split);
+
+			if (!CrcHardwareAdapterIsSupported(parameters))
+			{
+				continue;
+			}
+
+			uint32_t state = CrcEngineResume(&engine, CrcEngineCalculate(&engine, data, split));
+
+			state = CrcHardwareAdapterUpdate(&privateHardware, &engine, state, data + split, size - split);
+
+			privateCheck(CrcEngineFinish(&engine, state) == expected, parameters->Name, "unit by the CPU", size, split);
+
+			//the stream takes the aligned words, a third of the transfers fail and are repeated by the CPU
+			DmaStubFailPeriod = run % 3;
+
+			expected = CrcEngineCalculate(&bitwise, privateBuffer, size);
+			state = CrcEngineResume(&engine, CrcEngineCalculate(&engine, privateBuffer, split));
+			state = CrcHardwareAdapterUpdateDma(&privateHardware, &engine, state, privateBuffer + split, size - split);
+
+			privateCheck(CrcEngineFinish(&engine, state) == expected, parameters->Name, "unit by DMA", size, split);
+		}
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief MB/s of the bitwise engine and of the tables of 1, 4 and 8 slices
+static void privateThroughputRun(CrcVariantT variant)
+{
+	static const uint8_t slices[] = { 0, 1, 4, 8 };
+	const CrcParametersT* parameters = &CrcParameters[variant];
+
+	printf("  %-20s", parameters->Name);
+
+	for (uint8_t i = 0; i < sizeof(slices); i++)
+	{
+		CrcEngineT engine;
+		uint32_t rounds = slices[i] ? TABLE_ROUNDS : BITWISE_ROUNDS;
+		volatile uint32_t crc = 0;
+
+		CrcEngineInit(&engine, parameters, slices[i] ? privateTables[variant] : NULL, slices[i]);
+
+		double start = privateGetTime();
+
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			crc += CrcEngineCalculate(&engine, privateBuffer, BUFFER_SIZE);
+		}
+
+		printf(" s%u %7.1f MB/s", slices[i], rounds / (privateGetTime() - start));
+	}
+
+	printf("\n");
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	CrcHardwareAdapterInitT hardwareInit = { &privateHandle, &privateDma, 100 };
+
+	CrcHardwareAdapterInit(&privateHardware, &hardwareInit);
+
+	for (uint32_t i = 0; i < sizeof(privateBuffer); i++)
+	{
+		privateBuffer[i] = privateRandom();
+	}
+
+	//CRC-32/STM32 is CRC-32/MPEG-2 over the bytes of each word in reverse order
+	CrcEngineT mpeg2;
+
+	CrcEngineInit(&mpeg2, &CrcParameters[CrcVariant32Mpeg2], NULL, 0);
+
+	privateCheck(CrcEngineCalculate(&mpeg2, "432187659", 9) == CrcParameters[CrcVariant32Stm32].Check,
+					CrcParameters[CrcVariant32Stm32].Name, "by CRC-32/MPEG-2", 9, 0);
+
+	for (uint8_t variant = 0; variant < CrcVariantsCount; variant++)
+	{
+		privateVariantRun((CrcVariantT)variant);
+	}
+
+	printf("%u checks, %u failures, %u DMA transfers, %u DMA errors repeated by the CPU\n",
+			privateChecks,
+			privateFailures,
+			privateHardware.Statistic.DmaTransfers,
+			privateHardware.Statistic.DmaErrors);
+
+	for (uint8_t variant = 0; variant < CrcVariantsCount; variant++)
+	{
+		privateThroughputRun((CrcVariantT)variant);
+	}
+
+	if (privateFailures)
+	{
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
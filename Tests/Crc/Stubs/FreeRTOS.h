@@ -0,0 +1,19 @@
+//==============================================================================
+//header:
+
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+//==============================================================================
+//types:
+
+typedef long BaseType_t;
+//==============================================================================
+//defines:
+
+#define pdFALSE 0
+#define pdTRUE 1
+
+#define pdMS_TO_TICKS(time) (time)
+#define portYIELD_FROM_ISR(woken) (void)(woken)
+//==============================================================================
+#endif //INC_FREERTOS_H
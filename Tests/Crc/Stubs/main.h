@@ -0,0 +1,153 @@
+//==============================================================================
+//header:
+
+#ifndef _MAIN_H_
+#define _MAIN_H_
+//==============================================================================
+//includes:
+
+#include <stdint.h>
+#include <string.h>
+//==============================================================================
+//defines:
+
+#define CRC_CR_RESET 1
+
+#define CCMDATARAM_BASE 0x10000000UL
+#define CCMDATARAM_END 0x1000FFFFUL
+
+#define HAL_OK 0
+#define HAL_DMA_ERROR_NONE 0
+
+#define WRITE_REG(REG, VAL) CrcStubWrite(&(REG), (VAL))
+#define READ_REG(REG) ((REG))
+//==============================================================================
+//types:
+
+/// @brief the registers of the CRC unit as in stm32f4xx.h, the test points the handle to an instance of it
+typedef struct
+{
+	volatile uint32_t DR;
+	volatile uint8_t IDR;
+	uint8_t RESERVED0;
+	uint16_t RESERVED1;
+	volatile uint32_t CR;
+
+} CRC_TypeDef;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	CRC_TypeDef* Instance;
+
+} CRC_HandleTypeDef;
+//------------------------------------------------------------------------------
+typedef struct __DMA_HandleTypeDef
+{
+	void* Parent;
+
+	void (*XferCpltCallback)(struct __DMA_HandleTypeDef* dma);
+	void (*XferErrorCallback)(struct __DMA_HandleTypeDef* dma);
+	void (*XferHalfCpltCallback)(struct __DMA_HandleTypeDef* dma);
+	void (*XferAbortCallback)(struct __DMA_HandleTypeDef* dma);
+
+	uint32_t ErrorCode;
+
+} DMA_HandleTypeDef;
+//==============================================================================
+//export:
+
+extern CRC_TypeDef CrcStubUnit; //the only unit: the writes to its DR and CR are computed
+extern uint32_t DmaStubFailPeriod; //every n-th transfer fails after a wrong word, 0 - none
+extern uint32_t DmaStubStarts;
+//==============================================================================
+//functions:
+
+/// @brief a word written to DR goes through CRC-32/MPEG-2, RESET of CR loads the initial value
+static inline void CrcStubWrite(volatile uint32_t* reg, uint32_t value)
+{
+	if (reg == &CrcStubUnit.CR)
+	{
+		if (value & CRC_CR_RESET)
+		{
+			CrcStubUnit.DR = 0xffffffff;
+		}
+	}
+	else if (reg == &CrcStubUnit.DR)
+	{
+		value ^= CrcStubUnit.DR;
+
+		for (uint8_t i = 0; i < 32; i++)
+		{
+			value = (value & 0x80000000) ? (value << 1) ^ 0x04c11db7 : value << 1;
+		}
+
+		CrcStubUnit.DR = value;
+	}
+	else
+	{
+		*reg = value;
+	}
+}
+//------------------------------------------------------------------------------
+
+/// @brief the memory to memory stream, the addresses are 32 bit as on the board: the test is built without PIE
+static inline int HAL_DMA_Start_IT(DMA_HandleTypeDef* dma, uint32_t source, uint32_t destination, uint32_t count)
+{
+	volatile uint32_t* data = (volatile uint32_t*)(uintptr_t)destination;
+	const uint32_t* words = (const uint32_t*)(uintptr_t)source;
+
+	DmaStubStarts++;
+	dma->ErrorCode = HAL_DMA_ERROR_NONE;
+
+	if (DmaStubFailPeriod && DmaStubStarts % DmaStubFailPeriod == 0)
+	{
+		CrcStubWrite(data, 0x12345678);
+		dma->ErrorCode = 1;
+		dma->XferErrorCallback(dma);
+
+		return HAL_OK;
+	}
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		CrcStubWrite(data, words[i]);
+	}
+
+	dma->XferCpltCallback(dma);
+
+	return HAL_OK;
+}
+//------------------------------------------------------------------------------
+static inline int HAL_DMA_Abort(DMA_HandleTypeDef* dma)
+{
+	return HAL_OK;
+}
+//------------------------------------------------------------------------------
+static inline uint32_t __RBIT(uint32_t value)
+{
+	uint32_t result = 0;
+
+	for (uint8_t i = 0; i < 32; i++)
+	{
+		result = (result << 1) | (value & 1);
+		value >>= 1;
+	}
+
+	return result;
+}
+//------------------------------------------------------------------------------
+static inline uint32_t __REV(uint32_t value)
+{
+	return __builtin_bswap32(value);
+}
+//------------------------------------------------------------------------------
+static inline uint32_t __UNALIGNED_UINT32_READ(const void* data)
+{
+	uint32_t value;
+
+	memcpy(&value, data, sizeof(value));
+
+	return value;
+}
+//==============================================================================
+#endif //_MAIN_H_
@@ -0,0 +1,40 @@
+//==============================================================================
+//header:
+
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+//==============================================================================
+//types:
+
+/// @brief the binary semaphore of the DMA event: the transfers of the stub complete before they return
+typedef int* SemaphoreHandle_t;
+//==============================================================================
+//functions:
+
+static inline SemaphoreHandle_t xSemaphoreCreateBinary()
+{
+	static int semaphore;
+
+	return &semaphore;
+}
+//------------------------------------------------------------------------------
+static inline BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t* woken)
+{
+	*semaphore = 1;
+
+	return pdTRUE;
+}
+//------------------------------------------------------------------------------
+static inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, uint32_t timeout)
+{
+	if (!*semaphore)
+	{
+		return pdFALSE;
+	}
+
+	*semaphore = 0;
+
+	return pdTRUE;
+}
+//==============================================================================
+#endif //SEMAPHORE_H
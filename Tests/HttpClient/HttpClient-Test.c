@@ -0,0 +1,461 @@
+//==============================================================================
+//includes:
+
+#include "HttpClient/HttpClient.h"
+#include "HttpClient/HttpClient-ComponentConfig.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+//==============================================================================
+//defines:
+
+#define REPORTS 200
+#define SERVER_BUFFER_SIZE 4096
+
+#define REPORT_BODY "{\"uptime\":123456,\"heap\":20480,\"sequence\":%u}"
+//==============================================================================
+//types:
+
+/// @brief the answer of the stand-in server to each request
+typedef enum
+{
+	ServerChunked, //chunk extension and trailer
+	ServerContentLength,
+	ServerContinue, //100 Continue before the final response
+	ServerNoContent, //204, no body without a length
+	ServerUntilClose, //no length: the body ends with the connection
+	ServerCloseInPipeline, //two responses on a connection, the pipelined requests behind them are lost
+
+} ServerModeT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	const char* Name;
+	ServerModeT Mode;
+
+	const char* Response; //sent for each request
+	uint32_t BodySize; //body bytes the client passes on per response
+
+} ServerCaseT;
+//------------------------------------------------------------------------------
+/// @brief the server end of the socket pair, run by the receive of the client
+typedef struct
+{
+	int Socket;
+	ServerModeT Mode;
+
+	char Buffer[SERVER_BUFFER_SIZE];
+	uint32_t Size;
+	uint32_t Answered; //on the current connection
+
+	uint32_t Requests;
+	bool IsBroken; //a request is malformed or out of order
+	bool Reports[REPORTS]; //the sequence numbers received
+
+} ServerT;
+//==============================================================================
+//variables:
+
+static const ServerCaseT privateCases[] =
+{
+	{
+		"chunked", ServerChunked,
+		"HTTP/1.1 201 Created\r\nTransfer-Encoding: chunked\r\n\r\n"
+		"4;name=value\r\n{\"id\r\n7\r\n\":1234}\r\n0\r\nX-Checksum: 5f\r\n\r\n",
+		11
+	},
+	{
+		"content-length", ServerContentLength,
+		"HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: 11\r\n\r\n{\"id\":1234}",
+		11
+	},
+	{
+		"100 continue", ServerContinue,
+		"HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok",
+		2
+	},
+	{
+		"204 no content", ServerNoContent,
+		"HTTP/1.1 204 No Content\r\nServer: stand-in\r\n\r\n",
+		0
+	},
+	{
+		"until close", ServerUntilClose,
+		"HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n\r\n{\"id\":1234}",
+		11
+	},
+	{
+		"close in pipeline", ServerCloseInPipeline,
+		"HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok",
+		2
+	}
+};
+
+static ServerT privateServer;
+static int privateSocket = -1;
+
+static uint32_t privateBodyBytes;
+static uint32_t privateResponses;
+static uint16_t privateLastStatus;
+//==============================================================================
+//functions:
+
+static void privateServerClose()
+{
+	if (privateServer.Socket >= 0)
+	{
+		close(privateServer.Socket);
+		privateServer.Socket = -1;
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief checks the request at the head of the buffer: the headers of the client and the report in the body
+/// @return bytes of the request, 0 - not complete
+static uint32_t privateServerRequest(ServerT* server)
+{
+	server->Buffer[server->Size] = 0;
+
+	char* end = strstr(server->Buffer, "\r\n\r\n");
+
+	if (!end)
+	{
+		return 0;
+	}
+
+	uint32_t headerSize = end + 4 - server->Buffer;
+	char* length = strstr(server->Buffer, "Content-Length: ");
+
+	if (!length || length > end
+		|| memcmp(server->Buffer, HTTP_REPORT_METHOD " " HTTP_REPORT_PATH " HTTP/1.1\r\nHost: " HTTP_HOST "\r\n",
+					sizeof(HTTP_REPORT_METHOD " " HTTP_REPORT_PATH " HTTP/1.1\r\nHost: " HTTP_HOST "\r\n") - 1))
+	{
+		server->IsBroken = true;
+		return headerSize;
+	}
+
+	uint32_t bodySize = strtoul(length + sizeof("Content-Length: ") - 1, NULL, 10);
+
+	if (server->Size < headerSize + bodySize)
+	{
+		return 0;
+	}
+
+	uint32_t sequence;
+	char body[128];
+
+	memcpy(body, server->Buffer + headerSize, bodySize);
+	body[bodySize] = 0;
+
+	if (sscanf(body, REPORT_BODY, &sequence) != 1 || sequence >= REPORTS)
+	{
+		server->IsBroken = true;
+	}
+	else
+	{
+		server->Reports[sequence] = true;
+	}
+
+	return headerSize + bodySize;
+}
+//------------------------------------------------------------------------------
+/// @brief the server answers the complete requests it has received
+static void privateServerRun(const ServerCaseT* serverCase)
+{
+	ServerT* server = &privateServer;
+
+	while (server->Socket >= 0)
+	{
+		int received = recv(server->Socket, server->Buffer + server->Size, SERVER_BUFFER_SIZE - 1 - server->Size, MSG_DONTWAIT);
+
+		if (received == 0)
+		{
+			//the client closed the connection
+			privateServerClose();
+			return;
+		}
+
+		if (received < 0)
+		{
+			break;
+		}
+
+		server->Size += received;
+	}
+
+	uint32_t size;
+
+	while (server->Socket >= 0 && (size = privateServerRequest(server)))
+	{
+		memmove(server->Buffer, server->Buffer + size, server->Size - size);
+		server->Size -= size;
+		server->Requests++;
+
+		send(server->Socket, serverCase->Response, strlen(serverCase->Response), MSG_NOSIGNAL);
+		server->Answered++;
+
+		if (server->Mode == ServerUntilClose || (server->Mode == ServerCloseInPipeline && server->Answered == 2))
+		{
+			privateServerClose();
+		}
+	}
+}
+//------------------------------------------------------------------------------
+static xResult privateConnect(void* context)
+{
+	int sockets[2];
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets))
+	{
+		return xResultError;
+	}
+
+	privateSocket = sockets[0];
+
+	privateServerClose();
+	privateServer.Socket = sockets[1];
+	privateServer.Size = 0;
+	privateServer.Answered = 0;
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static int32_t privateTransmit(void* context, const void* data, uint32_t size)
+{
+	return send(privateSocket, data, size, MSG_NOSIGNAL);
+}
+//------------------------------------------------------------------------------
+/// @brief the server takes the requests sent so far, then the client receives without waiting
+static int32_t privateReceive(void* context, void* data, uint32_t size)
+{
+	privateServerRun(context);
+
+	int received = recv(privateSocket, data, size, MSG_DONTWAIT);
+
+	if (received < 0)
+	{
+		return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+	}
+
+	return received ? received : -1;
+}
+//------------------------------------------------------------------------------
+static void privateClose(void* context)
+{
+	close(privateSocket);
+	privateSocket = -1;
+}
+//------------------------------------------------------------------------------
+static void privateBody(void* context, uint16_t status, const uint8_t* data, uint32_t size)
+{
+	privateBodyBytes += size;
+}
+//------------------------------------------------------------------------------
+static void privateResponse(void* context, uint16_t status)
+{
+	privateLastStatus = status;
+	privateResponses++;
+}
+//------------------------------------------------------------------------------
+/// @brief the responses of the cases and a close-delimited one, fed a byte at a time
+static bool privateParserTest()
+{
+	char stream[1024] = "";
+	uint32_t bodySize = 0;
+
+	for (uint8_t i = 0; i < sizeof(privateCases) / sizeof(privateCases[0]); i++)
+	{
+		if (privateCases[i].Mode != ServerUntilClose && privateCases[i].Mode != ServerCloseInPipeline)
+		{
+			strcat(stream, privateCases[i].Response);
+			bodySize += privateCases[i].BodySize;
+		}
+	}
+
+	strcat(stream, "HTTP/1.0 404 Not Found\r\ncontent-length: 3\r\n\r\nxyz");
+	strcat(stream, privateCases[4].Response);
+	bodySize += 3 + privateCases[4].BodySize;
+
+	const uint16_t statuses[] = { 201, 200, 200, 204, 404, 200 };
+	uint8_t responses = 0;
+	uint32_t position = 0;
+	uint32_t length = strlen(stream);
+	HttpParserT parser;
+
+	HttpParserReset(&parser);
+	privateBodyBytes = 0;
+
+	while (position < length)
+	{
+		int32_t used = HttpParserReceive(&parser, (const uint8_t*)stream + position, 1, privateBody, NULL);
+
+		if (used < 0)
+		{
+			printf("FAIL: parser error at %u\n", position);
+			return false;
+		}
+
+		position += used;
+
+		if (parser.State == HttpParserComplete)
+		{
+			if (responses >= sizeof(statuses) / sizeof(statuses[0]) || parser.StatusCode != statuses[responses])
+			{
+				printf("FAIL: parser, response %u has status %u\n", responses, parser.StatusCode);
+				return false;
+			}
+
+			responses++;
+			HttpParserReset(&parser);
+		}
+	}
+
+	HttpParserClose(&parser);
+
+	if (parser.State != HttpParserComplete || parser.StatusCode != statuses[responses] || parser.KeepAlive)
+	{
+		printf("FAIL: parser, the body until close\n");
+		return false;
+	}
+
+	responses++;
+
+	printf("parser, a byte at a time: %u responses, %u body bytes\n", responses, privateBodyBytes);
+
+	return responses == sizeof(statuses) / sizeof(statuses[0]) && privateBodyBytes == bodySize;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the reports of HttpClient-Component through the pipeline of HTTP_PIPELINE_DEPTH to the stand-in server
+ * @return the reports are answered in order, each one arrived at the server
+ */
+static bool privateClientRun(const ServerCaseT* serverCase)
+{
+	static uint8_t memory[HTTP_PIPELINE_DEPTH * HTTP_REQUEST_SIZE + HTTP_RX_BUFFER_SIZE];
+	HttpClientT client;
+	HttpClientInitT init =
+	{
+		.Transport =
+		{
+			.Connect = privateConnect,
+			.Transmit = privateTransmit,
+			.Receive = privateReceive,
+			.Close = privateClose,
+			.Context = (void*)serverCase
+		},
+		.Host = HTTP_HOST,
+		.Headers = HTTP_HOST_AUTHORIZATION "\r\n",
+		.Memory = memory,
+		.MemorySize = sizeof(memory),
+		.SlotSize = HTTP_REQUEST_SIZE,
+		.PipelineDepth = HTTP_PIPELINE_DEPTH,
+		.RxBufferSize = HTTP_RX_BUFFER_SIZE,
+		.Response = privateResponse,
+		.Body = privateBody
+	};
+
+	memset(&privateServer, 0, sizeof(privateServer));
+	privateServer.Socket = -1;
+	privateServer.Mode = serverCase->Mode;
+
+	privateBodyBytes = 0;
+	privateResponses = 0;
+
+	if (HttpClientInit(&client, &init) != xResultAccept)
+	{
+		return false;
+	}
+
+	struct timespec start;
+	struct timespec end;
+	uint32_t queued = 0;
+	uint32_t passes = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	while (client.Statistic.Responses < REPORTS && passes++ < REPORTS * 100)
+	{
+		while (queued < REPORTS && HttpClientGetFreeSlots(&client))
+		{
+			char body[HTTP_REPORT_BUFFER_SIZE];
+			int size = snprintf(body, sizeof(body), REPORT_BODY, queued);
+
+			if (HttpClientRequest(&client, HTTP_REPORT_METHOD, HTTP_REPORT_PATH, "application/json", body, size) != xResultAccept)
+			{
+				return false;
+			}
+
+			queued++;
+		}
+
+		HttpClientHandler(&client);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	HttpClientClose(&client);
+	privateServerClose();
+
+	double time = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	HttpClientStatisticT* statistic = &client.Statistic;
+	uint32_t received = 0;
+
+	for (uint32_t i = 0; i < REPORTS; i++)
+	{
+		received += privateServer.Reports[i];
+	}
+
+	printf("%-18s %7.0f reports/s, %3u B sent + %3u B received per report, %3u connects, %3u resent\n",
+			serverCase->Name,
+			statistic->Responses / time,
+			statistic->TxBytes / (statistic->Responses ? statistic->Responses : 1),
+			statistic->RxBytes / (statistic->Responses ? statistic->Responses : 1),
+			statistic->Connects,
+			statistic->Resent);
+
+	return statistic->Responses == REPORTS
+			&& privateResponses == REPORTS
+			&& !statistic->Failures
+			&& received == REPORTS
+			&& !privateServer.IsBroken
+			&& privateBodyBytes == REPORTS * serverCase->BodySize;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	if (!privateParserTest())
+	{
+		printf("FAIL: parser\n");
+		return 1;
+	}
+
+	printf("%u reports over a socket pair, pipeline of %u:\n", REPORTS, HTTP_PIPELINE_DEPTH);
+
+	for (uint8_t i = 0; i < sizeof(privateCases) / sizeof(privateCases[0]); i++)
+	{
+		if (!privateClientRun(&privateCases[i]))
+		{
+			printf("FAIL: %s\n", privateCases[i].Name);
+			return 1;
+		}
+
+		//a connection per report when the body ends with it; the lost requests are sent again
+		bool isConnectionKept = privateCases[i].Mode != ServerUntilClose && privateCases[i].Mode != ServerCloseInPipeline;
+
+		if (isConnectionKept && (privateServer.Requests != REPORTS || privateLastStatus / 100 != 2))
+		{
+			printf("FAIL: %s, %u requests at the server\n", privateCases[i].Name, privateServer.Requests);
+			return 1;
+		}
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
@@ -0,0 +1,667 @@
+//==============================================================================
+//includes:
+
+#include "Modbus/ModbusRtu.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+//==============================================================================
+//defines:
+
+#define CRC_SLICES 4 //CRC_SOFTWARE_SLICES
+
+#define SLAVE_ADDRESS 5
+#define COILS 256
+#define REGISTERS 200
+
+#define LINE_SIZE 4096
+#define LINE_FRAMES 8
+#define LINE_LATENCY 25 //us from the end of the silence to the frame in the task
+#define DEFAULT_BAUD_RATE 115200
+
+#define BIT_RUNS 2000
+#define BENCH_TRANSACTIONS 20000
+#define FIXED_SILENCE 1750 //us, T3.5 above 19200 baud
+//==============================================================================
+//types:
+
+/// @brief the bytes on the line with the time of their stop bit
+typedef struct
+{
+	uint8_t Data[LINE_SIZE];
+	double Time[LINE_SIZE];
+	uint16_t Count;
+
+} LineT;
+//------------------------------------------------------------------------------
+/// @brief the frames cut by the silence as the adapter does
+typedef struct
+{
+	uint8_t Data[LINE_FRAMES][MODBUS_RTU_ADU_SIZE];
+	uint16_t Sizes[LINE_FRAMES];
+	double Ends[LINE_FRAMES]; //us, the frame is given to the task
+	uint8_t Count;
+
+} FramesT;
+//==============================================================================
+//variables:
+
+static double privateCharTime; //us of one character 8N1 and a parity or a second stop bit
+static double privateSilence; //us, T3.5
+static double privateTime; //us
+
+static uint8_t privateCoils[COILS / 8];
+static uint8_t privateInputs[COILS / 8];
+static uint16_t privateHolding[REGISTERS];
+static uint16_t privateInputRegisters[REGISTERS];
+static uint32_t privateWrites;
+static uint32_t privateCompletions;
+
+static uint32_t privateCrcTable[CRC_TABLE_SIZE(CRC_SLICES)];
+static CrcEngineT privateCrc;
+
+static ModbusSlaveT privateSlave;
+static ModbusMasterT privateMaster;
+
+static uint32_t privateFailures;
+static uint32_t privateSeed = 1;
+//==============================================================================
+//functions:
+
+static uint32_t privateRandom()
+{
+	privateSeed = privateSeed * 1103515245 + 12345;
+
+	return privateSeed >> 16;
+}
+//------------------------------------------------------------------------------
+static void privateCheck(bool isValid, uint32_t line)
+{
+	if (!isValid)
+	{
+		printf("FAIL: ModbusRtu-Test.c:%u\n", line);
+		privateFailures++;
+	}
+}
+//------------------------------------------------------------------------------
+static void privateLineSend(LineT* line, double start, const uint8_t* data, uint16_t size, double gap, int32_t gapIndex)
+{
+	double time = start;
+
+	for (uint16_t i = 0; i < size; i++)
+	{
+		time += i == gapIndex ? gap + privateCharTime : privateCharTime;
+
+		line->Data[line->Count] = data[i];
+		line->Time[line->Count++] = time;
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief the frame ends when no byte comes within the silence after the last stop bit
+static void privateLineCut(LineT* line, FramesT* frames)
+{
+	double silence = privateSilence > privateCharTime ? privateSilence : privateCharTime;
+	uint16_t size = 0;
+
+	frames->Count = 0;
+
+	for (uint16_t i = 0; i < line->Count; i++)
+	{
+		if (size < MODBUS_RTU_ADU_SIZE)
+		{
+			frames->Data[frames->Count][size] = line->Data[i];
+		}
+
+		size++;
+
+		if (i + 1 == line->Count || line->Time[i + 1] > line->Time[i] + silence)
+		{
+			frames->Sizes[frames->Count] = size > MODBUS_RTU_ADU_SIZE ? MODBUS_RTU_ADU_SIZE : size;
+			frames->Ends[frames->Count++] = line->Time[i] + privateSilence + LINE_LATENCY;
+			size = 0;
+		}
+	}
+
+	line->Count = 0;
+}
+//------------------------------------------------------------------------------
+static void privateSeal(uint8_t* frame, uint16_t size)
+{
+	uint16_t crc = ModbusRtuCrc(&privateCrc, frame, size);
+
+	frame[size] = crc;
+	frame[size + 1] = crc >> 8;
+}
+//------------------------------------------------------------------------------
+static void privateWriteListener(void* context, ModbusFunctionT function, uint16_t address, uint16_t count)
+{
+	privateWrites++;
+}
+//------------------------------------------------------------------------------
+static void privateComplete(ModbusRequestT* request)
+{
+	privateCompletions++;
+}
+//------------------------------------------------------------------------------
+static void privateSlaveInit()
+{
+	ModbusRegisterMapT map =
+	{
+		.Coils = privateCoils,
+		.CoilsCount = COILS,
+		.DiscreteInputs = privateInputs,
+		.DiscreteInputsCount = COILS,
+		.HoldingRegisters = privateHolding,
+		.HoldingRegistersCount = REGISTERS,
+		.InputRegisters = privateInputRegisters,
+		.InputRegistersCount = REGISTERS
+	};
+
+	memset(&privateSlave, 0, sizeof(privateSlave));
+
+	privateSlave.Address = SLAVE_ADDRESS;
+	privateSlave.Map = map;
+	privateSlave.WriteListener = privateWriteListener;
+	privateSlave.Crc = &privateCrc;
+
+	for (uint16_t i = 0; i < REGISTERS; i++)
+	{
+		privateHolding[i] = 0x1000 + i;
+		privateInputRegisters[i] = 0x2000 + i;
+	}
+
+	for (uint16_t i = 0; i < sizeof(privateCoils); i++)
+	{
+		privateCoils[i] = privateRandom();
+		privateInputs[i] = privateRandom();
+	}
+}
+//------------------------------------------------------------------------------
+static void privateMasterInit(uint32_t broadcastDelay)
+{
+	ModbusMasterInitT init =
+	{
+		.Timeout = 100,
+		.BroadcastDelay = broadcastDelay,
+		.ByteTimeUs = (uint32_t)privateCharTime,
+		.Crc = &privateCrc
+	};
+
+	ModbusMasterInit(&privateMaster, &init);
+}
+//------------------------------------------------------------------------------
+static void privateLineInit(uint32_t baudRate, bool isSilenceFixed)
+{
+	privateCharTime = 11e6 / baudRate;
+	privateSilence = isSilenceFixed && baudRate > 19200 ? FIXED_SILENCE : 3.5 * privateCharTime;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief one transaction through the line: the request, the slave answers in place
+ * @param isCorrupted a bit of the response is flipped
+ * @param isOtherSlave the response comes from another address with a valid CRC
+ */
+static void privateTransact(bool isCorrupted, bool isOtherSlave)
+{
+	static LineT line;
+	static FramesT frames;
+	uint8_t frame[MODBUS_RTU_ADU_SIZE];
+	uint16_t size = ModbusMasterStart(&privateMaster, (uint32_t)(privateTime / 1000), frame);
+
+	if (!size)
+	{
+		return;
+	}
+
+	privateLineSend(&line, privateTime, frame, size, 0, -1);
+	privateLineCut(&line, &frames);
+	privateTime = frames.Ends[frames.Count - 1];
+
+	for (uint8_t i = 0; i < frames.Count; i++)
+	{
+		uint8_t* request = frames.Data[i];
+		uint16_t responseSize = ModbusSlaveProcess(&privateSlave, request, frames.Sizes[i], request);
+
+		if (!responseSize)
+		{
+			continue;
+		}
+
+		if (isCorrupted)
+		{
+			request[responseSize / 2] ^= 0x10;
+		}
+
+		if (isOtherSlave)
+		{
+			request[0]++;
+			privateSeal(request, responseSize - 2);
+		}
+
+		privateLineSend(&line, privateTime, request, responseSize, 0, -1);
+	}
+
+	privateLineCut(&line, &frames);
+
+	for (uint8_t i = 0; i < frames.Count; i++)
+	{
+		privateTime = frames.Ends[i];
+		ModbusMasterReceive(&privateMaster, frames.Data[i], frames.Sizes[i]);
+	}
+}
+//------------------------------------------------------------------------------
+static inline uint8_t privateGetBit(const uint8_t* bits, uint16_t index)
+{
+	return (bits[index >> 3] >> (index & 7)) & 1;
+}
+//------------------------------------------------------------------------------
+/// @brief the functions 1, 2 and 15 at random offsets and counts against a bit by bit reference
+static void privateBitsRun()
+{
+	uint8_t bits[COILS / 8 + 1];
+	ModbusRequestT request = { .Slave = SLAVE_ADDRESS, .Complete = privateComplete };
+
+	for (uint32_t run = 0; run < BIT_RUNS; run++)
+	{
+		uint16_t offset = privateRandom() % REGISTERS;
+		uint16_t count = 1 + privateRandom() % (COILS - offset > 56 ? 56 : COILS - offset);
+		const uint8_t* map = run & 1 ? privateCoils : privateInputs;
+
+		request.Function = run & 1 ? ModbusFunctionReadCoils : ModbusFunctionReadDiscreteInputs;
+		request.Address = offset;
+		request.Count = count;
+		request.Bits = bits;
+
+		memset(bits, 0xaa, sizeof(bits));
+
+		privateCheck(ModbusMasterSubmit(&privateMaster, &request) == xResultAccept, __LINE__);
+		privateTransact(false, false);
+		privateCheck(request.State == ModbusRequestComplete, __LINE__);
+
+		for (uint16_t i = 0; i < count; i++)
+		{
+			privateCheck(privateGetBit(bits, i) == privateGetBit(map, offset + i), __LINE__);
+		}
+
+		//the unused bits of the last byte are zero
+		if (count & 7)
+		{
+			privateCheck((bits[(count - 1) >> 3] >> (count & 7)) == 0, __LINE__);
+		}
+
+		uint8_t values[8];
+		uint8_t before[sizeof(privateCoils)];
+
+		for (uint8_t i = 0; i < sizeof(values); i++)
+		{
+			values[i] = privateRandom();
+		}
+
+		memcpy(before, privateCoils, sizeof(before));
+
+		request.Function = ModbusFunctionWriteMultipleCoils;
+		request.Bits = values;
+
+		privateCheck(ModbusMasterSubmit(&privateMaster, &request) == xResultAccept, __LINE__);
+		privateTransact(false, false);
+		privateCheck(request.State == ModbusRequestComplete, __LINE__);
+
+		for (uint16_t i = 0; i < COILS; i++)
+		{
+			uint8_t expected = i >= offset && i < offset + count ? privateGetBit(values, i - offset) : privateGetBit(before, i);
+
+			privateCheck(privateGetBit(privateCoils, i) == expected, __LINE__);
+		}
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief the functions 3, 4, 5, 6, 16 and 23 at their largest counts
+static void privateRegistersRun()
+{
+	uint16_t registers[MODBUS_MAX_READ_REGISTERS + 5];
+	uint16_t writeRegisters[MODBUS_MAX_READ_WRITE_REGISTERS];
+	uint8_t on = 1;
+	ModbusRequestT request = { .Slave = SLAVE_ADDRESS, .Complete = privateComplete, .Registers = registers };
+
+	request.Function = ModbusFunctionReadHoldingRegisters;
+	request.Address = 10;
+	request.Count = MODBUS_MAX_READ_REGISTERS;
+	ModbusMasterSubmit(&privateMaster, &request);
+	privateTransact(false, false);
+	privateCheck(request.State == ModbusRequestComplete && registers[0] == 0x100a && registers[124] == 0x1000 + 134, __LINE__);
+
+	request.Function = ModbusFunctionReadInputRegisters;
+	request.Address = 75;
+	ModbusMasterSubmit(&privateMaster, &request);
+	privateTransact(false, false);
+	privateCheck(request.State == ModbusRequestComplete && registers[0] == 0x2000 + 75 && registers[124] == 0x2000 + 199, __LINE__);
+
+	request.Function = ModbusFunctionWriteSingleCoil;
+	request.Address = 3;
+	request.Bits = &on;
+	privateCoils[0] &= ~8;
+	ModbusMasterSubmit(&privateMaster, &request);
+	privateTransact(false, false);
+	privateCheck(request.State == ModbusRequestComplete && (privateCoils[0] & 8), __LINE__);
+
+	registers[0] = 0xbeef;
+	request.Function = ModbusFunctionWriteSingleRegister;
+	request.Address = 7;
+	ModbusMasterSubmit(&privateMaster, &request);
+	privateTransact(false, false);
+	privateCheck(request.State == ModbusRequestComplete && privateHolding[7] == 0xbeef, __LINE__);
+
+	for (uint16_t i = 0; i < MODBUS_MAX_WRITE_REGISTERS; i++)
+	{
+		registers[i] = 0x3000 + i;
+	}
+
+	request.Function = ModbusFunctionWriteMultipleRegisters;
+	request.Address = 50;
+	request.Count = MODBUS_MAX_WRITE_REGISTERS;
+	ModbusMasterSubmit(&privateMaster, &request);
+	privateTransact(false, false);
+	privateCheck(request.State == ModbusRequestComplete && privateHolding[50] == 0x3000 && privateHolding[172] == 0x3000 + 122, __LINE__);
+
+	for (uint16_t i = 0; i < MODBUS_MAX_READ_WRITE_REGISTERS; i++)
+	{
+		writeRegisters[i] = 0x4000 + i;
+	}
+
+	//the write of the function 23 is done before the read
+	request.Function = ModbusFunctionReadWriteMultipleRegisters;
+	request.Address = 0;
+	request.Count = MODBUS_MAX_READ_REGISTERS;
+	request.WriteAddress = 20;
+	request.WriteCount = MODBUS_MAX_READ_WRITE_REGISTERS;
+	request.WriteRegisters = writeRegisters;
+	ModbusMasterSubmit(&privateMaster, &request);
+	privateTransact(false, false);
+	privateCheck(request.State == ModbusRequestComplete
+					&& registers[19] == 0x1000 + 19
+					&& registers[20] == 0x4000
+					&& registers[124] == 0x4000 + 104, __LINE__);
+}
+//------------------------------------------------------------------------------
+static void privateExceptionsRun()
+{
+	uint16_t registers[20];
+	ModbusRequestT request =
+	{
+		.Slave = SLAVE_ADDRESS,
+		.Function = ModbusFunctionReadHoldingRegisters,
+		.Address = 190,
+		.Count = 20,
+		.Registers = registers,
+		.Complete = privateComplete
+	};
+
+	ModbusMasterSubmit(&privateMaster, &request);
+	privateTransact(false, false);
+	privateCheck(request.State == ModbusRequestException && request.Exception == ModbusExceptionIllegalDataAddress, __LINE__);
+
+	uint8_t function[16] = { SLAVE_ADDRESS, 7 };
+	privateSeal(function, 2);
+	privateCheck(ModbusSlaveProcess(&privateSlave, function, 4, function) == 5
+					&& function[1] == 0x87
+					&& function[2] == ModbusExceptionIllegalFunction, __LINE__);
+
+	uint8_t count[16] = { SLAVE_ADDRESS, 3, 0, 0, 0, MODBUS_MAX_READ_REGISTERS + 1 };
+	privateSeal(count, 6);
+	privateCheck(ModbusSlaveProcess(&privateSlave, count, 8, count) == 5
+					&& count[1] == 0x83
+					&& count[2] == ModbusExceptionIllegalDataValue, __LINE__);
+
+	//a single coil takes only 0xFF00 and 0x0000
+	uint8_t coil[16] = { SLAVE_ADDRESS, 5, 0, 1, 0x12, 0x34 };
+	privateSeal(coil, 6);
+	privateCheck(ModbusSlaveProcess(&privateSlave, coil, 8, coil) == 5 && coil[2] == ModbusExceptionIllegalDataValue, __LINE__);
+
+	request.Count = 0;
+	privateCheck(ModbusMasterSubmit(&privateMaster, &request) == xResultError, __LINE__);
+}
+//------------------------------------------------------------------------------
+/// @brief the timeouts, the foreign responses, the broadcast and the queue of the master
+static void privateMasterRun()
+{
+	uint16_t registers[10];
+	ModbusRequestT request =
+	{
+		.Slave = SLAVE_ADDRESS,
+		.Function = ModbusFunctionReadHoldingRegisters,
+		.Count = 10,
+		.Registers = registers,
+		.Complete = privateComplete
+	};
+
+	//a corrupted response: the CRC error, the request times out
+	double sent = privateTime;
+
+	ModbusMasterSubmit(&privateMaster, &request);
+	privateTransact(true, false);
+	privateCheck(request.State == ModbusRequestSent && privateMaster.Statistic.CrcErrors == 1, __LINE__);
+	ModbusMasterHandler(&privateMaster, (uint32_t)(sent / 1000) + 99);
+	privateCheck(request.State == ModbusRequestSent, __LINE__);
+	ModbusMasterHandler(&privateMaster, (uint32_t)(sent / 1000) + 102);
+	privateCheck(request.State == ModbusRequestTimeout
+					&& privateMaster.Statistic.Timeouts == 1
+					&& !privateMaster.Current, __LINE__);
+
+	//the response of another slave is not taken
+	ModbusMasterSubmit(&privateMaster, &request);
+	privateTransact(false, true);
+	privateCheck(request.State == ModbusRequestSent && privateMaster.Statistic.Unexpected == 1, __LINE__);
+	ModbusMasterHandler(&privateMaster, (uint32_t)(privateTime / 1000) + 200);
+	privateCheck(request.State == ModbusRequestTimeout, __LINE__);
+
+	//the other addresses are ignored by the slave
+	uint32_t ignored = privateSlave.Statistic.Ignored;
+
+	request.Slave = SLAVE_ADDRESS + 1;
+	ModbusMasterSubmit(&privateMaster, &request);
+	privateTransact(false, false);
+	privateCheck(privateSlave.Statistic.Ignored == ignored + 1 && request.State == ModbusRequestSent, __LINE__);
+
+	//the timeout of the slave and of the request
+	ModbusMasterHandler(&privateMaster, (uint32_t)(privateTime / 1000) + 1000);
+	privateCheck(ModbusMasterSetTimeout(&privateMaster, SLAVE_ADDRESS + 1, 20) == xResultAccept, __LINE__);
+
+	sent = privateTime;
+	ModbusMasterSubmit(&privateMaster, &request);
+	privateTransact(false, false);
+	ModbusMasterHandler(&privateMaster, (uint32_t)(sent / 1000) + 19);
+	privateCheck(request.State == ModbusRequestSent, __LINE__);
+	ModbusMasterHandler(&privateMaster, (uint32_t)(sent / 1000) + 22);
+	privateCheck(request.State == ModbusRequestTimeout, __LINE__);
+
+	request.Timeout = 5;
+	sent = privateTime;
+	ModbusMasterSubmit(&privateMaster, &request);
+	privateTransact(false, false);
+	ModbusMasterHandler(&privateMaster, (uint32_t)(sent / 1000) + 7);
+	privateCheck(request.State == ModbusRequestTimeout, __LINE__);
+	request.Timeout = 0;
+
+	//a broadcast write is applied without a response, it completes after the delay
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		registers[i] = 0x5550 + i;
+	}
+
+	uint32_t responses = privateMaster.Statistic.Responses;
+
+	request.Slave = MODBUS_BROADCAST_ADDRESS;
+	request.Function = ModbusFunctionWriteMultipleRegisters;
+	request.Address = 100;
+	request.Count = 4;
+	sent = privateTime;
+	ModbusMasterSubmit(&privateMaster, &request);
+	privateTransact(false, false);
+	privateCheck(privateHolding[100] == 0x5550 && privateHolding[103] == 0x5553 && request.State == ModbusRequestSent, __LINE__);
+	ModbusMasterHandler(&privateMaster, (uint32_t)(sent / 1000) + 52);
+	privateCheck(request.State == ModbusRequestComplete && privateMaster.Statistic.Responses == responses, __LINE__);
+
+	request.Function = ModbusFunctionReadHoldingRegisters;
+	privateCheck(ModbusMasterSubmit(&privateMaster, &request) == xResultError, __LINE__);
+
+	//the queued requests go out one by one in order
+	ModbusRequestT queue[4];
+	uint16_t queueRegisters[4][2];
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		ModbusRequestT queued =
+		{
+			.Slave = SLAVE_ADDRESS,
+			.Function = ModbusFunctionReadHoldingRegisters,
+			.Address = i,
+			.Count = 2,
+			.Registers = queueRegisters[i],
+			.Complete = privateComplete
+		};
+
+		queue[i] = queued;
+		ModbusMasterSubmit(&privateMaster, &queue[i]);
+	}
+
+	privateCheck(ModbusMasterSubmit(&privateMaster, &queue[2]) == xResultBusy, __LINE__);
+
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		privateTransact(false, false);
+		privateCheck(queue[i].State == ModbusRequestComplete, __LINE__);
+	}
+
+	privateCheck(queueRegisters[3][0] == privateHolding[3] && !privateMaster.Head && !privateMaster.Tail, __LINE__);
+}
+//------------------------------------------------------------------------------
+/// @brief a gap within the silence keeps the frame, a longer one splits it into two CRC errors
+static void privateLineRun()
+{
+	static LineT line;
+	static FramesT frames;
+	uint8_t frame[16] = { SLAVE_ADDRESS, 3, 0, 0, 0, 2 };
+
+	privateSeal(frame, 6);
+
+	privateLineSend(&line, 0, frame, 8, privateSilence - privateCharTime - 1, 4);
+	privateLineCut(&line, &frames);
+	privateCheck(frames.Count == 1 && ModbusSlaveProcess(&privateSlave, frames.Data[0], frames.Sizes[0], frames.Data[0]) == 9, __LINE__);
+
+	uint32_t crcErrors = privateSlave.Statistic.CrcErrors;
+
+	privateLineSend(&line, 0, frame, 8, privateSilence - privateCharTime + 1, 4);
+	privateLineCut(&line, &frames);
+	privateCheck(frames.Count == 2, __LINE__);
+
+	for (uint8_t i = 0; i < frames.Count; i++)
+	{
+		privateCheck(!ModbusSlaveProcess(&privateSlave, frames.Data[i], frames.Sizes[i], frames.Data[i]), __LINE__);
+	}
+
+	privateCheck(privateSlave.Statistic.CrcErrors == crcErrors + 2, __LINE__);
+}
+//------------------------------------------------------------------------------
+/// @brief the function 3 of 10 registers back to back: the next request goes out right after the response
+static void privateBenchRun()
+{
+	static const uint32_t baudRates[] = { 115200, 900000 };
+	uint16_t registers[10];
+
+	for (uint8_t i = 0; i < sizeof(baudRates) / sizeof(baudRates[0]); i++)
+	{
+		for (int8_t isFixed = 1; isFixed >= 0; isFixed--)
+		{
+			ModbusRequestT request =
+			{
+				.Slave = SLAVE_ADDRESS,
+				.Function = ModbusFunctionReadHoldingRegisters,
+				.Count = 10,
+				.Registers = registers
+			};
+
+			privateLineInit(baudRates[i], isFixed);
+			privateMasterInit(0);
+			privateTime = 0;
+
+			clock_t start = clock();
+
+			for (uint32_t j = 0; j < BENCH_TRANSACTIONS; j++)
+			{
+				ModbusMasterSubmit(&privateMaster, &request);
+				privateTransact(false, false);
+			}
+
+			double duration = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+			printf("  %6u baud, T3.5 %s %4.0f us: %5.0f transactions/s, %u ok, host codec and line %.2f us/transaction\n",
+					baudRates[i],
+					isFixed ? "fixed" : "chars",
+					privateSilence,
+					BENCH_TRANSACTIONS / (privateTime / 1e6),
+					privateMaster.Statistic.Responses,
+					duration * 1e6 / BENCH_TRANSACTIONS);
+
+			privateCheck(privateMaster.Statistic.Responses == BENCH_TRANSACTIONS, __LINE__);
+		}
+	}
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	//the engine of CrcComponentInit
+	CrcEngineInit(&privateCrc, &CrcParameters[CrcVariant16Modbus], privateCrcTable, CRC_SLICES);
+
+	//the check value of CRC-16/MODBUS: 01 03 00 00 00 0A C5 CD
+	uint8_t vector[] = { 0x01, 0x03, 0x00, 0x00, 0x00, 0x0a };
+	uint16_t crc = ModbusRtuCrc(&privateCrc, vector, sizeof(vector));
+
+	privateCheck((crc & 0xff) == 0xc5 && (crc >> 8) == 0xcd, __LINE__);
+
+	privateLineInit(DEFAULT_BAUD_RATE, false);
+	privateSlaveInit();
+
+	//without the engine of CRC-16/MODBUS the master is not initialized and the slave answers nothing
+	CrcEngineT other;
+	ModbusMasterInitT noCrc = { .Timeout = 100 };
+	uint8_t frame[8] = { SLAVE_ADDRESS, 0x03, 0x00, 0x00, 0x00, 0x0a };
+	uint8_t response[32];
+
+	CrcEngineInit(&other, &CrcParameters[CrcVariant16CcittFalse], NULL, 0);
+
+	privateCheck(ModbusMasterInit(&privateMaster, &noCrc) == xResultError, __LINE__);
+
+	noCrc.Crc = &other;
+	privateCheck(ModbusMasterInit(&privateMaster, &noCrc) == xResultError, __LINE__);
+
+	privateSeal(frame, 6);
+	privateSlave.Crc = NULL;
+	privateCheck(!ModbusSlaveProcess(&privateSlave, frame, sizeof(frame), response), __LINE__);
+
+	privateSlave.Crc = &privateCrc;
+	privateCheck(ModbusSlaveProcess(&privateSlave, frame, sizeof(frame), response) == 5 + 10 * 2, __LINE__);
+
+	privateMasterInit(50);
+
+	privateBitsRun();
+	privateRegistersRun();
+	privateExceptionsRun();
+	privateMasterRun();
+	privateLineRun();
+
+	printf("functional: %u failures, %u completions, %u writes of the slave\n", privateFailures, privateCompletions, privateWrites);
+
+	privateBenchRun();
+
+	if (privateFailures)
+	{
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
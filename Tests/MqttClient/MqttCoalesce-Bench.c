@@ -0,0 +1,285 @@
+//==============================================================================
+//includes:
+
+#include "MqttLinkSocket.h"
+#include "MqttClient/MqttClient-ComponentConfig.h"
+#include "MqttClient/Adapters/Ports/FreeRTOS-MQTT/MqttPort-Adapter.h"
+#include "TerminalCommands/TerminalCommands.h"
+#include <stdio.h>
+#include <string.h>
+//==============================================================================
+//defines:
+
+#define LINK_LATENCY 20000 //us, one way
+#define LINK_RATE 1000000 //bit/s
+
+#define RUN_TIME 4 //seconds
+#define RECORD_SIZE 48 //a line of the terminal log
+#define RECORDS_MAX 8192
+#define TASK_MAX_WAIT_TIME 1000 //ms, MQTT_TASK_MAX_WAIT_TIME
+//==============================================================================
+//types:
+
+typedef struct
+{
+	uint32_t Publishes; //PUBLISH packets per second taken by the broker
+	uint32_t Records; //records per second taken by the broker
+	uint32_t AverageLatency; //us, from xPortEndTransmission to the arrival at the broker
+	uint32_t MaxLatency; //us
+
+	bool IsComplete; //all the records arrived in order
+
+} BenchResultT;
+//==============================================================================
+//variables:
+
+static xPortT privatePort;
+static MqttPortAdapterT privateAdapter;
+
+static uint8_t privateMqttBuffer[1024];
+static uint8_t privateTxBuffer[512];
+static uint8_t privateCoalesceBuffer[MQTT_PORT_PUBLISH_SIZE];
+
+static uint64_t privateSendTimes[RECORDS_MAX]; //us, xPortEndTransmission of the record
+static uint32_t privateSent;
+static uint32_t privatePeriod; //us between the records
+static uint64_t privateEndTime;
+
+static uint32_t privateReceived;
+static uint64_t privateLatency; //us, the sum
+static uint32_t privateMaxLatency;
+static bool privateIsOrdered;
+//==============================================================================
+//functions:
+
+void TerminalCommandsReceive(xPortT* port, RxDataPacketT* packet)
+{
+
+}
+//------------------------------------------------------------------------------
+/// @brief a record: its number, the rest is the text of a log line
+static void privateRecordTake(uint64_t time, const uint8_t* record, uint32_t size)
+{
+	uint32_t number;
+
+	memcpy(&number, record, sizeof(number));
+
+	if (size != RECORD_SIZE || number != privateReceived || number >= privateSent)
+	{
+		privateIsOrdered = false;
+		return;
+	}
+
+	uint32_t latency = time - privateSendTimes[number];
+
+	privateLatency += latency;
+
+	if (latency > privateMaxLatency)
+	{
+		privateMaxLatency = latency;
+	}
+
+	privateReceived++;
+}
+//------------------------------------------------------------------------------
+/// @brief the publishes of TxTopic at the broker: one record or the size-prefixed coalesced records
+static void privatePublishTake(uint64_t time, const uint8_t* payload, uint32_t size)
+{
+	if (!privateAdapter.Internal.CoalesceThreshold)
+	{
+		privateRecordTake(time, payload, size);
+		return;
+	}
+
+	uint32_t offset = 0;
+
+	while (offset + 2 <= size)
+	{
+		uint16_t recordSize = (payload[offset] << 8) | payload[offset + 1];
+
+		offset += 2;
+
+		if (offset + recordSize > size)
+		{
+			privateIsOrdered = false;
+			return;
+		}
+
+		privateRecordTake(time, payload + offset, recordSize);
+		offset += recordSize;
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief the task writing the log to the port: a record each period until the end of the run
+static void privateRecordTask()
+{
+	uint8_t record[RECORD_SIZE];
+
+	memset(record, 'x', sizeof(record));
+	memcpy(record, &privateSent, sizeof(privateSent));
+
+	xPortStartTransmission(&privatePort);
+	xPortTransmitData(&privatePort, record, sizeof(record));
+	privateSendTimes[privateSent++] = MqttLinkGetTime();
+	xPortEndTransmission(&privatePort);
+
+	uint64_t next = MqttLinkGetTime() + privatePeriod;
+
+	if (next < privateEndTime && privateSent < RECORDS_MAX)
+	{
+		MqttLinkSocketSchedule(next, privateRecordTask);
+	}
+}
+//------------------------------------------------------------------------------
+static bool privateOpen(bool isCoalescing)
+{
+	MqttLinkInitT linkInit =
+	{
+		.Latency = LINK_LATENCY,
+		.Rate = LINK_RATE
+	};
+
+	MqttLinkSocketReset();
+
+	if (MqttLinkOpen(&linkInit) != xResultAccept || MqttLinkObserve("bench/log", privatePublishTake) != xResultAccept)
+	{
+		return false;
+	}
+
+	MqttPortAdapterInitT init = { 0 };
+	init.TxTopic = "bench/log";
+	init.RxTopic = "bench/command";
+	init.MqttBuffer = privateMqttBuffer;
+	init.MqttBufferSize = sizeof(privateMqttBuffer);
+	init.TxBuffer = privateTxBuffer;
+	init.TxBufferSize = sizeof(privateTxBuffer);
+
+	//as MqttClient-Component with MQTT_PORT_COALESCE_ENABLE
+	if (isCoalescing)
+	{
+		init.CoalesceBuffer = privateCoalesceBuffer;
+		init.CoalesceBufferSize = sizeof(privateCoalesceBuffer);
+		init.CoalesceThreshold = MQTT_PORT_COALESCE_THRESHOLD;
+		init.CoalesceDeadline = MQTT_PORT_COALESCE_DEADLINE;
+	}
+
+	memset(&privateAdapter, 0, sizeof(privateAdapter));
+	privateAdapter.Id = "bench";
+	privateAdapter.QoS = MQTTQoS0;
+	privateAdapter.KeepAlive = MQTT_PORT_KEEP_ALIVE;
+
+	if (MqttPortAdapterInit(&privatePort, &privateAdapter, &init) != xResultAccept)
+	{
+		return false;
+	}
+
+	xPortAdapterInterfaceT* interface = privatePort.Adapter.Interface;
+
+	interface->RequestListener(&privatePort, xPortAdapterRequestOpen, 0, NULL);
+	interface->RequestListener(&privatePort, xPortAdapterRequestConnect, 0, NULL);
+
+	return privatePort.IsConnected;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the port task of MqttClient-Component while a task writes the records
+ * @param rate records per second
+ */
+static BenchResultT privateRun(bool isCoalescing, uint32_t rate)
+{
+	BenchResultT result = { 0 };
+
+	if (!privateOpen(isCoalescing))
+	{
+		return result;
+	}
+
+	privateSent = 0;
+	privateReceived = 0;
+	privateLatency = 0;
+	privateMaxLatency = 0;
+	privateIsOrdered = true;
+	privatePeriod = 1000000 / rate;
+
+	uint64_t start = MqttLinkGetTime();
+	uint32_t publishes = MqttLinkBroker.Statistic.Publishes;
+
+	privateEndTime = start + RUN_TIME * 1000000ull;
+
+	MqttLinkSocketSchedule(start, privateRecordTask);
+
+	//the last records wait for the deadline and the link
+	while (MqttLinkGetTime() < privateEndTime + 1000000)
+	{
+		privatePort.Adapter.Interface->Handler(&privatePort);
+
+		MqttPortAdapterWaitEvent(&privatePort, TASK_MAX_WAIT_TIME);
+	}
+
+	if (!privateReceived)
+	{
+		return result;
+	}
+
+	result.Publishes = (MqttLinkBroker.Statistic.Publishes - publishes) / RUN_TIME;
+	result.Records = privateReceived / RUN_TIME;
+	result.AverageLatency = privateLatency / privateReceived;
+	result.MaxLatency = privateMaxLatency;
+	result.IsComplete = privateIsOrdered
+						&& privateReceived == privateSent
+						&& !privateAdapter.Internal.Statistic.Dropped
+						&& !MqttLinkBroker.Statistic.Errors;
+
+	return result;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	const uint32_t rates[] = { 20, 200, 1000 };
+	//the record travels the link: the serialization and the latency
+	const uint32_t linkTime = LINK_LATENCY + MQTT_PORT_PUBLISH_SIZE * 8 * 1000000ull / LINK_RATE;
+
+	printf("QoS0 records of %u bytes through the port adapter for %u s, one way %u us, %u bit/s,\n",
+			RECORD_SIZE, RUN_TIME, LINK_LATENCY, LINK_RATE);
+	printf("coalescing up to %u bytes or %u ms:\n", MQTT_PORT_COALESCE_THRESHOLD, MQTT_PORT_COALESCE_DEADLINE);
+
+	for (uint8_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++)
+	{
+		BenchResultT direct = privateRun(false, rates[i]);
+		BenchResultT coalesced = privateRun(true, rates[i]);
+
+		printf("%4u records/s: coalescing off %4u PUBLISH/s %4u records/s, latency %5u us average %5u us max\n",
+				rates[i], direct.Publishes, direct.Records, direct.AverageLatency, direct.MaxLatency);
+		printf("%4u records/s: coalescing on  %4u PUBLISH/s %4u records/s, latency %5u us average %5u us max\n",
+				rates[i], coalesced.Publishes, coalesced.Records, coalesced.AverageLatency, coalesced.MaxLatency);
+
+		if (!direct.IsComplete || !coalesced.IsComplete)
+		{
+			printf("FAIL: records lost or reordered at %u records/s\n", rates[i]);
+			return 1;
+		}
+
+		//a record waits for the threshold or the deadline, then for the link
+		if (direct.MaxLatency > linkTime || coalesced.MaxLatency > MQTT_PORT_COALESCE_DEADLINE * 1000 + linkTime)
+		{
+			printf("FAIL: latency at %u records/s\n", rates[i]);
+			return 1;
+		}
+
+		//the threshold packs its records into one publish
+		uint32_t perPublish = MQTT_PORT_COALESCE_THRESHOLD / (RECORD_SIZE + 2);
+
+		if (rates[i] >= perPublish * 1000 / MQTT_PORT_COALESCE_DEADLINE && coalesced.Publishes * perPublish > direct.Publishes)
+		{
+			printf("FAIL: %u records/s are not coalesced\n", rates[i]);
+			return 1;
+		}
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
@@ -0,0 +1,180 @@
+//==============================================================================
+//includes:
+
+#include "MqttClient/Compress/MqttCompress.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+//==============================================================================
+//defines:
+
+#define TEXT_SIZE 20000
+#define FRAGMENT_SIZE 512 //the terminal output is published by the fragments of the transmission
+#define FRAGMENT_SPLIT 300 //a fragment is added by two parts as by xPortTransmitData
+
+#define DEFAULT_WINDOW_BITS 8 //MQTT_PORT_COMPRESS_WINDOW_BITS
+#define DEFAULT_LOOKAHEAD_BITS 4 //MQTT_PORT_COMPRESS_LOOKAHEAD_BITS
+#define DEFAULT_RATIO_MAX 0.5
+
+#define RANDOM_PAYLOADS 2000
+//==============================================================================
+//variables:
+
+static char privateText[TEXT_SIZE];
+static uint8_t privateInput[FRAGMENT_SIZE];
+static uint8_t privateOutput[FRAGMENT_SIZE + FRAGMENT_SIZE / 4];
+static uint8_t privateDecoded[FRAGMENT_SIZE + FRAGMENT_SIZE / 4];
+
+static uint32_t privateSeed = 1;
+//==============================================================================
+//functions:
+
+static uint32_t privateRandom()
+{
+	privateSeed = privateSeed * 1103515245 + 12345;
+
+	return privateSeed >> 16;
+}
+//------------------------------------------------------------------------------
+static uint64_t privateGetTime()
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+//------------------------------------------------------------------------------
+/// @brief the terminal output of the board: the telemetry lines of the ADC channels
+static uint32_t privateTextFill()
+{
+	uint32_t size = 0;
+
+	for (uint32_t i = 0; size < TEXT_SIZE - 100; i++)
+	{
+		size += sprintf(privateText + size, "[%05u] ADC ch%u=%4u mV, T=%2u.%uC, state=%s\r\n",
+						i * 20,
+						i % 4,
+						1200 + privateRandom() % 300,
+						21 + privateRandom() % 3,
+						privateRandom() % 10,
+						i % 7 ? "RUN" : "IDLE");
+	}
+
+	return size;
+}
+//------------------------------------------------------------------------------
+/// @return the compressed size of the fragment, -1 - doesn't fit, -2 - doesn't decode back
+static int32_t privateRoundTrip(const void* data, uint32_t size, uint32_t split, uint32_t outputSize,
+								uint8_t windowBits, uint8_t lookaheadBits)
+{
+	MqttCompressEncoderT encoder;
+
+	MqttCompressBegin(&encoder, privateOutput, outputSize, windowBits, lookaheadBits);
+	MqttCompressAdd(&encoder, data, split);
+	MqttCompressAdd(&encoder, (const uint8_t*)data + split, size - split);
+
+	int32_t compressed = MqttCompressEnd(&encoder);
+
+	if (compressed < 0)
+	{
+		return -1;
+	}
+
+	int32_t decoded = MqttCompressDecode(privateOutput, compressed, privateDecoded, sizeof(privateDecoded));
+
+	return decoded == (int32_t)size && !memcmp(privateDecoded, data, size) ? compressed : -2;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	uint32_t textSize = privateTextFill();
+	double defaultRatio = 0;
+
+	printf("%u bytes of the terminal telemetry by %u byte fragments:\n", textSize, FRAGMENT_SIZE);
+
+	for (uint8_t windowBits = 7; windowBits <= 10; windowBits++)
+	{
+		for (uint8_t lookaheadBits = 3; lookaheadBits <= 5; lookaheadBits++)
+		{
+			uint32_t total = 0;
+			uint32_t compressed = 0;
+			uint64_t start = privateGetTime();
+
+			for (uint32_t offset = 0; offset + FRAGMENT_SIZE <= textSize; offset += FRAGMENT_SIZE)
+			{
+				int32_t size = privateRoundTrip(privateText + offset, FRAGMENT_SIZE, FRAGMENT_SPLIT,
+												FRAGMENT_SIZE + MQTT_COMPRESS_HEADER_SIZE, windowBits, lookaheadBits);
+
+				if (size < 0)
+				{
+					printf("FAIL: window %u, lookahead %u, offset %u: %d\n", windowBits, lookaheadBits, offset, size);
+					return 1;
+				}
+
+				total += FRAGMENT_SIZE;
+				compressed += size;
+			}
+
+			double ratio = (double)compressed / total;
+
+			if (windowBits == DEFAULT_WINDOW_BITS && lookaheadBits == DEFAULT_LOOKAHEAD_BITS)
+			{
+				defaultRatio = ratio;
+			}
+
+			printf("  window %2u, lookahead %u: ratio %.3f, %.1f ns/byte%s\n",
+					windowBits,
+					lookaheadBits,
+					ratio,
+					(double)(privateGetTime() - start) / total,
+					windowBits == DEFAULT_WINDOW_BITS && lookaheadBits == DEFAULT_LOOKAHEAD_BITS ? " (default)" : "");
+		}
+	}
+
+	if (defaultRatio > DEFAULT_RATIO_MAX)
+	{
+		printf("FAIL: the default settings give %.3f\n", defaultRatio);
+		return 1;
+	}
+
+	//all the sizes of the random and the repetitive payloads
+	for (uint32_t i = 0; i < RANDOM_PAYLOADS; i++)
+	{
+		uint32_t size = privateRandom() % FRAGMENT_SIZE;
+
+		for (uint32_t j = 0; j < size; j++)
+		{
+			privateInput[j] = i & 1 ? privateRandom() : "abcab"[privateRandom() % 5];
+		}
+
+		if (privateRoundTrip(privateInput, size, size / 3, sizeof(privateOutput),
+								DEFAULT_WINDOW_BITS, DEFAULT_LOOKAHEAD_BITS) < 0)
+		{
+			printf("FAIL: payload %u of %u bytes\n", i, size);
+			return 1;
+		}
+	}
+
+	//the output doesn't take the random data: the port publishes it raw
+	for (uint32_t i = 0; i < FRAGMENT_SIZE; i++)
+	{
+		privateInput[i] = privateRandom();
+	}
+
+	if (privateRoundTrip(privateInput, FRAGMENT_SIZE, FRAGMENT_SPLIT, FRAGMENT_SIZE / 5,
+							DEFAULT_WINDOW_BITS, DEFAULT_LOOKAHEAD_BITS) != -1)
+	{
+		printf("FAIL: overflow of the output\n");
+		return 1;
+	}
+
+	printf("%u random payloads decoded, the encoder takes %u bytes\n", RANDOM_PAYLOADS, (uint32_t)sizeof(MqttCompressEncoderT));
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
@@ -0,0 +1,348 @@
+//==============================================================================
+//includes:
+
+#include "MqttClient/Egress/MqttEgress.h"
+#include <stdio.h>
+#include <string.h>
+//==============================================================================
+//defines:
+
+//the settings of MqttClient-ComponentConfig.h
+#define ALARM_QUEUE 512
+#define TELEMETRY_QUEUE 1024
+#define TELEMETRY_RATE 512
+#define TELEMETRY_BURST 1024
+#define LOG_QUEUE 2048
+#define LOG_RATE 2048
+#define LOG_BURST 1024
+
+#define LINK_RATE 4 //bytes per ms, a congested uplink of 32 kbit/s
+#define PACKET_OVERHEAD 10 //bytes, the fixed header, the topic and the TCP share of a publish
+#define RUN_TIME 60000 //ms
+
+#define LOG_SIZE 120 //bytes every ms: a terminal flood of 120 KB/s
+#define TELEMETRY_SIZE 32
+#define TELEMETRY_PERIOD 100 //ms
+#define ALARM_SIZE 64
+#define ALARM_PERIOD 250 //ms
+
+#define ALARM_LATENCY_MAX 100 //ms
+
+#define ORDER_RUN_TIME 200000 //ms
+//==============================================================================
+//types:
+
+/// @brief the record of the FIFO baseline: one shared drop-tail buffer of the same memory
+typedef struct
+{
+	uint32_t TimeStamp;
+	uint16_t Size;
+	uint8_t Class;
+
+} FifoRecordT;
+//==============================================================================
+//variables:
+
+static MqttEgressTopicT privateTopics[3];
+static uint8_t privateAlarmQueue[ALARM_QUEUE];
+static uint8_t privateTelemetryQueue[TELEMETRY_QUEUE];
+static uint8_t privateLogQueue[LOG_QUEUE];
+
+static FifoRecordT privateFifo[RUN_TIME * 2];
+
+static uint32_t privateSeed = 1;
+//==============================================================================
+//functions:
+
+static uint32_t privateRandom()
+{
+	privateSeed = privateSeed * 1103515245 + 12345;
+
+	return privateSeed >> 16;
+}
+//------------------------------------------------------------------------------
+/// @return the worst latency of the alarms behind one FIFO of ALARM_QUEUE + TELEMETRY_QUEUE + LOG_QUEUE bytes
+static uint32_t privateFifoRun()
+{
+	uint32_t head = 0;
+	uint32_t tail = 0;
+	uint32_t queuedBytes = 0;
+	uint32_t linkBytes = 0;
+	uint32_t alarmLatency = 0;
+
+	for (uint32_t time = 1; time <= RUN_TIME; time++)
+	{
+		FifoRecordT records[] =
+		{
+			{ time, LOG_SIZE, MqttEgressClassLog },
+			{ time, time % TELEMETRY_PERIOD == 0 ? TELEMETRY_SIZE : 0, MqttEgressClassTelemetry },
+			{ time, time % ALARM_PERIOD == 7 ? ALARM_SIZE : 0, MqttEgressClassAlarm }
+		};
+
+		for (uint8_t i = 0; i < sizeof(records) / sizeof(records[0]); i++)
+		{
+			if (records[i].Size && queuedBytes + records[i].Size <= ALARM_QUEUE + TELEMETRY_QUEUE + LOG_QUEUE)
+			{
+				privateFifo[tail++] = records[i];
+				queuedBytes += records[i].Size;
+			}
+		}
+
+		linkBytes -= linkBytes > LINK_RATE ? LINK_RATE : linkBytes;
+
+		while (!linkBytes && head < tail)
+		{
+			if (privateFifo[head].Class == MqttEgressClassAlarm && time - privateFifo[head].TimeStamp > alarmLatency)
+			{
+				alarmLatency = time - privateFifo[head].TimeStamp;
+			}
+
+			linkBytes += privateFifo[head].Size + PACKET_OVERHEAD;
+			queuedBytes -= privateFifo[head].Size;
+			head++;
+		}
+	}
+
+	return alarmLatency;
+}
+//------------------------------------------------------------------------------
+/// @brief a log flood over a slow link: the alarms keep their latency, the log is held to its rate
+static bool privateFloodRun()
+{
+	MqttEgressT egress;
+	MqttEgressInitT init = { .Topics = privateTopics, .TopicsSize = 3 };
+	uint8_t alarm, telemetry, log;
+
+	MqttEgressTopicInitT alarmInit =
+	{
+		.Name = "bro-alarm",
+		.Class = MqttEgressClassAlarm,
+		.Policy = MqttEgressPolicyQueue,
+		.Memory = privateAlarmQueue,
+		.Size = sizeof(privateAlarmQueue)
+	};
+
+	MqttEgressTopicInitT telemetryInit =
+	{
+		.Name = "bro-telemetry",
+		.Class = MqttEgressClassTelemetry,
+		.Policy = MqttEgressPolicyMerge,
+		.Rate = TELEMETRY_RATE,
+		.Burst = TELEMETRY_BURST,
+		.Memory = privateTelemetryQueue,
+		.Size = sizeof(privateTelemetryQueue)
+	};
+
+	MqttEgressTopicInitT logInit =
+	{
+		.Name = "bro-tx",
+		.Class = MqttEgressClassLog,
+		.Policy = MqttEgressPolicyDrop,
+		.Rate = LOG_RATE,
+		.Burst = LOG_BURST,
+		.Memory = privateLogQueue,
+		.Size = sizeof(privateLogQueue)
+	};
+
+	if (MqttEgressInit(&egress, &init) != xResultAccept
+		|| MqttEgressAddTopic(&egress, &alarmInit, &alarm) != xResultAccept
+		|| MqttEgressAddTopic(&egress, &telemetryInit, &telemetry) != xResultAccept
+		|| MqttEgressAddTopic(&egress, &logInit, &log) != xResultAccept)
+	{
+		printf("FAIL: init\n");
+		return false;
+	}
+
+	uint8_t payload[LOG_SIZE];
+	uint32_t linkBytes = 0;
+	uint32_t logBytes = 0;
+
+	memset(payload, 'x', sizeof(payload));
+
+	for (uint32_t time = 1; time <= RUN_TIME; time++)
+	{
+		MqttEgressAdd(&egress, log, payload, LOG_SIZE, time);
+
+		if (time % TELEMETRY_PERIOD == 0)
+		{
+			uint8_t value[TELEMETRY_SIZE];
+
+			memset(value, (uint8_t)(time / TELEMETRY_PERIOD), sizeof(value));
+			MqttEgressAdd(&egress, telemetry, value, sizeof(value), time);
+		}
+
+		if (time % ALARM_PERIOD == 7)
+		{
+			MqttEgressAdd(&egress, alarm, payload, ALARM_SIZE, time);
+		}
+
+		linkBytes -= linkBytes > LINK_RATE ? LINK_RATE : linkBytes;
+
+		MqttEgressRecordT record;
+
+		while (!linkBytes && MqttEgressPeek(&egress, time, &record))
+		{
+			for (uint16_t i = 0; i < record.Size; i++)
+			{
+				if (record.Data[i] != (record.Topic == telemetry ? record.Data[0] : 'x'))
+				{
+					printf("FAIL: the record of the topic %u is damaged\n", record.Topic);
+					return false;
+				}
+			}
+
+			logBytes += record.Topic == log ? record.Size : 0;
+			linkBytes += record.Size + PACKET_OVERHEAD;
+
+			MqttEgressRemove(&egress, &record, time);
+		}
+	}
+
+	const char* names[] = { "alarm", "telemetry", "log" };
+
+	printf("log flood of %u KB/s over %u B/s for %u s:\n", LOG_SIZE, LINK_RATE * 1000, RUN_TIME / 1000);
+
+	for (uint8_t i = 0; i < MqttEgressClassCount; i++)
+	{
+		MqttEgressClassStatisticT* statistic = &egress.Statistic[i];
+
+		printf("  %-9s queued %5u, sent %5u, dropped %5u, latency %3u ms average, %3u ms max\n",
+				names[i],
+				statistic->Queued,
+				statistic->Sent,
+				statistic->Dropped,
+				statistic->Sent ? statistic->Latency / statistic->Sent : 0,
+				statistic->MaxLatency);
+	}
+
+	MqttEgressClassStatisticT* alarms = &egress.Statistic[MqttEgressClassAlarm];
+	uint32_t fifoLatency = privateFifoRun();
+
+	printf("  log %u B/s, the alarms behind one FIFO of the same memory: %u ms max\n", logBytes / (RUN_TIME / 1000), fifoLatency);
+
+	if (alarms->Dropped || alarms->Sent != RUN_TIME / ALARM_PERIOD || alarms->MaxLatency > ALARM_LATENCY_MAX)
+	{
+		printf("FAIL: the alarms are held by the flood\n");
+		return false;
+	}
+
+	if (logBytes > LOG_RATE * (RUN_TIME / 1000) + LOG_BURST || fifoLatency <= alarms->MaxLatency)
+	{
+		printf("FAIL: the log is not limited\n");
+		return false;
+	}
+
+	return true;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief random sizes and times: a queued topic keeps the order of its records,
+ * a merged one keeps the order and loses only the replaced values
+ */
+static bool privateOrderRun()
+{
+	MqttEgressT egress;
+	MqttEgressInitT init = { .Topics = privateTopics, .TopicsSize = 2 };
+
+	MqttEgressTopicInitT queued =
+	{
+		.Name = "queued",
+		.Class = MqttEgressClassTelemetry,
+		.Policy = MqttEgressPolicyQueue,
+		.Memory = privateAlarmQueue,
+		.Size = 300
+	};
+
+	MqttEgressTopicInitT merged =
+	{
+		.Name = "merged",
+		.Class = MqttEgressClassTelemetry,
+		.Policy = MqttEgressPolicyMerge,
+		.Rate = 300,
+		.Burst = 100,
+		.Memory = privateTelemetryQueue,
+		.Size = 257 //the records wrap at the odd offsets
+	};
+
+	MqttEgressInit(&egress, &init);
+	MqttEgressAddTopic(&egress, &queued, NULL);
+	MqttEgressAddTopic(&egress, &merged, NULL);
+
+	uint32_t added[2] = { 0 };
+	uint32_t next[2] = { 0 };
+	uint32_t skipped = 0;
+
+	for (uint32_t time = 1; time < ORDER_RUN_TIME; time++)
+	{
+		for (uint8_t topic = 0; topic < 2; topic++)
+		{
+			if (privateRandom() % 3)
+			{
+				continue;
+			}
+
+			uint8_t data[64];
+			uint16_t size = 4 + privateRandom() % 60;
+
+			memcpy(data, &added[topic], 4);
+
+			for (uint16_t i = 4; i < size; i++)
+			{
+				data[i] = (uint8_t)(added[topic] + i);
+			}
+
+			if (MqttEgressAdd(&egress, topic, data, size, time) == xResultAccept)
+			{
+				added[topic]++;
+			}
+		}
+
+		MqttEgressRecordT record;
+
+		if (privateRandom() % 2 && MqttEgressPeek(&egress, time, &record))
+		{
+			uint32_t number;
+
+			memcpy(&number, record.Data, 4);
+
+			for (uint16_t i = 4; i < record.Size; i++)
+			{
+				if (record.Data[i] != (uint8_t)(number + i))
+				{
+					printf("FAIL: record %u of the topic %u is damaged\n", number, record.Topic);
+					return false;
+				}
+			}
+
+			if (number < next[record.Topic] || (record.Topic == 0 && number != next[0]))
+			{
+				printf("FAIL: record %u of the topic %u after %u\n", number, record.Topic, next[record.Topic]);
+				return false;
+			}
+
+			skipped += number - next[record.Topic];
+			next[record.Topic] = number + 1;
+
+			MqttEgressRemove(&egress, &record, time);
+		}
+	}
+
+	printf("order: %u queued records in order, %u merged records replaced of %u\n", next[0], skipped, added[1]);
+
+	return true;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	if (!privateFloodRun() || !privateOrderRun())
+	{
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
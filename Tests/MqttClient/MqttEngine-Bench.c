@@ -0,0 +1,435 @@
+//==============================================================================
+//includes:
+
+#include "MqttBroker.h"
+#include "core_mqtt.h"
+#include "MQTTClient.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+//==============================================================================
+//defines:
+
+//the workload of "mqtt-bench": MqttBench-ComponentConfig.h
+#define BENCH_TOPIC "bench/loop"
+#define BENCH_CLIENT_ID "bench"
+#define BENCH_COUNT 20000 //publishes of one run, MQTT_BENCH_DEFAULT_COUNT is 500 on the board
+#define BENCH_LENGTH 64
+#define BENCH_PACKET_SIZE 512
+#define BENCH_PIPE_SIZE 2048
+#define BENCH_QOS_RECORDS 4
+#define BENCH_DRAIN_LIMIT 64
+#define BENCH_COMMAND_TIMEOUT 1000 //ms
+//==============================================================================
+//types:
+
+/// @brief bytes from the broker to the client, as MqttBenchPipeT: the exchange is synchronous
+typedef struct
+{
+	uint8_t Buffer[BENCH_PIPE_SIZE];
+	uint16_t Head;
+	uint16_t Count;
+	uint16_t Peak;
+
+	uint8_t Session;
+
+} PipeT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Published;
+	uint32_t Received;
+	uint64_t Duration; //ns
+	uint32_t Memory; //bytes of the engine: the context and its buffers
+
+} ResultT;
+//==============================================================================
+//prototypes:
+
+//one read of MQTTClient with the keep-alive, not declared by MQTTClient.h
+int cycle(MQTTClient* c, MQTTTimerT* timer);
+//==============================================================================
+//variables:
+
+static MqttBrokerT privateBroker;
+static MqttBrokerSessionT privateBrokerSessions[2];
+static uint8_t privateBrokerMemory[BENCH_PACKET_SIZE * 3];
+static PipeT privatePipe;
+
+static uint8_t privateClientBuffer[BENCH_PACKET_SIZE];
+static uint8_t privateClientReadBuffer[BENCH_PACKET_SIZE];
+static uint8_t privatePayload[BENCH_LENGTH];
+
+static MQTTContext_t privateCoreContext;
+static MQTTPubAckInfo_t privateCoreOutgoingRecords[BENCH_QOS_RECORDS];
+static MQTTPubAckInfo_t privateCoreIncomingRecords[BENCH_QOS_RECORDS];
+
+static MQTTClient privatePahoClient;
+static MQTTNetworkT privatePahoNetwork;
+
+static ResultT* privateResult;
+//==============================================================================
+//functions:
+
+static uint64_t privateGetTime()
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+//------------------------------------------------------------------------------
+//the platform of Paho MQTTClient: MQTT-Interface.h
+
+void TimerInit(MQTTTimerT* timer)
+{
+	timer->End = 0;
+}
+//------------------------------------------------------------------------------
+char TimerIsExpired(MQTTTimerT* timer)
+{
+	return privateGetTime() / 1000000 >= timer->End;
+}
+//------------------------------------------------------------------------------
+void TimerCountdownMS(MQTTTimerT* timer, unsigned int time)
+{
+	timer->End = privateGetTime() / 1000000 + time;
+}
+//------------------------------------------------------------------------------
+void TimerCountdown(MQTTTimerT* timer, unsigned int time)
+{
+	TimerCountdownMS(timer, time * 1000);
+}
+//------------------------------------------------------------------------------
+int TimerLeftMS(MQTTTimerT* timer)
+{
+	int64_t left = (int64_t)timer->End - (int64_t)(privateGetTime() / 1000000);
+
+	return left > 0 ? (int)left : 0;
+}
+//------------------------------------------------------------------------------
+static int32_t privatePipeWrite(void* context, const void* data, uint32_t size)
+{
+	PipeT* pipe = context;
+
+	if (size > sizeof(pipe->Buffer) - pipe->Count)
+	{
+		return 0;
+	}
+
+	const uint8_t* source = data;
+	uint16_t tail = (pipe->Head + pipe->Count) % sizeof(pipe->Buffer);
+
+	for (uint32_t i = 0; i < size; i++)
+	{
+		pipe->Buffer[tail] = source[i];
+		tail = (tail + 1) % sizeof(pipe->Buffer);
+	}
+
+	pipe->Count += size;
+
+	if (pipe->Count > pipe->Peak)
+	{
+		pipe->Peak = pipe->Count;
+	}
+
+	return size;
+}
+//------------------------------------------------------------------------------
+static int32_t privatePipeRead(void* data, uint32_t size)
+{
+	uint8_t* destination = data;
+
+	if (size > privatePipe.Count)
+	{
+		size = privatePipe.Count;
+	}
+
+	for (uint32_t i = 0; i < size; i++)
+	{
+		destination[i] = privatePipe.Buffer[privatePipe.Head];
+		privatePipe.Head = (privatePipe.Head + 1) % sizeof(privatePipe.Buffer);
+	}
+
+	privatePipe.Count -= size;
+
+	return size;
+}
+//------------------------------------------------------------------------------
+static int32_t privatePipeSend(const void* data, uint32_t size)
+{
+	return MqttBrokerReceive(&privateBroker, privatePipe.Session, data, size) == xResultAccept ? (int32_t)size : -1;
+}
+//------------------------------------------------------------------------------
+static bool privatePipeOpen()
+{
+	MqttBrokerInitT init =
+	{
+		.Sessions = privateBrokerSessions,
+		.SessionsSize = 2,
+		.Memory = privateBrokerMemory,
+		.MemorySize = sizeof(privateBrokerMemory),
+		.PacketSize = BENCH_PACKET_SIZE
+	};
+
+	memset(&privatePipe, 0, sizeof(privatePipe));
+
+	return MqttBrokerInit(&privateBroker, &init) == xResultAccept
+			&& MqttBrokerOpen(&privateBroker, privatePipeWrite, &privatePipe, &privatePipe.Session) == xResultAccept;
+}
+//------------------------------------------------------------------------------
+static void privateSampleAdd(const void* payload, uint32_t size)
+{
+	privateResult->Received += size == BENCH_LENGTH;
+}
+//------------------------------------------------------------------------------
+static int32_t privateCoreSend(NetworkContext_t* context, const void* data, size_t size)
+{
+	return privatePipeSend(data, size);
+}
+//------------------------------------------------------------------------------
+static int32_t privateCoreReceive(NetworkContext_t* context, void* data, size_t size)
+{
+	return privatePipeRead(data, size);
+}
+//------------------------------------------------------------------------------
+static uint32_t privateCoreGetTime(void)
+{
+	return privateGetTime() / 1000000;
+}
+//------------------------------------------------------------------------------
+static void privateCoreEventCallback(MQTTContext_t* context, MQTTPacketInfo_t* packetInfo, MQTTDeserializedInfo_t* info)
+{
+	if ((packetInfo->type & 0xF0U) == MQTT_PACKET_TYPE_PUBLISH)
+	{
+		privateSampleAdd(info->pPublishInfo->pPayload, info->pPublishInfo->payloadLength);
+	}
+}
+//------------------------------------------------------------------------------
+static void privateCoreDrain()
+{
+	for (uint8_t i = 0; i < BENCH_DRAIN_LIMIT; i++)
+	{
+		if ((!privatePipe.Count && !privateCoreContext.index)
+			|| MQTT_ReceiveLoop(&privateCoreContext) != MQTTSuccess)
+		{
+			break;
+		}
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief privateCoreMqttRun of MqttBench: connect, subscribe, publish and receive back
+static bool privateCoreMqttRun(MQTTQoS_t qos, ResultT* result)
+{
+	NetworkContextT networkContext = { .Context = &privatePipe };
+	TransportInterface_t transport = { 0 };
+	MQTTFixedBuffer_t buffer = { .pBuffer = privateClientBuffer, .size = sizeof(privateClientBuffer) };
+
+	transport.send = privateCoreSend;
+	transport.recv = privateCoreReceive;
+	transport.pNetworkContext = (void*)&networkContext;
+
+	if (MQTT_Init(&privateCoreContext, &transport, privateCoreGetTime, privateCoreEventCallback, &buffer) != MQTTSuccess
+		|| MQTT_InitStatefulQoS(&privateCoreContext,
+								privateCoreOutgoingRecords, BENCH_QOS_RECORDS,
+								privateCoreIncomingRecords, BENCH_QOS_RECORDS) != MQTTSuccess)
+	{
+		return false;
+	}
+
+	MQTTConnectInfo_t connectInfo = { 0 };
+	connectInfo.cleanSession = true;
+	connectInfo.pClientIdentifier = BENCH_CLIENT_ID;
+	connectInfo.clientIdentifierLength = sizeof(BENCH_CLIENT_ID) - 1;
+	connectInfo.keepAliveSeconds = 60;
+
+	bool sessionPresent;
+
+	if (MQTT_Connect(&privateCoreContext, &connectInfo, NULL, BENCH_COMMAND_TIMEOUT, &sessionPresent) != MQTTSuccess)
+	{
+		return false;
+	}
+
+	MQTTSubscribeInfo_t subscription = { 0 };
+	subscription.qos = qos;
+	subscription.pTopicFilter = BENCH_TOPIC;
+	subscription.topicFilterLength = sizeof(BENCH_TOPIC) - 1;
+
+	if (MQTT_Subscribe(&privateCoreContext, &subscription, 1, MQTT_GetPacketId(&privateCoreContext)) != MQTTSuccess)
+	{
+		return false;
+	}
+
+	privateCoreDrain();
+
+	MQTTPublishInfo_t publishInfo = { 0 };
+	publishInfo.qos = qos;
+	publishInfo.pTopicName = BENCH_TOPIC;
+	publishInfo.topicNameLength = sizeof(BENCH_TOPIC) - 1;
+	publishInfo.pPayload = privatePayload;
+	publishInfo.payloadLength = BENCH_LENGTH;
+
+	uint64_t start = privateGetTime();
+
+	for (uint32_t i = 0; i < BENCH_COUNT; i++)
+	{
+		memcpy(privatePayload, &i, sizeof(i));
+
+		uint16_t packetId = qos ? MQTT_GetPacketId(&privateCoreContext) : 0;
+
+		if (MQTT_Publish(&privateCoreContext, &publishInfo, packetId) != MQTTSuccess)
+		{
+			break;
+		}
+
+		result->Published++;
+		privateCoreDrain();
+	}
+
+	result->Duration = privateGetTime() - start;
+
+	MQTT_Disconnect(&privateCoreContext);
+
+	result->Memory = sizeof(privateCoreContext)
+						+ sizeof(privateClientBuffer)
+						+ sizeof(privateCoreOutgoingRecords)
+						+ sizeof(privateCoreIncomingRecords);
+
+	return true;
+}
+//------------------------------------------------------------------------------
+static int privatePahoRead(MQTTNetworkT* network, unsigned char* data, int size, int timeout)
+{
+	return privatePipeRead(data, size);
+}
+//------------------------------------------------------------------------------
+static int privatePahoWrite(MQTTNetworkT* network, unsigned char* data, int size, int timeout)
+{
+	return privatePipeSend(data, size);
+}
+//------------------------------------------------------------------------------
+static void privatePahoDisconnect(MQTTNetworkT* network)
+{
+	MqttBrokerClose(&privateBroker, privatePipe.Session);
+}
+//------------------------------------------------------------------------------
+static void privatePahoMessageHandler(MessageData* data)
+{
+	privateSampleAdd(data->message->payload, data->message->payloadlen);
+}
+//------------------------------------------------------------------------------
+static void privatePahoDrain()
+{
+	for (uint8_t i = 0; i < BENCH_DRAIN_LIMIT && privatePipe.Count; i++)
+	{
+		MQTTTimerT timer;
+		TimerInit(&timer);
+		TimerCountdownMS(&timer, BENCH_COMMAND_TIMEOUT);
+
+		if (cycle(&privatePahoClient, &timer) < 0)
+		{
+			break;
+		}
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief privatePahoRun of MqttBench, drained by cycle as privatePahoDrain of MqttBench
+static bool privatePahoRun(enum QoS qos, ResultT* result)
+{
+	privatePahoNetwork.mqttread = privatePahoRead;
+	privatePahoNetwork.mqttwrite = privatePahoWrite;
+	privatePahoNetwork.disconnect = privatePahoDisconnect;
+
+	MQTTClientInit(&privatePahoClient, &privatePahoNetwork, BENCH_COMMAND_TIMEOUT,
+					privateClientBuffer, sizeof(privateClientBuffer),
+					privateClientReadBuffer, sizeof(privateClientReadBuffer));
+
+	MQTTPacket_connectData connectData = MQTTPacket_connectData_initializer;
+	connectData.MQTTVersion = 4;
+	connectData.clientID.cstring = BENCH_CLIENT_ID;
+	connectData.keepAliveInterval = 60;
+	connectData.cleansession = 1;
+
+	if (MQTTConnect(&privatePahoClient, &connectData) != MQTT_RESULT_SUCCESS
+		|| MQTTSubscribe(&privatePahoClient, BENCH_TOPIC, qos, privatePahoMessageHandler) != MQTT_RESULT_SUCCESS)
+	{
+		return false;
+	}
+
+	privatePahoDrain();
+
+	MQTTMessage message = { 0 };
+	message.qos = qos;
+	message.payload = privatePayload;
+	message.payloadlen = BENCH_LENGTH;
+
+	uint64_t start = privateGetTime();
+
+	for (uint32_t i = 0; i < BENCH_COUNT; i++)
+	{
+		memcpy(privatePayload, &i, sizeof(i));
+
+		if (MQTTPublish(&privatePahoClient, BENCH_TOPIC, &message) != MQTT_RESULT_SUCCESS)
+		{
+			break;
+		}
+
+		result->Published++;
+		privatePahoDrain();
+	}
+
+	result->Duration = privateGetTime() - start;
+
+	MQTTDisconnect(&privatePahoClient);
+
+	result->Memory = sizeof(privatePahoClient)
+						+ sizeof(privatePahoNetwork)
+						+ sizeof(privateClientBuffer)
+						+ sizeof(privateClientReadBuffer);
+
+	return true;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	static const char* names[] = { "coreMQTT", "Paho" };
+
+	printf("%u publishes of %u bytes through the MqttBroker loopback of mqtt-bench, host build:\n", BENCH_COUNT, BENCH_LENGTH);
+
+	for (uint8_t qos = 0; qos < 2; qos++)
+	{
+		for (uint8_t engine = 0; engine < 2; engine++)
+		{
+			ResultT result = { 0 };
+
+			privateResult = &result;
+
+			bool isDone = privatePipeOpen()
+							&& (engine == 0 ? privateCoreMqttRun((MQTTQoS_t)qos, &result)
+											: privatePahoRun((enum QoS)qos, &result));
+
+			if (!isDone || result.Published != BENCH_COUNT || result.Received != BENCH_COUNT
+				|| privateBroker.Statistic.Errors || privateBroker.Statistic.Dropped)
+			{
+				printf("FAIL: %s qos%u, %u/%u received\n", names[engine], qos, result.Received, result.Published);
+				return 1;
+			}
+
+			printf("  %-8s qos%u: %5u ns/msg, %7u msg/s, engine ram %4u B, pipe peak %u B\n",
+					names[engine],
+					qos,
+					(uint32_t)(result.Duration / result.Published),
+					(uint32_t)((uint64_t)result.Published * 1000000000 / result.Duration),
+					result.Memory,
+					privatePipe.Peak);
+		}
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
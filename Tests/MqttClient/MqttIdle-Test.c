@@ -0,0 +1,255 @@
+//==============================================================================
+//includes:
+
+#include "MqttLinkSocket.h"
+#include "MqttClient/MqttClient-ComponentConfig.h"
+#include "MqttClient/Adapters/Ports/FreeRTOS-MQTT/MqttPort-Adapter.h"
+#include "TerminalCommands/TerminalCommands.h"
+#include <stdio.h>
+#include <string.h>
+//==============================================================================
+//defines:
+
+#define LINK_LATENCY 20000 //us, one way
+#define LINK_RATE 1000000 //bit/s
+
+#define IDLE_TIME 600 //seconds
+#define COMMAND_TIME 120 //seconds
+#define COMMAND_PERIOD 7 //seconds, the device publishes to its command topic, the broker delivers it back
+
+#define COMMAND "ping\r"
+#define COMMAND_TOPIC "idle/command"
+//the packet crosses the link: the latency, the serialization of a short packet, the poll quantum of the stand-in
+#define LINK_TIME (LINK_LATENCY + 1000)
+//==============================================================================
+//variables:
+
+static xPortT privatePort;
+static MqttPortAdapterT privateAdapter;
+
+static uint8_t privateMqttBuffer[1024];
+static uint8_t privateTxBuffer[MQTT_PORT_TX_BUFFER];
+
+static uint64_t privateCommandTime; //us, xPortEndTransmission of the last command
+static uint32_t privateCommandsSent;
+static uint32_t privateCommandsPublished; //taken by the broker
+static uint32_t privateCommandsReceived; //handled by the port task
+static uint32_t privateWireLatency; //us, the worst from xPortEndTransmission to the broker
+static uint32_t privateCommandLatency; //us, the worst from xPortEndTransmission to TerminalCommandsReceive
+static bool privateIsCommandBroken;
+//==============================================================================
+//functions:
+
+/// @brief the incoming publishes without a router: the command came back from the broker
+void TerminalCommandsReceive(xPortT* port, RxDataPacketT* packet)
+{
+	uint32_t latency = MqttLinkGetTime() - privateCommandTime;
+
+	if (packet->FullSize != sizeof(COMMAND) - 1 || memcmp(packet->Data, COMMAND, packet->FullSize))
+	{
+		privateIsCommandBroken = true;
+	}
+
+	if (latency > privateCommandLatency)
+	{
+		privateCommandLatency = latency;
+	}
+
+	privateCommandsReceived++;
+}
+//------------------------------------------------------------------------------
+static void privateCommandPublished(uint64_t time, const uint8_t* payload, uint32_t size)
+{
+	uint32_t latency = time - privateCommandTime;
+
+	if (latency > privateWireLatency)
+	{
+		privateWireLatency = latency;
+	}
+
+	privateCommandsPublished++;
+}
+//------------------------------------------------------------------------------
+/// @brief another task writes the command to the port, the adapter publishes it from the task
+static void privateCommandTask()
+{
+	xPortStartTransmission(&privatePort);
+	xPortTransmitData(&privatePort, COMMAND, sizeof(COMMAND) - 1);
+	privateCommandTime = MqttLinkGetTime();
+	xPortEndTransmission(&privatePort);
+
+	privateCommandsSent++;
+
+	MqttLinkSocketSchedule(MqttLinkGetTime() + COMMAND_PERIOD * 1000000ull, privateCommandTask);
+}
+//------------------------------------------------------------------------------
+/// @brief the port of MqttClient-Component: QoS0, the keep-alive of the board, TxTopic is RxTopic
+static bool privateOpen()
+{
+	MqttLinkInitT linkInit =
+	{
+		.Latency = LINK_LATENCY,
+		.Rate = LINK_RATE
+	};
+
+	MqttLinkSocketReset();
+
+	if (MqttLinkOpen(&linkInit) != xResultAccept
+		|| MqttLinkObserve(COMMAND_TOPIC, privateCommandPublished) != xResultAccept)
+	{
+		return false;
+	}
+
+	MqttPortAdapterInitT init = { 0 };
+	init.TxTopic = COMMAND_TOPIC;
+	init.RxTopic = COMMAND_TOPIC;
+	init.MqttBuffer = privateMqttBuffer;
+	init.MqttBufferSize = sizeof(privateMqttBuffer);
+	init.TxBuffer = privateTxBuffer;
+	init.TxBufferSize = sizeof(privateTxBuffer);
+
+	privateAdapter.Id = "idle";
+	privateAdapter.QoS = MQTTQoS0;
+	privateAdapter.KeepAlive = MQTT_PORT_KEEP_ALIVE;
+
+	if (MqttPortAdapterInit(&privatePort, &privateAdapter, &init) != xResultAccept)
+	{
+		return false;
+	}
+
+	xPortAdapterInterfaceT* interface = privatePort.Adapter.Interface;
+
+	interface->RequestListener(&privatePort, xPortAdapterRequestOpen, 0, NULL);
+	interface->RequestListener(&privatePort, xPortAdapterRequestConnect, 0, NULL);
+
+	return privatePort.IsConnected;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the loop of MqttClient-Component's task on the connected port until the time or the disconnect
+ * @return the passes of the task
+ */
+static uint32_t privateTaskRun(uint64_t end)
+{
+	uint32_t passes = 0;
+
+	while (MqttLinkGetTime() < end && privatePort.IsConnected)
+	{
+		passes++;
+
+		privatePort.Adapter.Interface->Handler(&privatePort);
+
+		if (!privatePort.IsConnected)
+		{
+			break;
+		}
+
+		MqttPortAdapterWaitEvent(&privatePort, MQTT_TASK_MAX_WAIT_TIME);
+	}
+
+	return passes;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	if (!privateOpen())
+	{
+		printf("FAIL: connect\n");
+		return 1;
+	}
+
+	//idle: the keep-alive only
+	uint32_t pings = MqttLinkBroker.Statistic.Pings;
+	uint32_t receives = MqttLinkSocketStatistic.Receives;
+	uint32_t passes = privateTaskRun(MqttLinkGetTime() + IDLE_TIME * 1000000ull);
+
+	pings = MqttLinkBroker.Statistic.Pings - pings;
+	receives = MqttLinkSocketStatistic.Receives - receives;
+
+	printf("idle %u s, keep-alive %u s, max wait %u ms:\n", IDLE_TIME, MQTT_PORT_KEEP_ALIVE, MQTT_TASK_MAX_WAIT_TIME);
+	printf("  task passes: %u (%u/min, polling every 1 ms: 60000/min), receive calls: %u, PINGREQ: %u\n",
+			passes, passes * 60 / IDLE_TIME, receives, pings);
+
+	if (!privatePort.IsConnected)
+	{
+		printf("FAIL: idle connection\n");
+		return 1;
+	}
+
+	//the task sleeps on the timers: the max wait and the keep-alive, PINGRESP wakes it once more
+	uint32_t expectedPasses = IDLE_TIME * 1000 / MQTT_TASK_MAX_WAIT_TIME + pings * 2;
+
+	if (passes > expectedPasses)
+	{
+		printf("FAIL: %u passes, expected not more than %u\n", passes, expectedPasses);
+		return 1;
+	}
+
+	if (pings < IDLE_TIME / MQTT_PORT_KEEP_ALIVE - 1 || pings > IDLE_TIME / MQTT_PORT_KEEP_ALIVE)
+	{
+		printf("FAIL: %u PINGREQ\n", pings);
+		return 1;
+	}
+
+	//commands: published from another task at once, the socket event wakes the port task on their return
+	MqttLinkSocketSchedule(MqttLinkGetTime() + COMMAND_PERIOD * 1000000ull, privateCommandTask);
+
+	passes = privateTaskRun(MqttLinkGetTime() + COMMAND_TIME * 1000000ull);
+	MqttLinkSocketSchedule(UINT64_MAX, NULL);
+
+	printf("commands every %u s for %u s: %u sent, %u at the broker, %u received, %u task passes\n",
+			COMMAND_PERIOD, COMMAND_TIME, privateCommandsSent, privateCommandsPublished, privateCommandsReceived, passes);
+	printf("  worst latency: to the broker %u us, back to the terminal %u us (one way %u us)\n",
+			privateWireLatency, privateCommandLatency, LINK_LATENCY);
+
+	if (!privatePort.IsConnected
+		|| privateIsCommandBroken
+		|| privateCommandsSent != COMMAND_TIME / COMMAND_PERIOD
+		|| privateCommandsPublished != privateCommandsSent
+		|| privateCommandsReceived != privateCommandsSent)
+	{
+		printf("FAIL: commands\n");
+		return 1;
+	}
+
+	//not on the next timer of the port task: the link is the whole latency
+	if (privateWireLatency > LINK_TIME || privateCommandLatency > 2 * LINK_TIME)
+	{
+		printf("FAIL: command latency\n");
+		return 1;
+	}
+
+	//a command adds its return: the wakeup on the socket event and the pass that finds no more data
+	expectedPasses = COMMAND_TIME * 1000 / MQTT_TASK_MAX_WAIT_TIME + privateCommandsSent * 2
+					+ (COMMAND_TIME / MQTT_PORT_KEEP_ALIVE) * 2;
+
+	if (passes > expectedPasses)
+	{
+		printf("FAIL: %u passes with commands, expected not more than %u\n", passes, expectedPasses);
+		return 1;
+	}
+
+	//the broker goes silent: no close, no answers
+	MqttLinkSetSilent(true);
+
+	uint32_t lastTxTime = privateAdapter.Internal.MQTTContext.lastPacketTxTime;
+
+	passes = privateTaskRun(MqttLinkGetTime() + (MQTT_PORT_KEEP_ALIVE + 60) * 1000000ull);
+
+	uint32_t detection = MqttLinkGetTime() / 1000 - lastTxTime;
+
+	printf("dead broker: detected %u ms after the last packet sent, %u task passes\n", detection, passes);
+
+	if (privatePort.IsConnected || detection > MQTT_PORT_KEEP_ALIVE * 1000 + MQTT_PINGRESP_TIMEOUT_MS + 1)
+	{
+		printf("FAIL: dead broker\n");
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
@@ -0,0 +1,310 @@
+//==============================================================================
+//includes:
+
+#include "MqttLink.h"
+#include "MQTTPacket.h"
+#include <string.h>
+//==============================================================================
+//defines:
+
+#define LINK_SEGMENTS 64
+#define LINK_SEGMENT_SIZE 256
+#define LINK_PACKET_SIZE 1024
+#define LINK_SESSIONS 2 //the client and the observer
+//==============================================================================
+//types:
+
+typedef struct
+{
+	uint64_t Time; //us, the segment is readable from
+	uint16_t Size;
+	uint16_t Offset;
+	uint8_t Data[LINK_SEGMENT_SIZE];
+
+} LinkSegmentT;
+//------------------------------------------------------------------------------
+/// @brief one direction of the connection: FIFO of segments delayed by the latency and the rate
+typedef struct
+{
+	LinkSegmentT Segments[LINK_SEGMENTS];
+	uint8_t Head;
+	uint8_t Count;
+
+	uint64_t BusyUntil; //us, the end of the serialization of the last segment
+
+} LinkT;
+//==============================================================================
+//variables:
+
+static uint64_t privateTime; //us
+static uint32_t privateLatency;
+static uint32_t privateRate;
+static bool privateIsSilent;
+
+static LinkT privateUplink; //client -> broker
+static LinkT privateDownlink; //broker -> client
+
+static MqttBrokerSessionT privateSessions[LINK_SESSIONS];
+static uint8_t privateBrokerMemory[LINK_PACKET_SIZE * (LINK_SESSIONS + 1)];
+static uint8_t privateSession;
+static uint8_t privateObserverSession;
+static MqttLinkPublishListenerT privateObserver;
+
+MqttBrokerT MqttLinkBroker;
+//==============================================================================
+//functions:
+
+static uint32_t privateLinkPut(LinkT* link, const uint8_t* data, uint32_t size)
+{
+	uint32_t taken = 0;
+
+	while (taken < size && link->Count < LINK_SEGMENTS)
+	{
+		LinkSegmentT* segment = &link->Segments[(link->Head + link->Count) % LINK_SEGMENTS];
+		uint32_t part = size - taken < LINK_SEGMENT_SIZE ? size - taken : LINK_SEGMENT_SIZE;
+		uint64_t start = link->BusyUntil > privateTime ? link->BusyUntil : privateTime;
+
+		link->BusyUntil = start + (uint64_t)part * 8 * 1000000 / privateRate;
+
+		segment->Time = link->BusyUntil + privateLatency;
+		segment->Size = part;
+		segment->Offset = 0;
+		memcpy(segment->Data, data + taken, part);
+
+		link->Count++;
+		taken += part;
+	}
+
+	return taken;
+}
+//------------------------------------------------------------------------------
+static LinkSegmentT* privateLinkReady(LinkT* link)
+{
+	LinkSegmentT* segment = &link->Segments[link->Head];
+
+	return link->Count && segment->Time <= privateTime ? segment : NULL;
+}
+//------------------------------------------------------------------------------
+static void privateLinkRemove(LinkT* link)
+{
+	link->Head = (link->Head + 1) % LINK_SEGMENTS;
+	link->Count--;
+}
+//------------------------------------------------------------------------------
+static void privateBrokerTake()
+{
+	LinkSegmentT* segment;
+
+	while ((segment = privateLinkReady(&privateUplink)))
+	{
+		if (!privateIsSilent)
+		{
+			MqttBrokerReceive(&MqttLinkBroker, privateSession, segment->Data, segment->Size);
+		}
+
+		privateLinkRemove(&privateUplink);
+	}
+}
+//------------------------------------------------------------------------------
+uint64_t MqttLinkGetArrivalTime(uint64_t after)
+{
+	for (uint8_t i = 0; i < privateDownlink.Count; i++)
+	{
+		uint64_t time = privateDownlink.Segments[(privateDownlink.Head + i) % LINK_SEGMENTS].Time;
+
+		if (time > after)
+		{
+			return time;
+		}
+	}
+
+	return UINT64_MAX;
+}
+//------------------------------------------------------------------------------
+uint64_t MqttLinkGetNextTime(uint64_t after)
+{
+	uint64_t next = MqttLinkGetArrivalTime(after);
+
+	if (privateUplink.Count && privateUplink.Segments[privateUplink.Head].Time < next)
+	{
+		next = privateUplink.Segments[privateUplink.Head].Time;
+	}
+
+	return next;
+}
+//------------------------------------------------------------------------------
+void MqttLinkRunTo(uint64_t time)
+{
+	while (privateUplink.Count && privateUplink.Segments[privateUplink.Head].Time <= time)
+	{
+		uint64_t next = privateUplink.Segments[privateUplink.Head].Time;
+
+		if (next > privateTime)
+		{
+			privateTime = next;
+		}
+
+		privateBrokerTake();
+	}
+
+	if (time > privateTime)
+	{
+		privateTime = time;
+	}
+}
+//------------------------------------------------------------------------------
+uint64_t MqttLinkGetTime()
+{
+	return privateTime;
+}
+//------------------------------------------------------------------------------
+void MqttLinkSetSilent(bool isSilent)
+{
+	privateIsSilent = isSilent;
+}
+//------------------------------------------------------------------------------
+uint32_t MqttLinkSend(const void* data, uint32_t size)
+{
+	return privateLinkPut(&privateUplink, data, size);
+}
+//------------------------------------------------------------------------------
+uint32_t MqttLinkGetSendSpace()
+{
+	return (LINK_SEGMENTS - privateUplink.Count) * LINK_SEGMENT_SIZE;
+}
+//------------------------------------------------------------------------------
+uint32_t MqttLinkReceive(void* data, uint32_t size)
+{
+	uint32_t received = 0;
+	LinkSegmentT* segment;
+
+	while (received < size && (segment = privateLinkReady(&privateDownlink)))
+	{
+		uint32_t part = segment->Size - segment->Offset;
+
+		if (part > size - received)
+		{
+			part = size - received;
+		}
+
+		memcpy((uint8_t*)data + received, segment->Data + segment->Offset, part);
+		segment->Offset += part;
+		received += part;
+
+		if (segment->Offset == segment->Size)
+		{
+			privateLinkRemove(&privateDownlink);
+		}
+	}
+
+	return received;
+}
+//------------------------------------------------------------------------------
+uint32_t MqttLinkGetReadableSize()
+{
+	uint32_t size = 0;
+
+	for (uint8_t i = 0; i < privateDownlink.Count; i++)
+	{
+		LinkSegmentT* segment = &privateDownlink.Segments[(privateDownlink.Head + i) % LINK_SEGMENTS];
+
+		if (segment->Time > privateTime)
+		{
+			break;
+		}
+
+		size += segment->Size - segment->Offset;
+	}
+
+	return size;
+}
+//------------------------------------------------------------------------------
+static int32_t privateBrokerSend(void* context, const void* data, uint32_t size)
+{
+	return privateLinkPut(&privateDownlink, data, size);
+}
+//------------------------------------------------------------------------------
+/// @brief the deliveries to the observer are whole packets, only the publishes are passed on
+static int32_t privateObserverSend(void* context, const void* data, uint32_t size)
+{
+	unsigned char dup;
+	unsigned char retained;
+	unsigned short packetId;
+	int qos;
+	MQTTString topic;
+	unsigned char* payload;
+	int payloadLength;
+
+	if (MQTTDeserialize_publish(&dup, &qos, &retained, &packetId, &topic,
+								&payload, &payloadLength, (unsigned char*)data, size) == 1)
+	{
+		privateObserver(privateTime, payload, payloadLength);
+	}
+
+	return size;
+}
+//------------------------------------------------------------------------------
+xResult MqttLinkObserve(const char* filter, MqttLinkPublishListenerT listener)
+{
+	uint8_t packet[64];
+	int size;
+
+	if (MqttBrokerOpen(&MqttLinkBroker, privateObserverSend, NULL, &privateObserverSession) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	privateObserver = listener;
+
+	MQTTPacket_connectData connectData = MQTTPacket_connectData_initializer;
+	connectData.clientID.cstring = "observer";
+
+	size = MQTTSerialize_connect(packet, sizeof(packet), &connectData);
+
+	if (size <= 0 || MqttBrokerReceive(&MqttLinkBroker, privateObserverSession, packet, size) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	MQTTString topicFilter = MQTTString_initializer;
+	topicFilter.cstring = (char*)filter;
+	int qos = 0;
+
+	size = MQTTSerialize_subscribe(packet, sizeof(packet), 0, 1, 1, &topicFilter, &qos);
+
+	if (size <= 0 || MqttBrokerReceive(&MqttLinkBroker, privateObserverSession, packet, size) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	return xResultAccept;
+}
+//==============================================================================
+//initialization:
+
+xResult MqttLinkOpen(MqttLinkInitT* init)
+{
+	memset(&privateUplink, 0, sizeof(privateUplink));
+	memset(&privateDownlink, 0, sizeof(privateDownlink));
+	privateTime = 0;
+	privateLatency = init->Latency;
+	privateRate = init->Rate;
+	privateIsSilent = false;
+
+	MqttBrokerInitT brokerInit =
+	{
+		.Sessions = privateSessions,
+		.SessionsSize = LINK_SESSIONS,
+		.Memory = privateBrokerMemory,
+		.MemorySize = sizeof(privateBrokerMemory),
+		.PacketSize = LINK_PACKET_SIZE
+	};
+
+	if (MqttBrokerInit(&MqttLinkBroker, &brokerInit) != xResultAccept)
+	{
+		return xResultError;
+	}
+
+	return MqttBrokerOpen(&MqttLinkBroker, privateBrokerSend, NULL, &privateSession);
+}
+//==============================================================================
@@ -0,0 +1,71 @@
+//==============================================================================
+//header:
+
+#ifndef _MQTT_LINK_H_
+#define _MQTT_LINK_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "MqttBroker.h"
+//==============================================================================
+//types:
+
+/// @brief simulated TCP connection from the client socket to the MqttBroker stand-in
+typedef struct
+{
+	uint32_t Latency; //us, one way
+	uint32_t Rate; //bit/s
+
+} MqttLinkInitT;
+//------------------------------------------------------------------------------
+/// @brief a publish taken by the broker, time - us, the arrival of its last segment
+typedef void (*MqttLinkPublishListenerT)(uint64_t time, const uint8_t* payload, uint32_t size);
+//==============================================================================
+//functions:
+
+/// @brief resets the clock, the link and the broker, opens the session of the client
+xResult MqttLinkOpen(MqttLinkInitT* init);
+
+/// @brief the broker passes the publishes matching the filter to the listener as they arrive
+xResult MqttLinkObserve(const char* filter, MqttLinkPublishListenerT listener);
+
+/// @return bytes taken to the link, split into segments; 0 - the link is full
+uint32_t MqttLinkSend(const void* data, uint32_t size);
+
+/// @return bytes the link takes now
+uint32_t MqttLinkGetSendSpace();
+
+/// @return bytes of the segments arrived to the client, doesn't wait
+uint32_t MqttLinkReceive(void* data, uint32_t size);
+
+/// @return bytes arrived to the client and not received
+uint32_t MqttLinkGetReadableSize();
+
+/// @return us, the first segment arriving to the client after the time, UINT64_MAX - none
+uint64_t MqttLinkGetArrivalTime(uint64_t after);
+
+/// @return us, the next event after the time: a segment taken by the broker or a segment arriving to the client,
+/// UINT64_MAX - none
+uint64_t MqttLinkGetNextTime(uint64_t after);
+
+/// @brief the clock goes to the time, the broker takes its segments on the way
+void MqttLinkRunTo(uint64_t time);
+
+uint64_t MqttLinkGetTime();
+
+/// @brief the broker stops taking the segments: the connection is dead without a close
+void MqttLinkSetSilent(bool isSilent);
+//==============================================================================
+//variables:
+
+extern MqttBrokerT MqttLinkBroker;
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MQTT_LINK_H_
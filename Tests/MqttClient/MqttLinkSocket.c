@@ -0,0 +1,446 @@
+//==============================================================================
+//includes:
+
+#include "MqttLinkSocket.h"
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+#include "FreeRTOS_IP.h"
+#include "main.h"
+#include "Components.h"
+#include "Abstractions/xPort/xPort.h"
+#include <stdlib.h>
+#include <time.h>
+//==============================================================================
+//types:
+
+struct MqttLinkSocketT
+{
+	SemaphoreHandle_t Semaphore; //FREERTOS_SO_SET_SEMAPHORE
+	uint64_t NotifiedTime; //us, the arrivals up to it have given the semaphore
+
+	TickType_t ReceiveTimeout;
+	TickType_t SendTimeout;
+
+	bool IsConnected;
+	bool IsStreamCreated; //by the first FreeRTOS_send
+
+	uint8_t Stream[MQTT_LINK_TX_STREAM_SIZE];
+};
+//------------------------------------------------------------------------------
+struct MqttLinkSemaphoreT
+{
+	Socket_t Socket;
+	uint32_t Depth; //the mutex is taken
+	bool IsGiven;
+};
+//------------------------------------------------------------------------------
+/// @brief the condition that ends a blocked call
+typedef bool (*privateConditionT)(void* object);
+//==============================================================================
+//variables:
+
+static uint32_t privateMutexDepth; //the running task holds a mutex, the others can't run
+static uint64_t privateTaskTime;
+static MqttLinkTaskT privateTask;
+
+static DWT_Type privateDwt;
+
+MqttLinkSocketStatisticT MqttLinkSocketStatistic;
+//==============================================================================
+//functions:
+
+static uint64_t privateDeadline(TickType_t ticks)
+{
+	return ticks == portMAX_DELAY ? UINT64_MAX : MqttLinkGetTime() + (uint64_t)ticks * 1000;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief moves the clock event by event until the condition is met or the deadline passes,
+ * the scheduled task runs on its time if no mutex is held
+ * @return the condition is met
+ */
+static bool privateBlock(uint64_t deadline, privateConditionT condition, void* object, uint64_t* after)
+{
+	while (true)
+	{
+		if (condition(object))
+		{
+			return true;
+		}
+
+		uint64_t time = MqttLinkGetTime();
+
+		if (privateTask && !privateMutexDepth && privateTaskTime <= time)
+		{
+			MqttLinkTaskT task = privateTask;
+
+			privateTask = NULL;
+			task();
+
+			continue;
+		}
+
+		if (time >= deadline)
+		{
+			return false;
+		}
+
+		uint64_t next = MqttLinkGetNextTime(after ? *after : time);
+
+		if (privateTask && !privateMutexDepth && privateTaskTime < next)
+		{
+			next = privateTaskTime;
+		}
+
+		if (next > deadline)
+		{
+			next = deadline;
+		}
+
+		MqttLinkRunTo(next);
+	}
+}
+//------------------------------------------------------------------------------
+static bool privateIsGiven(void* object)
+{
+	SemaphoreHandle_t semaphore = object;
+
+	if (semaphore->IsGiven)
+	{
+		semaphore->IsGiven = false;
+		return true;
+	}
+
+	//the socket gives the semaphore on the arrival of data
+	if (semaphore->Socket && MqttLinkGetArrivalTime(semaphore->Socket->NotifiedTime) <= MqttLinkGetTime())
+	{
+		semaphore->Socket->NotifiedTime = MqttLinkGetTime();
+		return true;
+	}
+
+	return false;
+}
+//------------------------------------------------------------------------------
+static bool privateIsReadable(void* object)
+{
+	return MqttLinkGetReadableSize() != 0;
+}
+//------------------------------------------------------------------------------
+static bool privateIsWritable(void* object)
+{
+	return MqttLinkGetSendSpace() != 0;
+}
+//------------------------------------------------------------------------------
+SemaphoreHandle_t xSemaphoreCreateBinary()
+{
+	return calloc(1, sizeof(struct MqttLinkSemaphoreT));
+}
+//------------------------------------------------------------------------------
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+	return calloc(1, sizeof(struct MqttLinkSemaphoreT));
+}
+//------------------------------------------------------------------------------
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex()
+{
+	return calloc(1, sizeof(struct MqttLinkSemaphoreT));
+}
+//------------------------------------------------------------------------------
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks)
+{
+	if (privateIsGiven(semaphore))
+	{
+		return pdTRUE;
+	}
+
+	if (!ticks)
+	{
+		return pdFALSE;
+	}
+
+	MqttLinkSocketStatistic.Waits++;
+
+	uint64_t* after = semaphore->Socket ? &semaphore->Socket->NotifiedTime : NULL;
+
+	if (privateBlock(privateDeadline(ticks), privateIsGiven, semaphore, after))
+	{
+		MqttLinkSocketStatistic.Wakeups++;
+		return pdTRUE;
+	}
+
+	return pdFALSE;
+}
+//------------------------------------------------------------------------------
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+	semaphore->IsGiven = true;
+
+	return pdTRUE;
+}
+//------------------------------------------------------------------------------
+/// @brief one task runs at a time: the mutex is free whenever it is taken
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticks)
+{
+	semaphore->Depth++;
+	privateMutexDepth++;
+
+	return pdTRUE;
+}
+//------------------------------------------------------------------------------
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore)
+{
+	if (!semaphore->Depth)
+	{
+		return pdFALSE;
+	}
+
+	semaphore->Depth--;
+	privateMutexDepth--;
+
+	return pdTRUE;
+}
+//------------------------------------------------------------------------------
+Socket_t FreeRTOS_socket(BaseType_t domain, BaseType_t type, BaseType_t protocol)
+{
+	Socket_t socket = calloc(1, sizeof(struct MqttLinkSocketT));
+
+	socket->ReceiveTimeout = ipconfigSOCK_DEFAULT_RECEIVE_BLOCK_TIME;
+	socket->SendTimeout = ipconfigSOCK_DEFAULT_SEND_BLOCK_TIME;
+
+	return socket;
+}
+//------------------------------------------------------------------------------
+BaseType_t FreeRTOS_setsockopt(Socket_t socket, int32_t level, int32_t name, const void* value, size_t length)
+{
+	MqttLinkSocketStatistic.Options++;
+
+	switch (name)
+	{
+		case FREERTOS_SO_RCVTIMEO:
+			socket->ReceiveTimeout = *(const TickType_t*)value;
+			break;
+
+		case FREERTOS_SO_SNDTIMEO:
+			socket->SendTimeout = *(const TickType_t*)value;
+			break;
+
+		case FREERTOS_SO_SET_SEMAPHORE:
+			socket->Semaphore = *(const SemaphoreHandle_t*)value;
+			socket->Semaphore->Socket = socket;
+			socket->NotifiedTime = MqttLinkGetTime();
+			break;
+
+		default: return -1;
+	}
+
+	return 0;
+}
+//------------------------------------------------------------------------------
+/// @brief the link is open by the test, the connection is taken at once
+BaseType_t FreeRTOS_connect(Socket_t socket, struct freertos_sockaddr* address, socklen_t length)
+{
+	socket->IsConnected = true;
+
+	return 0;
+}
+//------------------------------------------------------------------------------
+BaseType_t FreeRTOS_closesocket(Socket_t socket)
+{
+	if (socket)
+	{
+		if (socket->Semaphore)
+		{
+			socket->Semaphore->Socket = NULL;
+		}
+
+		free(socket);
+	}
+
+	return 0;
+}
+//------------------------------------------------------------------------------
+BaseType_t FreeRTOS_recv(Socket_t socket, void* buffer, size_t length, BaseType_t flags)
+{
+	MqttLinkSocketStatistic.Receives++;
+
+	if (!socket->IsConnected)
+	{
+		return -pdFREERTOS_ERRNO_ENOTCONN;
+	}
+
+	bool isWaiting = !(flags & FREERTOS_MSG_DONTWAIT) && socket->ReceiveTimeout;
+
+	if (isWaiting)
+	{
+		privateBlock(privateDeadline(socket->ReceiveTimeout), privateIsReadable, NULL, NULL);
+	}
+
+	uint32_t received = MqttLinkReceive(buffer, length);
+
+	if (!received)
+	{
+		MqttLinkSocketStatistic.EmptyReceives++;
+
+		if (!isWaiting)
+		{
+			MqttLinkRunTo(MqttLinkGetTime() + MQTT_LINK_POLL_TIME);
+		}
+	}
+
+	return received;
+}
+//------------------------------------------------------------------------------
+BaseType_t FreeRTOS_recvcount(Socket_t socket)
+{
+	return MqttLinkGetReadableSize();
+}
+//------------------------------------------------------------------------------
+BaseType_t FreeRTOS_send(Socket_t socket, const void* buffer, size_t length, BaseType_t flags)
+{
+	MqttLinkSocketStatistic.Sends++;
+
+	if (!socket->IsConnected)
+	{
+		return -pdFREERTOS_ERRNO_ENOTCONN;
+	}
+
+	socket->IsStreamCreated = true;
+
+	//the bytes are at the head of the stream, their space was checked by FreeRTOS_tx_space
+	if (!buffer)
+	{
+		return MqttLinkSend(socket->Stream, length);
+	}
+
+	uint64_t deadline = privateDeadline(socket->SendTimeout);
+	uint32_t sent = MqttLinkSend(buffer, length);
+
+	while (sent < length && privateBlock(deadline, privateIsWritable, NULL, NULL))
+	{
+		sent += MqttLinkSend((const uint8_t*)buffer + sent, length - sent);
+	}
+
+	return sent ? (BaseType_t)sent : -pdFREERTOS_ERRNO_ENOSPC;
+}
+//------------------------------------------------------------------------------
+BaseType_t FreeRTOS_tx_space(Socket_t socket)
+{
+	uint32_t space = MqttLinkGetSendSpace();
+
+	return space < MQTT_LINK_TX_STREAM_SIZE ? space : MQTT_LINK_TX_STREAM_SIZE;
+}
+//------------------------------------------------------------------------------
+uint8_t* FreeRTOS_get_tx_head(Socket_t socket, BaseType_t* length)
+{
+	if (!socket->IsStreamCreated)
+	{
+		return NULL;
+	}
+
+	*length = FreeRTOS_tx_space(socket);
+
+	return socket->Stream;
+}
+//------------------------------------------------------------------------------
+uint32_t FreeRTOS_gethostbyname(const char* name)
+{
+	return 0x0100007F;
+}
+//------------------------------------------------------------------------------
+TickType_t xTaskGetTickCount()
+{
+	return MqttLinkGetTime() / 1000;
+}
+//------------------------------------------------------------------------------
+uint32_t xSystemGetTime()
+{
+	return MqttLinkGetTime() / 1000;
+}
+//------------------------------------------------------------------------------
+void vTaskSetTimeOutState(TimeOut_t* timeOut)
+{
+	timeOut->TimeOnEntering = xTaskGetTickCount();
+}
+//------------------------------------------------------------------------------
+BaseType_t xTaskCheckForTimeOut(TimeOut_t* timeOut, TickType_t* ticksToWait)
+{
+	TickType_t time = xTaskGetTickCount();
+	TickType_t elapsed = time - timeOut->TimeOnEntering;
+
+	if (*ticksToWait == portMAX_DELAY)
+	{
+		return pdFALSE;
+	}
+
+	if (elapsed < *ticksToWait)
+	{
+		*ticksToWait -= elapsed;
+		timeOut->TimeOnEntering = time;
+
+		return pdFALSE;
+	}
+
+	*ticksToWait = 0;
+
+	return pdTRUE;
+}
+//------------------------------------------------------------------------------
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+	return NULL;
+}
+//------------------------------------------------------------------------------
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task)
+{
+	return 0;
+}
+//------------------------------------------------------------------------------
+/// @brief the tasks of the test are run by MqttLinkSocketSchedule
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint16_t stackSize, void* parameters, UBaseType_t priority, TaskHandle_t* task)
+{
+	return pdFAIL;
+}
+//------------------------------------------------------------------------------
+DWT_Type* MqttHostGetDwt()
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+	privateDwt.CYCCNT = (uint32_t)((uint64_t)time.tv_sec * 1000000000 + time.tv_nsec);
+
+	return &privateDwt;
+}
+//------------------------------------------------------------------------------
+/// @brief the transmissions of the tasks go to the adapter of the port
+void xPortStartTransmission(xPortT* port)
+{
+	port->Adapter.Interface->RequestListener(port, xPortAdapterRequestStartTransmission, 0, NULL);
+}
+//------------------------------------------------------------------------------
+int xPortTransmitData(xPortT* port, void* data, uint32_t size)
+{
+	return port->Adapter.Interface->Transmit(port, data, size);
+}
+//------------------------------------------------------------------------------
+void xPortEndTransmission(xPortT* port)
+{
+	port->Adapter.Interface->RequestListener(port, xPortAdapterRequestEndTransmission, 0, NULL);
+}
+//------------------------------------------------------------------------------
+void MqttLinkSocketSchedule(uint64_t time, MqttLinkTaskT task)
+{
+	privateTaskTime = time;
+	privateTask = task;
+}
+//==============================================================================
+//initialization:
+
+void MqttLinkSocketReset()
+{
+	memset(&MqttLinkSocketStatistic, 0, sizeof(MqttLinkSocketStatistic));
+
+	privateMutexDepth = 0;
+	privateTask = NULL;
+}
+//==============================================================================
@@ -0,0 +1,55 @@
+//==============================================================================
+//header:
+
+#ifndef _MQTT_LINK_SOCKET_H_
+#define _MQTT_LINK_SOCKET_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "MqttLink.h"
+//==============================================================================
+//defines:
+
+#define MQTT_LINK_POLL_TIME 2 //us, the clock of a receive that doesn't wait and finds nothing
+#define MQTT_LINK_TX_STREAM_SIZE 2048 //TX stream of the socket, ipconfigTCP_TX_BUFFER_LENGTH
+//==============================================================================
+//types:
+
+/// @brief calls of the FreeRTOS+TCP and FreeRTOS API made by the code under test
+typedef struct
+{
+	uint32_t Receives;
+	uint32_t EmptyReceives; //returned nothing
+	uint32_t Sends;
+	uint32_t Options; //FreeRTOS_setsockopt
+
+	uint32_t Waits; //semaphore takes that blocked
+	uint32_t Wakeups; //of them, ended by a give or a socket event
+
+} MqttLinkSocketStatisticT;
+//------------------------------------------------------------------------------
+/// @brief another task: runs while the waiting one holds no mutex, gives its semaphores
+typedef void (*MqttLinkTaskT)();
+//==============================================================================
+//functions:
+
+/// @brief the FreeRTOS+TCP socket, the semaphores and the clock (xSystemGetTime, xTaskGetTickCount, DWT)
+/// run on MqttLink: a blocked take of a semaphore moves the clock to the next event
+void MqttLinkSocketReset();
+
+/// @brief the task runs at the time from a blocked take, once; a later call replaces it
+void MqttLinkSocketSchedule(uint64_t time, MqttLinkTaskT task);
+//==============================================================================
+//variables:
+
+extern MqttLinkSocketStatisticT MqttLinkSocketStatistic;
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_MQTT_LINK_SOCKET_H_
@@ -0,0 +1,205 @@
+//==============================================================================
+//includes:
+
+#include "MqttClient/Outbox/MqttOutbox.h"
+#include "MqttClient/Outbox/MqttOutbox-RamFlash.h"
+#include "Crc/Crc.h"
+#include <stdio.h>
+#include <string.h>
+//==============================================================================
+//defines:
+
+#define SECTOR_SIZE 256
+#define SECTOR_COUNT 8
+
+#define RECORDS 60
+#define WRAP_RECORDS 1000
+//==============================================================================
+//variables:
+
+static uint8_t privateMemory[SECTOR_COUNT * SECTOR_SIZE];
+static uint32_t privateCrcTable[CRC_TABLE_SIZE(4)];
+
+static CrcEngineT privateCrc;
+static MqttOutboxRamFlashT privateFlash;
+static MqttOutboxFlashInterfaceT privateFlashInterface;
+//==============================================================================
+//functions:
+
+/// @brief as the component: CRC-32 of the Crc engine
+static uint32_t privateOutboxCrc(const void* data, uint32_t size)
+{
+	return CrcEngineCalculate(&privateCrc, data, size);
+}
+//------------------------------------------------------------------------------
+static xResult privateMount(MqttOutboxT* outbox)
+{
+	MqttOutboxInitT init =
+	{
+		.Flash = &privateFlashInterface,
+		.Crc = privateOutboxCrc,
+		.SectorSize = SECTOR_SIZE,
+		.SectorCount = SECTOR_COUNT
+	};
+
+	return MqttOutboxInit(outbox, &init);
+}
+//------------------------------------------------------------------------------
+static uint16_t privateRecord(char* buffer, uint32_t number)
+{
+	return sprintf(buffer, "msg-%03u-xxxxxxxxxxxxxx", number % 1000);
+}
+//------------------------------------------------------------------------------
+/// @return the number of the oldest record, -1 - empty or not a record of the test
+static int privatePeekNumber(MqttOutboxT* outbox)
+{
+	char buffer[64];
+	int size = MqttOutboxPeek(outbox, buffer, sizeof(buffer) - 1);
+	unsigned number;
+
+	if (size <= 0)
+	{
+		return -1;
+	}
+
+	buffer[size] = 0;
+
+	return sscanf(buffer, "msg-%u", &number) == 1 ? (int)number : -1;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	char buffer[64];
+	MqttOutboxT outbox;
+	uint32_t written = 0;
+	int number;
+
+	CrcEngineInit(&privateCrc, &CrcParameters[CrcVariant32], privateCrcTable, 4);
+	MqttOutboxRamFlashInit(&privateFlash, &privateFlashInterface, privateMemory, sizeof(privateMemory), SECTOR_SIZE);
+
+	MqttOutboxInitT noCrc = { .Flash = &privateFlashInterface, .SectorSize = SECTOR_SIZE, .SectorCount = SECTOR_COUNT };
+
+	if (MqttOutboxInit(&outbox, &noCrc) == xResultAccept || privateMount(&outbox) != xResultAccept)
+	{
+		printf("FAIL: init\n");
+		return 1;
+	}
+
+	//more records than the region holds: the oldest sectors are overwritten
+	for (uint32_t i = 0; i < RECORDS; i++)
+	{
+		uint16_t size = privateRecord(buffer, written++);
+
+		if (MqttOutboxAppend(&outbox, buffer, size) != xResultAccept)
+		{
+			printf("FAIL: append %u\n", i);
+			return 1;
+		}
+	}
+
+	uint32_t read = outbox.Statistic.Dropped;
+
+	printf("%u records appended: %u stored, %u dropped\n", RECORDS, outbox.Count, outbox.Statistic.Dropped);
+
+	if (!outbox.Statistic.Dropped || outbox.Count + outbox.Statistic.Dropped != RECORDS)
+	{
+		printf("FAIL: overwrite of the oldest sector\n");
+		return 1;
+	}
+
+	//the replay peeks again after a publish that was not accepted: the record is still there
+	if (privatePeekNumber(&outbox) != (int)read || privatePeekNumber(&outbox) != (int)read)
+	{
+		printf("FAIL: the record is lost without a remove\n");
+		return 1;
+	}
+
+	for (uint8_t i = 0; i < 5; i++)
+	{
+		if (privatePeekNumber(&outbox) != (int)read++ || MqttOutboxRemove(&outbox) != xResultAccept)
+		{
+			printf("FAIL: order before the remount\n");
+			return 1;
+		}
+	}
+
+	//the records left from the previous run are restored
+	MqttOutboxT restored;
+
+	if (privateMount(&restored) != xResultAccept || restored.Count != outbox.Count)
+	{
+		printf("FAIL: remount, %u records of %u\n", restored.Count, outbox.Count);
+		return 1;
+	}
+
+	//a damaged payload fails the CRC and is skipped
+	if (privatePeekNumber(&restored) != (int)read)
+	{
+		printf("FAIL: order after the remount\n");
+		return 1;
+	}
+
+	privateMemory[restored.TailSector * SECTOR_SIZE + restored.TailOffset + sizeof(MqttOutboxRecordHeaderT)] = 0;
+	read++;
+
+	while ((number = privatePeekNumber(&restored)) >= 0)
+	{
+		if (number != (int)read++ || MqttOutboxRemove(&restored) != xResultAccept)
+		{
+			printf("FAIL: order after the remount, %d\n", number);
+			return 1;
+		}
+	}
+
+	if (read != written || restored.Statistic.Corrupted != 1)
+	{
+		printf("FAIL: %u of %u records read, %u corrupted\n", read, written, restored.Statistic.Corrupted);
+		return 1;
+	}
+
+	//long run over the wrap of the region, two appends per replayed record
+	for (uint32_t i = 0; i < WRAP_RECORDS; i++)
+	{
+		uint16_t size = privateRecord(buffer, written++);
+
+		MqttOutboxAppend(&restored, buffer, size);
+
+		if (i % 3 == 0 && privatePeekNumber(&restored) >= 0)
+		{
+			MqttOutboxRemove(&restored);
+		}
+	}
+
+	MqttOutboxT wrapped;
+
+	if (privateMount(&wrapped) != xResultAccept || wrapped.Count != restored.Count || privateFlash.ProgramErrors)
+	{
+		printf("FAIL: remount after the wrap\n");
+		return 1;
+	}
+
+	int previous = -1;
+
+	while ((number = privatePeekNumber(&wrapped)) >= 0)
+	{
+		if (previous >= 0 && number != (previous + 1) % 1000)
+		{
+			printf("FAIL: order after the wrap, %d after %d\n", number, previous);
+			return 1;
+		}
+
+		previous = number;
+		MqttOutboxRemove(&wrapped);
+	}
+
+	printf("wrap: %u erased sectors, write amplification %.2f\n",
+			privateFlash.ErasedSectors,
+			(double)restored.Statistic.ProgrammedBytes / restored.Statistic.PayloadBytes);
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
@@ -0,0 +1,265 @@
+//==============================================================================
+//includes:
+
+#include "MqttLinkSocket.h"
+#include "MqttClient/MqttClient-ComponentConfig.h"
+#include "MQTTClient.h"
+#include <stdio.h>
+#include <string.h>
+//==============================================================================
+//defines:
+
+#define LINK_LATENCY 20000 //us, one way
+#define LINK_RATE 1000000 //bit/s
+
+#define MESSAGES 1000
+#define PAYLOAD_SIZE 32
+#define BURST 8 //incoming publishes arriving together
+#define COMMAND_TIMEOUT 3000 //ms, MQTT_PORT_COMMAND_TIMEOUT
+#define READ_TIMEOUT 100 //ms, MQTT_PORT_READ_TIMEOUT
+#define HANDLER_PACKETS 8 //MQTT_PORT_HANDLER_PACKETS
+//==============================================================================
+//types:
+
+/// @brief calls of the FreeRTOS+TCP API per message x100
+typedef struct
+{
+	uint32_t Receives;
+	uint32_t Sends;
+	uint32_t Options;
+
+} BenchCallsT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	BenchCallsT Publish; //QoS1 publishes, MQTTPublish waits for PUBACK
+	BenchCallsT Incoming; //QoS0 publishes from the broker read by the handler of the port
+
+	bool IsComplete;
+
+} BenchResultT;
+//==============================================================================
+//prototypes:
+
+int cycle(MQTTClient* c, MQTTTimerT* timer);
+//==============================================================================
+//variables:
+
+static MQTTClient privateClient;
+static MQTTNetworkT privateNetwork;
+
+static unsigned char privateSendBuffer[MQTT_TX_BUFFER_SIZE];
+static unsigned char privateReadBuffer[MQTT_RX_BUFFER_SIZE];
+static unsigned char privateReadAhead[MQTT_READ_AHEAD_SIZE];
+
+static uint32_t privateReceived;
+//==============================================================================
+//functions:
+
+static void privateMessageHandler(MessageData* data)
+{
+	if (data->message->payloadlen == PAYLOAD_SIZE)
+	{
+		privateReceived++;
+	}
+}
+//------------------------------------------------------------------------------
+static MqttLinkSocketStatisticT privateCallsTake()
+{
+	return MqttLinkSocketStatistic;
+}
+//------------------------------------------------------------------------------
+static BenchCallsT privateCallsPerMessage(MqttLinkSocketStatisticT* start)
+{
+	BenchCallsT calls =
+	{
+		.Receives = (MqttLinkSocketStatistic.Receives - start->Receives) * 100 / MESSAGES,
+		.Sends = (MqttLinkSocketStatistic.Sends - start->Sends) * 100 / MESSAGES,
+		.Options = (MqttLinkSocketStatistic.Options - start->Options) * 100 / MESSAGES
+	};
+
+	return calls;
+}
+//------------------------------------------------------------------------------
+/// @brief as PrivateHandler of the Paho port: cycles while the network has bytes, a packet a cycle
+static bool privateHandler()
+{
+	uint8_t packets = 0;
+	int result;
+
+	do
+	{
+		uint32_t timeout = NetworkPending(&privateNetwork) > 0 ? READ_TIMEOUT : 0;
+
+		MQTTTimerT timer;
+		TimerInit(&timer);
+		TimerCountdownMS(&timer, timeout);
+
+		result = cycle(&privateClient, &timer);
+		packets++;
+	}
+	while (result >= 0 && packets < HANDLER_PACKETS && NetworkPending(&privateNetwork) > 0);
+
+	return result >= 0;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief Paho MQTTClient over MQTT-Interface.c and the socket of the link
+ * @param isReadAhead the bytes are received in bulk into MQTT_READ_AHEAD_SIZE, otherwise each read goes to the socket
+ */
+static BenchResultT privateRun(bool isReadAhead)
+{
+	BenchResultT result = { 0 };
+	MqttLinkInitT linkInit =
+	{
+		.Latency = LINK_LATENCY,
+		.Rate = LINK_RATE
+	};
+
+	MqttLinkSocketReset();
+
+	if (MqttLinkOpen(&linkInit) != xResultAccept)
+	{
+		return result;
+	}
+
+	NetworkInit(&privateNetwork);
+
+	if (isReadAhead)
+	{
+		NetworkSetReadAhead(&privateNetwork, privateReadAhead, sizeof(privateReadAhead));
+	}
+
+	MQTTClientInit(&privateClient, &privateNetwork, COMMAND_TIMEOUT,
+					privateSendBuffer, sizeof(privateSendBuffer),
+					privateReadBuffer, sizeof(privateReadBuffer));
+
+	MQTTPacket_connectData connectData = MQTTPacket_connectData_initializer;
+	connectData.MQTTVersion = 4;
+	connectData.clientID.cstring = "bench";
+	connectData.keepAliveInterval = 60;
+
+	if (NetworkConnect(&privateNetwork, "127.0.0.1", MQTT_BROKER_PORT) < 0
+		|| MQTTConnect(&privateClient, &connectData) != MQTT_RESULT_SUCCESS
+		|| MQTTSubscribe(&privateClient, "bench/rx", QOS0, privateMessageHandler) != MQTT_RESULT_SUCCESS)
+	{
+		return result;
+	}
+
+	uint8_t payload[PAYLOAD_SIZE] = { 0 };
+	MQTTMessage message = { 0 };
+	message.payload = payload;
+	message.payloadlen = sizeof(payload);
+
+	//the publishes of the port at QoS1
+	MqttLinkSocketStatisticT start = privateCallsTake();
+
+	message.qos = QOS1;
+
+	for (uint32_t i = 0; i < MESSAGES; i++)
+	{
+		if (MQTTPublish(&privateClient, "bench/tx", &message) != MQTT_RESULT_SUCCESS)
+		{
+			return result;
+		}
+	}
+
+	result.Publish = privateCallsPerMessage(&start);
+
+	//the commands and the bursts of the broker: the loop back of QoS0 publishes to the subscription,
+	//the sending side is not counted
+	uint32_t sends = 0;
+	uint32_t options = 0;
+
+	message.qos = QOS0;
+	privateReceived = 0;
+	start = privateCallsTake();
+
+	for (uint32_t i = 0; i < MESSAGES; i += BURST)
+	{
+		MqttLinkSocketStatisticT burst = privateCallsTake();
+
+		for (uint32_t j = 0; j < BURST; j++)
+		{
+			MQTTPublish(&privateClient, "bench/rx", &message);
+		}
+
+		sends += MqttLinkSocketStatistic.Sends - burst.Sends;
+		options += MqttLinkSocketStatistic.Options - burst.Options;
+
+		//the port task sleeps until the socket event
+		while (privateReceived < i + BURST)
+		{
+			if (!NetworkPending(&privateNetwork))
+			{
+				MqttLinkRunTo(MqttLinkGetArrivalTime(MqttLinkGetTime()));
+			}
+
+			if (!privateHandler())
+			{
+				return result;
+			}
+		}
+	}
+
+	start.Sends += sends;
+	start.Options += options;
+	result.Incoming = privateCallsPerMessage(&start);
+
+	result.IsComplete = privateReceived == MESSAGES && !MqttLinkBroker.Statistic.Errors;
+
+	return result;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	BenchResultT direct = privateRun(false);
+	BenchResultT readAhead = privateRun(true);
+
+	printf("Paho MQTTClient over MQTT-Interface.c, %u messages of %u bytes, FreeRTOS+TCP calls per message:\n",
+			MESSAGES, PAYLOAD_SIZE);
+
+	printf("publish qos1:   read ahead off: recv %u.%02u send %u.%02u setsockopt %u.%02u, on: recv %u.%02u send %u.%02u setsockopt %u.%02u\n",
+			direct.Publish.Receives / 100, direct.Publish.Receives % 100,
+			direct.Publish.Sends / 100, direct.Publish.Sends % 100,
+			direct.Publish.Options / 100, direct.Publish.Options % 100,
+			readAhead.Publish.Receives / 100, readAhead.Publish.Receives % 100,
+			readAhead.Publish.Sends / 100, readAhead.Publish.Sends % 100,
+			readAhead.Publish.Options / 100, readAhead.Publish.Options % 100);
+
+	printf("incoming qos0:  read ahead off: recv %u.%02u send %u.%02u setsockopt %u.%02u, on: recv %u.%02u send %u.%02u setsockopt %u.%02u\n",
+			direct.Incoming.Receives / 100, direct.Incoming.Receives % 100,
+			direct.Incoming.Sends / 100, direct.Incoming.Sends % 100,
+			direct.Incoming.Options / 100, direct.Incoming.Options % 100,
+			readAhead.Incoming.Receives / 100, readAhead.Incoming.Receives % 100,
+			readAhead.Incoming.Sends / 100, readAhead.Incoming.Sends % 100,
+			readAhead.Incoming.Options / 100, readAhead.Incoming.Options % 100);
+
+	if (!direct.IsComplete || !readAhead.IsComplete)
+	{
+		printf("FAIL: messages lost\n");
+		return 1;
+	}
+
+	//the timeouts are written on a change only: not per message
+	if (direct.Publish.Options > 10 || readAhead.Publish.Options > 10 || readAhead.Incoming.Options > 10)
+	{
+		printf("FAIL: setsockopt per message\n");
+		return 1;
+	}
+
+	//a packet is one send, the header decoded byte by byte doesn't go to the socket with the read ahead
+	if (readAhead.Publish.Sends > 100 || readAhead.Incoming.Receives >= direct.Incoming.Receives
+		|| readAhead.Incoming.Receives > 100)
+	{
+		printf("FAIL: socket calls per message\n");
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
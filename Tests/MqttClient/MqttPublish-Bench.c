@@ -0,0 +1,189 @@
+//==============================================================================
+//includes:
+
+#include "MqttLinkSocket.h"
+#include "MqttClient/Adapters/Ports/FreeRTOS-MQTT/MqttPort-Adapter.h"
+#include "TerminalCommands/TerminalCommands.h"
+#include <stdio.h>
+#include <string.h>
+//==============================================================================
+//defines:
+
+#define LINK_LATENCY 1000 //us, one way
+#define LINK_RATE 100000000 //bit/s
+
+#define PUBLISHES 20000
+#define PAYLOAD_MAX 480 //MQTT_PORT_PUBLISH_SIZE less the coalescing headroom
+#define WINDOW 4 //MQTT_PORT_IN_FLIGHT_WINDOW
+//==============================================================================
+//types:
+
+typedef struct
+{
+	uint32_t PublishedBytes;
+	uint64_t PublishCycles;
+	uint32_t Lost; //publishes the broker didn't take
+
+} BenchResultT;
+//==============================================================================
+//variables:
+
+static xPortT privatePort;
+static MqttPortAdapterT privateAdapter;
+
+static uint8_t privateMqttBuffer[1024];
+static uint8_t privateTxBuffer[512];
+static MQTTPubAckInfo_t privateOutgoing[WINDOW];
+static MQTTPubAckInfo_t privateIncoming[WINDOW];
+static MqttPortInFlightPublishT privateInFlight[WINDOW];
+static uint8_t privateInFlightMemory[WINDOW * PAYLOAD_MAX];
+
+static uint8_t privatePayload[PAYLOAD_MAX];
+//==============================================================================
+//functions:
+
+void TerminalCommandsReceive(xPortT* port, RxDataPacketT* packet)
+{
+
+}
+//------------------------------------------------------------------------------
+static bool privateOpen(MQTTQoS_t qos)
+{
+	MqttLinkInitT linkInit =
+	{
+		.Latency = LINK_LATENCY,
+		.Rate = LINK_RATE
+	};
+
+	MqttLinkSocketReset();
+
+	if (MqttLinkOpen(&linkInit) != xResultAccept)
+	{
+		return false;
+	}
+
+	MqttPortAdapterInitT init = { 0 };
+	init.TxTopic = "bench/publish";
+	init.RxTopic = "bench/command";
+	init.MqttBuffer = privateMqttBuffer;
+	init.MqttBufferSize = sizeof(privateMqttBuffer);
+	init.TxBuffer = privateTxBuffer;
+	init.TxBufferSize = sizeof(privateTxBuffer);
+
+	if (qos != MQTTQoS0)
+	{
+		init.OutgoingPublishRecords = privateOutgoing;
+		init.IncomingPublishRecords = privateIncoming;
+		init.InFlight = privateInFlight;
+		init.InFlightMemory = privateInFlightMemory;
+		init.InFlightPayloadSize = PAYLOAD_MAX;
+		init.InFlightWindow = WINDOW;
+	}
+
+	memset(&privateAdapter, 0, sizeof(privateAdapter));
+	privateAdapter.Id = "bench";
+	privateAdapter.QoS = qos;
+	privateAdapter.KeepAlive = 60;
+
+	if (MqttPortAdapterInit(&privatePort, &privateAdapter, &init) != xResultAccept)
+	{
+		return false;
+	}
+
+	xPortAdapterInterfaceT* interface = privatePort.Adapter.Interface;
+
+	interface->RequestListener(&privatePort, xPortAdapterRequestOpen, 0, NULL);
+	interface->RequestListener(&privatePort, xPortAdapterRequestConnect, 0, NULL);
+
+	return privatePort.IsConnected;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief MqttPortAdapterPublish of a record as a header and a body, the link and the acknowledges
+ * are run between the publishes: the statistic of the adapter counts the publish path only
+ */
+static BenchResultT privateRun(MQTTQoS_t qos, uint16_t size)
+{
+	BenchResultT result = { 0 };
+
+	if (!privateOpen(qos))
+	{
+		result.Lost = PUBLISHES;
+		return result;
+	}
+
+	MqttPortFragmentT fragments[] =
+	{
+		{ .Data = privatePayload, .Size = 16 },
+		{ .Data = privatePayload + 16, .Size = size - 16 }
+	};
+
+	for (uint32_t i = 0; i < PUBLISHES; i++)
+	{
+		MqttPortAdapterPublish(&privatePort, fragments, 2);
+
+		MqttLinkRunTo(MqttLinkGetTime() + LINK_LATENCY * 3);
+		privatePort.Adapter.Interface->Handler(&privatePort);
+	}
+
+	MqttPortStatisticT* statistic = &privateAdapter.Internal.Statistic;
+
+	result.PublishedBytes = statistic->PublishedBytes;
+	result.PublishCycles = statistic->PublishCycles;
+	result.Lost = PUBLISHES - MqttLinkBroker.Statistic.Publishes;
+
+	return result;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	const MQTTQoS_t qos[] = { MQTTQoS0, MQTTQoS1 };
+	const uint16_t sizes[] = { 64, 256, PAYLOAD_MAX };
+
+	for (uint16_t i = 0; i < sizeof(privatePayload); i++)
+	{
+		privatePayload[i] = i;
+	}
+
+	printf("MqttPortAdapterPublish, %u publishes of 2 fragments, DWT->CYCCNT is the CPU time of the host in ns:\n",
+			PUBLISHES);
+
+	for (uint8_t i = 0; i < sizeof(qos) / sizeof(qos[0]); i++)
+	{
+		for (uint8_t j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++)
+		{
+			BenchResultT result = privateRun(qos[i], sizes[j]);
+
+			if (result.Lost || result.PublishedBytes != PUBLISHES * sizes[j])
+			{
+				printf("FAIL: qos%u %u bytes, %u publishes lost\n", qos[i], sizes[j], result.Lost);
+				return 1;
+			}
+
+			//the statistic of the adapter: PublishCycles * 1024 / PublishedBytes - cycles per KB
+			uint64_t cyclesPerKb = result.PublishCycles * 1024 / result.PublishedBytes;
+			uint32_t truncated = (uint32_t)result.PublishCycles * 1024 / result.PublishedBytes;
+
+			printf("qos%u %3u bytes: %6llu ns/KB, %5llu ns/msg, %llu ns in total (32-bit product: %u ns/KB)\n",
+					qos[i],
+					sizes[j],
+					(unsigned long long)cyclesPerKb,
+					(unsigned long long)(result.PublishCycles / PUBLISHES),
+					(unsigned long long)result.PublishCycles,
+					truncated);
+
+			if (!cyclesPerKb)
+			{
+				printf("FAIL: qos%u %u bytes, no cycles counted\n", qos[i], sizes[j]);
+				return 1;
+			}
+		}
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
@@ -0,0 +1,185 @@
+//==============================================================================
+//includes:
+
+#include "MqttClient/Router/MqttRouter.h"
+#include "TerminalCommands/TerminalCommands.h"
+#include <stdio.h>
+#include <string.h>
+//==============================================================================
+//defines:
+
+#define ROUTES 150
+#define NODES 4000
+#define FILTER_SIZE 32
+//==============================================================================
+//variables:
+
+static const char* privateFilters[] =
+{
+	"a/b", "a/+", "a/#", "#", "+/b", "$SYS/#", "a/+/c", "a/b/", "+", "sport/tennis/#"
+};
+
+static const char* privateTopics[] =
+{
+	"a/b", "a", "$SYS/x", "a/x/c", "a/b/", "sport/tennis", "x", "dev/77/sensor/t", "dev/149/sensor/t",
+	"dev/77/sensor", "dev/77/sensor/t/x", "sport/tennis/player1/ranking", "/b", "a//c", "$SYS"
+};
+
+static MqttRouterNodeT privateNodes[NODES];
+static MqttRouteT privateRoutes[ROUTES + 1]; //and the terminal route
+static char privateNames[ROUTES][FILTER_SIZE];
+
+static uint32_t privateHits[ROUTES];
+static uint32_t privateTerminalPackets;
+static xPortT privatePort;
+//==============================================================================
+//functions:
+
+/// @brief the routes without a handler give the payload to the terminal of the port
+void TerminalCommandsReceive(xPortT* port, RxDataPacketT* packet)
+{
+	privateTerminalPackets += port == &privatePort;
+}
+//------------------------------------------------------------------------------
+static void privateHandler(void* context, const char* topic, uint16_t topicLength, uint8_t* payload, uint32_t size)
+{
+	privateHits[(intptr_t)context]++;
+}
+//------------------------------------------------------------------------------
+static const char* privateLevelEnd(const char* level)
+{
+	while (*level && *level != '/')
+	{
+		level++;
+	}
+
+	return level;
+}
+//------------------------------------------------------------------------------
+/// @brief MQTT 3.1.1 4.7 matching of one filter, level by level: the reference for the trie
+static bool privateIsMatch(const char* filter, const char* topic)
+{
+	if (topic[0] == '$' && (filter[0] == '+' || filter[0] == '#'))
+	{
+		return false;
+	}
+
+	while (true)
+	{
+		if (filter[0] == '#')
+		{
+			return true;
+		}
+
+		const char* filterEnd = privateLevelEnd(filter);
+		const char* topicEnd = privateLevelEnd(topic);
+
+		if (!(filter[0] == '+' && filterEnd - filter == 1)
+			&& (filterEnd - filter != topicEnd - topic || memcmp(filter, topic, filterEnd - filter)))
+		{
+			return false;
+		}
+
+		if (!*filterEnd || !*topicEnd)
+		{
+			//"a/#" takes "a" as well
+			return (!*filterEnd && !*topicEnd) || (!*topicEnd && !strcmp(filterEnd, "/#"));
+		}
+
+		filter = filterEnd + 1;
+		topic = topicEnd + 1;
+	}
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	MqttRouterT router;
+	MqttRouterInitT init =
+	{
+		.Nodes = privateNodes,
+		.NodesSize = NODES,
+		.Routes = privateRoutes,
+		.RoutesSize = ROUTES + 1
+	};
+
+	MqttRouterInit(&router, &init);
+
+	const uint8_t filtersCount = sizeof(privateFilters) / sizeof(privateFilters[0]);
+
+	for (uint8_t i = 0; i < ROUTES; i++)
+	{
+		if (i < filtersCount)
+		{
+			strcpy(privateNames[i], privateFilters[i]);
+		}
+		else
+		{
+			sprintf(privateNames[i], "dev/%u/sensor/+", i);
+		}
+
+		if (MqttRouterAdd(&router, privateNames[i], privateHandler, (void*)(intptr_t)i, NULL) != xResultAccept)
+		{
+			printf("FAIL: add %s\n", privateNames[i]);
+			return 1;
+		}
+	}
+
+	if (MqttRouterAdd(&router, "a/b#", privateHandler, NULL, NULL) == xResultAccept
+		|| MqttRouterAdd(&router, "a/#/c", privateHandler, NULL, NULL) == xResultAccept
+		|| MqttRouterAdd(&router, "a/b", privateHandler, NULL, NULL) == xResultAccept)
+	{
+		printf("FAIL: an invalid or a repeated filter is accepted\n");
+		return 1;
+	}
+
+	printf("%u filters, %u trie nodes\n", ROUTES, router.NodesCount);
+
+	for (uint8_t i = 0; i < sizeof(privateTopics) / sizeof(privateTopics[0]); i++)
+	{
+		const char* topic = privateTopics[i];
+
+		memset(privateHits, 0, sizeof(privateHits));
+
+		uint8_t matches = MqttRouterDispatch(&router, topic, strlen(topic), NULL, 0);
+		uint8_t expected = 0;
+
+		for (uint8_t route = 0; route < ROUTES; route++)
+		{
+			bool isMatch = privateIsMatch(privateNames[route], topic);
+
+			expected += isMatch;
+
+			if (privateHits[route] != isMatch)
+			{
+				printf("FAIL: %s by %s: %u calls\n", topic, privateNames[route], privateHits[route]);
+				return 1;
+			}
+		}
+
+		//the trie walks the levels of the topic, a list of the filters would compare all of them
+		printf("%-30s %u matches, %3u nodes visited\n", topic, matches, router.Statistic.VisitedNodes);
+
+		if (matches != expected || router.Statistic.VisitedNodes > ROUTES / 2)
+		{
+			printf("FAIL: %s\n", topic);
+			return 1;
+		}
+	}
+
+	//the payload of a route without a handler goes to the terminal of its port
+	MqttRouterAdd(&router, "terminal/in", NULL, NULL, &privatePort);
+	MqttRouterDispatch(&router, "terminal/in", 11, (uint8_t*)"help", 4);
+
+	if (privateTerminalPackets != 1)
+	{
+		printf("FAIL: terminal route\n");
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
@@ -0,0 +1,126 @@
+//==============================================================================
+//includes:
+
+#include "MqttClient/Tls/MqttTlsBench.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+//==============================================================================
+//defines:
+
+#define BENCH_BYTES (1024 * 1024) //per cipher and record size
+#define RECORD_SIZE_MAX 1024
+//==============================================================================
+//variables:
+
+static uint8_t privateData[RECORD_SIZE_MAX];
+static uint8_t privatePlain[RECORD_SIZE_MAX];
+//==============================================================================
+//functions:
+
+/// @brief CUSTOM_RAND_GENERATE_SEED of the settings, hrng on the board: aes.c links the RNG of the GCM nonces
+int MqttTlsGenerateSeed(unsigned char* output, unsigned int size)
+{
+	FILE* source = fopen("/dev/urandom", "rb");
+	size_t read = source ? fread(output, 1, size, source) : 0;
+
+	if (source)
+	{
+		fclose(source);
+	}
+
+	return read == size ? 0 : -1;
+}
+//------------------------------------------------------------------------------
+static uint64_t privateGetTime()
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+//------------------------------------------------------------------------------
+/// @brief the record is sealed and opened back, a changed byte fails the tag
+static bool privateCheck(MqttTlsBenchCipherT cipher, uint32_t size)
+{
+	for (uint32_t i = 0; i < size; i++)
+	{
+		privatePlain[i] = i * 7 + cipher;
+	}
+
+	memcpy(privateData, privatePlain, size);
+
+	if (MqttTlsBenchSeal(cipher, privateData, size, 1) != xResultAccept
+		|| !memcmp(privateData, privatePlain, size)
+		|| MqttTlsBenchOpen(cipher, privateData, size) != xResultAccept
+		|| memcmp(privateData, privatePlain, size))
+	{
+		return false;
+	}
+
+	MqttTlsBenchSeal(cipher, privateData, size, 1);
+	privateData[size / 2] ^= 1;
+
+	return MqttTlsBenchOpen(cipher, privateData, size) == xResultError;
+}
+//------------------------------------------------------------------------------
+/// @return KB/s of the sealing, 0 - failed
+static uint32_t privateRun(MqttTlsBenchCipherT cipher, uint32_t size)
+{
+	uint32_t count = BENCH_BYTES / size;
+	uint64_t start = privateGetTime();
+
+	if (MqttTlsBenchSeal(cipher, privateData, size, count) != xResultAccept)
+	{
+		return 0;
+	}
+
+	uint64_t elapsed = privateGetTime() - start;
+
+	return (uint64_t)size * count * 1000000000 / 1024 / (elapsed ? elapsed : 1);
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	const uint32_t sizes[] = { 64, 256, 1024 };
+
+	printf("TLS 1.2 record ciphers of MQTT_TLS_CIPHER_LIST, host build of the target settings (on the board: mqtt-tls-bench)\n");
+
+	for (uint8_t cipher = 0; cipher < MqttTlsBenchCiphersCount; cipher++)
+	{
+		if (!privateCheck(cipher, sizeof(privateData)) || !privateCheck(cipher, 13))
+		{
+			printf("FAIL: %s doesn't open its records\n", MqttTlsBenchCipherNames[cipher]);
+			return 1;
+		}
+	}
+
+	for (uint8_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+	{
+		uint32_t rates[MqttTlsBenchCiphersCount];
+
+		for (uint8_t cipher = 0; cipher < MqttTlsBenchCiphersCount; cipher++)
+		{
+			rates[cipher] = privateRun(cipher, sizes[i]);
+
+			if (!rates[cipher])
+			{
+				printf("FAIL: %s\n", MqttTlsBenchCipherNames[cipher]);
+				return 1;
+			}
+		}
+
+		printf("record %4u bytes: %s %6u KB/s, %s %6u KB/s\n",
+				sizes[i],
+				MqttTlsBenchCipherNames[MqttTlsBenchAes128Gcm], rates[MqttTlsBenchAes128Gcm],
+				MqttTlsBenchCipherNames[MqttTlsBenchChaCha20Poly1305], rates[MqttTlsBenchChaCha20Poly1305]);
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
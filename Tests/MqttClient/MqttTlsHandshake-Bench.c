@@ -0,0 +1,556 @@
+//==============================================================================
+//includes:
+
+#include "MqttClient/MqttClient-ComponentConfig.h"
+#include "MqttClient/Tls/MqttTls.h"
+#include "wolfssl/error-ssl.h"
+#define USE_CERT_BUFFERS_256
+#define USE_CERT_BUFFERS_2048
+#include "wolfssl/certs_test.h"
+#include "rng.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+//==============================================================================
+//defines:
+
+#define CLIENT_STACK_SIZE (64 * 1024) //painted, the handshake of the MQTT task runs on it
+#define STACK_PAINT 0xa5
+#define SERVER_MEMORY_SIZE (256 * 1024)
+
+#define FULL_HANDSHAKES 5
+#define RESUMED_HANDSHAKES 5
+
+#define TIME_VALID 1685577600 //2023-06-01, the test certificates of wolfSSL are valid from 2022-02-15 to 2024-11-11
+#define TIME_EXPIRED 1735689600 //2025-01-01
+
+#define PEM_SIZE 2048
+//==============================================================================
+//types:
+
+/// @brief a suite of MQTT_TLS_CIPHER_LIST and the server certificate it is authenticated by
+typedef struct
+{
+	const char* CipherList;
+	const char* ServerName;
+	bool IsRsa;
+
+} BenchSuiteT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t FullTime; //us of the client CPU, average
+	uint32_t ResumedTime;
+	uint32_t Resumed; //handshakes the server accepted the ticket or the session id for
+
+	uint32_t StackUsed; //bytes, high-water mark of the client
+	uint32_t PeakMemory; //bytes of the pool, the connection peak tracked by wolfSSL
+	uint32_t MemoryTouched; //bytes of the pool written at least once, the context included
+
+	bool IsComplete;
+
+} BenchResultT;
+//------------------------------------------------------------------------------
+/// @brief the socket of the stubs is the client end of the socket pair here
+struct MqttLinkSocketT
+{
+	int Descriptor;
+};
+//==============================================================================
+//variables:
+
+RNG_HandleTypeDef hrng;
+
+static const BenchSuiteT privateSuites[] =
+{
+	{ "ECDHE-ECDSA-AES128-GCM-SHA256", "www.wolfssl.com", false },
+	{ "ECDHE-ECDSA-CHACHA20-POLY1305", "www.wolfssl.com", false },
+	{ "ECDHE-RSA-AES128-GCM-SHA256", "127.0.0.1", true },
+	{ "ECDHE-RSA-CHACHA20-POLY1305", "127.0.0.1", true }
+};
+
+static uint8_t privateClientMemory[MQTT_TLS_MEMORY_SIZE];
+static uint8_t privateServerMemory[2][SERVER_MEMORY_SIZE];
+static WOLFSSL_CTX* privateServerContexts[2];
+static char privatePemEcc[PEM_SIZE];
+static char privatePemRsa[PEM_SIZE];
+
+static uint8_t privateClientStack[CLIENT_STACK_SIZE];
+static ucontext_t privateMainContext;
+static ucontext_t privateClientContext;
+static bool privateClientIsDone;
+
+static MqttTlsT privateTls;
+static struct MqttLinkSocketT privateSocket;
+static xResult privateConnectResult;
+
+static uint32_t privateTime; //returned to MqttTls, 0 - not synchronized
+//==============================================================================
+//functions:
+
+uint32_t xSystemGetTime()
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return time.tv_sec * 1000 + time.tv_nsec / 1000000;
+}
+//------------------------------------------------------------------------------
+HAL_StatusTypeDef HAL_RNG_GenerateRandomNumber(RNG_HandleTypeDef* handle, uint32_t* value)
+{
+	FILE* source = fopen("/dev/urandom", "rb");
+	size_t read = source ? fread(value, sizeof(uint32_t), 1, source) : 0;
+
+	if (source)
+	{
+		fclose(source);
+	}
+
+	return read == 1 ? HAL_OK : HAL_ERROR;
+}
+//------------------------------------------------------------------------------
+uint32_t FreeRTOS_inet_addr(const char* address)
+{
+	struct in_addr value;
+
+	return inet_pton(AF_INET, address, &value) == 1 ? value.s_addr : 0;
+}
+//------------------------------------------------------------------------------
+static uint64_t privateGetCpuTime()
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+
+	return (uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+//------------------------------------------------------------------------------
+BaseType_t FreeRTOS_recv(Socket_t socket, void* buffer, size_t length, BaseType_t flags)
+{
+	ssize_t result = recv(socket->Descriptor, buffer, length, MSG_DONTWAIT);
+
+	if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+	{
+		//the client waits for the socket: the server takes its turn
+		swapcontext(&privateClientContext, &privateMainContext);
+
+		result = recv(socket->Descriptor, buffer, length, MSG_DONTWAIT);
+	}
+
+	if (result > 0)
+	{
+		return result;
+	}
+
+	//the receive timeout of FreeRTOS+TCP
+	if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+	{
+		return 0;
+	}
+
+	return -pdFREERTOS_ERRNO_ENOTCONN;
+}
+//------------------------------------------------------------------------------
+BaseType_t FreeRTOS_send(Socket_t socket, const void* buffer, size_t length, BaseType_t flags)
+{
+	ssize_t result = send(socket->Descriptor, buffer, length, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+	if (result >= 0)
+	{
+		return result;
+	}
+
+	return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -pdFREERTOS_ERRNO_ENOTCONN;
+}
+//------------------------------------------------------------------------------
+static int privateServerReceive(WOLFSSL* ssl, char* data, int size, void* context)
+{
+	ssize_t result = recv(*(int*)context, data, size, MSG_DONTWAIT);
+
+	if (result > 0)
+	{
+		return result;
+	}
+
+	if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+	{
+		return WOLFSSL_CBIO_ERR_WANT_READ;
+	}
+
+	return WOLFSSL_CBIO_ERR_CONN_CLOSE;
+}
+//------------------------------------------------------------------------------
+static int privateServerSend(WOLFSSL* ssl, char* data, int size, void* context)
+{
+	ssize_t result = send(*(int*)context, data, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+
+	if (result >= 0)
+	{
+		return result;
+	}
+
+	return errno == EAGAIN || errno == EWOULDBLOCK ? WOLFSSL_CBIO_ERR_WANT_WRITE : WOLFSSL_CBIO_ERR_CONN_CLOSE;
+}
+//------------------------------------------------------------------------------
+static uint32_t privateGetTime()
+{
+	return privateTime;
+}
+//------------------------------------------------------------------------------
+/// @brief MQTT_TLS_CA_CERTIFICATE is PEM: the DER of certs_test.h is wrapped
+static void privatePem(const uint8_t* der, uint32_t size, char* pem)
+{
+	const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	uint32_t length = 0;
+
+	pem += sprintf(pem, "-----BEGIN CERTIFICATE-----\n");
+
+	for (uint32_t i = 0; i < size; i += 3)
+	{
+		uint32_t value = der[i] << 16;
+
+		value |= i + 1 < size ? der[i + 1] << 8 : 0;
+		value |= i + 2 < size ? der[i + 2] : 0;
+
+		*pem++ = alphabet[(value >> 18) & 0x3f];
+		*pem++ = alphabet[(value >> 12) & 0x3f];
+		*pem++ = i + 1 < size ? alphabet[(value >> 6) & 0x3f] : '=';
+		*pem++ = i + 2 < size ? alphabet[value & 0x3f] : '=';
+
+		length += 4;
+
+		if (length % 64 == 0)
+		{
+			*pem++ = '\n';
+		}
+	}
+
+	if (length % 64)
+	{
+		*pem++ = '\n';
+	}
+
+	sprintf(pem, "-----END CERTIFICATE-----\n");
+}
+//------------------------------------------------------------------------------
+static WOLFSSL_CTX* privateServerOpen(uint8_t* memory, const uint8_t* certificate, uint32_t certificateSize,
+										const uint8_t* key, uint32_t keySize)
+{
+	WOLFSSL_CTX* context = NULL;
+
+	if (wolfSSL_CTX_load_static_memory(&context, wolfTLSv1_2_server_method_ex, memory, SERVER_MEMORY_SIZE,
+										WOLFMEM_GENERAL, 1) != WOLFSSL_SUCCESS
+		|| wolfSSL_CTX_use_certificate_buffer(context, certificate, certificateSize, WOLFSSL_FILETYPE_ASN1) != WOLFSSL_SUCCESS
+		|| wolfSSL_CTX_use_PrivateKey_buffer(context, key, keySize, WOLFSSL_FILETYPE_ASN1) != WOLFSSL_SUCCESS)
+	{
+		return NULL;
+	}
+
+	wolfSSL_CTX_SetIORecv(context, privateServerReceive);
+	wolfSSL_CTX_SetIOSend(context, privateServerSend);
+
+	return context;
+}
+//------------------------------------------------------------------------------
+/// @brief the MQTT task: the handshake and the close keeping the session for the next connection
+static void privateClientRun()
+{
+	privateConnectResult = MqttTlsConnect(&privateTls, &privateSocket, MQTT_PORT_TLS_HANDSHAKE_TIMEOUT);
+
+	if (privateConnectResult == xResultAccept)
+	{
+		MqttTlsClose(&privateTls);
+	}
+
+	privateClientIsDone = true;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief one connection: the client runs on the painted stack until it waits for the socket,
+ * then the server is stepped on the stack of main
+ * @return us of the client CPU
+ */
+static uint32_t privateHandshake(WOLFSSL_CTX* serverContext)
+{
+	int descriptors[2];
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, descriptors))
+	{
+		privateConnectResult = xResultError;
+		return 0;
+	}
+
+	privateSocket.Descriptor = descriptors[0];
+
+	WOLFSSL* server = wolfSSL_new(serverContext);
+
+	if (server)
+	{
+		wolfSSL_SetIOReadCtx(server, &descriptors[1]);
+		wolfSSL_SetIOWriteCtx(server, &descriptors[1]);
+	}
+
+	getcontext(&privateClientContext);
+	privateClientContext.uc_stack.ss_sp = privateClientStack;
+	privateClientContext.uc_stack.ss_size = sizeof(privateClientStack);
+	privateClientContext.uc_link = &privateMainContext;
+	makecontext(&privateClientContext, privateClientRun, 0);
+
+	privateClientIsDone = false;
+
+	uint64_t clientTime = 0;
+
+	while (true)
+	{
+		uint64_t start = privateGetCpuTime();
+
+		swapcontext(&privateMainContext, &privateClientContext);
+
+		//the client runs until it waits for the socket or is done, the server is not counted
+		clientTime += privateGetCpuTime() - start;
+
+		if (privateClientIsDone || !server)
+		{
+			break;
+		}
+
+		if (!wolfSSL_is_init_finished(server))
+		{
+			wolfSSL_accept(server);
+		}
+		else
+		{
+			uint8_t data[64];
+
+			//close_notify of the client
+			wolfSSL_read(server, data, sizeof(data));
+		}
+	}
+
+	if (server)
+	{
+		wolfSSL_free(server);
+	}
+
+	close(descriptors[0]);
+	close(descriptors[1]);
+
+	return clientTime / 1000;
+}
+//------------------------------------------------------------------------------
+static uint32_t privateStackUsed()
+{
+	uint32_t untouched = 0;
+
+	while (untouched < sizeof(privateClientStack) && privateClientStack[untouched] == STACK_PAINT)
+	{
+		untouched++;
+	}
+
+	return sizeof(privateClientStack) - untouched;
+}
+//------------------------------------------------------------------------------
+static uint32_t privateMemoryTouched()
+{
+	uint32_t touched = 0;
+
+	for (uint32_t i = 0; i < sizeof(privateClientMemory); i++)
+	{
+		touched += privateClientMemory[i] != STACK_PAINT;
+	}
+
+	return touched;
+}
+//------------------------------------------------------------------------------
+/// @brief MqttTls over the painted pool, the CA of the server certificate
+static bool privateClientOpen(const BenchSuiteT* suite)
+{
+	memset(privateClientMemory, STACK_PAINT, sizeof(privateClientMemory));
+	memset(privateClientStack, STACK_PAINT, sizeof(privateClientStack));
+
+	MqttTlsInitT init = { 0 };
+	init.Memory = privateClientMemory;
+	init.MemorySize = sizeof(privateClientMemory);
+	init.CaCertificate = suite->IsRsa ? privatePemRsa : privatePemEcc;
+	init.ServerName = suite->ServerName;
+	init.CipherList = suite->CipherList;
+	init.GetTime = privateGetTime;
+
+	return MqttTlsInit(&privateTls, &init) == xResultAccept;
+}
+//------------------------------------------------------------------------------
+static BenchResultT privateRun(const BenchSuiteT* suite)
+{
+	BenchResultT result = { 0 };
+	WOLFSSL_CTX* server = privateServerContexts[suite->IsRsa];
+
+	privateTime = TIME_VALID;
+
+	if (!privateClientOpen(suite))
+	{
+		return result;
+	}
+
+	uint64_t fullTime = 0;
+	uint64_t resumedTime = 0;
+
+	for (uint32_t i = 0; i < FULL_HANDSHAKES; i++)
+	{
+		//no session to offer: the full handshake
+		if (privateTls.Resumption)
+		{
+			wolfSSL_SESSION_free(privateTls.Resumption);
+			privateTls.Resumption = NULL;
+		}
+
+		fullTime += privateHandshake(server);
+
+		if (privateConnectResult != xResultAccept)
+		{
+			return result;
+		}
+	}
+
+	//the handshakes above didn't offer a session
+	if (privateTls.Statistic.ResumedHandshakes)
+	{
+		return result;
+	}
+
+	for (uint32_t i = 0; i < RESUMED_HANDSHAKES; i++)
+	{
+		resumedTime += privateHandshake(server);
+
+		if (privateConnectResult != xResultAccept)
+		{
+			return result;
+		}
+	}
+
+	result.FullTime = fullTime / FULL_HANDSHAKES;
+	result.ResumedTime = resumedTime / RESUMED_HANDSHAKES;
+	result.Resumed = privateTls.Statistic.ResumedHandshakes;
+	result.StackUsed = privateStackUsed();
+	result.PeakMemory = privateTls.Statistic.PeakMemory;
+	result.MemoryTouched = privateMemoryTouched();
+	result.IsComplete = true;
+
+	return result;
+}
+//------------------------------------------------------------------------------
+/// @return the error of the refused handshake, 0 - accepted
+static int privateRefused(const BenchSuiteT* suite, const char* serverName, uint32_t time)
+{
+	BenchSuiteT refused = *suite;
+
+	refused.ServerName = serverName;
+
+	//the init of the board runs before SNTP
+	privateTime = time;
+
+	if (!privateClientOpen(&refused))
+	{
+		return -1;
+	}
+
+	privateHandshake(privateServerContexts[suite->IsRsa]);
+
+	return privateConnectResult == xResultAccept ? 0 : privateTls.Statistic.LastError ? privateTls.Statistic.LastError : -1;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	privatePem(ca_ecc_cert_der_256, sizeof_ca_ecc_cert_der_256, privatePemEcc);
+	privatePem(ca_cert_der_2048, sizeof_ca_cert_der_2048, privatePemRsa);
+
+	wolfSSL_Init();
+
+	privateServerContexts[false] = privateServerOpen(privateServerMemory[0],
+														serv_ecc_der_256, sizeof_serv_ecc_der_256,
+														ecc_key_der_256, sizeof_ecc_key_der_256);
+	privateServerContexts[true] = privateServerOpen(privateServerMemory[1],
+														server_cert_der_2048, sizeof_server_cert_der_2048,
+														server_key_der_2048, sizeof_server_key_der_2048);
+
+	if (!privateServerContexts[false] || !privateServerContexts[true])
+	{
+		printf("FAIL: server\n");
+		return 1;
+	}
+
+	printf("MqttTls handshakes with a wolfSSL server over a socket pair, host build of the target settings:\n");
+	printf("us of the client CPU, the stack of the client and its pool of %u bytes\n", MQTT_TLS_MEMORY_SIZE);
+
+	uint32_t stackMax = 0;
+
+	for (uint8_t i = 0; i < sizeof(privateSuites) / sizeof(privateSuites[0]); i++)
+	{
+		const BenchSuiteT* suite = &privateSuites[i];
+		BenchResultT result = privateRun(suite);
+
+		printf("%-30s full %6u us, resumed %5u us (%u of %u), stack %5u B, pool peak %5u B, pool touched %5u B\n",
+				suite->CipherList,
+				result.FullTime,
+				result.ResumedTime,
+				result.Resumed,
+				RESUMED_HANDSHAKES,
+				result.StackUsed,
+				result.PeakMemory,
+				result.MemoryTouched);
+
+		if (!result.IsComplete)
+		{
+			printf("FAIL: %s handshake, error %d\n", suite->CipherList, privateTls.Statistic.LastError);
+			return 1;
+		}
+
+		if (result.Resumed != RESUMED_HANDSHAKES || result.ResumedTime >= result.FullTime)
+		{
+			printf("FAIL: %s session is not resumed\n", suite->CipherList);
+			return 1;
+		}
+
+		if (result.StackUsed > stackMax)
+		{
+			stackMax = result.StackUsed;
+		}
+	}
+
+	//the stack of the MQTT task is given in words of the target
+	printf("deepest handshake stack %u B, MQTT_TASK_STACK_SIZE %u B\n", stackMax, MQTT_TASK_STACK_SIZE * 4);
+
+	if (stackMax >= MQTT_TASK_STACK_SIZE * 4)
+	{
+		printf("FAIL: the handshake doesn't fit MQTT_TASK_STACK_SIZE\n");
+		return 1;
+	}
+
+	//the checks of the broker certificate
+	int unsynchronized = privateRefused(&privateSuites[0], privateSuites[0].ServerName, 0);
+	int expired = privateRefused(&privateSuites[0], privateSuites[0].ServerName, TIME_EXPIRED);
+	int otherName = privateRefused(&privateSuites[0], "broker.example.com", TIME_VALID);
+	int otherAddress = privateRefused(&privateSuites[2], "10.0.0.1", TIME_VALID);
+
+	printf("refused: time not synchronized %d, expired %d, other name %d, other address %d\n",
+			unsynchronized, expired, otherName, otherAddress);
+
+	if (!unsynchronized || expired != ASN_AFTER_DATE_E
+		|| otherName != DOMAIN_NAME_MISMATCH || otherAddress != DOMAIN_NAME_MISMATCH)
+	{
+		printf("FAIL: the broker certificate is not checked\n");
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
@@ -0,0 +1,198 @@
+//==============================================================================
+//includes:
+
+#include "MqttLinkSocket.h"
+#include "MqttClient/Adapters/Ports/FreeRTOS-MQTT/MqttPort-Adapter.h"
+#include "TerminalCommands/TerminalCommands.h"
+#include <stdio.h>
+#include <string.h>
+//==============================================================================
+//defines:
+
+#define LINK_LATENCY 20000 //us, one way
+#define LINK_RATE 1000000 //bit/s
+
+#define PUBLISHES 200
+#define PAYLOAD_SIZE 64
+#define WINDOW_MAX 16
+#define TASK_MAX_WAIT_TIME 1000 //ms, MQTT_TASK_MAX_WAIT_TIME
+//==============================================================================
+//types:
+
+typedef struct
+{
+	uint32_t Rate; //msg/s, 0 - failed
+	uint32_t WindowIsFull;
+	uint32_t Receives; //FreeRTOS_recv calls
+	uint32_t Waits; //sleeps of the publishing task on the event semaphore
+
+} BenchResultT;
+//==============================================================================
+//variables:
+
+static xPortT privatePort;
+static MqttPortAdapterT privateAdapter;
+
+static uint8_t privateMqttBuffer[1024];
+static uint8_t privateTxBuffer[512];
+static MQTTPubAckInfo_t privateOutgoing[WINDOW_MAX];
+static MQTTPubAckInfo_t privateIncoming[WINDOW_MAX];
+static MqttPortInFlightPublishT privateInFlight[WINDOW_MAX];
+static uint8_t privateInFlightMemory[WINDOW_MAX * PAYLOAD_SIZE];
+//==============================================================================
+//functions:
+
+void TerminalCommandsReceive(xPortT* port, RxDataPacketT* packet)
+{
+
+}
+//------------------------------------------------------------------------------
+/// @brief the port of MqttClient-Component over the link: QoS1, the window of the run
+static bool privateOpen(uint8_t window)
+{
+	MqttLinkInitT linkInit =
+	{
+		.Latency = LINK_LATENCY,
+		.Rate = LINK_RATE
+	};
+
+	MqttLinkSocketReset();
+
+	if (MqttLinkOpen(&linkInit) != xResultAccept)
+	{
+		return false;
+	}
+
+	MqttPortAdapterInitT init = { 0 };
+	init.TxTopic = "bench/window";
+	init.RxTopic = "bench/command";
+	init.MqttBuffer = privateMqttBuffer;
+	init.MqttBufferSize = sizeof(privateMqttBuffer);
+	init.TxBuffer = privateTxBuffer;
+	init.TxBufferSize = sizeof(privateTxBuffer);
+	init.OutgoingPublishRecords = privateOutgoing;
+	init.IncomingPublishRecords = privateIncoming;
+	init.InFlight = privateInFlight;
+	init.InFlightMemory = privateInFlightMemory;
+	init.InFlightPayloadSize = PAYLOAD_SIZE;
+	init.InFlightWindow = window;
+
+	memset(&privateAdapter, 0, sizeof(privateAdapter));
+	privateAdapter.Id = "bench";
+	privateAdapter.QoS = MQTTQoS1;
+	privateAdapter.KeepAlive = 60;
+
+	if (MqttPortAdapterInit(&privatePort, &privateAdapter, &init) != xResultAccept)
+	{
+		return false;
+	}
+
+	xPortAdapterInterfaceT* interface = privatePort.Adapter.Interface;
+
+	interface->RequestListener(&privatePort, xPortAdapterRequestOpen, 0, NULL);
+	interface->RequestListener(&privatePort, xPortAdapterRequestConnect, 0, NULL);
+
+	return privatePort.IsConnected;
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief a task transmits to the port back to back: the publish takes a slot of the window,
+ * on a full window the task sleeps in the adapter until PUBACK frees one. The port task takes the rest
+ */
+static BenchResultT privateRun(uint8_t window)
+{
+	BenchResultT result = { 0 };
+
+	if (!privateOpen(window))
+	{
+		return result;
+	}
+
+	uint8_t payload[PAYLOAD_SIZE] = { 0 };
+	uint64_t start = MqttLinkGetTime();
+	uint32_t receives = MqttLinkSocketStatistic.Receives;
+	uint32_t waits = MqttLinkSocketStatistic.Waits;
+
+	for (uint32_t i = 0; i < PUBLISHES; i++)
+	{
+		xPortStartTransmission(&privatePort);
+		xPortTransmitData(&privatePort, payload, sizeof(payload));
+		xPortEndTransmission(&privatePort);
+	}
+
+	result.Receives = MqttLinkSocketStatistic.Receives - receives;
+	result.Waits = MqttLinkSocketStatistic.Waits - waits;
+
+	MqttPortStatisticT* statistic = &privateAdapter.Internal.Statistic;
+	uint64_t end = MqttLinkGetTime() + 10 * 1000000ull;
+
+	while (MqttLinkGetTime() < end)
+	{
+		privatePort.Adapter.Interface->Handler(&privatePort);
+
+		if (statistic->Acknowledged == statistic->Published)
+		{
+			break;
+		}
+
+		MqttPortAdapterWaitEvent(&privatePort, TASK_MAX_WAIT_TIME);
+	}
+
+	if (statistic->Published != PUBLISHES
+		|| statistic->Acknowledged != PUBLISHES
+		|| MqttLinkBroker.Statistic.Publishes != PUBLISHES
+		|| MqttLinkBroker.Statistic.Errors)
+	{
+		return result;
+	}
+
+	result.Rate = (uint64_t)PUBLISHES * 1000000 / (MqttLinkGetTime() - start);
+	result.WindowIsFull = statistic->WindowIsFull;
+
+	return result;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	const uint8_t windows[] = { 1, 4, 16 };
+	BenchResultT results[sizeof(windows)];
+
+	printf("QoS1 through the port adapter, %u transmissions of %u bytes, one way %u us, %u bit/s\n",
+			PUBLISHES, PAYLOAD_SIZE, LINK_LATENCY, LINK_RATE);
+
+	for (uint8_t i = 0; i < sizeof(windows); i++)
+	{
+		results[i] = privateRun(windows[i]);
+
+		printf("window %2u: %5u msg/s, window full %3u times, %.2f receive calls and %.2f sleeps per publish\n",
+				windows[i], results[i].Rate, results[i].WindowIsFull,
+				(double)results[i].Receives / PUBLISHES, (double)results[i].Waits / PUBLISHES);
+
+		if (!results[i].Rate)
+		{
+			printf("FAIL: window %u\n", windows[i]);
+			return 1;
+		}
+
+		//the publishing task sleeps on the socket events: a few passes per PUBACK, not a poll of the socket
+		if (results[i].Receives > PUBLISHES * 4 || results[i].Waits > PUBLISHES)
+		{
+			printf("FAIL: window %u, the task polls the socket while the window is full\n", windows[i]);
+			return 1;
+		}
+	}
+
+	//a window of N keeps N publishes on the round trip until the rate of the link limits it
+	if (results[1].Rate < results[0].Rate * 3 || results[2].Rate < results[1].Rate * 3)
+	{
+		printf("FAIL: the window doesn't scale\n");
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
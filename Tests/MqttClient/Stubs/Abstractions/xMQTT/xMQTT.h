@@ -0,0 +1,10 @@
+//==============================================================================
+//header:
+
+#ifndef _X_MQTT_H_
+#define _X_MQTT_H_
+//------------------------------------------------------------------------------
+//included by the MQTT port adapter, nothing of it is used
+#include "Components-Types.h"
+//------------------------------------------------------------------------------
+#endif //_X_MQTT_H_
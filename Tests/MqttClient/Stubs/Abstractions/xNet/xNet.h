@@ -0,0 +1,36 @@
+//==============================================================================
+//header:
+
+#ifndef _X_NET_H_
+#define _X_NET_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+//==============================================================================
+//types:
+
+/// @brief the part of xLibs/Abstractions/xNet/xNet.h used by the MQTT port adapter
+typedef union
+{
+	struct
+	{
+		uint8_t Octet1;
+		uint8_t Octet2;
+		uint8_t Octet3;
+		uint8_t Octet4;
+	};
+
+	uint32_t Value;
+
+} xNetAddressT;
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_X_NET_H_
@@ -0,0 +1,61 @@
+//==============================================================================
+//header:
+
+#ifndef _X_DATA_BUFFER_H_
+#define _X_DATA_BUFFER_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include <string.h>
+#include "Components-Types.h"
+//==============================================================================
+//types:
+
+/// @brief the part of xLibs/Common/xDataBuffer.h used by the MQTT port adapter
+typedef struct
+{
+	union
+	{
+		uint8_t* Memory;
+		uint8_t* Data;
+	};
+
+	uint32_t Size;
+	uint32_t DataSize;
+
+} xDataBufferT;
+//==============================================================================
+//functions:
+
+static inline uint32_t xDataBufferGetFreeSize(xDataBufferT* buffer)
+{
+	return buffer->Size - buffer->DataSize;
+}
+//------------------------------------------------------------------------------
+static inline xResult xDataBufferAdd(xDataBufferT* buffer, const void* data, uint32_t size)
+{
+	if (size > xDataBufferGetFreeSize(buffer))
+	{
+		return xResultError;
+	}
+
+	memcpy(buffer->Memory + buffer->DataSize, data, size);
+	buffer->DataSize += size;
+
+	return xResultAccept;
+}
+//------------------------------------------------------------------------------
+static inline void xDataBufferClear(xDataBufferT* buffer)
+{
+	buffer->DataSize = 0;
+}
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_X_DATA_BUFFER_H_
@@ -0,0 +1,41 @@
+//==============================================================================
+//header:
+
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+//==============================================================================
+//defines:
+
+/// @brief the part of FreeRTOS used by the ports of MqttClient, the calls run on the clock of MqttLink
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+
+#define portMAX_DELAY UINT32_MAX
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(time) ((TickType_t)(time))
+
+#define configMINIMAL_STACK_SIZE 128
+//==============================================================================
+//types:
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //INC_FREERTOS_H
@@ -0,0 +1,75 @@
+//==============================================================================
+//header:
+
+#ifndef FREERTOS_IP_H
+#define FREERTOS_IP_H
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+//==============================================================================
+//defines:
+
+/// @brief the part of FreeRTOS+TCP used by the MQTT transports, the socket is the client end of MqttLink
+#define FREERTOS_AF_INET 2
+#define FREERTOS_SOCK_STREAM 1
+#define FREERTOS_IPPROTO_TCP 6
+
+#define FREERTOS_SO_RCVTIMEO 0
+#define FREERTOS_SO_SNDTIMEO 1
+#define FREERTOS_SO_SET_SEMAPHORE 3
+
+#define FREERTOS_MSG_DONTWAIT 2
+
+#define pdFREERTOS_ERRNO_EAGAIN 11
+#define pdFREERTOS_ERRNO_ENOSPC 28
+#define pdFREERTOS_ERRNO_ENOTCONN 128
+
+#define ipconfigSOCK_DEFAULT_RECEIVE_BLOCK_TIME portMAX_DELAY
+#define ipconfigSOCK_DEFAULT_SEND_BLOCK_TIME portMAX_DELAY
+
+#define FreeRTOS_htons(value) ((uint16_t)(((value) << 8) | ((uint16_t)(value) >> 8)))
+//==============================================================================
+//types:
+
+typedef struct MqttLinkSocketT* Socket_t;
+typedef Socket_t xSocket_t;
+typedef uint32_t socklen_t;
+
+struct freertos_sockaddr
+{
+	uint8_t sin_len;
+	uint8_t sin_family;
+	uint16_t sin_port;
+	uint32_t sin_addr;
+};
+//==============================================================================
+//functions:
+
+Socket_t FreeRTOS_socket(BaseType_t domain, BaseType_t type, BaseType_t protocol);
+BaseType_t FreeRTOS_setsockopt(Socket_t socket, int32_t level, int32_t name, const void* value, size_t length);
+BaseType_t FreeRTOS_connect(Socket_t socket, struct freertos_sockaddr* address, socklen_t length);
+BaseType_t FreeRTOS_closesocket(Socket_t socket);
+
+BaseType_t FreeRTOS_recv(Socket_t socket, void* buffer, size_t length, BaseType_t flags);
+BaseType_t FreeRTOS_recvcount(Socket_t socket);
+
+/// @brief NULL buffer commits the bytes written at the head of the TX stream
+BaseType_t FreeRTOS_send(Socket_t socket, const void* buffer, size_t length, BaseType_t flags);
+uint8_t* FreeRTOS_get_tx_head(Socket_t socket, BaseType_t* length);
+BaseType_t FreeRTOS_tx_space(Socket_t socket);
+
+uint32_t FreeRTOS_gethostbyname(const char* name);
+uint32_t FreeRTOS_inet_addr(const char* address); //0 - not a dotted IPv4 address
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //FREERTOS_IP_H
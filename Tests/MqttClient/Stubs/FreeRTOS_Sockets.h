@@ -0,0 +1,12 @@
+//==============================================================================
+//header:
+
+#ifndef FREERTOS_SOCKETS_H
+#define FREERTOS_SOCKETS_H
+//==============================================================================
+//includes:
+
+//the socket API of the stubs is declared with the IP task
+#include "FreeRTOS_IP.h"
+//==============================================================================
+#endif //FREERTOS_SOCKETS_H
@@ -0,0 +1,36 @@
+//==============================================================================
+//header:
+
+#ifndef __MAIN_H
+#define __MAIN_H
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include <stdint.h>
+//==============================================================================
+//types:
+
+typedef struct
+{
+	volatile uint32_t CYCCNT;
+
+} DWT_Type;
+//==============================================================================
+//functions:
+
+/// @brief the cycle counter of the board: on the host it counts the nanoseconds of the process CPU time
+DWT_Type* MqttHostGetDwt();
+//==============================================================================
+//defines:
+
+#define DWT (MqttHostGetDwt())
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //__MAIN_H
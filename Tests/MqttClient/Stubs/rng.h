@@ -0,0 +1,43 @@
+//==============================================================================
+//header:
+
+#ifndef __RNG_H__
+#define __RNG_H__
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include <stdint.h>
+//==============================================================================
+//types:
+
+/// @brief the part of the HAL RNG used by the seed of wolfSSL, the numbers are given by the test
+typedef enum
+{
+	HAL_OK,
+	HAL_ERROR
+
+} HAL_StatusTypeDef;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Instance;
+
+} RNG_HandleTypeDef;
+//==============================================================================
+//functions:
+
+HAL_StatusTypeDef HAL_RNG_GenerateRandomNumber(RNG_HandleTypeDef* handle, uint32_t* value);
+//==============================================================================
+//export:
+
+extern RNG_HandleTypeDef hrng;
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //__RNG_H__
@@ -0,0 +1,36 @@
+//==============================================================================
+//header:
+
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "FreeRTOS.h"
+//==============================================================================
+//types:
+
+typedef struct MqttLinkSemaphoreT* SemaphoreHandle_t;
+//==============================================================================
+//functions:
+
+SemaphoreHandle_t xSemaphoreCreateBinary();
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex();
+
+/// @brief a binary semaphore not given blocks: the clock of MqttLink goes to the event of the socket it is set to or to the timeout
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticks);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //SEMAPHORE_H
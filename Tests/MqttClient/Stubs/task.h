@@ -0,0 +1,41 @@
+//==============================================================================
+//header:
+
+#ifndef INC_TASK_H
+#define INC_TASK_H
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "FreeRTOS.h"
+//==============================================================================
+//types:
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+typedef struct
+{
+	TickType_t TimeOnEntering;
+
+} TimeOut_t;
+//==============================================================================
+//functions:
+
+TickType_t xTaskGetTickCount();
+
+void vTaskSetTimeOutState(TimeOut_t* timeOut);
+BaseType_t xTaskCheckForTimeOut(TimeOut_t* timeOut, TickType_t* ticksToWait);
+
+TaskHandle_t xTaskGetCurrentTaskHandle();
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task);
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint16_t stackSize, void* parameters, UBaseType_t priority, TaskHandle_t* task);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //INC_TASK_H
@@ -0,0 +1,193 @@
+//==============================================================================
+//includes:
+
+#include "Net/Reconnect/NetReconnect.h"
+#include <stdio.h>
+//==============================================================================
+//defines:
+
+#define BASE_DELAY 1000 //ms
+#define MAX_DELAY 60000 //ms
+#define STABLE_TIME 30000 //ms
+
+#define POLL_PERIOD 10 //ms, the client asks on each pass of its task
+#define DEAD_TIME 10 //minutes of the broker down
+
+#define FLEET_SIZE 100 //devices dropped by the restart of the broker at the same time
+#define FLEET_SLOT 100 //ms
+//==============================================================================
+//variables:
+
+static NetReconnectT privateFleet[FLEET_SIZE];
+//==============================================================================
+//functions:
+
+static void privateInit(NetReconnectT* reconnect, uint32_t seed)
+{
+	NetReconnectInitT init =
+	{
+		.Name = "mqtt",
+		.BaseDelay = BASE_DELAY,
+		.MaxDelay = MAX_DELAY,
+		.StableTime = STABLE_TIME,
+		.Seed = seed
+	};
+
+	NetReconnectInit(reconnect, &init);
+}
+//------------------------------------------------------------------------------
+/// @brief the delay doesn't exceed min(MaxDelay, BaseDelay * 2^(Failures - 1)) of the failure just counted
+static bool privateDelayIsValid(NetReconnectT* reconnect)
+{
+	uint32_t ceiling = reconnect->Failures - 1 < 6 ? BASE_DELAY << (reconnect->Failures - 1) : MAX_DELAY;
+
+	return reconnect->Delay <= (ceiling < MAX_DELAY ? ceiling : MAX_DELAY);
+}
+//------------------------------------------------------------------------------
+/// @brief polls until the attempt is allowed
+static uint32_t privateWaitAllowed(NetReconnectT* reconnect, uint32_t time)
+{
+	while (!NetReconnectIsAllowed(reconnect, time))
+	{
+		time += POLL_PERIOD;
+	}
+
+	return time;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	NetReconnectT reconnect;
+	NetReconnectInitT invalid = { .BaseDelay = MAX_DELAY, .MaxDelay = BASE_DELAY };
+
+	if (NetReconnectInit(&reconnect, &invalid) == xResultAccept)
+	{
+		printf("FAIL: the max delay below the base is accepted\n");
+		return 1;
+	}
+
+	//the broker is down: the task polls every POLL_PERIOD, the attempts are spaced by the backoff
+	uint32_t perMinute[DEAD_TIME] = { 0 };
+	uint32_t polls = 0;
+
+	privateInit(&reconnect, 12345);
+
+	for (uint32_t time = 0; time < DEAD_TIME * 60000; time += POLL_PERIOD)
+	{
+		polls++;
+
+		if (NetReconnectIsAllowed(&reconnect, time))
+		{
+			perMinute[time / 60000]++;
+			NetReconnectFailed(&reconnect, time);
+
+			if (!privateDelayIsValid(&reconnect))
+			{
+				printf("FAIL: delay %u ms after %u failures\n", reconnect.Delay, reconnect.Failures);
+				return 1;
+			}
+		}
+	}
+
+	printf("broker down %u min, %u polls: %u attempts, per minute:", DEAD_TIME, polls, reconnect.Attempts);
+
+	for (uint8_t i = 0; i < DEAD_TIME; i++)
+	{
+		printf(" %u", perMinute[i]);
+	}
+
+	printf("\n");
+
+	//the doubling reaches the ceiling in the first minute, then one attempt per 30 s on average
+	if (perMinute[0] > 10 || reconnect.Attempts > perMinute[0] + (DEAD_TIME - 1) * 4)
+	{
+		printf("FAIL: the attempts are not backed off\n");
+		return 1;
+	}
+
+	//a connection that lived StableTime resets the backoff
+	uint32_t time = privateWaitAllowed(&reconnect, DEAD_TIME * 60000);
+
+	NetReconnectConnected(&reconnect, time);
+	time += STABLE_TIME + 10000;
+	NetReconnectDisconnected(&reconnect, time);
+
+	printf("after a stable connection: %u failures, delay %u ms\n", reconnect.Failures, reconnect.Delay);
+
+	if (reconnect.Failures != 1 || reconnect.Delay > BASE_DELAY)
+	{
+		printf("FAIL: the backoff is not reset\n");
+		return 1;
+	}
+
+	//a broker that accepts and drops the connection keeps the backoff growing
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		time = privateWaitAllowed(&reconnect, time);
+
+		NetReconnectConnected(&reconnect, time);
+		time += 1000;
+		NetReconnectDisconnected(&reconnect, time);
+	}
+
+	printf("after 3 short connections: %u failures, delay %u ms\n", reconnect.Failures, reconnect.Delay);
+
+	if (reconnect.Failures != 4 || !privateDelayIsValid(&reconnect))
+	{
+		printf("FAIL: a short connection resets the backoff\n");
+		return 1;
+	}
+
+	//the system time wraps during the wait
+	uint32_t wrapTime = 0xFFFFFFFF - 100;
+
+	privateInit(&reconnect, 777);
+	reconnect.Failures = 6;
+	NetReconnectFailed(&reconnect, wrapTime);
+
+	uint32_t delay = reconnect.Delay;
+	uint32_t waitTime = NetReconnectGetWaitTime(&reconnect, wrapTime);
+
+	printf("wrap: delay %u ms, wait %u ms\n", delay, waitTime);
+
+	if (waitTime != delay
+		|| (delay && NetReconnectIsAllowed(&reconnect, wrapTime + delay - 1))
+		|| !NetReconnectIsAllowed(&reconnect, wrapTime + delay))
+	{
+		printf("FAIL: wrap of the time\n");
+		return 1;
+	}
+
+	//the fleet is dropped at once: the jitter of the seeds spreads the first attempts
+	uint32_t slots[BASE_DELAY / FLEET_SLOT + 1] = { 0 };
+	uint32_t busiestSlot = 0;
+
+	for (uint32_t i = 0; i < FLEET_SIZE; i++)
+	{
+		privateInit(&privateFleet[i], 0x1000 + i * 0x9E37);
+		NetReconnectConnected(&privateFleet[i], 0);
+		NetReconnectDisconnected(&privateFleet[i], STABLE_TIME);
+
+		uint32_t slot = privateFleet[i].Delay / FLEET_SLOT;
+
+		if (++slots[slot] > busiestSlot)
+		{
+			busiestSlot = slots[slot];
+		}
+	}
+
+	printf("fleet of %u: the busiest %u ms of the first reconnects takes %u devices\n", FLEET_SIZE, FLEET_SLOT, busiestSlot);
+
+	if (busiestSlot > FLEET_SIZE / 4)
+	{
+		printf("FAIL: the fleet reconnects in step\n");
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
@@ -0,0 +1,94 @@
+//==============================================================================
+//header:
+
+#ifndef _X_PORT_H_
+#define _X_PORT_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+//==============================================================================
+//types:
+
+typedef enum
+{
+	xPortAdapterRequestGetTxBufferSize = 1,
+	xPortAdapterRequestGetTxBufferFreeSize,
+	xPortAdapterRequestGetRxBufferSize,
+	xPortAdapterRequestGetRxBufferFreeSize,
+	xPortAdapterRequestClearRxBuffer,
+	xPortAdapterRequestStartTransmission,
+	xPortAdapterRequestEndTransmission,
+	xPortAdapterRequestSetBinding,
+	xPortAdapterRequestOpen,
+	xPortAdapterRequestConnect,
+	xPortAdapterRequestClose
+
+} xPortAdapterRequestSelector;
+//------------------------------------------------------------------------------
+typedef enum
+{
+	xPortAdapterEventIdle
+
+} xPortAdapterEventSelector;
+//------------------------------------------------------------------------------
+typedef struct xPortT xPortT;
+
+typedef void (*xPortAdapterHandlerT)(xPortT* port);
+typedef xResult (*xPortAdapterRequestListenerT)(xPortT* port, int selector, uint32_t description, void* arg);
+typedef void (*xPortAdapterEventListenerT)(xPortT* port, int selector, uint32_t description, void* arg);
+typedef int (*xPortAdapterTransmitActionT)(xPortT* port, void* data, uint32_t size);
+typedef int (*xPortAdapterReceiveActionT)(xPortT* port, void* data, uint32_t size);
+//------------------------------------------------------------------------------
+typedef struct
+{
+	xPortAdapterHandlerT Handler;
+
+	xPortAdapterRequestListenerT RequestListener;
+	xPortAdapterEventListenerT EventListener;
+
+	xPortAdapterTransmitActionT Transmit;
+	xPortAdapterReceiveActionT Receive;
+
+} xPortAdapterInterfaceT;
+//------------------------------------------------------------------------------
+/// @brief the part of xLibs/Abstractions/xPort/xPort.h used by the host tests
+struct xPortT
+{
+	void* Owner;
+
+	struct
+	{
+		const char* Description;
+		void* Content;
+		xPortAdapterInterfaceT* Interface;
+
+	} Adapter;
+
+	bool IsOpen;
+	bool IsConnected;
+};
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint8_t* Data;
+	uint32_t Size;
+	uint32_t FullSize;
+
+} RxDataPacketT;
+//==============================================================================
+//functions:
+
+void xPortStartTransmission(xPortT* port);
+int xPortTransmitData(xPortT* port, void* data, uint32_t size);
+void xPortEndTransmission(xPortT* port);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_X_PORT_H_
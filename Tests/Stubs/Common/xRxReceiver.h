@@ -0,0 +1,32 @@
+//==============================================================================
+//header:
+
+#ifndef _X_RX_RECEIVER_H_
+#define _X_RX_RECEIVER_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include "Components-Types.h"
+//==============================================================================
+//types:
+
+/// @brief the part of xLibs/Common/xRxReceiver.h used by the host tests
+typedef struct
+{
+	void* Object;
+
+} xRxReceiverT;
+//==============================================================================
+//functions:
+
+void xRxReceiverReceive(xRxReceiverT* receiver, uint8_t* data, uint32_t size);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_X_RX_RECEIVER_H_
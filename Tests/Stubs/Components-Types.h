@@ -0,0 +1,41 @@
+//==============================================================================
+//header:
+
+#ifndef _COMPONENTS_TYPES_H_
+#define _COMPONENTS_TYPES_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+//==============================================================================
+//defines:
+
+#define nameof(name) #name
+//==============================================================================
+//types:
+
+/// @brief the part of xLibs/Components-Types.h used by the host tests
+typedef enum
+{
+	xResultAccept,
+	xResultError,
+	xResultBusy,
+	xResultTimeOut,
+	xResultInProgress,
+	xResultLinkError,
+	xResultRequestIsNotFound,
+	xResultNotSupported
+
+} xResult;
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_COMPONENTS_TYPES_H_
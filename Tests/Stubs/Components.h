@@ -0,0 +1,24 @@
+//==============================================================================
+//header:
+
+#ifndef _COMPONENTS_H_
+#define _COMPONENTS_H_
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+//the board header of the components: the host tests take the types and the clock
+#include "Components-Types.h"
+//==============================================================================
+//functions:
+
+uint32_t xSystemGetTime(); //ms, given by the test
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //_COMPONENTS_H_
@@ -0,0 +1,46 @@
+//==============================================================================
+//header:
+
+#ifndef MQTTFreeRTOS_H
+#define MQTTFreeRTOS_H
+//------------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif
+//==============================================================================
+//includes:
+
+#include <stdint.h>
+//==============================================================================
+//types:
+
+/// @brief the part of Interfaces/Paho-MQTT-Interface/MQTT-Interface.h used by Paho MQTTClient,
+/// the test gives the timers and the transport of the host
+typedef struct MQTTTimer
+{
+	uint64_t End; //ms
+
+} MQTTTimerT;
+//------------------------------------------------------------------------------
+typedef struct MQTTNetwork MQTTNetworkT;
+
+struct MQTTNetwork
+{
+	int (*mqttread) (MQTTNetworkT*, unsigned char*, int, int);
+	int (*mqttwrite) (MQTTNetworkT*, unsigned char*, int, int);
+	void (*disconnect) (MQTTNetworkT*);
+};
+//==============================================================================
+//functions:
+
+void TimerInit(MQTTTimerT*);
+char TimerIsExpired(MQTTTimerT*);
+void TimerCountdownMS(MQTTTimerT*, unsigned int);
+void TimerCountdown(MQTTTimerT*, unsigned int);
+int TimerLeftMS(MQTTTimerT*);
+//==============================================================================
+#ifdef __cplusplus
+}
+#endif
+//------------------------------------------------------------------------------
+#endif //MQTTFreeRTOS_H
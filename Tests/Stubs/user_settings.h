@@ -0,0 +1,27 @@
+//==============================================================================
+//header:
+
+#ifndef _WOLFSSL_USER_SETTINGS_STUB_H_
+#define _WOLFSSL_USER_SETTINGS_STUB_H_
+//==============================================================================
+//includes:
+
+//the settings of the target: the same ciphers, math and memory model
+#include_next "user_settings.h"
+//==============================================================================
+//defines:
+
+//the platform of the host: no FreeRTOS, no STM32, the portable C of the SP math
+#undef FREERTOS
+#undef WOLFSSL_STM32F4
+#undef WOLFSSL_STM32_CUBEMX
+#undef WOLFSSL_SP_ARM_CORTEX_M_ASM
+
+#define SINGLE_THREADED
+
+//the TLS server of the handshake bench: the client is MqttTls with the settings of the target
+#ifdef MQTT_TLS_BENCH_SERVER
+#undef NO_WOLFSSL_SERVER
+#endif
+//==============================================================================
+#endif //_WOLFSSL_USER_SETTINGS_STUB_H_
@@ -0,0 +1,449 @@
+//==============================================================================
+//includes:
+
+#include "UsartDma/UsartDmaTx.h"
+#include <stdio.h>
+#include <string.h>
+//==============================================================================
+//defines:
+
+#define RING_SIZE_MASK 0x3f //small: the frames wrap and the spans are chained from the transfer complete
+
+#define BIT 100 //the time unit of the model is 1/100 of a bit
+#define CHAR (10 * BIT) //8N1
+#define GUARD_TIME (1 * BIT) //USART_DMA_RS485_GUARD_BITS
+#define IRQ_LATENCY_MAX (BIT / 2) //USART and TIM7 at priority 6
+#define DMA_LATENCY_MAX (40 * BIT) //the transfer complete of DMA1_Stream6, delayed by the higher priorities
+
+#define RUNS 2000
+#define WRITES 40 //frames of a run written by the task
+#define WRITE_SIZE_MAX 60
+#define RUN_TIME (3000 * BIT) //the writes are spread over it
+#define EVENTS 256
+//==============================================================================
+//types:
+
+typedef enum
+{
+	EventWrite,
+	EventShiftDone,
+	EventTcIrq,
+	EventDmaIrq,
+	EventGuardIrq
+
+} EventKindT;
+//------------------------------------------------------------------------------
+typedef struct
+{
+	uint32_t Time;
+	uint32_t Sequence; //the order of the events at the same time
+	EventKindT Kind;
+	uint32_t Generation; //of the guard timer, a stop cancels the pending update
+
+} EventT;
+//------------------------------------------------------------------------------
+/**
+ * @brief the USART2, its TX stream and TIM7 under UsartDmaPort-Adapter.c at the byte level: the stream
+ * moves a byte to DR when it is empty and clears EN after the last one, DR goes to the shift register,
+ * TC is set when the shift register and DR are empty
+ */
+typedef struct
+{
+	UsartDmaTxRingT Ring;
+	uint8_t Memory[RING_SIZE_MASK + 1];
+
+	bool IsEnabled; //DMA_SxCR_EN
+	uint16_t Remaining; //bytes of the span not moved to DR
+
+	bool IsDrFull;
+	bool IsShifting;
+	uint32_t ShiftEnd;
+
+	bool Tc; //USART_SR_TC
+	bool Tcie; //USART_CR1_TCIE
+
+	uint32_t Guard; //generation of the running guard timer, 0 - stopped
+	uint32_t Generation;
+
+	bool De;
+	bool IsTransmitting; //UsartDmaRs485T
+
+	uint32_t Frames;
+	uint32_t Truncated; //DE released with a byte in DR or in the shift register
+	uint32_t Unframed; //a byte started on the line with DE released
+	uint32_t ReleaseMin; //from the last stop bit to the release of DE
+	uint32_t ReleaseMax;
+
+} LineT;
+//==============================================================================
+//variables:
+
+static LineT privateLine;
+
+static EventT privateEvents[EVENTS];
+static uint32_t privateEventsCount;
+static uint32_t privateSequence;
+static uint32_t privateTime;
+
+static uint64_t privateSeed = 88172645463325252ULL;
+//==============================================================================
+//functions:
+
+static uint32_t privateRandom()
+{
+	privateSeed ^= privateSeed << 13;
+	privateSeed ^= privateSeed >> 7;
+	privateSeed ^= privateSeed << 17;
+
+	return (uint32_t)privateSeed;
+}
+//------------------------------------------------------------------------------
+static void privatePush(uint32_t time, EventKindT kind, uint32_t generation)
+{
+	if (privateEventsCount < EVENTS)
+	{
+		privateEvents[privateEventsCount++] = (EventT){ time, privateSequence++, kind, generation };
+	}
+}
+//------------------------------------------------------------------------------
+static bool privatePop(EventT* event)
+{
+	if (!privateEventsCount)
+	{
+		return false;
+	}
+
+	uint32_t first = 0;
+
+	for (uint32_t i = 1; i < privateEventsCount; i++)
+	{
+		if (privateEvents[i].Time < privateEvents[first].Time
+			|| (privateEvents[i].Time == privateEvents[first].Time && privateEvents[i].Sequence < privateEvents[first].Sequence))
+		{
+			first = i;
+		}
+	}
+
+	*event = privateEvents[first];
+	privateEvents[first] = privateEvents[--privateEventsCount];
+
+	return true;
+}
+//------------------------------------------------------------------------------
+static uint32_t privateIrqLatency()
+{
+	return privateRandom() % (IRQ_LATENCY_MAX + 1);
+}
+//------------------------------------------------------------------------------
+/// @brief the complete interrupt is late by a random preemption: none, a short one or a long one
+static uint32_t privateDmaLatency()
+{
+	const uint32_t latencies[] = { 1, BIT / 2, 3 * BIT, 15 * BIT, DMA_LATENCY_MAX };
+
+	return latencies[privateRandom() % (sizeof(latencies) / sizeof(latencies[0]))];
+}
+//------------------------------------------------------------------------------
+static void privateShift();
+//------------------------------------------------------------------------------
+/// @brief the stream writes DR when it is empty, EN is cleared with the last byte, before the complete interrupt
+static void privateFeed()
+{
+	LineT* line = &privateLine;
+
+	if (!line->IsEnabled || !line->Remaining || line->IsDrFull)
+	{
+		return;
+	}
+
+	line->IsDrFull = true;
+	line->Tc = false;
+	line->Remaining--;
+
+	if (!line->Remaining)
+	{
+		line->IsEnabled = false;
+		privatePush(privateTime + privateDmaLatency(), EventDmaIrq, 0);
+	}
+
+	if (!line->IsShifting)
+	{
+		privateShift();
+	}
+}
+//------------------------------------------------------------------------------
+static void privateShift()
+{
+	LineT* line = &privateLine;
+
+	if (!line->De)
+	{
+		line->Unframed++;
+	}
+
+	line->IsDrFull = false;
+	line->IsShifting = true;
+	line->ShiftEnd = privateTime + CHAR;
+
+	privatePush(line->ShiftEnd, EventShiftDone, 0);
+	privateFeed();
+}
+//------------------------------------------------------------------------------
+static void privateTcieSet()
+{
+	privateLine.Tcie = true;
+
+	if (privateLine.Tc)
+	{
+		privatePush(privateTime + privateIrqLatency(), EventTcIrq, 0);
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief privateTxIsIdle
+static bool privateTxIsIdle()
+{
+	return !privateLine.Ring.Pending || !privateLine.IsEnabled;
+}
+//------------------------------------------------------------------------------
+/// @brief privateRs485Release
+static void privateRelease()
+{
+	LineT* line = &privateLine;
+
+	if (line->IsShifting || line->IsDrFull)
+	{
+		line->Truncated++;
+	}
+
+	uint32_t release = privateTime - line->ShiftEnd;
+
+	if (release < line->ReleaseMin)
+	{
+		line->ReleaseMin = release;
+	}
+
+	if (release > line->ReleaseMax)
+	{
+		line->ReleaseMax = release;
+	}
+
+	line->De = false;
+	line->IsTransmitting = false;
+}
+//------------------------------------------------------------------------------
+/// @brief privateStartTransfer with privateRs485Assert
+static void privateStartTransfer()
+{
+	LineT* line = &privateLine;
+	uint8_t* data;
+	uint16_t size = UsartDmaTxRingStart(&line->Ring, &data);
+
+	if (!size)
+	{
+		return;
+	}
+
+	if (!line->IsTransmitting)
+	{
+		line->De = true;
+		line->IsTransmitting = true;
+		line->Frames++;
+	}
+	else
+	{
+		//privateOnePulseStop
+		line->Guard = 0;
+	}
+
+	privateTcieSet();
+
+	line->IsEnabled = true;
+	line->Remaining = size;
+	privateFeed();
+
+	//usart->SR = ~USART_SR_TC
+	line->Tc = false;
+}
+//------------------------------------------------------------------------------
+/// @brief privateTxComplete: the ring is completed and the wrapped part is chained, TC is enabled again
+static void privateDmaIrq()
+{
+	UsartDmaTxRingComplete(&privateLine.Ring);
+	privateStartTransfer();
+
+	if (privateLine.IsTransmitting)
+	{
+		privateTcieSet();
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief UsartDmaPortAdapterIRQ on TC: the guard timer starts when the stream is done
+static void privateTcIrq()
+{
+	LineT* line = &privateLine;
+
+	if (!line->Tc || !line->Tcie)
+	{
+		return;
+	}
+
+	line->Tcie = false;
+
+	if (privateTxIsIdle())
+	{
+		line->Guard = ++line->Generation;
+		privatePush(privateTime + GUARD_TIME + privateIrqLatency(), EventGuardIrq, line->Guard);
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief UsartDmaPortAdapterGuardIRQ
+static void privateGuardIrq(uint32_t generation)
+{
+	LineT* line = &privateLine;
+
+	if (line->Guard != generation)
+	{
+		return;
+	}
+
+	line->Guard = 0;
+
+	if (line->IsTransmitting && privateTxIsIdle())
+	{
+		privateRelease();
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief the frames of the task at random times, each one written to the ring and kicked
+static bool privateRun()
+{
+	LineT* line = &privateLine;
+
+	memset(line, 0, sizeof(LineT));
+	UsartDmaTxRingInit(&line->Ring, line->Memory, RING_SIZE_MASK);
+
+	line->Tc = true;
+	line->ReleaseMin = UINT32_MAX;
+
+	privateEventsCount = 0;
+	privateTime = 0;
+
+	for (uint32_t i = 0; i < WRITES; i++)
+	{
+		privatePush(privateRandom() % RUN_TIME, EventWrite, 0);
+	}
+
+	EventT event;
+
+	while (privatePop(&event))
+	{
+		privateTime = event.Time;
+
+		switch ((uint8_t)event.Kind)
+		{
+			case EventWrite:
+			{
+				uint8_t frame[WRITE_SIZE_MAX];
+				uint16_t size = 1 + privateRandom() % WRITE_SIZE_MAX;
+
+				//a full ring drops the rest, the task would wait on TxSemaphore
+				UsartDmaTxRingWrite(&line->Ring, frame, size);
+
+				//privateKick
+				privateStartTransfer();
+				break;
+			}
+
+			case EventShiftDone:
+				line->IsShifting = false;
+
+				if (line->IsDrFull)
+				{
+					privateShift();
+				}
+				else
+				{
+					line->Tc = true;
+
+					if (line->Tcie)
+					{
+						privatePush(privateTime + privateIrqLatency(), EventTcIrq, 0);
+					}
+				}
+				break;
+
+			case EventTcIrq:
+				privateTcIrq();
+				break;
+
+			case EventDmaIrq:
+				privateDmaIrq();
+				break;
+
+			case EventGuardIrq:
+				privateGuardIrq(event.Generation);
+				break;
+		}
+	}
+
+	//the bus is given back and the ring is drained
+	return !line->De && !line->IsTransmitting && !UsartDmaTxRingGetDataSize(&line->Ring) && !line->Ring.Pending;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	uint32_t frames = 0;
+	uint32_t stuck = 0;
+	uint32_t truncated = 0;
+	uint32_t unframed = 0;
+	uint32_t releaseMin = UINT32_MAX;
+	uint32_t releaseMax = 0;
+
+	for (uint32_t i = 0; i < RUNS; i++)
+	{
+		if (!privateRun())
+		{
+			stuck++;
+		}
+
+		frames += privateLine.Frames;
+		truncated += privateLine.Truncated;
+		unframed += privateLine.Unframed;
+
+		if (privateLine.ReleaseMin < releaseMin)
+		{
+			releaseMin = privateLine.ReleaseMin;
+		}
+
+		if (privateLine.ReleaseMax > releaseMax)
+		{
+			releaseMax = privateLine.ReleaseMax;
+		}
+	}
+
+	printf("RS485 DE model: %u randomised runs, %u frames (DE assertions), DMA complete late up to %u bit times\n",
+			RUNS, frames, DMA_LATENCY_MAX / BIT);
+	printf("  DE released %u.%02u..%u.%02u bit times after the last stop bit (guard %u bit), "
+			"truncated %u, bytes without DE %u, DE left asserted %u\n",
+			releaseMin / BIT, releaseMin % BIT, releaseMax / BIT, releaseMax % BIT, GUARD_TIME / BIT,
+			truncated, unframed, stuck);
+
+	if (truncated || unframed || stuck)
+	{
+		printf("FAIL: DE timing\n");
+		return 1;
+	}
+
+	//the guard and the latencies of TC and TIM7, not of the transfer complete
+	if (releaseMin < GUARD_TIME || releaseMax > GUARD_TIME + 2 * IRQ_LATENCY_MAX)
+	{
+		printf("FAIL: DE release time\n");
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
@@ -0,0 +1,256 @@
+//==============================================================================
+//includes:
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+//==============================================================================
+//defines:
+
+#define REQUESTS 500 //of each run
+#define REQUEST_PERIOD_MIN 2000 //us between the requests on the line
+#define REQUEST_PERIOD_SPREAD 3000 //us
+#define RESPONSE_TIME 20 //us of the terminal command and its response
+
+//the priorities of the model: the interrupt above the UsartDma task above the super-loop
+#define INTERRUPT_PRIORITY 30
+#define TASK_PRIORITY 20
+#define LOOP_PRIORITY 10
+//==============================================================================
+//types:
+
+typedef struct
+{
+	uint32_t Median; //us
+	uint32_t Percentile99;
+
+} LatencyT;
+//==============================================================================
+//variables:
+
+static bool privateIsEventMode;
+static uint64_t privateLoopPass; //ns, the mean of the random passes of the super-loop
+
+static _Atomic uint64_t privateStamp; //of the pending request, 0 - nothing is pending
+static _Atomic uint32_t privateDone;
+static volatile bool privateIsStopped;
+static sem_t privateNotify;
+
+static uint64_t privateLatency[REQUESTS];
+static bool privateIsRealTime = true;
+//==============================================================================
+//functions:
+
+static uint64_t privateGetTime()
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+//------------------------------------------------------------------------------
+static void privateSpin(uint64_t duration)
+{
+	uint64_t end = privateGetTime() + duration;
+
+	while (privateGetTime() < end)
+	{
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief the dispatch of the received data: the terminal command runs and responds
+static void privateDispatch()
+{
+	uint64_t stamp = atomic_exchange(&privateStamp, 0);
+
+	if (!stamp)
+	{
+		return;
+	}
+
+	privateSpin(RESPONSE_TIME * 1000);
+
+	uint32_t request = atomic_fetch_add(&privateDone, 1);
+
+	if (request < REQUESTS)
+	{
+		privateLatency[request] = privateGetTime() - stamp;
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief the super-loop: polls the port between its passes (USART_DMA_RX_EVENTS 0)
+static void* privateLoop(void* context)
+{
+	unsigned seed = 1;
+
+	while (!privateIsStopped)
+	{
+		privateSpin(privateLoopPass ? rand_r(&seed) % (2 * privateLoopPass) : 0);
+
+		if (!privateIsEventMode)
+		{
+			privateDispatch();
+		}
+		else
+		{
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+//------------------------------------------------------------------------------
+/// @brief the UsartDma task: waits for the notification of the interrupt
+static void* privateTask(void* context)
+{
+	while (!privateIsStopped)
+	{
+		sem_wait(&privateNotify);
+		privateDispatch();
+	}
+
+	return NULL;
+}
+//------------------------------------------------------------------------------
+/// @brief IDLE and the half/full transfer of the RX stream: stamps the request and notifies the task
+static void* privateInterrupt(void* context)
+{
+	unsigned seed = 7;
+
+	while (atomic_load(&privateDone) < REQUESTS)
+	{
+		usleep(REQUEST_PERIOD_MIN + rand_r(&seed) % REQUEST_PERIOD_SPREAD);
+
+		uint64_t expected = 0;
+
+		atomic_compare_exchange_strong(&privateStamp, &expected, privateGetTime() | 1);
+
+		if (privateIsEventMode)
+		{
+			sem_post(&privateNotify);
+		}
+	}
+
+	privateIsStopped = true;
+	sem_post(&privateNotify);
+
+	return NULL;
+}
+//------------------------------------------------------------------------------
+/// @brief SCHED_FIFO when it is permitted, the default policy otherwise
+static pthread_t privateStart(void* (*function)(void*), int priority)
+{
+	pthread_attr_t attributes;
+	struct sched_param parameters = { .sched_priority = priority };
+	pthread_t thread;
+
+	pthread_attr_init(&attributes);
+
+	if (privateIsRealTime)
+	{
+		pthread_attr_setinheritsched(&attributes, PTHREAD_EXPLICIT_SCHED);
+		pthread_attr_setschedpolicy(&attributes, SCHED_FIFO);
+		pthread_attr_setschedparam(&attributes, &parameters);
+
+		if (!pthread_create(&thread, &attributes, function, NULL))
+		{
+			return thread;
+		}
+
+		privateIsRealTime = false;
+		printf("SCHED_FIFO is not permitted, the default policy is used\n");
+		pthread_attr_init(&attributes);
+	}
+
+	pthread_create(&thread, &attributes, function, NULL);
+
+	return thread;
+}
+//------------------------------------------------------------------------------
+static int privateCompare(const void* a, const void* b)
+{
+	uint64_t x = *(const uint64_t*)a;
+	uint64_t y = *(const uint64_t*)b;
+
+	return x < y ? -1 : x > y;
+}
+//------------------------------------------------------------------------------
+static LatencyT privateRun(bool isEventMode, uint32_t loopPass)
+{
+	privateIsEventMode = isEventMode;
+	privateLoopPass = (uint64_t)loopPass * 1000;
+	privateIsStopped = false;
+
+	atomic_store(&privateStamp, 0);
+	atomic_store(&privateDone, 0);
+	sem_init(&privateNotify, 0, 0);
+
+	pthread_t loop = privateStart(privateLoop, LOOP_PRIORITY);
+	pthread_t task = privateStart(privateTask, TASK_PRIORITY);
+	pthread_t interrupt = privateStart(privateInterrupt, INTERRUPT_PRIORITY);
+
+	pthread_join(interrupt, NULL);
+	pthread_join(loop, NULL);
+	pthread_join(task, NULL);
+	sem_destroy(&privateNotify);
+
+	qsort(privateLatency, REQUESTS, sizeof(privateLatency[0]), privateCompare);
+
+	LatencyT latency =
+	{
+		.Median = privateLatency[REQUESTS / 2] / 1000,
+		.Percentile99 = privateLatency[REQUESTS * 99 / 100] / 1000
+	};
+
+	return latency;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	static const uint32_t passes[] = { 100, 1000, 5000 }; //us
+
+	//one CPU as on the board
+	cpu_set_t cpus;
+
+	CPU_ZERO(&cpus);
+	CPU_SET(0, &cpus);
+	sched_setaffinity(0, sizeof(cpus), &cpus);
+
+	printf("%u requests every %u-%u us, %u us response, from the interrupt to the end of the dispatch:\n",
+			REQUESTS, REQUEST_PERIOD_MIN, REQUEST_PERIOD_MIN + REQUEST_PERIOD_SPREAD, RESPONSE_TIME);
+
+	LatencyT poll;
+	LatencyT event;
+
+	for (uint8_t i = 0; i < sizeof(passes) / sizeof(passes[0]); i++)
+	{
+		poll = privateRun(false, passes[i]);
+		event = privateRun(true, passes[i]);
+
+		printf("  pass %4u us: poll p50 %4u / p99 %4u us, event p50 %4u / p99 %4u us\n",
+				passes[i], poll.Median, poll.Percentile99, event.Median, event.Percentile99);
+	}
+
+	//the events don't wait for the super-loop: its longest pass is far above their latency
+	if (event.Median * 10 > poll.Median || event.Percentile99 > poll.Median)
+	{
+		printf("FAIL: the events wait for the super-loop\n");
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================
@@ -0,0 +1,230 @@
+//==============================================================================
+//includes:
+
+#include "UsartDma/UsartDmaTx.h"
+#include <stdio.h>
+#include <string.h>
+//==============================================================================
+//defines:
+
+#define RING_SIZE_MASK 0x3ff //TxBufferSizeMask of the attached ports, USART_DMA_RS485_TX_BUFFER_SIZE_MASK
+#define BAUD_RATE 900000 //8N1: the time unit of the model is one byte on the line, 11.1 us
+
+#define BULK_BLOCK 64 //the blocks of "usart-load"
+#define LINE_SIZE_MAX 200 //the terminal lines
+#define RUN_SIZE (1 << 20)
+#define SPARSE_RUN_SIZE (1 << 18)
+
+#define BULK_BYTES_PER_TRANSFER_MIN 256
+#define LINE_BYTES_PER_TRANSFER_MIN 64
+//==============================================================================
+//types:
+
+/// @brief the DMA stream of the model: one span of the ring on the line at a time
+typedef struct
+{
+	uint8_t* Span;
+	uint16_t SpanSize;
+	uint32_t BusyUntil;
+	bool IsRunning;
+
+	uint32_t Transfers;
+	uint32_t Interrupts;
+
+} DmaT;
+//==============================================================================
+//variables:
+
+static UsartDmaTxRingT privateRing;
+static uint8_t privateMemory[RING_SIZE_MASK + 1];
+static DmaT privateDma;
+
+static uint8_t privateProduced[RUN_SIZE];
+static uint8_t privateSent[RUN_SIZE];
+static uint32_t privateSentCount;
+
+static uint32_t privateSeed = 1;
+//==============================================================================
+//functions:
+
+static uint32_t privateRandom()
+{
+	privateSeed = privateSeed * 1103515245 + 12345;
+
+	return privateSeed >> 16;
+}
+//------------------------------------------------------------------------------
+/// @brief the request of the transmission: starts the next span when the stream is idle
+static void privateDmaKick(uint32_t time)
+{
+	if (privateDma.IsRunning)
+	{
+		return;
+	}
+
+	privateDma.SpanSize = UsartDmaTxRingStart(&privateRing, &privateDma.Span);
+
+	if (privateDma.SpanSize)
+	{
+		privateDma.IsRunning = true;
+		privateDma.Transfers++;
+		privateDma.BusyUntil = time + privateDma.SpanSize;
+	}
+}
+//------------------------------------------------------------------------------
+/// @brief the transfer complete interrupt: the span went out, the next one is chained from it
+static void privateDmaStep(uint32_t time)
+{
+	if (!privateDma.IsRunning || time < privateDma.BusyUntil)
+	{
+		return;
+	}
+
+	memcpy(privateSent + privateSentCount, privateDma.Span, privateDma.SpanSize);
+	privateSentCount += privateDma.SpanSize;
+
+	privateDma.Interrupts++;
+	privateDma.IsRunning = false;
+
+	UsartDmaTxRingComplete(&privateRing);
+	privateDmaKick(time);
+}
+//------------------------------------------------------------------------------
+/**
+ * @brief the task writes the blocks or the random lines at the load of the line in percent,
+ * waits for the transfer complete while the ring is full. The odd lines are built in place
+ * through UsartDmaTxRingReserve as the frames of the adapter
+ * @return bytes per transfer, 0 - the sent bytes differ from the written ones
+ */
+static uint32_t privateRun(const char* name, bool isBulk, uint32_t load, uint32_t total)
+{
+	memset(&privateDma, 0, sizeof(privateDma));
+	UsartDmaTxRingInit(&privateRing, privateMemory, RING_SIZE_MASK);
+
+	uint32_t produced = 0;
+	uint32_t waits = 0;
+	uint32_t time = 0;
+
+	privateSentCount = 0;
+
+	while (produced < total || UsartDmaTxRingGetDataSize(&privateRing))
+	{
+		privateDmaStep(time);
+
+		if (produced < total && (isBulk || privateRandom() % 10000 < load))
+		{
+			uint32_t size = isBulk ? BULK_BLOCK : 1 + privateRandom() % LINE_SIZE_MAX;
+			bool isReserved = !isBulk && (produced & 1);
+
+			if (size > total - produced)
+			{
+				size = total - produced;
+			}
+
+			for (uint32_t i = 0; i < size; i++)
+			{
+				privateProduced[produced + i] = privateRandom();
+			}
+
+			uint32_t written = 0;
+
+			while (written < size)
+			{
+				if (isReserved)
+				{
+					uint8_t* data;
+					uint16_t free = UsartDmaTxRingReserve(&privateRing, &data);
+
+					if (free > size - written)
+					{
+						free = size - written;
+					}
+
+					memcpy(data, privateProduced + produced + written, free);
+					UsartDmaTxRingCommit(&privateRing, free);
+
+					written += free;
+				}
+				else
+				{
+					written += UsartDmaTxRingWrite(&privateRing, privateProduced + produced + written, size - written);
+				}
+
+				privateDmaKick(time);
+
+				if (written < size)
+				{
+					waits++;
+					time = privateDma.BusyUntil;
+					privateDmaStep(time);
+				}
+			}
+
+			produced += size;
+		}
+
+		time++;
+	}
+
+	double seconds = (double)time * 10 / BAUD_RATE;
+	bool isValid = privateSentCount == total && !memcmp(privateSent, privateProduced, total);
+
+	printf("  %-26s %7u B %s, %5u transfers, %3u B/transfer, %4.0f irq/s (per byte TXE %5.0f), %4u waits\n",
+			name,
+			total,
+			isValid ? "ok" : "CORRUPT",
+			privateDma.Transfers,
+			total / privateDma.Transfers,
+			privateDma.Interrupts / seconds,
+			total / seconds,
+			waits);
+
+	return isValid ? total / privateDma.Transfers : 0;
+}
+//==============================================================================
+//initialization:
+
+int main()
+{
+	printf("ring of %u bytes at %u baud:\n", RING_SIZE_MASK + 1, BAUD_RATE);
+
+	if (privateRun("bulk 64 B blocks", true, 0, RUN_SIZE) < BULK_BYTES_PER_TRANSFER_MIN
+		|| privateRun("lines, 50% of the line", false, 50, RUN_SIZE) < LINE_BYTES_PER_TRANSFER_MIN
+		|| privateRun("lines, 90% of the line", false, 90, RUN_SIZE) < LINE_BYTES_PER_TRANSFER_MIN
+		|| !privateRun("sparse lines, 5% of the line", false, 5, SPARSE_RUN_SIZE))
+	{
+		printf("FAIL: the transfers\n");
+		return 1;
+	}
+
+	//the span never crosses the end of the memory, the wrapped part is chained
+	uint8_t data[1000] = { 0 };
+	uint8_t* span;
+
+	UsartDmaTxRingInit(&privateRing, privateMemory, RING_SIZE_MASK);
+	UsartDmaTxRingWrite(&privateRing, data, sizeof(data));
+	UsartDmaTxRingStart(&privateRing, &span);
+	UsartDmaTxRingComplete(&privateRing);
+	UsartDmaTxRingWrite(&privateRing, data, 100);
+
+	uint16_t first = UsartDmaTxRingStart(&privateRing, &span);
+	uint16_t blocked = UsartDmaTxRingStart(&privateRing, &span);
+
+	UsartDmaTxRingComplete(&privateRing);
+
+	uint16_t chained = UsartDmaTxRingStart(&privateRing, &span);
+
+	printf("wrap: span %u to the end, %u while running, chained %u, free %u\n",
+			first, blocked, chained, UsartDmaTxRingGetFreeSize(&privateRing));
+
+	if (first != RING_SIZE_MASK + 1 - sizeof(data) || blocked || chained != 100 - first || span != privateMemory)
+	{
+		printf("FAIL: wrap\n");
+		return 1;
+	}
+
+	printf("OK\n");
+
+	return 0;
+}
+//==============================================================================